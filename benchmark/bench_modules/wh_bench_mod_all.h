@@ -25,6 +25,15 @@
 int wh_Bench_Mod_Echo(whClientContext* client, whBenchOpContext* benchCtx,
                       int id, void* params);
 
+/*
+ * TLS transport benchmark module prototypes (wh_bench_mod_tls.c)
+ */
+int wh_Bench_Mod_TlsConnect(whClientContext* client, whBenchOpContext* ctx,
+                            int id, void* params);
+
+int wh_Bench_Mod_TlsConnectResume(whClientContext*  client,
+                                  whBenchOpContext* ctx, int id, void* params);
+
 /*
  * AES benchmark module prototypes (wh_bench_mod_aes.c)
  */
@@ -161,6 +170,15 @@ int wh_Bench_Mod_CmacAes256Dma(whClientContext* client, whBenchOpContext* ctx,
 int wh_Bench_Mod_Rng(whClientContext* client, whBenchOpContext* ctx, int id,
                      void* params);
 
+/*
+ * Keystore benchmark module prototypes (wh_bench_mod_keystore.c)
+ */
+int wh_Bench_Mod_KeyLookup(whClientContext* client, whBenchOpContext* ctx,
+                           int id, void* params);
+
+int wh_Bench_Mod_KeyLookupFull(whClientContext* client, whBenchOpContext* ctx,
+                               int id, void* params);
+
 /*
  * SHA2 benchmark module prototypes (wh_bench_mod_sha2.c)
  */
@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2025 wolfSSL Inc.
+ *
+ * This file is part of wolfHSM.
+ *
+ * wolfHSM is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * wolfHSM is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with wolfHSM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stdint.h>
+#include <string.h>
+#include "wh_bench_mod.h"
+#include "wolfhsm/wh_error.h"
+#include "wolfhsm/wh_keyid.h"
+
+#if !defined(WOLFHSM_CFG_NO_CRYPTO) && defined(WOLFHSM_CFG_BENCH_ENABLE)
+
+#define WH_BENCH_KEYSTORE_KEY_SIZE 16
+
+/* Time exporting one cached key while fill other keys are also cached, so
+ * lookup cost can be compared between a nearly empty and a full key cache */
+static int _benchKeyLookup(whClientContext* client, whBenchOpContext* ctx,
+                           int id, int fill)
+{
+    int      ret = 0;
+    int      i;
+    int      cached = 0;
+    uint16_t keyIds[WOLFHSM_CFG_SERVER_KEYCACHE_COUNT];
+    uint16_t keyId  = WH_KEYID_ERASED;
+    uint8_t  key[WH_BENCH_KEYSTORE_KEY_SIZE];
+    uint8_t  out[WH_BENCH_KEYSTORE_KEY_SIZE];
+    uint16_t outSz;
+
+    memset(key, 0xA5, sizeof(key));
+    if (fill > WOLFHSM_CFG_SERVER_KEYCACHE_COUNT - 1) {
+        fill = WOLFHSM_CFG_SERVER_KEYCACHE_COUNT - 1;
+    }
+    /* One client has at most WH_KEYID_IDMAX key IDs */
+    if (fill > WH_KEYID_IDMAX - 1) {
+        fill = WH_KEYID_IDMAX - 1;
+    }
+
+    /* Fill the cache first so the measured key is cached last */
+    for (i = 0; i < fill; i++) {
+        keyIds[i] = WH_KEYID_ERASED;
+        ret = wh_Client_KeyCache(client, 0, NULL, 0, key, sizeof(key),
+                                 &keyIds[i]);
+        if (ret == WH_ERROR_NOSPACE) {
+            /* Already full with keys of other users */
+            ret = 0;
+            break;
+        }
+        if (ret != 0) {
+            WH_BENCH_PRINTF("Failed to wh_Client_KeyCache %d\n", ret);
+            break;
+        }
+        cached++;
+    }
+
+    if (ret == 0) {
+        ret = wh_Client_KeyCache(client, 0, NULL, 0, key, sizeof(key), &keyId);
+        if (ret != 0) {
+            WH_BENCH_PRINTF("Failed to wh_Client_KeyCache %d\n", ret);
+        }
+    }
+
+    if (ret == 0) {
+        ret = wh_Bench_SetDataSize(ctx, id, sizeof(key));
+        if (ret != 0) {
+            WH_BENCH_PRINTF("Failed to wh_Bench_SetDataSize %d\n", ret);
+        }
+    }
+
+    for (i = 0; (ret == 0) && (i < WOLFHSM_CFG_BENCH_CRYPT_ITERS); i++) {
+        int benchStartRet;
+        int benchStopRet;
+        int exportRet;
+
+        outSz = sizeof(out);
+
+        /* Defer error checking until after all operations are complete */
+        benchStartRet = wh_Bench_StartOp(ctx, id);
+        exportRet = wh_Client_KeyExport(client, keyId, NULL, 0, out, &outSz);
+        benchStopRet  = wh_Bench_StopOp(ctx, id);
+
+        /* Check for errors after all operations are complete */
+        if (benchStartRet != 0) {
+            WH_BENCH_PRINTF("Failed to wh_Bench_StartOp: %d\n", benchStartRet);
+            ret = benchStartRet;
+            break;
+        }
+        if (exportRet != 0) {
+            WH_BENCH_PRINTF("Failed to wh_Client_KeyExport %d\n", exportRet);
+            ret = exportRet;
+            break;
+        }
+        if (benchStopRet != 0) {
+            WH_BENCH_PRINTF("Failed to wh_Bench_StopOp: %d\n", benchStopRet);
+            ret = benchStopRet;
+            break;
+        }
+    }
+
+    /* Evict everything cached above, even on failure */
+    if (keyId != WH_KEYID_ERASED) {
+        (void)wh_Client_KeyEvict(client, keyId);
+    }
+    for (i = 0; i < cached; i++) {
+        (void)wh_Client_KeyEvict(client, keyIds[i]);
+    }
+
+    return ret;
+}
+
+int wh_Bench_Mod_KeyLookup(whClientContext* client, whBenchOpContext* ctx,
+                           int id, void* params)
+{
+    (void)params;
+
+    return _benchKeyLookup(client, ctx, id, 0);
+}
+
+int wh_Bench_Mod_KeyLookupFull(whClientContext* client, whBenchOpContext* ctx,
+                               int id, void* params)
+{
+    (void)params;
+
+    return _benchKeyLookup(client, ctx, id,
+                           WOLFHSM_CFG_SERVER_KEYCACHE_COUNT - 1);
+}
+
+#endif /* !WOLFHSM_CFG_NO_CRYPTO && WOLFHSM_CFG_BENCH_ENABLE */
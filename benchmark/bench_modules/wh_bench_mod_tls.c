@@ -0,0 +1,179 @@
+/*
+ * Copyright (C) 2025 wolfSSL Inc.
+ *
+ * This file is part of wolfHSM.
+ *
+ * wolfHSM is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * wolfHSM is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with wolfHSM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stdint.h>
+#include <string.h>
+#include "wh_bench_mod.h"
+#include "wolfhsm/wh_error.h"
+
+#if !defined(WOLFHSM_CFG_NO_CRYPTO) && defined(WOLFHSM_CFG_BENCH_ENABLE) && \
+    defined(WOLFHSM_CFG_TLS)
+#include "port/posix/posix_transport_tls.h"
+
+#undef USE_CERT_BUFFERS_2048
+#define USE_CERT_BUFFERS_2048
+#include "wolfssl/certs_test.h"
+
+/* Loopback port of the private TLS server. Differs from the benchmark server
+ * so both may run at the same time */
+#ifndef WH_BENCH_TLS_PORT
+#define WH_BENCH_TLS_PORT 23457
+#endif
+
+/* Upper bound on polls of a single connect before giving up */
+#define WH_BENCH_TLS_MAX_POLLS 1000000
+
+/* Time each connect from posixTransportTls_InitConnect() until the server has
+ * received the first request, which covers the TCP connect and the complete TLS
+ * handshake. The benchmark client and server are not used. Instead, a private
+ * TLS client and server are run on the loopback interface by polling both
+ * non-blocking transports from this thread. */
+static int _benchTlsConnect(whBenchOpContext* ctx, int id, int resume)
+{
+    static posixTransportTlsServerContext tlsServer;
+    static posixTransportTlsClientContext tlsClient;
+    static uint8_t                        rxBuf[PTTLS_PACKET_MAX_SIZE];
+    posixTransportTlsConfig               serverCfg;
+    posixTransportTlsConfig               clientCfg;
+    posixTransportTlsSessionCache         sessionCache;
+    const uint8_t                         probe[8] = {0};
+    uint16_t                              rxLen;
+    int                                   ret = 0;
+    int                                   sendRet;
+    int                                   recvRet;
+    int                                   polls;
+    int                                   reused;
+    int                                   i;
+
+    memset(&serverCfg, 0, sizeof(serverCfg));
+    serverCfg.server_ip_string = "127.0.0.1";
+    serverCfg.server_port      = WH_BENCH_TLS_PORT;
+    serverCfg.ca_cert          = client_cert_der_2048;
+    serverCfg.ca_cert_len      = sizeof_client_cert_der_2048;
+    serverCfg.cert             = server_cert_der_2048;
+    serverCfg.cert_len         = sizeof_server_cert_der_2048;
+    serverCfg.key              = server_key_der_2048;
+    serverCfg.key_len          = sizeof_server_key_der_2048;
+
+    memset(&sessionCache, 0, sizeof(sessionCache));
+    memset(&clientCfg, 0, sizeof(clientCfg));
+    clientCfg.server_ip_string = "127.0.0.1";
+    clientCfg.server_port      = WH_BENCH_TLS_PORT;
+    clientCfg.ca_cert          = ca_cert_der_2048;
+    clientCfg.ca_cert_len      = sizeof_ca_cert_der_2048;
+    clientCfg.cert             = client_cert_der_2048;
+    clientCfg.cert_len         = sizeof_client_cert_der_2048;
+    clientCfg.key              = client_key_der_2048;
+    clientCfg.key_len          = sizeof_client_key_der_2048;
+    if (resume) {
+        clientCfg.session_cache = &sessionCache;
+    }
+    else {
+        clientCfg.disable_session_resumption = true;
+    }
+
+    ret = posixTransportTls_InitListen(&tlsServer, &serverCfg, NULL, NULL);
+    if (ret != 0) {
+        WH_BENCH_PRINTF("Failed to start TLS server: %d\n", ret);
+        return ret;
+    }
+
+    /* Establish the session to resume outside of the measurement */
+    for (i = (resume ? -1 : 0); i < WOLFHSM_CFG_BENCH_CRYPT_ITERS; i++) {
+        if (i >= 0) {
+            ret = wh_Bench_StartOp(ctx, id);
+            if (ret != 0) {
+                WH_BENCH_PRINTF("Failed to wh_Bench_StartOp %d\n", ret);
+                break;
+            }
+        }
+
+        ret = posixTransportTls_InitConnect(&tlsClient, &clientCfg, NULL,
+                                            NULL);
+        if (ret != 0) {
+            WH_BENCH_PRINTF("Failed to start TLS client: %d\n", ret);
+            break;
+        }
+
+        /* Alternate between client and server until the probe arrives */
+        sendRet = WH_ERROR_NOTREADY;
+        recvRet = WH_ERROR_NOTREADY;
+        for (polls = 0; (recvRet == WH_ERROR_NOTREADY) &&
+                        (polls < WH_BENCH_TLS_MAX_POLLS);
+             polls++) {
+            if (sendRet == WH_ERROR_NOTREADY) {
+                sendRet = posixTransportTls_SendRequest(&tlsClient,
+                                                        sizeof(probe), probe);
+            }
+            recvRet = posixTransportTls_RecvRequest(&tlsServer, &rxLen, rxBuf);
+        }
+
+        if (i >= 0) {
+            ret = wh_Bench_StopOp(ctx, id);
+            if (ret != 0) {
+                WH_BENCH_PRINTF("Failed to wh_Bench_StopOp %d\n", ret);
+            }
+        }
+        if ((ret == 0) && ((sendRet != 0) || (recvRet != 0))) {
+            WH_BENCH_PRINTF("TLS connect failed: send %d recv %d\n", sendRet,
+                            recvRet);
+            ret = WH_ERROR_ABORTED;
+        }
+        if ((ret == 0) && resume && (i >= 0) &&
+            (posixTransportTls_SessionReused(&tlsClient, &reused) == 0) &&
+            !reused) {
+            WH_BENCH_PRINTF("TLS session was not resumed\n");
+            ret = WH_ERROR_ABORTED;
+        }
+
+        /* Disconnect and let the server release the connection */
+        (void)posixTransportTls_CleanupConnect(&tlsClient);
+        for (polls = 0; (recvRet != WH_ERROR_ABORTED) &&
+                        (polls < WH_BENCH_TLS_MAX_POLLS);
+             polls++) {
+            recvRet = posixTransportTls_RecvRequest(&tlsServer, &rxLen, rxBuf);
+        }
+
+        if (ret != 0) {
+            break;
+        }
+    }
+
+    (void)posixTransportTls_FreeSessionCache(&sessionCache);
+    (void)posixTransportTls_CleanupListen(&tlsServer);
+    return ret;
+}
+
+int wh_Bench_Mod_TlsConnect(whClientContext* client, whBenchOpContext* ctx,
+                            int id, void* params)
+{
+    (void)client;
+    (void)params;
+    return _benchTlsConnect(ctx, id, 0);
+}
+
+int wh_Bench_Mod_TlsConnectResume(whClientContext*  client,
+                                  whBenchOpContext* ctx, int id, void* params)
+{
+    (void)client;
+    (void)params;
+    return _benchTlsConnect(ctx, id, 1);
+}
+
+#endif /* !WOLFHSM_CFG_NO_CRYPTO && WOLFHSM_CFG_BENCH_ENABLE && \
+          WOLFHSM_CFG_TLS */
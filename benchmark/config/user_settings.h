@@ -47,10 +47,12 @@ extern "C" {
 #define WOLFSSL_BASE64_ENCODE
 #define HAVE_ANONYMOUS_INLINE_AGGREGATES 1
 
-/* For cert manager */
+/* For cert manager. The TLS connect benchmarks need the TLS layer and IO */
+#ifndef WOLFHSM_CFG_TLS
 #define NO_TLS
 /* Eliminates need for IO layer since we only use CM */
 #define WOLFSSL_USER_IO
+#endif /* WOLFHSM_CFG_TLS */
 /* For ACert support (also requires WOLFSSL_ASN_TEMPLATE) */
 #define WOLFSSL_ACERT
 
@@ -81,7 +83,9 @@ extern "C" {
 #define NO_ERROR_QUEUE
 #define NO_INLINE
 #define NO_OLD_TLS
+#ifndef WOLFHSM_CFG_TLS
 #define WOLFSSL_NO_TLS12
+#endif /* WOLFHSM_CFG_TLS */
 #define NO_DO178
 
 /* Prevents certain functions (SHA, hash.c) on server from falling back to
@@ -48,4 +48,8 @@
 /* Benchmark configs */
 #define WOLFHSM_CFG_BENCH_ENABLE
 #define WOLFHSM_CFG_BENCH_MAIN
+
+/* Cache line size of the host, used by the mempad transport layout */
+#define XCACHELINE 64
+
 #endif /* WOLFHSM_CFG_H_ */
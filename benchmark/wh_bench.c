@@ -30,6 +30,7 @@
 #include "wolfhsm/wh_error.h"
 #include "wolfhsm/wh_comm.h"
 #include "wolfhsm/wh_transport_mem.h"
+#include "wolfhsm/wh_transport_direct.h"
 #include "wolfhsm/wh_nvm.h"
 #include "wolfhsm/wh_nvm_flash.h"
 #include "wolfhsm/wh_flash_ramsim.h"
@@ -60,6 +61,13 @@
 #define BUFFER_SIZE \
     (sizeof(whTransportMemCsr) + sizeof(whCommHeader) + \
      WOLFHSM_CFG_COMM_DATA_LEN)
+
+/* Buffer size for the cache line CSR layout: a line for the CSR, whole lines
+ * for the packet and one more line of slack to align the buffer at runtime */
+#define PADDED_LINE_SIZE WH_TRANSPORT_MEM_CSR_SIZE_CACHELINE
+#define PADDED_DATA_SIZE \
+    ((WH_COMM_MTU + PADDED_LINE_SIZE - 1) & ~(PADDED_LINE_SIZE - 1))
+#define PADDED_BUFFER_SIZE (2 * PADDED_LINE_SIZE + PADDED_DATA_SIZE)
 #define FLASH_RAM_SIZE (1024 * 1024) /* 1MB */
 
 typedef struct BenchModule {
@@ -78,11 +86,21 @@ typedef struct BenchModule {
 typedef enum BenchModuleIdx {
     BENCH_MODULE_IDX_ECHO = 0,
 #if !defined(WOLFHSM_CFG_NO_CRYPTO)
+/* TLS transport */
+#if defined(WOLFHSM_CFG_TLS)
+    BENCH_MODULE_IDX_TLS_CONNECT,
+    BENCH_MODULE_IDX_TLS_CONNECT_RESUME,
+#endif /* WOLFHSM_CFG_TLS */
+
 /* RNG */
 #if !defined(WC_NO_RNG)
     BENCH_MODULE_IDX_RNG,
 #endif /* !(WC_NO_RNG) */
 
+/* Keystore */
+    BENCH_MODULE_IDX_KEY_LOOKUP,
+    BENCH_MODULE_IDX_KEY_LOOKUP_FULL,
+
 /* AES */
 #if !defined(NO_AES)
 #if defined(WOLFSSL_AES_COUNTER)
@@ -268,11 +286,21 @@ WH_UTILS_STATIC_ASSERT(MAX_BENCH_OPS > BENCH_MODULE_IDX_COUNT,
 static BenchModule g_benchModules[] = {
     [BENCH_MODULE_IDX_ECHO]                    = {"ECHO",                         wh_Bench_Mod_Echo,                 BENCH_THROUGHPUT_XBPS, 0, NULL},
 #if !defined(WOLFHSM_CFG_NO_CRYPTO)
+    /* TLS transport */
+#if defined(WOLFHSM_CFG_TLS)
+    [BENCH_MODULE_IDX_TLS_CONNECT]             = {"TLS-Connect",                  wh_Bench_Mod_TlsConnect,           BENCH_THROUGHPUT_OPS, 0, NULL},
+    [BENCH_MODULE_IDX_TLS_CONNECT_RESUME]      = {"TLS-Connect-Resume",           wh_Bench_Mod_TlsConnectResume,     BENCH_THROUGHPUT_OPS, 0, NULL},
+#endif /* WOLFHSM_CFG_TLS */
+
     /* RNG */
 #if !defined(WC_NO_RNG)
     [BENCH_MODULE_IDX_RNG]                     = {"RNG",                          wh_Bench_Mod_Rng,                  BENCH_THROUGHPUT_XBPS, 0, NULL},
 #endif /* !(WC_NO_RNG) */
 
+    /* Keystore */
+    [BENCH_MODULE_IDX_KEY_LOOKUP]              = {"KEY-Lookup",                   wh_Bench_Mod_KeyLookup,            BENCH_THROUGHPUT_OPS, 0, NULL},
+    [BENCH_MODULE_IDX_KEY_LOOKUP_FULL]         = {"KEY-Lookup-Full-Cache",        wh_Bench_Mod_KeyLookupFull,        BENCH_THROUGHPUT_OPS, 0, NULL},
+
     /* AES */
 #if !defined(NO_AES)
 #if defined(WOLFSSL_AES_COUNTER)
@@ -387,23 +415,23 @@ static BenchModule g_benchModules[] = {
     [BENCH_MODULE_IDX_RSA_2048_ENCRYPT_DMA]    = {"RSA-2048-PUBLIC-ENCRYPT-DMA",  wh_Bench_Mod_Rsa2048PubEncryptDma,   BENCH_THROUGHPUT_XBPS, 0, NULL},
     [BENCH_MODULE_IDX_RSA_2048_DECRYPT]        = {"RSA-2048-PRIVATE-DECRYPT",     wh_Bench_Mod_Rsa2048PrvDecrypt,      BENCH_THROUGHPUT_XBPS, 0, NULL},
     [BENCH_MODULE_IDX_RSA_2048_DECRYPT_DMA]    = {"RSA-2048-PRIVATE-DECRYPT-DMA", wh_Bench_Mod_Rsa2048PrvDecryptDma,   BENCH_THROUGHPUT_XBPS, 0, NULL},
-    [BENCH_MODULE_IDX_RSA_2048_SIGN]           = {"RSA-2048-SIGN",                wh_Bench_Mod_Rsa2048Sign,            BENCH_THROUGHPUT_OPS,  0, NULL},
-    [BENCH_MODULE_IDX_RSA_2048_SIGN_DMA]       = {"RSA-2048-SIGN-DMA",            wh_Bench_Mod_Rsa2048SignDma,         BENCH_THROUGHPUT_OPS,  0, NULL},
-    [BENCH_MODULE_IDX_RSA_2048_VERIFY]         = {"RSA-2048-VERIFY",              wh_Bench_Mod_Rsa2048Verify,          BENCH_THROUGHPUT_OPS,  0, NULL},
-    [BENCH_MODULE_IDX_RSA_2048_VERIFY_DMA]     = {"RSA-2048-VERIFY-DMA",          wh_Bench_Mod_Rsa2048VerifyDma,       BENCH_THROUGHPUT_OPS,  0, NULL},
-    [BENCH_MODULE_IDX_RSA_2048_KEY_GEN]        = {"RSA-2048-KEY-GEN",             wh_Bench_Mod_Rsa2048KeyGen,          BENCH_THROUGHPUT_OPS,  0, NULL},
-    [BENCH_MODULE_IDX_RSA_2048_KEY_GEN_DMA]    = {"RSA-2048-KEY-GEN-DMA",         wh_Bench_Mod_Rsa2048KeyGenDma,       BENCH_THROUGHPUT_OPS,  0, NULL},
+    [BENCH_MODULE_IDX_RSA_2048_SIGN]           = {"RSA-2048-SIGN",                wh_Bench_Mod_Rsa2048Sign,            BENCH_THROUGHPUT_OPS, 0, NULL},
+    [BENCH_MODULE_IDX_RSA_2048_SIGN_DMA]       = {"RSA-2048-SIGN-DMA",            wh_Bench_Mod_Rsa2048SignDma,         BENCH_THROUGHPUT_OPS, 0, NULL},
+    [BENCH_MODULE_IDX_RSA_2048_VERIFY]         = {"RSA-2048-VERIFY",              wh_Bench_Mod_Rsa2048Verify,          BENCH_THROUGHPUT_OPS, 0, NULL},
+    [BENCH_MODULE_IDX_RSA_2048_VERIFY_DMA]     = {"RSA-2048-VERIFY-DMA",          wh_Bench_Mod_Rsa2048VerifyDma,       BENCH_THROUGHPUT_OPS, 0, NULL},
+    [BENCH_MODULE_IDX_RSA_2048_KEY_GEN]        = {"RSA-2048-KEY-GEN",             wh_Bench_Mod_Rsa2048KeyGen,          BENCH_THROUGHPUT_OPS, 0, NULL},
+    [BENCH_MODULE_IDX_RSA_2048_KEY_GEN_DMA]    = {"RSA-2048-KEY-GEN-DMA",         wh_Bench_Mod_Rsa2048KeyGenDma,       BENCH_THROUGHPUT_OPS, 0, NULL},
     /* 4096 */
     [BENCH_MODULE_IDX_RSA_4096_ENCRYPT]        = {"RSA-4096-PUBLIC-ENCRYPT",      wh_Bench_Mod_Rsa4096PubEncrypt,      BENCH_THROUGHPUT_XBPS, 0, NULL},
     [BENCH_MODULE_IDX_RSA_4096_ENCRYPT_DMA]    = {"RSA-4096-PUBLIC-ENCRYPT-DMA",  wh_Bench_Mod_Rsa4096PubEncryptDma,   BENCH_THROUGHPUT_XBPS, 0, NULL},
     [BENCH_MODULE_IDX_RSA_4096_DECRYPT]        = {"RSA-4096-PRIVATE-DECRYPT",     wh_Bench_Mod_Rsa4096PrvDecrypt,      BENCH_THROUGHPUT_XBPS, 0, NULL},
     [BENCH_MODULE_IDX_RSA_4096_DECRYPT_DMA]    = {"RSA-4096-PRIVATE-DECRYPT-DMA", wh_Bench_Mod_Rsa4096PrvDecryptDma,   BENCH_THROUGHPUT_XBPS, 0, NULL},
-    [BENCH_MODULE_IDX_RSA_4096_SIGN]           = {"RSA-4096-SIGN",                wh_Bench_Mod_Rsa4096Sign,            BENCH_THROUGHPUT_OPS,  0, NULL},
-    [BENCH_MODULE_IDX_RSA_4096_SIGN_DMA]       = {"RSA-4096-SIGN-DMA",            wh_Bench_Mod_Rsa4096SignDma,         BENCH_THROUGHPUT_OPS,  0, NULL},
-    [BENCH_MODULE_IDX_RSA_4096_VERIFY]         = {"RSA-4096-VERIFY",              wh_Bench_Mod_Rsa4096Verify,          BENCH_THROUGHPUT_OPS,  0, NULL},
-    [BENCH_MODULE_IDX_RSA_4096_VERIFY_DMA]     = {"RSA-4096-VERIFY-DMA",          wh_Bench_Mod_Rsa4096VerifyDma,       BENCH_THROUGHPUT_OPS,  0, NULL},
-    [BENCH_MODULE_IDX_RSA_4096_KEY_GEN]        = {"RSA-4096-KEY-GEN",             wh_Bench_Mod_Rsa4096KeyGen,          BENCH_THROUGHPUT_OPS,  0, NULL},
-    [BENCH_MODULE_IDX_RSA_4096_KEY_GEN_DMA]    = {"RSA-4096-KEY-GEN-DMA",         wh_Bench_Mod_Rsa4096KeyGenDma,       BENCH_THROUGHPUT_OPS,  0, NULL},
+    [BENCH_MODULE_IDX_RSA_4096_SIGN]           = {"RSA-4096-SIGN",                wh_Bench_Mod_Rsa4096Sign,            BENCH_THROUGHPUT_OPS, 0, NULL},
+    [BENCH_MODULE_IDX_RSA_4096_SIGN_DMA]       = {"RSA-4096-SIGN-DMA",            wh_Bench_Mod_Rsa4096SignDma,         BENCH_THROUGHPUT_OPS, 0, NULL},
+    [BENCH_MODULE_IDX_RSA_4096_VERIFY]         = {"RSA-4096-VERIFY",              wh_Bench_Mod_Rsa4096Verify,          BENCH_THROUGHPUT_OPS, 0, NULL},
+    [BENCH_MODULE_IDX_RSA_4096_VERIFY_DMA]     = {"RSA-4096-VERIFY-DMA",          wh_Bench_Mod_Rsa4096VerifyDma,       BENCH_THROUGHPUT_OPS, 0, NULL},
+    [BENCH_MODULE_IDX_RSA_4096_KEY_GEN]        = {"RSA-4096-KEY-GEN",             wh_Bench_Mod_Rsa4096KeyGen,          BENCH_THROUGHPUT_OPS, 0, NULL},
+    [BENCH_MODULE_IDX_RSA_4096_KEY_GEN_DMA]    = {"RSA-4096-KEY-GEN-DMA",         wh_Bench_Mod_Rsa4096KeyGenDma,       BENCH_THROUGHPUT_OPS, 0, NULL},
 
 #endif /* !(NO_RSA) */
 
@@ -572,6 +600,8 @@ static int wh_Bench_CheckTransport(int transport)
 {
     switch (transport) {
         case WH_BENCH_TRANSPORT_MEM:
+        case WH_BENCH_TRANSPORT_MEM_PADDED:
+        case WH_BENCH_TRANSPORT_DIRECT:
             break;
         case WH_BENCH_TRANSPORT_POSIX_DMA:
 #if !defined(WOLFSSL_STATIC_MEMORY) || !defined(WOLFHSM_CFG_TEST_POSIX)
@@ -810,6 +840,24 @@ static void* _whBenchServerTask(void* cf)
     return NULL;
 }
 
+/* Server dispatched directly by the client transport. There is no server
+ * thread, so it is initialized and cleaned up around the client task */
+static whServerContext g_direct_server = {0};
+
+static void _whBenchClientServerDirectTest(whClientConfig* c_conf,
+                                           whServerConfig* s_conf,
+                                           int moduleIndex, int transport)
+{
+    whBenchClientTaskData clientData = {c_conf, moduleIndex, transport};
+
+    if (wh_Server_Init(&g_direct_server, s_conf) != 0) {
+        WH_BENCH_PRINTF("Failed to initialize server\n");
+        return;
+    }
+    (void)_whBenchClientTask(&clientData);
+    (void)wh_Server_Cleanup(&g_direct_server);
+}
+
 static void _whBenchClientServerThreadTest(whClientConfig* c_conf,
                                            whServerConfig* s_conf,
                                            int moduleIndex, int transport)
@@ -820,6 +868,11 @@ static void _whBenchClientServerThreadTest(whClientConfig* c_conf,
     int       rc = 0;
     whBenchClientTaskData clientData = {c_conf, moduleIndex, transport};
 
+    if (transport == WH_BENCH_TRANSPORT_DIRECT) {
+        _whBenchClientServerDirectTest(c_conf, s_conf, moduleIndex, transport);
+        return;
+    }
+
     /* Create server thread first */
     rc = pthread_create(&sthread, NULL, _whBenchServerTask, s_conf);
     if (rc == 0) {
@@ -866,6 +919,63 @@ static whCommServerConfig          g_mem_cs_conf = {
              .server_id         = 124,
 };
 
+/* Memory transport with each CSR padded to its own cache line. The config is
+ * completed at runtime once the buffers are aligned */
+static uint8_t              g_mempad_req[PADDED_BUFFER_SIZE]  = {0};
+static uint8_t              g_mempad_resp[PADDED_BUFFER_SIZE] = {0};
+static whTransportMemConfig g_mempad_tmcf                     = {
+                 .req_size  = PADDED_BUFFER_SIZE - PADDED_LINE_SIZE,
+                 .resp_size = PADDED_BUFFER_SIZE - PADDED_LINE_SIZE,
+                 .csr_size  = PADDED_LINE_SIZE,
+};
+static whTransportClientCb         g_mempad_tccb    = WH_TRANSPORT_MEM_CLIENT_CB;
+static whTransportMemClientContext g_mempad_tmcc    = {0};
+static whCommClientConfig          g_mempad_cc_conf = {
+             .transport_cb      = &g_mempad_tccb,
+             .transport_context = (void*)&g_mempad_tmcc,
+             .transport_config  = (void*)&g_mempad_tmcf,
+             .client_id         = WH_BENCH_CLIENT_ID,
+};
+
+static whTransportServerCb         g_mempad_tscb    = WH_TRANSPORT_MEM_SERVER_CB;
+static whTransportMemServerContext g_mempad_tmsc    = {0};
+static whCommServerConfig          g_mempad_cs_conf = {
+             .transport_cb      = &g_mempad_tscb,
+             .transport_context = (void*)&g_mempad_tmsc,
+             .transport_config  = (void*)&g_mempad_tmcf,
+             .server_id         = 124,
+};
+
+/* Direct dispatch transport. The client and server share one context */
+static whTransportDirectConfig  g_direct_tdcf = {
+     .server = &g_direct_server,
+};
+static whTransportDirectContext g_direct_tdctx = {0};
+
+static whTransportClientCb g_direct_tccb    = WH_TRANSPORT_DIRECT_CLIENT_CB;
+static whCommClientConfig  g_direct_cc_conf = {
+     .transport_cb      = &g_direct_tccb,
+     .transport_context = (void*)&g_direct_tdctx,
+     .transport_config  = (void*)&g_direct_tdcf,
+     .client_id         = WH_BENCH_CLIENT_ID,
+};
+
+static whTransportServerCb g_direct_tscb    = WH_TRANSPORT_DIRECT_SERVER_CB;
+static whCommServerConfig  g_direct_cs_conf = {
+     .transport_cb      = &g_direct_tscb,
+     .transport_context = (void*)&g_direct_tdctx,
+     .transport_config  = (void*)&g_direct_tdcf,
+     .server_id         = 124,
+};
+
+/* Align a padded layout buffer to the start of its first full line */
+static void* _alignPaddedBuffer(uint8_t* buffer)
+{
+    return buffer + ((PADDED_LINE_SIZE -
+                      ((uintptr_t)buffer % PADDED_LINE_SIZE)) %
+                     PADDED_LINE_SIZE);
+}
+
 /* Helper function to configure client transport based on type */
 static int _configureClientTransport(whBenchTransportType transport,
                                      whClientConfig*      c_conf)
@@ -879,6 +989,20 @@ static int _configureClientTransport(whBenchTransportType transport,
             break;
         }
 
+        case WH_BENCH_TRANSPORT_MEM_PADDED: {
+            /* Memory transport configuration with cache line CSRs */
+            g_mempad_tmcf.req  = _alignPaddedBuffer(g_mempad_req);
+            g_mempad_tmcf.resp = _alignPaddedBuffer(g_mempad_resp);
+            c_conf->comm       = &g_mempad_cc_conf;
+            break;
+        }
+
+        case WH_BENCH_TRANSPORT_DIRECT: {
+            /* Direct dispatch transport configuration */
+            c_conf->comm = &g_direct_cc_conf;
+            break;
+        }
+
 #if defined(WOLFSSL_STATIC_MEMORY) && defined(WOLFHSM_CFG_TEST_POSIX)
         case WH_BENCH_TRANSPORT_POSIX_DMA: {
             static whClientDmaConfig dmaConfig;
@@ -954,6 +1078,20 @@ static int _configureServerTransport(whBenchTransportType transport,
             break;
         }
 
+        case WH_BENCH_TRANSPORT_MEM_PADDED: {
+            /* Memory transport configuration with cache line CSRs */
+            g_mempad_tmcf.req   = _alignPaddedBuffer(g_mempad_req);
+            g_mempad_tmcf.resp  = _alignPaddedBuffer(g_mempad_resp);
+            s_conf->comm_config = &g_mempad_cs_conf;
+            break;
+        }
+
+        case WH_BENCH_TRANSPORT_DIRECT: {
+            /* Direct dispatch transport configuration */
+            s_conf->comm_config = &g_direct_cs_conf;
+            break;
+        }
+
 #if defined(WOLFSSL_STATIC_MEMORY) && defined(WOLFHSM_CFG_TEST_POSIX)
         case WH_BENCH_TRANSPORT_POSIX_DMA: {
             static whServerDmaConfig dmaConfig;
@@ -30,7 +30,7 @@
 void Usage(const char* exeName)
 {
     WOLFHSM_CFG_PRINTF("Usage: %s --type <type> --module <module> --list\n", exeName);
-    WOLFHSM_CFG_PRINTF("Type: mem, shm, tcp, dma\n");
+    WOLFHSM_CFG_PRINTF("Type: mem, mempad, direct, shm, tcp, dma\n");
     WOLFHSM_CFG_PRINTF("Module: index of the module to run\n");
     WOLFHSM_CFG_PRINTF("List: list all modules\n");
     exit(1);
@@ -52,6 +52,12 @@ int main(int argc, char** argv)
             if (strcmp(type, "mem") == 0) {
                 transport = WH_BENCH_TRANSPORT_MEM;
             }
+            else if (strcmp(type, "mempad") == 0) {
+                transport = WH_BENCH_TRANSPORT_MEM_PADDED;
+            }
+            else if (strcmp(type, "direct") == 0) {
+                transport = WH_BENCH_TRANSPORT_DIRECT;
+            }
             else if (strcmp(type, "shm") == 0) {
                 transport = WH_BENCH_TRANSPORT_POSIX_SHM;
             }
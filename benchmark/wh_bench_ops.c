@@ -292,6 +292,12 @@ int wh_Bench_PrintResults(whBenchOpContext* ctx)
         case WH_BENCH_TRANSPORT_MEM:
             WH_BENCH_PRINTF("(Memory):\n");
             break;
+        case WH_BENCH_TRANSPORT_MEM_PADDED:
+            WH_BENCH_PRINTF("(Memory, Cache Line CSRs):\n");
+            break;
+        case WH_BENCH_TRANSPORT_DIRECT:
+            WH_BENCH_PRINTF("(Direct Dispatch):\n");
+            break;
         case WH_BENCH_TRANSPORT_POSIX_SHM:
             WH_BENCH_PRINTF("(Shared Memory):\n");
             break;
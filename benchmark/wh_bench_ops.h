@@ -26,7 +26,7 @@
 #include <stdint.h>
 
 /* Maximum number of operations that can be registered */
-#define MAX_BENCH_OPS 101
+#define MAX_BENCH_OPS 103
 /* Maximum length of operation name */
 #define MAX_OP_NAME 64
 
@@ -46,6 +46,10 @@ typedef enum {
     WH_BENCH_TRANSPORT_POSIX_TCP, /* TCP transport (PTT_CLIENT_CB) */
     WH_BENCH_TRANSPORT_POSIX_DMA, /* DMA transport
                                      (POSIX_TRANSPORT_REF_CLIENT_CB) */
+    WH_BENCH_TRANSPORT_MEM_PADDED, /* Memory transport with each CSR on its
+                                      own cache line */
+    WH_BENCH_TRANSPORT_DIRECT, /* Direct dispatch transport
+                                  (WH_TRANSPORT_DIRECT_CLIENT_CB) */
 } whBenchTransportType;
 
 typedef struct whBenchOp {
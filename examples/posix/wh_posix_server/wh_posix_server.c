@@ -48,6 +48,8 @@ static void _sleepMs(long milliseconds)
 
 enum {
     ONE_MS = 1,
+    /* Upper bound on a blocking wait for requests */
+    WAIT_TIMEOUT_US = 100000,
 };
 
 #define WH_SERVER_TCP_IPSTRING "127.0.0.1"
@@ -167,7 +169,12 @@ static int wh_ServerTask(void* cf, const char* keyFilePath, int keyId,
         while (1) {
             ret = wh_Server_HandleRequestMessage(server);
             if (ret == WH_ERROR_NOTREADY) {
-                _sleepMs(ONE_MS);
+                /* Block until a request arrives if the transport supports it,
+                 * otherwise fall back to polling */
+                if (wh_Server_WaitRequest(server, WAIT_TIMEOUT_US) ==
+                    WH_ERROR_NOTIMPL) {
+                    _sleepMs(ONE_MS);
+                }
             }
             else if (ret != WH_ERROR_OK) {
                 WOLFHSM_CFG_PRINTF("Failed to wh_Server_HandleRequestMessage: %d\n", ret);
@@ -0,0 +1,353 @@
+/*
+ * Copyright (C) 2025 wolfSSL Inc.
+ *
+ * This file is part of wolfHSM.
+ *
+ * wolfHSM is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * wolfHSM is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with wolfHSM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/*
+ * port/posix/posix_server_pool.c
+ *
+ * Worker thread pool serving many server contexts
+ */
+
+#include "wolfhsm/wh_settings.h"
+
+#ifdef WOLFHSM_CFG_ENABLE_SERVER
+
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "wolfhsm/wh_error.h"
+#include "wolfhsm/wh_server.h"
+
+#include "port/posix/posix_server_pool.h"
+
+/* Claim the next server to handle, preferring notified servers.  Returns the
+ * server index, or -1 if there is nothing to do.  Called with the mutex held */
+static int _Claim(posixServerPool* pool)
+{
+    uint16_t i;
+    uint16_t idx;
+
+    for (i = 0; i < pool->server_count; i++) {
+        idx = (uint16_t)((pool->next + i) % pool->server_count);
+        if ((pool->busy[idx] == 0) && (pool->ready[idx] != 0)) {
+            pool->ready[idx] = 0;
+            pool->busy[idx]  = 1;
+            pool->next       = (uint16_t)((idx + 1) % pool->server_count);
+            return idx;
+        }
+    }
+
+    /* Poll until a full pass finds no request */
+    if ((pool->idle_us != 0) && (pool->idle < pool->server_count)) {
+        for (i = 0; i < pool->server_count; i++) {
+            idx = (uint16_t)((pool->next + i) % pool->server_count);
+            if (pool->busy[idx] == 0) {
+                pool->busy[idx] = 1;
+                pool->next      = (uint16_t)((idx + 1) % pool->server_count);
+                return idx;
+            }
+        }
+    }
+    return -1;
+}
+
+/* Wake the worker blocked in poll(), if any, so it handles a notification or
+ * watches a released server. Called with the mutex held */
+static void _Wake(posixServerPool* pool)
+{
+    char c = 0;
+
+    if ((pool->polling != 0) && (write(pool->wake_wr_p1 - 1, &c, 1) < 0)) {
+        /* The pipe is full, which wakes the poller as well */
+    }
+}
+
+/* Block in poll() on the readiness fds of the idle servers and the wake pipe,
+ * then mark the readable servers ready.  Only one worker polls at a time.
+ * Called with the mutex held, which is released while blocked */
+static void _Poll(posixServerPool* pool)
+{
+    struct pollfd pfd[POSIX_SERVER_POOL_MAX_SERVERS + 1];
+    uint16_t      map[POSIX_SERVER_POOL_MAX_SERVERS];
+    char          drain[16];
+    nfds_t        count = 0;
+    nfds_t        i;
+    uint16_t      idx;
+    int           fd;
+    int           rc;
+
+    for (idx = 0; idx < pool->server_count; idx++) {
+        if (    (pool->busy[idx] != 0) ||
+                (pool->ready[idx] != 0) ||
+                (pool->get_fd(pool->server[idx], &fd) != WH_ERROR_OK)) {
+            /* Servers without a readiness fd are only served on Notify */
+            continue;
+        }
+        pfd[count].fd      = fd;
+        pfd[count].events  = POLLIN;
+        pfd[count].revents = 0;
+        map[count]         = idx;
+        count++;
+    }
+    pfd[count].fd      = pool->wake_rd_p1 - 1;
+    pfd[count].events  = POLLIN;
+    pfd[count].revents = 0;
+
+    pool->polling = 1;
+    (void)pthread_mutex_unlock(&pool->mutex);
+    rc = poll(pfd, count + 1, -1);
+    (void)pthread_mutex_lock(&pool->mutex);
+    pool->polling = 0;
+
+    if (rc > 0) {
+        if (pfd[count].revents != 0) {
+            while (read(pool->wake_rd_p1 - 1, drain, sizeof(drain)) > 0) {
+            }
+        }
+        for (i = 0; i < count; i++) {
+            if (pfd[i].revents != 0) {
+                /* Errors and hangups are handled by the server as well */
+                pool->ready[map[i]] = 1;
+                (void)pthread_cond_signal(&pool->cond);
+            }
+        }
+    }
+    /* Hand polling over to a sleeping worker while this one is busy */
+    (void)pthread_cond_signal(&pool->cond);
+}
+
+/* Wait for a notification, or for idle_us when polling. Called with the mutex
+ * held */
+static void _Wait(posixServerPool* pool)
+{
+    struct timespec ts;
+    uint64_t        nsec;
+
+    if (pool->idle_us == 0) {
+        (void)pthread_cond_wait(&pool->cond, &pool->mutex);
+        return;
+    }
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+    nsec       = (uint64_t)ts.tv_nsec + (uint64_t)pool->idle_us * 1000ULL;
+    ts.tv_sec += (time_t)(nsec / 1000000000ULL);
+    ts.tv_nsec = (long)(nsec % 1000000000ULL);
+    if (pthread_cond_timedwait(&pool->cond, &pool->mutex, &ts) == ETIMEDOUT) {
+        /* Start a new polling pass */
+        pool->idle = 0;
+    }
+}
+
+static void* _Worker(void* arg)
+{
+    posixServerPool* pool = (posixServerPool*)arg;
+    int              idx;
+    int              rc;
+
+    (void)pthread_mutex_lock(&pool->mutex);
+    while (pool->stop == 0) {
+        idx = _Claim(pool);
+        if (idx < 0) {
+            if (    (pool->idle_us == 0) &&
+                    (pool->get_fd != NULL) &&
+                    (pool->polling == 0)) {
+                _Poll(pool);
+            }
+            else {
+                _Wait(pool);
+            }
+            continue;
+        }
+
+        /* Only this worker holds the server, so its requests stay in order */
+        (void)pthread_mutex_unlock(&pool->mutex);
+        rc = wh_Server_HandleRequestMessage(pool->server[idx]);
+        (void)pthread_mutex_lock(&pool->mutex);
+
+        pool->busy[idx] = 0;
+        if (rc == WH_ERROR_OK) {
+            /* More requests may be pending */
+            pool->handled++;
+            pool->ready[idx] = 1;
+            pool->idle       = 0;
+        }
+        else if (pool->idle < UINT16_MAX) {
+            pool->idle++;
+        }
+        if (pool->ready[idx] != 0) {
+            /* Wake a worker for a server that was notified while held */
+            (void)pthread_cond_signal(&pool->cond);
+        }
+        else {
+            /* The poller did not watch the server while it was held */
+            _Wake(pool);
+        }
+    }
+    (void)pthread_mutex_unlock(&pool->mutex);
+
+    return NULL;
+}
+
+int posixServerPool_Init(posixServerPool* pool,
+        const posixServerPoolConfig* config)
+{
+    uint16_t           i;
+    int                rc = WH_ERROR_OK;
+    int                fds[2];
+    pthread_condattr_t attr;
+
+    if (    (pool == NULL) ||
+            (config == NULL) ||
+            (config->servers == NULL) ||
+            (config->server_count == 0) ||
+            (config->server_count > POSIX_SERVER_POOL_MAX_SERVERS) ||
+            (config->worker_count == 0) ||
+            (config->worker_count > POSIX_SERVER_POOL_MAX_WORKERS)) {
+        return WH_ERROR_BADARGS;
+    }
+    for (i = 0; i < config->server_count; i++) {
+        if (config->servers[i] == NULL) {
+            return WH_ERROR_BADARGS;
+        }
+    }
+
+#ifndef WOLFHSM_CFG_THREADSAFE
+    /* Workers run servers that share NVM and global keys concurrently */
+    return WH_ERROR_NOTIMPL;
+#endif
+
+    memset(pool, 0, sizeof(*pool));
+    if (pthread_mutex_init(&pool->mutex, NULL) != 0) {
+        return WH_ERROR_ABORTED;
+    }
+    /* Time idle polls on a clock that wall clock changes do not move */
+    if (pthread_condattr_init(&attr) != 0) {
+        (void)pthread_mutex_destroy(&pool->mutex);
+        return WH_ERROR_ABORTED;
+    }
+    rc = pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    if (rc == 0) {
+        rc = pthread_cond_init(&pool->cond, &attr);
+    }
+    (void)pthread_condattr_destroy(&attr);
+    if (rc != 0) {
+        (void)pthread_mutex_destroy(&pool->mutex);
+        return WH_ERROR_ABORTED;
+    }
+    /* Notify and cleanup wake the worker blocked in poll() through a pipe */
+    if (pipe(fds) != 0) {
+        (void)pthread_cond_destroy(&pool->cond);
+        (void)pthread_mutex_destroy(&pool->mutex);
+        return WH_ERROR_ABORTED;
+    }
+    (void)fcntl(fds[0], F_SETFL, fcntl(fds[0], F_GETFL) | O_NONBLOCK);
+    (void)fcntl(fds[1], F_SETFL, fcntl(fds[1], F_GETFL) | O_NONBLOCK);
+    pool->wake_rd_p1 = fds[0] + 1;
+    pool->wake_wr_p1 = fds[1] + 1;
+
+    rc = WH_ERROR_OK;
+    for (i = 0; i < config->server_count; i++) {
+        pool->server[i] = config->servers[i];
+    }
+    pool->server_count = config->server_count;
+    pool->idle_us      = config->idle_us;
+    pool->get_fd       = config->get_fd;
+    pool->initialized  = 1;
+
+    for (i = 0; i < config->worker_count; i++) {
+        if (pthread_create(&pool->worker[i], NULL, _Worker, pool) != 0) {
+            rc = WH_ERROR_ABORTED;
+            break;
+        }
+        pool->worker_count++;
+    }
+
+    if (rc != WH_ERROR_OK) {
+        (void)posixServerPool_Cleanup(pool);
+    }
+    return rc;
+}
+
+int posixServerPool_Notify(posixServerPool* pool, uint16_t index)
+{
+    if (    (pool == NULL) ||
+            (pool->initialized == 0) ||
+            (index >= pool->server_count)) {
+        return WH_ERROR_BADARGS;
+    }
+
+    (void)pthread_mutex_lock(&pool->mutex);
+    pool->ready[index] = 1;
+    (void)pthread_cond_signal(&pool->cond);
+    _Wake(pool);
+    (void)pthread_mutex_unlock(&pool->mutex);
+
+    return WH_ERROR_OK;
+}
+
+int posixServerPool_GetHandled(posixServerPool* pool, uint64_t* out_handled)
+{
+    if (    (pool == NULL) ||
+            (pool->initialized == 0) ||
+            (out_handled == NULL)) {
+        return WH_ERROR_BADARGS;
+    }
+
+    (void)pthread_mutex_lock(&pool->mutex);
+    *out_handled = pool->handled;
+    (void)pthread_mutex_unlock(&pool->mutex);
+
+    return WH_ERROR_OK;
+}
+
+int posixServerPool_Cleanup(posixServerPool* pool)
+{
+    uint16_t i;
+
+    if (pool == NULL) {
+        return WH_ERROR_BADARGS;
+    }
+    if (pool->initialized == 0) {
+        return WH_ERROR_OK;
+    }
+
+    (void)pthread_mutex_lock(&pool->mutex);
+    pool->stop = 1;
+    (void)pthread_cond_broadcast(&pool->cond);
+    _Wake(pool);
+    (void)pthread_mutex_unlock(&pool->mutex);
+
+    for (i = 0; i < pool->worker_count; i++) {
+        (void)pthread_join(pool->worker[i], NULL);
+    }
+
+    (void)close(pool->wake_rd_p1 - 1);
+    (void)close(pool->wake_wr_p1 - 1);
+    (void)pthread_cond_destroy(&pool->cond);
+    (void)pthread_mutex_destroy(&pool->mutex);
+    memset(pool, 0, sizeof(*pool));
+
+    return WH_ERROR_OK;
+}
+
+#endif /* WOLFHSM_CFG_ENABLE_SERVER */
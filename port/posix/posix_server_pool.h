@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2025 wolfSSL Inc.
+ *
+ * This file is part of wolfHSM.
+ *
+ * wolfHSM is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * wolfHSM is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with wolfHSM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/*
+ * port/posix/posix_server_pool.h
+ *
+ * Worker thread pool that serves many server contexts from a fixed number of
+ * pthreads.
+ *
+ * Without a pool, each whServerContext needs its own thread polling its own
+ * transport, so the number of threads grows with the number of clients.  The
+ * pool instead hands out the contexts it owns to worker_count workers.  A
+ * worker claims a context that no other worker holds, handles at most one
+ * request on it with wh_Server_HandleRequestMessage(), then releases it.  A
+ * context is never held by two workers at once, so the requests of each
+ * client are still handled in order.
+ *
+ * Workers find pending requests in one of two ways:
+ *  - Waiting: with an idle_us of 0, one idle worker at a time blocks in poll()
+ *    on a readiness file descriptor of every idle context, obtained with the
+ *    get_fd callback, such as the socket of its transport.  When one becomes
+ *    readable, its context is marked ready and the other idle workers are
+ *    woken, so a request is picked up as soon as a worker is free, however many
+ *    contexts there are.  Contexts without a readiness descriptor, such as
+ *    those of the shared memory transport, are only handled after the
+ *    application calls posixServerPool_Notify(), for example after
+ *    posixTransportTcpUring_Poll().  Without get_fd, workers sleep until
+ *    notified.
+ *  - Polled: with a non-zero idle_us, workers poll every context in turn and
+ *    sleep for idle_us once a full pass finds no request.
+ * A context that had a request is polled again right away, as more requests
+ * may be pending.  CPU use therefore follows the request load instead of the
+ * number of clients.
+ *
+ * The servers must be initialized before the pool and cleaned up after it.
+ * The pool requires WOLFHSM_CFG_THREADSAFE, as servers normally share an NVM
+ * context, and posixServerPool_Init() returns WH_ERROR_NOTIMPL without it.
+ *
+ * Example usage:
+ *
+ * whServerContext  server[N];  ... wh_Server_Init() each ...
+ * whServerContext* servers[N] = {&server[0], ..};
+ * posixServerPoolConfig pcfg[1] = {{
+ *      .servers      = servers,
+ *      .server_count = N,
+ *      .worker_count = 4,
+ *      .idle_us      = 0,
+ *      .get_fd       = getFd,  ... e.g. posixTransportUds_GetServerWaitFd() ...
+ * }};
+ * posixServerPool pool[1] = {0};
+ * posixServerPool_Init(pool, pcfg);
+ * ... serve until shutdown ...
+ * posixServerPool_Cleanup(pool);
+ */
+
+#ifndef PORT_POSIX_POSIX_SERVER_POOL_H_
+#define PORT_POSIX_POSIX_SERVER_POOL_H_
+
+#include "wolfhsm/wh_settings.h"
+
+#ifdef WOLFHSM_CFG_ENABLE_SERVER
+
+#include <stdint.h>
+#include <pthread.h>
+
+#include "wolfhsm/wh_server.h"
+
+/* Maximum number of server contexts per pool */
+#ifndef POSIX_SERVER_POOL_MAX_SERVERS
+#define POSIX_SERVER_POOL_MAX_SERVERS 64
+#endif
+
+/* Maximum number of worker threads per pool */
+#ifndef POSIX_SERVER_POOL_MAX_WORKERS
+#define POSIX_SERVER_POOL_MAX_WORKERS 16
+#endif
+
+/* Get a file descriptor of a server that polls readable when it may have a
+ * request, or a client to accept, pending.  Returns WH_ERROR_OK, or an error if
+ * the server has none at the moment.  Called again each time the server goes
+ * idle, so the descriptor may change between connections */
+typedef int (*posixServerPoolGetFdCb)(whServerContext* server, int* out_fd);
+
+typedef struct {
+    whServerContext** servers; /* Initialized servers to serve */
+    uint16_t server_count;     /* At most POSIX_SERVER_POOL_MAX_SERVERS */
+    uint16_t worker_count;     /* At most POSIX_SERVER_POOL_MAX_WORKERS */
+    uint32_t idle_us;          /* Sleep after an idle polling pass. 0 to wait
+                                * for readiness instead of polling */
+    posixServerPoolGetFdCb get_fd; /* Readiness source when idle_us is 0.
+                                    * NULL to only serve notified servers */
+} posixServerPoolConfig;
+
+typedef struct {
+    pthread_mutex_t  mutex;
+    pthread_cond_t   cond;          /* Signaled on Notify, release and stop.
+                                     * Uses CLOCK_MONOTONIC */
+    pthread_t        worker[POSIX_SERVER_POOL_MAX_WORKERS];
+    whServerContext* server[POSIX_SERVER_POOL_MAX_SERVERS];
+    uint8_t          busy[POSIX_SERVER_POOL_MAX_SERVERS];  /* Held by a worker */
+    uint8_t          ready[POSIX_SERVER_POOL_MAX_SERVERS]; /* Request may be
+                                                            * pending */
+    posixServerPoolGetFdCb get_fd;
+    uint64_t         handled;       /* Requests handled by all workers */
+    uint32_t         idle_us;
+    uint16_t         server_count;
+    uint16_t         worker_count;  /* Workers started */
+    uint16_t         next;          /* Next context to poll */
+    uint16_t         idle;          /* Consecutive polls without a request */
+    int              wake_rd_p1;    /* Wake pipe read end. fd plus 1 */
+    int              wake_wr_p1;    /* Wake pipe write end. fd plus 1 */
+    int              polling;       /* A worker is blocked in poll() */
+    int              stop;
+    int              initialized;
+} posixServerPool;
+
+/* Start the worker threads serving the configured servers. */
+int posixServerPool_Init(posixServerPool* pool,
+        const posixServerPoolConfig* config);
+
+/* Mark the server at index in the configured servers array as possibly having
+ * a pending request and wake a worker.  Safe to call from any thread. */
+int posixServerPool_Notify(posixServerPool* pool, uint16_t index);
+
+/* Get the number of requests handled so far */
+int posixServerPool_GetHandled(posixServerPool* pool, uint64_t* out_handled);
+
+/* Stop and join the worker threads.  A request being handled is completed
+ * first.  Servers are not cleaned up. */
+int posixServerPool_Cleanup(posixServerPool* pool);
+
+#endif /* WOLFHSM_CFG_ENABLE_SERVER */
+
+#endif /* !PORT_POSIX_POSIX_SERVER_POOL_H_ */
@@ -19,10 +19,12 @@
 /*
  * port/posix/posix_time.c
  *
- * POSIX time helper returning the current time in microseconds.
+ * POSIX time helper returning the current time in microseconds, and a yield
+ * helper for client wait policies.
  */
 
 #include <time.h>
+#include <sched.h>
 
 #include "port/posix/posix_time.h"
 
@@ -36,3 +38,9 @@ uint64_t posixGetTime(void)
 
     return (uint64_t)ts.tv_sec * 1000000ULL + (uint64_t)(ts.tv_nsec / 1000);
 }
+
+void posixYield(void* arg)
+{
+    (void)arg;
+    (void)sched_yield();
+}
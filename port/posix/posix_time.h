@@ -19,7 +19,8 @@
 /*
  * port/posix/posix_time.h
  *
- * POSIX time helper returning the current time in microseconds.
+ * POSIX time helper returning the current time in microseconds, and a yield
+ * helper for client wait policies.
  */
 
 #ifndef PORT_POSIX_POSIX_TIME_H_
@@ -29,4 +30,7 @@
 
 uint64_t posixGetTime(void);
 
+/* Yield the CPU using sched_yield(). Matches whClientYieldCb */
+void posixYield(void* arg);
+
 #endif /* PORT_POSIX_POSIX_TIME_H_ */
@@ -20,6 +20,11 @@
  * port/posix/posix_transport_shm.c
  */
 
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+/* Required for syscall() when building with strict standards flags */
+#define _GNU_SOURCE
+#endif
+
 #include <fcntl.h>    /* For O_* constants */
 #include <sys/mman.h> /* For shm_open, mmap */
 #include <sys/stat.h> /* For mode constants */
@@ -29,6 +34,13 @@
 #include <string.h>   /* For memset */
 #include <stdint.h>
 #include <stdio.h>
+#include <time.h>     /* For clock_gettime, nanosleep */
+
+#if defined(__linux__)
+#include <limits.h>        /* For INT_MAX */
+#include <linux/futex.h>   /* For FUTEX_WAIT, FUTEX_WAKE */
+#include <sys/syscall.h>   /* For SYS_futex */
+#endif
 
 #include "wolfhsm/wh_error.h"
 #include "wolfhsm/wh_utils.h"
@@ -48,6 +60,10 @@ typedef union {
         size_t   dma_size;    /* Size of shared DMA space */
         pid_t    creator_pid; /* Process ID of the creator */
         pid_t    user_pid;    /* Process ID of user */
+        volatile uint32_t req_doorbell; /* Incremented on each client event */
+        volatile uint32_t req_waiters;  /* Non-zero while server is blocked */
+        volatile uint32_t resp_doorbell; /* Incremented on each response */
+        volatile uint32_t resp_waiters;  /* Non-zero while client is blocked */
     };
     uint8_t WH_PAD[PTSHM_HEADER_SIZE];
 } ptshmHeader;
@@ -70,8 +86,30 @@ enum {
     PTSHM_INITIALIZED_CREATOR = 2,
     PTSHM_INITIALIZED_USER    = 3,
 };
+/* Poll interval used to wait for the doorbell when futexes are unavailable */
+#define PTSHM_DOORBELL_POLL_NS 50000
+
 /** Local declarations */
 
+/* Notify a blocked waiter that the doorbell has changed */
+static void posixTransportShm_DoorbellRing(volatile uint32_t* doorbell,
+                                           volatile uint32_t* waiters);
+
+/* Block while the doorbell still holds value, for at most timeout_us */
+static void posixTransportShm_DoorbellWait(volatile uint32_t* doorbell,
+                                           volatile uint32_t* waiters,
+                                           uint32_t value, uint64_t timeout_us);
+
+/* Block until the doorbell differs from *last or timeout_us elapses, then
+ * update *last */
+static int posixTransportShm_DoorbellWaitChange(volatile uint32_t* doorbell,
+                                                volatile uint32_t* waiters,
+                                                uint32_t*          last,
+                                                uint64_t           timeout_us);
+
+/* Monotonic time in microseconds */
+static uint64_t posixTransportShm_NowUs(void);
+
 /* Memory map and interpret the header block */
 static int posixTransportShm_Map(int fd, size_t size, ptshmMapping* map);
 
@@ -91,6 +129,93 @@ static int posixTransportShm_HandleMap(posixTransportShmContext* ctx);
 #endif
 
 /** Local Definitions */
+static void posixTransportShm_DoorbellRing(volatile uint32_t* doorbell,
+                                           volatile uint32_t* waiters)
+{
+    /* Each doorbell is only rung by one side, so no atomic RMW needed */
+    *doorbell = *doorbell + 1;
+    XMEMFENCE();
+    if (*waiters != 0) {
+#if defined(__linux__)
+        (void)syscall(SYS_futex, doorbell, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+#endif
+    }
+}
+
+static uint64_t posixTransportShm_NowUs(void)
+{
+    struct timespec ts = {0};
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000ULL + (uint64_t)ts.tv_nsec / 1000ULL;
+}
+
+static void posixTransportShm_DoorbellWait(volatile uint32_t* doorbell,
+                                           volatile uint32_t* waiters,
+                                           uint32_t value, uint64_t timeout_us)
+{
+    struct timespec  ts  = {0};
+    struct timespec* pts = NULL;
+
+    if (timeout_us != 0) {
+        ts.tv_sec  = (time_t)(timeout_us / 1000000ULL);
+        ts.tv_nsec = (long)((timeout_us % 1000000ULL) * 1000ULL);
+        pts        = &ts;
+    }
+
+    /* Publish the waiter before rechecking so a concurrent ring will wake */
+    *waiters = 1;
+    XMEMFENCE();
+    if (*doorbell == value) {
+#if defined(__linux__)
+        /* Returns immediately if the doorbell no longer holds value */
+        (void)syscall(SYS_futex, doorbell, FUTEX_WAIT, value, pts, NULL, 0);
+#else
+        ts.tv_sec  = 0;
+        ts.tv_nsec = PTSHM_DOORBELL_POLL_NS;
+        if ((pts != NULL) && (timeout_us * 1000ULL < PTSHM_DOORBELL_POLL_NS)) {
+            ts.tv_nsec = (long)(timeout_us * 1000ULL);
+        }
+        (void)nanosleep(&ts, NULL);
+#endif
+    }
+    *waiters = 0;
+    XMEMFENCE();
+}
+
+static int posixTransportShm_DoorbellWaitChange(volatile uint32_t* doorbell,
+                                                volatile uint32_t* waiters,
+                                                uint32_t*          last,
+                                                uint64_t           timeout_us)
+{
+    uint64_t start   = 0;
+    uint64_t elapsed = 0;
+    uint32_t value   = 0;
+
+    if (timeout_us != 0) {
+        start = posixTransportShm_NowUs();
+    }
+
+    while (1) {
+        value = *doorbell;
+        if (value != *last) {
+            /* Event since the last one consumed */
+            *last = value;
+            return WH_ERROR_OK;
+        }
+
+        if (timeout_us != 0) {
+            elapsed = posixTransportShm_NowUs() - start;
+            if (elapsed >= timeout_us) {
+                return WH_ERROR_TIMEOUT;
+            }
+        }
+
+        posixTransportShm_DoorbellWait(
+            doorbell, waiters, value,
+            (timeout_us != 0) ? (timeout_us - elapsed) : 0);
+    }
+}
+
 static int posixTransportShm_Map(int fd, size_t size, ptshmMapping* map)
 {
     int   ret = WH_ERROR_OK;
@@ -161,6 +286,10 @@ static int posixTransportShm_UseMap(char* name, ptshmMapping* map)
                             map->header->user_pid = getpid();
                             XMEMFENCE();
                             map->header->initialized = PTSHM_INITIALIZED_USER;
+                            /* Wake the server to notice the connection */
+                            posixTransportShm_DoorbellRing(
+                                &map->header->req_doorbell,
+                                &map->header->req_waiters);
                         }
                     }
                 }
@@ -472,6 +601,11 @@ int posixTransportShm_Cleanup(void* c)
     if (ctx->ptr != NULL) {
         ptshmHeader* header = (ptshmHeader*)ctx->ptr;
         header->initialized = PTSHM_INITIALIZED_CLEANUP;
+        /* Wake a blocked peer so it may notice the disconnect */
+        posixTransportShm_DoorbellRing(&header->req_doorbell,
+                                       &header->req_waiters);
+        posixTransportShm_DoorbellRing(&header->resp_doorbell,
+                                       &header->resp_waiters);
 
         (void)wh_TransportMem_Cleanup(ctx->transportMemCtx);
         (void)munmap(ctx->ptr, ctx->size);
@@ -525,22 +659,89 @@ int posixTransportShm_SendRequest(void* c, uint16_t len, const void* data)
 
     if (ret == WH_ERROR_OK) {
         ret = wh_TransportMem_SendRequest(ctx->transportMemCtx, len, data);
+        if (ret == WH_ERROR_OK) {
+            ptshmHeader* header = (ptshmHeader*)ctx->ptr;
+            posixTransportShm_DoorbellRing(&header->req_doorbell,
+                                           &header->req_waiters);
+        }
     }
     return ret;
 }
 
+int posixTransportShm_GetSendBuffer(void* c, uint16_t* out_size,
+                                    void** out_buffer)
+{
+    posixTransportShmContext* ctx = (posixTransportShmContext*)c;
+
+    if (ctx == NULL) {
+        return WH_ERROR_BADARGS;
+    }
+
+    /* The buffer is only known once mapped, which happens on first send */
+    if (ctx->state != PTSHM_STATE_INITIALIZED) {
+        return WH_ERROR_NOTREADY;
+    }
+
+    return wh_TransportMem_GetSendBuffer(ctx->transportMemCtx, out_size,
+                                         out_buffer);
+}
+
+int posixTransportShm_CancelRequest(void* c)
+{
+    posixTransportShmContext* ctx = (posixTransportShmContext*)c;
+
+    /* Only need to check NULL, mem transport checks other state info */
+    if (ctx == NULL) {
+        return WH_ERROR_BADARGS;
+    }
+
+    /* The cancel is written to the request CSR in the shared memory */
+    return wh_TransportMem_CancelRequest(ctx->transportMemCtx);
+}
+
 int posixTransportShm_RecvResponse(void* c, uint16_t* out_len, void* data)
 {
     posixTransportShmContext* ctx = (posixTransportShmContext*)c;
+    int                       ret = WH_ERROR_OK;
 
     /* Only need to check NULL, mem transport checks other state info */
     if (ctx == NULL) {
         return WH_ERROR_BADARGS;
     }
 
+    if (ctx->ptr != NULL) {
+        /* Sample the doorbell first so a later ring is never missed */
+        uint32_t doorbell = ((ptshmHeader*)ctx->ptr)->resp_doorbell;
+        XMEMFENCE();
+        ret = wh_TransportMem_RecvResponse(ctx->transportMemCtx, out_len, data);
+        if (ret == WH_ERROR_OK) {
+            ctx->resp_doorbell = doorbell;
+        }
+        return ret;
+    }
     return wh_TransportMem_RecvResponse(ctx->transportMemCtx, out_len, data);
 }
 
+int posixTransportShm_ClientWait(void* c, uint64_t timeout_us)
+{
+    posixTransportShmContext* ctx    = (posixTransportShmContext*)c;
+    ptshmHeader*              header = NULL;
+
+    if (ctx == NULL) {
+        return WH_ERROR_BADARGS;
+    }
+    if (ctx->ptr == NULL) {
+        /* Not mapped until the first request is sent */
+        return WH_ERROR_OK;
+    }
+    header = (ptshmHeader*)ctx->ptr;
+
+    return posixTransportShm_DoorbellWaitChange(&header->resp_doorbell,
+                                                &header->resp_waiters,
+                                                &ctx->resp_doorbell,
+                                                timeout_us);
+}
+
 #ifdef WOLFHSM_CFG_DMA
 /** DMA function callbacks that can make use of WOLFSSL_STATIC_MEMORY using
  * the POSIX shared memory transport.
@@ -623,6 +824,25 @@ int posixTransportShm_ClientStaticMemDmaCallback(
 
 #if defined(WOLFHSM_CFG_ENABLE_SERVER)
 int posixTransportShm_SendResponse(void* c, uint16_t len, const void* data)
+{
+    posixTransportShmContext* ctx = (posixTransportShmContext*)c;
+    int                       ret = WH_ERROR_OK;
+
+    /* Only need to check NULL, mem transport checks other state info */
+    if (ctx == NULL) {
+        return WH_ERROR_BADARGS;
+    }
+
+    ret = wh_TransportMem_SendResponse(ctx->transportMemCtx, len, data);
+    if ((ret == WH_ERROR_OK) && (ctx->ptr != NULL)) {
+        ptshmHeader* header = (ptshmHeader*)ctx->ptr;
+        posixTransportShm_DoorbellRing(&header->resp_doorbell,
+                                       &header->resp_waiters);
+    }
+    return ret;
+}
+
+int posixTransportShm_CompleteRequest(void* c)
 {
     posixTransportShmContext* ctx = (posixTransportShmContext*)c;
 
@@ -631,7 +851,19 @@ int posixTransportShm_SendResponse(void* c, uint16_t len, const void* data)
         return WH_ERROR_BADARGS;
     }
 
-    return wh_TransportMem_SendResponse(ctx->transportMemCtx, len, data);
+    return wh_TransportMem_CompleteRequest(ctx->transportMemCtx);
+}
+
+int posixTransportShm_CheckCanceled(void* c)
+{
+    posixTransportShmContext* ctx = (posixTransportShmContext*)c;
+
+    /* Only need to check NULL, mem transport checks other state info */
+    if (ctx == NULL) {
+        return WH_ERROR_BADARGS;
+    }
+
+    return wh_TransportMem_CheckCanceled(ctx->transportMemCtx);
 }
 
 int posixTransportShm_RecvRequest(void* c, uint16_t* out_len, void* data)
@@ -673,11 +905,59 @@ int posixTransportShm_RecvRequest(void* c, uint16_t* out_len, void* data)
     }
 
     if (ret == WH_ERROR_OK) {
+        /* Sample the doorbell first so a later ring is never missed */
+        uint32_t doorbell = ((ptshmHeader*)ctx->ptr)->req_doorbell;
+        XMEMFENCE();
         ret = wh_TransportMem_RecvRequest(ctx->transportMemCtx, out_len, data);
+        if (ret == WH_ERROR_OK) {
+            ctx->req_doorbell = doorbell;
+        }
     }
     return ret;
 }
 
+int posixTransportShm_PendingRequest(void* c)
+{
+    posixTransportShmContext* ctx = (posixTransportShmContext*)c;
+
+    if (ctx == NULL) {
+        return WH_ERROR_BADARGS;
+    }
+
+    switch (ctx->state) {
+        case PTSHM_STATE_MAPPED: {
+            /* A newly connected client is handled by the next Recv */
+            whCommConnected connected = WH_COMM_DISCONNECTED;
+            posixTransportShm_IsConnected(ctx, &connected);
+            return (connected == WH_COMM_CONNECTED) ? WH_ERROR_OK :
+                                                      WH_ERROR_NOTREADY;
+        }
+
+        case PTSHM_STATE_INITIALIZED:
+            return wh_TransportMem_PendingRequest(ctx->transportMemCtx);
+
+        default:
+            /* Let Recv report the state error */
+            return WH_ERROR_OK;
+    }
+}
+
+int posixTransportShm_ServerWait(void* c, uint64_t timeout_us)
+{
+    posixTransportShmContext* ctx    = (posixTransportShmContext*)c;
+    ptshmHeader*              header = NULL;
+
+    if ((ctx == NULL) || (ctx->ptr == NULL)) {
+        return WH_ERROR_BADARGS;
+    }
+    header = (ptshmHeader*)ctx->ptr;
+
+    /* Wait for a client event since the last request was received */
+    return posixTransportShm_DoorbellWaitChange(&header->req_doorbell,
+                                                &header->req_waiters,
+                                                &ctx->req_doorbell, timeout_us);
+}
+
 #ifdef WOLFHSM_CFG_DMA
 /* Generic offset into the DMA area. This function can operate with no knowledge
  * of what structures the DMA area is. It takes in an offset, validates it, and
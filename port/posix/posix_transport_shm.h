@@ -44,6 +44,16 @@
  * Both the server and the client also provide their process ids within the
  * header block to support asynchronous signalling using POSIX RT signals.
  *
+ * The header block also holds a request doorbell that the client increments
+ * after each request, connect and cleanup.  The server may block on the
+ * doorbell using posixTransportShm_ServerWait() (or wh_Server_WaitRequest())
+ * instead of polling.  Likewise, the server increments a response doorbell
+ * after each response, which the client may block on using
+ * posixTransportShm_ClientWait() (or a client wait policy).  On Linux these
+ * are futexes, so a blocked side uses no CPU and the other side only makes a
+ * wake syscall while it is blocked.  Other platforms fall back to polling the
+ * doorbell with short sleeps.
+ *
  * The optional DMA block is intended to allow the client to use the DMA
  * versions of requests by configuring the base address of the DMA request to be
  * the mapped address of the DMA block.
@@ -89,6 +99,8 @@ typedef struct {
     whCommSetConnectedCb    connectcb;
     void*                   connectcb_arg;
     void*                   heap; /* heap hint used in pass by reference */
+    uint32_t                req_doorbell; /* Last doorbell seen by server */
+    uint32_t                resp_doorbell; /* Last doorbell seen by client */
 } posixTransportShmContext;
 
 /* Naming conveniences. Reuses the same types. */
@@ -145,22 +157,45 @@ int posixTransportShm_Cleanup(void* c);
 int posixTransportShm_SendRequest(void* c, uint16_t len, const void* data);
 int posixTransportShm_RecvRequest(void* c, uint16_t* out_len, void* data);
 int posixTransportShm_SendResponse(void* c, uint16_t len, const void* data);
+int posixTransportShm_CompleteRequest(void* c);
 int posixTransportShm_RecvResponse(void* c, uint16_t* out_len, void* data);
-
-#define POSIX_TRANSPORT_SHM_CLIENT_CB              \
-    {                                              \
-        .Init    = posixTransportShm_ClientInit,   \
-        .Send    = posixTransportShm_SendRequest,  \
-        .Recv    = posixTransportShm_RecvResponse, \
-        .Cleanup = posixTransportShm_Cleanup,      \
+int posixTransportShm_GetSendBuffer(void* c, uint16_t* out_size,
+                                    void** out_buffer);
+int posixTransportShm_CancelRequest(void* c);
+int posixTransportShm_CheckCanceled(void* c);
+
+/* Check without blocking whether a request may be available. */
+int posixTransportShm_PendingRequest(void* c);
+
+/* Block until the client rings the request doorbell or timeout_us elapses. A
+ * timeout_us of 0 waits indefinitely. */
+int posixTransportShm_ServerWait(void* c, uint64_t timeout_us);
+
+/* Block until the server rings the response doorbell or timeout_us elapses. A
+ * timeout_us of 0 waits indefinitely. */
+int posixTransportShm_ClientWait(void* c, uint64_t timeout_us);
+
+#define POSIX_TRANSPORT_SHM_CLIENT_CB                     \
+    {                                                     \
+        .Init          = posixTransportShm_ClientInit,    \
+        .Send          = posixTransportShm_SendRequest,   \
+        .Recv          = posixTransportShm_RecvResponse,  \
+        .Cleanup       = posixTransportShm_Cleanup,       \
+        .GetSendBuffer = posixTransportShm_GetSendBuffer, \
+        .Wait          = posixTransportShm_ClientWait,    \
+        .Cancel        = posixTransportShm_CancelRequest, \
     }
 
-#define POSIX_TRANSPORT_SHM_SERVER_CB              \
-    {                                              \
-        .Init    = posixTransportShm_ServerInit,   \
-        .Recv    = posixTransportShm_RecvRequest,  \
-        .Send    = posixTransportShm_SendResponse, \
-        .Cleanup = posixTransportShm_Cleanup,      \
+#define POSIX_TRANSPORT_SHM_SERVER_CB                  \
+    {                                                  \
+        .Init     = posixTransportShm_ServerInit,      \
+        .Recv     = posixTransportShm_RecvRequest,     \
+        .Send     = posixTransportShm_SendResponse,    \
+        .Cleanup  = posixTransportShm_Cleanup,         \
+        .Wait     = posixTransportShm_ServerWait,      \
+        .Complete = posixTransportShm_CompleteRequest, \
+        .Canceled = posixTransportShm_CheckCanceled,   \
+        .Pending  = posixTransportShm_PendingRequest,  \
     }
 
 
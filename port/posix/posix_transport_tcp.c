@@ -34,6 +34,9 @@
 #include <fcntl.h>
 #include <errno.h>
 #include <poll.h>
+#if defined(__linux__)
+#include <sys/epoll.h>
+#endif
 
 #include "wolfhsm/wh_error.h"
 #include "wolfhsm/wh_comm.h"
@@ -550,6 +553,55 @@ int posixTransportTcp_RecvResponse(void* context,
     return rc;
 }
 
+int posixTransportTcp_CompleteSend(void* context)
+{
+    posixTransportTcpClientContext* c = context;
+    if (c == NULL) {
+        return WH_ERROR_BADARGS;
+    }
+
+    /* No response for this request. The next one may be sent */
+    c->buffer_offset = 0;
+    c->request_sent = 0;
+    return 0;
+}
+
+int posixTransportTcp_ClientWait(void* context, uint64_t timeout_us)
+{
+    int rc = 0;
+    posixTransportTcpClientContext* c = context;
+    struct pollfd pfd;
+    int timeout_ms = -1;
+
+    if (c == NULL) {
+        return WH_ERROR_BADARGS;
+    }
+    if ((c->connect_fd_p1 == 0) || (c->request_sent != 1)) {
+        /* Nothing to wait for yet */
+        return WH_ERROR_OK;
+    }
+
+    if (timeout_us != 0) {
+        /* Round up so short timeouts still wait */
+        uint64_t ms = (timeout_us + 999) / 1000;
+        timeout_ms = (ms > 0x7FFFFFFF) ? 0x7FFFFFFF : (int)ms;
+    }
+
+    pfd.fd = c->connect_fd_p1 - 1;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+
+    rc = poll(&pfd, 1, timeout_ms);
+    if (rc < 0) {
+        /* Treat signals as spurious wakeups */
+        return (errno == EINTR) ? WH_ERROR_OK : WH_ERROR_ABORTED;
+    }
+    if (rc == 0) {
+        return WH_ERROR_TIMEOUT;
+    }
+    return WH_ERROR_OK;
+}
+
 int posixTransportTcp_CleanupConnect(void* context)
 {
      posixTransportTcpClientContext* c = context;
@@ -784,6 +836,19 @@ int posixTransportTcp_SendResponse(void* context,
     return rc;
 }
 
+int posixTransportTcp_CompleteRequest(void* context)
+{
+    posixTransportTcpServerContext* c = context;
+    if (c == NULL) {
+        return WH_ERROR_BADARGS;
+    }
+
+    /* No response for this request. The next one may be received */
+    c->buffer_offset = 0;
+    c->request_recv = 0;
+    return 0;
+}
+
 int posixTransportTcp_CleanupListen(void* context)
 {
     posixTransportTcpServerContext* c = context;
@@ -807,3 +872,445 @@ int posixTransportTcp_CleanupListen(void* context)
 
     return 0;
 }
+
+
+#if defined(__linux__)
+/** Multi-connection server functions */
+
+/* Stop or resume accepting clients by removing or adding the listen socket in
+ * the epoll set */
+static void posixTransportTcpMux_PauseAccept(posixTransportTcpMuxContext* mux,
+        int pause)
+{
+    struct epoll_event ev;
+
+    if (    (pause == mux->accept_paused) ||
+            (mux->epoll_fd_p1 == 0) ||
+            (mux->listen_fd_p1 == 0) ) {
+        return;
+    }
+    if (pause != 0) {
+        (void)epoll_ctl(mux->epoll_fd_p1 - 1, EPOLL_CTL_DEL,
+                mux->listen_fd_p1 - 1, NULL);
+        (void)clock_gettime(CLOCK_MONOTONIC, &mux->accept_retry);
+        mux->accept_retry.tv_nsec += PTT_MUX_ACCEPT_RETRY_MS * 1000000L;
+        mux->accept_retry.tv_sec += mux->accept_retry.tv_nsec / 1000000000L;
+        mux->accept_retry.tv_nsec %= 1000000000L;
+    }
+    else {
+        memset(&ev, 0, sizeof(ev));
+        ev.events = EPOLLIN;
+        ev.data.ptr = NULL; /* NULL identifies the listen socket */
+        if (epoll_ctl(mux->epoll_fd_p1 - 1, EPOLL_CTL_ADD,
+                mux->listen_fd_p1 - 1, &ev) != 0) {
+            return;
+        }
+    }
+    mux->accept_paused = pause;
+}
+
+/* Close the connection in a slot and notify its server */
+static void posixTransportTcpMux_CloseConn(
+        posixTransportTcpMuxServerContext* c)
+{
+    if (c->accept_fd_p1 != 0) {
+        /* Closing the fd also removes it from the epoll set */
+        close(c->accept_fd_p1 - 1);
+        c->accept_fd_p1 = 0;
+        c->request_recv = 0;
+        c->buffer_offset = 0;
+        /* The freed descriptor may let a paused accept succeed */
+        if (c->mux != NULL) {
+            posixTransportTcpMux_PauseAccept(c->mux, 0);
+        }
+        if (c->connectcb != NULL) {
+            c->connectcb(c->connectcb_arg, WH_COMM_DISCONNECTED);
+        }
+    }
+}
+
+/* Accept all pending clients, binding each to a free slot */
+static int posixTransportTcpMux_Accept(posixTransportTcpMuxContext* mux)
+{
+    int rc = 0;
+    int i = 0;
+    struct sockaddr_in client_addr;
+    socklen_t client_len;
+    struct epoll_event ev;
+    posixTransportTcpMuxServerContext* c = NULL;
+
+    while (1) {
+        client_len = sizeof(client_addr);
+        rc = accept(mux->listen_fd_p1 - 1,
+                (struct sockaddr*)&client_addr,
+                &client_len);
+        if (rc < 0) {
+            switch (errno) {
+            case EAGAIN:
+            case EINTR:
+            case ECONNABORTED:
+                /* No more pending clients */
+                return 0;
+
+            case EMFILE:
+            case ENFILE:
+                /* Out of descriptors. Leave the client queued and keep serving
+                 * the open connections until one closes or the retry time */
+                WH_DEBUG_SERVER("tcp mux: accept failed, errno %d\n", errno);
+                posixTransportTcpMux_PauseAccept(mux, 1);
+                return 0;
+
+            default:
+                /* Other error. Assume fatal. */
+                return WH_ERROR_ABORTED;
+            }
+        }
+
+        c = NULL;
+        for (i = 0; i < PTT_MUX_MAX_CONNECTIONS; i++) {
+            if (    (mux->conn[i] != NULL) &&
+                    (mux->conn[i]->accept_fd_p1 == 0) ) {
+                c = mux->conn[i];
+                break;
+            }
+        }
+        if (    (c == NULL) ||
+                (posixTransportTcp_MakeNonBlocking(rc) != 0) ) {
+            /* No free slot. Refuse the client */
+            close(rc);
+            continue;
+        }
+
+        memset(&ev, 0, sizeof(ev));
+        ev.events = EPOLLIN | EPOLLRDHUP;
+        ev.data.ptr = c;
+        if (epoll_ctl(mux->epoll_fd_p1 - 1, EPOLL_CTL_ADD, rc, &ev) != 0) {
+            close(rc);
+            continue;
+        }
+
+        c->accept_fd_p1 = rc + 1;
+        c->client_addr = client_addr;
+        c->request_recv = 0;
+        c->buffer_offset = 0;
+        if (c->connectcb != NULL) {
+            c->connectcb(c->connectcb_arg, WH_COMM_CONNECTED);
+        }
+    }
+}
+
+int posixTransportTcpMux_Init(posixTransportTcpMuxContext* mux,
+        const posixTransportTcpConfig* config)
+{
+    int rc;
+    int enable = 1;
+    struct epoll_event ev;
+
+    if ( (mux == NULL) || (config == NULL)) {
+        return WH_ERROR_BADARGS;
+    }
+
+    memset(mux, 0, sizeof(*mux));
+
+    rc = inet_pton(AF_INET, config->server_ip_string,
+            &mux->server_addr.sin_addr);
+    if (rc != 1) {
+        return WH_ERROR_BADARGS;
+    }
+    mux->server_addr.sin_port = htons(config->server_port);
+    mux->server_addr.sin_family = AF_INET;
+
+    rc = socket(AF_INET, SOCK_STREAM, 0);
+    if (rc < 0) {
+        return WH_ERROR_ABORTED;
+    }
+    else if (rc <= 2) {
+        /* fd conflicts with stdin/stdout/stderr */
+        close(rc);
+        return WH_ERROR_ABORTED;
+    }
+    mux->listen_fd_p1 = rc + 1;
+
+    rc = posixTransportTcp_MakeNonBlocking(mux->listen_fd_p1 - 1);
+    if (rc == 0) {
+        /* Ok to fail to linger or share the port */
+        (void)posixTransportTcp_MakeNoLinger(mux->listen_fd_p1 - 1);
+#ifdef SO_REUSEPORT
+        (void)setsockopt(mux->listen_fd_p1 - 1, SOL_SOCKET, SO_REUSEPORT,
+                &enable, sizeof(enable));
+#else
+        (void)enable;
+#endif
+
+        rc = bind(mux->listen_fd_p1 - 1,
+                (struct sockaddr*)&mux->server_addr,
+                sizeof(mux->server_addr));
+    }
+    if (rc == 0) {
+        rc = listen(mux->listen_fd_p1 - 1, SOMAXCONN);
+    }
+    if (rc == 0) {
+        rc = epoll_create1(0);
+        if (rc >= 0) {
+            mux->epoll_fd_p1 = rc + 1;
+            rc = 0;
+        }
+    }
+    if (rc == 0) {
+        memset(&ev, 0, sizeof(ev));
+        ev.events = EPOLLIN;
+        ev.data.ptr = NULL; /* NULL identifies the listen socket */
+        rc = epoll_ctl(mux->epoll_fd_p1 - 1, EPOLL_CTL_ADD,
+                mux->listen_fd_p1 - 1, &ev);
+    }
+    if (rc != 0) {
+        (void)posixTransportTcpMux_Cleanup(mux);
+        return WH_ERROR_ABORTED;
+    }
+    return 0;
+}
+
+int posixTransportTcpMux_Poll(posixTransportTcpMuxContext* mux, int timeout_ms,
+        uint16_t* out_ready, uint16_t* inout_count)
+{
+    int rc = 0;
+    int i = 0;
+    int nfds = 0;
+    uint16_t count = 0;
+    uint8_t peek = 0;
+    int wait_ms = 0;
+    struct timespec now;
+    struct epoll_event events[PTT_MUX_MAX_EVENTS];
+    posixTransportTcpMuxServerContext* c = NULL;
+
+    if (    (mux == NULL) ||
+            (mux->epoll_fd_p1 == 0) ||
+            (out_ready == NULL) ||
+            (inout_count == NULL) ) {
+        return WH_ERROR_BADARGS;
+    }
+
+    if (mux->accept_paused != 0) {
+        /* Resume accepting at the retry time, and wait no longer than that */
+        (void)clock_gettime(CLOCK_MONOTONIC, &now);
+        wait_ms = (int)((mux->accept_retry.tv_sec - now.tv_sec) * 1000 +
+                (mux->accept_retry.tv_nsec - now.tv_nsec) / 1000000L);
+        if (wait_ms <= 0) {
+            posixTransportTcpMux_PauseAccept(mux, 0);
+        }
+        else if ((timeout_ms < 0) || (timeout_ms > wait_ms)) {
+            timeout_ms = wait_ms;
+        }
+    }
+
+    nfds = epoll_wait(mux->epoll_fd_p1 - 1, events, PTT_MUX_MAX_EVENTS,
+            timeout_ms);
+    if (nfds < 0) {
+        if (errno == EINTR) {
+            nfds = 0;
+        } else {
+            return WH_ERROR_ABORTED;
+        }
+    }
+
+    for (i = 0; i < nfds; i++) {
+        c = (posixTransportTcpMuxServerContext*)events[i].data.ptr;
+        if (c == NULL) {
+            rc = posixTransportTcpMux_Accept(mux);
+            if (rc != 0) {
+                break;
+            }
+            continue;
+        }
+
+        if (c->accept_fd_p1 == 0) {
+            /* Closed earlier in this batch */
+            continue;
+        }
+
+        if (events[i].events & (EPOLLRDHUP | EPOLLHUP | EPOLLERR)) {
+            /* Peer is closing. Deliver any remaining request first */
+            rc = recv(c->accept_fd_p1 - 1, &peek, sizeof(peek),
+                    MSG_PEEK | MSG_DONTWAIT);
+            if (rc <= 0) {
+                posixTransportTcpMux_CloseConn(c);
+                rc = 0;
+                continue;
+            }
+            rc = 0;
+        }
+
+        if (    (events[i].events & EPOLLIN) &&
+                (count < *inout_count) ) {
+            out_ready[count++] = c->index;
+        }
+    }
+
+    *inout_count = count;
+    return rc;
+}
+
+int posixTransportTcpMux_Cleanup(posixTransportTcpMuxContext* mux)
+{
+    if (mux == NULL) {
+        return WH_ERROR_BADARGS;
+    }
+
+    if (mux->epoll_fd_p1 != 0) {
+        close(mux->epoll_fd_p1 - 1);
+        mux->epoll_fd_p1 = 0;
+    }
+    if (mux->listen_fd_p1 != 0) {
+        close(mux->listen_fd_p1 - 1);
+        mux->listen_fd_p1 = 0;
+    }
+    return 0;
+}
+
+int posixTransportTcpMux_GetEpollFd(posixTransportTcpMuxContext* mux,
+        int* out_fd)
+{
+    if (mux == NULL) {
+        return WH_ERROR_BADARGS;
+    }
+    if (mux->epoll_fd_p1 == 0) {
+        return WH_ERROR_NOTREADY;
+    }
+    if (out_fd != NULL) {
+        *out_fd = mux->epoll_fd_p1 - 1;
+    }
+    return WH_ERROR_OK;
+}
+
+int posixTransportTcpMux_InitServer(void* context, const void* config,
+        whCommSetConnectedCb connectcb, void* connectcb_arg)
+{
+    posixTransportTcpMuxServerContext* c = context;
+    const posixTransportTcpMuxServerConfig* cf = config;
+
+    if (    (c == NULL) ||
+            (cf == NULL) ||
+            (cf->mux == NULL) ||
+            (cf->index >= PTT_MUX_MAX_CONNECTIONS) ) {
+        return WH_ERROR_BADARGS;
+    }
+
+    if (    (cf->mux->conn[cf->index] != NULL) &&
+            (cf->mux->conn[cf->index] != c) ) {
+        /* Slot is owned by another context */
+        return WH_ERROR_BADARGS;
+    }
+
+    memset(c, 0, sizeof(*c));
+    c->mux = cf->mux;
+    c->index = cf->index;
+    c->connectcb = connectcb;
+    c->connectcb_arg = connectcb_arg;
+
+    /* Register the slot. Clients are bound to it as they connect */
+    cf->mux->conn[cf->index] = c;
+    return 0;
+}
+
+int posixTransportTcpMux_RecvRequest(void* context,
+        uint16_t* out_size, void* data)
+{
+    int rc = 0;
+    posixTransportTcpMuxServerContext* c = context;
+    if (    (c == NULL) ||
+            (c->mux == NULL) ) {
+        return WH_ERROR_BADARGS;
+    }
+
+    if (    (c->accept_fd_p1 == 0) ||
+            (c->request_recv == 1) ) {
+        /* No client yet or already working on a request. */
+        return WH_ERROR_NOTREADY;
+    }
+
+    rc = posixTransportTcp_Recv(
+            c->accept_fd_p1 - 1,
+            &c->buffer_offset,
+            c->buffer,
+            out_size,
+            data);
+
+    if (rc != WH_ERROR_NOTREADY) {
+        /* Success or fatal.  Reset state either way */
+        c->buffer_offset = 0;
+        if (rc == 0) {
+            c->request_recv = 1;
+        } else {
+            /* Assume fatal error and free the slot */
+            posixTransportTcpMux_CloseConn(c);
+        }
+    }
+    return rc;
+}
+
+int posixTransportTcpMux_SendResponse(void* context,
+        uint16_t size, const void* data)
+{
+    int rc = 0;
+    posixTransportTcpMuxServerContext* c = context;
+    if (    (c == NULL) ||
+            (c->accept_fd_p1 == 0) ||
+            (size == 0) ||
+            (size > PTT_PACKET_MAX_SIZE) ||
+            (data == NULL) ) {
+        return WH_ERROR_BADARGS;
+    }
+
+    if (c->request_recv == 0) {
+        return WH_ERROR_NOTREADY;
+    }
+
+    rc = posixTransportTcp_Send(
+            c->accept_fd_p1 - 1,
+            &c->buffer_offset,
+            c->buffer,
+            size, data);
+
+    if (rc != WH_ERROR_NOTREADY) {
+        /* Reset state */
+        c->buffer_offset = 0;
+        if (rc == 0) {
+            c->request_recv = 0;
+        } else {
+            /* Assume fatal error and free the slot */
+            posixTransportTcpMux_CloseConn(c);
+        }
+    }
+    return rc;
+}
+
+int posixTransportTcpMux_CompleteRequest(void* context)
+{
+    posixTransportTcpMuxServerContext* c = context;
+    if (c == NULL) {
+        return WH_ERROR_BADARGS;
+    }
+
+    /* No response for this request. The next one may be received */
+    c->buffer_offset = 0;
+    c->request_recv = 0;
+    return 0;
+}
+
+int posixTransportTcpMux_CleanupServer(void* context)
+{
+    posixTransportTcpMuxServerContext* c = context;
+    if (c == NULL) {
+        return WH_ERROR_BADARGS;
+    }
+
+    posixTransportTcpMux_CloseConn(c);
+
+    /* Deregister the slot */
+    if (    (c->mux != NULL) &&
+            (c->mux->conn[c->index] == c) ) {
+        c->mux->conn[c->index] = NULL;
+    }
+    return 0;
+}
+#endif /* __linux__ */
@@ -69,6 +69,7 @@
 
 #include <stdint.h>
 #include <netinet/in.h>
+#include <time.h>
 
 #include "wolfhsm/wh_comm.h"
 
@@ -108,6 +109,11 @@ int posixTransportTcp_SendRequest(void* context, uint16_t size,
 int posixTransportTcp_RecvResponse(void* context, uint16_t *out_size,
         void* data);
 int posixTransportTcp_CleanupConnect(void* context);
+int posixTransportTcp_CompleteSend(void* context);
+
+/* Block until a response may be available or timeout_us elapses. A timeout_us
+ * of 0 waits indefinitely. */
+int posixTransportTcp_ClientWait(void* context, uint64_t timeout_us);
 
 #define PTT_CLIENT_CB                               \
 {                                                   \
@@ -115,6 +121,8 @@ int posixTransportTcp_CleanupConnect(void* context);
     .Send =     posixTransportTcp_SendRequest,      \
     .Recv =     posixTransportTcp_RecvResponse,     \
     .Cleanup =  posixTransportTcp_CleanupConnect,   \
+    .Wait =     posixTransportTcp_ClientWait,       \
+    .Complete = posixTransportTcp_CompleteSend,     \
 }
 
 /* Return the file descriptor of the connected socket to support poll/select */
@@ -143,6 +151,7 @@ int posixTransportTcp_RecvRequest(void* context, uint16_t *out_size,
         void* data);
 int posixTransportTcp_SendResponse(void* context, uint16_t size,
         const void* data);
+int posixTransportTcp_CompleteRequest(void* context);
 int posixTransportTcp_CleanupListen(void* context);
 
 #define PTT_SERVER_CB                               \
@@ -151,6 +160,7 @@ int posixTransportTcp_CleanupListen(void* context);
     .Recv =     posixTransportTcp_RecvRequest,      \
     .Send =     posixTransportTcp_SendResponse,     \
     .Cleanup =  posixTransportTcp_CleanupListen,    \
+    .Complete = posixTransportTcp_CompleteRequest,  \
 }
 
 /* Return the file descriptor of the listen socket to support poll/select */
@@ -161,4 +171,136 @@ int posixTransportTcp_GetListenFd(posixTransportTcpServerContext *context,
 int posixTransportTcp_GetAcceptFd(posixTransportTcpServerContext *context,
         int *out_fd);
 
+
+#if defined(__linux__)
+/** Multi-connection server context and functions
+ *
+ * The multiplexer (mux) owns a single listen socket and an epoll instance and
+ * serves many clients at once.  The application provides one connection slot
+ * context per simultaneous client, each used as the transport context of its
+ * own whServerContext, so every connection gets independent server state and
+ * learns its own client_id through the normal comm init exchange.
+ *
+ * Accepted connections are bound to the first free registered slot and that
+ * slot's server is notified as connected.  Connections beyond the number of
+ * free slots are closed immediately.  When a client disconnects, its slot is
+ * notified as disconnected and becomes free for the next client.
+ *
+ * A single event loop thread calls posixTransportTcpMux_Poll() to accept new
+ * clients and obtain the slots with pending requests, then calls
+ * wh_Server_HandleRequestMessage() on the matching servers.  Where available,
+ * the listen socket uses SO_REUSEPORT, so several event loop threads may each
+ * own a mux bound to the same port and the kernel balances new connections
+ * between them.
+ *
+ * Example usage:
+ *
+ * posixTransportTcpMuxContext mux[1] = {0};
+ * posixTransportTcpMux_Init(mux, pttcfg);
+ *
+ * wh_TransportServer_Cb muxcb[1] = {PTT_MUX_SERVER_CB};
+ * posixTransportTcpMuxServerContext conn[N] = {0};
+ * posixTransportTcpMuxServerConfig conncfg[N] = {{.mux = mux, .index = 0}, ..};
+ * whCommServerConfig csc[N] = {{
+ *      .transport_cb = muxcb,
+ *      .transport_context = &conn[i],
+ *      .transport_config = &conncfg[i],
+ *      .server_id = 0xF,
+ * }, ..};
+ * ... wh_Server_Init(&server[i], ...) for each slot ...
+ *
+ * while (1) {
+ *      uint16_t ready[N];
+ *      uint16_t count = N;
+ *      posixTransportTcpMux_Poll(mux, -1, ready, &count);
+ *      for (j = 0; j < count; j++) {
+ *          wh_Server_HandleRequestMessage(&server[ready[j]]);
+ *      }
+ * }
+ */
+
+/* Maximum number of connection slots per mux */
+#ifndef PTT_MUX_MAX_CONNECTIONS
+#define PTT_MUX_MAX_CONNECTIONS 256
+#endif
+
+/* Maximum number of epoll events processed per poll */
+#ifndef PTT_MUX_MAX_EVENTS
+#define PTT_MUX_MAX_EVENTS 64
+#endif
+
+/* Milliseconds to stop accepting after running out of file descriptors */
+#ifndef PTT_MUX_ACCEPT_RETRY_MS
+#define PTT_MUX_ACCEPT_RETRY_MS 100
+#endif
+
+typedef struct posixTransportTcpMuxContext_t posixTransportTcpMuxContext;
+
+/* Per-connection slot configuration */
+typedef struct {
+    posixTransportTcpMuxContext* mux;
+    uint16_t index; /* Slot number, less than PTT_MUX_MAX_CONNECTIONS */
+    uint8_t WH_PAD[6];
+} posixTransportTcpMuxServerConfig;
+
+/* Per-connection slot context, used as a server transport context */
+typedef struct {
+    posixTransportTcpMuxContext* mux;
+    whCommSetConnectedCb connectcb;
+    void* connectcb_arg;
+    struct sockaddr_in client_addr;
+    int accept_fd_p1;       /* fd plus 1 so 0 is invalid */
+    int request_recv;
+    uint16_t index;
+    uint16_t buffer_offset;
+    uint8_t buffer[PTT_BUFFER_SIZE];
+} posixTransportTcpMuxServerContext;
+
+struct posixTransportTcpMuxContext_t {
+    struct sockaddr_in server_addr;
+    int listen_fd_p1;       /* fd plus 1 so 0 is invalid */
+    int epoll_fd_p1;        /* fd plus 1 so 0 is invalid */
+    int accept_paused;      /* Listen socket removed from the epoll set */
+    struct timespec accept_retry; /* When to resume accepting */
+    posixTransportTcpMuxServerContext* conn[PTT_MUX_MAX_CONNECTIONS];
+};
+
+/* Create the listen socket and epoll instance */
+int posixTransportTcpMux_Init(posixTransportTcpMuxContext* mux,
+        const posixTransportTcpConfig* config);
+
+/* Accept pending clients and report slots with pending requests. Waits up to
+ * timeout_ms milliseconds for activity (-1 waits indefinitely, 0 returns
+ * immediately). On input, inout_count holds the capacity of out_ready. On
+ * output, it holds the number of slot indices written to out_ready. */
+int posixTransportTcpMux_Poll(posixTransportTcpMuxContext* mux, int timeout_ms,
+        uint16_t* out_ready, uint16_t* inout_count);
+
+/* Close the listen socket and epoll instance. Slots must be cleaned up
+ * separately through their servers. */
+int posixTransportTcpMux_Cleanup(posixTransportTcpMuxContext* mux);
+
+/* Return the epoll file descriptor to nest within another event loop */
+int posixTransportTcpMux_GetEpollFd(posixTransportTcpMuxContext* mux,
+        int* out_fd);
+
+int posixTransportTcpMux_InitServer(void* context, const void* config,
+        whCommSetConnectedCb connectcb, void* connectcb_arg);
+int posixTransportTcpMux_RecvRequest(void* context, uint16_t *out_size,
+        void* data);
+int posixTransportTcpMux_SendResponse(void* context, uint16_t size,
+        const void* data);
+int posixTransportTcpMux_CompleteRequest(void* context);
+int posixTransportTcpMux_CleanupServer(void* context);
+
+#define PTT_MUX_SERVER_CB                               \
+{                                                       \
+    .Init =     posixTransportTcpMux_InitServer,        \
+    .Recv =     posixTransportTcpMux_RecvRequest,       \
+    .Send =     posixTransportTcpMux_SendResponse,      \
+    .Cleanup =  posixTransportTcpMux_CleanupServer,     \
+    .Complete = posixTransportTcpMux_CompleteRequest,   \
+}
+#endif /* __linux__ */
+
 #endif /* !PORT_POSIX_POSIX_TRANSPORT_TCP_H_ */
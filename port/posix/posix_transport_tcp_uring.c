@@ -0,0 +1,833 @@
+/*
+ * Copyright (C) 2025 wolfSSL Inc.
+ *
+ * This file is part of wolfHSM.
+ *
+ * wolfHSM is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * wolfHSM is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with wolfHSM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/*
+ * port/posix/posix_transport_tcp_uring.c
+ *
+ * Implementation of a multi-connection TCP server transport using io_uring
+ */
+
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+/* Required for syscall() when building with strict standards flags */
+#define _GNU_SOURCE
+#endif
+
+#include "port/posix/posix_transport_tcp_uring.h"
+
+#if defined(PTT_URING_SUPPORTED)
+
+#include <stddef.h>
+#include <string.h>
+#include <stdint.h>
+
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>    /* For struct iovec */
+#include <netinet/in.h>
+#include <unistd.h>
+#include <errno.h>
+
+#include "wolfhsm/wh_error.h"
+#include "wolfhsm/wh_comm.h"
+#include "port/posix/posix_transport_tcp.h"
+
+/* Operation encoded in the low byte of the user_data of each entry */
+#define PTT_URING_OP_ACCEPT 1
+#define PTT_URING_OP_READ   2
+#define PTT_URING_OP_WRITE  3
+
+/* user_data holds the operation, the slot index and the connection generation
+ * of the slot when the operation was queued */
+#define PTT_URING_USER_DATA(_op, _index, _gen)                              \
+    (((uint64_t)(_gen) << 32) | ((uint64_t)(_index) << 8) | (uint64_t)(_op))
+#define PTT_URING_UD_OP(_ud) ((uint8_t)((_ud) & 0xFF))
+#define PTT_URING_UD_INDEX(_ud) ((uint16_t)(((_ud) >> 8) & 0xFFFF))
+#define PTT_URING_UD_GEN(_ud) ((uint32_t)((_ud) >> 32))
+
+/* Registered buffer indices of a slot */
+#define PTT_URING_RX_BUF(_index) ((uint16_t)(2 * (_index)))
+#define PTT_URING_TX_BUF(_index) ((uint16_t)(2 * (_index) + 1))
+
+/* Features required from the kernel */
+#define PTT_URING_FEATURES                                                  \
+    (IORING_FEAT_SINGLE_MMAP | IORING_FEAT_NODROP | IORING_FEAT_EXT_ARG)
+
+
+/** Local declarations */
+
+/* Create the ring, map its queues and register the sparse buffer table */
+static int posixTransportTcpUring_RingInit(posixTransportTcpUringContext* r);
+
+/* Submit to_submit queued entries and optionally wait for a completion */
+static int posixTransportTcpUring_Enter(posixTransportTcpUringContext* r,
+        uint32_t min_complete, int timeout_ms);
+
+/* Queue one entry. Entries are not visible to the kernel until submitted */
+static int posixTransportTcpUring_Queue(posixTransportTcpUringContext* r,
+        uint8_t opcode, int fd, void* addr, uint32_t len, uint16_t buf_index,
+        uint16_t ioprio, uint64_t user_data);
+
+/* Queue a read of the rest of the current packet of a slot */
+static int posixTransportTcpUring_QueueRead(
+        posixTransportTcpUringServerContext* c);
+
+/* Queue a write of the unwritten part of the response of a slot */
+static int posixTransportTcpUring_QueueWrite(
+        posixTransportTcpUringServerContext* c);
+
+/* Check for a complete packet in the receive buffer of a slot. Returns 1 and
+ * sets out_size if there is one, 0 if more data is needed, or an error if the
+ * packet header is invalid */
+static int posixTransportTcpUring_RxPacket(
+        posixTransportTcpUringServerContext* c, uint32_t* out_size);
+
+/* Whether a slot has a request the server can receive now */
+static int posixTransportTcpUring_IsReady(
+        posixTransportTcpUringServerContext* c);
+
+/* Close the connection in a slot and notify its server */
+static void posixTransportTcpUring_CloseConn(
+        posixTransportTcpUringServerContext* c);
+
+/* Bind an accepted connection to a free slot, or refuse it */
+static void posixTransportTcpUring_Bind(posixTransportTcpUringContext* r,
+        int fd);
+
+/* Process one completion */
+static void posixTransportTcpUring_Complete(posixTransportTcpUringContext* r,
+        uint64_t user_data, int32_t res, uint32_t flags);
+
+
+/** Local implementations */
+static int posixTransportTcpUring_RingInit(posixTransportTcpUringContext* r)
+{
+    int rc = 0;
+    struct io_uring_params p;
+    struct io_uring_rsrc_register reg;
+    uint8_t* mem = NULL;
+    size_t sq_size = 0;
+    size_t cq_size = 0;
+
+    memset(&p, 0, sizeof(p));
+    rc = (int)syscall(__NR_io_uring_setup, PTT_URING_QUEUE_DEPTH, &p);
+    if (rc < 0) {
+        /* io_uring is not built in or disabled by policy */
+        return ((errno == ENOSYS) || (errno == EPERM)) ? WH_ERROR_NOTIMPL :
+                                                         WH_ERROR_ABORTED;
+    }
+    r->ring_fd_p1 = rc + 1;
+
+    if ((p.features & PTT_URING_FEATURES) != PTT_URING_FEATURES) {
+        /* Kernel is too old */
+        return WH_ERROR_NOTIMPL;
+    }
+
+    /* The SQ and CQ rings share one mapping */
+    sq_size = p.sq_off.array + p.sq_entries * sizeof(uint32_t);
+    cq_size = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+    r->ring_size = (sq_size > cq_size) ? sq_size : cq_size;
+    mem = mmap(NULL, r->ring_size, PROT_READ | PROT_WRITE, MAP_SHARED,
+            r->ring_fd_p1 - 1, IORING_OFF_SQ_RING);
+    if (mem == MAP_FAILED) {
+        r->ring_size = 0;
+        return WH_ERROR_ABORTED;
+    }
+    r->ring_mem = mem;
+
+    r->sqes_size = p.sq_entries * sizeof(struct io_uring_sqe);
+    r->sqes = mmap(NULL, r->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED,
+            r->ring_fd_p1 - 1, IORING_OFF_SQES);
+    if (r->sqes == MAP_FAILED) {
+        r->sqes = NULL;
+        r->sqes_size = 0;
+        return WH_ERROR_ABORTED;
+    }
+
+    r->sq_head    = (uint32_t*)(mem + p.sq_off.head);
+    r->sq_tail    = (uint32_t*)(mem + p.sq_off.tail);
+    r->sq_array   = (uint32_t*)(mem + p.sq_off.array);
+    r->sq_mask    = *(uint32_t*)(mem + p.sq_off.ring_mask);
+    r->sq_entries = p.sq_entries;
+    r->cq_head    = (uint32_t*)(mem + p.cq_off.head);
+    r->cq_tail    = (uint32_t*)(mem + p.cq_off.tail);
+    r->cq_mask    = *(uint32_t*)(mem + p.cq_off.ring_mask);
+    r->cqes       = (struct io_uring_cqe*)(mem + p.cq_off.cqes);
+
+    /* Reserve a fixed buffer pair for every slot. Each slot registers its own
+     * buffers when initialized */
+    memset(&reg, 0, sizeof(reg));
+    reg.nr = 2 * PTT_URING_MAX_CONNECTIONS;
+    reg.flags = IORING_RSRC_REGISTER_SPARSE;
+    rc = (int)syscall(__NR_io_uring_register, r->ring_fd_p1 - 1,
+            IORING_REGISTER_BUFFERS2, &reg, sizeof(reg));
+    if (rc < 0) {
+        return WH_ERROR_ABORTED;
+    }
+    return 0;
+}
+
+static int posixTransportTcpUring_Enter(posixTransportTcpUringContext* r,
+        uint32_t min_complete, int timeout_ms)
+{
+    int rc = 0;
+    uint32_t flags = 0;
+    struct io_uring_getevents_arg arg;
+    struct __kernel_timespec ts;
+
+    memset(&arg, 0, sizeof(arg));
+    if (min_complete > 0) {
+        flags = IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG;
+        if (timeout_ms > 0) {
+            ts.tv_sec = timeout_ms / 1000;
+            ts.tv_nsec = (timeout_ms % 1000) * 1000000;
+            arg.ts = (uint64_t)(uintptr_t)&ts;
+        }
+    }
+
+    do {
+        rc = (int)syscall(__NR_io_uring_enter, r->ring_fd_p1 - 1, r->sq_queued,
+                min_complete, flags, (flags != 0) ? &arg : NULL,
+                (flags != 0) ? sizeof(arg) : 0);
+    } while ((rc < 0) && (errno == EINTR) && (min_complete == 0));
+
+    if (rc < 0) {
+        switch (errno) {
+        case EINTR:
+        case ETIME:
+            /* Signal or timeout while waiting */
+            return 0;
+
+        case EAGAIN:
+        case EBUSY:
+            /* Completions must be reaped before more can be submitted */
+            return WH_ERROR_NOTREADY;
+
+        default:
+            return WH_ERROR_ABORTED;
+        }
+    }
+
+    /* Returns the number of entries consumed */
+    if ((uint32_t)rc > r->sq_queued) {
+        rc = (int)r->sq_queued;
+    }
+    r->sq_queued -= (uint32_t)rc;
+    return 0;
+}
+
+static int posixTransportTcpUring_Queue(posixTransportTcpUringContext* r,
+        uint8_t opcode, int fd, void* addr, uint32_t len, uint16_t buf_index,
+        uint16_t ioprio, uint64_t user_data)
+{
+    int rc = 0;
+    uint32_t head = __atomic_load_n(r->sq_head, __ATOMIC_ACQUIRE);
+    uint32_t tail = *r->sq_tail;
+    uint32_t index = 0;
+    struct io_uring_sqe* sqe = NULL;
+
+    if ((tail - head) >= r->sq_entries) {
+        /* Full. Submit what is queued to make room */
+        rc = posixTransportTcpUring_Enter(r, 0, 0);
+        head = __atomic_load_n(r->sq_head, __ATOMIC_ACQUIRE);
+        if ((rc != 0) || ((tail - head) >= r->sq_entries)) {
+            return WH_ERROR_NOTREADY;
+        }
+    }
+
+    index = tail & r->sq_mask;
+    sqe = &r->sqes[index];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = opcode;
+    sqe->fd = fd;
+    sqe->ioprio = ioprio;
+    sqe->addr = (uint64_t)(uintptr_t)addr;
+    sqe->len = len;
+    sqe->buf_index = buf_index;
+    sqe->user_data = user_data;
+    if ((opcode == IORING_OP_READ_FIXED) || (opcode == IORING_OP_WRITE_FIXED)) {
+        /* Sockets have no file position */
+        sqe->off = (uint64_t)-1;
+    }
+    r->sq_array[index] = index;
+
+    /* Publish the entry. The kernel reads it on the next io_uring_enter() */
+    __atomic_store_n(r->sq_tail, tail + 1, __ATOMIC_RELEASE);
+    r->sq_queued++;
+    return 0;
+}
+
+static int posixTransportTcpUring_QueueRead(
+        posixTransportTcpUringServerContext* c)
+{
+    int rc = posixTransportTcpUring_Queue(c->ring, IORING_OP_READ_FIXED,
+            c->accept_fd_p1 - 1, &c->rx_buffer[c->rx_len],
+            PTT_BUFFER_SIZE - c->rx_len, PTT_URING_RX_BUF(c->index), 0,
+            PTT_URING_USER_DATA(PTT_URING_OP_READ, c->index, c->gen));
+    if (rc == 0) {
+        c->read_pending = 1;
+    }
+    return rc;
+}
+
+static int posixTransportTcpUring_QueueWrite(
+        posixTransportTcpUringServerContext* c)
+{
+    int rc = posixTransportTcpUring_Queue(c->ring, IORING_OP_WRITE_FIXED,
+            c->accept_fd_p1 - 1, &c->tx_buffer[c->tx_offset],
+            c->tx_len - c->tx_offset, PTT_URING_TX_BUF(c->index), 0,
+            PTT_URING_USER_DATA(PTT_URING_OP_WRITE, c->index, c->gen));
+    if (rc == 0) {
+        c->write_pending = 1;
+    }
+    return rc;
+}
+
+static int posixTransportTcpUring_RxPacket(
+        posixTransportTcpUringServerContext* c, uint32_t* out_size)
+{
+    uint32_t packet_len = 0;
+
+    if (c->rx_len < sizeof(uint32_t)) {
+        return 0;
+    }
+    memcpy(&packet_len, c->rx_buffer, sizeof(packet_len));
+    packet_len = ntohl(packet_len);
+    if ((packet_len == 0) || (packet_len > PTT_PACKET_MAX_SIZE)) {
+        /* Bad recv'ed size.  Assume fatal */
+        return WH_ERROR_ABORTED;
+    }
+    if (c->rx_len < sizeof(uint32_t) + packet_len) {
+        return 0;
+    }
+    *out_size = packet_len;
+    return 1;
+}
+
+static int posixTransportTcpUring_IsReady(
+        posixTransportTcpUringServerContext* c)
+{
+    uint32_t size = 0;
+
+    return  (c->accept_fd_p1 != 0) &&
+            (c->request_recv == 0) &&
+            (c->write_pending == 0) &&
+            (posixTransportTcpUring_RxPacket(c, &size) == 1);
+}
+
+static void posixTransportTcpUring_CloseConn(
+        posixTransportTcpUringServerContext* c)
+{
+    if (c->accept_fd_p1 != 0) {
+        /* Queued entries must reach the kernel before the fd number can be
+         * reused by a new connection */
+        if ((c->ring != NULL) && (c->ring->sq_queued > 0)) {
+            (void)posixTransportTcpUring_Enter(c->ring, 0, 0);
+        }
+        /* Shutdown completes any read in flight. The pending flags are cleared
+         * by the stale completions, which keeps the slot from being reused
+         * while the kernel still references its buffers */
+        (void)shutdown(c->accept_fd_p1 - 1, SHUT_RDWR);
+        close(c->accept_fd_p1 - 1);
+        c->accept_fd_p1 = 0;
+        c->gen++;
+        c->request_recv = 0;
+        c->rx_len = 0;
+        c->tx_len = 0;
+        c->tx_offset = 0;
+        if (c->connectcb != NULL) {
+            c->connectcb(c->connectcb_arg, WH_COMM_DISCONNECTED);
+        }
+    }
+}
+
+static void posixTransportTcpUring_Bind(posixTransportTcpUringContext* r,
+        int fd)
+{
+    int i = 0;
+    posixTransportTcpUringServerContext* c = NULL;
+
+    for (i = 0; i < PTT_URING_MAX_CONNECTIONS; i++) {
+        if (    (r->conn[i] != NULL) &&
+                (r->conn[i]->accept_fd_p1 == 0) &&
+                (r->conn[i]->read_pending == 0) &&
+                (r->conn[i]->write_pending == 0) ) {
+            c = r->conn[i];
+            break;
+        }
+    }
+    if (c == NULL) {
+        /* No free slot. Refuse the client */
+        close(fd);
+        return;
+    }
+
+    c->accept_fd_p1 = fd + 1;
+    c->request_recv = 0;
+    c->rx_len = 0;
+    c->tx_len = 0;
+    c->tx_offset = 0;
+    if (c->connectcb != NULL) {
+        c->connectcb(c->connectcb_arg, WH_COMM_CONNECTED);
+    }
+    if (posixTransportTcpUring_QueueRead(c) != 0) {
+        posixTransportTcpUring_CloseConn(c);
+    }
+}
+
+static void posixTransportTcpUring_Complete(posixTransportTcpUringContext* r,
+        uint64_t user_data, int32_t res, uint32_t flags)
+{
+    uint8_t op = PTT_URING_UD_OP(user_data);
+    uint16_t index = PTT_URING_UD_INDEX(user_data);
+    uint32_t size = 0;
+    int rc = 0;
+    posixTransportTcpUringServerContext* c = NULL;
+
+    if (op == PTT_URING_OP_ACCEPT) {
+        if ((flags & IORING_CQE_F_MORE) == 0) {
+            /* Multishot accept ended. Rearmed on the next poll */
+            r->accept_armed = 0;
+        }
+        if (res >= 0) {
+            posixTransportTcpUring_Bind(r, res);
+        }
+        return;
+    }
+
+    if (index >= PTT_URING_MAX_CONNECTIONS) {
+        return;
+    }
+    c = r->conn[index];
+    if (c == NULL) {
+        return;
+    }
+
+    if (op == PTT_URING_OP_READ) {
+        c->read_pending = 0;
+    }
+    else if (op == PTT_URING_OP_WRITE) {
+        c->write_pending = 0;
+    }
+    else {
+        return;
+    }
+
+    if (    (c->gen != PTT_URING_UD_GEN(user_data)) ||
+            (c->accept_fd_p1 == 0) ) {
+        /* Completion of a connection that was closed */
+        return;
+    }
+
+    if (res <= 0) {
+        /* Peer closed or fatal error. Free the slot */
+        posixTransportTcpUring_CloseConn(c);
+        return;
+    }
+
+    if (op == PTT_URING_OP_READ) {
+        c->rx_len += (uint16_t)res;
+        rc = posixTransportTcpUring_RxPacket(c, &size);
+        if (rc == 0) {
+            rc = posixTransportTcpUring_QueueRead(c);
+        }
+        if (rc < 0) {
+            posixTransportTcpUring_CloseConn(c);
+        }
+    }
+    else {
+        c->tx_offset += (uint16_t)res;
+        if (c->tx_offset < c->tx_len) {
+            /* Incomplete write */
+            if (posixTransportTcpUring_QueueWrite(c) != 0) {
+                posixTransportTcpUring_CloseConn(c);
+            }
+        }
+        else {
+            c->tx_len = 0;
+            c->tx_offset = 0;
+        }
+    }
+}
+
+
+/** Ring functions */
+
+int posixTransportTcpUring_Init(posixTransportTcpUringContext* ring,
+        const posixTransportTcpConfig* config)
+{
+    int rc;
+    int enable = 1;
+
+    if ( (ring == NULL) || (config == NULL)) {
+        return WH_ERROR_BADARGS;
+    }
+
+    memset(ring, 0, sizeof(*ring));
+
+    rc = inet_pton(AF_INET, config->server_ip_string,
+            &ring->server_addr.sin_addr);
+    if (rc != 1) {
+        return WH_ERROR_BADARGS;
+    }
+    ring->server_addr.sin_port = htons(config->server_port);
+    ring->server_addr.sin_family = AF_INET;
+
+    rc = socket(AF_INET, SOCK_STREAM, 0);
+    if (rc < 0) {
+        return WH_ERROR_ABORTED;
+    }
+    else if (rc <= 2) {
+        /* fd conflicts with stdin/stdout/stderr */
+        close(rc);
+        return WH_ERROR_ABORTED;
+    }
+    ring->listen_fd_p1 = rc + 1;
+
+    /* Ok to fail to reuse the address or share the port */
+    (void)setsockopt(ring->listen_fd_p1 - 1, SOL_SOCKET, SO_REUSEADDR,
+            &enable, sizeof(enable));
+#ifdef SO_REUSEPORT
+    (void)setsockopt(ring->listen_fd_p1 - 1, SOL_SOCKET, SO_REUSEPORT,
+            &enable, sizeof(enable));
+#endif
+
+    rc = bind(ring->listen_fd_p1 - 1,
+            (struct sockaddr*)&ring->server_addr,
+            sizeof(ring->server_addr));
+    if (rc == 0) {
+        rc = listen(ring->listen_fd_p1 - 1, SOMAXCONN);
+    }
+    if (rc == 0) {
+        rc = posixTransportTcpUring_RingInit(ring);
+    }
+    if (rc == 0) {
+        /* Accept clients as soon as they connect */
+        rc = posixTransportTcpUring_Queue(ring, IORING_OP_ACCEPT,
+                ring->listen_fd_p1 - 1, NULL, 0, 0, IORING_ACCEPT_MULTISHOT,
+                PTT_URING_USER_DATA(PTT_URING_OP_ACCEPT, 0, 0));
+    }
+    if (rc == 0) {
+        ring->accept_armed = 1;
+        rc = posixTransportTcpUring_Enter(ring, 0, 0);
+    }
+    if (rc != 0) {
+        (void)posixTransportTcpUring_Cleanup(ring);
+        return (rc == WH_ERROR_NOTIMPL) ? rc : WH_ERROR_ABORTED;
+    }
+    return 0;
+}
+
+int posixTransportTcpUring_Poll(posixTransportTcpUringContext* ring,
+        int timeout_ms, uint16_t* out_ready, uint16_t* inout_count)
+{
+    int rc = 0;
+    int i = 0;
+    int ready = 0;
+    uint16_t count = 0;
+    uint32_t head = 0;
+    uint32_t tail = 0;
+    struct io_uring_cqe cqe;
+
+    if (    (ring == NULL) ||
+            (ring->ring_fd_p1 == 0) ||
+            (out_ready == NULL) ||
+            (inout_count == NULL) ) {
+        return WH_ERROR_BADARGS;
+    }
+
+    if (ring->accept_armed == 0) {
+        rc = posixTransportTcpUring_Queue(ring, IORING_OP_ACCEPT,
+                ring->listen_fd_p1 - 1, NULL, 0, 0, IORING_ACCEPT_MULTISHOT,
+                PTT_URING_USER_DATA(PTT_URING_OP_ACCEPT, 0, 0));
+        if (rc == 0) {
+            ring->accept_armed = 1;
+        }
+    }
+
+    /* Only wait if there is nothing to do yet */
+    for (i = 0; (i < PTT_URING_MAX_CONNECTIONS) && (ready == 0); i++) {
+        ready = (ring->conn[i] != NULL) &&
+                posixTransportTcpUring_IsReady(ring->conn[i]);
+    }
+    head = *ring->cq_head;
+    tail = __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE);
+
+    /* Submit everything queued since the last call and wait in one call */
+    if (    (ring->sq_queued > 0) ||
+            ((timeout_ms != 0) && (ready == 0) && (head == tail)) ) {
+        rc = posixTransportTcpUring_Enter(ring,
+                ((timeout_ms != 0) && (ready == 0) && (head == tail)) ? 1 : 0,
+                timeout_ms);
+        if ((rc != 0) && (rc != WH_ERROR_NOTREADY)) {
+            return rc;
+        }
+    }
+
+    /* Reap all completions */
+    head = *ring->cq_head;
+    tail = __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE);
+    while (head != tail) {
+        cqe = ring->cqes[head & ring->cq_mask];
+        head++;
+        __atomic_store_n(ring->cq_head, head, __ATOMIC_RELEASE);
+        posixTransportTcpUring_Complete(ring, cqe.user_data, cqe.res,
+                cqe.flags);
+        tail = __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE);
+    }
+
+    for (i = 0; i < PTT_URING_MAX_CONNECTIONS; i++) {
+        if (    (ring->conn[i] != NULL) &&
+                posixTransportTcpUring_IsReady(ring->conn[i]) &&
+                (count < *inout_count) ) {
+            out_ready[count++] = ring->conn[i]->index;
+        }
+    }
+
+    *inout_count = count;
+    return 0;
+}
+
+int posixTransportTcpUring_Submit(posixTransportTcpUringContext* ring)
+{
+    if (    (ring == NULL) ||
+            (ring->ring_fd_p1 == 0) ) {
+        return WH_ERROR_BADARGS;
+    }
+    if (ring->sq_queued == 0) {
+        return 0;
+    }
+    return posixTransportTcpUring_Enter(ring, 0, 0);
+}
+
+int posixTransportTcpUring_Cleanup(posixTransportTcpUringContext* ring)
+{
+    if (ring == NULL) {
+        return WH_ERROR_BADARGS;
+    }
+
+    /* Closing the ring cancels all operations in flight */
+    if (ring->sqes != NULL) {
+        (void)munmap(ring->sqes, ring->sqes_size);
+        ring->sqes = NULL;
+    }
+    if (ring->ring_mem != NULL) {
+        (void)munmap(ring->ring_mem, ring->ring_size);
+        ring->ring_mem = NULL;
+    }
+    if (ring->ring_fd_p1 != 0) {
+        close(ring->ring_fd_p1 - 1);
+        ring->ring_fd_p1 = 0;
+    }
+    if (ring->listen_fd_p1 != 0) {
+        close(ring->listen_fd_p1 - 1);
+        ring->listen_fd_p1 = 0;
+    }
+    ring->sq_queued = 0;
+    ring->accept_armed = 0;
+    return 0;
+}
+
+int posixTransportTcpUring_GetRingFd(posixTransportTcpUringContext* ring,
+        int* out_fd)
+{
+    if (ring == NULL) {
+        return WH_ERROR_BADARGS;
+    }
+    if (ring->ring_fd_p1 == 0) {
+        return WH_ERROR_NOTREADY;
+    }
+    if (out_fd != NULL) {
+        *out_fd = ring->ring_fd_p1 - 1;
+    }
+    return WH_ERROR_OK;
+}
+
+
+/** Connection slot functions */
+
+int posixTransportTcpUring_InitServer(void* context, const void* config,
+        whCommSetConnectedCb connectcb, void* connectcb_arg)
+{
+    int rc = 0;
+    posixTransportTcpUringServerContext* c = context;
+    const posixTransportTcpUringServerConfig* cf = config;
+    struct io_uring_rsrc_update2 up;
+    struct iovec iov[2];
+
+    if (    (c == NULL) ||
+            (cf == NULL) ||
+            (cf->ring == NULL) ||
+            (cf->ring->ring_fd_p1 == 0) ||
+            (cf->index >= PTT_URING_MAX_CONNECTIONS) ) {
+        return WH_ERROR_BADARGS;
+    }
+
+    if (    (cf->ring->conn[cf->index] != NULL) &&
+            (cf->ring->conn[cf->index] != c) ) {
+        /* Slot is owned by another context */
+        return WH_ERROR_BADARGS;
+    }
+
+    memset(c, 0, sizeof(*c));
+    c->ring = cf->ring;
+    c->index = cf->index;
+    c->connectcb = connectcb;
+    c->connectcb_arg = connectcb_arg;
+
+    /* Register the buffers of the slot with the ring */
+    iov[0].iov_base = c->rx_buffer;
+    iov[0].iov_len  = sizeof(c->rx_buffer);
+    iov[1].iov_base = c->tx_buffer;
+    iov[1].iov_len  = sizeof(c->tx_buffer);
+    memset(&up, 0, sizeof(up));
+    up.offset = PTT_URING_RX_BUF(c->index);
+    up.data   = (uint64_t)(uintptr_t)iov;
+    up.nr     = 2;
+    rc = (int)syscall(__NR_io_uring_register, c->ring->ring_fd_p1 - 1,
+            IORING_REGISTER_BUFFERS_UPDATE, &up, sizeof(up));
+    if (rc != 2) {
+        return WH_ERROR_ABORTED;
+    }
+
+    /* Register the slot. Clients are bound to it as they connect */
+    cf->ring->conn[cf->index] = c;
+    return 0;
+}
+
+int posixTransportTcpUring_RecvRequest(void* context,
+        uint16_t* out_size, void* data)
+{
+    posixTransportTcpUringServerContext* c = context;
+    uint32_t size = 0;
+    uint16_t consumed = 0;
+
+    if (    (c == NULL) ||
+            (c->ring == NULL) ) {
+        return WH_ERROR_BADARGS;
+    }
+
+    if (    (posixTransportTcpUring_IsReady(c) == 0) ||
+            (c->read_pending != 0) ) {
+        /* No client, no complete request yet, or still working on one */
+        return WH_ERROR_NOTREADY;
+    }
+    (void)posixTransportTcpUring_RxPacket(c, &size);
+
+    if (data != NULL) {
+        memcpy(data, &c->rx_buffer[sizeof(uint32_t)], size);
+    }
+    if (out_size != NULL) {
+        *out_size = (uint16_t)size;
+    }
+    c->request_recv = 1;
+
+    /* Keep any data of the next request */
+    consumed = (uint16_t)(sizeof(uint32_t) + size);
+    c->rx_len -= consumed;
+    if (c->rx_len > 0) {
+        memmove(c->rx_buffer, &c->rx_buffer[consumed], c->rx_len);
+    }
+    if (posixTransportTcpUring_RxPacket(c, &size) == 0) {
+        if (posixTransportTcpUring_QueueRead(c) != 0) {
+            posixTransportTcpUring_CloseConn(c);
+        }
+    }
+    return 0;
+}
+
+int posixTransportTcpUring_SendResponse(void* context,
+        uint16_t size, const void* data)
+{
+    int rc = 0;
+    uint32_t packet_len = 0;
+    posixTransportTcpUringServerContext* c = context;
+
+    if (    (c == NULL) ||
+            (c->accept_fd_p1 == 0) ||
+            (size == 0) ||
+            (size > PTT_PACKET_MAX_SIZE) ||
+            (data == NULL) ) {
+        return WH_ERROR_BADARGS;
+    }
+
+    if (c->request_recv == 0) {
+        return WH_ERROR_NOTREADY;
+    }
+
+    /* Prepend packet data with the size in network order */
+    packet_len = htonl((uint32_t)size);
+    memcpy(c->tx_buffer, &packet_len, sizeof(packet_len));
+    memcpy(&c->tx_buffer[sizeof(packet_len)], data, size);
+    c->tx_len = (uint16_t)(sizeof(packet_len) + size);
+    c->tx_offset = 0;
+
+    /* Written on the next submission */
+    rc = posixTransportTcpUring_QueueWrite(c);
+    if (rc != 0) {
+        /* Assume fatal error and free the slot */
+        posixTransportTcpUring_CloseConn(c);
+        return WH_ERROR_ABORTED;
+    }
+    c->request_recv = 0;
+    return 0;
+}
+
+int posixTransportTcpUring_CompleteRequest(void* context)
+{
+    posixTransportTcpUringServerContext* c = context;
+    if (c == NULL) {
+        return WH_ERROR_BADARGS;
+    }
+
+    /* No response for this request. The next one may be delivered */
+    c->request_recv = 0;
+    return 0;
+}
+
+int posixTransportTcpUring_CleanupServer(void* context)
+{
+    posixTransportTcpUringServerContext* c = context;
+    struct io_uring_rsrc_update2 up;
+    struct iovec iov[2];
+
+    if (c == NULL) {
+        return WH_ERROR_BADARGS;
+    }
+
+    posixTransportTcpUring_CloseConn(c);
+
+    /* Deregister the slot and its buffers */
+    if (    (c->ring != NULL) &&
+            (c->ring->conn[c->index] == c) ) {
+        if (c->ring->ring_fd_p1 != 0) {
+            memset(iov, 0, sizeof(iov));
+            memset(&up, 0, sizeof(up));
+            up.offset = PTT_URING_RX_BUF(c->index);
+            up.data   = (uint64_t)(uintptr_t)iov;
+            up.nr     = 2;
+            (void)syscall(__NR_io_uring_register, c->ring->ring_fd_p1 - 1,
+                    IORING_REGISTER_BUFFERS_UPDATE, &up, sizeof(up));
+        }
+        c->ring->conn[c->index] = NULL;
+    }
+    return 0;
+}
+
+#endif /* PTT_URING_SUPPORTED */
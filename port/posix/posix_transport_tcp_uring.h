@@ -0,0 +1,203 @@
+/*
+ * Copyright (C) 2025 wolfSSL Inc.
+ *
+ * This file is part of wolfHSM.
+ *
+ * wolfHSM is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * wolfHSM is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with wolfHSM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/*
+ * port/posix/posix_transport_tcp_uring.h
+ *
+ * wolfHSM multi-connection TCP server transport using io_uring
+ *
+ * This is a variant of the multi-connection TCP server (PTT_MUX_SERVER_CB) that
+ * performs all socket I/O through an io_uring instance instead of epoll and
+ * non-blocking recv/send.  Packets use the same framing as
+ * posix_transport_tcp.h, so clients use the unchanged PTT_CLIENT_CB.
+ *
+ * The ring owns a single listen socket with one multishot accept, so new
+ * clients are accepted without resubmitting.  Each connection slot has a
+ * receive and a transmit buffer registered with the ring, so reads and writes
+ * use IORING_OP_READ_FIXED and IORING_OP_WRITE_FIXED without mapping user
+ * pages on every operation.
+ *
+ * Operations are queued and only submitted by posixTransportTcpUring_Poll()
+ * or posixTransportTcpUring_Submit(), so a single io_uring_enter() both
+ * submits every response and read queued since the last call and waits for
+ * new completions.  Note that a response passed to
+ * posixTransportTcpUring_SendResponse() is not sent until the next Poll or
+ * Submit.  The next request of a slot is not delivered until its previous
+ * response has been written.
+ *
+ * As with the epoll variant, the application provides one slot context per
+ * simultaneous client, each used as the transport context of its own
+ * whServerContext.  Connections beyond the number of free slots are closed
+ * immediately.  A single thread must call Poll and handle the requests of the
+ * slots it reports.
+ *
+ * Example usage:
+ *
+ * posixTransportTcpUringContext ring[1] = {0};
+ * posixTransportTcpUring_Init(ring, pttcfg);
+ *
+ * wh_TransportServer_Cb ringcb[1] = {PTT_URING_SERVER_CB};
+ * posixTransportTcpUringServerContext conn[N] = {0};
+ * posixTransportTcpUringServerConfig conncfg[N] = {{.ring = ring, .index = 0},
+ *                                                   ..};
+ * whCommServerConfig csc[N] = {{
+ *      .transport_cb = ringcb,
+ *      .transport_context = &conn[i],
+ *      .transport_config = &conncfg[i],
+ *      .server_id = 0xF,
+ * }, ..};
+ * ... wh_Server_Init(&server[i], ...) for each slot ...
+ *
+ * while (1) {
+ *      uint16_t ready[N];
+ *      uint16_t count = N;
+ *      posixTransportTcpUring_Poll(ring, -1, ready, &count);
+ *      for (j = 0; j < count; j++) {
+ *          wh_Server_HandleRequestMessage(&server[ready[j]]);
+ *      }
+ * }
+ *
+ * Only available on Linux with io_uring headers from 5.19 or later.
+ */
+
+#ifndef PORT_POSIX_POSIX_TRANSPORT_TCP_URING_H_
+#define PORT_POSIX_POSIX_TRANSPORT_TCP_URING_H_
+
+#if defined(__linux__)
+#include <linux/io_uring.h>
+#endif
+
+#if defined(__linux__) && defined(IORING_ACCEPT_MULTISHOT) && \
+    defined(IORING_RSRC_REGISTER_SPARSE)
+#define PTT_URING_SUPPORTED
+
+#include <stdint.h>
+#include <stddef.h>  /* For size_t */
+#include <netinet/in.h>
+
+#include "wolfhsm/wh_comm.h"
+#include "port/posix/posix_transport_tcp.h"
+
+/* Maximum number of connection slots per ring */
+#ifndef PTT_URING_MAX_CONNECTIONS
+#define PTT_URING_MAX_CONNECTIONS 64
+#endif
+
+/* Number of submission queue entries. Each slot has at most one read and one
+ * write in flight, plus the multishot accept */
+#ifndef PTT_URING_QUEUE_DEPTH
+#define PTT_URING_QUEUE_DEPTH (2 * PTT_URING_MAX_CONNECTIONS + 2)
+#endif
+
+typedef struct posixTransportTcpUringContext_t posixTransportTcpUringContext;
+
+/* Per-connection slot configuration */
+typedef struct {
+    posixTransportTcpUringContext* ring;
+    uint16_t index; /* Slot number, less than PTT_URING_MAX_CONNECTIONS */
+    uint8_t WH_PAD[6];
+} posixTransportTcpUringServerConfig;
+
+/* Per-connection slot context, used as a server transport context.  The
+ * buffers are registered with the ring, so the context must not move while
+ * the slot is initialized. */
+typedef struct {
+    posixTransportTcpUringContext* ring;
+    whCommSetConnectedCb connectcb;
+    void* connectcb_arg;
+    int accept_fd_p1;       /* fd plus 1 so 0 is invalid */
+    int request_recv;       /* Request delivered, awaiting its response */
+    uint32_t gen;           /* Connection generation, to drop stale CQEs */
+    uint16_t index;
+    uint16_t rx_len;        /* Bytes received into rx_buffer */
+    uint16_t tx_len;        /* Bytes of tx_buffer to write */
+    uint16_t tx_offset;     /* Bytes of tx_buffer already written */
+    uint8_t read_pending;   /* Read submitted, not yet completed */
+    uint8_t write_pending;  /* Write submitted, not yet completed */
+    uint8_t rx_buffer[PTT_BUFFER_SIZE];
+    uint8_t tx_buffer[PTT_BUFFER_SIZE];
+} posixTransportTcpUringServerContext;
+
+struct posixTransportTcpUringContext_t {
+    struct sockaddr_in server_addr;
+    int listen_fd_p1;       /* fd plus 1 so 0 is invalid */
+    int ring_fd_p1;         /* fd plus 1 so 0 is invalid */
+    void* ring_mem;         /* Shared SQ and CQ ring mapping */
+    size_t ring_size;
+    struct io_uring_sqe* sqes;
+    size_t sqes_size;
+    uint32_t* sq_head;
+    uint32_t* sq_tail;
+    uint32_t* sq_array;
+    struct io_uring_cqe* cqes;
+    uint32_t* cq_head;
+    uint32_t* cq_tail;
+    uint32_t sq_mask;
+    uint32_t cq_mask;
+    uint32_t sq_entries;
+    uint32_t sq_queued;     /* Entries queued but not yet submitted */
+    int accept_armed;       /* Multishot accept is active */
+    posixTransportTcpUringServerContext* conn[PTT_URING_MAX_CONNECTIONS];
+};
+
+/* Create the listen socket and the ring, and arm the multishot accept. Returns
+ * WH_ERROR_NOTIMPL if io_uring is unavailable or the kernel is too old */
+int posixTransportTcpUring_Init(posixTransportTcpUringContext* ring,
+        const posixTransportTcpConfig* config);
+
+/* Submit queued operations, then reap completions and report slots with
+ * pending requests. Waits up to timeout_ms milliseconds for a completion if no
+ * slot is ready (-1 waits indefinitely, 0 returns immediately). On input,
+ * inout_count holds the capacity of out_ready. On output, it holds the number
+ * of slot indices written to out_ready. */
+int posixTransportTcpUring_Poll(posixTransportTcpUringContext* ring,
+        int timeout_ms, uint16_t* out_ready, uint16_t* inout_count);
+
+/* Submit queued operations, such as responses, without waiting */
+int posixTransportTcpUring_Submit(posixTransportTcpUringContext* ring);
+
+/* Close the listen socket and the ring. Slots must be cleaned up separately
+ * through their servers. */
+int posixTransportTcpUring_Cleanup(posixTransportTcpUringContext* ring);
+
+/* Return the ring file descriptor to nest within another event loop. It is
+ * readable when completions are pending. */
+int posixTransportTcpUring_GetRingFd(posixTransportTcpUringContext* ring,
+        int* out_fd);
+
+int posixTransportTcpUring_InitServer(void* context, const void* config,
+        whCommSetConnectedCb connectcb, void* connectcb_arg);
+int posixTransportTcpUring_RecvRequest(void* context, uint16_t *out_size,
+        void* data);
+int posixTransportTcpUring_SendResponse(void* context, uint16_t size,
+        const void* data);
+int posixTransportTcpUring_CompleteRequest(void* context);
+int posixTransportTcpUring_CleanupServer(void* context);
+
+#define PTT_URING_SERVER_CB                                 \
+{                                                           \
+    .Init =     posixTransportTcpUring_InitServer,          \
+    .Recv =     posixTransportTcpUring_RecvRequest,         \
+    .Send =     posixTransportTcpUring_SendResponse,        \
+    .Cleanup =  posixTransportTcpUring_CleanupServer,       \
+    .Complete = posixTransportTcpUring_CompleteRequest,     \
+}
+
+#endif /* __linux__ && IORING_ACCEPT_MULTISHOT && ... */
+
+#endif /* !PORT_POSIX_POSIX_TRANSPORT_TCP_URING_H_ */
@@ -39,7 +39,9 @@
 #include <arpa/inet.h>
 #include <errno.h>
 #include <fcntl.h>
+#include <limits.h>
 #include <poll.h>
+#include <sys/stat.h>
 
 
 /* Compile-time check: TLS recv functions pass PTTLS_PACKET_MAX_SIZE to
@@ -104,6 +106,181 @@ static int LoadTlsCertificates(WOLFSSL_CTX*                   ssl_ctx,
 
     return WH_ERROR_OK;
 }
+
+#if !defined(NO_SESSION_CACHE) && \
+    (defined(OPENSSL_EXTRA) || defined(HAVE_EXT_CACHE))
+#define PTTLS_SESSION_FILE
+
+/* Upper bound on the size of a serialized session file */
+#define PTTLS_SESSION_FILE_MAX_SIZE (16 * 1024)
+
+/* Load a session previously saved by SaveTlsSession. Returns NULL if the file
+ * does not exist, does not hold a valid session, or could have been written or
+ * read by another user */
+static WOLFSSL_SESSION* LoadTlsSession(const char* path)
+{
+    WOLFSSL_SESSION*     session = NULL;
+    const unsigned char* p;
+    unsigned char*       buf;
+    struct stat          st;
+    ssize_t              rc;
+    int                  fd;
+
+    fd = open(path, O_RDONLY | O_NOFOLLOW | O_CLOEXEC);
+    if (fd < 0) {
+        return NULL;
+    }
+    if ((fstat(fd, &st) != 0) || !S_ISREG(st.st_mode) ||
+        (st.st_uid != geteuid()) ||
+        ((st.st_mode & (S_IRWXG | S_IRWXO)) != 0) || (st.st_size <= 0) ||
+        (st.st_size > PTTLS_SESSION_FILE_MAX_SIZE)) {
+        close(fd);
+        return NULL;
+    }
+    buf = (unsigned char*)malloc((size_t)st.st_size);
+    if (buf == NULL) {
+        close(fd);
+        return NULL;
+    }
+    rc = read(fd, buf, (size_t)st.st_size);
+    close(fd);
+    if (rc == (ssize_t)st.st_size) {
+        p       = buf;
+        session = wolfSSL_d2i_SSL_SESSION(NULL, &p, (long)st.st_size);
+    }
+    /* The serialized session holds the master secret */
+    memset(buf, 0, (size_t)st.st_size);
+    free(buf);
+    return session;
+}
+
+/* Save a session to a file only readable by the owner. The session is written
+ * to a new temporary file that then replaces path, so path is never followed
+ * as a symlink or left partly written */
+static int SaveTlsSession(const char* path, WOLFSSL_SESSION* session)
+{
+    char           tmp[PATH_MAX];
+    unsigned char* buf;
+    unsigned char* p;
+    ssize_t        rc;
+    size_t         off;
+    int            len;
+    int            fd;
+    int            ret = WH_ERROR_OK;
+
+    rc = snprintf(tmp, sizeof(tmp), "%s.%ld.tmp", path, (long)getpid());
+    if ((rc < 0) || ((size_t)rc >= sizeof(tmp))) {
+        return WH_ERROR_BADARGS;
+    }
+
+    len = wolfSSL_i2d_SSL_SESSION(session, NULL);
+    if ((len <= 0) || (len > PTTLS_SESSION_FILE_MAX_SIZE)) {
+        return WH_ERROR_ABORTED;
+    }
+    buf = (unsigned char*)malloc((size_t)len);
+    if (buf == NULL) {
+        return WH_ERROR_ABORTED;
+    }
+    p = buf;
+    if (wolfSSL_i2d_SSL_SESSION(session, &p) != len) {
+        free(buf);
+        return WH_ERROR_ABORTED;
+    }
+
+    fd = open(tmp, O_WRONLY | O_CREAT | O_EXCL | O_NOFOLLOW | O_CLOEXEC,
+              S_IRUSR | S_IWUSR);
+    if ((fd < 0) && (errno == EEXIST)) {
+        /* Left by an earlier process with the same pid */
+        (void)unlink(tmp);
+        fd = open(tmp, O_WRONLY | O_CREAT | O_EXCL | O_NOFOLLOW | O_CLOEXEC,
+                  S_IRUSR | S_IWUSR);
+    }
+    if (fd < 0) {
+        ret = WH_ERROR_ABORTED;
+    }
+    else {
+        /* The umask may only remove permissions, but be explicit */
+        if (fchmod(fd, S_IRUSR | S_IWUSR) != 0) {
+            ret = WH_ERROR_ABORTED;
+        }
+        for (off = 0; (ret == WH_ERROR_OK) && (off < (size_t)len);) {
+            rc = write(fd, buf + off, (size_t)len - off);
+            if (rc > 0) {
+                off += (size_t)rc;
+            }
+            else if ((rc < 0) && (errno == EINTR)) {
+                continue;
+            }
+            else {
+                ret = WH_ERROR_ABORTED;
+            }
+        }
+        if ((ret == WH_ERROR_OK) && (fsync(fd) != 0)) {
+            ret = WH_ERROR_ABORTED;
+        }
+        if ((close(fd) != 0) && (ret == WH_ERROR_OK)) {
+            ret = WH_ERROR_ABORTED;
+        }
+        if ((ret == WH_ERROR_OK) && (rename(tmp, path) != 0)) {
+            ret = WH_ERROR_ABORTED;
+        }
+        if (ret != WH_ERROR_OK) {
+            (void)unlink(tmp);
+        }
+    }
+    memset(buf, 0, (size_t)len);
+    free(buf);
+    return ret;
+}
+#endif /* !NO_SESSION_CACHE && (OPENSSL_EXTRA || HAVE_EXT_CACHE) */
+
+#ifndef NO_SESSION_CACHE
+/* Session to offer for resumption. The application cache takes precedence
+ * over the session loaded from the file */
+static WOLFSSL_SESSION*
+GetResumeSession(posixTransportTlsClientContext* ctx)
+{
+    if (!ctx->session_resume) {
+        return NULL;
+    }
+    if ((ctx->session_cache != NULL) && (ctx->session_cache->session != NULL)) {
+        return ctx->session_cache->session;
+    }
+    return ctx->session;
+}
+
+/* Keep the session of the established connection for the next connect */
+static void StoreResumeSession(posixTransportTlsClientContext* ctx)
+{
+    WOLFSSL_SESSION* session;
+
+    if (!ctx->session_resume || (ctx->ssl == NULL) ||
+        (ctx->state != PTTLS_STATE_CONNECTED)) {
+        return;
+    }
+
+    session = wolfSSL_get1_session(ctx->ssl);
+    if (session == NULL) {
+        return;
+    }
+
+#ifdef PTTLS_SESSION_FILE
+    if (ctx->session_file != NULL) {
+        (void)SaveTlsSession(ctx->session_file, session);
+    }
+#endif
+
+    if (ctx->session_cache != NULL) {
+        if (ctx->session_cache->session != NULL) {
+            wolfSSL_SESSION_free(ctx->session_cache->session);
+        }
+        ctx->session_cache->session = session;
+    }
+    else {
+        wolfSSL_SESSION_free(session);
+    }
+}
+#endif /* !NO_SESSION_CACHE */
 #endif /* WOLFHSM_CFG_NO_CRYPTO */
 
 /** Client-side TLS transport functions */
@@ -158,6 +335,37 @@ int posixTransportTls_InitConnect(void* context, const void* config,
     }
 #endif /* NO_PSK */
 
+    /* Setup session resumption if a session cache or file is provided */
+    if (!cfg->disable_session_resumption &&
+        ((cfg->session_cache != NULL) || (cfg->session_file != NULL))) {
+#ifndef NO_SESSION_CACHE
+#ifndef PTTLS_SESSION_FILE
+        if (cfg->session_file != NULL) {
+            wolfSSL_CTX_free(ctx->ssl_ctx);
+            ctx->ssl_ctx = NULL;
+            return WH_ERROR_NOTIMPL;
+        }
+#endif
+#ifdef HAVE_SESSION_TICKET
+        (void)wolfSSL_CTX_UseSessionTicket(ctx->ssl_ctx);
+#endif
+        ctx->session_resume = 1;
+        ctx->session_cache  = cfg->session_cache;
+        ctx->session_file   = cfg->session_file;
+#ifdef PTTLS_SESSION_FILE
+        if ((ctx->session_file != NULL) &&
+            ((ctx->session_cache == NULL) ||
+             (ctx->session_cache->session == NULL))) {
+            ctx->session = LoadTlsSession(ctx->session_file);
+        }
+#endif
+#else
+        wolfSSL_CTX_free(ctx->ssl_ctx);
+        ctx->ssl_ctx = NULL;
+        return WH_ERROR_NOTIMPL;
+#endif /* !NO_SESSION_CACHE */
+    }
+
     /* Setup underlying TCP transport */
     rc = posixTransportTcp_InitConnect((void*)&ctx->tcpCtx, cfg, connectcb,
                                        connectcb_arg);
@@ -166,6 +374,10 @@ int posixTransportTls_InitConnect(void* context, const void* config,
             wolfSSL_CTX_free(ctx->ssl_ctx);
             ctx->ssl_ctx = NULL;
         }
+        if (ctx->session != NULL) {
+            wolfSSL_SESSION_free(ctx->session);
+            ctx->session = NULL;
+        }
         return rc;
     }
 
@@ -232,6 +444,14 @@ int posixTransportTls_SendRequest(void* context, uint16_t size,
                 posixTransportTcp_CleanupConnect((void*)&ctx->tcpCtx);
                 return WH_ERROR_ABORTED;
             }
+
+#ifndef NO_SESSION_CACHE
+            /* Offer the previous session for an abbreviated handshake. A
+             * stale or rejected session falls back to a full handshake */
+            if (GetResumeSession(ctx) != NULL) {
+                (void)wolfSSL_set_session(ctx->ssl, GetResumeSession(ctx));
+            }
+#endif
         }
 
         rc  = wolfSSL_connect(ctx->ssl);
@@ -267,7 +487,8 @@ int posixTransportTls_SendRequest(void* context, uint16_t size,
             }
         }
         else {
-            ctx->state = PTTLS_STATE_CONNECTED;
+            ctx->state          = PTTLS_STATE_CONNECTED;
+            ctx->session_reused = wolfSSL_session_reused(ctx->ssl);
         }
     }
 
@@ -339,18 +560,28 @@ int posixTransportTls_CleanupConnect(void* context)
         return WH_ERROR_BADARGS;
     }
 
+#ifndef NO_SESSION_CACHE
+    StoreResumeSession(ctx);
+#endif
+
     if (ctx->ssl) {
         (void)wolfSSL_shutdown(ctx->ssl);
         wolfSSL_free(ctx->ssl);
         ctx->ssl = NULL;
     }
 
+    if (ctx->session) {
+        wolfSSL_SESSION_free(ctx->session);
+        ctx->session = NULL;
+    }
+
     if (ctx->ssl_ctx) {
         (void)wolfSSL_CTX_free(ctx->ssl_ctx);
         ctx->ssl_ctx = NULL;
     }
 
-    ctx->state         = PTTLS_STATE_UNCONNECTED;
+    ctx->state          = PTTLS_STATE_UNCONNECTED;
+    ctx->session_reused = 0;
     ctx->connect_fd_p1 = 0;
     posixTransportTcp_CleanupConnect((void*)&ctx->tcpCtx);
     return WH_ERROR_OK;
@@ -436,6 +667,24 @@ int posixTransportTls_InitListen(void* context, const void* config,
     }
 #endif /* NO_PSK */
 
+    /* Returning clients resume from the wolfSSL session cache or with session
+     * tickets, which are both enabled by default. Turn them off to force a
+     * full handshake on every connect */
+    if (cfg->disable_session_resumption) {
+#ifndef NO_SESSION_CACHE
+        (void)wolfSSL_CTX_set_session_cache_mode(ctx->ssl_ctx,
+                                                 WOLFSSL_SESS_CACHE_OFF);
+#endif
+#ifdef HAVE_SESSION_TICKET
+#ifndef WOLFSSL_NO_TLS12
+        (void)wolfSSL_CTX_NoTicketTLSv12(ctx->ssl_ctx);
+#endif
+#ifdef WOLFSSL_TLS13
+        (void)wolfSSL_CTX_no_ticket_TLSv13(ctx->ssl_ctx);
+#endif
+#endif /* HAVE_SESSION_TICKET */
+    }
+
     if (ctx->connectcb != NULL) {
         ctx->connectcb(ctx->connectcb_arg, WH_COMM_CONNECTED);
     }
@@ -543,7 +792,12 @@ int posixTransportTls_RecvRequest(void* context, uint16_t* out_size, void* data)
         return WH_ERROR_NOTREADY;
     }
     else {
-        /* Connection closed */
+        /* Connection closed. Release it so the next call accepts a new
+         * client, which may resume the session of this one */
+        wolfSSL_free(ctx->ssl);
+        ctx->ssl = NULL;
+        close(ctx->accept_fd_p1 - 1);
+        ctx->accept_fd_p1 = 0;
         return WH_ERROR_ABORTED;
     }
 #else
@@ -627,6 +881,37 @@ int posixTransportTls_CleanupListen(void* context)
 #endif
 }
 
+int posixTransportTls_SessionReused(posixTransportTlsClientContext* context,
+                                    int*                            out_reused)
+{
+    if ((context == NULL) || (out_reused == NULL)) {
+        return WH_ERROR_BADARGS;
+    }
+    if (context->state != PTTLS_STATE_CONNECTED) {
+        return WH_ERROR_NOTREADY;
+    }
+#ifndef WOLFHSM_CFG_NO_CRYPTO
+    *out_reused = context->session_reused;
+#else
+    *out_reused = 0;
+#endif
+    return WH_ERROR_OK;
+}
+
+int posixTransportTls_FreeSessionCache(posixTransportTlsSessionCache* cache)
+{
+    if (cache == NULL) {
+        return WH_ERROR_BADARGS;
+    }
+#ifndef WOLFHSM_CFG_NO_CRYPTO
+    if (cache->session != NULL) {
+        wolfSSL_SESSION_free(cache->session);
+    }
+#endif
+    cache->session = NULL;
+    return WH_ERROR_OK;
+}
+
 /* Return the file descriptor of the listen socket to support poll/select */
 int posixTransportTls_GetListenFd(posixTransportTlsServerContext* context,
                                   int*                            out_fd)
@@ -24,6 +24,15 @@
  * This transport extends the TCP transport with TLS encryption using
  * wolfSSL's embedded certificate buffers for authentication.
  *
+ * Reconnecting clients may resume their previous TLS session to skip the full
+ * handshake.  The client keeps the session in an application-owned
+ * posixTransportTlsSessionCache referenced by the config, so it survives
+ * wh_Client_Cleanup()/wh_Client_Init(), and optionally in config->session_file
+ * so it survives process restarts.  The server uses the wolfSSL session cache
+ * and session tickets, and accepts a new client after the previous one
+ * disconnects.  Session resumption may be disabled on either side using
+ * config->disable_session_resumption.
+ *
  */
 
 #ifndef PORT_POSIX_POSIX_TRANSPORT_TLS_H_
@@ -48,6 +57,14 @@
 #define PTTLS_PACKET_MAX_SIZE WH_COMM_MTU
 #define PTTLS_BUFFER_SIZE (sizeof(uint32_t) + PTTLS_PACKET_MAX_SIZE)
 
+/** Client session cache.  Owned by the application and shared by reference
+ * in the config so the last session of the client outlives the transport
+ * context.  Zero initialize before first use and release the session using
+ * posixTransportTls_FreeSessionCache() when no longer needed. */
+typedef struct {
+    WOLFSSL_SESSION* session; /* Last session of the client, or NULL */
+} posixTransportTlsSessionCache;
+
 /** TLS configuration structure */
 typedef struct {
     char* server_ip_string;
@@ -91,6 +108,16 @@ typedef struct {
 #endif                             /* NO_PSK */
     void* heap_hint; /* A pointer to a WOLFSSL_HEAP_HINT structure for static
                       * memory allocation */
+    /* Session resumption configuration */
+    bool disable_session_resumption; /* Whether to always perform a full
+                              handshake, defaults to allowing resumption */
+    posixTransportTlsSessionCache* session_cache; /* Client only. Optional
+                                                   * in-memory session cache */
+    const char* session_file; /* Client only. Optional file used to persist the
+                               * session across processes. Requires
+                               * OPENSSL_EXTRA or HAVE_EXT_CACHE in wolfSSL.
+                               * Ignored unless owned by the user and not
+                               * accessible by group or others */
 } posixTransportTlsConfig;
 
 /** Client context and functions */
@@ -111,6 +138,11 @@ typedef struct {
 #ifndef WOLFHSM_CFG_NO_CRYPTO
     WOLFSSL_CTX* ssl_ctx;
     WOLFSSL*     ssl;
+    WOLFSSL_SESSION*               session; /* Loaded from session_file */
+    posixTransportTlsSessionCache* session_cache;
+    const char*                    session_file;
+    int                            session_resume; /* Resumption enabled */
+    int                            session_reused; /* Handshake resumed */
 #endif
     posixTransportTcpClientContext tcpCtx;
 } posixTransportTlsClientContext;
@@ -136,6 +168,14 @@ int posixTransportTls_CleanupConnect(void* context);
 int posixTransportTls_GetConnectFd(posixTransportTlsClientContext* context,
                                    int*                            out_fd);
 
+/* Return whether the handshake of the current connection resumed a previous
+ * session. Returns WH_ERROR_NOTREADY if the handshake has not completed */
+int posixTransportTls_SessionReused(posixTransportTlsClientContext* context,
+                                    int*                            out_reused);
+
+/* Release the session held by an application session cache */
+int posixTransportTls_FreeSessionCache(posixTransportTlsSessionCache* cache);
+
 /** Server context and functions */
 
 typedef struct {
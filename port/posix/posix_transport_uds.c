@@ -0,0 +1,840 @@
+/*
+ * Copyright (C) 2024 wolfSSL Inc.
+ *
+ * This file is part of wolfHSM.
+ *
+ * wolfHSM is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * wolfHSM is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with wolfHSM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/*
+ * port/posix/posix_transport_uds.c
+ *
+ * Implementation of transport callbacks using Unix domain sockets, with bulk
+ * data in a memfd shared using SCM_RIGHTS
+ */
+
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+/* Required for memfd_create() and accept4() when building with strict
+ * standards flags */
+#define _GNU_SOURCE
+#endif
+
+#if defined(__linux__)
+
+#include <stddef.h>
+#include <string.h>
+#include <stdint.h>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/mman.h>   /* For memfd_create, mmap */
+#include <sys/stat.h>   /* For fstat */
+#include <unistd.h>     /* For ftruncate, close, unlink */
+#include <fcntl.h>
+#include <errno.h>
+#include <poll.h>
+
+#include "wolfhsm/wh_error.h"
+#include "wolfhsm/wh_comm.h"
+#include "port/posix/posix_transport_uds.h"
+
+/* Name of the client memfd, visible in /proc/<pid>/fd for debugging */
+#define PTU_MEMFD_NAME "wolfhsm-uds"
+
+/* Seals the server requires on a client memfd before mapping it.  Without
+ * them, the client could shrink the memfd and fault the server with SIGBUS */
+#define PTU_MEMFD_SEALS (F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL)
+
+
+/** Local declarations */
+
+/* Validate the config and set up the socket address */
+static int posixTransportUds_InitAddr(posixTransportUdsContext* c,
+        const posixTransportUdsConfig* cf);
+
+/* Create a non-blocking SOCK_SEQPACKET socket */
+static int posixTransportUds_Socket(void);
+
+/* Attempt to connect to the server */
+static int posixTransportUds_HandleConnect(posixTransportUdsContext* c);
+
+/* Close the connected socket and release the memfd area of the connection */
+static void posixTransportUds_CloseConnect(posixTransportUdsContext* c);
+
+/* Map the memfd received from a client as the bulk area of the connection */
+static int posixTransportUds_MapMemfd(posixTransportUdsContext* c, int fd);
+
+/* Block until fd is readable or timeout_us elapses. 0 waits indefinitely */
+static int posixTransportUds_PollIn(const int* fds, int count,
+        uint64_t timeout_us);
+
+
+/** Local implementations */
+static int posixTransportUds_InitAddr(posixTransportUdsContext* c,
+        const posixTransportUdsConfig* cf)
+{
+    size_t len = 0;
+
+    if (    (c == NULL) ||
+            (cf == NULL) ||
+            (cf->socket_path == NULL)) {
+        return WH_ERROR_BADARGS;
+    }
+
+    len = strlen(cf->socket_path);
+    if ((len == 0) || (len >= sizeof(c->addr.sun_path))) {
+        return WH_ERROR_BADARGS;
+    }
+
+    memset(c, 0, sizeof(*c));
+    c->addr.sun_family = AF_UNIX;
+    memcpy(c->addr.sun_path, cf->socket_path, len + 1);
+    return 0;
+}
+
+static int posixTransportUds_Socket(void)
+{
+    int fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return WH_ERROR_ABORTED;
+    }
+    if (fd <= 2) {
+        /* fd conflicts with stdin/stdout/stderr */
+        close(fd);
+        return WH_ERROR_ABORTED;
+    }
+    return fd;
+}
+
+static int posixTransportUds_HandleConnect(posixTransportUdsContext* c)
+{
+    int rc = 0;
+
+    if (c->connect_fd_p1 != 0) {
+        return WH_ERROR_OK;
+    }
+
+    rc = posixTransportUds_Socket();
+    if (rc < 0) {
+        return rc;
+    }
+    c->connect_fd_p1 = rc + 1;
+    c->memfd_sent = 0;
+
+    /* Connecting a Unix socket completes or fails immediately */
+    rc = connect(c->connect_fd_p1 - 1, (struct sockaddr*)&c->addr,
+            sizeof(c->addr));
+    if (rc == 0) {
+        return WH_ERROR_OK;
+    }
+
+    close(c->connect_fd_p1 - 1);
+    c->connect_fd_p1 = 0;
+    switch (errno) {
+    case ENOENT:
+    case ECONNREFUSED:
+        /* Server not listening yet. Rebuild socket on retry. */
+        return WH_ERROR_NOTFOUND;
+
+    case EAGAIN:
+    case EINTR:
+        /* Listen backlog is full. Retry. */
+        return WH_ERROR_NOTREADY;
+
+    default:
+        /* Some other error. Assume fatal. */
+        return WH_ERROR_ABORTED;
+    }
+}
+
+static void posixTransportUds_CloseConnect(posixTransportUdsContext* c)
+{
+    if (c->connect_fd_p1 != 0) {
+        close(c->connect_fd_p1 - 1);
+        c->connect_fd_p1 = 0;
+        if (c->connectcb != NULL) {
+            /* Report the disconnect so per-connection state is dropped. Both
+             * ends connect again internally, so the transport stays usable */
+            c->connectcb(c->connectcb_arg, WH_COMM_DISCONNECTED);
+            c->connectcb(c->connectcb_arg, WH_COMM_CONNECTED);
+        }
+    }
+    c->memfd_sent = 0;
+
+    /* The client keeps its area across reconnects.  The server mapping belongs
+     * to the connection. */
+    if ((c->listen_fd_p1 != 0) && (c->dma != NULL)) {
+        (void)munmap(c->dma, c->dma_size);
+        c->dma = NULL;
+        c->dma_size = 0;
+    }
+}
+
+static int posixTransportUds_MapMemfd(posixTransportUdsContext* c, int fd)
+{
+    struct stat st;
+    void* ptr = NULL;
+    int seals = 0;
+
+    if (c->dma != NULL) {
+        /* Only the first area of a connection is used */
+        return WH_ERROR_ABORTED;
+    }
+    seals = fcntl(fd, F_GET_SEALS);
+    if ((seals < 0) || ((seals & PTU_MEMFD_SEALS) != PTU_MEMFD_SEALS)) {
+        return WH_ERROR_ABORTED;
+    }
+    if ((fstat(fd, &st) != 0) || (st.st_size <= 0)) {
+        return WH_ERROR_ABORTED;
+    }
+    ptr = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED,
+            fd, 0);
+    if (ptr == MAP_FAILED) {
+        return WH_ERROR_ABORTED;
+    }
+    c->dma = (uint8_t*)ptr;
+    c->dma_size = (size_t)st.st_size;
+    return 0;
+}
+
+/* Wait until any of count fds, at most POSIX_TRANSPORT_UDS_WAIT_SET_MAX, is
+ * readable */
+static int posixTransportUds_PollIn(const int* fds, int count,
+        uint64_t timeout_us)
+{
+    int rc = 0;
+    struct pollfd pfd[POSIX_TRANSPORT_UDS_WAIT_SET_MAX];
+    int timeout_ms = -1;
+    int i;
+
+    if (timeout_us != 0) {
+        /* Round up so short timeouts still wait */
+        uint64_t ms = (timeout_us + 999) / 1000;
+        timeout_ms = (ms > 0x7FFFFFFF) ? 0x7FFFFFFF : (int)ms;
+    }
+
+    for (i = 0; i < count; i++) {
+        pfd[i].fd = fds[i];
+        pfd[i].events = POLLIN;
+        pfd[i].revents = 0;
+    }
+
+    rc = poll(pfd, (nfds_t)count, timeout_ms);
+    if (rc < 0) {
+        /* Treat signals as spurious wakeups */
+        return (errno == EINTR) ? WH_ERROR_OK : WH_ERROR_ABORTED;
+    }
+    if (rc == 0) {
+        return WH_ERROR_TIMEOUT;
+    }
+    return WH_ERROR_OK;
+}
+
+
+/** Common functions */
+int posixTransportUds_GetDma(posixTransportUdsContext* ctx, void** out_dma,
+        size_t* out_size)
+{
+    if (ctx == NULL) {
+        return WH_ERROR_BADARGS;
+    }
+    if (ctx->dma == NULL) {
+        return WH_ERROR_NOTREADY;
+    }
+    if (out_dma != NULL) {
+        *out_dma = ctx->dma;
+    }
+    if (out_size != NULL) {
+        *out_size = ctx->dma_size;
+    }
+    return 0;
+}
+
+int posixTransportUds_GetConnectFd(posixTransportUdsContext* ctx, int* out_fd)
+{
+    if (ctx == NULL) {
+        return WH_ERROR_BADARGS;
+    }
+    if (ctx->connect_fd_p1 == 0) {
+        return WH_ERROR_NOTREADY;
+    }
+    if (out_fd != NULL) {
+        *out_fd = ctx->connect_fd_p1 - 1;
+    }
+    return 0;
+}
+
+int posixTransportUds_GetServerWaitFd(posixTransportUdsContext* ctx,
+        int* out_fd)
+{
+    if (    (ctx == NULL) ||
+            (out_fd == NULL)) {
+        return WH_ERROR_BADARGS;
+    }
+    if (ctx->listen_fd_p1 == 0) {
+        return WH_ERROR_NOTREADY;
+    }
+
+    /* Wait for a request, or for a client if none is connected */
+    *out_fd = (ctx->connect_fd_p1 != 0) ? ctx->connect_fd_p1 - 1 :
+                                          ctx->listen_fd_p1 - 1;
+    return 0;
+}
+
+
+/** Client functions */
+int posixTransportUds_InitConnect(void* context, const void* config,
+        whCommSetConnectedCb connectcb, void* connectcb_arg)
+{
+    int rc = 0;
+    posixTransportUdsContext* c = context;
+    const posixTransportUdsConfig* cf = config;
+    void* ptr = NULL;
+
+    rc = posixTransportUds_InitAddr(c, cf);
+    if (rc != 0) {
+        return rc;
+    }
+
+    if (cf->dma_size != 0) {
+        /* Create the private bulk area shared with the server on connect */
+        rc = memfd_create(PTU_MEMFD_NAME, MFD_CLOEXEC | MFD_ALLOW_SEALING);
+        if (rc < 0) {
+            return WH_ERROR_ABORTED;
+        }
+        c->memfd_p1 = rc + 1;
+        if (    (ftruncate(c->memfd_p1 - 1, (off_t)cf->dma_size) != 0) ||
+                (fcntl(c->memfd_p1 - 1, F_ADD_SEALS, PTU_MEMFD_SEALS) != 0)) {
+            (void)posixTransportUds_CleanupConnect(c);
+            return WH_ERROR_ABORTED;
+        }
+        ptr = mmap(NULL, cf->dma_size, PROT_READ | PROT_WRITE, MAP_SHARED,
+                c->memfd_p1 - 1, 0);
+        if (ptr == MAP_FAILED) {
+            (void)posixTransportUds_CleanupConnect(c);
+            return WH_ERROR_ABORTED;
+        }
+        c->dma = (uint8_t*)ptr;
+        c->dma_size = cf->dma_size;
+    }
+
+    /* Start the connect process */
+    rc = posixTransportUds_HandleConnect(c);
+    if (    (rc == WH_ERROR_OK) ||
+            (rc == WH_ERROR_NOTFOUND) ||    /* Server not listening */
+            (rc == WH_ERROR_NOTREADY) ) {
+        c->connectcb = connectcb;
+        c->connectcb_arg = connectcb_arg;
+        if (c->connectcb != NULL) {
+            c->connectcb(connectcb_arg, WH_COMM_CONNECTED);
+        }
+        rc = WH_ERROR_OK;
+    }
+    else {
+        (void)posixTransportUds_CleanupConnect(c);
+    }
+    return rc;
+}
+
+int posixTransportUds_SendRequest(void* context, uint16_t size,
+        const void* data)
+{
+    int rc = 0;
+    posixTransportUdsContext* c = context;
+    struct iovec iov;
+    struct msghdr msg;
+    union {
+        struct cmsghdr align;
+        uint8_t buf[CMSG_SPACE(sizeof(int))];
+    } cmsg_buf;
+    struct cmsghdr* cmsg = NULL;
+    int memfd = 0;
+
+    if (    (c == NULL) ||
+            (size == 0) ||
+            (size > WH_COMM_MTU) ||
+            (data == NULL)) {
+        return WH_ERROR_BADARGS;
+    }
+
+    rc = posixTransportUds_HandleConnect(c);
+    if (rc != WH_ERROR_OK) {
+        return (rc == WH_ERROR_NOTFOUND) ? WH_ERROR_NOTREADY : rc;
+    }
+
+    memset(&msg, 0, sizeof(msg));
+    iov.iov_base = (void*)data;
+    iov.iov_len = size;
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+
+    if ((c->memfd_p1 != 0) && (c->memfd_sent == 0)) {
+        /* Pass the bulk area along with the first request */
+        memset(&cmsg_buf, 0, sizeof(cmsg_buf));
+        msg.msg_control = cmsg_buf.buf;
+        msg.msg_controllen = sizeof(cmsg_buf.buf);
+        cmsg = CMSG_FIRSTHDR(&msg);
+        cmsg->cmsg_level = SOL_SOCKET;
+        cmsg->cmsg_type = SCM_RIGHTS;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+        memfd = c->memfd_p1 - 1;
+        memcpy(CMSG_DATA(cmsg), &memfd, sizeof(memfd));
+    }
+
+    rc = sendmsg(c->connect_fd_p1 - 1, &msg, MSG_NOSIGNAL | MSG_DONTWAIT);
+    if (rc < 0) {
+        switch (errno) {
+        case EAGAIN:
+        case EINTR:
+            /* Socket buffer is full */
+            return WH_ERROR_NOTREADY;
+
+        default:
+            /* Server went away. Reconnect on the next request. */
+            posixTransportUds_CloseConnect(c);
+            return WH_ERROR_ABORTED;
+        }
+    }
+    if (msg.msg_control != NULL) {
+        c->memfd_sent = 1;
+    }
+    return 0;
+}
+
+int posixTransportUds_RecvResponse(void* context, uint16_t* out_size,
+        void* data)
+{
+    ssize_t rc = 0;
+    posixTransportUdsContext* c = context;
+    struct iovec iov;
+    struct msghdr msg;
+
+    if (    (c == NULL) ||
+            (data == NULL)) {
+        return WH_ERROR_BADARGS;
+    }
+    if (c->connect_fd_p1 == 0) {
+        return WH_ERROR_NOTREADY;
+    }
+
+    memset(&msg, 0, sizeof(msg));
+    iov.iov_base = data;
+    iov.iov_len = WH_COMM_MTU;
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+
+    rc = recvmsg(c->connect_fd_p1 - 1, &msg, MSG_DONTWAIT);
+    if (rc < 0) {
+        switch (errno) {
+        case EAGAIN:
+        case EINTR:
+            /* No response yet */
+            return WH_ERROR_NOTREADY;
+
+        default:
+            posixTransportUds_CloseConnect(c);
+            return WH_ERROR_ABORTED;
+        }
+    }
+    if ((rc == 0) || ((msg.msg_flags & MSG_TRUNC) != 0)) {
+        /* Server closed the connection or sent an oversized packet */
+        posixTransportUds_CloseConnect(c);
+        if (c->connectcb != NULL) {
+            c->connectcb(c->connectcb_arg, WH_COMM_DISCONNECTED);
+        }
+        return WH_ERROR_ABORTED;
+    }
+    if (out_size != NULL) {
+        *out_size = (uint16_t)rc;
+    }
+    return 0;
+}
+
+int posixTransportUds_ClientWait(void* context, uint64_t timeout_us)
+{
+    posixTransportUdsContext* c = context;
+    int fd = -1;
+
+    if (c == NULL) {
+        return WH_ERROR_BADARGS;
+    }
+    if (c->connect_fd_p1 == 0) {
+        /* Not connected until the first request is sent */
+        return WH_ERROR_OK;
+    }
+    fd = c->connect_fd_p1 - 1;
+    return posixTransportUds_PollIn(&fd, 1, timeout_us);
+}
+
+int posixTransportUds_CleanupConnect(void* context)
+{
+    posixTransportUdsContext* c = context;
+    if (c == NULL) {
+        return WH_ERROR_BADARGS;
+    }
+
+    /* Trigger disconnect */
+    if (c->connectcb != NULL) {
+        c->connectcb(c->connectcb_arg, WH_COMM_DISCONNECTED);
+        c->connectcb = NULL;
+    }
+
+    posixTransportUds_CloseConnect(c);
+    if (c->dma != NULL) {
+        (void)munmap(c->dma, c->dma_size);
+        c->dma = NULL;
+        c->dma_size = 0;
+    }
+    if (c->memfd_p1 != 0) {
+        close(c->memfd_p1 - 1);
+        c->memfd_p1 = 0;
+    }
+    return 0;
+}
+
+
+/** Server functions */
+int posixTransportUds_InitListen(void* context, const void* config,
+        whCommSetConnectedCb connectcb, void* connectcb_arg)
+{
+    int rc = 0;
+    posixTransportUdsContext* c = context;
+    const posixTransportUdsConfig* cf = config;
+
+    rc = posixTransportUds_InitAddr(c, cf);
+    if (rc != 0) {
+        return rc;
+    }
+
+    rc = posixTransportUds_Socket();
+    if (rc < 0) {
+        return rc;
+    }
+    c->listen_fd_p1 = rc + 1;
+
+    /* Remove a stale socket left by an earlier server */
+    (void)unlink(c->addr.sun_path);
+
+    rc = bind(c->listen_fd_p1 - 1, (struct sockaddr*)&c->addr,
+            sizeof(c->addr));
+    if (rc == 0) {
+        rc = listen(c->listen_fd_p1 - 1, 1);
+    }
+    if (rc != 0) {
+        close(c->listen_fd_p1 - 1);
+        c->listen_fd_p1 = 0;
+        return WH_ERROR_ABORTED;
+    }
+
+    c->connectcb = connectcb;
+    c->connectcb_arg = connectcb_arg;
+
+    /* Connecting is handled internally so we need server to call recv */
+    if (c->connectcb != NULL) {
+        c->connectcb(c->connectcb_arg, WH_COMM_CONNECTED);
+    }
+    return 0;
+}
+
+int posixTransportUds_RecvRequest(void* context, uint16_t* out_size,
+        void* data)
+{
+    ssize_t rc = 0;
+    posixTransportUdsContext* c = context;
+    struct iovec iov;
+    struct msghdr msg;
+    union {
+        struct cmsghdr align;
+        uint8_t buf[CMSG_SPACE(sizeof(int))];
+    } cmsg_buf;
+    struct cmsghdr* cmsg = NULL;
+    int memfd = -1;
+
+    if (    (c == NULL) ||
+            (c->listen_fd_p1 == 0) ||
+            (data == NULL)) {
+        return WH_ERROR_BADARGS;
+    }
+
+    if (c->connect_fd_p1 == 0) {
+        rc = accept4(c->listen_fd_p1 - 1, NULL, NULL,
+                SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (rc < 0) {
+            switch (errno) {
+            case EAGAIN:
+            case EINTR:
+            case ECONNABORTED:
+                /* No client yet */
+                return WH_ERROR_NOTREADY;
+
+            case EMFILE:
+            case ENFILE:
+            case ENOBUFS:
+            case ENOMEM:
+                /* Out of resources. Leave the client queued and retry */
+                return WH_ERROR_NOTREADY;
+
+            default:
+                /* Other error. Assume fatal. */
+                return WH_ERROR_ABORTED;
+            }
+        }
+        c->connect_fd_p1 = (int)rc + 1;
+    }
+
+    memset(&msg, 0, sizeof(msg));
+    memset(&cmsg_buf, 0, sizeof(cmsg_buf));
+    iov.iov_base = data;
+    iov.iov_len = WH_COMM_MTU;
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = cmsg_buf.buf;
+    msg.msg_controllen = sizeof(cmsg_buf.buf);
+
+    rc = recvmsg(c->connect_fd_p1 - 1, &msg, MSG_DONTWAIT | MSG_CMSG_CLOEXEC);
+    if (rc < 0) {
+        switch (errno) {
+        case EAGAIN:
+        case EINTR:
+            /* No request yet */
+            return WH_ERROR_NOTREADY;
+
+        default:
+            posixTransportUds_CloseConnect(c);
+            return WH_ERROR_NOTREADY;
+        }
+    }
+    if (rc == 0) {
+        /* Client disconnected. Wait for the next one. */
+        posixTransportUds_CloseConnect(c);
+        return WH_ERROR_NOTREADY;
+    }
+
+    /* Take ownership of any passed descriptor before checking the packet */
+    for (cmsg = CMSG_FIRSTHDR(&msg); cmsg != NULL;
+            cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+        if (    (cmsg->cmsg_level == SOL_SOCKET) &&
+                (cmsg->cmsg_type == SCM_RIGHTS) &&
+                (cmsg->cmsg_len == CMSG_LEN(sizeof(int)))) {
+            memcpy(&memfd, CMSG_DATA(cmsg), sizeof(memfd));
+        }
+    }
+    if (memfd >= 0) {
+        int ret = posixTransportUds_MapMemfd(c, memfd);
+        /* The mapping stays valid after the descriptor is closed */
+        close(memfd);
+        if (ret != 0) {
+            /* Bad area. Drop this client and wait for the next one. */
+            posixTransportUds_CloseConnect(c);
+            return WH_ERROR_NOTREADY;
+        }
+    }
+
+    if ((msg.msg_flags & (MSG_TRUNC | MSG_CTRUNC)) != 0) {
+        /* Oversized packet or unexpected descriptors. Drop the client. */
+        posixTransportUds_CloseConnect(c);
+        return WH_ERROR_NOTREADY;
+    }
+
+    if (out_size != NULL) {
+        *out_size = (uint16_t)rc;
+    }
+    return 0;
+}
+
+int posixTransportUds_SendResponse(void* context, uint16_t size,
+        const void* data)
+{
+    ssize_t rc = 0;
+    posixTransportUdsContext* c = context;
+
+    if (    (c == NULL) ||
+            (c->listen_fd_p1 == 0) ||
+            (size == 0) ||
+            (size > WH_COMM_MTU) ||
+            (data == NULL)) {
+        return WH_ERROR_BADARGS;
+    }
+    if (c->connect_fd_p1 == 0) {
+        /* Client went away.  Drop the response. */
+        return WH_ERROR_ABORTED;
+    }
+
+    rc = send(c->connect_fd_p1 - 1, data, size, MSG_NOSIGNAL | MSG_DONTWAIT);
+    if (rc < 0) {
+        switch (errno) {
+        case EAGAIN:
+        case EINTR:
+            /* Socket buffer is full */
+            return WH_ERROR_NOTREADY;
+
+        default:
+            posixTransportUds_CloseConnect(c);
+            return WH_ERROR_ABORTED;
+        }
+    }
+    return 0;
+}
+
+int posixTransportUds_CleanupListen(void* context)
+{
+    posixTransportUdsContext* c = context;
+    if (c == NULL) {
+        return WH_ERROR_BADARGS;
+    }
+
+    /* Trigger disconnect */
+    if (c->connectcb != NULL) {
+        c->connectcb(c->connectcb_arg, WH_COMM_DISCONNECTED);
+        c->connectcb = NULL;
+    }
+
+    posixTransportUds_CloseConnect(c);
+    if (c->listen_fd_p1 != 0) {
+        close(c->listen_fd_p1 - 1);
+        c->listen_fd_p1 = 0;
+        (void)unlink(c->addr.sun_path);
+    }
+    return 0;
+}
+
+int posixTransportUds_ServerWait(void* context, uint64_t timeout_us)
+{
+    int fd = -1;
+
+    if (posixTransportUds_GetServerWaitFd(context, &fd) != 0) {
+        return WH_ERROR_BADARGS;
+    }
+    return posixTransportUds_PollIn(&fd, 1, timeout_us);
+}
+
+int posixTransportUds_ServerPending(void* context)
+{
+    struct pollfd pfd;
+    int           rc;
+
+    if (posixTransportUds_GetServerWaitFd(context, &pfd.fd) != 0) {
+        return WH_ERROR_BADARGS;
+    }
+    pfd.events  = POLLIN;
+    pfd.revents = 0;
+
+    rc = poll(&pfd, 1, 0);
+    if (rc < 0) {
+        return (errno == EINTR) ? WH_ERROR_NOTREADY : WH_ERROR_ABORTED;
+    }
+    return (rc > 0) ? WH_ERROR_OK : WH_ERROR_NOTREADY;
+}
+
+int posixTransportUds_ServerWaitSet(void* context, uint64_t timeout_us)
+{
+    posixTransportUdsServerWaitSet* set = context;
+    int fds[POSIX_TRANSPORT_UDS_WAIT_SET_MAX];
+    int i;
+
+    if (    (set == NULL) ||
+            (set->contexts == NULL) ||
+            (set->count <= 0) ||
+            (set->count > POSIX_TRANSPORT_UDS_WAIT_SET_MAX)) {
+        return WH_ERROR_BADARGS;
+    }
+
+    for (i = 0; i < set->count; i++) {
+        if (posixTransportUds_GetServerWaitFd(set->contexts[i], &fds[i]) !=
+                0) {
+            return WH_ERROR_BADARGS;
+        }
+    }
+    return posixTransportUds_PollIn(fds, set->count, timeout_us);
+}
+
+
+#ifdef WOLFHSM_CFG_DMA
+int posixTransportUds_ServerDmaCallback(whServerContext* server,
+                                        uintptr_t clientAddr,
+                                        void** xformedCliAddr, size_t len,
+                                        whServerDmaOper  oper,
+                                        whServerDmaFlags flags)
+{
+    posixTransportUdsContext* ctx;
+    void*                     dma_ptr;
+    size_t                    dma_size;
+    int                       ret;
+
+    (void)oper;
+    (void)flags;
+
+    if (server == NULL || xformedCliAddr == NULL) {
+        return WH_ERROR_BADARGS;
+    }
+
+    ctx = (posixTransportUdsContext*)server->comm->transport_context;
+    ret = posixTransportUds_GetDma(ctx, &dma_ptr, &dma_size);
+    if (ret != WH_ERROR_OK) {
+        return ret;
+    }
+
+    /* The client sends offsets into its area */
+    if (len > dma_size || clientAddr > dma_size - len) {
+        return WH_ERROR_BADARGS;
+    }
+
+    *xformedCliAddr = (void*)((uintptr_t)dma_ptr + clientAddr);
+    return WH_ERROR_OK;
+}
+
+int posixTransportUds_ClientDmaCallback(whClientContext* client,
+                                        uintptr_t        clientAddr,
+                                        void** xformedCliAddr, size_t len,
+                                        whDmaOper oper, whDmaFlags flags)
+{
+    void*  dma_ptr;
+    size_t dma_size;
+    int    ret;
+
+    (void)flags;
+
+    if (client == NULL || xformedCliAddr == NULL) {
+        return WH_ERROR_BADARGS;
+    }
+
+    /* NULL pointer maps to NULL, short circuit here */
+    if (clientAddr == 0 || len == 0) {
+        *xformedCliAddr = NULL;
+        return WH_ERROR_OK;
+    }
+
+    /* Nothing to release after the operation */
+    if (    (oper != WH_DMA_OPER_CLIENT_READ_PRE) &&
+            (oper != WH_DMA_OPER_CLIENT_WRITE_PRE)) {
+        return WH_ERROR_OK;
+    }
+
+    ret = posixTransportUds_GetDma(client->comm->transport_context, &dma_ptr,
+                                   &dma_size);
+    if (ret != WH_ERROR_OK) {
+        return ret;
+    }
+
+    if (    (len > dma_size) ||
+            (clientAddr < (uintptr_t)dma_ptr) ||
+            (clientAddr - (uintptr_t)dma_ptr > dma_size - len)) {
+        return WH_ERROR_BADARGS;
+    }
+
+    *xformedCliAddr = (void*)(clientAddr - (uintptr_t)dma_ptr);
+    return WH_ERROR_OK;
+}
+#endif /* WOLFHSM_CFG_DMA */
+
+#endif /* __linux__ */
@@ -0,0 +1,209 @@
+/*
+ * Copyright (C) 2024 wolfSSL Inc.
+ *
+ * This file is part of wolfHSM.
+ *
+ * wolfHSM is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * wolfHSM is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with wolfHSM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/*
+ * port/posix/posix_transport_uds.h
+ *
+ * wolfHSM Transport binding using Unix domain sockets with a memfd bulk area
+ *
+ * For this implementation, packets are exchanged over an AF_UNIX SOCK_SEQPACKET
+ * socket bound to config->socket_path, so the kernel preserves packet
+ * boundaries and no framing is needed.  All function calls are non-blocking and
+ * return WH_ERROR_NOTREADY when the operation cannot complete yet.
+ *
+ * If config->dma_size is nonzero, the client creates an anonymous memfd of that
+ * size, maps it, and passes the descriptor to the server with SCM_RIGHTS along
+ * with its first request.  The server maps the same memory for the lifetime of
+ * the connection, so each client gets a private bulk area instead of one
+ * pre-sized global DMA area.  The client seals the memfd against resizing, and
+ * the server refuses an area without those seals, so a client cannot truncate
+ * the area under the server's mapping.  Bulk data placed in the area by the client is
+ * visible to the server without passing through the socket.  Using the
+ * optional DMA callbacks, client addresses within the area are sent to the
+ * server as offsets.
+ *
+ * The server accepts one client at a time.  When the client disconnects, the
+ * server unmaps its area and waits for the next client.  The server may block
+ * on the socket using posixTransportUds_ServerWait() (or
+ * wh_Server_WaitRequest()) instead of polling, and the client may block using
+ * posixTransportUds_ClientWait().
+ *
+ * Only available on Linux.
+ */
+
+#ifndef PORT_POSIX_POSIX_TRANSPORT_UDS_H_
+#define PORT_POSIX_POSIX_TRANSPORT_UDS_H_
+
+/* Example usage:
+ *
+ * posixTransportUdsConfig ptucfg[1] = {{
+ *      .socket_path = "/tmp/wolfhsm.sock",
+ *      .dma_size = 64 * 1024,
+ * }};
+ *
+ * whTransportClientCb ptuccb[1] = {POSIX_TRANSPORT_UDS_CLIENT_CB};
+ * posixTransportUdsClientContext ptucc[1] = {0};
+ * whCommClientConfig ccc[1] = {{
+ *      .transport_cb = ptuccb,
+ *      .transport_context = ptucc,
+ *      .transport_config = ptucfg,
+ *      .client_id = 0x1,
+ * }}
+ *
+ * whTransportServerCb ptuscb[1] = {POSIX_TRANSPORT_UDS_SERVER_CB};
+ * posixTransportUdsServerContext ptusc[1] = {0};
+ * whCommServerConfig csc[1] = {{
+ *      .transport_cb = ptuscb,
+ *      .transport_context = ptusc,
+ *      .transport_config = ptucfg,
+ *      .server_id = 0xF,
+ * }}
+ */
+
+#include <stdint.h>
+#include <stddef.h>  /* For size_t */
+#include <sys/un.h>  /* For struct sockaddr_un */
+
+#include "wolfhsm/wh_comm.h"
+
+/** Common configuration structure */
+typedef struct {
+    char*       socket_path;    /* Null terminated, shorter than sun_path */
+    size_t      dma_size;       /* Size of the client memfd area. 0 for none */
+} posixTransportUdsConfig;
+
+/** Common context structure */
+typedef struct {
+    whCommSetConnectedCb    connectcb;
+    void*                   connectcb_arg;
+    struct sockaddr_un      addr;
+    uint8_t*                dma;        /* Mapped memfd area, if any */
+    size_t                  dma_size;
+    int                     listen_fd_p1;   /* Server only. fd plus 1 */
+    int                     connect_fd_p1;  /* Connected socket. fd plus 1 */
+    int                     memfd_p1;       /* Client only. fd plus 1 */
+    int                     memfd_sent;     /* Client passed memfd to server */
+} posixTransportUdsContext;
+
+/* Naming conveniences. Reuses the same types. */
+typedef posixTransportUdsContext posixTransportUdsClientContext;
+typedef posixTransportUdsContext posixTransportUdsServerContext;
+
+/* Maximum number of contexts in a wait set */
+#ifndef POSIX_TRANSPORT_UDS_WAIT_SET_MAX
+#define POSIX_TRANSPORT_UDS_WAIT_SET_MAX 8
+#endif
+
+/** Server contexts waited on at once, such as the lanes of one server */
+typedef struct {
+    posixTransportUdsServerContext** contexts;
+    int                              count;  /* At most _WAIT_SET_MAX */
+} posixTransportUdsServerWaitSet;
+
+/** Custom functions */
+
+/* Get the bulk memfd area of the connection.  For the server, the area is only
+ * available once the first request of a client has been received.  Returns
+ * WH_ERROR_NOTREADY if there is no area. */
+int posixTransportUds_GetDma(posixTransportUdsContext* ctx, void** out_dma,
+        size_t* out_size);
+
+/* Return the file descriptor of the connected socket to support poll/select */
+int posixTransportUds_GetConnectFd(posixTransportUdsContext* ctx, int* out_fd);
+
+/* Return the file descriptor posixTransportUds_ServerWait() blocks on: the
+ * connected socket, or the listen socket while no client is connected.  It is
+ * readable when a request or a client is pending, so a server can be waited
+ * on within poll/select, such as by posixServerPool */
+int posixTransportUds_GetServerWaitFd(posixTransportUdsContext* ctx,
+        int* out_fd);
+
+/** Callback function declarations */
+int posixTransportUds_InitConnect(void* c, const void* cf,
+                                  whCommSetConnectedCb connectcb,
+                                  void*                connectcb_arg);
+int posixTransportUds_SendRequest(void* c, uint16_t len, const void* data);
+int posixTransportUds_RecvResponse(void* c, uint16_t* out_len, void* data);
+int posixTransportUds_CleanupConnect(void* c);
+
+/* Block until a response may be available or timeout_us elapses. A timeout_us
+ * of 0 waits indefinitely. */
+int posixTransportUds_ClientWait(void* c, uint64_t timeout_us);
+
+int posixTransportUds_InitListen(void* c, const void* cf,
+                                 whCommSetConnectedCb connectcb,
+                                 void*                connectcb_arg);
+int posixTransportUds_RecvRequest(void* c, uint16_t* out_len, void* data);
+int posixTransportUds_SendResponse(void* c, uint16_t len, const void* data);
+int posixTransportUds_CleanupListen(void* c);
+
+/* Block until the socket is readable or timeout_us elapses. A timeout_us of 0
+ * waits indefinitely. */
+int posixTransportUds_ServerWait(void* c, uint64_t timeout_us);
+
+/* Check without blocking whether the socket is readable. */
+int posixTransportUds_ServerPending(void* c);
+
+/* Block until any context of the posixTransportUdsServerWaitSet is readable or
+ * timeout_us elapses, with a single poll().  A timeout_us of 0 waits
+ * indefinitely.  Use as the lane_wait_cb of a server whose lanes all use this
+ * transport. */
+int posixTransportUds_ServerWaitSet(void* set, uint64_t timeout_us);
+
+#define POSIX_TRANSPORT_UDS_CLIENT_CB                   \
+    {                                                   \
+        .Init    = posixTransportUds_InitConnect,       \
+        .Send    = posixTransportUds_SendRequest,       \
+        .Recv    = posixTransportUds_RecvResponse,      \
+        .Cleanup = posixTransportUds_CleanupConnect,    \
+        .Wait    = posixTransportUds_ClientWait,        \
+    }
+
+#define POSIX_TRANSPORT_UDS_SERVER_CB                   \
+    {                                                   \
+        .Init    = posixTransportUds_InitListen,        \
+        .Recv    = posixTransportUds_RecvRequest,       \
+        .Send    = posixTransportUds_SendResponse,      \
+        .Cleanup = posixTransportUds_CleanupListen,     \
+        .Wait    = posixTransportUds_ServerWait,        \
+        .Pending = posixTransportUds_ServerPending,     \
+    }
+
+
+#ifdef WOLFHSM_CFG_DMA
+#include "wolfhsm/wh_dma.h"
+
+#include "wolfhsm/wh_server.h"
+/* Translate an offset sent by the client into the server mapping of the
+ * connection's memfd area */
+int posixTransportUds_ServerDmaCallback(whServerContext* server,
+                                        uintptr_t clientAddr,
+                                        void** xformedCliAddr, size_t len,
+                                        whServerDmaOper  oper,
+                                        whServerDmaFlags flags);
+
+#include "wolfhsm/wh_client.h"
+/* Translate a client address within the memfd area into an offset.  Client
+ * buffers must be placed within the area from posixTransportUds_GetDma() */
+int posixTransportUds_ClientDmaCallback(whClientContext* client,
+                                        uintptr_t        clientAddr,
+                                        void** xformedCliAddr, size_t len,
+                                        whDmaOper oper, whDmaFlags flags);
+#endif /* WOLFHSM_CFG_DMA */
+
+#endif /* !PORT_POSIX_POSIX_TRANSPORT_UDS_H_ */
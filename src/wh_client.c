@@ -68,6 +68,62 @@ const int WH_DEV_IDS_ARRAY[WH_NUM_DEVIDS] = {
 };
 #endif /* WOLFHSM_CFG_NO_CRYPTO */
 
+#ifdef WOLFHSM_CFG_CLIENT_WAIT
+/* Wait class of a request. Public key operations, including key generation,
+ * and certificate verification take milliseconds. Everything else is short */
+static uint8_t _wh_Client_WaitClass(uint16_t group, uint16_t action)
+{
+#ifndef WOLFHSM_CFG_NO_CRYPTO
+    if (((group == WH_MESSAGE_GROUP_CRYPTO) ||
+         (group == WH_MESSAGE_GROUP_CRYPTO_DMA)) &&
+        (action == WC_ALGO_TYPE_PK)) {
+        return WH_CLIENT_WAIT_CLASS_LONG;
+    }
+#else
+    (void)action;
+#endif /* !WOLFHSM_CFG_NO_CRYPTO */
+    if (group == WH_MESSAGE_GROUP_CERT) {
+        return WH_CLIENT_WAIT_CLASS_LONG;
+    }
+    return WH_CLIENT_WAIT_CLASS_SHORT;
+}
+#endif /* WOLFHSM_CFG_CLIENT_WAIT */
+
+int wh_Client_WaitStep(whClientContext* c)
+{
+#ifdef WOLFHSM_CFG_CLIENT_WAIT
+    const whClientWaitPolicy* policy = NULL;
+    uint32_t                  polls  = 0;
+#endif /* WOLFHSM_CFG_CLIENT_WAIT */
+
+    if (c == NULL) {
+        return WH_ERROR_BADARGS;
+    }
+
+#ifdef WOLFHSM_CFG_CLIENT_WAIT
+    policy = &c->wait.policy[c->wait.wait_class];
+    polls  = c->wait.polls;
+    if (polls != UINT32_MAX) {
+        c->wait.polls++;
+    }
+
+    if (polls < policy->spin_count) {
+        return WH_ERROR_OK;
+    }
+    if (((polls - policy->spin_count) >= policy->yield_count) &&
+        (policy->block_us != 0)) {
+        if (wh_CommClient_WaitResponse(c->comm, policy->block_us) !=
+            WH_ERROR_NOTIMPL) {
+            return WH_ERROR_OK;
+        }
+    }
+    if (c->wait.yield_cb != NULL) {
+        c->wait.yield_cb(c->wait.yield_arg);
+    }
+#endif /* WOLFHSM_CFG_CLIENT_WAIT */
+    return WH_ERROR_OK;
+}
+
 int wh_Client_Init(whClientContext* c, const whClientConfig* config)
 {
     int rc = 0;
@@ -77,6 +133,34 @@ int wh_Client_Init(whClientContext* c, const whClientConfig* config)
 
     memset(c, 0, sizeof(*c));
 
+#ifdef WOLFHSM_CFG_CLIENT_WAIT
+    if (config->waitConfig != NULL) {
+        memcpy(c->wait.policy, config->waitConfig->policy,
+               sizeof(c->wait.policy));
+        c->wait.yield_cb  = config->waitConfig->yield_cb;
+        c->wait.yield_arg = config->waitConfig->yield_arg;
+    }
+    else {
+        c->wait.policy[WH_CLIENT_WAIT_CLASS_SHORT].spin_count =
+            WOLFHSM_CFG_CLIENT_WAIT_SHORT_SPIN;
+        c->wait.policy[WH_CLIENT_WAIT_CLASS_SHORT].yield_count =
+            WOLFHSM_CFG_CLIENT_WAIT_SHORT_YIELD;
+        c->wait.policy[WH_CLIENT_WAIT_CLASS_SHORT].block_us =
+            WOLFHSM_CFG_CLIENT_WAIT_SHORT_BLOCK_US;
+        c->wait.policy[WH_CLIENT_WAIT_CLASS_LONG].spin_count =
+            WOLFHSM_CFG_CLIENT_WAIT_LONG_SPIN;
+        c->wait.policy[WH_CLIENT_WAIT_CLASS_LONG].yield_count =
+            WOLFHSM_CFG_CLIENT_WAIT_LONG_YIELD;
+        c->wait.policy[WH_CLIENT_WAIT_CLASS_LONG].block_us =
+            WOLFHSM_CFG_CLIENT_WAIT_LONG_BLOCK_US;
+    }
+#endif /* WOLFHSM_CFG_CLIENT_WAIT */
+
+#ifdef WOLFHSM_CFG_CANCEL_API
+    c->cancelCb  = config->cancelCb;
+    c->cancelArg = config->cancelArg;
+#endif /* WOLFHSM_CFG_CANCEL_API */
+
     rc = wh_CommClient_Init(c->comm, config->comm);
 
 #ifndef WOLFHSM_CFG_NO_CRYPTO
@@ -125,16 +209,31 @@ int wh_Client_Cleanup(whClientContext* c)
         return WH_ERROR_BADARGS;
     }
 
+    if (wh_CommClient_Cleanup(c->comm) == WH_ERROR_NOTREADY) {
+        /* A response must be received before the transport can be released */
+        return WH_ERROR_NOTREADY;
+    }
+
 #ifndef WOLFHSM_CFG_NO_CRYPTO
     (void)wolfCrypt_Cleanup();
 #endif  /* !WOLFHSM_CFG_NO_CRYPTO */
 
-    (void)wh_CommClient_Cleanup(c->comm);
-
     memset(c, 0, sizeof(*c));
     return 0;
 }
 
+/* Record a request that was sent so its response can be matched */
+static void _wh_Client_RequestSent(whClientContext* c, uint16_t group,
+                                   uint16_t action, uint16_t req_id)
+{
+    c->last_req_kind = WH_MESSAGE_KIND(group, action);
+    c->last_req_id = req_id;
+#ifdef WOLFHSM_CFG_CLIENT_WAIT
+    c->wait.polls      = 0;
+    c->wait.wait_class = _wh_Client_WaitClass(group, action);
+#endif /* WOLFHSM_CFG_CLIENT_WAIT */
+}
+
 int wh_Client_SendRequest(whClientContext* c,
         uint16_t group, uint16_t action,
         uint16_t data_size, const void* data)
@@ -146,11 +245,98 @@ int wh_Client_SendRequest(whClientContext* c,
     if (c == NULL) {
         return WH_ERROR_BADARGS;
     }
+#ifdef WOLFHSM_CFG_CLIENT_PIPELINE
+    /* Responses to a single outstanding request cannot be distinguished from
+     * pipelined responses */
+    if (c->pipeline.count != 0) {
+        return WH_ERROR_BADARGS;
+    }
+#endif /* WOLFHSM_CFG_CLIENT_PIPELINE */
     rc = wh_CommClient_SendRequest(c->comm, WH_COMM_MAGIC_NATIVE, kind, &req_id,
         data_size, data);
     if (rc == 0) {
-        c->last_req_kind = kind;
-        c->last_req_id = req_id;
+        _wh_Client_RequestSent(c, group, action, req_id);
+    }
+    return rc;
+}
+
+int wh_Client_SendRequestV(whClientContext* c, uint16_t group,
+                           uint16_t action, uint16_t iov_count,
+                           const whCommIoVec* iov)
+{
+    int rc = 0;
+    uint16_t req_id = 0;
+
+    if (c == NULL) {
+        return WH_ERROR_BADARGS;
+    }
+#ifdef WOLFHSM_CFG_CLIENT_PIPELINE
+    if (c->pipeline.count != 0) {
+        return WH_ERROR_BADARGS;
+    }
+#endif /* WOLFHSM_CFG_CLIENT_PIPELINE */
+    rc = wh_CommClient_SendRequestV(c->comm, WH_COMM_MAGIC_NATIVE,
+                                    WH_MESSAGE_KIND(group, action), &req_id,
+                                    iov_count, iov);
+    if (rc == 0) {
+        _wh_Client_RequestSent(c, group, action, req_id);
+    }
+    return rc;
+}
+
+int wh_Client_SendRequestNoResp(whClientContext* c, uint16_t group,
+                                uint16_t action, uint16_t data_size,
+                                const void* data)
+{
+    if (c == NULL) {
+        return WH_ERROR_BADARGS;
+    }
+#ifdef WOLFHSM_CFG_CLIENT_PIPELINE
+    /* The pipeline does not track the transport slot this request would
+     * hold, so it is only sent once the pipelined requests have completed */
+    if (c->pipeline.count != 0) {
+        return WH_ERROR_NOTREADY;
+    }
+#endif /* WOLFHSM_CFG_CLIENT_PIPELINE */
+    /* No response will arrive, so the last request id is left unchanged */
+    return wh_CommClient_SendRequestNoResp(c->comm, WH_COMM_MAGIC_NATIVE,
+                                           WH_MESSAGE_KIND(group, action),
+                                           NULL, data_size, data);
+}
+
+/* Check that a received response answers the last request and set outputs */
+static int _wh_Client_CheckResponse(whClientContext* c, uint16_t resp_magic,
+                                    uint16_t resp_kind, uint16_t resp_id,
+                                    uint16_t resp_size, uint16_t* out_group,
+                                    uint16_t* out_action, uint16_t* out_size)
+{
+    int rc = 0;
+
+    if (    (resp_magic != WH_COMM_MAGIC_NATIVE) ||
+            (resp_id != c->last_req_id) ){
+        /* Invalid or unexpected message */
+        rc = WH_ERROR_ABORTED;
+    }
+#ifdef WOLFHSM_CFG_CANCEL_API
+    else if (WH_MESSAGE_GROUP(resp_kind) == WH_MESSAGE_GROUP_CANCEL) {
+        /* Server stopped the request after a cancel */
+        rc = WH_ERROR_CANCEL;
+    }
+#endif /* WOLFHSM_CFG_CANCEL_API */
+    else if (resp_kind != c->last_req_kind) {
+        /* Response to a different request */
+        rc = WH_ERROR_ABORTED;
+    } else {
+        /* Valid and expected message. Set outputs */
+        if (out_group != NULL) {
+            *out_group = WH_MESSAGE_GROUP(resp_kind);
+        }
+        if (out_action != NULL) {
+            *out_action = WH_MESSAGE_ACTION(resp_kind);
+        }
+        if (out_size != NULL) {
+            *out_size = resp_size;
+        }
     }
     return rc;
 }
@@ -173,28 +359,451 @@ int wh_Client_RecvResponse(whClientContext *c,
                 &resp_magic, &resp_kind, &resp_id,
                 &resp_size, data);
     if (rc == 0) {
-        /* Validate response */
-        if (    (resp_magic != WH_COMM_MAGIC_NATIVE) ||
-                (resp_kind != c->last_req_kind) ||
-                (resp_id != c->last_req_id) ){
-            /* Invalid or unexpected message */
+        rc = _wh_Client_CheckResponse(c, resp_magic, resp_kind, resp_id,
+                                      resp_size, out_group, out_action,
+                                      out_size);
+    }
+    return rc;
+}
+
+int wh_Client_RecvResponseExt(whClientContext* c, uint16_t* out_group,
+                              uint16_t* out_action, uint16_t* out_size,
+                              uint16_t data_size, void* data,
+                              uint16_t ext_size, void* ext)
+{
+    int rc = 0;
+    uint16_t resp_magic = 0;
+    uint16_t resp_kind = 0;
+    uint16_t resp_id = 0;
+    uint16_t resp_size = 0;
+
+    if (c == NULL) {
+        return WH_ERROR_BADARGS;
+    }
+
+    rc = wh_CommClient_RecvResponseExt(c->comm, &resp_magic, &resp_kind,
+                                       &resp_id, &resp_size, data_size, data,
+                                       ext_size, ext);
+    if (rc == 0) {
+        rc = _wh_Client_CheckResponse(c, resp_magic, resp_kind, resp_id,
+                                      resp_size, out_group, out_action,
+                                      out_size);
+    }
+    return rc;
+}
+
+#ifdef WOLFHSM_CFG_CANCEL_API
+int wh_Client_CancelRequest(whClientContext* c)
+{
+    int rc = 0;
+
+    if (c == NULL) {
+        return WH_ERROR_BADARGS;
+    }
+#ifdef WOLFHSM_CFG_CLIENT_PIPELINE
+    if (c->pipeline.count != 0) {
+        return WH_ERROR_BADARGS;
+    }
+#endif /* WOLFHSM_CFG_CLIENT_PIPELINE */
+
+    if (c->cancelCb != NULL) {
+        rc = c->cancelCb(c->cancelArg, c->last_req_id);
+    }
+    else {
+        /* Use the out of band cancel of the transport */
+        rc = wh_CommClient_Cancel(c->comm);
+    }
+#ifdef WOLFHSM_CFG_ENABLE_TIMEOUT
+    if (rc == 0) {
+        /* Allow the server a full timeout to answer the cancel */
+        (void)wh_Timeout_Start(&c->comm->respTimeout);
+    }
+#endif /* WOLFHSM_CFG_ENABLE_TIMEOUT */
+    return rc;
+}
+
+int wh_Client_CancelResponse(whClientContext* c)
+{
+    int rc = 0;
+
+    if (c == NULL) {
+        return WH_ERROR_BADARGS;
+    }
+
+    /* Discard the payload of a response that arrives despite the cancel */
+    rc = wh_Client_RecvResponse(c, NULL, NULL, NULL, NULL);
+    if (rc == WH_ERROR_CANCEL) {
+        rc = WH_ERROR_OK;
+    }
+    else if (rc == WH_ERROR_OK) {
+        rc = WH_ERROR_CANCEL_LATE;
+    }
+    return rc;
+}
+
+int wh_Client_Cancel(whClientContext* c)
+{
+    int rc = wh_Client_CancelRequest(c);
+    if (rc == 0) {
+        do {
+            rc = wh_Client_CancelResponse(c);
+        } while ((rc == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(c) == 0));
+    }
+    return rc;
+}
+#endif /* WOLFHSM_CFG_CANCEL_API */
+
+#ifdef WOLFHSM_CFG_CLIENT_WAIT
+int wh_Client_SetWaitPolicy(whClientContext* c, whClientWaitClass wait_class,
+                            const whClientWaitPolicy* policy)
+{
+    if ((c == NULL) || (policy == NULL) ||
+        ((int)wait_class < 0) || (wait_class >= WH_CLIENT_WAIT_CLASS_COUNT)) {
+        return WH_ERROR_BADARGS;
+    }
+    c->wait.policy[wait_class] = *policy;
+    return WH_ERROR_OK;
+}
+#endif /* WOLFHSM_CFG_CLIENT_WAIT */
+
+#ifdef WOLFHSM_CFG_CLIENT_PIPELINE
+int wh_Client_PipelineSendRequest(whClientContext* c, uint16_t group,
+                                  uint16_t action, uint16_t data_size,
+                                  const void* data, whClientPipelineCb cb,
+                                  void* cb_arg, uint16_t* out_seq)
+{
+    int                    rc     = 0;
+    int                    i      = 0;
+    uint16_t               req_id = 0;
+    uint16_t               kind   = WH_MESSAGE_KIND(group, action);
+    whClientPipelineEntry* entry  = NULL;
+
+    if (c == NULL) {
+        return WH_ERROR_BADARGS;
+    }
+
+    if (c->pipeline.count >= WOLFHSM_CFG_CLIENT_PIPELINE_DEPTH) {
+        return WH_ERROR_NOTREADY;
+    }
+    if (c->pipeline.count != 0) {
+        /* A request that needs several fragments waits for an empty pipeline */
+        rc = wh_CommClient_CheckPipeline(c->comm, data_size);
+        if (rc != 0) {
+            return rc;
+        }
+    }
+
+    for (i = 0; i < WOLFHSM_CFG_CLIENT_PIPELINE_DEPTH; i++) {
+        if (c->pipeline.entry[i].in_use == 0) {
+            entry = &c->pipeline.entry[i];
+            break;
+        }
+    }
+    if (entry == NULL) {
+        /* Table is inconsistent with count */
+        return WH_ERROR_ABORTED;
+    }
+
+    rc = wh_CommClient_SendRequest(c->comm, WH_COMM_MAGIC_NATIVE, kind,
+                                   &req_id, data_size, data);
+    if (rc == 0) {
+        entry->cb     = cb;
+        entry->cb_arg = cb_arg;
+        entry->seq    = req_id;
+        entry->kind   = kind;
+        entry->in_use = 1;
+#ifdef WOLFHSM_CFG_CLIENT_WAIT
+        /* Restart the wait. Keep the longest class of the requests sent since
+         * the pipeline was last empty */
+        c->wait.polls = 0;
+        if ((c->pipeline.count == 0) ||
+            (_wh_Client_WaitClass(group, action) ==
+             WH_CLIENT_WAIT_CLASS_LONG)) {
+            c->wait.wait_class = _wh_Client_WaitClass(group, action);
+        }
+#endif /* WOLFHSM_CFG_CLIENT_WAIT */
+        c->pipeline.count++;
+        if (out_seq != NULL) {
+            *out_seq = req_id;
+        }
+    }
+    return rc;
+}
+
+int wh_Client_PipelinePoll(whClientContext* c)
+{
+    int                    rc         = 0;
+    int                    i          = 0;
+    uint16_t               resp_magic = 0;
+    uint16_t               resp_kind  = 0;
+    uint16_t               resp_id    = 0;
+    uint16_t               resp_size  = 0;
+    uint16_t               kind       = 0;
+    uint8_t*               resp_data  = NULL;
+    whClientPipelineEntry* entry      = NULL;
+    whClientPipelineCb     cb         = NULL;
+    void*                  cb_arg     = NULL;
+
+    if (c == NULL) {
+        return WH_ERROR_BADARGS;
+    }
+
+    if (c->pipeline.count == 0) {
+        /* Nothing outstanding */
+        return WH_ERROR_BADARGS;
+    }
+
+    /* Receive in place so the callback can read directly from the buffer */
+    resp_data = wh_CommClient_GetDataPtr(c->comm);
+    rc        = wh_CommClient_RecvResponse(c->comm, &resp_magic, &resp_kind,
+                                           &resp_id, &resp_size, resp_data);
+    if (rc != 0) {
+        return rc;
+    }
+#ifdef WOLFHSM_CFG_CLIENT_WAIT
+    /* A response arrived, so the wait for the next one starts over */
+    c->wait.polls = 0;
+#endif /* WOLFHSM_CFG_CLIENT_WAIT */
+
+    for (i = 0; i < WOLFHSM_CFG_CLIENT_PIPELINE_DEPTH; i++) {
+        if ((c->pipeline.entry[i].in_use != 0) &&
+            (c->pipeline.entry[i].seq == resp_id)) {
+            entry = &c->pipeline.entry[i];
+            break;
+        }
+    }
+    if (entry == NULL) {
+        /* Unexpected message */
+        return WH_ERROR_ABORTED;
+    }
+
+    /* Release the entry before the callback so it may issue a new request */
+    cb     = entry->cb;
+    cb_arg = entry->cb_arg;
+    kind   = entry->kind;
+    memset(entry, 0, sizeof(*entry));
+    c->pipeline.count--;
+
+    if (    (resp_magic != WH_COMM_MAGIC_NATIVE) ||
+            (resp_kind != kind)) {
+        /* Invalid response. The request is complete but failed */
+        rc        = WH_ERROR_ABORTED;
+        resp_size = 0;
+        resp_data = NULL;
+    }
+
+    if (cb != NULL) {
+        rc = cb(c, cb_arg, rc, resp_magic, WH_MESSAGE_GROUP(kind),
+                WH_MESSAGE_ACTION(kind), resp_id, resp_size, resp_data);
+    }
+    return rc;
+}
+
+int wh_Client_PipelineDrain(whClientContext* c)
+{
+    int rc = 0;
+
+    if (c == NULL) {
+        return WH_ERROR_BADARGS;
+    }
+
+    while ((rc == 0) && (c->pipeline.count != 0)) {
+        do {
+            rc = wh_Client_PipelinePoll(c);
+        } while ((rc == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(c) == 0));
+    }
+    return rc;
+}
+
+int wh_Client_PipelineGetOutstanding(whClientContext* c, uint16_t* out_count)
+{
+    if ((c == NULL) || (out_count == NULL)) {
+        return WH_ERROR_BADARGS;
+    }
+    *out_count = c->pipeline.count;
+    return 0;
+}
+#endif /* WOLFHSM_CFG_CLIENT_PIPELINE */
+
+#ifdef WOLFHSM_CFG_BATCH
+int wh_Client_BatchStart(whClientContext* c)
+{
+    if (c == NULL) {
+        return WH_ERROR_BADARGS;
+    }
+    memset(&c->batch, 0, sizeof(c->batch));
+    return wh_MessageBatch_LayoutInit(&c->batch.layout);
+}
+
+int wh_Client_BatchAdd(whClientContext* c, uint16_t group, uint16_t action,
+                       uint16_t data_size, const void* data,
+                       uint16_t resp_max)
+{
+    int                        rc     = 0;
+    uint8_t*                   buf    = NULL;
+    uint32_t                   offset = 0;
+    whMessageBatch_RequestItem item   = {0};
+
+    if ((c == NULL) || ((data == NULL) && (data_size != 0)) ||
+        (group == WH_MESSAGE_GROUP_BATCH)) {
+        return WH_ERROR_BADARGS;
+    }
+
+    buf = wh_CommClient_GetDataPtr(c->comm);
+    if (buf == NULL) {
+        return WH_ERROR_BADARGS;
+    }
+
+    offset = sizeof(whMessageBatch_Request) + c->batch.layout.req_total;
+    rc     = wh_MessageBatch_LayoutAdd(&c->batch.layout, data_size, resp_max);
+    if (rc != 0) {
+        return rc;
+    }
+
+    item.kind     = WH_MESSAGE_KIND(group, action);
+    item.size     = data_size;
+    item.resp_max = resp_max;
+    (void)wh_MessageBatch_TranslateRequestItem(
+        WH_COMM_MAGIC_NATIVE, &item,
+        (whMessageBatch_RequestItem*)(buf + offset));
+    offset += sizeof(item);
+    if (data_size != 0) {
+        memcpy(buf + offset, data, data_size);
+    }
+    /* Clear the padding so no stale buffer contents are sent */
+    memset(buf + offset + data_size, 0,
+           WH_MESSAGE_BATCH_ALIGN((uint32_t)data_size) - data_size);
+    return 0;
+}
+
+int wh_Client_BatchRequest(whClientContext* c)
+{
+    uint8_t*               buf = NULL;
+    whMessageBatch_Request req = {0};
+
+    if (c == NULL) {
+        return WH_ERROR_BADARGS;
+    }
+
+    buf = wh_CommClient_GetDataPtr(c->comm);
+    if (buf == NULL) {
+        return WH_ERROR_BADARGS;
+    }
+
+    req.count = c->batch.layout.count;
+    (void)wh_MessageBatch_TranslateRequest(WH_COMM_MAGIC_NATIVE, &req,
+                                           (whMessageBatch_Request*)buf);
+    /* Send in place from the comm buffer */
+    return wh_Client_SendRequest(
+        c, WH_MESSAGE_GROUP_BATCH, WH_MESSAGE_BATCH_ACTION_EXEC,
+        (uint16_t)(sizeof(req) + c->batch.layout.req_total), buf);
+}
+
+int wh_Client_BatchResponse(whClientContext* c, uint16_t* out_count)
+{
+    int                     rc        = 0;
+    uint8_t*                buf       = NULL;
+    uint16_t                resp_size = 0;
+    whMessageBatch_Response resp      = {0};
+
+    if (c == NULL) {
+        return WH_ERROR_BADARGS;
+    }
+
+    buf = wh_CommClient_GetDataPtr(c->comm);
+    if (buf == NULL) {
+        return WH_ERROR_BADARGS;
+    }
+
+    c->batch.resp_size  = 0;
+    c->batch.resp_count = 0;
+
+    rc = wh_Client_RecvResponse(c, NULL, NULL, &resp_size, buf);
+    if (rc == 0) {
+        if (resp_size < sizeof(resp)) {
             rc = WH_ERROR_ABORTED;
-        } else {
-            /* Valid and expected message. Set outputs */
-            if (out_group != NULL) {
-                *out_group = WH_MESSAGE_GROUP(resp_kind);
-            }
-            if (out_action != NULL) {
-                *out_action = WH_MESSAGE_ACTION(resp_kind);
-            }
-            if (out_size != NULL) {
-                *out_size = resp_size;
-            }
+        }
+        else {
+            (void)wh_MessageBatch_TranslateResponse(
+                WH_COMM_MAGIC_NATIVE, (whMessageBatch_Response*)buf, &resp);
+            rc = resp.rc;
+        }
+    }
+    if (rc == 0) {
+        c->batch.resp_size  = resp_size;
+        c->batch.resp_count = resp.count;
+        if (out_count != NULL) {
+            *out_count = resp.count;
         }
     }
     return rc;
 }
 
+int wh_Client_Batch(whClientContext* c, uint16_t* out_count)
+{
+    int rc = 0;
+
+    if (c == NULL) {
+        return WH_ERROR_BADARGS;
+    }
+
+    rc = wh_Client_BatchRequest(c);
+    if (rc == 0) {
+        do {
+            rc = wh_Client_BatchResponse(c, out_count);
+        } while ((rc == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(c) == 0));
+    }
+    return rc;
+}
+
+int wh_Client_BatchGetResult(whClientContext* c, uint16_t index,
+                             int32_t* out_rc, uint16_t* out_size,
+                             const void** out_data)
+{
+    uint8_t*                    buf    = NULL;
+    uint32_t                    offset = sizeof(whMessageBatch_Response);
+    uint16_t                    i      = 0;
+    whMessageBatch_ResponseItem item   = {0};
+
+    if ((c == NULL) || (index >= c->batch.resp_count)) {
+        return WH_ERROR_BADARGS;
+    }
+
+    buf = wh_CommClient_GetDataPtr(c->comm);
+    if (buf == NULL) {
+        return WH_ERROR_BADARGS;
+    }
+
+    /* Items are variable length, so walk to the requested index */
+    for (i = 0; i <= index; i++) {
+        if (offset + sizeof(item) > c->batch.resp_size) {
+            return WH_ERROR_ABORTED;
+        }
+        (void)wh_MessageBatch_TranslateResponseItem(
+            WH_COMM_MAGIC_NATIVE,
+            (const whMessageBatch_ResponseItem*)(buf + offset), &item);
+        offset += sizeof(item);
+        if (offset + item.size > c->batch.resp_size) {
+            return WH_ERROR_ABORTED;
+        }
+        if (i != index) {
+            offset += WH_MESSAGE_BATCH_ALIGN((uint32_t)item.size);
+        }
+    }
+
+    if (out_rc != NULL) {
+        *out_rc = item.rc;
+    }
+    if (out_size != NULL) {
+        *out_size = item.size;
+    }
+    if (out_data != NULL) {
+        *out_data = buf + offset;
+    }
+    return 0;
+}
+#endif /* WOLFHSM_CFG_BATCH */
+
 int wh_Client_CommInitRequest(whClientContext* c)
 {
     whMessageCommInitRequest msg = {0};
@@ -263,7 +872,7 @@ int wh_Client_CommInit(whClientContext* c,
     if (rc == 0) {
         do {
             rc = wh_Client_CommInitResponse(c, out_clientid, out_serverid);
-        } while (rc == WH_ERROR_NOTREADY);
+        } while ((rc == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(c) == 0));
     }
     return rc;
 }
@@ -405,7 +1014,7 @@ int wh_Client_CommInfo(whClientContext* c,
                     out_boot_state,
                     out_lifecycle_state,
                     out_nvm_state);
-        } while (rc == WH_ERROR_NOTREADY);
+        } while ((rc == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(c) == 0));
     }
     return rc;
 }
@@ -485,7 +1094,7 @@ int wh_Client_CommClose(whClientContext* c)
     if (rc == 0) {
         do {
             rc = wh_Client_CommCloseResponse(c);
-        } while (rc == WH_ERROR_NOTREADY);
+        } while ((rc == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(c) == 0));
     }
     return rc;
 }
@@ -563,7 +1172,7 @@ int wh_Client_Echo(whClientContext* c, uint16_t snd_len, const void* snd_data,
     if (rc == 0) {
         do {
             rc = wh_Client_EchoResponse(c, out_rcv_len, rcv_data);
-        } while (rc == WH_ERROR_NOTREADY);
+        } while ((rc == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(c) == 0));
     }
     return rc;
 }
@@ -669,7 +1278,7 @@ int wh_Client_CustomCbCheckRegistered(whClientContext* c, uint16_t id, int* resp
     if (rc == WH_ERROR_OK) {
         do {
             rc = wh_Client_CustomCbCheckRegisteredResponse(c, &id, responseError);
-        } while (rc == WH_ERROR_NOTREADY);
+        } while ((rc == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(c) == 0));
     }
 
     return rc;
@@ -681,11 +1290,11 @@ int wh_Client_KeyCacheRequest_ex(whClientContext* c, uint32_t flags,
                                  uint16_t inSz, uint16_t keyId)
 {
     whMessageKeystore_CacheRequest* req = NULL;
-    uint8_t*                        packIn;
+    whCommIoVec                     iov[2] = {{0}};
     uint16_t                        capSz;
 
     if (c == NULL || in == NULL || inSz == 0 ||
-        sizeof(*req) + inSz > WOLFHSM_CFG_COMM_DATA_LEN) {
+        sizeof(*req) + inSz > wh_CommClient_GetMaxDataLen(c->comm)) {
         return WH_ERROR_BADARGS;
     }
 
@@ -694,7 +1303,6 @@ int wh_Client_KeyCacheRequest_ex(whClientContext* c, uint32_t flags,
         return WH_ERROR_BADARGS;
     }
     memset(req, 0, sizeof(*req));
-    packIn = (uint8_t*)(req + 1);
     req->id    = keyId;
     req->flags = flags;
     req->sz    = inSz;
@@ -709,12 +1317,14 @@ int wh_Client_KeyCacheRequest_ex(whClientContext* c, uint32_t flags,
         memcpy(req->label, label, capSz);
     }
 
-    /* write in */
-    memcpy(packIn, in, inSz);
-
-    /* write request */
-    return wh_Client_SendRequest(c, WH_MESSAGE_GROUP_KEY, WH_KEY_CACHE,
-                                 sizeof(*req) + inSz, (uint8_t*)req);
+    /* write request, with in sent from the caller's buffer if it is larger
+     * than WOLFHSM_CFG_COMM_DATA_LEN allows on a fragmenting channel */
+    iov[0].data = req;
+    iov[0].size = sizeof(*req);
+    iov[1].data = in;
+    iov[1].size = inSz;
+    return wh_Client_SendRequestV(c, WH_MESSAGE_GROUP_KEY, WH_KEY_CACHE, 2,
+                                  iov);
 }
 
 int wh_Client_KeyCacheRequest(whClientContext* c, uint32_t flags,
@@ -767,7 +1377,7 @@ int wh_Client_KeyCache(whClientContext* c, uint32_t flags, uint8_t* label,
     if (ret == 0) {
         do {
             ret = wh_Client_KeyCacheResponse(c, keyId);
-        } while (ret == WH_ERROR_NOTREADY);
+        } while ((ret == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(c) == 0));
     }
 
     WH_DEBUG_CLIENT_VERBOSE("label:%.*s key_id:%x ret:%d \n", labelSz,
@@ -793,6 +1403,24 @@ int wh_Client_KeyEvictRequest(whClientContext* c, uint16_t keyId)
                                  sizeof(*req), (uint8_t*)req);
 }
 
+int wh_Client_KeyEvictNoResp(whClientContext* c, uint16_t keyId)
+{
+    whMessageKeystore_EvictRequest* req = NULL;
+
+    if (c == NULL || keyId == WH_KEYID_ERASED) {
+        return WH_ERROR_BADARGS;
+    }
+
+    req = (whMessageKeystore_EvictRequest*)wh_CommClient_GetDataPtr(c->comm);
+    if (req == NULL) {
+        return WH_ERROR_BADARGS;
+    }
+    req->id = keyId;
+
+    return wh_Client_SendRequestNoResp(c, WH_MESSAGE_GROUP_KEY, WH_KEY_EVICT,
+                                       sizeof(*req), (uint8_t*)req);
+}
+
 int wh_Client_KeyEvictResponse(whClientContext* c)
 {
     uint16_t                         group;
@@ -823,7 +1451,7 @@ int wh_Client_KeyEvict(whClientContext* c, uint16_t keyId)
     if (ret == 0) {
         do {
             ret = wh_Client_KeyEvictResponse(c);
-        } while (ret == WH_ERROR_NOTREADY);
+        } while ((ret == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(c) == 0));
     }
 
     WH_DEBUG_CLIENT_VERBOSE("key_id:%x ret:%d \n", keyId, ret);
@@ -856,19 +1484,28 @@ int wh_Client_KeyExportResponse(whClientContext* c, uint8_t* label,
     uint16_t                          size;
     int                               ret;
     whMessageKeystore_ExportResponse *resp = NULL;
-    uint8_t*                          packOut;
+    whMessageKeystore_ExportResponse  hdr;
 
     if (c == NULL || outSz == NULL) {
         return WH_ERROR_BADARGS;
     }
 
-    resp = (whMessageKeystore_ExportResponse*)wh_CommClient_GetDataPtr(c->comm);
-    if (resp == NULL) {
-        return WH_ERROR_BADARGS;
+    if (out != NULL) {
+        /* Receive the key straight into out, since it may be larger than
+         * WOLFHSM_CFG_COMM_DATA_LEN when fragmenting */
+        resp = &hdr;
+        ret  = wh_Client_RecvResponseExt(c, &group, &action, &size,
+                                         sizeof(hdr), &hdr, *outSz, out);
+    }
+    else {
+        resp = (whMessageKeystore_ExportResponse*)wh_CommClient_GetDataPtr(
+            c->comm);
+        if (resp == NULL) {
+            return WH_ERROR_BADARGS;
+        }
+        ret = wh_Client_RecvResponse(c, &group, &action, &size,
+                                     (uint8_t*)resp);
     }
-    packOut = (uint8_t*)(resp + 1);
-
-    ret = wh_Client_RecvResponse(c, &group, &action, &size, (uint8_t*)resp);
     if (ret == WH_ERROR_OK) {
         if (resp->rc != 0) {
             ret = resp->rc;
@@ -877,11 +1514,12 @@ int wh_Client_KeyExportResponse(whClientContext* c, uint8_t* label,
             if (out == NULL) {
                 *outSz = resp->len;
             }
-            else if (*outSz < resp->len) {
+            else if ((*outSz < resp->len) ||
+                     (size < sizeof(*resp) + resp->len)) {
                 ret = WH_ERROR_ABORTED;
             }
             else {
-                memcpy(out, packOut, resp->len);
+                /* Key is already in out */
                 *outSz = resp->len;
             }
             if (label != NULL) {
@@ -904,7 +1542,7 @@ int wh_Client_KeyExport(whClientContext* c, whKeyId keyId, uint8_t* label,
     if (ret == 0) {
         do {
             ret = wh_Client_KeyExportResponse(c, label, labelSz, out, outSz);
-        } while (ret == WH_ERROR_NOTREADY);
+        } while ((ret == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(c) == 0));
     }
     return ret;
 }
@@ -960,7 +1598,7 @@ int wh_Client_KeyCommit(whClientContext* c, whNvmId keyId)
     if (ret == 0) {
         do {
             ret = wh_Client_KeyCommitResponse(c);
-        } while (ret == WH_ERROR_NOTREADY);
+        } while ((ret == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(c) == 0));
     }
     return ret;
 }
@@ -1016,7 +1654,7 @@ int wh_Client_KeyErase(whClientContext* c, whNvmId keyId)
     if (ret == 0) {
         do {
             ret = wh_Client_KeyEraseResponse(c);
-        } while (ret == WH_ERROR_NOTREADY);
+        } while ((ret == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(c) == 0));
     }
     return ret;
 }
@@ -1072,11 +1710,78 @@ int wh_Client_KeyRevoke(whClientContext* c, whKeyId keyId)
     if (ret == 0) {
         do {
             ret = wh_Client_KeyRevokeResponse(c);
-        } while (ret == WH_ERROR_NOTREADY);
+        } while ((ret == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(c) == 0));
+    }
+    return ret;
+}
+
+int wh_Client_KeyPinRequest(whClientContext* c, whKeyId keyId, int pin)
+{
+    whMessageKeystore_PinRequest* req = NULL;
+
+    if (c == NULL || keyId == WH_KEYID_ERASED) {
+        return WH_ERROR_BADARGS;
+    }
+
+    req = (whMessageKeystore_PinRequest*)wh_CommClient_GetDataPtr(c->comm);
+    if (req == NULL) {
+        return WH_ERROR_BADARGS;
+    }
+    req->id  = keyId;
+    req->pin = (pin != 0) ? 1 : 0;
+
+    return wh_Client_SendRequest(c, WH_MESSAGE_GROUP_KEY, WH_KEY_PIN,
+                                 sizeof(*req), (uint8_t*)req);
+}
+
+int wh_Client_KeyPinResponse(whClientContext* c)
+{
+    uint16_t                       group;
+    uint16_t                       action;
+    uint16_t                       size;
+    int                            ret;
+    whMessageKeystore_PinResponse* resp = NULL;
+
+    if (c == NULL) {
+        return WH_ERROR_BADARGS;
+    }
+
+    resp = (whMessageKeystore_PinResponse*)wh_CommClient_GetDataPtr(c->comm);
+    if (resp == NULL) {
+        return WH_ERROR_BADARGS;
+    }
+
+    ret = wh_Client_RecvResponse(c, &group, &action, &size, (uint8_t*)resp);
+    if (ret == 0) {
+        if (resp->rc != 0) {
+            ret = resp->rc;
+        }
     }
     return ret;
 }
 
+static int _wh_Client_KeyPin(whClientContext* c, whKeyId keyId, int pin)
+{
+    int ret;
+    ret = wh_Client_KeyPinRequest(c, keyId, pin);
+    if (ret == 0) {
+        do {
+            ret = wh_Client_KeyPinResponse(c);
+        } while ((ret == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(c) == 0));
+    }
+    return ret;
+}
+
+int wh_Client_KeyPin(whClientContext* c, whKeyId keyId)
+{
+    return _wh_Client_KeyPin(c, keyId, 1);
+}
+
+int wh_Client_KeyUnpin(whClientContext* c, whKeyId keyId)
+{
+    return _wh_Client_KeyPin(c, keyId, 0);
+}
+
 int wh_Client_CounterInitRequest(whClientContext* c, whNvmId counterId,
     uint32_t counter)
 {
@@ -1134,7 +1839,7 @@ int wh_Client_CounterInit(whClientContext* c, whNvmId counterId,
     if (ret == 0) {
         do {
             ret = wh_Client_CounterInitResponse(c, counter);
-        } while (ret == WH_ERROR_NOTREADY);
+        } while ((ret == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(c) == 0));
     }
     return ret;
 }
@@ -1175,6 +1880,25 @@ int wh_Client_CounterIncrementRequest(whClientContext* c, whNvmId counterId)
                                  (uint8_t*)req);
 }
 
+int wh_Client_CounterIncrementNoResp(whClientContext* c, whNvmId counterId)
+{
+    whMessageCounter_IncrementRequest* req = NULL;
+
+    if (c == NULL || counterId == WH_KEYID_ERASED) {
+        return WH_ERROR_BADARGS;
+    }
+
+    req = (whMessageCounter_IncrementRequest*)wh_CommClient_GetDataPtr(c->comm);
+    if (req == NULL) {
+        return WH_ERROR_BADARGS;
+    }
+    req->counterId = counterId;
+
+    return wh_Client_SendRequestNoResp(c, WH_MESSAGE_GROUP_COUNTER,
+                                       WH_COUNTER_INCREMENT, sizeof(*req),
+                                       (uint8_t*)req);
+}
+
 int wh_Client_CounterIncrementResponse(whClientContext* c, uint32_t* counter)
 {
     uint16_t group;
@@ -1212,7 +1936,7 @@ int wh_Client_CounterIncrement(whClientContext* c, whNvmId counterId,
     if (ret == 0) {
         do {
             ret = wh_Client_CounterIncrementResponse(c, counter);
-        } while (ret == WH_ERROR_NOTREADY);
+        } while ((ret == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(c) == 0));
     }
     return ret;
 }
@@ -1272,7 +1996,7 @@ int wh_Client_CounterRead(whClientContext* c, whNvmId counterId,
     if (ret == 0) {
         do {
             ret = wh_Client_CounterReadResponse(c, counter);
-        } while (ret == WH_ERROR_NOTREADY);
+        } while ((ret == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(c) == 0));
     }
     return ret;
 }
@@ -1328,7 +2052,7 @@ int wh_Client_CounterDestroy(whClientContext* c, whNvmId counterId)
     if (ret == 0) {
         do {
             ret = wh_Client_CounterDestroyResponse(c);
-        } while (ret == WH_ERROR_NOTREADY);
+        } while ((ret == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(c) == 0));
     }
     return ret;
 }
@@ -1433,7 +2157,7 @@ int wh_Client_KeyCacheDma(whClientContext* c, uint32_t flags, uint8_t* label,
     if (ret == 0) {
         do {
             ret = wh_Client_KeyCacheDmaResponse(c, keyId);
-        } while (ret == WH_ERROR_NOTREADY);
+        } while ((ret == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(c) == 0));
     }
     return ret;
 }
@@ -1517,7 +2241,7 @@ int wh_Client_KeyExportDma(whClientContext* c, uint16_t keyId,
     if (ret == 0) {
         do {
             ret = wh_Client_KeyExportDmaResponse(c, label, labelSz, outSz);
-        } while (ret == WH_ERROR_NOTREADY);
+        } while ((ret == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(c) == 0));
     }
     return ret;
 }
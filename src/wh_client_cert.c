@@ -109,7 +109,7 @@ int wh_Client_CertInit(whClientContext* c, int32_t* out_rc)
     if (rc == 0) {
         do {
             rc = wh_Client_CertInitResponse(c, out_rc);
-        } while (rc == WH_ERROR_NOTREADY);
+        } while ((rc == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(c) == 0));
     }
 
     return rc;
@@ -121,13 +121,13 @@ int wh_Client_CertAddTrustedRequest(whClientContext* c, whNvmId id,
                                     uint8_t* label, whNvmSize label_len,
                                     const uint8_t* cert, uint32_t cert_len)
 {
-    whMessageCert_AddTrustedRequest req                               = {0};
-    uint8_t                         buffer[WOLFHSM_CFG_COMM_DATA_LEN] = {0};
+    whMessageCert_AddTrustedRequest req     = {0};
     uint16_t                        hdr_len = sizeof(req);
-    uint8_t*                        payload = buffer + hdr_len;
+    whCommIoVec                     iov[2]  = {{0}};
 
     if ((c == NULL) || (cert == NULL) || (cert_len == 0) ||
-        (cert_len > (sizeof(buffer) - hdr_len))) {
+        (cert_len > (uint32_t)(wh_CommClient_GetMaxDataLen(c->comm) -
+                               hdr_len))) {
         return WH_ERROR_BADARGS;
     }
 
@@ -143,14 +143,14 @@ int wh_Client_CertAddTrustedRequest(whClientContext* c, whNvmId id,
         memcpy(req.label, label, copy_len);
     }
 
-    /* Copy request struct and certificate data */
-    memcpy(buffer, &req, hdr_len);
-    memcpy(payload, cert, cert_len);
-
-    /* Send request */
-    return wh_Client_SendRequest(c, WH_MESSAGE_GROUP_CERT,
-                                 WH_MESSAGE_CERT_ACTION_ADDTRUSTED,
-                                 hdr_len + cert_len, buffer);
+    /* Send the request struct followed by the certificate data, which may be
+     * larger than WOLFHSM_CFG_COMM_DATA_LEN when fragmenting */
+    iov[0].data = &req;
+    iov[0].size = hdr_len;
+    iov[1].data = cert;
+    iov[1].size = (uint16_t)cert_len;
+    return wh_Client_SendRequestV(c, WH_MESSAGE_GROUP_CERT,
+                                  WH_MESSAGE_CERT_ACTION_ADDTRUSTED, 2, iov);
 }
 
 int wh_Client_CertAddTrustedResponse(whClientContext* c, int32_t* out_rc)
@@ -202,7 +202,7 @@ int wh_Client_CertAddTrusted(whClientContext* c, whNvmId id, whNvmAccess access,
     if (rc == 0) {
         do {
             rc = wh_Client_CertAddTrustedResponse(c, out_rc);
-        } while (rc == WH_ERROR_NOTREADY);
+        } while ((rc == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(c) == 0));
     }
 
     return rc;
@@ -269,7 +269,7 @@ int wh_Client_CertEraseTrusted(whClientContext* c, whNvmId id, int32_t* out_rc)
     if (rc == 0) {
         do {
             rc = wh_Client_CertEraseTrustedResponse(c, out_rc);
-        } while (rc == WH_ERROR_NOTREADY);
+        } while ((rc == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(c) == 0));
     }
 
     return rc;
@@ -300,38 +300,40 @@ int wh_Client_CertReadTrustedResponse(whClientContext* c, uint8_t* cert,
     uint16_t                           group;
     uint16_t                           action;
     uint16_t                           size;
-    uint8_t                            buffer[WOLFHSM_CFG_COMM_DATA_LEN] = {0};
-    whMessageCert_ReadTrustedResponse* resp =
-        (whMessageCert_ReadTrustedResponse*)buffer;
-    uint8_t* payload = buffer + sizeof(*resp);
+    whMessageCert_ReadTrustedResponse  resp     = {0};
+    uint16_t                           cert_max = 0;
 
     if ((c == NULL) || (cert == NULL) || (cert_len == NULL)) {
         return WH_ERROR_BADARGS;
     }
 
+    /* Receive the certificate straight into the caller's buffer, since it may
+     * be larger than WOLFHSM_CFG_COMM_DATA_LEN when fragmenting */
+    cert_max = (*cert_len > 0xFFFF) ? 0xFFFF : (uint16_t)*cert_len;
+
     /* Receive and validate response */
-    rc = wh_Client_RecvResponse(c, &group, &action, &size, buffer);
+    rc = wh_Client_RecvResponseExt(c, &group, &action, &size, sizeof(resp),
+                                   &resp, cert_max, cert);
     if (rc == 0) {
         if ((group != WH_MESSAGE_GROUP_CERT) ||
             (action != WH_MESSAGE_CERT_ACTION_READTRUSTED) ||
-            (size < sizeof(*resp))) {
+            (size < sizeof(resp)) ||
+            ((resp.rc == WH_ERROR_OK) &&
+             (resp.cert_len > size - sizeof(resp)))) {
             rc = WH_ERROR_ABORTED;
         }
         else {
             if (out_rc != NULL) {
-                *out_rc = resp->rc;
+                *out_rc = resp.rc;
                 /* Ensure we return the actual certificate length */
-                if (resp->rc == WH_ERROR_BUFFER_SIZE) {
-                    *cert_len = resp->cert_len;
+                if (resp.rc == WH_ERROR_BUFFER_SIZE) {
+                    *cert_len = resp.cert_len;
                 }
             }
 
-            if (resp->rc == WH_ERROR_OK) {
-                /* Copy certificate data if buffer is large enough */
-                if (*cert_len >= resp->cert_len) {
-                    memcpy(cert, payload, resp->cert_len);
-                    *cert_len = resp->cert_len;
-                }
+            if (resp.rc == WH_ERROR_OK) {
+                /* Certificate data is already in the caller's buffer */
+                *cert_len = resp.cert_len;
             }
         }
     }
@@ -355,7 +357,7 @@ int wh_Client_CertReadTrusted(whClientContext* c, whNvmId id, uint8_t* cert,
     if (rc == 0) {
         do {
             rc = wh_Client_CertReadTrustedResponse(c, cert, cert_len, out_rc);
-        } while (rc == WH_ERROR_NOTREADY);
+        } while ((rc == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(c) == 0));
     }
 
     return rc;
@@ -367,13 +369,13 @@ static int _certVerifyRequest(whClientContext* c, const uint8_t* cert,
                               uint16_t verifyFlags, whNvmFlags cachedKeyFlags,
                               whKeyId keyId)
 {
-    whMessageCert_VerifyRequest req                               = {0};
-    uint8_t                     buffer[WOLFHSM_CFG_COMM_DATA_LEN] = {0};
-    uint16_t                    hdr_len                           = sizeof(req);
-    uint8_t*                    payload = buffer + hdr_len;
+    whMessageCert_VerifyRequest req     = {0};
+    uint16_t                    hdr_len = sizeof(req);
+    whCommIoVec                 iov[2]  = {{0}};
 
     if ((c == NULL) || (cert == NULL) || (cert_len == 0) ||
-        (cert_len > (sizeof(buffer) - hdr_len))) {
+        (cert_len > (uint32_t)(wh_CommClient_GetMaxDataLen(c->comm) -
+                               hdr_len))) {
         return WH_ERROR_BADARGS;
     }
 
@@ -384,14 +386,14 @@ static int _certVerifyRequest(whClientContext* c, const uint8_t* cert,
     req.cachedKeyFlags   = cachedKeyFlags;
     req.keyId            = keyId;
 
-    /* Copy request struct and certificate data */
-    memcpy(buffer, &req, hdr_len);
-    memcpy(payload, cert, cert_len);
-
-    /* Send request */
-    return wh_Client_SendRequest(c, WH_MESSAGE_GROUP_CERT,
-                                 WH_MESSAGE_CERT_ACTION_VERIFY,
-                                 hdr_len + cert_len, buffer);
+    /* Send the request struct followed by the chain, which may be larger
+     * than WOLFHSM_CFG_COMM_DATA_LEN when fragmenting */
+    iov[0].data = &req;
+    iov[0].size = hdr_len;
+    iov[1].data = cert;
+    iov[1].size = (uint16_t)cert_len;
+    return wh_Client_SendRequestV(c, WH_MESSAGE_GROUP_CERT,
+                                  WH_MESSAGE_CERT_ACTION_VERIFY, 2, iov);
 }
 
 /* Helper function to receive a verify response */
@@ -453,7 +455,7 @@ static int _certVerify(whClientContext* c, const uint8_t* cert,
     if (rc == 0) {
         do {
             rc = _certVerifyResponse(c, inout_keyId, out_rc);
-        } while (rc == WH_ERROR_NOTREADY);
+        } while ((rc == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(c) == 0));
     }
 
     return rc;
@@ -587,7 +589,7 @@ int wh_Client_CertAddTrustedDma(whClientContext* c, whNvmId id,
     if (rc == 0) {
         do {
             rc = wh_Client_CertAddTrustedDmaResponse(c, out_rc);
-        } while (rc == WH_ERROR_NOTREADY);
+        } while ((rc == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(c) == 0));
     }
 
     return rc;
@@ -657,7 +659,7 @@ int wh_Client_CertReadTrustedDma(whClientContext* c, whNvmId id, void* cert,
     if (rc == 0) {
         do {
             rc = wh_Client_CertReadTrustedDmaResponse(c, out_rc);
-        } while (rc == WH_ERROR_NOTREADY);
+        } while ((rc == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(c) == 0));
     }
 
     return rc;
@@ -747,7 +749,7 @@ static int _certVerifyDma(whClientContext* c, const void* cert,
     if (rc == 0) {
         do {
             rc = _certVerifyDmaResponse(c, inout_keyId, out_rc);
-        } while (rc == WH_ERROR_NOTREADY);
+        } while ((rc == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(c) == 0));
     }
 
     return rc;
@@ -810,27 +812,29 @@ int wh_Client_CertVerifyAcertRequest(whClientContext* c, const void* cert,
                                      uint32_t cert_len,
                                      whNvmId  trustedRootNvmId)
 {
-    whMessageCert_VerifyAcertRequest req = {0};
-    uint8_t                          buffer[WOLFHSM_CFG_COMM_DATA_LEN];
-    size_t                           hdr_len = sizeof(req);
-    uint8_t*                         payload = buffer + hdr_len;
+    whMessageCert_VerifyAcertRequest req     = {0};
+    uint16_t                         hdr_len = sizeof(req);
+    whCommIoVec                      iov[2]  = {{0}};
 
 
     if ((c == NULL) || (trustedRootNvmId == WH_NVM_ID_INVALID) ||
         (cert == NULL) || (cert_len == 0) ||
-        (cert_len > (sizeof(buffer) - hdr_len))) {
+        (cert_len > (uint32_t)(wh_CommClient_GetMaxDataLen(c->comm) -
+                               hdr_len))) {
         return WH_ERROR_BADARGS;
     }
 
     req.cert_len         = cert_len;
     req.trustedRootNvmId = trustedRootNvmId;
 
-    memcpy(buffer, &req, sizeof(req));
-    memcpy(payload, cert, cert_len);
-
-    return wh_Client_SendRequest(c, WH_MESSAGE_GROUP_CERT,
-                                 WH_MESSAGE_CERT_ACTION_VERIFY_ACERT,
-                                 hdr_len + cert_len, buffer);
+    /* The certificate may be larger than WOLFHSM_CFG_COMM_DATA_LEN when
+     * fragmenting */
+    iov[0].data = &req;
+    iov[0].size = hdr_len;
+    iov[1].data = cert;
+    iov[1].size = (uint16_t)cert_len;
+    return wh_Client_SendRequestV(c, WH_MESSAGE_GROUP_CERT,
+                                  WH_MESSAGE_CERT_ACTION_VERIFY_ACERT, 2, iov);
 }
 
 int wh_Client_CertVerifyAcertResponse(whClientContext* c, int32_t* out_rc)
@@ -876,7 +880,7 @@ int wh_Client_CertVerifyAcert(whClientContext* c, const void* cert,
     if (rc == 0) {
         do {
             rc = wh_Client_CertVerifyAcertResponse(c, out_rc);
-        } while (rc == WH_ERROR_NOTREADY);
+        } while ((rc == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(c) == 0));
     }
 
     return rc;
@@ -949,7 +953,7 @@ int wh_Client_CertVerifyAcertDma(whClientContext* c, const void* cert,
     if (rc == 0) {
         do {
             rc = wh_Client_CertVerifyAcertDmaResponse(c, out_rc);
-        } while (rc == WH_ERROR_NOTREADY);
+        } while ((rc == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(c) == 0));
     }
 
     return rc;
@@ -243,7 +243,8 @@ int wh_Client_RngGenerate(whClientContext* ctx, uint8_t* out, uint32_t size)
             do {
                 ret = wh_Client_RecvResponse(ctx, &group, &action, &res_len,
                                              dataPtr);
-            } while (ret == WH_ERROR_NOTREADY);
+            } while ((ret == WH_ERROR_NOTREADY) &&
+                     (wh_Client_WaitStep(ctx) == 0));
         }
         if (ret == WH_ERROR_OK) {
             /* Get response */
@@ -321,7 +322,7 @@ int wh_Client_RngGenerateDma(whClientContext* ctx, uint8_t* out, uint32_t size)
         do {
             ret = wh_Client_RecvResponse(ctx, NULL, NULL, &respSz,
                                          (uint8_t*)dataPtr);
-        } while (ret == WH_ERROR_NOTREADY);
+        } while ((ret == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(ctx) == 0));
     }
 
     if (ret == WH_ERROR_OK) {
@@ -424,7 +425,7 @@ int wh_Client_AesCtr(whClientContext* ctx, Aes* aes, int enc, const uint8_t* in,
         do {
             ret =
                 wh_Client_RecvResponse(ctx, &group, &action, &res_len, dataPtr);
-        } while (ret == WH_ERROR_NOTREADY);
+        } while ((ret == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(ctx) == 0));
         if (ret == WH_ERROR_OK) {
             ret = _getCryptoResponse(dataPtr, type, (uint8_t**)&res);
             if (ret == WH_ERROR_OK) {
@@ -550,7 +551,7 @@ int wh_Client_AesCtrDma(whClientContext* ctx, Aes* aes, int enc,
         do {
             ret =
                 wh_Client_RecvResponse(ctx, &group, &action, &resLen, dataPtr);
-        } while (ret == WH_ERROR_NOTREADY);
+        } while ((ret == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(ctx) == 0));
 
         if (ret == WH_ERROR_OK) {
             /* Get response */
@@ -664,7 +665,7 @@ int wh_Client_AesEcb(whClientContext* ctx, Aes* aes, int enc, const uint8_t* in,
         do {
             ret =
                 wh_Client_RecvResponse(ctx, &group, &action, &res_len, dataPtr);
-        } while (ret == WH_ERROR_NOTREADY);
+        } while ((ret == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(ctx) == 0));
         if (ret == WH_ERROR_OK) {
             ret = _getCryptoResponse(dataPtr, type, (uint8_t**)&res);
             if (ret == WH_ERROR_OK) {
@@ -770,7 +771,7 @@ int wh_Client_AesEcbDma(whClientContext* ctx, Aes* aes, int enc,
         do {
             ret =
                 wh_Client_RecvResponse(ctx, &group, &action, &resLen, dataPtr);
-        } while (ret == WH_ERROR_NOTREADY);
+        } while ((ret == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(ctx) == 0));
 
         if (ret == WH_ERROR_OK) {
             /* Get response */
@@ -883,7 +884,7 @@ int wh_Client_AesCbc(whClientContext* ctx, Aes* aes, int enc, const uint8_t* in,
         do {
             ret =
                 wh_Client_RecvResponse(ctx, &group, &action, &res_len, dataPtr);
-        } while (ret == WH_ERROR_NOTREADY);
+        } while ((ret == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(ctx) == 0));
         if (ret == WH_ERROR_OK) {
             ret = _getCryptoResponse(dataPtr, type, (uint8_t**)&res);
             if (ret == WH_ERROR_OK) {
@@ -1000,7 +1001,7 @@ int wh_Client_AesCbcDma(whClientContext* ctx, Aes* aes, int enc,
         do {
             ret =
                 wh_Client_RecvResponse(ctx, &group, &action, &resLen, dataPtr);
-        } while (ret == WH_ERROR_NOTREADY);
+        } while ((ret == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(ctx) == 0));
 
         if (ret == WH_ERROR_OK) {
             /* Get response */
@@ -1247,7 +1248,7 @@ int wh_Client_AesGcm(whClientContext* ctx, Aes* aes, int enc, const uint8_t* in,
         do {
             ret =
                 wh_Client_RecvResponse(ctx, &group, &action, &res_len, dataPtr);
-        } while (ret == WH_ERROR_NOTREADY);
+        } while ((ret == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(ctx) == 0));
 
         if (ret == WH_ERROR_OK) {
             /* Get response */
@@ -1422,7 +1423,7 @@ int wh_Client_AesGcmDma(whClientContext* ctx, Aes* aes, int enc,
         do {
             ret =
                 wh_Client_RecvResponse(ctx, &group, &action, &resLen, dataPtr);
-        } while (ret == WH_ERROR_NOTREADY);
+        } while ((ret == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(ctx) == 0));
 
         if (ret == WH_ERROR_OK) {
             /* Get response */
@@ -1614,7 +1615,8 @@ static int _EccMakeKey(whClientContext* ctx, int size, int curveId,
                 do {
                     ret = wh_Client_RecvResponse(ctx, &group, &action, &res_len,
                                                  (uint8_t*)dataPtr);
-                } while (ret == WH_ERROR_NOTREADY);
+                } while ((ret == WH_ERROR_NOTREADY) &&
+                         (wh_Client_WaitStep(ctx) == 0));
 
                 if (ret == WH_ERROR_OK) {
                     /* Get response structure pointer, validates generic header
@@ -1778,7 +1780,8 @@ int wh_Client_EccSharedSecret(whClientContext* ctx, ecc_key* priv_key,
                 do {
                     ret = wh_Client_RecvResponse(ctx, &group, &action, &res_len,
                                                  (uint8_t*)dataPtr);
-                } while (ret == WH_ERROR_NOTREADY);
+                } while ((ret == WH_ERROR_NOTREADY) &&
+                         (wh_Client_WaitStep(ctx) == 0));
                 WH_DEBUG_CLIENT_VERBOSE("resp packet recv. ret:%d\n", ret);
                 if (ret == WH_ERROR_OK) {
                     /* Get response structure pointer, validates generic header
@@ -1914,7 +1917,8 @@ int wh_Client_EccSign(whClientContext* ctx, ecc_key* key, const uint8_t* hash,
                 do {
                     ret = wh_Client_RecvResponse(ctx, &group, &action, &res_len,
                                                  (uint8_t*)dataPtr);
-                } while (ret == WH_ERROR_NOTREADY);
+                } while ((ret == WH_ERROR_NOTREADY) &&
+                         (wh_Client_WaitStep(ctx) == 0));
 
                 if (ret == WH_ERROR_OK) {
                     /* Get response structure pointer, validates generic header
@@ -2068,7 +2072,8 @@ int wh_Client_EccVerify(whClientContext* ctx, ecc_key* key, const uint8_t* sig,
                 do {
                     ret = wh_Client_RecvResponse(ctx, &group, &action, &res_len,
                                                  (uint8_t*)dataPtr);
-                } while (ret == WH_ERROR_NOTREADY);
+                } while ((ret == WH_ERROR_NOTREADY) &&
+                         (wh_Client_WaitStep(ctx) == 0));
                 if (ret == WH_ERROR_OK) {
                     /* Get response structure pointer, validates generic header
                      * rc */
@@ -2146,7 +2151,7 @@ int wh_Client_EccCheckPubKey(whClientContext* ctx, ecc_key* key,
         do {
             ret = wh_Client_RecvResponse(ctx, &group, &action, &dataSz,
                 (uint8_t*)packet);
-        } while (ret == WH_ERROR_NOTREADY);
+        } while ((ret == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(ctx) == 0));
     }
     if (ret == 0) {
         if (packet->rc != 0)
@@ -2291,7 +2296,7 @@ static int _Curve25519MakeKey(whClientContext* ctx, uint16_t size,
         do {
             ret = wh_Client_RecvResponse(ctx, &group, &action, &data_len,
                                          (uint8_t*)dataPtr);
-        } while (ret == WH_ERROR_NOTREADY);
+        } while ((ret == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(ctx) == 0));
     }
 
 
@@ -2450,7 +2455,8 @@ int wh_Client_Curve25519SharedSecret(whClientContext* ctx,
                 do {
                     ret = wh_Client_RecvResponse(ctx, &group, &action, &res_len,
                                                  (uint8_t*)dataPtr);
-                } while (ret == WH_ERROR_NOTREADY);
+                } while ((ret == WH_ERROR_NOTREADY) &&
+                         (wh_Client_WaitStep(ctx) == 0));
                 WH_DEBUG_CLIENT_VERBOSE("resp packet recv. ret:%d\n",
                        ret);
                 if (ret == WH_ERROR_OK) {
@@ -2619,7 +2625,7 @@ static int _Ed25519MakeKey(whClientContext* ctx, whKeyId* inout_key_id,
     do {
         ret = wh_Client_RecvResponse(ctx, &group, &action, &res_len,
                                      (uint8_t*)dataPtr);
-    } while (ret == WH_ERROR_NOTREADY);
+    } while ((ret == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(ctx) == 0));
 
     if (ret != WH_ERROR_OK) {
         return ret;
@@ -2765,7 +2771,8 @@ int wh_Client_Ed25519Sign(whClientContext* ctx, ed25519_key* key,
             do {
                 ret = wh_Client_RecvResponse(ctx, &group, &action, &res_len,
                                              (uint8_t*)dataPtr);
-            } while (ret == WH_ERROR_NOTREADY);
+            } while ((ret == WH_ERROR_NOTREADY) &&
+                     (wh_Client_WaitStep(ctx) == 0));
 
             if (group != WH_MESSAGE_GROUP_CRYPTO || action != WC_ALGO_TYPE_PK) {
                 ret = WH_ERROR_ABORTED;
@@ -2904,7 +2911,8 @@ int wh_Client_Ed25519Verify(whClientContext* ctx, ed25519_key* key,
             do {
                 ret = wh_Client_RecvResponse(ctx, &group, &action, &res_len,
                                              (uint8_t*)dataPtr);
-            } while (ret == WH_ERROR_NOTREADY);
+            } while ((ret == WH_ERROR_NOTREADY) &&
+                     (wh_Client_WaitStep(ctx) == 0));
 
             if (group != WH_MESSAGE_GROUP_CRYPTO || action != WC_ALGO_TYPE_PK) {
                 ret = WH_ERROR_ABORTED;
@@ -3040,7 +3048,8 @@ int wh_Client_Ed25519SignDma(whClientContext* ctx, ed25519_key* key,
             do {
                 ret = wh_Client_RecvResponse(ctx, &group, &action, &res_len,
                                              (uint8_t*)dataPtr);
-            } while (ret == WH_ERROR_NOTREADY);
+            } while ((ret == WH_ERROR_NOTREADY) &&
+                     (wh_Client_WaitStep(ctx) == 0));
 
             if (group != WH_MESSAGE_GROUP_CRYPTO_DMA ||
                 action != WC_ALGO_TYPE_PK) {
@@ -3187,7 +3196,8 @@ int wh_Client_Ed25519VerifyDma(whClientContext* ctx, ed25519_key* key,
             do {
                 ret = wh_Client_RecvResponse(ctx, &group, &action, &res_len,
                                              (uint8_t*)dataPtr);
-            } while (ret == WH_ERROR_NOTREADY);
+            } while ((ret == WH_ERROR_NOTREADY) &&
+                     (wh_Client_WaitStep(ctx) == 0));
 
             if (group != WH_MESSAGE_GROUP_CRYPTO_DMA ||
                 action != WC_ALGO_TYPE_PK) {
@@ -3375,7 +3385,7 @@ static int _RsaMakeKey(whClientContext* ctx, uint32_t size, uint32_t e,
         do {
             ret =
                 wh_Client_RecvResponse(ctx, &group, &action, &res_len, dataPtr);
-        } while (ret == WH_ERROR_NOTREADY);
+        } while ((ret == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(ctx) == 0));
 
         WH_DEBUG_CLIENT_VERBOSE("RSA KeyGen Res recv: ret:%d, res_len: %u\n", ret,
                (unsigned int)res_len);
@@ -3539,7 +3549,8 @@ int wh_Client_RsaFunction(whClientContext* ctx, RsaKey* key, int rsa_type,
                 do {
                     ret = wh_Client_RecvResponse(ctx, &group, &action, &res_len,
                                                  (uint8_t*)dataPtr);
-                } while (ret == WH_ERROR_NOTREADY);
+                } while ((ret == WH_ERROR_NOTREADY) &&
+                         (wh_Client_WaitStep(ctx) == 0));
 
                 if (ret == WH_ERROR_OK) {
                     /* Get response */
@@ -3651,7 +3662,8 @@ int wh_Client_RsaGetSize(whClientContext* ctx, const RsaKey* key, int* out_size)
                 do {
                     ret = wh_Client_RecvResponse(ctx, &group, &action, &res_len,
                                                  (uint8_t*)dataPtr);
-                } while (ret == WH_ERROR_NOTREADY);
+                } while ((ret == WH_ERROR_NOTREADY) &&
+                         (wh_Client_WaitStep(ctx) == 0));
 
                 if (ret == WH_ERROR_OK) {
                     /* Get response */
@@ -3779,7 +3791,7 @@ static int _HkdfMakeKey(whClientContext* ctx, int hashType, whKeyId keyIdIn,
         do {
             ret =
                 wh_Client_RecvResponse(ctx, &group, &action, &res_len, dataPtr);
-        } while (ret == WH_ERROR_NOTREADY);
+        } while ((ret == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(ctx) == 0));
 
         WH_DEBUG_CLIENT_VERBOSE("HKDF Res recv: ret:%d, res_len: %u\n", ret,
                (unsigned int)res_len);
@@ -3946,7 +3958,7 @@ static int _CmacKdfMakeKey(whClientContext* ctx, whKeyId saltKeyId,
     uint16_t res_len = 0;
     do {
         ret = wh_Client_RecvResponse(ctx, &group, &action, &res_len, dataPtr);
-    } while (ret == WH_ERROR_NOTREADY);
+    } while ((ret == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(ctx) == 0));
 
     if (ret == WH_ERROR_OK) {
         ret = _getCryptoResponse(dataPtr, WC_ALGO_TYPE_KDF, (uint8_t**)&res);
@@ -4139,7 +4151,7 @@ int wh_Client_Cmac(whClientContext* ctx, Cmac* cmac, CmacType type,
         do {
             ret = wh_Client_RecvResponse(ctx, &group, &action, &res_len,
                                          (uint8_t*)dataPtr);
-        } while (ret == WH_ERROR_NOTREADY);
+        } while ((ret == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(ctx) == 0));
         if (ret == WH_ERROR_OK) {
             /* Get response */
             ret =
@@ -4272,7 +4284,7 @@ int wh_Client_CmacDma(whClientContext* ctx, Cmac* cmac, CmacType type,
         do {
             ret = wh_Client_RecvResponse(ctx, NULL, NULL, &respSz,
                                          (uint8_t*)dataPtr);
-        } while (ret == WH_ERROR_NOTREADY);
+        } while ((ret == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(ctx) == 0));
 
         if (ret == WH_ERROR_OK) {
             ret =
@@ -4375,7 +4387,7 @@ static int _xferSha256BlockAndUpdateDigest(whClientContext* ctx,
         do {
             ret = wh_Client_RecvResponse(ctx, &group, &action, &dataSz,
                                          (uint8_t*)dataPtr);
-        } while (ret == WH_ERROR_NOTREADY);
+        } while ((ret == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(ctx) == 0));
     }
     if (ret == 0) {
         /* Get response */
@@ -4531,7 +4543,8 @@ int wh_Client_Sha256Dma(whClientContext* ctx, wc_Sha256* sha, const uint8_t* in,
             do {
                 ret = wh_Client_RecvResponse(ctx, NULL, NULL, &respSz,
                                              (uint8_t*)dataPtr);
-            } while (ret == WH_ERROR_NOTREADY);
+            } while ((ret == WH_ERROR_NOTREADY) &&
+                     (wh_Client_WaitStep(ctx) == 0));
         }
 
         if (ret == WH_ERROR_OK) {
@@ -4560,7 +4573,8 @@ int wh_Client_Sha256Dma(whClientContext* ctx, wc_Sha256* sha, const uint8_t* in,
             do {
                 ret = wh_Client_RecvResponse(ctx, NULL, NULL, &respSz,
                                              (uint8_t*)dataPtr);
-            } while (ret == WH_ERROR_NOTREADY);
+            } while ((ret == WH_ERROR_NOTREADY) &&
+                     (wh_Client_WaitStep(ctx) == 0));
         }
 
         /* Copy out the final hash value */
@@ -4661,7 +4675,7 @@ static int _xferSha224BlockAndUpdateDigest(whClientContext* ctx,
         do {
             ret = wh_Client_RecvResponse(ctx, &group, &action, &dataSz,
                                          (uint8_t*)dataPtr);
-        } while (ret == WH_ERROR_NOTREADY);
+        } while ((ret == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(ctx) == 0));
     }
     if (ret == 0) {
         /* Get response */
@@ -4816,7 +4830,8 @@ int wh_Client_Sha224Dma(whClientContext* ctx, wc_Sha224* sha, const uint8_t* in,
             do {
                 ret = wh_Client_RecvResponse(ctx, NULL, NULL, &respSz,
                                              (uint8_t*)dataPtr);
-            } while (ret == WH_ERROR_NOTREADY);
+            } while ((ret == WH_ERROR_NOTREADY) &&
+                     (wh_Client_WaitStep(ctx) == 0));
         }
 
         if (ret == WH_ERROR_OK) {
@@ -4846,7 +4861,8 @@ int wh_Client_Sha224Dma(whClientContext* ctx, wc_Sha224* sha, const uint8_t* in,
             do {
                 ret = wh_Client_RecvResponse(ctx, NULL, NULL, &respSz,
                                              (uint8_t*)dataPtr);
-            } while (ret == WH_ERROR_NOTREADY);
+            } while ((ret == WH_ERROR_NOTREADY) &&
+                     (wh_Client_WaitStep(ctx) == 0));
         }
 
         /* Copy out the final hash value */
@@ -4942,7 +4958,7 @@ static int _xferSha384BlockAndUpdateDigest(whClientContext* ctx,
         do {
             ret = wh_Client_RecvResponse(ctx, &group, &action, &dataSz,
                                          (uint8_t*)dataPtr);
-        } while (ret == WH_ERROR_NOTREADY);
+        } while ((ret == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(ctx) == 0));
     }
     if (ret == 0) {
         /* Get response */
@@ -5097,7 +5113,8 @@ int wh_Client_Sha384Dma(whClientContext* ctx, wc_Sha384* sha, const uint8_t* in,
             do {
                 ret = wh_Client_RecvResponse(ctx, NULL, NULL, &respSz,
                                              (uint8_t*)dataPtr);
-            } while (ret == WH_ERROR_NOTREADY);
+            } while ((ret == WH_ERROR_NOTREADY) &&
+                     (wh_Client_WaitStep(ctx) == 0));
         }
 
         if (ret == WH_ERROR_OK) {
@@ -5127,7 +5144,8 @@ int wh_Client_Sha384Dma(whClientContext* ctx, wc_Sha384* sha, const uint8_t* in,
             do {
                 ret = wh_Client_RecvResponse(ctx, NULL, NULL, &respSz,
                                              (uint8_t*)dataPtr);
-            } while (ret == WH_ERROR_NOTREADY);
+            } while ((ret == WH_ERROR_NOTREADY) &&
+                     (wh_Client_WaitStep(ctx) == 0));
         }
 
         /* Copy out the final hash value */
@@ -5224,7 +5242,7 @@ static int _xferSha512BlockAndUpdateDigest(whClientContext* ctx,
         do {
             ret = wh_Client_RecvResponse(ctx, &group, &action, &dataSz,
                                          (uint8_t*)dataPtr);
-        } while (ret == WH_ERROR_NOTREADY);
+        } while ((ret == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(ctx) == 0));
     }
     if (ret == 0) {
         /* Get response */
@@ -5390,7 +5408,8 @@ int wh_Client_Sha512Dma(whClientContext* ctx, wc_Sha512* sha, const uint8_t* in,
             do {
                 ret = wh_Client_RecvResponse(ctx, NULL, NULL, &respSz,
                                              (uint8_t*)dataPtr);
-            } while (ret == WH_ERROR_NOTREADY);
+            } while ((ret == WH_ERROR_NOTREADY) &&
+                     (wh_Client_WaitStep(ctx) == 0));
         }
 
         if (ret == WH_ERROR_OK) {
@@ -5420,7 +5439,8 @@ int wh_Client_Sha512Dma(whClientContext* ctx, wc_Sha512* sha, const uint8_t* in,
             do {
                 ret = wh_Client_RecvResponse(ctx, NULL, NULL, &respSz,
                                              (uint8_t*)dataPtr);
-            } while (ret == WH_ERROR_NOTREADY);
+            } while ((ret == WH_ERROR_NOTREADY) &&
+                     (wh_Client_WaitStep(ctx) == 0));
         }
 
         /* Copy out the final hash value */
@@ -5598,7 +5618,8 @@ static int _MlDsaMakeKey(whClientContext* ctx, int size, int level,
                 do {
                     ret = wh_Client_RecvResponse(ctx, &group, &action, &res_len,
                                                  (uint8_t*)dataPtr);
-                } while (ret == WH_ERROR_NOTREADY);
+                } while ((ret == WH_ERROR_NOTREADY) &&
+                         (wh_Client_WaitStep(ctx) == 0));
 
                 if (ret == WH_ERROR_OK) {
                     /* Get response structure pointer, validates generic header
@@ -5680,6 +5701,10 @@ int wh_Client_MlDsaSign(whClientContext* ctx, const byte* in, word32 in_len,
     whMessageCrypto_MlDsaSignRequest*  req     = NULL;
     whMessageCrypto_MlDsaSignResponse* res     = NULL;
     uint8_t*                           dataPtr = NULL;
+    whCommIoVec                        iov[3]  = {{0}};
+    /* Response header storage, as the signature may be streamed */
+    uint64_t resBuf[(sizeof(whMessageCrypto_GenericResponseHeader) +
+                     sizeof(*res) + 7) / 8];
 
     /* Transaction state */
     whKeyId key_id;
@@ -5733,9 +5758,7 @@ int wh_Client_MlDsaSign(whClientContext* ctx, const byte* in, word32 in_len,
                 dataPtr, WC_PK_TYPE_PQC_SIG_SIGN, WC_PQC_SIG_TYPE_DILITHIUM,
                 ctx->cryptoAffinity);
 
-        if (total_len <= WOLFHSM_CFG_COMM_DATA_LEN) {
-            uint16_t req_len = (uint16_t)total_len;
-            uint8_t* req_data = (uint8_t*)(req + 1);
+        if (total_len <= wh_CommClient_GetMaxDataLen(ctx->comm)) {
             if (evict != 0) {
                 options |= WH_MESSAGE_CRYPTO_MLDSA_SIGN_OPTIONS_EVICT;
             }
@@ -5747,49 +5770,51 @@ int wh_Client_MlDsaSign(whClientContext* ctx, const byte* in, word32 in_len,
             req->sz          = in_len;
             req->contextSz   = contextLen;
             req->preHashType = preHashType;
-            if ((in != NULL) && (in_len > 0)) {
-                memcpy(req_data, in, in_len);
-            }
-            if ((context != NULL) && (contextLen > 0)) {
-                memcpy(req_data + in_len, context, contextLen);
-            }
+
+            /* The message and context are streamed from the caller's buffers
+             * if they do not fit in the comm buffer */
+            iov[0].data = dataPtr;
+            iov[0].size = (uint16_t)((uint8_t*)(req + 1) - dataPtr);
+            iov[1].data = in;
+            iov[1].size = (uint16_t)in_len;
+            iov[2].data = context;
+            iov[2].size = contextLen;
 
             /* Send Request */
-            ret = wh_Client_SendRequest(ctx, group, action, req_len,
-                                        (uint8_t*)dataPtr);
+            ret = wh_Client_SendRequestV(ctx, group, action, 3, iov);
             if (ret == WH_ERROR_OK) {
                 /* Server will evict at this point. Reset evict */
                 evict = 0;
 
                 /* Response Message */
                 uint16_t res_len = 0;
+                uint16_t sig_max =
+                    (*inout_len > 0xFFFF) ? 0xFFFF : (uint16_t)*inout_len;
 
-                /* Recv Response */
+                /* Recv Response, with the signature directly into out */
                 do {
-                    ret = wh_Client_RecvResponse(ctx, &group, &action, &res_len,
-                                                 (uint8_t*)dataPtr);
-                } while (ret == WH_ERROR_NOTREADY);
+                    ret = wh_Client_RecvResponseExt(
+                        ctx, &group, &action, &res_len, sizeof(resBuf),
+                        resBuf, sig_max, out);
+                } while ((ret == WH_ERROR_NOTREADY) &&
+                         (wh_Client_WaitStep(ctx) == 0));
 
                 if (ret == WH_ERROR_OK) {
                     /* Get response structure pointer, validates generic header
                      * rc */
-                    ret = _getCryptoResponse(dataPtr, WC_PK_TYPE_PQC_SIG_SIGN,
+                    ret = _getCryptoResponse((uint8_t*)resBuf,
+                                             WC_PK_TYPE_PQC_SIG_SIGN,
                                              (uint8_t**)&res);
                     /* wolfCrypt allows positive error codes on success in some
                      * scenarios */
                     if (ret >= 0) {
-                        uint8_t* res_sig = (uint8_t*)(res + 1);
-                        uint16_t sig_len = res->sz;
-                        /* check inoutlen and read out */
-                        if (inout_len != NULL) {
-                            if (sig_len > *inout_len) {
-                                /* Silently truncate the signature */
-                                sig_len = *inout_len;
-                            }
-                            *inout_len = sig_len;
-                            if ((out != NULL) && (sig_len > 0)) {
-                                memcpy(out, res_sig, sig_len);
-                            }
+                        if ((res->sz > sig_max) ||
+                            ((uint8_t*)(res + 1) - (uint8_t*)resBuf + res->sz >
+                             res_len)) {
+                            ret = WH_ERROR_ABORTED;
+                        }
+                        else {
+                            *inout_len = res->sz;
                         }
                     }
                 }
@@ -5869,10 +5894,8 @@ int wh_Client_MlDsaVerify(whClientContext* ctx, const byte* sig, word32 sig_len,
                                             WC_PQC_SIG_TYPE_DILITHIUM,
                                             ctx->cryptoAffinity);
 
-        if (total_len <= WOLFHSM_CFG_COMM_DATA_LEN) {
-            uint16_t req_len = (uint16_t)total_len;
-            uint8_t* req_sig  = (uint8_t*)(req + 1);
-            uint8_t* req_hash = req_sig + sig_len;
+        if (total_len <= wh_CommClient_GetMaxDataLen(ctx->comm)) {
+            whCommIoVec iov[4] = {{0}};
 
             /* Set request packet members */
             if (evict != 0) {
@@ -5884,22 +5907,23 @@ int wh_Client_MlDsaVerify(whClientContext* ctx, const byte* sig, word32 sig_len,
             req->level       = key->level;
             req->keyId       = key_id;
             req->sigSz       = sig_len;
-            if ((sig != NULL) && (sig_len > 0)) {
-                memcpy(req_sig, sig, sig_len);
-            }
             req->hashSz      = msg_len;
-            if ((msg != NULL) && (msg_len > 0)) {
-                memcpy(req_hash, msg, msg_len);
-            }
             req->contextSz   = contextLen;
             req->preHashType = preHashType;
-            if ((context != NULL) && (contextLen > 0)) {
-                memcpy(req_hash + msg_len, context, contextLen);
-            }
+
+            /* The signature, message and context are streamed from the
+             * caller's buffers if they do not fit in the comm buffer */
+            iov[0].data = dataPtr;
+            iov[0].size = (uint16_t)((uint8_t*)(req + 1) - dataPtr);
+            iov[1].data = sig;
+            iov[1].size = (uint16_t)sig_len;
+            iov[2].data = msg;
+            iov[2].size = (uint16_t)msg_len;
+            iov[3].data = context;
+            iov[3].size = contextLen;
 
             /* write request */
-            ret = wh_Client_SendRequest(ctx, group, action, req_len,
-                                        (uint8_t*)dataPtr);
+            ret = wh_Client_SendRequestV(ctx, group, action, 4, iov);
 
             if (ret == WH_ERROR_OK) {
                 /* Server will evict at this point. Reset evict */
@@ -5911,7 +5935,8 @@ int wh_Client_MlDsaVerify(whClientContext* ctx, const byte* sig, word32 sig_len,
                 do {
                     ret = wh_Client_RecvResponse(ctx, &group, &action, &res_len,
                                                  (uint8_t*)dataPtr);
-                } while (ret == WH_ERROR_NOTREADY);
+                } while ((ret == WH_ERROR_NOTREADY) &&
+                         (wh_Client_WaitStep(ctx) == 0));
                 if (ret == 0) {
                     /* Get response structure pointer, validates generic header
                      * rc */
@@ -6080,7 +6105,8 @@ static int _MlDsaMakeKeyDma(whClientContext* ctx, int level,
             do {
                 ret = wh_Client_RecvResponse(ctx, &group, &action, &res_len,
                                              (uint8_t*)dataPtr);
-            } while (ret == WH_ERROR_NOTREADY);
+            } while ((ret == WH_ERROR_NOTREADY) &&
+                     (wh_Client_WaitStep(ctx) == 0));
         }
 
         (void)wh_Client_DmaProcessClientAddress(
@@ -6248,7 +6274,8 @@ int wh_Client_MlDsaSignDma(whClientContext* ctx, const byte* in, word32 in_len,
                 do {
                     ret = wh_Client_RecvResponse(ctx, &group, &action, &res_len,
                                                  (uint8_t*)dataPtr);
-                } while (ret == WH_ERROR_NOTREADY);
+                } while ((ret == WH_ERROR_NOTREADY) &&
+                         (wh_Client_WaitStep(ctx) == 0));
 
                 if (ret == WH_ERROR_OK) {
                     /* Get response structure pointer, validates generic header
@@ -6391,7 +6418,8 @@ int wh_Client_MlDsaVerifyDma(whClientContext* ctx, const byte* sig,
                 do {
                     ret = wh_Client_RecvResponse(ctx, &group, &action, &res_len,
                                                  (uint8_t*)dataPtr);
-                } while (ret == WH_ERROR_NOTREADY);
+                } while ((ret == WH_ERROR_NOTREADY) &&
+                         (wh_Client_WaitStep(ctx) == 0));
 
                 if (ret == WH_ERROR_OK) {
                     /* Get response structure pointer, validates generic header
@@ -122,7 +122,7 @@ int wh_Client_KeyWrap(whClientContext* ctx, enum wc_CipherType cipherType,
     do {
         ret = wh_Client_KeyWrapResponse(ctx, cipherType, wrappedKeyOut,
                                         wrappedKeyInOutSz);
-    } while (ret == WH_ERROR_NOTREADY);
+    } while ((ret == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(ctx) == 0));
 
     return ret;
 }
@@ -245,7 +245,7 @@ int wh_Client_KeyUnwrapAndExport(whClientContext*   ctx,
     do {
         ret = wh_Client_KeyUnwrapAndExportResponse(ctx, cipherType, metadataOut,
                                                    keyOut, keyInOutSz);
-    } while (ret == WH_ERROR_NOTREADY);
+    } while ((ret == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(ctx) == 0));
 
     return ret;
 }
@@ -349,7 +349,7 @@ int wh_Client_KeyUnwrapAndCache(whClientContext*   ctx,
 
     do {
         ret = wh_Client_KeyUnwrapAndCacheResponse(ctx, cipherType, keyIdOut);
-    } while (ret == WH_ERROR_NOTREADY);
+    } while ((ret == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(ctx) == 0));
 
     return ret;
 }
@@ -461,7 +461,7 @@ int wh_Client_DataWrap(whClientContext* ctx, enum wc_CipherType cipherType,
         ret = wh_Client_DataWrapResponse(ctx, cipherType, wrappedDataOut,
                                          wrappedDataInOutSz);
 
-    } while (ret == WH_ERROR_NOTREADY);
+    } while ((ret == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(ctx) == 0));
 
     return ret;
 }
@@ -574,7 +574,7 @@ int wh_Client_DataUnwrap(whClientContext* ctx, enum wc_CipherType cipherType,
         ret =
             wh_Client_DataUnwrapResponse(ctx, cipherType, dataOut, dataInOutSz);
 
-    } while (ret == WH_ERROR_NOTREADY);
+    } while ((ret == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(ctx) == 0));
 
     return ret;
 }
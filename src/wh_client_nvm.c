@@ -112,7 +112,7 @@ int wh_Client_NvmInit(whClientContext* c, int32_t *out_rc,
         do {
             rc = wh_Client_NvmInitResponse(c, out_rc,
                     out_clientnvm_id, out_servernvm_id);
-        } while (rc == WH_ERROR_NOTREADY);
+        } while ((rc == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(c) == 0));
     }
     return rc;
 }
@@ -176,7 +176,7 @@ int wh_Client_NvmCleanup(whClientContext* c, int32_t *out_rc)
     if (rc == 0) {
         do {
             rc = wh_Client_NvmCleanupResponse(c, out_rc);
-        } while (rc == WH_ERROR_NOTREADY);
+        } while ((rc == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(c) == 0));
     }
     return rc;
 }
@@ -258,7 +258,7 @@ int wh_Client_NvmGetAvailable(whClientContext* c, int32_t *out_rc,
             rc = wh_Client_NvmGetAvailableResponse(c, out_rc,
                     out_avail_size, out_avail_objects,
                     out_reclaim_size, out_reclaim_objects);
-        } while (rc == WH_ERROR_NOTREADY);
+        } while ((rc == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(c) == 0));
     }
     return rc;
 }
@@ -269,34 +269,35 @@ int wh_Client_NvmAddObjectRequest(whClientContext* c,
         whNvmSize label_len, uint8_t* label,
         whNvmSize len, const uint8_t* data)
 {
-    /*TODO: Add scatter/gather into CommClient to avoid construction here */
-    uint8_t buffer[WOLFHSM_CFG_COMM_DATA_LEN] = {0};
-    whMessageNvm_AddObjectRequest* msg = (whMessageNvm_AddObjectRequest*)buffer;
-    uint16_t hdr_len = sizeof(*msg);
-    uint8_t* payload = (uint8_t*)buffer + hdr_len;
+    whMessageNvm_AddObjectRequest msg = {0};
+    uint16_t hdr_len = sizeof(msg);
+    whCommIoVec iov[2] = {{0}};
 
     if (    (c == NULL) ||
             ((label == NULL) && (label_len > 0)) ||
             (label_len > WH_NVM_LABEL_LEN) ||
             ((data == NULL) && (len > 0)) ||
-            (len > WH_MESSAGE_NVM_MAX_ADDOBJECT_LEN) ){
+            (len > wh_CommClient_GetMaxDataLen(c->comm) - hdr_len) ){
         return WH_ERROR_BADARGS;
     }
 
-    msg->id = id;
-    msg->access = access;
-    msg->flags = flags;
-    msg->len = len;
+    msg.id = id;
+    msg.access = access;
+    msg.flags = flags;
+    msg.len = len;
     if(label_len > 0) {
-        memcpy(msg->label, label, label_len);
-    }
-    if(len > 0) {
-        memcpy(payload, data, len);
+        memcpy(msg.label, label, label_len);
     }
 
-    return wh_Client_SendRequest(c,
+    /* The object may be larger than WOLFHSM_CFG_COMM_DATA_LEN when
+     * fragmenting, in which case it is sent straight from data */
+    iov[0].data = &msg;
+    iov[0].size = hdr_len;
+    iov[1].data = data;
+    iov[1].size = len;
+    return wh_Client_SendRequestV(c,
             WH_MESSAGE_GROUP_NVM, WH_MESSAGE_NVM_ACTION_ADDOBJECT,
-            hdr_len + len, buffer);
+            2, iov);
 }
 
 int wh_Client_NvmAddObjectResponse(whClientContext* c, int32_t *out_rc)
@@ -351,7 +352,7 @@ int wh_Client_NvmAddObject(whClientContext* c,
     if (rc == 0) {
         do {
             rc = wh_Client_NvmAddObjectResponse(c, out_rc);
-        } while (rc == WH_ERROR_NOTREADY);
+        } while ((rc == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(c) == 0));
     }
     return rc;
 }
@@ -432,7 +433,7 @@ int wh_Client_NvmList(whClientContext* c,
         do {
             rc = wh_Client_NvmListResponse(c, out_rc,
                     out_count, out_id);
-        } while (rc == WH_ERROR_NOTREADY);
+        } while ((rc == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(c) == 0));
     }
     return rc;
 }
@@ -523,7 +524,7 @@ int wh_Client_NvmGetMetadata(whClientContext* c, whNvmId id,
             rc = wh_Client_NvmGetMetadataResponse(c, out_rc,
                     out_id, out_access, out_flags, out_len,
                     label_len, label);
-        } while (rc == WH_ERROR_NOTREADY);
+        } while ((rc == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(c) == 0));
     }
     return rc;
 }
@@ -551,6 +552,28 @@ int wh_Client_NvmDestroyObjectsRequest(whClientContext* c,
             sizeof(msg), &msg);
 }
 
+int wh_Client_NvmDestroyObjectsNoResp(whClientContext* c,
+        whNvmId list_count, const whNvmId* id_list)
+{
+    whMessageNvm_DestroyObjectsRequest msg = {0};
+    int counter = 0;
+
+    if (    (c == NULL) ||
+            ((id_list == NULL) && (list_count > 0)) ||
+            (list_count > WH_MESSAGE_NVM_MAX_DESTROY_OBJECTS_COUNT) ){
+        return WH_ERROR_BADARGS;
+    }
+
+    msg.list_count = list_count;
+    for (counter = 0; counter < list_count; counter++) {
+        msg.list[counter] = id_list[counter];
+    }
+
+    return wh_Client_SendRequestNoResp(c,
+            WH_MESSAGE_GROUP_NVM, WH_MESSAGE_NVM_ACTION_DESTROYOBJECTS,
+            sizeof(msg), &msg);
+}
+
 int wh_Client_NvmDestroyObjectsResponse(whClientContext* c, int32_t *out_rc)
 {
     whMessageNvm_SimpleResponse msg = {0};
@@ -600,7 +623,7 @@ int wh_Client_NvmDestroyObjects(whClientContext* c,
     if (rc == 0) {
         do {
             rc = wh_Client_NvmDestroyObjectsResponse(c, out_rc);
-        } while (rc == WH_ERROR_NOTREADY);
+        } while ((rc == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(c) == 0));
     }
     return rc;
 }
@@ -626,10 +649,9 @@ int wh_Client_NvmReadRequest(whClientContext* c,
 int wh_Client_NvmReadResponse(whClientContext* c, int32_t *out_rc,
         whNvmSize *out_len, uint8_t* data)
 {
-    uint8_t                    buffer[WOLFHSM_CFG_COMM_DATA_LEN] = {0};
-    whMessageNvm_ReadResponse* msg = (whMessageNvm_ReadResponse*)buffer;
-    uint16_t hdr_len = sizeof(*msg);
-    uint8_t* payload = buffer + hdr_len;
+    whMessageNvm_ReadResponse msg = {0};
+    uint16_t hdr_len = sizeof(msg);
+    uint8_t* buffer = NULL;
 
     int rc = 0;
     uint16_t resp_group = 0;
@@ -640,29 +662,40 @@ int wh_Client_NvmReadResponse(whClientContext* c, int32_t *out_rc,
         return WH_ERROR_BADARGS;
     }
 
-    rc = wh_Client_RecvResponse(c,
-            &resp_group, &resp_action,
-            &resp_size, buffer);
+    if (data != NULL) {
+        /* Receive the data straight into the caller's buffer, since it may be
+         * larger than WOLFHSM_CFG_COMM_DATA_LEN when fragmenting */
+        rc = wh_Client_RecvResponseExt(c,
+                &resp_group, &resp_action, &resp_size,
+                hdr_len, &msg,
+                wh_CommClient_GetMaxDataLen(c->comm) - hdr_len, data);
+    }
+    else {
+        /* Discard the data in the comm buffer */
+        buffer = wh_CommClient_GetDataPtr(c->comm);
+        rc = wh_Client_RecvResponse(c,
+                &resp_group, &resp_action,
+                &resp_size, buffer);
+        if ((rc == 0) && (resp_size >= hdr_len)) {
+            memcpy(&msg, buffer, hdr_len);
+        }
+    }
     if (rc == 0) {
         /* Validate response */
         if ((resp_group != WH_MESSAGE_GROUP_NVM) ||
             (resp_action != WH_MESSAGE_NVM_ACTION_READ) ||
-            (resp_size < hdr_len) || (resp_size > sizeof(buffer)) ||
-            (resp_size - hdr_len > WH_MESSAGE_NVM_MAX_READ_LEN)) {
+            (resp_size < hdr_len)) {
             /* Invalid message */
             rc = WH_ERROR_ABORTED;
         }
         else {
             /* Valid message */
             if (out_rc != NULL) {
-                *out_rc = msg->rc;
+                *out_rc = msg.rc;
             }
             if (out_len != NULL) {
                 *out_len = resp_size - hdr_len;
             }
-            if (data != NULL) {
-                memcpy(data, payload, resp_size - hdr_len);
-            }
         }
     }
     return rc;
@@ -684,7 +717,7 @@ int wh_Client_NvmRead(whClientContext* c,
         do {
             rc = wh_Client_NvmReadResponse(c, out_rc,
                     out_len, data);
-        } while (rc == WH_ERROR_NOTREADY);
+        } while ((rc == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(c) == 0));
     }
     return rc;
 }
@@ -757,7 +790,7 @@ int wh_Client_NvmAddObjectDma(whClientContext* c, whNvmMetadata* metadata,
     if (rc == 0) {
         do {
             rc = wh_Client_NvmAddObjectDmaResponse(c, out_rc);
-        } while (rc == WH_ERROR_NOTREADY);
+        } while ((rc == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(c) == 0));
     }
     return rc;
 }
@@ -826,7 +859,7 @@ int wh_Client_NvmReadDma(whClientContext* c, whNvmId id, whNvmSize offset,
     if (rc == 0) {
         do {
             rc = wh_Client_NvmReadDmaResponse(c, out_rc);
-        } while (rc == WH_ERROR_NOTREADY);
+        } while ((rc == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(c) == 0));
     }
     return rc;
 }
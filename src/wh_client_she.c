@@ -109,7 +109,7 @@ int wh_Client_SheSetUid(whClientContext* c, uint8_t* uid, uint32_t uidSz)
     if (ret == 0) {
         do {
             ret = wh_Client_SheSetUidResponse(c);
-        } while (ret == WH_ERROR_NOTREADY);
+        } while ((ret == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(c) == 0));
     }
     return ret;
 }
@@ -148,7 +148,7 @@ int wh_Client_SheSecureBoot(whClientContext* c, uint8_t* bootloader,
         do {
             ret = wh_Client_RecvResponse(c, &group, &action, &dataSz, respBuf);
             initResp = (whMessageShe_SecureBootInitResponse*)respBuf;
-        } while (ret == WH_ERROR_NOTREADY);
+        } while ((ret == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(c) == 0));
     }
 
     /* send update sub command until we've sent the entire bootloader */
@@ -184,7 +184,8 @@ int wh_Client_SheSecureBoot(whClientContext* c, uint8_t* bootloader,
             do {
                 ret = wh_Client_RecvResponse(c, &group, &action, &dataSz,
                                              respBuf);
-            } while (ret == WH_ERROR_NOTREADY);
+            } while ((ret == WH_ERROR_NOTREADY) &&
+                     (wh_Client_WaitStep(c) == 0));
         }
 
         /* increment sent  */
@@ -203,7 +204,7 @@ int wh_Client_SheSecureBoot(whClientContext* c, uint8_t* bootloader,
         do {
             ret = wh_Client_RecvResponse(c, &group, &action, &dataSz, respBuf);
             finishResp = (whMessageShe_SecureBootFinishResponse*)respBuf;
-        } while (ret == WH_ERROR_NOTREADY);
+        } while ((ret == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(c) == 0));
     }
 
     if (ret == 0) {
@@ -260,7 +261,7 @@ int wh_Client_SheGetStatus(whClientContext* c, uint8_t* sreg)
     if (ret == 0) {
         do {
             ret = wh_Client_SheGetStatusResponse(c, sreg);
-        } while (ret == WH_ERROR_NOTREADY);
+        } while ((ret == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(c) == 0));
     }
     return ret;
 }
@@ -328,7 +329,7 @@ int wh_Client_SheLoadKey(whClientContext* c, uint8_t* messageOne,
     if (ret == 0) {
         do {
             ret = wh_Client_SheLoadKeyResponse(c, messageFour, messageFive);
-        } while (ret == WH_ERROR_NOTREADY);
+        } while ((ret == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(c) == 0));
     }
     return ret;
 }
@@ -379,7 +380,7 @@ int wh_Client_SheLoadPlainKey(whClientContext* c, uint8_t* key, uint32_t keySz)
     if (ret == 0) {
         do {
             ret = wh_Client_SheLoadPlainKeyResponse(c);
-        } while (ret == WH_ERROR_NOTREADY);
+        } while ((ret == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(c) == 0));
     }
     return ret;
 }
@@ -443,7 +444,7 @@ int wh_Client_SheExportRamKey(whClientContext* c, uint8_t* messageOne,
         do {
             ret = wh_Client_SheExportRamKeyResponse(c, messageOne, messageTwo,
                 messageThree, messageFour, messageFive);
-        } while (ret == WH_ERROR_NOTREADY);
+        } while ((ret == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(c) == 0));
     }
     return ret;
 }
@@ -486,7 +487,7 @@ int wh_Client_SheInitRnd(whClientContext* c)
     if (ret == 0) {
         do {
             ret = wh_Client_SheInitRndResponse(c);
-        } while (ret == WH_ERROR_NOTREADY);
+        } while ((ret == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(c) == 0));
     }
     return ret;
 }
@@ -535,7 +536,7 @@ int wh_Client_SheRnd(whClientContext* c, uint8_t* out, uint32_t* outSz)
     if (ret == 0) {
         do {
             ret = wh_Client_SheRndResponse(c, out, outSz);
-        } while (ret == WH_ERROR_NOTREADY);
+        } while ((ret == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(c) == 0));
     }
     return ret;
 }
@@ -592,7 +593,7 @@ int wh_Client_SheExtendSeed(whClientContext* c, uint8_t* entropy,
     if (ret == 0) {
         do {
             ret = wh_Client_SheExtendSeedResponse(c);
-        } while (ret == WH_ERROR_NOTREADY);
+        } while ((ret == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(c) == 0));
     }
     return ret;
 }
@@ -661,7 +662,7 @@ int wh_Client_SheEncEcb(whClientContext* c, uint8_t keyId, uint8_t* in,
     if (ret == 0) {
         do {
             ret = wh_Client_SheEncEcbResponse(c, out, sz);
-        } while (ret == WH_ERROR_NOTREADY);
+        } while ((ret == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(c) == 0));
     }
     return ret;
 }
@@ -733,7 +734,7 @@ int wh_Client_SheEncCbc(whClientContext* c, uint8_t keyId, uint8_t* iv,
     if (ret == 0) {
         do {
             ret = wh_Client_SheEncCbcResponse(c, out, sz);
-        } while (ret == WH_ERROR_NOTREADY);
+        } while ((ret == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(c) == 0));
     }
     return ret;
 }
@@ -801,7 +802,7 @@ int wh_Client_SheDecEcb(whClientContext* c, uint8_t keyId, uint8_t* in,
     if (ret == 0) {
         do {
             ret = wh_Client_SheDecEcbResponse(c, out, sz);
-        } while (ret == WH_ERROR_NOTREADY);
+        } while ((ret == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(c) == 0));
     }
     return ret;
 }
@@ -873,7 +874,7 @@ int wh_Client_SheDecCbc(whClientContext* c, uint8_t keyId, uint8_t* iv,
     if (ret == 0) {
         do {
             ret = wh_Client_SheDecCbcResponse(c, out, sz);
-        } while (ret == WH_ERROR_NOTREADY);
+        } while ((ret == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(c) == 0));
     }
     return ret;
 }
@@ -937,7 +938,7 @@ int wh_Client_SheGenerateMac(whClientContext* c, uint8_t keyId, uint8_t* in,
     if (ret == 0) {
         do {
             ret = wh_Client_SheGenerateMacResponse(c, out, outSz);
-        } while (ret == WH_ERROR_NOTREADY);
+        } while ((ret == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(c) == 0));
     }
     return ret;
 }
@@ -1010,7 +1011,7 @@ int wh_Client_SheVerifyMac(whClientContext* c, uint8_t keyId, uint8_t* message,
     if (ret == 0) {
         do {
             ret = wh_Client_SheVerifyMacResponse(c, outStatus);
-        } while (ret == WH_ERROR_NOTREADY);
+        } while ((ret == WH_ERROR_NOTREADY) && (wh_Client_WaitStep(c) == 0));
     }
     return ret;
 }
@@ -34,29 +34,265 @@
 #include "wolfhsm/wh_comm.h"
 
 
-/** Conditional byteswap functions */
+#if defined(WOLFHSM_CFG_ENABLE_CLIENT) || defined(WOLFHSM_CFG_COMM_FRAGMENT)
+/* Caller buffers receiving the data of a response, or of a streamed logical
+ * packet when fragmenting */
+typedef struct {
+    uint8_t* data;
+    uint8_t* ext;
+    uint16_t data_size;
+    uint16_t ext_size;
+} whCommRecvDest;
 
-uint8_t wh_Translate8(uint16_t magic, uint8_t val)
+/* Copy len bytes to offset within the data then ext buffers of dest, dropping
+ * whatever does not fit */
+static void _wh_Comm_ScatterDest(const whCommRecvDest* dest, uint16_t offset,
+        const uint8_t* src, uint16_t len)
 {
-    (void) magic;
-    return val;
+    uint16_t n = 0;
+
+    if (dest == NULL) {
+        return;
+    }
+    if (offset < dest->data_size) {
+        n = dest->data_size - offset;
+        if (n > len) {
+            n = len;
+        }
+        memmove(dest->data + offset, src, n);
+        src += n;
+        len -= n;
+        offset += n;
+    }
+    offset -= dest->data_size;
+    if ((len > 0) && (offset < dest->ext_size)) {
+        n = dest->ext_size - offset;
+        if (n > len) {
+            n = len;
+        }
+        memmove(dest->ext + offset, src, n);
+    }
 }
+#endif /* WOLFHSM_CFG_ENABLE_CLIENT || WOLFHSM_CFG_COMM_FRAGMENT */
+
+
+#ifdef WOLFHSM_CFG_COMM_FRAGMENT
+/** Fragmentation helpers shared by the client and server
+ *
+ * The logical packet is held just after the reserved space at the start of the
+ * context packet buffer.  Each fragment is sent in place by writing its
+ * fragment header over the 8 bytes ahead of it, which are either the reserved
+ * space or the end of a fragment the peer has already acked.  Fragments are
+ * received in place the same way, saving and restoring the bytes under the
+ * fragment header.
+ *
+ * A logical packet that does not fit in the buffer is streamed instead.  Sent
+ * fragments past the buffered head are gathered from the caller's iovs behind
+ * a fragment header at the start of the buffer.  Received fragments past the
+ * first are taken in just after the logical header and scattered into the
+ * caller's destination.
+ */
 
-uint16_t wh_Translate16(uint16_t magic, uint16_t val)
+typedef int (*whCommSendCb)(void* context, uint16_t size, const void* data);
+typedef int (*whCommRecvCb)(void* context, uint16_t* inout_size, void* data);
+
+static int _wh_Comm_CheckFragmentSize(uint16_t fragment_size)
 {
-    return WH_COMM_FLAGS_SWAPTEST(magic) ? val : wh_Utils_Swap16(val);
+    if (    (fragment_size != 0) &&
+            ((fragment_size < 2 * sizeof(whCommFragHeader)) ||
+             (fragment_size > WH_COMM_MTU) ||
+             ((fragment_size % sizeof(uint64_t)) != 0))) {
+        return WH_ERROR_BADARGS;
+    }
+    return 0;
 }
 
-uint32_t wh_Translate32(uint16_t magic, uint32_t val)
+/* Copy len bytes from offset within the concatenated iov data into dest */
+static void _wh_Comm_GatherIoVec(uint8_t* dest, uint16_t iov_count,
+        const whCommIoVec* iov, uint16_t offset, uint16_t len)
 {
-    return WH_COMM_FLAGS_SWAPTEST(magic) ? val : wh_Utils_Swap32(val);
+    uint16_t i = 0;
+    uint16_t n = 0;
+
+    for (i = 0; (i < iov_count) && (len > 0); i++) {
+        if (offset >= iov[i].size) {
+            offset -= iov[i].size;
+            continue;
+        }
+        n = iov[i].size - offset;
+        if (n > len) {
+            n = len;
+        }
+        memcpy(dest, (const uint8_t*)iov[i].data + offset, n);
+        dest += n;
+        len -= n;
+        offset = 0;
+    }
 }
 
-uint64_t wh_Translate64(uint16_t magic, uint64_t val)
+/* Send the fragment of the logical packet starting at *inout_offset, and
+ * advance *inout_offset past it on success.  The first head bytes of the
+ * logical packet are in buffer and the rest are gathered from iov.
+ */
+static int _wh_Comm_SendFragment(void* transport_context, whCommSendCb send,
+        uint8_t* buffer, uint16_t frag_size, uint16_t magic, uint16_t total,
+        uint16_t head, uint16_t iov_count, const whCommIoVec* iov,
+        uint16_t* inout_offset)
 {
-    return WH_COMM_FLAGS_SWAPTEST(magic) ? val : wh_Utils_Swap64(val);
+    int rc = 0;
+    whCommFragHeader* frag = NULL;
+    uint16_t offset = *inout_offset;
+    uint16_t len = total - offset;
+
+    if (len > frag_size - sizeof(*frag)) {
+        len = frag_size - sizeof(*frag);
+    }
+    if (offset < head) {
+        /* Fragments do not straddle the end of the head */
+        frag = (whCommFragHeader*)(buffer + offset);
+        if (len > head - offset) {
+            len = head - offset;
+        }
+    }
+    else {
+        frag = (whCommFragHeader*)buffer;
+        _wh_Comm_GatherIoVec((uint8_t*)(frag + 1), iov_count, iov,
+                offset - head, len);
+    }
+    frag->magic = magic;
+    frag->flags = wh_Translate16(magic, WH_COMM_FRAG_FLAG_DATA);
+    frag->offset = wh_Translate16(magic, offset);
+    frag->total = wh_Translate16(magic, total);
+    rc = send(transport_context, sizeof(*frag) + len, frag);
+    if (rc == 0) {
+        *inout_offset += len;
+    }
+    return rc;
 }
 
+/* Wait for the peer to ack the fragments sent up to offset.  The ack is
+ * received into the reserved space, which is free once the first fragment has
+ * been sent.
+ */
+static int _wh_Comm_RecvAck(void* transport_context, whCommRecvCb recv,
+        uint8_t* buffer, uint16_t buffer_size, uint16_t offset, uint16_t total)
+{
+    int rc = 0;
+    whCommFragHeader* ack = (whCommFragHeader*)buffer;
+    uint16_t size = buffer_size;
+    uint16_t magic = 0;
+
+    rc = recv(transport_context, &size, ack);
+    if (rc == 0) {
+        magic = ack->magic;
+        if (    (size != sizeof(*ack)) ||
+                (wh_Translate16(magic, ack->flags) != WH_COMM_FRAG_FLAG_ACK) ||
+                (wh_Translate16(magic, ack->offset) != offset) ||
+                (wh_Translate16(magic, ack->total) != total)) {
+            rc = WH_ERROR_ABORTED;
+        }
+    }
+    return rc;
+}
+
+/* Receive the next fragment of a logical packet, acking it if more fragments
+ * are expected.  A logical packet larger than buffer_size - 8 bytes keeps its
+ * header in place and has its data scattered into dest, or dropped if dest is
+ * NULL.  Returns WH_ERROR_NOTREADY until the last fragment arrives, then sets
+ * *out_size to the size of the logical packet.  Returns WH_ERROR_ABORTED once
+ * the last fragment has arrived if the data did not fit.
+ */
+static int _wh_Comm_RecvFragment(void* transport_context, whCommRecvCb recv,
+        whCommSendCb send, uint8_t* buffer, uint16_t buffer_size,
+        const whCommRecvDest* dest, uint16_t* inout_offset,
+        uint16_t* inout_total, uint16_t* out_size)
+{
+    int rc = 0;
+    uint16_t capacity = buffer_size - sizeof(whCommFragHeader);
+    int streamed = (*inout_offset != 0) && (*inout_total > capacity);
+    uint16_t at = streamed ? sizeof(whCommFragHeader) : *inout_offset;
+    whCommFragHeader* frag = (whCommFragHeader*)(buffer + at);
+    whCommFragHeader ack = {0};
+    uint8_t saved[sizeof(whCommFragHeader)];
+    uint16_t size = buffer_size - at;
+    uint16_t magic = 0;
+    uint16_t flags = 0;
+    uint16_t offset = 0;
+    uint16_t total = 0;
+    uint16_t len = 0;
+    uint32_t dest_size = 0;
+
+    memcpy(saved, frag, sizeof(saved));
+    rc = recv(transport_context, &size, frag);
+    if (rc != 0) {
+        memcpy(frag, saved, sizeof(saved));
+        return rc;
+    }
+    if (size < sizeof(*frag)) {
+        *inout_offset = 0;
+        return WH_ERROR_ABORTED;
+    }
+    magic = frag->magic;
+    flags = wh_Translate16(magic, frag->flags);
+    offset = wh_Translate16(magic, frag->offset);
+    total = wh_Translate16(magic, frag->total);
+    memcpy(frag, saved, sizeof(saved));
+    len = size - sizeof(*frag);
+
+    /* Fragments must arrive in order, and a streamed packet must bring its
+     * whole header first */
+    if (    (flags != WH_COMM_FRAG_FLAG_DATA) ||
+            (offset != *inout_offset) ||
+            ((offset != 0) && (total != *inout_total)) ||
+            (len == 0) ||
+            (len > total - offset) ||
+            ((offset == 0) && (total > capacity) &&
+                (len < sizeof(whCommHeader)))) {
+        *inout_offset = 0;
+        return WH_ERROR_ABORTED;
+    }
+    if (total > capacity) {
+        if (offset == 0) {
+            _wh_Comm_ScatterDest(dest, 0,
+                    (uint8_t*)(frag + 1) + sizeof(whCommHeader),
+                    len - sizeof(whCommHeader));
+        }
+        else {
+            _wh_Comm_ScatterDest(dest, offset - sizeof(whCommHeader),
+                    (uint8_t*)(frag + 1), len);
+        }
+    }
+    *inout_offset = offset + len;
+    *inout_total = total;
+
+    if (*inout_offset < total) {
+        /* The peer is waiting for this ack, so the transport can send it */
+        ack.magic = WH_COMM_MAGIC_NATIVE;
+        ack.flags = WH_COMM_FRAG_FLAG_ACK;
+        ack.offset = *inout_offset;
+        ack.total = total;
+        rc = send(transport_context, sizeof(ack), &ack);
+        if (rc != 0) {
+            *inout_offset = 0;
+            return (rc == WH_ERROR_NOTREADY) ? WH_ERROR_ABORTED : rc;
+        }
+        return WH_ERROR_NOTREADY;
+    }
+
+    *inout_offset = 0;
+    *out_size = total;
+    if (total > capacity) {
+        if (dest != NULL) {
+            dest_size = (uint32_t)dest->data_size + dest->ext_size;
+        }
+        if ((uint32_t)(total - sizeof(whCommHeader)) > dest_size) {
+            return WH_ERROR_ABORTED;
+        }
+    }
+    return 0;
+}
+#endif /* WOLFHSM_CFG_COMM_FRAGMENT */
+
 
 /** Client functions */
 #if defined(WOLFHSM_CFG_ENABLE_CLIENT)
@@ -74,13 +310,27 @@ int wh_CommClient_Init(whCommClient* context, const whCommClientConfig* config)
     context->transport_context  = config->transport_context;
     context->client_id          = config->client_id;
     context->connect_cb         = config->connect_cb;
+#ifdef WOLFHSM_CFG_COMM_FRAGMENT
+    rc = _wh_Comm_CheckFragmentSize(config->fragment_size);
+    if (rc != 0) {
+        return rc;
+    }
+    context->frag_size          = config->fragment_size;
+#endif
+#ifdef WOLFHSM_CFG_COMM_SESSIONS
+    if (config->session_id == WH_COMM_AUX_REQ_NORESP) {
+        return WH_ERROR_BADARGS;
+    }
+    context->session_id         = config->session_id;
+#endif
 
     if (context->transport_cb->Init != NULL) {
         rc = context->transport_cb->Init(context->transport_context,
                 config->transport_config, NULL, NULL);
     }
     if (rc == 0) {
-        uintptr_t packet_addr = (uintptr_t)context->packet;
+        uintptr_t packet_addr = (uintptr_t)context->packet +
+                WH_COMM_FRAG_RESERVE_U64_COUNT * sizeof(uint64_t);
         context->hdr = (whCommHeader*)(packet_addr);
         context->data = (void*)(packet_addr + sizeof(*(context->hdr)));
         context->initialized = 1;
@@ -100,60 +350,287 @@ int wh_CommClient_Init(whCommClient* context, const whCommClientConfig* config)
     return rc;
 }
 
+/* Fill in the header at the start of packet and send it.  The sequence number
+ * will be incremented on transport success.
+ */
+static int _wh_CommClient_SendPacket(whCommClient* context, uint16_t magic,
+    uint16_t kind, uint16_t aux, uint16_t *out_seq, uint16_t data_size,
+    uint8_t* packet)
+{
+    int rc = 0;
+    whCommHeader* hdr = (whCommHeader*)packet;
+
+    hdr->magic = magic;
+    hdr->kind = wh_Translate16(magic, kind);
+    hdr->seq = wh_Translate16(magic, context->seq + 1);
+#ifdef WOLFHSM_CFG_COMM_SESSIONS
+    if (aux == WH_COMM_AUX_REQ_NORMAL) {
+        aux = context->session_id;
+    }
+#endif
+    hdr->aux = wh_Translate16(magic, aux);
+#ifdef WOLFHSM_CFG_COMM_FRAGMENT
+    if (context->frag_size != 0) {
+        /* Send the first fragment.  The rest follow as the server acks them
+         * in wh_CommClient_RecvResponse() */
+        uint16_t offset = 0;
+        rc = _wh_Comm_SendFragment(context->transport_context,
+                context->transport_cb->Send, (uint8_t*)context->packet,
+                context->frag_size, magic, sizeof(*hdr) + data_size,
+                context->tx_head, context->tx_iov_count, context->tx_iov,
+                &offset);
+        if (rc == 0) {
+            context->tx_magic = magic;
+            context->tx_total = sizeof(*hdr) + data_size;
+            context->tx_offset = offset;
+            context->tx_acked = 0;
+            context->rx_offset = 0;
+        }
+    }
+    else
+#endif
+    {
+        rc = context->transport_cb->Send(context->transport_context,
+                sizeof(*hdr) + data_size,
+                packet);
+    }
+    if (rc == 0) {
+        context->seq++;
+        context->send_buffer = NULL;
+        if (out_seq != NULL) *out_seq = context->seq;
+        if (    (aux == WH_COMM_AUX_REQ_NORESP) &&
+                (context->transport_cb->Complete != NULL)) {
+            rc = context->transport_cb->Complete(context->transport_context);
+        }
+    }
+#ifdef WOLFHSM_CFG_ENABLE_TIMEOUT
+    /* No response will arrive for a NORESP request */
+    if ((rc == 0) && (aux != WH_COMM_AUX_REQ_NORESP)) {
+        rc = wh_Timeout_Start(&context->respTimeout);
+    }
+#endif
+    return rc;
+}
+
+/* Get the packet buffer for the next request from the transport, or fall back
+ * to the internal packet buffer.
+ */
+static uint8_t* _wh_CommClient_GetSendPacket(whCommClient* context,
+        uint16_t* out_size)
+{
+    void* buffer = NULL;
+    uint16_t size = 0;
+
+#ifdef WOLFHSM_CFG_COMM_FRAGMENT
+    /* Fragments are sent from the internal buffer */
+    if (context->frag_size != 0) {
+        context->send_buffer = NULL;
+        *out_size = WH_COMM_MTU;
+        return (uint8_t*)context->hdr;
+    }
+#endif
+    if (    (context->transport_cb->GetSendBuffer != NULL) &&
+            (context->transport_cb->GetSendBuffer(context->transport_context,
+                    &size, &buffer) == 0) &&
+            (buffer != NULL) &&
+            (size > sizeof(*(context->hdr)))) {
+        context->send_buffer = buffer;
+        *out_size = size;
+        return buffer;
+    }
+    context->send_buffer = NULL;
+    *out_size = WH_COMM_MTU;
+    return (uint8_t*)context->hdr;
+}
+
+static int _wh_CommClient_SendRequest(whCommClient* context, uint16_t magic,
+    uint16_t kind, uint16_t aux, uint16_t *out_seq, uint16_t data_size,
+    const void* data)
+{
+    uint8_t* packet = NULL;
+
+    if ((context == NULL) || (context->hdr == NULL) ||
+        (context->initialized == 0) || (context->transport_cb == NULL) ||
+        (context->transport_cb->Send == NULL)) {
+        return WH_ERROR_BADARGS;
+    }
+
+    /* Only wh_CommClient_SendRequestV() streams larger requests */
+    if (data_size > WOLFHSM_CFG_COMM_DATA_LEN) {
+        return WH_ERROR_BADARGS;
+    }
+#ifdef WOLFHSM_CFG_COMM_SESSIONS
+    /* The aux field cannot carry both the session and NORESP */
+    if ((context->session_id != 0) && (aux == WH_COMM_AUX_REQ_NORESP)) {
+        return WH_ERROR_BADARGS;
+    }
+#endif
+#ifdef WOLFHSM_CFG_COMM_FRAGMENT
+    /* Without a response, nothing would send the remaining fragments */
+    if (    (context->frag_size != 0) &&
+            (aux == WH_COMM_AUX_REQ_NORESP) &&
+            (sizeof(whCommFragHeader) + sizeof(*(context->hdr)) + data_size >
+                context->frag_size)) {
+        return WH_ERROR_BADARGS;
+    }
+#endif
+
+    if (    (context->send_buffer != NULL) &&
+            (data == context->send_buffer + sizeof(*(context->hdr)))) {
+        /* Request was built in place in the transport buffer */
+        packet = context->send_buffer;
+    }
+    else {
+        packet = (uint8_t*)context->hdr;
+        if (    (data != NULL) &&
+                (data_size != 0) &&
+                (data != context->data)) {
+            memcpy(context->data, data, data_size);
+        }
+    }
+#ifdef WOLFHSM_CFG_COMM_FRAGMENT
+    context->tx_head = sizeof(*(context->hdr)) + data_size;
+    context->tx_iov_count = 0;
+#endif
+    return _wh_CommClient_SendPacket(context, magic, kind, aux, out_seq,
+            data_size, packet);
+}
+
 /* If a request buffer is available, send a new request to the server.  The
  * sequence number will be incremented on transport success.
  */
 int wh_CommClient_SendRequest(whCommClient* context, uint16_t magic,
     uint16_t kind, uint16_t *out_seq, uint16_t data_size, const void* data)
 {
-    int rc = 0;
+    return _wh_CommClient_SendRequest(context, magic, kind,
+            WH_COMM_AUX_REQ_NORMAL, out_seq, data_size, data);
+}
+
+int wh_CommClient_SendRequestNoResp(whCommClient* context, uint16_t magic,
+    uint16_t kind, uint16_t *out_seq, uint16_t data_size, const void* data)
+{
+    return _wh_CommClient_SendRequest(context, magic, kind,
+            WH_COMM_AUX_REQ_NORESP, out_seq, data_size, data);
+}
+
+int wh_CommClient_SendRequestV(whCommClient* context, uint16_t magic,
+    uint16_t kind, uint16_t *out_seq, uint16_t iov_count,
+    const whCommIoVec* iov)
+{
+    uint8_t* packet = NULL;
+    uint8_t* dest = NULL;
+    uint16_t packet_size = 0;
+    uint32_t data_size = 0;
+    uint16_t head_size = 0;
+    uint16_t i = 0;
 
     if ((context == NULL) || (context->hdr == NULL) ||
         (context->initialized == 0) || (context->transport_cb == NULL) ||
-        (context->transport_cb->Send == NULL)) {
+        (context->transport_cb->Send == NULL) ||
+        ((iov == NULL) && (iov_count != 0))) {
         return WH_ERROR_BADARGS;
     }
 
+    for (i = 0; i < iov_count; i++) {
+        if ((iov[i].data == NULL) && (iov[i].size != 0)) {
+            return WH_ERROR_BADARGS;
+        }
+        data_size += iov[i].size;
+    }
+
     /* Check if the data size is within allowed limits */
-    if (data_size > WOLFHSM_CFG_COMM_DATA_LEN) {
+    if (data_size > wh_CommClient_GetMaxDataLen(context)) {
         return WH_ERROR_BADARGS;
     }
 
-    context->hdr->magic = magic;
-    context->hdr->kind = wh_Translate16(magic, kind);
-    context->hdr->seq = wh_Translate16(magic, context->seq + 1);
-    if (    (data != NULL) &&
-            (data_size != 0) &&
-            (data != context->data)) {
-        memcpy(context->data, data, data_size);
+    packet = _wh_CommClient_GetSendPacket(context, &packet_size);
+    packet_size -= sizeof(*(context->hdr));
+    if (    (data_size > packet_size)
+#ifdef WOLFHSM_CFG_COMM_FRAGMENT
+            && (context->frag_size == 0)
+#endif
+        ) {
+        return WH_ERROR_BADARGS;
     }
-    rc = context->transport_cb->Send(context->transport_context,
-            sizeof(*(context->hdr)) + data_size,
-            context->packet);
-    if (rc == 0) {
-        context->seq++;
-        if (out_seq != NULL) *out_seq = context->seq;
+
+    /* Copy the leading fragments that fit into the packet */
+    dest = packet + sizeof(*(context->hdr));
+    for (i = 0; i < iov_count; i++) {
+        if (iov[i].size > packet_size - head_size) {
+            break;
+        }
+        if ((iov[i].size != 0) && (iov[i].data != dest)) {
+            memmove(dest, iov[i].data, iov[i].size);
+        }
+        dest += iov[i].size;
+        head_size += iov[i].size;
     }
-#ifdef WOLFHSM_CFG_ENABLE_TIMEOUT
-    if (rc == 0) {
-        rc = wh_Timeout_Start(&context->respTimeout);
+#ifdef WOLFHSM_CFG_COMM_FRAGMENT
+    if (context->frag_size != 0) {
+        /* Stream the rest from the caller's buffers */
+        if (iov_count - i > WH_COMM_FRAG_IOV_MAX) {
+            return WH_ERROR_BADARGS;
+        }
+        context->tx_head = sizeof(*(context->hdr)) + head_size;
+        context->tx_iov_count = iov_count - i;
+        if (context->tx_iov_count != 0) {
+            memcpy(context->tx_iov, &iov[i],
+                    context->tx_iov_count * sizeof(*iov));
+        }
     }
 #endif
-    return rc;
+    return _wh_CommClient_SendPacket(context, magic, kind,
+            WH_COMM_AUX_REQ_NORMAL, out_seq, (uint16_t)data_size, packet);
 }
 
-/* If a response packet has been buffered, get the header and copy the data out
- * of the buffer.
+#ifdef WOLFHSM_CFG_COMM_FRAGMENT
+/* Send the remaining request fragments as the server acks them, then receive
+ * the response.  Returns WH_ERROR_NOTREADY until the whole response is held in
+ * the internal buffer, or has had its data scattered into dest if it is larger.
  */
-int wh_CommClient_RecvResponse(whCommClient* context,
+static int _wh_CommClient_RecvFragmented(whCommClient* context,
+        const whCommRecvDest* dest, uint16_t* out_size)
+{
+    int rc = 0;
+    uint8_t* buffer = (uint8_t*)context->packet;
+
+    if (context->tx_offset < context->tx_total) {
+        if (context->tx_acked < context->tx_offset) {
+            rc = _wh_Comm_RecvAck(context->transport_context,
+                    context->transport_cb->Recv, buffer,
+                    sizeof(whCommFragHeader) + WH_COMM_MTU,
+                    context->tx_offset, context->tx_total);
+            if (rc != 0) {
+                return rc;
+            }
+            context->tx_acked = context->tx_offset;
+        }
+        rc = _wh_Comm_SendFragment(context->transport_context,
+                context->transport_cb->Send, buffer, context->frag_size,
+                context->tx_magic, context->tx_total, context->tx_head,
+                context->tx_iov_count, context->tx_iov, &context->tx_offset);
+        return (rc == 0) ? WH_ERROR_NOTREADY : rc;
+    }
+
+    return _wh_Comm_RecvFragment(context->transport_context,
+            context->transport_cb->Recv, context->transport_cb->Send, buffer,
+            sizeof(whCommFragHeader) + WH_COMM_MTU, dest, &context->rx_offset,
+            &context->rx_total, out_size);
+}
+#endif /* WOLFHSM_CFG_COMM_FRAGMENT */
+
+/* Receive a response and copy its data out of the internal buffer, into data
+ * or, if dest is not NULL, into the buffers of dest.
+ */
+static int _wh_CommClient_RecvResponse(whCommClient* context,
         uint16_t* out_magic, uint16_t* out_kind, uint16_t* out_seq,
-        uint16_t* out_size, void* data)
+        uint16_t* out_size, void* data, const whCommRecvDest* dest)
 {
     int rc = 0;
     uint16_t magic = 0;
     uint16_t kind = 0;
     uint16_t seq = 0;
-    uint16_t size = sizeof(context->packet);
+    uint16_t size = WH_COMM_MTU;
     uint16_t data_size = 0;
 
     if ((context == NULL) || (context->hdr == NULL) ||
@@ -162,9 +639,17 @@ int wh_CommClient_RecvResponse(whCommClient* context,
         return WH_ERROR_BADARGS;
     }
 
-    rc = context->transport_cb->Recv(context->transport_context,
-            &size,
-            context->packet);
+#ifdef WOLFHSM_CFG_COMM_FRAGMENT
+    if (context->frag_size != 0) {
+        rc = _wh_CommClient_RecvFragmented(context, dest, &size);
+    }
+    else
+#endif
+    {
+        rc = context->transport_cb->Recv(context->transport_context,
+                &size,
+                context->hdr);
+    }
     if (rc == 0) {
 #ifdef WOLFHSM_CFG_ENABLE_TIMEOUT
         (void)wh_Timeout_Stop(&context->respTimeout);
@@ -173,20 +658,45 @@ int wh_CommClient_RecvResponse(whCommClient* context,
             /* Size is too small */
             rc = WH_ERROR_ABORTED;
         }
+#ifdef WOLFHSM_CFG_COMM_NATIVE_ONLY
+        else if (!WH_COMM_FLAGS_SWAPTEST(context->hdr->magic)) {
+            /* Peer has a different endianness */
+            rc = WH_ERROR_ABORTED;
+        }
+#endif /* WOLFHSM_CFG_COMM_NATIVE_ONLY */
+        else if (   (dest != NULL) &&
+                    ((uint32_t)(size - sizeof(*context->hdr)) >
+                        (uint32_t)dest->data_size + dest->ext_size)) {
+            /* Response does not fit in the caller's buffers */
+            rc = WH_ERROR_ABORTED;
+        }
         if (rc == 0) {
             data_size = size - sizeof(*context->hdr);
             magic = context->hdr->magic;
             kind = wh_Translate16(magic, context->hdr->kind);
             seq = wh_Translate16(magic, context->hdr->seq);
-            if (    (data != NULL) &&
-                    (data_size != 0) &&
-                    (data != context->data)) {
+            if (data_size > WOLFHSM_CFG_COMM_DATA_LEN) {
+                /* Streamed into dest as it arrived */
+            }
+            else if (dest != NULL) {
+                _wh_Comm_ScatterDest(dest, 0, context->data, data_size);
+            }
+            else if (   (data != NULL) &&
+                        (data_size != 0) &&
+                        (data != context->data)) {
                 memcpy(data, context->data, data_size);
             }
             if (out_magic != NULL) *out_magic = magic;
             if (out_kind != NULL) *out_kind = kind;
             if (out_seq != NULL) *out_seq = seq;
             if (out_size != NULL) *out_size = data_size;
+#ifdef WOLFHSM_CFG_COMM_SESSIONS
+            if (wh_Translate16(magic, context->hdr->aux) ==
+                    WH_COMM_AUX_RESP_ERROR) {
+                /* Server did not have the session open */
+                rc = WH_ERROR_NOSESSION;
+            }
+#endif
         }
     }
 #ifdef WOLFHSM_CFG_ENABLE_TIMEOUT
@@ -203,6 +713,64 @@ int wh_CommClient_RecvResponse(whCommClient* context,
     return rc;
 }
 
+/* If a response packet has been buffered, get the header and copy the data out
+ * of the buffer.
+ */
+int wh_CommClient_RecvResponse(whCommClient* context,
+        uint16_t* out_magic, uint16_t* out_kind, uint16_t* out_seq,
+        uint16_t* out_size, void* data)
+{
+    return _wh_CommClient_RecvResponse(context, out_magic, out_kind, out_seq,
+            out_size, data, NULL);
+}
+
+int wh_CommClient_RecvResponseExt(whCommClient* context,
+        uint16_t* out_magic, uint16_t* out_kind, uint16_t* out_seq,
+        uint16_t* out_size, uint16_t data_size, void* data,
+        uint16_t ext_size, void* ext)
+{
+    whCommRecvDest dest = {0};
+
+    if (    ((data == NULL) && (data_size != 0)) ||
+            ((ext == NULL) && (ext_size != 0))) {
+        return WH_ERROR_BADARGS;
+    }
+    dest.data = data;
+    dest.data_size = data_size;
+    dest.ext = ext;
+    dest.ext_size = ext_size;
+    return _wh_CommClient_RecvResponse(context, out_magic, out_kind, out_seq,
+            out_size, NULL, &dest);
+}
+
+int wh_CommClient_WaitResponse(whCommClient* context, uint64_t timeout_us)
+{
+    if ((context == NULL) || (context->initialized == 0) ||
+        (context->transport_cb == NULL)) {
+        return WH_ERROR_BADARGS;
+    }
+
+    if (context->transport_cb->Wait == NULL) {
+        return WH_ERROR_NOTIMPL;
+    }
+
+    return context->transport_cb->Wait(context->transport_context, timeout_us);
+}
+
+int wh_CommClient_Cancel(whCommClient* context)
+{
+    if ((context == NULL) || (context->initialized == 0) ||
+        (context->transport_cb == NULL)) {
+        return WH_ERROR_BADARGS;
+    }
+
+    if (context->transport_cb->Cancel == NULL) {
+        return WH_ERROR_NOTIMPL;
+    }
+
+    return context->transport_cb->Cancel(context->transport_context);
+}
+
 uint8_t* wh_CommClient_GetDataPtr(whCommClient* context)
 {
     if (context == NULL) {
@@ -211,6 +779,64 @@ uint8_t* wh_CommClient_GetDataPtr(whCommClient* context)
     return context->data;
 }
 
+uint16_t wh_CommClient_GetMaxDataLen(const whCommClient* context)
+{
+    if (context == NULL) {
+        return 0;
+    }
+#ifdef WOLFHSM_CFG_COMM_FRAGMENT
+    if (context->frag_size != 0) {
+        return WOLFHSM_CFG_COMM_FRAGMENT_DATA_LEN;
+    }
+#endif
+    return WOLFHSM_CFG_COMM_DATA_LEN;
+}
+
+int wh_CommClient_GetSendDataPtr(whCommClient* context, uint16_t* out_size,
+    uint8_t** out_data)
+{
+    uint8_t* packet = NULL;
+    uint16_t packet_size = 0;
+
+    if ((context == NULL) || (context->initialized == 0) ||
+        (context->transport_cb == NULL) || (out_data == NULL)) {
+        return WH_ERROR_BADARGS;
+    }
+
+    packet = _wh_CommClient_GetSendPacket(context, &packet_size);
+    packet_size -= sizeof(*(context->hdr));
+    if (packet_size > wh_CommClient_GetMaxDataLen(context)) {
+        packet_size = wh_CommClient_GetMaxDataLen(context);
+    }
+    *out_data = packet + sizeof(*(context->hdr));
+    if (out_size != NULL) {
+        *out_size = packet_size;
+    }
+    return 0;
+}
+
+int wh_CommClient_CheckPipeline(const whCommClient* context,
+        uint16_t data_size)
+{
+    if (context == NULL) {
+        return WH_ERROR_BADARGS;
+    }
+#ifdef WOLFHSM_CFG_COMM_FRAGMENT
+    /* Fragments are acked one at a time, so a multi-fragment exchange needs
+     * the channel to itself */
+    if (    (context->frag_size != 0) &&
+            ((context->tx_offset < context->tx_total) ||
+             (context->rx_offset != 0) ||
+             (sizeof(whCommFragHeader) + sizeof(whCommHeader) + data_size >
+                context->frag_size))) {
+        return WH_ERROR_NOTREADY;
+    }
+#else
+    (void)data_size;
+#endif
+    return 0;
+}
+
 /* Inform the server that no further communications are necessary and any
  * unfinished requests can be ignored.
  */
@@ -222,6 +848,16 @@ int wh_CommClient_Cleanup(whCommClient* context)
         return WH_ERROR_BADARGS;
     }
 
+    if (    (context->transport_cb != NULL) &&
+            (context->transport_cb->Cleanup != NULL)) {
+        rc = context->transport_cb->Cleanup(context->transport_context);
+        if (rc == WH_ERROR_NOTREADY) {
+            /* Transport must deliver a response first, such as a session
+             * sharing its connection */
+            return rc;
+        }
+    }
+
     /* Signal a non-blocking disconnect to the server if registered */
     if (context->connect_cb != NULL) {
         (void)context->connect_cb(context, WH_COMM_DISCONNECTED);
@@ -231,11 +867,6 @@ int wh_CommClient_Cleanup(whCommClient* context)
     (void)wh_Timeout_Cleanup(&context->respTimeout);
 #endif
 
-    if (    (context->transport_cb != NULL) &&
-            (context->transport_cb->Cleanup != NULL)) {
-        rc = context->transport_cb->Cleanup(context->transport_context);
-    }
-
     /* Mark as not initialized regardless of cleanup return */
     context->initialized = 0;
     return rc;
@@ -259,13 +890,50 @@ int wh_CommServer_Init(whCommServer* context, const whCommServerConfig* config,
     context->transport_context  = config->transport_context;
     context->transport_cb       = config->transport_cb;
     context->server_id          = config->server_id;
+#ifdef WOLFHSM_CFG_COMM_FRAGMENT
+    rc = _wh_Comm_CheckFragmentSize(config->fragment_size);
+    if (rc != 0) {
+        return rc;
+    }
+    context->frag_size          = config->fragment_size;
+    context->buffer             = (uint8_t*)context->packet;
+    context->buffer_size        = sizeof(whCommFragHeader) + WH_COMM_MTU;
+    if (config->frag_buffer != NULL) {
+        /* Large requests are reassembled in place in the caller's buffer */
+        if (    (config->fragment_size == 0) ||
+                (((uintptr_t)config->frag_buffer % sizeof(uint64_t)) != 0) ||
+                (config->frag_buffer_size <
+                    sizeof(whCommFragHeader) + WH_COMM_MTU)) {
+            return WH_ERROR_BADARGS;
+        }
+        context->buffer         = config->frag_buffer;
+        context->buffer_size    = config->frag_buffer_size;
+    }
+#endif
 
     if (context->transport_cb->Init != NULL) {
         rc = context->transport_cb->Init(context->transport_context,
                 config->transport_config, connectcb, connectcb_arg);
     }
     if (rc == 0) {
-        uintptr_t packet_addr = (uintptr_t)context->packet;
+        uintptr_t packet_addr = (uintptr_t)context->packet +
+                WH_COMM_FRAG_RESERVE_U64_COUNT * sizeof(uint64_t);
+        void* buffer = NULL;
+        uint16_t buffer_size = 0;
+
+#ifdef WOLFHSM_CFG_COMM_FRAGMENT
+        packet_addr = (uintptr_t)context->buffer + sizeof(whCommFragHeader);
+#endif
+        if (    (context->transport_cb->GetBuffer != NULL) &&
+#ifdef WOLFHSM_CFG_COMM_FRAGMENT
+                (context->frag_size == 0) &&
+#endif
+                (context->transport_cb->GetBuffer(context->transport_context,
+                        &buffer_size, &buffer) == 0) &&
+                (buffer_size >= WH_COMM_MTU)) {
+            /* Receive and respond in place in the transport buffer */
+            packet_addr = (uintptr_t)buffer;
+        }
         context->hdr = (whCommHeader*)packet_addr;
         context->data = (void*)(packet_addr + sizeof(*(context->hdr)));
         context->initialized = 1;
@@ -273,6 +941,49 @@ int wh_CommServer_Init(whCommServer* context, const whCommServerConfig* config,
     return rc;
 }
 
+#ifdef WOLFHSM_CFG_COMM_FRAGMENT
+/* Send the remaining response fragments as the client acks them, then
+ * reassemble the next request.  Returns WH_ERROR_NOTREADY until the whole
+ * request is held in the internal buffer.
+ */
+static int _wh_CommServer_RecvFragmented(whCommServer* context,
+        uint16_t* out_size)
+{
+    int rc = 0;
+    uint8_t* buffer = context->buffer;
+
+    if (context->tx_offset < context->tx_total) {
+        if (context->tx_acked < context->tx_offset) {
+            rc = _wh_Comm_RecvAck(context->transport_context,
+                    context->transport_cb->Recv, buffer,
+                    context->buffer_size, context->tx_offset,
+                    context->tx_total);
+            if (rc == WH_ERROR_ABORTED) {
+                /* Such as a pipelined request in place of the ack.  Drop
+                 * the response so later requests are still received */
+                context->tx_offset = 0;
+                context->tx_total = 0;
+            }
+            if (rc != 0) {
+                return rc;
+            }
+            context->tx_acked = context->tx_offset;
+        }
+        rc = _wh_Comm_SendFragment(context->transport_context,
+                context->transport_cb->Send, buffer, context->frag_size,
+                context->hdr->magic, context->tx_total, context->tx_total,
+                0, NULL, &context->tx_offset);
+        return (rc == 0) ? WH_ERROR_NOTREADY : rc;
+    }
+
+    /* Requests too large for the buffer are received and dropped */
+    return _wh_Comm_RecvFragment(context->transport_context,
+            context->transport_cb->Recv, context->transport_cb->Send, buffer,
+            context->buffer_size, NULL, &context->rx_offset,
+            &context->rx_total, out_size);
+}
+#endif /* WOLFHSM_CFG_COMM_FRAGMENT */
+
 int wh_CommServer_RecvRequest(whCommServer* context,
         uint16_t* out_magic, uint16_t* out_kind, uint16_t* out_seq,
         uint16_t* out_size, void* data)
@@ -281,7 +992,7 @@ int wh_CommServer_RecvRequest(whCommServer* context,
     uint16_t magic = 0;
     uint16_t kind = 0;
     uint16_t seq = 0;
-    uint16_t size = sizeof(context->packet);
+    uint16_t size = WH_COMM_MTU;
     uint16_t data_size = 0;
 
     if ((context == NULL) || (context->hdr == NULL) ||
@@ -290,18 +1001,40 @@ int wh_CommServer_RecvRequest(whCommServer* context,
         return WH_ERROR_BADARGS;
     }
 
-    rc = context->transport_cb->Recv(context->transport_context,
-            &size,
-            context->packet);
+#ifdef WOLFHSM_CFG_COMM_FRAGMENT
+    if (context->frag_size != 0) {
+        rc = _wh_CommServer_RecvFragmented(context, &size);
+    }
+    else
+#endif
+    {
+        rc = context->transport_cb->Recv(context->transport_context,
+                &size,
+                context->hdr);
+    }
     if (rc == 0) {
         if (size < sizeof(*context->hdr)) {
             rc = WH_ERROR_ABORTED;
         }
+#ifdef WOLFHSM_CFG_COMM_NATIVE_ONLY
+        else if (!WH_COMM_FLAGS_SWAPTEST(context->hdr->magic)) {
+            /* Peer has a different endianness */
+            rc = WH_ERROR_ABORTED;
+        }
+#endif /* WOLFHSM_CFG_COMM_NATIVE_ONLY */
+        else if (   (size - sizeof(*context->hdr) >
+                        WOLFHSM_CFG_COMM_DATA_LEN) &&
+                    (data != NULL) &&
+                    (data != context->data)) {
+            /* Larger requests are only received in place */
+            rc = WH_ERROR_ABORTED;
+        }
         if (rc == 0) {
             data_size = size - sizeof(*context->hdr);
             magic = context->hdr->magic;
             kind = wh_Translate16(magic, context->hdr->kind);
             seq = wh_Translate16(magic, context->hdr->seq);
+            context->aux = wh_Translate16(magic, context->hdr->aux);
 
             /* Copy the data from the internal buffer if necessary */
             if (    (data != NULL) &&
@@ -318,8 +1051,73 @@ int wh_CommServer_RecvRequest(whCommServer* context,
     return rc;
 }
 
-int wh_CommServer_SendResponse(whCommServer* context,
-        uint16_t magic, uint16_t kind, uint16_t seq,
+int wh_CommServer_GetRequestAux(whCommServer* context, uint16_t* out_aux)
+{
+    if ((context == NULL) || (out_aux == NULL)) {
+        return WH_ERROR_BADARGS;
+    }
+    *out_aux = context->aux;
+    return 0;
+}
+
+int wh_CommServer_CompleteRequest(whCommServer* context)
+{
+    if ((context == NULL) || (context->initialized == 0) ||
+        (context->transport_cb == NULL)) {
+        return WH_ERROR_BADARGS;
+    }
+
+    if (context->transport_cb->Complete == NULL) {
+        /* Nothing to release */
+        return 0;
+    }
+    return context->transport_cb->Complete(context->transport_context);
+}
+
+int wh_CommServer_WaitRequest(whCommServer* context, uint64_t timeout_us)
+{
+    if ((context == NULL) || (context->initialized == 0) ||
+        (context->transport_cb == NULL)) {
+        return WH_ERROR_BADARGS;
+    }
+
+    if (context->transport_cb->Wait == NULL) {
+        return WH_ERROR_NOTIMPL;
+    }
+
+    return context->transport_cb->Wait(context->transport_context, timeout_us);
+}
+
+int wh_CommServer_PollRequest(whCommServer* context)
+{
+    if ((context == NULL) || (context->initialized == 0) ||
+        (context->transport_cb == NULL)) {
+        return WH_ERROR_BADARGS;
+    }
+
+    if (context->transport_cb->Pending == NULL) {
+        return WH_ERROR_NOTIMPL;
+    }
+
+    return context->transport_cb->Pending(context->transport_context);
+}
+
+int wh_CommServer_CheckCanceled(whCommServer* context)
+{
+    if ((context == NULL) || (context->initialized == 0) ||
+        (context->transport_cb == NULL)) {
+        return WH_ERROR_BADARGS;
+    }
+
+    if (context->transport_cb->Canceled == NULL) {
+        return WH_ERROR_OK;
+    }
+
+    return context->transport_cb->Canceled(context->transport_context);
+}
+
+static int _wh_CommServer_SendResponse(whCommServer* context,
+        uint16_t magic, uint16_t kind, uint16_t seq, uint16_t aux,
         uint16_t data_size, const void* data)
 {
     int rc = 0;
@@ -331,13 +1129,14 @@ int wh_CommServer_SendResponse(whCommServer* context,
     }
 
     /* Check if the data size is within allowed limits */
-    if (data_size > WOLFHSM_CFG_COMM_DATA_LEN) {
+    if (data_size > wh_CommServer_GetMaxDataLen(context)) {
         return WH_ERROR_BADARGS;
     }
 
     context->hdr->magic = magic;
     context->hdr->kind = wh_Translate16(magic, kind);
     context->hdr->seq = wh_Translate16(magic, seq);
+    context->hdr->aux = wh_Translate16(magic, aux);
 
     /* Copy the data into the internal buffer if necessary */
     if (    (data != NULL) &&
@@ -345,12 +1144,45 @@ int wh_CommServer_SendResponse(whCommServer* context,
             (data != context->data) ) {
         memcpy(context->data, data, data_size);
     }
+#ifdef WOLFHSM_CFG_COMM_FRAGMENT
+    if (context->frag_size != 0) {
+        /* Send the first fragment.  The rest follow as the client acks them
+         * in wh_CommServer_RecvRequest() */
+        uint16_t offset = 0;
+        rc = _wh_Comm_SendFragment(context->transport_context,
+                context->transport_cb->Send, context->buffer,
+                context->frag_size, magic,
+                sizeof(*(context->hdr)) + data_size,
+                sizeof(*(context->hdr)) + data_size, 0, NULL, &offset);
+        if (rc == 0) {
+            context->tx_total = sizeof(*(context->hdr)) + data_size;
+            context->tx_offset = offset;
+            context->tx_acked = 0;
+        }
+        return rc;
+    }
+#endif
     rc = context->transport_cb->Send(context->transport_context,
             sizeof(*(context->hdr)) + data_size,
-            context->packet);
+            context->hdr);
     return rc;
 }
 
+int wh_CommServer_SendResponse(whCommServer* context,
+        uint16_t magic, uint16_t kind, uint16_t seq,
+        uint16_t data_size, const void* data)
+{
+    return _wh_CommServer_SendResponse(context, magic, kind, seq,
+            WH_COMM_AUX_RESP_OK, data_size, data);
+}
+
+int wh_CommServer_SendErrorResponse(whCommServer* context,
+        uint16_t magic, uint16_t kind, uint16_t seq)
+{
+    return _wh_CommServer_SendResponse(context, magic, kind, seq,
+            WH_COMM_AUX_RESP_ERROR, 0, NULL);
+}
+
 uint8_t* wh_CommServer_GetDataPtr(whCommServer* context)
 {
     if (context == NULL) {
@@ -359,6 +1191,26 @@ uint8_t* wh_CommServer_GetDataPtr(whCommServer* context)
     return context->data;
 }
 
+uint16_t wh_CommServer_GetMaxDataLen(const whCommServer* context)
+{
+    uint16_t len = WOLFHSM_CFG_COMM_DATA_LEN;
+
+    if (context == NULL) {
+        return 0;
+    }
+#ifdef WOLFHSM_CFG_COMM_FRAGMENT
+    if (context->frag_size != 0) {
+        /* Limited by the buffer requests are reassembled into */
+        len = context->buffer_size - sizeof(whCommFragHeader) -
+                sizeof(whCommHeader);
+        if (len > WOLFHSM_CFG_COMM_FRAGMENT_DATA_LEN) {
+            len = WOLFHSM_CFG_COMM_FRAGMENT_DATA_LEN;
+        }
+    }
+#endif
+    return len;
+}
+
 int wh_CommServer_Cleanup(whCommServer* context)
 {
     int rc = 0;
@@ -0,0 +1,136 @@
+/*
+ * Copyright (C) 2025 wolfSSL Inc.
+ *
+ * This file is part of wolfHSM.
+ *
+ * wolfHSM is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * wolfHSM is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with wolfHSM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/*
+ * src/wh_message_batch.c
+ *
+ * Message translation and layout functions for batched requests.
+ */
+
+#include "wolfhsm/wh_message_batch.h"
+#include "wolfhsm/wh_error.h"
+#include "wolfhsm/wh_comm.h"
+#include <string.h>
+
+/* Batch Request translation */
+int wh_MessageBatch_TranslateRequest(uint16_t magic,
+                                     const whMessageBatch_Request* src,
+                                     whMessageBatch_Request*       dest)
+{
+    if ((src == NULL) || (dest == NULL)) {
+        return WH_ERROR_BADARGS;
+    }
+    WH_T16(magic, dest, src, count);
+    return 0;
+}
+
+/* Batch Request item translation */
+int wh_MessageBatch_TranslateRequestItem(uint16_t magic,
+                                         const whMessageBatch_RequestItem* src,
+                                         whMessageBatch_RequestItem* dest)
+{
+    if ((src == NULL) || (dest == NULL)) {
+        return WH_ERROR_BADARGS;
+    }
+    WH_T16(magic, dest, src, kind);
+    WH_T16(magic, dest, src, size);
+    WH_T16(magic, dest, src, resp_max);
+    return 0;
+}
+
+/* Batch Response translation */
+int wh_MessageBatch_TranslateResponse(uint16_t magic,
+                                      const whMessageBatch_Response* src,
+                                      whMessageBatch_Response*       dest)
+{
+    if ((src == NULL) || (dest == NULL)) {
+        return WH_ERROR_BADARGS;
+    }
+    WH_T32(magic, dest, src, rc);
+    WH_T16(magic, dest, src, count);
+    return 0;
+}
+
+/* Batch Response item translation */
+int wh_MessageBatch_TranslateResponseItem(
+    uint16_t magic, const whMessageBatch_ResponseItem* src,
+    whMessageBatch_ResponseItem* dest)
+{
+    if ((src == NULL) || (dest == NULL)) {
+        return WH_ERROR_BADARGS;
+    }
+    WH_T32(magic, dest, src, rc);
+    WH_T16(magic, dest, src, kind);
+    WH_T16(magic, dest, src, size);
+    return 0;
+}
+
+int wh_MessageBatch_LayoutInit(whMessageBatch_Layout* layout)
+{
+    if (layout == NULL) {
+        return WH_ERROR_BADARGS;
+    }
+    memset(layout, 0, sizeof(*layout));
+    return 0;
+}
+
+int wh_MessageBatch_LayoutAdd(whMessageBatch_Layout* layout, uint16_t size,
+                              uint16_t resp_max)
+{
+    uint32_t req_len  = 0;
+    uint32_t resp_len = 0;
+    uint32_t slot_len = 0;
+    uint32_t required = 0;
+
+    if (layout == NULL) {
+        return WH_ERROR_BADARGS;
+    }
+
+    req_len  = sizeof(whMessageBatch_RequestItem) +
+               WH_MESSAGE_BATCH_ALIGN((uint32_t)size);
+    resp_len = sizeof(whMessageBatch_ResponseItem) +
+               WH_MESSAGE_BATCH_ALIGN((uint32_t)resp_max);
+
+    /* The request is moved into its response slot to be executed in place,
+     * so the slot must hold whichever is larger */
+    slot_len = sizeof(whMessageBatch_ResponseItem) +
+               WH_MESSAGE_BATCH_ALIGN((uint32_t)((size > resp_max) ? size
+                                                                   : resp_max));
+
+    /* While an earlier item is processed, this request is still unread. While
+     * this item is processed, every earlier response is packed and this
+     * item occupies its slot. */
+    required = layout->required + req_len;
+    if (required < layout->resp_total + slot_len) {
+        required = layout->resp_total + slot_len;
+    }
+
+    if ((layout->count == UINT16_MAX) ||
+        (sizeof(whMessageBatch_Request) + layout->req_total + req_len >
+         WOLFHSM_CFG_COMM_DATA_LEN) ||
+        (sizeof(whMessageBatch_Response) + required >
+         (WOLFHSM_CFG_COMM_DATA_LEN & ~7u))) {
+        return WH_ERROR_BUFFER_SIZE;
+    }
+
+    layout->req_total += req_len;
+    layout->resp_total += resp_len;
+    layout->required = required;
+    layout->count++;
+    return 0;
+}
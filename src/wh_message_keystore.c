@@ -187,6 +187,31 @@ int wh_MessageKeystore_TranslateRevokeResponse(
     return 0;
 }
 
+/* Key Pin Request translation */
+int wh_MessageKeystore_TranslatePinRequest(
+    uint16_t magic, const whMessageKeystore_PinRequest* src,
+    whMessageKeystore_PinRequest* dest)
+{
+    if ((src == NULL) || (dest == NULL)) {
+        return WH_ERROR_BADARGS;
+    }
+    WH_T16(magic, dest, src, id);
+    WH_T16(magic, dest, src, pin);
+    return 0;
+}
+
+/* Key Pin Response translation */
+int wh_MessageKeystore_TranslatePinResponse(
+    uint16_t magic, const whMessageKeystore_PinResponse* src,
+    whMessageKeystore_PinResponse* dest)
+{
+    if ((src == NULL) || (dest == NULL)) {
+        return WH_ERROR_BADARGS;
+    }
+    WH_T32(magic, dest, src, rc);
+    return 0;
+}
+
 #ifdef WOLFHSM_CFG_DMA
 /*
  * DMA-based keystore operations
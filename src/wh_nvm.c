@@ -88,6 +88,71 @@ static int wh_Nvm_CheckPolicy(whNvmContext* context, whNvmOp op, whNvmId id,
 }
 
 
+#ifndef WOLFHSM_CFG_NO_CRYPTO
+/* Mark a crypto key ID as used or unused in the key ID map */
+static void _KeyIdMapSet(whNvmContext* context, whNvmId id, int used)
+{
+    uint32_t* word;
+    uint32_t  bit;
+
+    if (WH_KEYID_TYPE(id) != WH_KEYTYPE_CRYPTO) {
+        return;
+    }
+    word = &context->keyIdMap[WH_KEYID_USER(id)][WH_KEYID_ID(id) / 32];
+    bit  = (uint32_t)1 << (WH_KEYID_ID(id) % 32);
+    if (used != 0) {
+        *word |= bit;
+    }
+    else {
+        *word &= ~bit;
+    }
+}
+
+/* Set a crypto key ID in the key ID map if the backend still holds an object
+ * with that ID, as after a failed add.  The ID is marked if the backend cannot
+ * tell, so the map never misses a stored object */
+static void _KeyIdMapUpdate(whNvmContext* context, whNvmId id)
+{
+    whNvmMetadata meta;
+
+    if ((context->cb->GetMetadata == NULL) ||
+        (context->cb->GetMetadata(context->context, id, &meta) !=
+         WH_ERROR_NOTFOUND)) {
+        _KeyIdMapSet(context, id, 1);
+    }
+}
+
+/* Build the key ID map from the objects in NVM.  The map is left invalid if
+ * the backend cannot list its objects */
+static void _KeyIdMapBuild(whNvmContext* context)
+{
+    whNvmId id = WH_NVM_ID_INVALID;
+    whNvmId count;
+    whNvmId next;
+    int     rc;
+
+    memset(context->keyIdMap, 0, sizeof(context->keyIdMap));
+    context->keyIdMapValid = 0;
+    if (context->cb->List == NULL) {
+        return;
+    }
+
+    while (1) {
+        rc = context->cb->List(context->context, WH_NVM_ACCESS_ANY,
+                               WH_NVM_FLAGS_ANY, id, &count, &next);
+        if (rc != WH_ERROR_OK) {
+            return;
+        }
+        if ((count == 0) || (next == WH_NVM_ID_INVALID) || (next == id)) {
+            break;
+        }
+        _KeyIdMapSet(context, next, 1);
+        id = next;
+    }
+    context->keyIdMapValid = 1;
+}
+#endif /* !WOLFHSM_CFG_NO_CRYPTO */
+
 int wh_Nvm_Init(whNvmContext* context, const whNvmConfig* config)
 {
     int rc = 0;
@@ -123,6 +188,12 @@ int wh_Nvm_Init(whNvmContext* context, const whNvmConfig* config)
         }
     }
 
+#ifndef WOLFHSM_CFG_NO_CRYPTO
+    if (context->cb != NULL) {
+        _KeyIdMapBuild(context);
+    }
+#endif
+
     return rc;
 }
 
@@ -140,6 +211,11 @@ int wh_Nvm_Cleanup(whNvmContext* context)
     memset(&context->globalCache, 0, sizeof(context->globalCache));
 #endif
 
+#ifndef WOLFHSM_CFG_NO_CRYPTO
+    memset(context->keyIdMap, 0, sizeof(context->keyIdMap));
+    context->keyIdMapValid = 0;
+#endif
+
     /* No callback? Return ABORTED */
     if (context->cb->Cleanup == NULL) {
         rc = WH_ERROR_ABORTED;
@@ -217,6 +293,8 @@ int wh_Nvm_AddObjectWithReclaim(whNvmContext* context, whNvmMetadata *meta,
 int wh_Nvm_AddObject(whNvmContext* context, whNvmMetadata *meta,
         whNvmSize data_len, const uint8_t* data)
 {
+    int rc;
+
     if (    (context == NULL) ||
             (context->cb == NULL) ) {
         return WH_ERROR_BADARGS;
@@ -226,7 +304,18 @@ int wh_Nvm_AddObject(whNvmContext* context, whNvmMetadata *meta,
     if (context->cb->AddObject == NULL) {
         return WH_ERROR_ABORTED;
     }
-    return context->cb->AddObject(context->context, meta, data_len, data);
+    rc = context->cb->AddObject(context->context, meta, data_len, data);
+#ifndef WOLFHSM_CFG_NO_CRYPTO
+    if (meta != NULL) {
+        if (rc == WH_ERROR_OK) {
+            _KeyIdMapSet(context, meta->id, 1);
+        }
+        else {
+            _KeyIdMapUpdate(context, meta->id);
+        }
+    }
+#endif
+    return rc;
 }
 
 int wh_Nvm_AddObjectChecked(whNvmContext* context, whNvmMetadata* meta,
@@ -278,6 +367,11 @@ int wh_Nvm_GetMetadata(whNvmContext* context, whNvmId id,
 int wh_Nvm_DestroyObjects(whNvmContext* context, whNvmId list_count,
         const whNvmId* id_list)
 {
+    int     rc;
+#ifndef WOLFHSM_CFG_NO_CRYPTO
+    whNvmId i;
+#endif
+
     if (    (context == NULL) ||
             (context->cb == NULL) ) {
         return WH_ERROR_BADARGS;
@@ -287,7 +381,16 @@ int wh_Nvm_DestroyObjects(whNvmContext* context, whNvmId list_count,
     if (context->cb->DestroyObjects == NULL) {
         return WH_ERROR_ABORTED;
     }
-    return context->cb->DestroyObjects(context->context, list_count, id_list);
+    rc = context->cb->DestroyObjects(context->context, list_count, id_list);
+#ifndef WOLFHSM_CFG_NO_CRYPTO
+    /* On failure, some objects may remain, so keep them all marked */
+    if ((rc == WH_ERROR_OK) && (id_list != NULL)) {
+        for (i = 0; i < list_count; i++) {
+            _KeyIdMapSet(context, id_list[i], 0);
+        }
+    }
+#endif
+    return rc;
 }
 
 int wh_Nvm_DestroyObjectsChecked(whNvmContext* context, whNvmId list_count,
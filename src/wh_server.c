@@ -42,6 +42,9 @@
 #include "wolfhsm/wh_message.h"
 #include "wolfhsm/wh_message_comm.h"
 #include "wolfhsm/wh_message_nvm.h"
+#ifdef WOLFHSM_CFG_BATCH
+#include "wolfhsm/wh_message_batch.h"
+#endif /* WOLFHSM_CFG_BATCH */
 
 /* Server API's */
 #include "wolfhsm/wh_server.h"
@@ -64,6 +67,12 @@ static int _wh_Server_HandlePkcs11Request(whServerContext* server,
         uint16_t magic, uint16_t action, uint16_t seq,
         uint16_t req_size, const void* req_packet,
         uint16_t *out_resp_size, void* resp_packet);
+#ifdef WOLFHSM_CFG_BATCH
+static int _wh_Server_HandleBatchRequest(whServerContext* server,
+        uint16_t magic, uint16_t action, uint16_t seq,
+        uint16_t req_size, const void* req_packet,
+        uint16_t *out_resp_size, void* resp_packet);
+#endif /* WOLFHSM_CFG_BATCH */
 
 int wh_Server_Init(whServerContext* server, whServerConfig* config)
 {
@@ -101,6 +110,26 @@ int wh_Server_Init(whServerContext* server, whServerConfig* config)
         return WH_ERROR_ABORTED;
     }
 
+#ifdef WOLFHSM_CFG_SERVER_LANES
+    {
+        int i;
+        for (i = 0; i < WOLFHSM_CFG_SERVER_LANE_COUNT - 1; i++) {
+            if (config->lane_config[i] == NULL) {
+                continue;
+            }
+            /* The primary channel governs the connection state */
+            rc = wh_CommServer_Init(&server->lane[i], config->lane_config[i],
+                    NULL, NULL);
+            if (rc != 0) {
+                (void)wh_Server_Cleanup(server);
+                return WH_ERROR_ABORTED;
+            }
+        }
+        server->laneWaitCb      = config->lane_wait_cb;
+        server->laneWaitContext = config->lane_wait_context;
+    }
+#endif /* WOLFHSM_CFG_SERVER_LANES */
+
 #ifdef WOLFHSM_CFG_DMA
     /* Initialize DMA configuration and callbacks, if provided */
     if (NULL != config->dmaConfig) {
@@ -115,13 +144,53 @@ int wh_Server_Init(whServerContext* server, whServerConfig* config)
     return rc;
 }
 
+#ifndef WOLFHSM_CFG_NO_CRYPTO
+/* Release the key pins of every client on the connection and evict the keys
+ * of its sessions, which close with it. ids[0] is the connection's own
+ * client, whose keys stay cached */
+static void _wh_Server_ReleaseConnection(whServerContext* server)
+{
+    uint8_t ids[WH_SERVER_CONNECTION_CLIENTS];
+    int     count = wh_Server_GetConnectionClients(server, ids);
+    int     rc;
+    int     i;
+
+    /* Pins in the global cache are shared with other servers */
+    rc = WH_SERVER_NVM_LOCK(server);
+    if (rc == WH_ERROR_OK) {
+        for (i = 0; i < count; i++) {
+            (void)wh_Server_KeystoreUnpinClient(server, ids[i]);
+            if (i > 0) {
+                (void)wh_Server_KeystoreEvictClient(server, ids[i]);
+            }
+        }
+        (void)WH_SERVER_NVM_UNLOCK(server);
+    } /* WH_SERVER_NVM_LOCK() */
+}
+#endif /* !WOLFHSM_CFG_NO_CRYPTO */
+
 int wh_Server_Cleanup(whServerContext* server)
 {
     if (server ==NULL) {
         return WH_ERROR_BADARGS;
     }
 
+#ifndef WOLFHSM_CFG_NO_CRYPTO
+    /* Release pins the clients hold in the shared global cache */
+    _wh_Server_ReleaseConnection(server);
+#endif /* !WOLFHSM_CFG_NO_CRYPTO */
+
     (void)wh_CommServer_Cleanup(server->comm);
+#ifdef WOLFHSM_CFG_SERVER_LANES
+    {
+        int i;
+        for (i = 0; i < WOLFHSM_CFG_SERVER_LANE_COUNT - 1; i++) {
+            if (server->lane[i].initialized != 0) {
+                (void)wh_CommServer_Cleanup(&server->lane[i]);
+            }
+        }
+    }
+#endif /* WOLFHSM_CFG_SERVER_LANES */
 
     /* Log the server cleanup */
     WH_LOG(&server->log, WH_LOG_LEVEL_INFO, "Server Cleanup");
@@ -130,6 +199,10 @@ int wh_Server_Cleanup(whServerContext* server)
     (void)wh_Log_Cleanup(&server->log);
 #endif /* WOLFHSM_CFG_LOGGING */
 
+#ifdef WOLFHSM_CFG_SERVER_KEYCACHE_PARSED
+    wh_Server_ParsedKeyFlush(server);
+#endif /* WOLFHSM_CFG_SERVER_KEYCACHE_PARSED */
+
     memset(server, 0, sizeof(*server));
 
     return WH_ERROR_OK;
@@ -143,6 +216,19 @@ int wh_Server_SetConnected(whServerContext *server, whCommConnected connected)
     }
 
     server->connected = connected;
+#ifndef WOLFHSM_CFG_NO_CRYPTO
+    if (connected == WH_COMM_DISCONNECTED) {
+        /* Pins do not outlive the clients that made them, and keys do not
+         * outlive the sessions closed below */
+        _wh_Server_ReleaseConnection(server);
+    }
+#endif /* !WOLFHSM_CFG_NO_CRYPTO */
+#ifdef WOLFHSM_CFG_COMM_SESSIONS
+    if (connected == WH_COMM_DISCONNECTED) {
+        /* Sessions do not outlive the connection that carries them */
+        memset(server->session, 0, sizeof(server->session));
+    }
+#endif /* WOLFHSM_CFG_COMM_SESSIONS */
     return WH_ERROR_OK;
 }
 
@@ -164,6 +250,42 @@ int wh_Server_GetConnected(whServerContext *server,
     return WH_ERROR_OK;
 }
 
+int wh_Server_GetConnectionClients(whServerContext* server, uint8_t* out_ids)
+{
+    int count = 0;
+#ifdef WOLFHSM_CFG_COMM_SESSIONS
+    int i;
+    int j;
+#endif /* WOLFHSM_CFG_COMM_SESSIONS */
+
+    if ((server == NULL) || (out_ids == NULL)) {
+        return WH_ERROR_BADARGS;
+    }
+
+#ifdef WOLFHSM_CFG_COMM_SESSIONS
+    out_ids[count++] = (server->sessionDispatch != 0) ? server->connClientId
+                                                      : server->comm->client_id;
+    for (i = 0; i < WOLFHSM_CFG_SERVER_SESSION_COUNT; i++) {
+        /* A session has no client until its CommInit succeeds */
+        if ((server->session[i].id == 0) ||
+            (server->session[i].client_id == 0)) {
+            continue;
+        }
+        for (j = 0; j < count; j++) {
+            if (out_ids[j] == server->session[i].client_id) {
+                break;
+            }
+        }
+        if (j == count) {
+            out_ids[count++] = server->session[i].client_id;
+        }
+    }
+#else
+    out_ids[count++] = server->comm->client_id;
+#endif /* WOLFHSM_CFG_COMM_SESSIONS */
+    return count;
+}
+
 
 static int _wh_Server_HandleCommRequest(whServerContext* server,
         uint16_t magic, uint16_t action, uint16_t seq,
@@ -290,121 +412,559 @@ static int _wh_Server_HandlePkcs11Request(whServerContext* server,
     return rc;
 }
 
-int wh_Server_HandleRequestMessage(whServerContext* server)
+int wh_Server_WaitRequest(whServerContext* server, uint64_t timeout_us)
 {
-    uint16_t magic = 0;
-    uint16_t kind = 0;
-    uint16_t group = 0;
-    uint16_t action = 0;
-    uint16_t seq = 0;
-    uint16_t size = 0;
-    uint8_t* data = NULL;
-    int      handlerRc = 0;
+    if (server == NULL) {
+        return WH_ERROR_BADARGS;
+    }
+
+#ifdef WOLFHSM_CFG_SERVER_LANES
+    {
+        /* Blocking on the primary channel alone would starve the other lanes,
+         * so sleep on the first channel that can block, for a short slice at
+         * a time, and check the others without blocking before each slice */
+        whCommServer* sleeper = NULL;
+        uint64_t      waited  = 0;
+        uint64_t      slice   = 0;
+        int           lanes   = 0;
+        int           rc      = 0;
+        int           i;
+
+        for (i = -1; i < WOLFHSM_CFG_SERVER_LANE_COUNT - 1; i++) {
+            whCommServer* comm = (i < 0) ? server->comm : &server->lane[i];
+
+            if ((i >= 0) && (comm->initialized == 0)) {
+                continue;
+            }
+            lanes++;
+            if ((sleeper == NULL) && (comm->transport_cb != NULL) &&
+                (comm->transport_cb->Wait != NULL)) {
+                sleeper = comm;
+            }
+        }
+        if ((lanes > 1) && (server->laneWaitCb != NULL)) {
+            /* One wait covers every channel */
+            return server->laneWaitCb(server->laneWaitContext, timeout_us);
+        }
+        if (sleeper == NULL) {
+            return WH_ERROR_NOTIMPL;
+        }
+        if (lanes == 1) {
+            return wh_CommServer_WaitRequest(sleeper, timeout_us);
+        }
+        while (1) {
+            int unchecked = 0;
+
+            for (i = -1; i < WOLFHSM_CFG_SERVER_LANE_COUNT - 1; i++) {
+                whCommServer* comm = (i < 0) ? server->comm : &server->lane[i];
+
+                if ((comm == sleeper) ||
+                    ((i >= 0) && (comm->initialized == 0))) {
+                    continue;
+                }
+                rc = wh_CommServer_PollRequest(comm);
+                if (rc == WH_ERROR_NOTIMPL) {
+                    /* Cannot tell. Polled once the wait returns */
+                    unchecked++;
+                }
+                else if (rc != WH_ERROR_NOTREADY) {
+                    /* A request may be pending, or an error */
+                    return rc;
+                }
+            }
+
+            slice = WOLFHSM_CFG_SERVER_LANE_WAIT_US;
+            if ((timeout_us != 0) && (timeout_us - waited < slice)) {
+                slice = timeout_us - waited;
+            }
+            rc = wh_CommServer_WaitRequest(sleeper, slice);
+            if (rc != WH_ERROR_TIMEOUT) {
+                return rc;
+            }
+            waited += slice;
+            if ((timeout_us != 0) && (waited >= timeout_us)) {
+                return WH_ERROR_TIMEOUT;
+            }
+            if (unchecked > 0) {
+                /* Let the caller poll the channels that cannot be checked */
+                return WH_ERROR_OK;
+            }
+        }
+    }
+#else
+    return wh_CommServer_WaitRequest(server->comm, timeout_us);
+#endif /* WOLFHSM_CFG_SERVER_LANES */
+}
 
+#ifdef WOLFHSM_CFG_CANCEL_API
+int wh_Server_SetCanceledSequence(whServerContext* server, uint16_t seq)
+{
     if (server == NULL) {
         return WH_ERROR_BADARGS;
     }
 
-    /* Use the CommServer internal buffer to avoid copies */
-    data = wh_CommServer_GetDataPtr(server->comm);
+    /* Count the cancel so the same sequence canceled twice is seen twice */
+    server->cancelSeq = ((server->cancelSeq + 0x10000u) & 0xFFFF0000u) |
+                        (uint32_t)seq;
+    return WH_ERROR_OK;
+}
 
-    /* Are we connected with a valid data pointer? */
-    if (    (server->connected == WH_COMM_DISCONNECTED) ||
-            (data == NULL) ) {
-        return WH_ERROR_NOTREADY;
+int wh_Server_CheckCanceled(whServerContext* server, uint16_t seq)
+{
+    uint32_t cancelSeq;
+
+    if (server == NULL) {
+        return WH_ERROR_BADARGS;
     }
 
-    int rc = wh_CommServer_RecvRequest(server->comm, &magic, &kind, &seq,
-            &size, data);
-    /* Got a packet? */
-    if (rc == WH_ERROR_OK) {
-        group = WH_MESSAGE_GROUP(kind);
-        action = WH_MESSAGE_ACTION(kind);
-        switch (group) {
+    if ((server->cancelable != 0) && (server->canceled == 0)) {
+        /* Only the server writes cancelSeen, so a cancel recorded after the
+         * read below is never lost. With a single outstanding request, a
+         * cancel for another sequence is stale and only marked seen */
+        cancelSeq = server->cancelSeq;
+        if (cancelSeq != server->cancelSeen) {
+            server->cancelSeen = cancelSeq;
+            if ((cancelSeq & 0xFFFFu) == (uint32_t)seq) {
+                server->canceled = 1;
+            }
+        }
+        if (wh_CommServer_CheckCanceled(server->comm) == WH_ERROR_CANCEL) {
+            server->canceled = 1;
+        }
+    }
+    return (server->canceled != 0) ? WH_ERROR_CANCEL : WH_ERROR_OK;
+}
+#endif /* WOLFHSM_CFG_CANCEL_API */
 
-        case WH_MESSAGE_GROUP_COMM:
-            rc = _wh_Server_HandleCommRequest(server, magic, action, seq,
-                    size, data, &size, data);
-        break;
+static int _wh_Server_DispatchRequest(whServerContext* server,
+        uint16_t magic, uint16_t kind, uint16_t seq,
+        uint16_t req_size, const void* req_packet,
+        uint16_t *out_resp_size, void* resp_packet)
+{
+    int      rc     = 0;
+    uint16_t group  = WH_MESSAGE_GROUP(kind);
+    uint16_t action = WH_MESSAGE_ACTION(kind);
 
-        case WH_MESSAGE_GROUP_NVM:
-            rc = wh_Server_HandleNvmRequest(server, magic, action, seq,
-                    size, data, &size, data);
-        break;
+    switch (group) {
 
-        case WH_MESSAGE_GROUP_COUNTER:
-            rc = wh_Server_HandleCounter(server, magic, action, size, data,
-                                         &size, data);
-            break;
+    case WH_MESSAGE_GROUP_COMM:
+        rc = _wh_Server_HandleCommRequest(server, magic, action, seq,
+                req_size, req_packet, out_resp_size, resp_packet);
+    break;
+
+    case WH_MESSAGE_GROUP_NVM:
+        rc = wh_Server_HandleNvmRequest(server, magic, action, seq,
+                req_size, req_packet, out_resp_size, resp_packet);
+    break;
+
+    case WH_MESSAGE_GROUP_COUNTER:
+        rc = wh_Server_HandleCounter(server, magic, action, req_size,
+                                     req_packet, out_resp_size, resp_packet);
+        break;
 
 #ifndef WOLFHSM_CFG_NO_CRYPTO
-        case WH_MESSAGE_GROUP_KEY:
-            rc = wh_Server_HandleKeyRequest(server, magic, action, size, data,
-                                            &size, data);
-            break;
+    case WH_MESSAGE_GROUP_KEY:
+        rc = wh_Server_HandleKeyRequest(server, magic, action, req_size,
+                                        req_packet, out_resp_size,
+                                        resp_packet);
+        break;
 
-        case WH_MESSAGE_GROUP_CRYPTO:
-            rc = wh_Server_HandleCryptoRequest(server, magic, action, seq, size,
-                                               data, &size, data);
-            break;
+    case WH_MESSAGE_GROUP_CRYPTO:
+        rc = wh_Server_HandleCryptoRequest(server, magic, action, seq,
+                                           req_size, req_packet,
+                                           out_resp_size, resp_packet);
+        break;
 
 #ifdef WOLFHSM_CFG_DMA
-        case WH_MESSAGE_GROUP_CRYPTO_DMA:
-            rc = wh_Server_HandleCryptoDmaRequest(server, magic, action, seq,
-                                                  size, data, &size, data);
-            break;
+    case WH_MESSAGE_GROUP_CRYPTO_DMA:
+        rc = wh_Server_HandleCryptoDmaRequest(server, magic, action, seq,
+                                              req_size, req_packet,
+                                              out_resp_size, resp_packet);
+        break;
 #endif /* WOLFHSM_CFG_DMA */
 
 #endif  /* !WOLFHSM_CFG_NO_CRYPTO */
 
-        case WH_MESSAGE_GROUP_PKCS11:
-            rc = _wh_Server_HandlePkcs11Request(server, magic, action, seq,
-                    size, data, &size, data);
-        break;
+    case WH_MESSAGE_GROUP_PKCS11:
+        rc = _wh_Server_HandlePkcs11Request(server, magic, action, seq,
+                req_size, req_packet, out_resp_size, resp_packet);
+    break;
 
 #ifdef WOLFHSM_CFG_SHE_EXTENSION
-        case WH_MESSAGE_GROUP_SHE:
-            rc = wh_Server_HandleSheRequest(server, magic, action, size, data,
-                                            &size, data);
-            break;
+    case WH_MESSAGE_GROUP_SHE:
+        rc = wh_Server_HandleSheRequest(server, magic, action, req_size,
+                                        req_packet, out_resp_size,
+                                        resp_packet);
+        break;
 #endif
 
-        case WH_MESSAGE_GROUP_CUSTOM:
-            rc = wh_Server_HandleCustomCbRequest(server, magic, action, seq,
-                    size, data, &size, data);
-        break;
+    case WH_MESSAGE_GROUP_CUSTOM:
+        rc = wh_Server_HandleCustomCbRequest(server, magic, action, seq,
+                req_size, req_packet, out_resp_size, resp_packet);
+    break;
 
 #if defined(WOLFHSM_CFG_CERTIFICATE_MANAGER) && !defined(WOLFHSM_CFG_NO_CRYPTO)
-        case WH_MESSAGE_GROUP_CERT:
-            rc = wh_Server_HandleCertRequest(server, magic, action, seq,
-                    size, data, &size, data);
-        break;
+    case WH_MESSAGE_GROUP_CERT:
+        rc = wh_Server_HandleCertRequest(server, magic, action, seq,
+                req_size, req_packet, out_resp_size, resp_packet);
+    break;
 #endif /* WOLFHSM_CFG_CERTIFICATE_MANAGER && !WOLFHSM_CFG_NO_CRYPTO */
 
-        default:
-            /* Unknown group. Return empty packet */
-            rc   = WH_ERROR_NOTIMPL;
-            data = NULL;
+#ifdef WOLFHSM_CFG_BATCH
+    case WH_MESSAGE_GROUP_BATCH:
+        rc = _wh_Server_HandleBatchRequest(server, magic, action, seq,
+                req_size, req_packet, out_resp_size, resp_packet);
+    break;
+#endif /* WOLFHSM_CFG_BATCH */
+
+    default:
+        /* Unknown group. Return empty packet */
+        rc             = WH_ERROR_NOTIMPL;
+        *out_resp_size = 0;
+    }
+
+    return rc;
+}
+
+#ifdef WOLFHSM_CFG_BATCH
+static int _wh_Server_HandleBatchRequest(whServerContext* server,
+        uint16_t magic, uint16_t action, uint16_t seq,
+        uint16_t req_size, const void* req_packet,
+        uint16_t *out_resp_size, void* resp_packet)
+{
+    whMessageBatch_Request      req       = {0};
+    whMessageBatch_Response     resp      = {0};
+    whMessageBatch_RequestItem  reqItem   = {0};
+    whMessageBatch_ResponseItem respItem  = {0};
+    whMessageBatch_Layout       layout    = {0};
+    uint8_t*                    buf       = (uint8_t*)resp_packet;
+    const uint8_t*              items     = NULL;
+    uint32_t                    items_len = 0;
+    uint32_t                    in_off    = 0;
+    uint32_t                    out_off   = 0;
+    uint16_t                    i         = 0;
+    uint8_t*                    item_data = NULL;
+    uint16_t                    item_resp_size;
+    int                         rc        = WH_ERROR_OK;
+
+    if (action != WH_MESSAGE_BATCH_ACTION_EXEC) {
+        rc = WH_ERROR_BADARGS;
+    }
+    else if (req_size < sizeof(req)) {
+        rc = WH_ERROR_ABORTED;
+    }
+
+    /* Walk and validate every item before executing any of them */
+    if (rc == WH_ERROR_OK) {
+        (void)wh_MessageBatch_TranslateRequest(
+            magic, (const whMessageBatch_Request*)req_packet, &req);
+        items = (const uint8_t*)req_packet + sizeof(req);
+        (void)wh_MessageBatch_LayoutInit(&layout);
+        for (i = 0; (i < req.count) && (rc == WH_ERROR_OK); i++) {
+            if (sizeof(req) + items_len + sizeof(reqItem) > req_size) {
+                rc = WH_ERROR_ABORTED;
+                break;
+            }
+            (void)wh_MessageBatch_TranslateRequestItem(magic,
+                (const whMessageBatch_RequestItem*)(items + items_len),
+                &reqItem);
+            items_len += sizeof(reqItem) +
+                         WH_MESSAGE_BATCH_ALIGN((uint32_t)reqItem.size);
+            if (sizeof(req) + items_len > req_size) {
+                rc = WH_ERROR_ABORTED;
+                break;
+            }
+            rc = wh_MessageBatch_LayoutAdd(&layout, reqItem.size,
+                                           reqItem.resp_max);
+        }
+    }
+
+    if (rc == WH_ERROR_OK) {
+        /* Move the items to the end of the buffer so responses can be packed
+         * from the start without overwriting unread sub-requests */
+        in_off = (WOLFHSM_CFG_COMM_DATA_LEN & ~7u) - items_len;
+        memmove(buf + in_off, items, items_len);
+        out_off = sizeof(resp);
+
+        for (i = 0; i < req.count; i++) {
+#ifdef WOLFHSM_CFG_CANCEL_API
+            if (wh_Server_CheckCanceled(server, seq) != WH_ERROR_OK) {
+                /* Remaining sub-requests are not executed */
+                rc = WH_ERROR_CANCEL;
+                break;
+            }
+#endif /* WOLFHSM_CFG_CANCEL_API */
+            (void)wh_MessageBatch_TranslateRequestItem(magic,
+                (const whMessageBatch_RequestItem*)(buf + in_off), &reqItem);
+            item_resp_size = 0;
+
+            /* Consume the sub-request by moving its payload into its response
+             * slot, where the handler reads it and writes over it in place */
+            item_data = buf + out_off + sizeof(respItem);
+            memmove(item_data, buf + in_off + sizeof(reqItem), reqItem.size);
+            in_off += sizeof(reqItem) +
+                      WH_MESSAGE_BATCH_ALIGN((uint32_t)reqItem.size);
+
+            if (WH_MESSAGE_GROUP(reqItem.kind) == WH_MESSAGE_GROUP_BATCH) {
+                /* Batches may not be nested */
+                respItem.rc = WH_ERROR_BADARGS;
+            }
+            else {
+                respItem.rc = _wh_Server_DispatchRequest(server, magic,
+                    reqItem.kind, seq, reqItem.size, item_data,
+                    &item_resp_size, item_data);
+                if (item_resp_size > reqItem.resp_max) {
+                    respItem.rc = WH_ERROR_BUFFER_SIZE;
+                    if (out_off + sizeof(respItem) +
+                            (uint32_t)item_resp_size > in_off) {
+                        /* The response ran into the unread sub-requests */
+                        rc = WH_ERROR_BUFFER_SIZE;
+                    }
+                    item_resp_size = 0;
+                }
+            }
+
+            respItem.kind = reqItem.kind;
+            respItem.size = item_resp_size;
+            (void)wh_MessageBatch_TranslateResponseItem(magic, &respItem,
+                (whMessageBatch_ResponseItem*)(buf + out_off));
+            out_off += sizeof(respItem) +
+                       WH_MESSAGE_BATCH_ALIGN((uint32_t)item_resp_size);
+            if (rc != WH_ERROR_OK) {
+                break;
+            }
+        }
+        resp.count = req.count;
+    }
+    else {
+        out_off = sizeof(resp);
+    }
+
+    resp.rc = rc;
+    (void)wh_MessageBatch_TranslateResponse(magic, &resp,
+                                            (whMessageBatch_Response*)buf);
+    *out_resp_size = (uint16_t)out_off;
+    return rc;
+}
+#endif /* WOLFHSM_CFG_BATCH */
+
+#ifdef WOLFHSM_CFG_COMM_SESSIONS
+/* Find the open session with id.  If create is set and the session is not
+ * open, claim a free entry for it.  Returns NULL if there is none */
+static whServerSession* _wh_Server_FindSession(whServerContext* server,
+        uint16_t id, int create)
+{
+    whServerSession* free_session = NULL;
+    int              i;
+
+    for (i = 0; i < WOLFHSM_CFG_SERVER_SESSION_COUNT; i++) {
+        if (server->session[i].id == id) {
+            return &server->session[i];
+        }
+        if ((free_session == NULL) && (server->session[i].id == 0)) {
+            free_session = &server->session[i];
+        }
+    }
+    if ((create == 0) || (free_session == NULL)) {
+        return NULL;
+    }
+    free_session->id        = id;
+    free_session->client_id = 0;
+    return free_session;
+}
+
+#ifndef WOLFHSM_CFG_NO_CRYPTO
+/* Evict the keys and release the key pins of the client of a closed session,
+ * unless the connection or another of its sessions still uses that
+ * client_id */
+static void _wh_Server_ReleaseSessionClient(whServerContext* server,
+        uint8_t client_id)
+{
+    uint8_t ids[WH_SERVER_CONNECTION_CLIENTS];
+    int     count = wh_Server_GetConnectionClients(server, ids);
+    int     rc;
+    int     i;
+
+    if (client_id == 0) {
+        /* The session was never opened */
+        return;
+    }
+    for (i = 0; i < count; i++) {
+        if (ids[i] == client_id) {
+            return;
+        }
+    }
+
+    rc = WH_SERVER_NVM_LOCK(server);
+    if (rc == WH_ERROR_OK) {
+        (void)wh_Server_KeystoreUnpinClient(server, client_id);
+        (void)wh_Server_KeystoreEvictClient(server, client_id);
+        (void)WH_SERVER_NVM_UNLOCK(server);
+    } /* WH_SERVER_NVM_LOCK() */
+}
+#endif /* !WOLFHSM_CFG_NO_CRYPTO */
+
+/* Dispatch a request of the session in aux as the client of that session.
+ * Returns WH_ERROR_NOSESSION without dispatching if the session is not open */
+static int _wh_Server_DispatchSession(whServerContext* server, uint16_t aux,
+        uint16_t magic, uint16_t kind, uint16_t seq,
+        uint16_t req_size, const void* req_packet,
+        uint16_t *out_resp_size, void* resp_packet)
+{
+    whServerSession* session   = NULL;
+    int              is_comm   = 0;
+    uint8_t          client_id = 0;
+    int              rc        = 0;
+
+    if ((aux == WH_COMM_AUX_REQ_NORMAL) || (aux == WH_COMM_AUX_REQ_NORESP)) {
+        return _wh_Server_DispatchRequest(server, magic, kind, seq, req_size,
+                req_packet, out_resp_size, resp_packet);
+    }
+
+    is_comm = (WH_MESSAGE_GROUP(kind) == WH_MESSAGE_GROUP_COMM);
+    session = _wh_Server_FindSession(server, aux, is_comm &&
+            (WH_MESSAGE_ACTION(kind) == WH_MESSAGE_COMM_ACTION_INIT));
+    if (session == NULL) {
+        *out_resp_size = 0;
+        return WH_ERROR_NOSESSION;
+    }
+
+    if (is_comm &&
+            (WH_MESSAGE_ACTION(kind) == WH_MESSAGE_COMM_ACTION_CLOSE)) {
+        /* Only this session closes. The connection stays up */
+        WH_LOG_F(&server->log, WH_LOG_LEVEL_INFO,
+                 "SessionClose: session=0x%04X, client_id=0x%08X", aux,
+                 session->client_id);
+        client_id = session->client_id;
+        memset(session, 0, sizeof(*session));
+#ifndef WOLFHSM_CFG_NO_CRYPTO
+        _wh_Server_ReleaseSessionClient(server, client_id);
+#endif /* !WOLFHSM_CFG_NO_CRYPTO */
+        *out_resp_size = 0;
+        return WH_ERROR_OK;
+    }
+
+    /* Handlers use the client_id of the comm context for key and object
+     * ownership, so substitute the one of the session */
+    client_id               = server->comm->client_id;
+    server->connClientId    = client_id;
+    server->sessionDispatch = 1;
+    server->comm->client_id = session->client_id;
+    rc = _wh_Server_DispatchRequest(server, magic, kind, seq, req_size,
+            req_packet, out_resp_size, resp_packet);
+    if (is_comm &&
+            (WH_MESSAGE_ACTION(kind) == WH_MESSAGE_COMM_ACTION_INIT)) {
+        if (rc == WH_ERROR_OK) {
+            session->client_id = server->comm->client_id;
+        }
+        else if (session->client_id == 0) {
+            /* Rejected before the session was ever opened */
+            memset(session, 0, sizeof(*session));
+        }
+    }
+    server->comm->client_id = client_id;
+    server->sessionDispatch = 0;
+
+    return rc;
+}
+#endif /* WOLFHSM_CFG_COMM_SESSIONS */
+
+/* Receive, dispatch and respond to one request pending on comm, which is the
+ * primary channel or one of the lanes of server */
+static int _wh_Server_HandleLaneMessage(whServerContext* server,
+        whCommServer* comm, int* out_handled)
+{
+    uint16_t magic = 0;
+    uint16_t kind = 0;
+    uint16_t group = 0;
+    uint16_t action = 0;
+    uint16_t seq = 0;
+    uint16_t aux = 0;
+    uint16_t size = 0;
+    uint8_t* data = NULL;
+    int      handlerRc = 0;
+
+    /* Use the CommServer internal buffer to avoid copies */
+    data = wh_CommServer_GetDataPtr(comm);
+
+    /* Are we connected with a valid data pointer? */
+    if (    (server->connected == WH_COMM_DISCONNECTED) ||
+            (data == NULL) ) {
+        return WH_ERROR_NOTREADY;
+    }
+
+    int rc = wh_CommServer_RecvRequest(comm, &magic, &kind, &seq,
+            &size, data);
+    /* Got a packet? */
+    if (rc == WH_ERROR_OK) {
+        *out_handled = 1;
+        group = WH_MESSAGE_GROUP(kind);
+        action = WH_MESSAGE_ACTION(kind);
+        (void)wh_CommServer_GetRequestAux(comm, &aux);
+#ifdef WOLFHSM_CFG_CANCEL_API
+        /* Only requests on the primary channel can be canceled */
+        server->canceled   = 0;
+        server->cancelable = (comm == server->comm);
+        rc = wh_Server_CheckCanceled(server, seq);
+        if (rc == WH_ERROR_OK) {
+#ifdef WOLFHSM_CFG_COMM_SESSIONS
+            rc = _wh_Server_DispatchSession(server, aux, magic, kind, seq,
+                                            size, data, &size, data);
+#else
+            rc = _wh_Server_DispatchRequest(server, magic, kind, seq, size,
+                                            data, &size, data);
+#endif /* WOLFHSM_CFG_COMM_SESSIONS */
+        }
+        if (server->canceled != 0) {
+            /* Replace the response with an empty cancel response */
+            kind = WH_MESSAGE_KIND(WH_MESSAGE_GROUP_CANCEL,
+                                   WH_MESSAGE_ACTION_NONE);
             size = 0;
+            rc   = WH_ERROR_CANCEL;
         }
+        server->cancelable = 0;
+#elif defined(WOLFHSM_CFG_COMM_SESSIONS)
+        rc = _wh_Server_DispatchSession(server, aux, magic, kind, seq, size,
+                                        data, &size, data);
+#else
+        rc = _wh_Server_DispatchRequest(server, magic, kind, seq, size, data,
+                                        &size, data);
+#endif /* WOLFHSM_CFG_CANCEL_API */
 
         /* Capture handler result for logging. The response packet already
          * contains the error code for the client in the resp.rc field. */
         handlerRc = rc;
 
-        /* Always send the response to the client, regardless of handler error.
-         * The response packet contains the operational error code for the
-         * client in the resp.rc field. */
-        do {
-            rc = wh_CommServer_SendResponse(server->comm, magic, kind, seq,
-                                            size, data);
-        } while (rc == WH_ERROR_NOTREADY);
+        if (aux == WH_COMM_AUX_REQ_NORESP) {
+            /* Client does not want a response. Only release the request */
+            rc = wh_CommServer_CompleteRequest(comm);
+        }
+#ifdef WOLFHSM_CFG_COMM_SESSIONS
+        else if (handlerRc == WH_ERROR_NOSESSION) {
+            /* There is no response packet to carry an error code */
+            do {
+                rc = wh_CommServer_SendErrorResponse(comm, magic, kind, seq);
+            } while (rc == WH_ERROR_NOTREADY);
+        }
+#endif /* WOLFHSM_CFG_COMM_SESSIONS */
+        else {
+            /* Always send the response to the client, regardless of handler
+             * error. The response packet contains the operational error code
+             * for the client in the resp.rc field. */
+            do {
+                rc = wh_CommServer_SendResponse(comm, magic, kind, seq,
+                                                size, data);
+            } while (rc == WH_ERROR_NOTREADY);
+        }
 
         /* Log error code from request handler, if present */
         WH_LOG_ON_ERROR_F(&server->log, WH_LOG_LEVEL_ERROR, handlerRc,
                           "Handler (group=%d, action=%d, seq=%d) returned %d",
                           group, action, seq, handlerRc);
-        (void)handlerRc; /* suppress unused var warning */
+        /* suppress unused var warnings when logging is disabled */
+        (void)handlerRc;
+        (void)group;
+        (void)action;
 
         /* Log error code from sending response, if present */
         WH_LOG_ON_ERROR_F(
@@ -427,6 +987,75 @@ int wh_Server_HandleRequestMessage(whServerContext* server)
     return rc;
 }
 
+int wh_Server_HandleRequestMessage(whServerContext* server)
+{
+    if (server == NULL) {
+        return WH_ERROR_BADARGS;
+    }
+
+#ifdef WOLFHSM_CFG_SERVER_LANES
+    {
+        /* Handle at most one request, from the highest priority lane.  An
+         * error on one channel does not keep the others from being served */
+        int firstRc  = WH_ERROR_NOTREADY;
+        int firstErr = -1;
+        int handled  = 0;
+        int rc       = 0;
+        int i;
+
+        for (i = 0; i < WOLFHSM_CFG_SERVER_LANE_COUNT; i++) {
+            whCommServer* comm = (i == 0) ? server->comm : &server->lane[i - 1];
+
+            if ((i > 0) && (comm->initialized == 0)) {
+                continue;
+            }
+            rc = _wh_Server_HandleLaneMessage(server, comm, &handled);
+            if (handled != 0) {
+                break;
+            }
+            if (rc != WH_ERROR_NOTREADY) {
+                if (firstErr < 0) {
+                    firstErr = i;
+                    firstRc  = rc;
+                }
+                else {
+                    server->laneError[i] = rc;
+                }
+            }
+        }
+        if (handled == 0) {
+            return firstRc;
+        }
+        if (firstErr >= 0) {
+            /* Keep the earlier error for wh_Server_GetLaneError */
+            server->laneError[firstErr] = firstRc;
+        }
+        return rc;
+    }
+#else
+    {
+        int handled = 0;
+        return _wh_Server_HandleLaneMessage(server, server->comm, &handled);
+    }
+#endif /* WOLFHSM_CFG_SERVER_LANES */
+}
+
+#ifdef WOLFHSM_CFG_SERVER_LANES
+int wh_Server_GetLaneError(whServerContext* server, int lane, int* out_rc)
+{
+    if (    (server == NULL) ||
+            (out_rc == NULL) ||
+            (lane < 0) ||
+            (lane >= WOLFHSM_CFG_SERVER_LANE_COUNT)) {
+        return WH_ERROR_BADARGS;
+    }
+
+    *out_rc                 = server->laneError[lane];
+    server->laneError[lane] = WH_ERROR_OK;
+    return WH_ERROR_OK;
+}
+#endif /* WOLFHSM_CFG_SERVER_LANES */
+
 #ifdef WOLFHSM_CFG_THREADSAFE
 int wh_Server_NvmLock(whServerContext* server)
 {
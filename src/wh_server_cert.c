@@ -122,6 +122,12 @@ static int _verifyChainAgainstCmStore(whServerContext*      server,
                     word32         cacheBufSize =
                         WOLFHSM_CFG_SERVER_KEYCACHE_BIG_BUFSIZE;
 
+                    /* The public key is part of the cert, so reserve no more
+                     * than the cert size rather than the largest slot */
+                    if ((word32)cert_len + idx < cacheBufSize) {
+                        cacheBufSize = (word32)cert_len + idx;
+                    }
+
                     /* Grab the cache slot and dump the public key from the cert
                      * into it */
                     rc = wh_Server_KeystoreGetCacheSlotChecked(
@@ -454,8 +460,9 @@ int wh_Server_HandleCertRequest(whServerContext* server, uint16_t magic,
         }; break;
 
         case WH_MESSAGE_CERT_ACTION_READTRUSTED: {
+            /* Reads may fill a reassembled response when fragmenting */
             const uint32_t max_transport_cert_len =
-                WOLFHSM_CFG_COMM_DATA_LEN -
+                wh_CommServer_GetMaxDataLen(server->comm) -
                 sizeof(whMessageCert_ReadTrustedResponse);
             whMessageCert_ReadTrustedRequest  req  = {0};
             whMessageCert_ReadTrustedResponse resp = {0};
@@ -498,7 +505,11 @@ int wh_Server_HandleCertRequest(whServerContext* server, uint16_t magic,
             /* Convert the response struct */
             wh_MessageCert_TranslateReadTrustedResponse(
                 magic, &resp, (whMessageCert_ReadTrustedResponse*)resp_packet);
-            *out_resp_size = sizeof(resp) + resp.cert_len;
+            /* Only a successful read carries the certificate */
+            *out_resp_size = sizeof(resp);
+            if (resp.rc == WH_ERROR_OK) {
+                *out_resp_size += resp.cert_len;
+            }
         }; break;
 
         case WH_MESSAGE_CERT_ACTION_VERIFY: {
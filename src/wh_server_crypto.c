@@ -205,6 +205,7 @@ int wh_Server_CacheImportRsaKey(whServerContext* ctx, RsaKey* key,
     whNvmMetadata* cacheMeta;
     uint16_t max_size;
     uint16_t der_size;
+    int      need;
 
     if (    (ctx == NULL) ||
             (key == NULL) ||
@@ -213,15 +214,23 @@ int wh_Server_CacheImportRsaKey(whServerContext* ctx, RsaKey* key,
         return WH_ERROR_BADARGS;
     }
 
-    /* wc_RsaKeyToDer doesn't have a length check option so we need to just pass
-     * the big key size if compiled */
-    /* TODO: Change this to use an estimate of the DER size based on key len */
     if(WOLFHSM_CFG_SERVER_KEYCACHE_BIG_COUNT > 0) {
         max_size = WOLFHSM_CFG_SERVER_KEYCACHE_BIG_BUFSIZE;
     } else {
         max_size = WOLFHSM_CFG_SERVER_KEYCACHE_BUFSIZE;
     }
 
+    /* Reserve only the DER size of this key rather than the largest slot, so
+     * caching it doesn't evict keys to make room it will never use */
+    if (key->type == RSA_PRIVATE) {
+        need = wc_RsaKeyToDer(key, NULL, 0);
+    } else {
+        need = wc_RsaKeyToPublicDer(key, NULL, 0);
+    }
+    if ((need > 0) && (need < max_size)) {
+        max_size = (uint16_t)need;
+    }
+
     /* get a free slot */
     ret = wh_Server_KeystoreGetCacheSlotChecked(ctx, keyId, max_size, &cacheBuf,
                                                 &cacheMeta);
@@ -799,6 +808,213 @@ int wh_Server_MlDsaKeyCacheExport(whServerContext* ctx, whKeyId keyId,
 #endif /* HAVE_DILITHIUM */
 
 
+#ifdef WOLFHSM_CFG_SERVER_KEYCACHE_PARSED
+/* Free the key object of a parsed key entry and mark the entry unused */
+static void _ParsedKeyFree(whServerParsedKey* entry)
+{
+    switch (entry->type) {
+#ifndef NO_RSA
+        case WH_SERVER_PARSEDKEY_RSA:
+            (void)wc_FreeRsaKey(&entry->key.rsa);
+            break;
+#endif /* !NO_RSA */
+#ifdef HAVE_ECC
+        case WH_SERVER_PARSEDKEY_ECC:
+            (void)wc_ecc_free(&entry->key.ecc);
+            break;
+#endif /* HAVE_ECC */
+#ifdef HAVE_ED25519
+        case WH_SERVER_PARSEDKEY_ED25519:
+            wc_ed25519_free(&entry->key.ed25519);
+            break;
+#endif /* HAVE_ED25519 */
+#ifdef HAVE_DILITHIUM
+        case WH_SERVER_PARSEDKEY_MLDSA:
+            (void)wc_MlDsaKey_Free(&entry->key.mldsa);
+            break;
+#endif /* HAVE_DILITHIUM */
+        default:
+            break;
+    }
+    /* The object may have held private key material */
+    memset(entry, 0, sizeof(*entry));
+}
+
+/* Initialize the key object of an unused entry and decode the cached key
+ * into it */
+static int _ParsedKeyDecode(whServerContext* ctx, whServerParsedKey* entry,
+                            whKeyId keyId, uint16_t type, int devId)
+{
+    int ret;
+
+    /* Unused when no key types are enabled */
+    (void)ctx;
+    (void)keyId;
+    (void)devId;
+
+    switch (type) {
+#ifndef NO_RSA
+        case WH_SERVER_PARSEDKEY_RSA:
+            ret = wc_InitRsaKey_ex(&entry->key.rsa, NULL, devId);
+            break;
+#endif /* !NO_RSA */
+#ifdef HAVE_ECC
+        case WH_SERVER_PARSEDKEY_ECC:
+            ret = wc_ecc_init_ex(&entry->key.ecc, NULL, devId);
+            break;
+#endif /* HAVE_ECC */
+#ifdef HAVE_ED25519
+        case WH_SERVER_PARSEDKEY_ED25519:
+            ret = wc_ed25519_init_ex(&entry->key.ed25519, NULL, devId);
+            break;
+#endif /* HAVE_ED25519 */
+#ifdef HAVE_DILITHIUM
+        case WH_SERVER_PARSEDKEY_MLDSA:
+            ret = wc_MlDsaKey_Init(&entry->key.mldsa, NULL, devId);
+            break;
+#endif /* HAVE_DILITHIUM */
+        default:
+            return WH_ERROR_BADARGS;
+    }
+    if (ret != 0) {
+        return ret;
+    }
+    /* Initialized, so _ParsedKeyFree must free the object from here on */
+    entry->type = type;
+
+    switch (type) {
+#ifndef NO_RSA
+        case WH_SERVER_PARSEDKEY_RSA:
+            ret = wh_Server_CacheExportRsaKey(ctx, keyId, &entry->key.rsa);
+            break;
+#endif /* !NO_RSA */
+#ifdef HAVE_ECC
+        case WH_SERVER_PARSEDKEY_ECC:
+            ret = wh_Server_EccKeyCacheExport(ctx, keyId, &entry->key.ecc);
+            break;
+#endif /* HAVE_ECC */
+#ifdef HAVE_ED25519
+        case WH_SERVER_PARSEDKEY_ED25519:
+            ret = wh_Server_CacheExportEd25519Key(ctx, keyId,
+                                                  &entry->key.ed25519);
+            break;
+#endif /* HAVE_ED25519 */
+#ifdef HAVE_DILITHIUM
+        case WH_SERVER_PARSEDKEY_MLDSA:
+            ret = wh_Server_MlDsaKeyCacheExport(ctx, keyId, &entry->key.mldsa);
+            break;
+#endif /* HAVE_DILITHIUM */
+        default:
+            ret = WH_ERROR_BADARGS;
+            break;
+    }
+    return ret;
+}
+
+int wh_Server_ParsedKeyGet(whServerContext* ctx, whKeyId keyId, uint16_t type,
+                           int devId, void** out_key)
+{
+    whServerParsedKey* entry = NULL;
+    uint32_t           gen   = 0;
+    int                ret;
+    int                i;
+
+    if (    (ctx == NULL) ||
+            (out_key == NULL) ||
+            (WH_KEYID_ISERASED(keyId))) {
+        return WH_ERROR_BADARGS;
+    }
+
+    /* Load key from NVM into a cache slot if necessary */
+    ret = wh_Server_KeystoreFreshenKey(ctx, keyId, NULL, NULL);
+    if (ret == WH_ERROR_OK) {
+        ret = wh_Server_KeystoreGetCacheGen(ctx, keyId, &gen);
+    }
+    if (ret != WH_ERROR_OK) {
+        return ret;
+    }
+
+    /* Keys evicted through this server were dropped at evict time. A global
+     * key evicted or replaced by another server is left here until its entry
+     * is reused or this key is used again, when its generation mismatches */
+    for (i = 0; i < WOLFHSM_CFG_SERVER_KEYCACHE_PARSED_COUNT; i++) {
+        if (ctx->parsedKey[i].id == keyId) {
+            entry = &ctx->parsedKey[i];
+            break;
+        }
+    }
+
+    if (    (entry != NULL) &&
+            (entry->type == type) &&
+            (entry->gen == gen) &&
+            (entry->devId == devId)) {
+        /* Cached key bytes are unchanged since decoded */
+        *out_key = &entry->key;
+        return WH_ERROR_OK;
+    }
+
+    if (entry == NULL) {
+        /* Use an unused entry, else replace the entries in turn */
+        for (i = 0; i < WOLFHSM_CFG_SERVER_KEYCACHE_PARSED_COUNT; i++) {
+            if (ctx->parsedKey[i].id == WH_KEYID_ERASED) {
+                entry = &ctx->parsedKey[i];
+                break;
+            }
+        }
+        if (entry == NULL) {
+            entry              = &ctx->parsedKey[ctx->parsedKeyNext];
+            ctx->parsedKeyNext = (uint16_t)((ctx->parsedKeyNext + 1) %
+                                 WOLFHSM_CFG_SERVER_KEYCACHE_PARSED_COUNT);
+        }
+    }
+
+    _ParsedKeyFree(entry);
+    ret = _ParsedKeyDecode(ctx, entry, keyId, type, devId);
+    if (ret != WH_ERROR_OK) {
+        _ParsedKeyFree(entry);
+        return ret;
+    }
+    entry->id    = keyId;
+    entry->gen   = gen;
+    entry->devId = devId;
+
+    WH_DEBUG_SERVER_VERBOSE("ParsedKeyGet: decoded keyId:%x type:%u gen:%u\n",
+                            keyId, type, (unsigned)gen);
+    *out_key = &entry->key;
+    return WH_ERROR_OK;
+}
+
+void wh_Server_ParsedKeyDrop(whServerContext* ctx, whKeyId keyId)
+{
+    int i;
+
+    if ((ctx == NULL) || (WH_KEYID_ISERASED(keyId))) {
+        return;
+    }
+    for (i = 0; i < WOLFHSM_CFG_SERVER_KEYCACHE_PARSED_COUNT; i++) {
+        if (ctx->parsedKey[i].id == keyId) {
+            _ParsedKeyFree(&ctx->parsedKey[i]);
+        }
+    }
+}
+
+void wh_Server_ParsedKeyFlush(whServerContext* ctx)
+{
+    int i;
+
+    if (ctx == NULL) {
+        return;
+    }
+    for (i = 0; i < WOLFHSM_CFG_SERVER_KEYCACHE_PARSED_COUNT; i++) {
+        if (ctx->parsedKey[i].id != WH_KEYID_ERASED) {
+            _ParsedKeyFree(&ctx->parsedKey[i]);
+        }
+    }
+    ctx->parsedKeyNext = 0;
+}
+#endif /* WOLFHSM_CFG_SERVER_KEYCACHE_PARSED */
+
+
 /** Request/Response Handling functions */
 
 #ifdef HAVE_ECC
@@ -4197,7 +4413,7 @@ static int _HandleMlDsaSign(whServerContext* ctx, uint16_t magic, int devId,
     /* Response message */
     byte* res_out =
         (uint8_t*)(cryptoDataOut) + sizeof(whMessageCrypto_MlDsaSignResponse);
-    const word32 max_len = (word32)(WOLFHSM_CFG_COMM_DATA_LEN -
+    const word32 max_len = (word32)(wh_CommServer_GetMaxDataLen(ctx->comm) -
                                     (res_out - (uint8_t*)cryptoDataOut));
     word32       res_len = max_len;
 
@@ -4745,6 +4961,30 @@ int wh_Server_HandleCryptoRequest(whServerContext* ctx, uint16_t magic,
 
 #ifdef WOLFHSM_CFG_DMA
 
+#if !defined(NO_SHA256) || defined(WOLFSSL_SHA224) || \
+    defined(WOLFSSL_SHA384) || defined(WOLFSSL_SHA512)
+/* Size of the next chunk of DMA input to hash. With WOLFHSM_CFG_CANCEL_API the
+ * input is hashed in chunks, each preceded by a check for a cancel */
+static int _DmaHashChunk(whServerContext* ctx, uint16_t seq, word32 left,
+                         word32* out_chunk)
+{
+#ifdef WOLFHSM_CFG_CANCEL_API
+    int ret = wh_Server_CheckCanceled(ctx, seq);
+    if (ret != WH_ERROR_OK) {
+        return ret;
+    }
+    *out_chunk = (left > WOLFHSM_CFG_SERVER_CANCEL_CHUNK)
+                     ? (word32)WOLFHSM_CFG_SERVER_CANCEL_CHUNK
+                     : left;
+#else
+    (void)ctx;
+    (void)seq;
+    *out_chunk = left;
+#endif /* WOLFHSM_CFG_CANCEL_API */
+    return WH_ERROR_OK;
+}
+#endif /* !NO_SHA256 || WOLFSSL_SHA224 || WOLFSSL_SHA384 || WOLFSSL_SHA512 */
+
 #ifndef NO_SHA256
 static int _HandleSha256Dma(whServerContext* ctx, uint16_t magic, int devId,
                             uint16_t seq, const void* cryptoDataIn,
@@ -4829,7 +5069,11 @@ static int _HandleSha256Dma(whServerContext* ctx, uint16_t magic, int devId,
     else if (ret == WH_ERROR_OK) {
         /* Update requested, update the SHA256 operation, wrapping client
          * address accesses with the associated DMA address processing */
-        void* inAddr;
+        void*       inAddr;
+        const byte* in    = NULL;
+        word32      left  = (word32)req.input.sz;
+        word32      chunk = 0;
+        int         postRet;
         ret = wh_Server_DmaProcessClientAddress(
             ctx, req.input.addr, &inAddr, req.input.sz,
             WH_DMA_OPER_CLIENT_READ_PRE, (whServerDmaFlags){0});
@@ -4838,13 +5082,23 @@ static int _HandleSha256Dma(whServerContext* ctx, uint16_t magic, int devId,
         if (ret == WH_ERROR_OK) {
             WH_DEBUG_SERVER_VERBOSE("  wc_Sha256Update: inAddr=%p, sz=%llu\n", inAddr,
                    (long long unsigned int)req.input.sz);
-            ret = wc_Sha256Update(sha256, inAddr, req.input.sz);
-        }
-
-        if (ret == WH_ERROR_OK) {
-            ret = wh_Server_DmaProcessClientAddress(
+            /* Hash in chunks so a canceled request stops early */
+            in = (const byte*)inAddr;
+            while ((ret == WH_ERROR_OK) && (left > 0)) {
+                ret = _DmaHashChunk(ctx, seq, left, &chunk);
+                if (ret == WH_ERROR_OK) {
+                    ret = wc_Sha256Update(sha256, in, chunk);
+                    in += chunk;
+                    left -= chunk;
+                }
+            }
+            /* Release the input even if the hash was canceled part way */
+            postRet = wh_Server_DmaProcessClientAddress(
                 ctx, req.input.addr, &inAddr, req.input.sz,
                 WH_DMA_OPER_CLIENT_READ_POST, (whServerDmaFlags){0});
+            if (ret == WH_ERROR_OK) {
+                ret = postRet;
+            }
         }
 
         if (ret == WH_ERROR_ACCESS) {
@@ -4957,7 +5211,11 @@ static int _HandleSha224Dma(whServerContext* ctx, uint16_t magic, int devId,
     else if (ret == WH_ERROR_OK) {
         /* Update requested, update the SHA224 operation, wrapping client
          * address accesses with the associated DMA address processing */
-        void* inAddr;
+        void*       inAddr;
+        const byte* in    = NULL;
+        word32      left  = (word32)req.input.sz;
+        word32      chunk = 0;
+        int         postRet;
         ret = wh_Server_DmaProcessClientAddress(
             ctx, req.input.addr, &inAddr, req.input.sz,
             WH_DMA_OPER_CLIENT_READ_PRE, (whServerDmaFlags){0});
@@ -4966,13 +5224,23 @@ static int _HandleSha224Dma(whServerContext* ctx, uint16_t magic, int devId,
         if (ret == WH_ERROR_OK) {
             WH_DEBUG_SERVER_VERBOSE("  wc_Sha224Update: inAddr=%p, sz=%llu\n", inAddr,
                    (long long unsigned int)req.input.sz);
-            ret = wc_Sha224Update(sha224, inAddr, req.input.sz);
-        }
-
-        if (ret == WH_ERROR_OK) {
-            ret = wh_Server_DmaProcessClientAddress(
+            /* Hash in chunks so a canceled request stops early */
+            in = (const byte*)inAddr;
+            while ((ret == WH_ERROR_OK) && (left > 0)) {
+                ret = _DmaHashChunk(ctx, seq, left, &chunk);
+                if (ret == WH_ERROR_OK) {
+                    ret = wc_Sha224Update(sha224, in, chunk);
+                    in += chunk;
+                    left -= chunk;
+                }
+            }
+            /* Release the input even if the hash was canceled part way */
+            postRet = wh_Server_DmaProcessClientAddress(
                 ctx, req.input.addr, &inAddr, req.input.sz,
                 WH_DMA_OPER_CLIENT_READ_POST, (whServerDmaFlags){0});
+            if (ret == WH_ERROR_OK) {
+                ret = postRet;
+            }
         }
 
         if (ret == WH_ERROR_ACCESS) {
@@ -5085,7 +5353,11 @@ static int _HandleSha384Dma(whServerContext* ctx, uint16_t magic, int devId,
     else if (ret == WH_ERROR_OK) {
         /* Update requested, update the SHA384 operation, wrapping client
          * address accesses with the associated DMA address processing */
-        void* inAddr;
+        void*       inAddr;
+        const byte* in    = NULL;
+        word32      left  = (word32)req.input.sz;
+        word32      chunk = 0;
+        int         postRet;
         ret = wh_Server_DmaProcessClientAddress(
             ctx, req.input.addr, &inAddr, req.input.sz,
             WH_DMA_OPER_CLIENT_READ_PRE, (whServerDmaFlags){0});
@@ -5094,13 +5366,23 @@ static int _HandleSha384Dma(whServerContext* ctx, uint16_t magic, int devId,
         if (ret == WH_ERROR_OK) {
             WH_DEBUG_SERVER_VERBOSE("  wc_Sha384Update: inAddr=%p, sz=%llu\n", inAddr,
                    (long long unsigned int)req.input.sz);
-            ret = wc_Sha384Update(sha384, inAddr, req.input.sz);
-        }
-
-        if (ret == WH_ERROR_OK) {
-            ret = wh_Server_DmaProcessClientAddress(
+            /* Hash in chunks so a canceled request stops early */
+            in = (const byte*)inAddr;
+            while ((ret == WH_ERROR_OK) && (left > 0)) {
+                ret = _DmaHashChunk(ctx, seq, left, &chunk);
+                if (ret == WH_ERROR_OK) {
+                    ret = wc_Sha384Update(sha384, in, chunk);
+                    in += chunk;
+                    left -= chunk;
+                }
+            }
+            /* Release the input even if the hash was canceled part way */
+            postRet = wh_Server_DmaProcessClientAddress(
                 ctx, req.input.addr, &inAddr, req.input.sz,
                 WH_DMA_OPER_CLIENT_READ_POST, (whServerDmaFlags){0});
+            if (ret == WH_ERROR_OK) {
+                ret = postRet;
+            }
         }
 
         if (ret == WH_ERROR_ACCESS) {
@@ -5232,7 +5514,11 @@ static int _HandleSha512Dma(whServerContext* ctx, uint16_t magic, int devId,
     else if (ret == WH_ERROR_OK) {
         /* Update requested, update the SHA512 operation, wrapping client
          * address accesses with the associated DMA address processing */
-        void* inAddr;
+        void*       inAddr;
+        const byte* in    = NULL;
+        word32      left  = (word32)req.input.sz;
+        word32      chunk = 0;
+        int         postRet;
         ret = wh_Server_DmaProcessClientAddress(
             ctx, req.input.addr, &inAddr, req.input.sz,
             WH_DMA_OPER_CLIENT_READ_PRE, (whServerDmaFlags){0});
@@ -5241,13 +5527,23 @@ static int _HandleSha512Dma(whServerContext* ctx, uint16_t magic, int devId,
         if (ret == WH_ERROR_OK) {
             WH_DEBUG_SERVER_VERBOSE("  wc_Sha512Update: inAddr=%p, sz=%llu\n", inAddr,
                    (long long unsigned int)req.input.sz);
-            ret = wc_Sha512Update(sha512, inAddr, req.input.sz);
-        }
-
-        if (ret == WH_ERROR_OK) {
-            ret = wh_Server_DmaProcessClientAddress(
+            /* Hash in chunks so a canceled request stops early */
+            in = (const byte*)inAddr;
+            while ((ret == WH_ERROR_OK) && (left > 0)) {
+                ret = _DmaHashChunk(ctx, seq, left, &chunk);
+                if (ret == WH_ERROR_OK) {
+                    ret = wc_Sha512Update(sha512, in, chunk);
+                    in += chunk;
+                    left -= chunk;
+                }
+            }
+            /* Release the input even if the hash was canceled part way */
+            postRet = wh_Server_DmaProcessClientAddress(
                 ctx, req.input.addr, &inAddr, req.input.sz,
                 WH_DMA_OPER_CLIENT_READ_POST, (whServerDmaFlags){0});
+            if (ret == WH_ERROR_OK) {
+                ret = postRet;
+            }
         }
 
         if (ret == WH_ERROR_ACCESS) {
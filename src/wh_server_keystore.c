@@ -49,6 +49,10 @@
 
 #include "wolfhsm/wh_server_keystore.h"
 
+#ifdef WOLFHSM_CFG_SERVER_KEYCACHE_PARSED
+#include "wolfhsm/wh_server_crypto.h"
+#endif
+
 static int _FindInCache(whServerContext* server, whKeyId keyId, int* out_index,
                         int* out_big, uint8_t** out_buffer,
                         whNvmMetadata** out_meta);
@@ -83,6 +87,91 @@ static whKeyCacheContext* _GetCacheContext(whServerContext* server,
     return &server->localCache;
 }
 
+/* Slots in the regular and big arrays.  With the pool, all slots are regular
+ * and hold a buffer of any size in the pool */
+#ifdef WOLFHSM_CFG_SERVER_KEYCACHE_POOL
+#define WH_KEYCACHE_REGULAR_SLOTS WOLFHSM_CFG_SERVER_KEYCACHE_POOL_KEYS
+#define WH_KEYCACHE_BIG_SLOTS 0
+#else
+#define WH_KEYCACHE_REGULAR_SLOTS WOLFHSM_CFG_SERVER_KEYCACHE_COUNT
+#define WH_KEYCACHE_BIG_SLOTS WOLFHSM_CFG_SERVER_KEYCACHE_BIG_COUNT
+#endif
+
+/* Slot accessors.  index is within the regular (big == 0) or big array */
+static whNvmMetadata* _SlotMeta(whKeyCacheContext* ctx, int index, int big)
+{
+#ifdef WOLFHSM_CFG_SERVER_KEYCACHE_POOL
+    (void)big;
+    return ctx->cache[index].meta;
+#else
+    return (big == 0) ? ctx->cache[index].meta : ctx->bigCache[index].meta;
+#endif
+}
+
+static uint8_t* _SlotBuffer(whKeyCacheContext* ctx, int index, int big)
+{
+#ifdef WOLFHSM_CFG_SERVER_KEYCACHE_POOL
+    (void)big;
+    return &ctx->pool[(size_t)ctx->cache[index].offset *
+                      WOLFHSM_CFG_SERVER_KEYCACHE_POOL_GRANULE];
+#else
+    return (big == 0) ? ctx->cache[index].buffer : ctx->bigCache[index].buffer;
+#endif
+}
+
+static uint8_t* _SlotCommitted(whKeyCacheContext* ctx, int index, int big)
+{
+#ifdef WOLFHSM_CFG_SERVER_KEYCACHE_POOL
+    (void)big;
+    return &ctx->cache[index].committed;
+#else
+    return (big == 0) ? &ctx->cache[index].committed
+                      : &ctx->bigCache[index].committed;
+#endif
+}
+
+static uint16_t* _SlotPinned(whKeyCacheContext* ctx, int index, int big)
+{
+#ifdef WOLFHSM_CFG_SERVER_KEYCACHE_POOL
+    (void)big;
+    return &ctx->cache[index].pinned;
+#else
+    return (big == 0) ? &ctx->cache[index].pinned
+                      : &ctx->bigCache[index].pinned;
+#endif
+}
+
+#ifdef WOLFHSM_CFG_SERVER_KEYCACHE_PARSED
+static uint32_t* _SlotGen(whKeyCacheContext* ctx, int index, int big)
+{
+#ifdef WOLFHSM_CFG_SERVER_KEYCACHE_POOL
+    (void)big;
+    return &ctx->cache[index].gen;
+#else
+    return (big == 0) ? &ctx->cache[index].gen : &ctx->bigCache[index].gen;
+#endif
+}
+#endif /* WOLFHSM_CFG_SERVER_KEYCACHE_PARSED */
+
+#if defined(WOLFHSM_CFG_SERVER_KEYCACHE_LRU) || \
+    defined(WOLFHSM_CFG_SERVER_KEYCACHE_LFU)
+static uint32_t* _SlotUse(whKeyCacheContext* ctx, int index, int big)
+{
+#ifdef WOLFHSM_CFG_SERVER_KEYCACHE_POOL
+    (void)big;
+    return &ctx->cache[index].use;
+#else
+    return (big == 0) ? &ctx->cache[index].use : &ctx->bigCache[index].use;
+#endif
+}
+#endif
+
+/* Slot number used by the index: regular slots first, then big ones */
+static int _SlotNumber(int index, int big)
+{
+    return (big == 0) ? index : WH_KEYCACHE_REGULAR_SLOTS + index;
+}
+
 typedef enum {
     WH_KS_OP_CACHE = 0,
     WH_KS_OP_COMMIT,
@@ -103,12 +192,7 @@ static int _KeyIsCommitted(whServerContext* server, whKeyId keyId)
         return 0;
     }
 
-    if (big == 0) {
-        return ctx->cache[index].committed;
-    }
-    else {
-        return ctx->bigCache[index].committed;
-    }
+    return *_SlotCommitted(ctx, index, big);
 }
 /* Centralized cache/NVM policy: enforce NONMODIFIABLE/NONEXPORTABLE at the
  * keystore layer. Usage enforcement remains separate. */
@@ -189,6 +273,92 @@ static int _KeystoreCheckPolicy(whServerContext* server, whKsOp op,
 
     return WH_ERROR_OK;
 }
+/* Home bucket of a key ID.  Key IDs differ mostly in their low ID bits, so mix
+ * them into the whole word before reducing */
+static int _IndexHome(whKeyId keyId)
+{
+    uint32_t h = (uint32_t)keyId * 0x9E3779B1u;
+    return (int)((h >> 16) % WOLFHSM_CFG_SERVER_KEYCACHE_INDEX_SIZE);
+}
+
+/* Find the bucket of keyId. Returns -1 if keyId is not indexed */
+static int _IndexFind(const whKeyCacheContext* ctx, whKeyId keyId)
+{
+    int pos = _IndexHome(keyId);
+    int n;
+
+    for (n = 0; n < WOLFHSM_CFG_SERVER_KEYCACHE_INDEX_SIZE; n++) {
+        if (ctx->index[pos].slot == 0) {
+            break;
+        }
+        if (ctx->index[pos].id == keyId) {
+            return pos;
+        }
+        pos = (pos + 1) % WOLFHSM_CFG_SERVER_KEYCACHE_INDEX_SIZE;
+    }
+    return -1;
+}
+
+/* Empty a bucket, shifting later entries of the probe run back so no
+ * tombstones are needed */
+static void _IndexRemoveAt(whKeyCacheContext* ctx, int pos)
+{
+    int next = pos;
+    int home;
+
+    ctx->indexId[ctx->index[pos].slot - 1] = WH_KEYID_ERASED;
+    while (1) {
+        next = (next + 1) % WOLFHSM_CFG_SERVER_KEYCACHE_INDEX_SIZE;
+        if (ctx->index[next].slot == 0) {
+            break;
+        }
+        /* An entry whose home lies cyclically in (pos, next] stays put */
+        home = _IndexHome(ctx->index[next].id);
+        if ((pos <= next) ? ((home > pos) && (home <= next))
+                          : ((home > pos) || (home <= next))) {
+            continue;
+        }
+        ctx->index[pos] = ctx->index[next];
+        pos             = next;
+    }
+    ctx->index[pos].id   = WH_KEYID_ERASED;
+    ctx->index[pos].slot = 0;
+}
+
+/* Index slot (0 based, regular slots first) under keyId, dropping whatever
+ * keyId and the slot were indexed under before */
+static void _IndexSet(whKeyCacheContext* ctx, whKeyId keyId, int slot)
+{
+    int pos;
+
+    if (ctx->indexId[slot] != WH_KEYID_ERASED) {
+        pos = _IndexFind(ctx, ctx->indexId[slot]);
+        if (pos >= 0) {
+            _IndexRemoveAt(ctx, pos);
+        }
+        ctx->indexId[slot] = WH_KEYID_ERASED;
+    }
+    if (keyId == WH_KEYID_ERASED) {
+        return;
+    }
+
+    pos = _IndexFind(ctx, keyId);
+    if (pos >= 0) {
+        /* Reserved before in a slot it was never stored in */
+        ctx->indexId[ctx->index[pos].slot - 1] = WH_KEYID_ERASED;
+    }
+    else {
+        /* There is always an empty bucket, as each slot has at most one */
+        pos = _IndexHome(keyId);
+        while (ctx->index[pos].slot != 0) {
+            pos = (pos + 1) % WOLFHSM_CFG_SERVER_KEYCACHE_INDEX_SIZE;
+        }
+        ctx->index[pos].id = keyId;
+    }
+    ctx->index[pos].slot = (uint16_t)(slot + 1);
+    ctx->indexId[slot]   = keyId;
+}
+
 /**
  * @brief Find a key in the specified cache context
  */
@@ -196,135 +366,433 @@ static int _FindInKeyCache(whKeyCacheContext* ctx, whKeyId keyId,
                            int* out_index, int* out_big, uint8_t** out_buffer,
                            whNvmMetadata** out_meta)
 {
-    int            ret = WH_ERROR_NOTFOUND;
-    int            i;
-    int            index  = -1;
-    int            big    = -1;
-    whNvmMetadata* meta   = NULL;
-    uint8_t*       buffer = NULL;
-
-    /* Search regular cache */
-    for (i = 0; i < WOLFHSM_CFG_SERVER_KEYCACHE_COUNT; i++) {
-        if (ctx->cache[i].meta->id == keyId) {
-            big    = 0;
-            index  = i;
-            meta   = ctx->cache[i].meta;
-            buffer = ctx->cache[i].buffer;
-            break;
+    int            pos;
+    int            slot;
+    int            index;
+    int            big;
+    whNvmMetadata* meta;
+
+    pos = _IndexFind(ctx, keyId);
+    if (pos < 0) {
+        return WH_ERROR_NOTFOUND;
+    }
+
+    slot = ctx->index[pos].slot - 1;
+    if (slot < WH_KEYCACHE_REGULAR_SLOTS) {
+        big   = 0;
+        index = slot;
+    }
+    else {
+        big   = 1;
+        index = slot - WH_KEYCACHE_REGULAR_SLOTS;
+    }
+    meta = _SlotMeta(ctx, index, big);
+
+    /* The slot may have been reserved for the key but never filled */
+    if (meta->id != keyId) {
+        return WH_ERROR_NOTFOUND;
+    }
+
+    /* Set output parameters */
+    if (out_index != NULL)
+        *out_index = index;
+    if (out_big != NULL)
+        *out_big = big;
+    if (out_meta != NULL)
+        *out_meta = meta;
+    if (out_buffer != NULL)
+        *out_buffer = _SlotBuffer(ctx, index, big);
+
+    return WH_ERROR_OK;
+}
+
+#ifdef WOLFHSM_CFG_SERVER_KEYCACHE_POOL
+/* Number of pool granules needed to hold len bytes, at least one */
+static uint16_t _PoolGranules(uint32_t len)
+{
+    uint32_t n = (len + WOLFHSM_CFG_SERVER_KEYCACHE_POOL_GRANULE - 1) /
+                 WOLFHSM_CFG_SERVER_KEYCACHE_POOL_GRANULE;
+    return (uint16_t)((n == 0) ? 1 : n);
+}
+
+static int _PoolInUse(const whKeyCacheContext* ctx, int granule)
+{
+    return (ctx->poolMap[granule / 8] >> (granule % 8)) & 1;
+}
+
+static void _PoolMark(whKeyCacheContext* ctx, int first, int count, int used)
+{
+    int i;
+
+    for (i = first; i < first + count; i++) {
+        if (used != 0) {
+            ctx->poolMap[i / 8] |= (uint8_t)(1 << (i % 8));
+        }
+        else {
+            ctx->poolMap[i / 8] &= (uint8_t)~(1 << (i % 8));
         }
     }
+}
 
-    /* Search big cache if not found */
-    if (index == -1) {
-        for (i = 0; i < WOLFHSM_CFG_SERVER_KEYCACHE_BIG_COUNT; i++) {
-            if (ctx->bigCache[i].meta->id == keyId) {
-                big    = 1;
-                index  = i;
-                meta   = ctx->bigCache[i].meta;
-                buffer = ctx->bigCache[i].buffer;
-                break;
+/* Release the pool granules of a slot */
+static void _PoolRelease(whKeyCacheContext* ctx, int index)
+{
+    _PoolMark(ctx, ctx->cache[index].offset, ctx->cache[index].granules, 0);
+    ctx->cache[index].offset   = 0;
+    ctx->cache[index].granules = 0;
+}
+
+/* Whether the pool space of a slot overlaps count granules at first */
+static int _PoolOverlaps(const whKeyCacheContext* ctx, int index, int first,
+                         int count)
+{
+    return (ctx->cache[index].granules != 0) &&
+           (ctx->cache[index].offset < first + count) &&
+           (ctx->cache[index].offset + ctx->cache[index].granules > first);
+}
+
+/* Number of keys that must be evicted to free count granules at first, or -1
+ * if a key holding space there is uncommitted or pinned */
+static int _PoolRunEvictions(const whKeyCacheContext* ctx, int first,
+                             int count)
+{
+    int evictions = 0;
+    int i;
+
+    for (i = 0; i < WOLFHSM_CFG_SERVER_KEYCACHE_POOL_KEYS; i++) {
+        if (_PoolOverlaps(ctx, i, first, count) == 0) {
+            continue;
+        }
+        if ((ctx->cache[i].committed != 1) || (ctx->cache[i].pinned != 0)) {
+            return -1;
+        }
+        evictions++;
+    }
+    return evictions;
+}
+
+/* Find count free granules in a row.  Keys of up to
+ * WOLFHSM_CFG_SERVER_KEYCACHE_BUFSIZE bytes are placed from the start of the
+ * pool and larger ones from the end, so they fragment each other less.
+ * Returns the first granule, or -1 if there is no such run */
+static int _PoolFind(const whKeyCacheContext* ctx, int count, int large)
+{
+    int run = 0;
+    int i;
+
+    if (large == 0) {
+        for (i = 0; i < WH_KEYCACHE_POOL_GRANULES; i++) {
+            run = _PoolInUse(ctx, i) ? 0 : run + 1;
+            if (run == count) {
+                return i - count + 1;
             }
         }
     }
+    else {
+        for (i = WH_KEYCACHE_POOL_GRANULES - 1; i >= 0; i--) {
+            run = _PoolInUse(ctx, i) ? 0 : run + 1;
+            if (run == count) {
+                return i;
+            }
+        }
+    }
+    return -1;
+}
+
+/* Find a run of count granules for a key, preferring a free one and otherwise
+ * the one that needs the fewest evictions, searched in the same direction.
+ * Returns the first granule and sets *out_evictions, or returns -1 if no run
+ * can be freed */
+static int _PoolPlan(const whKeyCacheContext* ctx, int count, int large,
+                     int* out_evictions)
+{
+    int best          = _PoolFind(ctx, count, large);
+    int bestEvictions = 0;
+    int first;
+    int evictions;
+    int i;
 
-    /* Set output parameters if found */
-    if (index != -1) {
-        if (out_index != NULL)
-            *out_index = index;
-        if (out_big != NULL)
-            *out_big = big;
-        if (out_meta != NULL)
-            *out_meta = meta;
-        if (out_buffer != NULL)
-            *out_buffer = buffer;
-        ret = WH_ERROR_OK;
+    if (best < 0) {
+        for (i = 0; i + count <= WH_KEYCACHE_POOL_GRANULES; i++) {
+            first = (large == 0) ? i : WH_KEYCACHE_POOL_GRANULES - count - i;
+            evictions = _PoolRunEvictions(ctx, first, count);
+            if ((evictions >= 0) &&
+                ((best < 0) || (evictions < bestEvictions))) {
+                best          = first;
+                bestEvictions = evictions;
+            }
+        }
     }
+    *out_evictions = bestEvictions;
+    return best;
+}
 
-    return ret;
+/* Give back the pool space a slot does not use.  Slots are reserved for the
+ * largest size a caller may write and filled with the actual length later, so
+ * trim them to their length, and release reservations that were never filled
+ */
+static void _PoolTrim(whKeyCacheContext* ctx)
+{
+    uint16_t need;
+    int      i;
+
+    for (i = 0; i < WOLFHSM_CFG_SERVER_KEYCACHE_POOL_KEYS; i++) {
+        if (ctx->cache[i].granules == 0) {
+            continue;
+        }
+        if (ctx->cache[i].meta->id == WH_KEYID_ERASED) {
+            _PoolRelease(ctx, i);
+            continue;
+        }
+        need = _PoolGranules(ctx->cache[i].meta->len);
+        if (need < ctx->cache[i].granules) {
+            _PoolMark(ctx, ctx->cache[i].offset + need,
+                      ctx->cache[i].granules - need, 0);
+            ctx->cache[i].granules = need;
+        }
+    }
 }
+#endif /* WOLFHSM_CFG_SERVER_KEYCACHE_POOL */
 
-static int _EvictSlot(uint8_t* buf, whNvmMetadata* meta)
+static int _EvictSlot(whKeyCacheContext* ctx, int index, int big)
 {
-    meta->id = WH_KEYID_ERASED;
-    memset(buf, 0, meta->len);
+    whNvmMetadata* meta = _SlotMeta(ctx, index, big);
+
+    memset(_SlotBuffer(ctx, index, big), 0, meta->len);
+    meta->id                         = WH_KEYID_ERASED;
+    *_SlotCommitted(ctx, index, big) = 0;
+    *_SlotPinned(ctx, index, big)    = 0;
+#ifdef WOLFHSM_CFG_SERVER_KEYCACHE_POOL
+    _PoolRelease(ctx, index);
+#endif
     return WH_ERROR_OK;
 }
 
 /**
- * @brief Get an available cache slot from the specified cache context
+ * @brief Record a use of a cached key for the eviction policy
  */
-static int _GetKeyCacheSlot(whKeyCacheContext* ctx, uint16_t keySz,
-                            uint8_t** outBuf, whNvmMetadata** outMeta)
+static void _TouchSlot(whKeyCacheContext* ctx, int index, int big)
 {
-    int foundIndex = -1;
+#if defined(WOLFHSM_CFG_SERVER_KEYCACHE_LRU)
     int i;
-    int            evictRet = WH_ERROR_OK;
-    uint8_t*       slotBuf  = NULL;
-    whNvmMetadata* slotMeta = NULL;
 
-    if (ctx == NULL) {
-        return WH_ERROR_BADARGS;
+    if (++ctx->tick == 0) {
+        /* Restart the ticks rather than let new uses look oldest */
+        for (i = 0; i < WH_KEYCACHE_REGULAR_SLOTS; i++) {
+            *_SlotUse(ctx, i, 0) = 0;
+        }
+        for (i = 0; i < WH_KEYCACHE_BIG_SLOTS; i++) {
+            *_SlotUse(ctx, i, 1) = 0;
+        }
+        ctx->tick = 1;
     }
+    *_SlotUse(ctx, index, big) = ctx->tick;
+#elif defined(WOLFHSM_CFG_SERVER_KEYCACHE_LFU)
+    uint32_t* use = _SlotUse(ctx, index, big);
 
-    /* Determine which cache to use based on key size */
-    if (keySz <= WOLFHSM_CFG_SERVER_KEYCACHE_BUFSIZE) {
-        /* Search regular cache for empty slot */
-        for (i = 0; i < WOLFHSM_CFG_SERVER_KEYCACHE_COUNT; i++) {
-            if (ctx->cache[i].meta->id == WH_KEYID_ERASED) {
-                foundIndex = i;
-                break;
-            }
-        }
+    if (*use < UINT32_MAX) {
+        (*use)++;
+    }
+#else
+    (void)ctx;
+    (void)index;
+    (void)big;
+#endif
+}
 
-        /* If no empty slots, find committed key to evict */
-        if (foundIndex == -1) {
-            for (i = 0; i < WOLFHSM_CFG_SERVER_KEYCACHE_COUNT; i++) {
-                if (ctx->cache[i].committed == 1) {
-                    evictRet =
-                        _EvictSlot(ctx->cache[i].buffer, ctx->cache[i].meta);
-                    if (evictRet == WH_ERROR_OK) {
-                        foundIndex = i;
-                        break;
-                    }
-                }
-            }
+/**
+ * @brief Choose the committed key to evict from a full cache array
+ *
+ * Returns the slot index in the regular (big == 0) or big cache, or -1 if no
+ * key in it is committed and unpinned.
+ */
+static int _PickVictim(whKeyCacheContext* ctx, int big)
+{
+    int victim = -1;
+    int count  = (big == 0) ? WH_KEYCACHE_REGULAR_SLOTS : WH_KEYCACHE_BIG_SLOTS;
+    int i;
+#if defined(WOLFHSM_CFG_SERVER_KEYCACHE_LRU) || \
+    defined(WOLFHSM_CFG_SERVER_KEYCACHE_LFU)
+    uint32_t use;
+    uint32_t best = 0;
+#endif
+
+    for (i = 0; i < count; i++) {
+        if ((*_SlotCommitted(ctx, i, big) != 1) ||
+            (*_SlotPinned(ctx, i, big) != 0)) {
+            continue;
         }
+#if defined(WOLFHSM_CFG_SERVER_KEYCACHE_LRU) || \
+    defined(WOLFHSM_CFG_SERVER_KEYCACHE_LFU)
+        use = *_SlotUse(ctx, i, big);
+        if ((victim < 0) || (use < best)) {
+            victim = i;
+            best   = use;
+        }
+#else
+        victim = i;
+        break;
+#endif
+    }
 
-        /* Zero slot and capture pointers */
-        if (foundIndex >= 0) {
-            memset(&ctx->cache[foundIndex], 0, sizeof(whCacheSlot));
-            slotBuf  = ctx->cache[foundIndex].buffer;
-            slotMeta = ctx->cache[foundIndex].meta;
+#ifdef WOLFHSM_CFG_SERVER_KEYCACHE_LFU
+    /* Age the counts so keys that were only used long ago can be evicted */
+    if (victim >= 0) {
+        for (i = 0; i < count; i++) {
+            *_SlotUse(ctx, i, big) >>= 1;
         }
     }
+#endif
+    return victim;
+}
+
+/* Evict the committed key in a slot picked as a victim, dropping any decoded
+ * copy of it so its key material does not outlive the cached bytes */
+static void _EvictVictim(whServerContext* server, whKeyCacheContext* ctx,
+                         int index, int big)
+{
+#ifdef WOLFHSM_CFG_SERVER_KEYCACHE_PARSED
+    wh_Server_ParsedKeyDrop(server, _SlotMeta(ctx, index, big)->id);
+#else
+    (void)server;
+#endif
+    _IndexSet(ctx, WH_KEYID_ERASED, _SlotNumber(index, big));
+    (void)_EvictSlot(ctx, index, big);
+    ctx->stats.evictions++;
+}
+
+/* Zero a slot, stamp it for the eviction policy and index it under keyId */
+static void _FillSlot(whKeyCacheContext* ctx, whKeyId keyId, int index,
+                      int big)
+{
+#ifdef WOLFHSM_CFG_SERVER_KEYCACHE_POOL
+    memset(&ctx->cache[index], 0, sizeof(whCacheSlot));
+#else
+    if (big == 0) {
+        memset(&ctx->cache[index], 0, sizeof(whCacheSlot));
+    }
     else {
-        /* Search big cache for empty slot */
-        for (i = 0; i < WOLFHSM_CFG_SERVER_KEYCACHE_BIG_COUNT; i++) {
-            if (ctx->bigCache[i].meta->id == WH_KEYID_ERASED) {
+        memset(&ctx->bigCache[index], 0, sizeof(whBigCacheSlot));
+    }
+#endif
+    _TouchSlot(ctx, index, big);
+#ifdef WOLFHSM_CFG_SERVER_KEYCACHE_PARSED
+    *_SlotGen(ctx, index, big) = ++ctx->gen;
+#endif
+    _IndexSet(ctx, keyId, _SlotNumber(index, big));
+}
+
+#ifdef WOLFHSM_CFG_SERVER_KEYCACHE_POOL
+/**
+ * @brief Get a cache slot with keySz bytes of pool space
+ *
+ * The run of pool space needing the fewest evictions is chosen first, and
+ * only the committed keys in it are evicted.  If no run can be freed, no key
+ * is evicted.
+ */
+static int _GetKeyCacheSlot(whServerContext* server, whKeyCacheContext* ctx,
+                            whKeyId keyId, uint16_t keySz, uint8_t** outBuf,
+                            whNvmMetadata** outMeta)
+{
+    uint16_t granules   = _PoolGranules(keySz);
+    int      large      = (keySz > WOLFHSM_CFG_SERVER_KEYCACHE_BUFSIZE);
+    int      foundIndex = -1;
+    int      evictions  = 0;
+    int      first;
+    int      i;
+
+    if (ctx == NULL) {
+        return WH_ERROR_BADARGS;
+    }
+
+    _PoolTrim(ctx);
+
+    first = _PoolPlan(ctx, granules, large, &evictions);
+    if (first < 0) {
+        return WH_ERROR_NOSPACE;
+    }
+
+    /* Search for an empty slot */
+    for (i = 0; i < WOLFHSM_CFG_SERVER_KEYCACHE_POOL_KEYS; i++) {
+        if (ctx->cache[i].meta->id == WH_KEYID_ERASED) {
+            foundIndex = i;
+            break;
+        }
+    }
+    if ((foundIndex == -1) && (evictions == 0)) {
+        /* The run is free but every slot is taken */
+        foundIndex = _PickVictim(ctx, 0);
+        if (foundIndex == -1) {
+            return WH_ERROR_NOSPACE;
+        }
+        _EvictVictim(server, ctx, foundIndex, 0);
+    }
+
+    /* Evict the keys in the run, reusing the first slot freed if needed */
+    for (i = 0; i < WOLFHSM_CFG_SERVER_KEYCACHE_POOL_KEYS; i++) {
+        if (_PoolOverlaps(ctx, i, first, granules) != 0) {
+            _EvictVictim(server, ctx, i, 0);
+            if (foundIndex == -1) {
                 foundIndex = i;
-                break;
             }
         }
+    }
 
-        /* If no empty slots, find committed key to evict */
-        if (foundIndex == -1) {
-            for (i = 0; i < WOLFHSM_CFG_SERVER_KEYCACHE_BIG_COUNT; i++) {
-                if (ctx->bigCache[i].committed == 1) {
-                    evictRet = _EvictSlot(ctx->bigCache[i].buffer,
-                                          ctx->bigCache[i].meta);
-                    if (evictRet == WH_ERROR_OK) {
-                        foundIndex = i;
-                        break;
-                    }
-                }
-            }
+    _FillSlot(ctx, keyId, foundIndex, 0);
+    ctx->cache[foundIndex].offset   = (uint16_t)first;
+    ctx->cache[foundIndex].granules = granules;
+    _PoolMark(ctx, first, granules, 1);
+
+    if (outBuf != NULL) {
+        *outBuf = _SlotBuffer(ctx, foundIndex, 0);
+    }
+    if (outMeta != NULL) {
+        *outMeta = ctx->cache[foundIndex].meta;
+    }
+
+    return WH_ERROR_OK;
+}
+#else
+/**
+ * @brief Get an available cache slot from the specified cache context
+ */
+static int _GetKeyCacheSlot(whServerContext* server, whKeyCacheContext* ctx,
+                            whKeyId keyId, uint16_t keySz, uint8_t** outBuf,
+                            whNvmMetadata** outMeta)
+{
+    int foundIndex = -1;
+    int big;
+    int count;
+    int i;
+
+    if (ctx == NULL) {
+        return WH_ERROR_BADARGS;
+    }
+
+    /* Determine which cache to use based on key size */
+    if (keySz <= WOLFHSM_CFG_SERVER_KEYCACHE_BUFSIZE) {
+        big   = 0;
+        count = WOLFHSM_CFG_SERVER_KEYCACHE_COUNT;
+    }
+    else {
+        big   = 1;
+        count = WOLFHSM_CFG_SERVER_KEYCACHE_BIG_COUNT;
+    }
+
+    /* Search for empty slot */
+    for (i = 0; i < count; i++) {
+        if (_SlotMeta(ctx, i, big)->id == WH_KEYID_ERASED) {
+            foundIndex = i;
+            break;
         }
+    }
 
-        /* Zero slot and capture pointers */
-        if (foundIndex >= 0) {
-            memset(&ctx->bigCache[foundIndex], 0, sizeof(whBigCacheSlot));
-            slotBuf  = ctx->bigCache[foundIndex].buffer;
-            slotMeta = ctx->bigCache[foundIndex].meta;
+    /* If no empty slots, find committed key to evict */
+    if (foundIndex == -1) {
+        i = _PickVictim(ctx, big);
+        if (i >= 0) {
+            _EvictVictim(server, ctx, i, big);
+            foundIndex = i;
         }
     }
 
@@ -332,16 +800,20 @@ static int _GetKeyCacheSlot(whKeyCacheContext* ctx, uint16_t keySz,
         return WH_ERROR_NOSPACE;
     }
 
+    /* Zero slot and capture pointers */
+    _FillSlot(ctx, keyId, foundIndex, big);
+
     /* Copy out pointers only if caller provided non-NULL output parameters */
     if (outBuf != NULL) {
-        *outBuf = slotBuf;
+        *outBuf = _SlotBuffer(ctx, foundIndex, big);
     }
     if (outMeta != NULL) {
-        *outMeta = slotMeta;
+        *outMeta = _SlotMeta(ctx, foundIndex, big);
     }
 
     return WH_ERROR_OK;
 }
+#endif /* WOLFHSM_CFG_SERVER_KEYCACHE_POOL */
 
 /**
  * @brief Evict a key from the specified cache context
@@ -349,13 +821,14 @@ static int _GetKeyCacheSlot(whKeyCacheContext* ctx, uint16_t keySz,
  */
 static int _EvictKeyFromCache(whKeyCacheContext* ctx, whKeyId keyId)
 {
-    whNvmMetadata* meta      = NULL;
-    uint8_t*       outBuffer = NULL;
+    int index = -1;
+    int big   = -1;
 
-    int ret = _FindInKeyCache(ctx, keyId, NULL, NULL, &outBuffer, &meta);
+    int ret = _FindInKeyCache(ctx, keyId, &index, &big, NULL, NULL);
 
-    if (ret == WH_ERROR_OK && meta != NULL) {
-        return _EvictSlot(outBuffer, meta);
+    if (ret == WH_ERROR_OK) {
+        _IndexSet(ctx, WH_KEYID_ERASED, _SlotNumber(index, big));
+        return _EvictSlot(ctx, index, big);
     }
 
     return ret;
@@ -372,17 +845,48 @@ static int _MarkKeyCommitted(whKeyCacheContext* ctx, whKeyId keyId,
     int ret   = _FindInKeyCache(ctx, keyId, &index, &big, NULL, NULL);
 
     if (ret == WH_ERROR_OK) {
-        if (big == 0) {
-            ctx->cache[index].committed = committed;
-        }
-        else {
-            ctx->bigCache[index].committed = committed;
-        }
+        *_SlotCommitted(ctx, index, big) = (uint8_t)committed;
     }
 
     return ret;
 }
 
+/* Find the highest free crypto key ID of a user from the NVM key ID map and the
+ * IDs indexed in the cache, without searching the cache or the NVM directory */
+static int _GetUniqueIdFromMap(whNvmContext* nvm, whKeyCacheContext* ctx,
+                               int user, whNvmId* inout_id)
+{
+    uint32_t used[WH_NVM_KEYID_MAP_WORDS];
+    whKeyId  id;
+    int      i;
+    int      bit;
+
+    memcpy(used, nvm->keyIdMap[user], sizeof(used));
+    for (i = 0; i < WH_KEYCACHE_SLOT_COUNT; i++) {
+        id = ctx->indexId[i];
+        if ((id != WH_KEYID_ERASED) &&
+            (WH_KEYID_TYPE(id) == WH_KEYTYPE_CRYPTO) &&
+            (WH_KEYID_USER(id) == user)) {
+            used[WH_KEYID_ID(id) / 32] |= (uint32_t)1 << (WH_KEYID_ID(id) % 32);
+        }
+    }
+
+    for (i = WH_NVM_KEYID_MAP_WORDS - 1; i >= 0; i--) {
+        if (used[i] == 0xFFFFFFFFu) {
+            continue;
+        }
+        for (bit = 31; bit >= 0; bit--) {
+            id = (whKeyId)(i * 32 + bit);
+            if ((id > WH_KEYID_ERASED) && (id <= WH_KEYID_IDMAX) &&
+                ((used[i] & ((uint32_t)1 << bit)) == 0)) {
+                *inout_id = WH_MAKE_KEYID(WH_KEYTYPE_CRYPTO, user, id);
+                return WH_ERROR_OK;
+            }
+        }
+    }
+    return WH_ERROR_NOSPACE;
+}
+
 int wh_Server_KeystoreGetUniqueId(whServerContext* server, whNvmId* inout_id)
 {
     int     ret   = WH_ERROR_OK;
@@ -401,6 +905,11 @@ int wh_Server_KeystoreGetUniqueId(whServerContext* server, whNvmId* inout_id)
         return WH_ERROR_BADARGS;
     }
 
+    if ((type == WH_KEYTYPE_CRYPTO) && (server->nvm != NULL) &&
+        (server->nvm->keyIdMapValid != 0)) {
+        return _GetUniqueIdFromMap(server->nvm, ctx, user, inout_id);
+    }
+
     /* try every index until we find a unique one, don't worry about capacity */
     for (id = WH_KEYID_IDMAX; id > WH_KEYID_ERASED; id--) {
         /* id loop var is not an input client ID so we don't need to handle the
@@ -470,7 +979,7 @@ int wh_Server_KeystoreGetCacheSlot(whServerContext* server, whKeyId keyId,
     }
 
     ctx = _GetCacheContext(server, keyId);
-    return _GetKeyCacheSlot(ctx, keySz, outBuf, outMeta);
+    return _GetKeyCacheSlot(server, ctx, keyId, keySz, outBuf, outMeta);
 }
 
 int wh_Server_KeystoreGetCacheSlotChecked(whServerContext* server,
@@ -545,6 +1054,27 @@ static int _FindInCache(whServerContext* server, whKeyId keyId, int* out_index,
                            out_meta);
 }
 
+/* Find a key that is about to be used, counting the lookup in the cache
+ * statistics and recording the use for the eviction policy */
+static int _FindForUse(whServerContext* server, whKeyId keyId,
+                       uint8_t** out_buffer, whNvmMetadata** out_meta)
+{
+    whKeyCacheContext* ctx   = _GetCacheContext(server, keyId);
+    int                index = -1;
+    int                big   = -1;
+    int                ret;
+
+    ret = _FindInKeyCache(ctx, keyId, &index, &big, out_buffer, out_meta);
+    if (ret == WH_ERROR_OK) {
+        ctx->stats.hits++;
+        _TouchSlot(ctx, index, big);
+    }
+    else if (ret == WH_ERROR_NOTFOUND) {
+        ctx->stats.misses++;
+    }
+    return ret;
+}
+
 #ifdef WOLFHSM_CFG_KEYWRAP
 static int _ExistsInCache(whServerContext* server, whKeyId keyId)
 {
@@ -573,8 +1103,6 @@ int wh_Server_KeystoreFreshenKey(whServerContext* server, whKeyId keyId,
                                  uint8_t** outBuf, whNvmMetadata** outMeta)
 {
     int             ret            = 0;
-    int             foundIndex     = -1;
-    int             foundBigIndex  = -1;
     uint8_t*        cacheBufLocal  = NULL;
     whNvmMetadata*  cacheMetaLocal = NULL;
     uint8_t**       cacheBufOut;
@@ -589,8 +1117,7 @@ int wh_Server_KeystoreFreshenKey(whServerContext* server, whKeyId keyId,
     cacheBufOut  = (outBuf != NULL) ? outBuf : (uint8_t**)&cacheBufLocal;
     cacheMetaOut = (outMeta != NULL) ? outMeta : &cacheMetaLocal;
 
-    ret = _FindInCache(server, keyId, &foundIndex, &foundBigIndex, cacheBufOut,
-                       cacheMetaOut);
+    ret = _FindForUse(server, keyId, cacheBufOut, cacheMetaOut);
     if (ret != WH_ERROR_NOTFOUND) {
         return ret;
     }
@@ -645,7 +1172,7 @@ int wh_Server_KeystoreReadKey(whServerContext* server, whKeyId keyId,
     }
 
     /* Check the cache using unified function */
-    ret = _FindInCache(server, keyId, NULL, NULL, &cacheBuffer, &cacheMeta);
+    ret = _FindForUse(server, keyId, &cacheBuffer, &cacheMeta);
     if (ret == WH_ERROR_OK) {
         /* Found in cache */
         if (cacheMeta->len > *outSz)
@@ -717,6 +1244,74 @@ int wh_Server_KeystoreReadKeyChecked(whServerContext* server, whKeyId keyId,
     return wh_Server_KeystoreReadKey(server, keyId, outMeta, out, outSz);
 }
 
+#ifdef WOLFHSM_CFG_SERVER_KEYCACHE_PARSED
+int wh_Server_KeystoreGetCacheGen(whServerContext* server, whKeyId keyId,
+                                  uint32_t* out_gen)
+{
+    whKeyCacheContext* ctx;
+    int                ret;
+    int                index = -1;
+    int                big   = -1;
+
+    if ((server == NULL) || (out_gen == NULL) || WH_KEYID_ISERASED(keyId)) {
+        return WH_ERROR_BADARGS;
+    }
+
+    ctx = _GetCacheContext(server, keyId);
+    ret = _FindInKeyCache(ctx, keyId, &index, &big, NULL, NULL);
+    if (ret == WH_ERROR_OK) {
+        *out_gen = *_SlotGen(ctx, index, big);
+    }
+    return ret;
+}
+#endif /* WOLFHSM_CFG_SERVER_KEYCACHE_PARSED */
+
+/* Cache holding keys of the given scope */
+static whKeyCacheContext* _GetScopeCacheContext(whServerContext* server,
+                                                int              global)
+{
+#ifdef WOLFHSM_CFG_GLOBAL_KEYS
+    if (global != 0) {
+        return &server->nvm->globalCache;
+    }
+#endif
+    (void)global;
+    return &server->localCache;
+}
+
+int wh_Server_KeystoreGetCacheStats(whServerContext* server, int global,
+                                    whKeyCacheStats* out_stats)
+{
+    if ((server == NULL) || (out_stats == NULL)) {
+        return WH_ERROR_BADARGS;
+    }
+#ifndef WOLFHSM_CFG_GLOBAL_KEYS
+    if (global != 0) {
+        return WH_ERROR_BADARGS;
+    }
+#endif
+
+    memcpy(out_stats, &_GetScopeCacheContext(server, global)->stats,
+           sizeof(*out_stats));
+    return WH_ERROR_OK;
+}
+
+int wh_Server_KeystoreResetCacheStats(whServerContext* server, int global)
+{
+    if (server == NULL) {
+        return WH_ERROR_BADARGS;
+    }
+#ifndef WOLFHSM_CFG_GLOBAL_KEYS
+    if (global != 0) {
+        return WH_ERROR_BADARGS;
+    }
+#endif
+
+    memset(&_GetScopeCacheContext(server, global)->stats, 0,
+           sizeof(whKeyCacheStats));
+    return WH_ERROR_OK;
+}
+
 int wh_Server_KeystoreEvictKey(whServerContext* server, whNvmId keyId)
 {
     int                ret = 0;
@@ -732,6 +1327,11 @@ int wh_Server_KeystoreEvictKey(whServerContext* server, whNvmId keyId)
     /* Use the unified evict function */
     ret = _EvictKeyFromCache(ctx, keyId);
 
+#ifdef WOLFHSM_CFG_SERVER_KEYCACHE_PARSED
+    /* Don't leave a decoded copy of the evicted key behind */
+    wh_Server_ParsedKeyDrop(server, keyId);
+#endif
+
     if (ret == 0) {
         WH_DEBUG_SERVER_VERBOSE("wh_Server_KeystoreEvictKey: evicted keyid=0x%X\n",
                keyId);
@@ -895,6 +1495,178 @@ int wh_Server_KeystoreRevokeKey(whServerContext* server, whNvmId keyId)
     return ret;
 }
 
+/* Number of keys in a cache pinned with the given pin value */
+static int _CountPins(whKeyCacheContext* ctx, uint16_t pin)
+{
+    int count = 0;
+    int i;
+
+    for (i = 0; i < WH_KEYCACHE_REGULAR_SLOTS; i++) {
+        if (*_SlotPinned(ctx, i, 0) == pin) {
+            count++;
+        }
+    }
+    for (i = 0; i < WH_KEYCACHE_BIG_SLOTS; i++) {
+        if (*_SlotPinned(ctx, i, 1) == pin) {
+            count++;
+        }
+    }
+    return count;
+}
+
+/* Unpin every key in a cache pinned with the given pin value */
+static void _ClearPins(whKeyCacheContext* ctx, uint16_t pin)
+{
+    int i;
+
+    for (i = 0; i < WH_KEYCACHE_REGULAR_SLOTS; i++) {
+        if (*_SlotPinned(ctx, i, 0) == pin) {
+            *_SlotPinned(ctx, i, 0) = 0;
+        }
+    }
+    for (i = 0; i < WH_KEYCACHE_BIG_SLOTS; i++) {
+        if (*_SlotPinned(ctx, i, 1) == pin) {
+            *_SlotPinned(ctx, i, 1) = 0;
+        }
+    }
+}
+
+int wh_Server_KeystorePinKey(whServerContext* server, whKeyId keyId)
+{
+    whKeyCacheContext* ctx;
+    uint16_t*          pinned;
+    uint16_t           pin;
+    int                index = -1;
+    int                big   = -1;
+    uint8_t            ids[WH_SERVER_CONNECTION_CLIENTS];
+    int                clients;
+    int                count;
+    int                ret;
+    int                i;
+
+    if ((server == NULL) || WH_KEYID_ISERASED(keyId)) {
+        return WH_ERROR_BADARGS;
+    }
+    pin = (uint16_t)(server->comm->client_id + 1);
+
+    /* Load the key from NVM if it is not cached */
+    ret = wh_Server_KeystoreFreshenKey(server, keyId, NULL, NULL);
+    if (ret != WH_ERROR_OK) {
+        return ret;
+    }
+
+    ctx = _GetCacheContext(server, keyId);
+    ret = _FindInKeyCache(ctx, keyId, &index, &big, NULL, NULL);
+    if (ret != WH_ERROR_OK) {
+        return ret;
+    }
+
+    pinned = _SlotPinned(ctx, index, big);
+    if (*pinned == pin) {
+        return WH_ERROR_OK;
+    }
+    if (*pinned != 0) {
+        /* Pinned by another client sharing the global cache */
+        return WH_ERROR_ACCESS;
+    }
+
+    /* Count the keys the clients of this connection, its own and those of
+     * its sessions, pinned in the local and the global cache. Sessions share
+     * the local cache, so together they may not pin more than one client */
+    count   = 0;
+    clients = wh_Server_GetConnectionClients(server, ids);
+    for (i = 0; i < clients; i++) {
+        count += _CountPins(&server->localCache, (uint16_t)(ids[i] + 1));
+#ifdef WOLFHSM_CFG_GLOBAL_KEYS
+        count += _CountPins(&server->nvm->globalCache, (uint16_t)(ids[i] + 1));
+#endif
+    }
+    if (count >= WOLFHSM_CFG_SERVER_KEYCACHE_PIN_MAX) {
+        return WH_ERROR_NOSPACE;
+    }
+
+    *pinned = pin;
+    WH_DEBUG_SERVER_VERBOSE("wh_Server_KeystorePinKey: pinned keyid=0x%X\n",
+                            keyId);
+    return WH_ERROR_OK;
+}
+
+int wh_Server_KeystoreUnpinKey(whServerContext* server, whKeyId keyId)
+{
+    whKeyCacheContext* ctx;
+    uint16_t*          pinned;
+    int                index = -1;
+    int                big   = -1;
+    int                ret;
+
+    if ((server == NULL) || WH_KEYID_ISERASED(keyId)) {
+        return WH_ERROR_BADARGS;
+    }
+
+    ctx = _GetCacheContext(server, keyId);
+    ret = _FindInKeyCache(ctx, keyId, &index, &big, NULL, NULL);
+    if (ret != WH_ERROR_OK) {
+        return ret;
+    }
+
+    pinned = _SlotPinned(ctx, index, big);
+    if ((*pinned != 0) &&
+        (*pinned != (uint16_t)(server->comm->client_id + 1))) {
+        return WH_ERROR_ACCESS;
+    }
+    *pinned = 0;
+    return WH_ERROR_OK;
+}
+
+int wh_Server_KeystoreUnpinClient(whServerContext* server, uint8_t clientId)
+{
+    uint16_t pin;
+
+    if (server == NULL) {
+        return WH_ERROR_BADARGS;
+    }
+    pin = (uint16_t)(clientId + 1);
+
+    _ClearPins(&server->localCache, pin);
+#ifdef WOLFHSM_CFG_GLOBAL_KEYS
+    if (server->nvm != NULL) {
+        _ClearPins(&server->nvm->globalCache, pin);
+    }
+#endif
+    return WH_ERROR_OK;
+}
+
+int wh_Server_KeystoreEvictClient(whServerContext* server, uint8_t clientId)
+{
+    whKeyCacheContext* ctx;
+    whNvmMetadata*     meta;
+    int                big;
+    int                count;
+    int                i;
+
+    if (server == NULL) {
+        return WH_ERROR_BADARGS;
+    }
+    ctx = &server->localCache;
+
+    for (big = 0; big < 2; big++) {
+        count = (big == 0) ? WH_KEYCACHE_REGULAR_SLOTS : WH_KEYCACHE_BIG_SLOTS;
+        for (i = 0; i < count; i++) {
+            meta = _SlotMeta(ctx, i, big);
+            if ((meta->id == WH_KEYID_ERASED) ||
+                (WH_KEYID_USER(meta->id) != clientId)) {
+                continue;
+            }
+#ifdef WOLFHSM_CFG_SERVER_KEYCACHE_PARSED
+            wh_Server_ParsedKeyDrop(server, meta->id);
+#endif
+            _IndexSet(ctx, WH_KEYID_ERASED, _SlotNumber(i, big));
+            (void)_EvictSlot(ctx, i, big);
+        }
+    }
+    return WH_ERROR_OK;
+}
+
 #ifdef WOLFHSM_CFG_KEYWRAP
 
 #ifndef NO_AES
@@ -1846,6 +2618,34 @@ int wh_Server_HandleKeyRequest(whServerContext* server, uint16_t magic,
             *out_resp_size = sizeof(resp);
         } break;
 
+        case WH_KEY_PIN: {
+            whMessageKeystore_PinRequest  req;
+            whMessageKeystore_PinResponse resp;
+            whKeyId                       keyId;
+
+            (void)wh_MessageKeystore_TranslatePinRequest(
+                magic, (whMessageKeystore_PinRequest*)req_packet, &req);
+
+            ret = WH_SERVER_NVM_LOCK(server);
+            if (ret == WH_ERROR_OK) {
+                keyId = wh_KeyId_TranslateFromClient(
+                    WH_KEYTYPE_CRYPTO, server->comm->client_id, req.id);
+                if (req.pin != 0) {
+                    ret = wh_Server_KeystorePinKey(server, keyId);
+                }
+                else {
+                    ret = wh_Server_KeystoreUnpinKey(server, keyId);
+                }
+
+                (void)WH_SERVER_NVM_UNLOCK(server);
+            } /* WH_SERVER_NVM_LOCK() */
+            resp.rc = ret;
+
+            (void)wh_MessageKeystore_TranslatePinResponse(
+                magic, &resp, (whMessageKeystore_PinResponse*)resp_packet);
+            *out_resp_size = sizeof(resp);
+        } break;
+
         case WH_KEY_EXPORT: {
             whMessageKeystore_ExportRequest  req;
             whMessageKeystore_ExportResponse resp = {0};
@@ -1857,7 +2657,7 @@ int wh_Server_HandleKeyRequest(whServerContext* server, uint16_t magic,
 
             /* out is after fixed size fields */
             out   = (uint8_t*)resp_packet + sizeof(resp);
-            keySz = WOLFHSM_CFG_COMM_DATA_LEN - sizeof(resp);
+            keySz = wh_CommServer_GetMaxDataLen(server->comm) - sizeof(resp);
 
             resp.len = 0;
             ret      = WH_SERVER_NVM_LOCK(server);
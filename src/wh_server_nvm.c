@@ -55,7 +55,9 @@ static int _HandleNvmRead(whServerContext* server, uint8_t* out_data,
         return WH_ERROR_BADARGS;
     }
 
-    if (len > WH_MESSAGE_NVM_MAX_READ_LEN) {
+    /* Reads may fill a reassembled response when the channel fragments */
+    if (len > wh_CommServer_GetMaxDataLen(server->comm) -
+                  sizeof(whMessageNvm_ReadResponse)) {
         return WH_ERROR_ABORTED;
     }
 
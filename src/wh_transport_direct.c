@@ -0,0 +1,265 @@
+/*
+ * Copyright (C) 2025 wolfSSL Inc.
+ *
+ * This file is part of wolfHSM.
+ *
+ * wolfHSM is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * wolfHSM is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with wolfHSM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/*
+ * src/wh_transport_direct.c
+ *
+ * Implementation of transport callbacks that dispatch requests directly to a
+ * server in the same process
+ */
+
+/* Pick up compile-time configuration */
+#include "wolfhsm/wh_settings.h"
+
+#if defined(WOLFHSM_CFG_ENABLE_CLIENT) && defined(WOLFHSM_CFG_ENABLE_SERVER)
+
+#include <stddef.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "wolfhsm/wh_error.h"
+#include "wolfhsm/wh_comm.h"
+#include "wolfhsm/wh_server.h"
+
+#include "wolfhsm/wh_transport_direct.h"
+
+/* Both sides share the context, so only the first Init resets it */
+static int _Init(whTransportDirectContext* context,
+        const whTransportDirectConfig* config)
+{
+    if (    (context == NULL) ||
+            (config == NULL) ||
+            (config->server == NULL)) {
+        return WH_ERROR_BADARGS;
+    }
+
+    if (context->initialized == 0) {
+        memset(context, 0, sizeof(*context));
+        context->server = config->server;
+    }
+    else if (context->server != config->server) {
+        return WH_ERROR_BADARGS;
+    }
+    context->initialized = 1;
+
+    return WH_ERROR_OK;
+}
+
+/* Let the server handle a pending request.  A server that is not ready leaves
+ * the request pending to be dispatched on the next call. */
+static int _Dispatch(whTransportDirectContext* context)
+{
+    int rc = wh_Server_HandleRequestMessage(context->server);
+    if (rc == WH_ERROR_NOTREADY) {
+        rc = WH_ERROR_OK;
+    }
+    return rc;
+}
+
+int wh_TransportDirect_InitConnect(void* c, const void* cf,
+        whCommSetConnectedCb connectcb, void* connectcb_arg)
+{
+    whTransportDirectContext* context = c;
+    int rc;
+
+    (void)connectcb; (void)connectcb_arg; /* Not used */
+
+    rc = _Init(context, cf);
+    if (rc == WH_ERROR_OK) {
+        rc = wh_Server_SetConnected(context->server, WH_COMM_CONNECTED);
+    }
+    return rc;
+}
+
+int wh_TransportDirect_InitListen(void* c, const void* cf,
+        whCommSetConnectedCb connectcb, void* connectcb_arg)
+{
+    (void)connectcb; (void)connectcb_arg; /* Not used */
+
+    return _Init(c, cf);
+}
+
+int wh_TransportDirect_CleanupConnect(void* c)
+{
+    whTransportDirectContext* context = c;
+    if (context == NULL) {
+        return WH_ERROR_BADARGS;
+    }
+
+    if (context->initialized != 0) {
+        (void)wh_Server_SetConnected(context->server, WH_COMM_DISCONNECTED);
+    }
+    context->initialized = 0;
+
+    return 0;
+}
+
+int wh_TransportDirect_CleanupListen(void* c)
+{
+    whTransportDirectContext* context = c;
+    if (context == NULL) {
+        return WH_ERROR_BADARGS;
+    }
+
+    context->initialized = 0;
+
+    return 0;
+}
+
+int wh_TransportDirect_SendRequest(void* c, uint16_t len, const void* data)
+{
+    whTransportDirectContext* context = c;
+
+    if (    (context == NULL) ||
+            (context->initialized == 0) ||
+            (data == NULL && len != 0) ||
+            (len > sizeof(context->buffer))) {
+        return WH_ERROR_BADARGS;
+    }
+
+    /* The buffer holds a request or response that has not been received */
+    if ((context->req_ready != 0) || (context->resp_ready != 0)) {
+        return WH_ERROR_NOTREADY;
+    }
+
+    if ((data != NULL) && (len != 0) && (data != (void*)context->buffer)) {
+        memcpy(context->buffer, data, len);
+    }
+    context->len       = len;
+    context->req_ready = 1;
+
+    return _Dispatch(context);
+}
+
+int wh_TransportDirect_GetSendBuffer(void* c, uint16_t* out_size,
+        void** out_buffer)
+{
+    whTransportDirectContext* context = c;
+
+    if (    (context == NULL) ||
+            (context->initialized == 0) ||
+            (out_size == NULL) ||
+            (out_buffer == NULL)) {
+        return WH_ERROR_BADARGS;
+    }
+
+    if ((context->req_ready != 0) || (context->resp_ready != 0)) {
+        return WH_ERROR_NOTREADY;
+    }
+
+    *out_buffer = context->buffer;
+    *out_size   = sizeof(context->buffer);
+    return 0;
+}
+
+int wh_TransportDirect_RecvResponse(void* c, uint16_t* out_len, void* data)
+{
+    whTransportDirectContext* context = c;
+    int rc;
+
+    if (    (context == NULL) ||
+            (context->initialized == 0)) {
+        return WH_ERROR_BADARGS;
+    }
+
+    /* Retry a request the server was not ready for */
+    if (context->req_ready != 0) {
+        rc = _Dispatch(context);
+        if (rc != WH_ERROR_OK) {
+            return rc;
+        }
+    }
+
+    if (context->resp_ready == 0) {
+        return WH_ERROR_NOTREADY;
+    }
+
+    if ((data != NULL) && (context->len != 0)) {
+        memcpy(data, context->buffer, context->len);
+    }
+    if (out_len != NULL) {
+        *out_len = context->len;
+    }
+    context->resp_ready = 0;
+
+    return 0;
+}
+
+int wh_TransportDirect_RecvRequest(void* c, uint16_t* out_len, void* data)
+{
+    whTransportDirectContext* context = c;
+
+    if (    (context == NULL) ||
+            (context->initialized == 0)) {
+        return WH_ERROR_BADARGS;
+    }
+
+    if (context->req_ready == 0) {
+        return WH_ERROR_NOTREADY;
+    }
+
+    if (    (data != NULL) &&
+            (context->len != 0) &&
+            (data != (void*)context->buffer)) {
+        memcpy(data, context->buffer, context->len);
+    }
+    if (out_len != NULL) {
+        *out_len = context->len;
+    }
+    context->req_ready = 0;
+
+    return 0;
+}
+
+int wh_TransportDirect_SendResponse(void* c, uint16_t len, const void* data)
+{
+    whTransportDirectContext* context = c;
+
+    if (    (context == NULL) ||
+            (context->initialized == 0) ||
+            (data == NULL && len != 0) ||
+            (len > sizeof(context->buffer))) {
+        return WH_ERROR_BADARGS;
+    }
+
+    if ((data != NULL) && (len != 0) && (data != (void*)context->buffer)) {
+        memcpy(context->buffer, data, len);
+    }
+    context->len        = len;
+    context->resp_ready = 1;
+
+    return 0;
+}
+
+int wh_TransportDirect_GetBuffer(void* c, uint16_t* out_size,
+        void** out_buffer)
+{
+    whTransportDirectContext* context = c;
+
+    if (    (context == NULL) ||
+            (out_size == NULL) ||
+            (out_buffer == NULL)) {
+        return WH_ERROR_BADARGS;
+    }
+
+    *out_buffer = context->buffer;
+    *out_size   = sizeof(context->buffer);
+    return 0;
+}
+
+#endif /* WOLFHSM_CFG_ENABLE_CLIENT && WOLFHSM_CFG_ENABLE_SERVER */
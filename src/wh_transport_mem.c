@@ -41,6 +41,9 @@ int wh_TransportMem_Init(void* c, const void* cf,
     (void)connectcb; (void)connectcb_arg; /* Not used */
 
     whTransportMemContext* context = c;
+    uint16_t csr_size = sizeof(whTransportMemCsr);
+    uint16_t req_data_size;
+    uint16_t resp_data_size;
 
     const whTransportMemConfig* config = cf;
     if (    (context == NULL) ||
@@ -52,14 +55,41 @@ int wh_TransportMem_Init(void* c, const void* cf,
         return WH_ERROR_BADARGS;
     }
 
+    if (config->csr_size != 0) {
+        /* Padded layout: the CSR and the data each start on a csr_size line */
+        csr_size = config->csr_size;
+        if (    (csr_size < sizeof(whTransportMemCsr)) ||
+                ((csr_size & (csr_size - 1)) != 0) ||
+                (((uintptr_t)config->req & (csr_size - 1)) != 0) ||
+                (((uintptr_t)config->resp & (csr_size - 1)) != 0)) {
+            return WH_ERROR_BADARGS;
+        }
+    }
+
+    if (    (config->req_size <= csr_size) ||
+            (config->resp_size <= csr_size)) {
+        return WH_ERROR_BADARGS;
+    }
+    req_data_size   = config->req_size - csr_size;
+    resp_data_size  = config->resp_size - csr_size;
+    if (config->csr_size != 0) {
+        req_data_size  &= ~(uint16_t)(csr_size - 1);
+        resp_data_size &= ~(uint16_t)(csr_size - 1);
+        if ((req_data_size == 0) || (resp_data_size == 0)) {
+            return WH_ERROR_BADARGS;
+        }
+    }
+
     wh_Utils_memset_flush(context, 0, sizeof(*context));
     context->req            = (whTransportMemCsr*)config->req;
     context->req_size       = config->req_size;
-    context->req_data       = (void*)(context->req + 1);
+    context->req_data       = (void*)((uint8_t*)config->req + csr_size);
+    context->req_data_size  = req_data_size;
 
     context->resp           = (whTransportMemCsr*)config->resp;
     context->resp_size      = config->resp_size;
-    context->resp_data      = (void*)(context->resp + 1);
+    context->resp_data      = (void*)((uint8_t*)config->resp + csr_size);
+    context->resp_data_size = resp_data_size;
 
     context->initialized = 1;
     XMEMFENCE();
@@ -111,7 +141,7 @@ int wh_TransportMem_SendRequest(void* c, uint16_t len, const void* data)
     ctx_resp = context->resp;
 
     /* Don't send more data than we have space for in the request buffer */
-    if (len > (context->req_size - sizeof(whTransportMemCsr))) {
+    if (len > context->req_data_size) {
         return WH_ERROR_BADARGS;
     }
 
@@ -127,10 +157,18 @@ int wh_TransportMem_SendRequest(void* c, uint16_t len, const void* data)
     }
 
     if ((data != NULL) && (len != 0)) {
-        wh_Utils_memcpy_flush((void*)context->req_data, data, len);
+        if (data == context->req_data) {
+            /* Built in place with GetSendBuffer */
+            wh_Utils_CacheFlush((void*)context->req_data, len);
+        }
+        else {
+            wh_Utils_memcpy_flush((void*)context->req_data, data, len);
+        }
     }
 
     req.s.len = len;
+    /* A cancel of the previous request must not match the new one */
+    req.s.cancel = req.s.notify;
     req.s.notify++;
 
     /* Write the new CSR's */
@@ -142,6 +180,79 @@ int wh_TransportMem_SendRequest(void* c, uint16_t len, const void* data)
     return 0;
 }
 
+int wh_TransportMem_GetSendBuffer(void* c, uint16_t* out_size,
+        void** out_buffer)
+{
+    whTransportMemContext* context = c;
+    volatile whTransportMemCsr* ctx_req;
+    volatile whTransportMemCsr* ctx_resp;
+    whTransportMemCsr resp;
+    whTransportMemCsr req;
+
+    if (    (context == NULL) ||
+            (context->initialized == 0) ||
+            (out_size == NULL) ||
+            (out_buffer == NULL)) {
+        return WH_ERROR_BADARGS;
+    }
+
+    ctx_req  = context->req;
+    ctx_resp = context->resp;
+
+    /* Read current CSR's. ctx_req does not need to be invalidated */
+    XMEMFENCE();
+    XCACHEINVLD(ctx_resp);
+    resp.u64 = ctx_resp->u64;
+    req.u64 = ctx_req->u64;
+
+    /* The server may still be reading the previous request */
+    if (req.s.notify != resp.s.notify) {
+        return WH_ERROR_NOTREADY;
+    }
+
+    *out_buffer = context->req_data;
+    *out_size   = context->req_data_size;
+    return 0;
+}
+
+int wh_TransportMem_CancelRequest(void* c)
+{
+    whTransportMemContext* context = c;
+    volatile whTransportMemCsr* ctx_req;
+    volatile whTransportMemCsr* ctx_resp;
+    whTransportMemCsr resp;
+    whTransportMemCsr req;
+
+    if (    (context == NULL) ||
+            (context->initialized == 0)) {
+        return WH_ERROR_BADARGS;
+    }
+
+    ctx_req  = context->req;
+    ctx_resp = context->resp;
+
+    /* Read current CSR's. ctx_req does not need to be invalidated */
+    XMEMFENCE();
+    XCACHEINVLD(ctx_resp);
+    resp.u64 = ctx_resp->u64;
+    req.u64 = ctx_req->u64;
+
+    /* Is a request outstanding */
+    if (req.s.notify == resp.s.notify) {
+        return WH_ERROR_NOTREADY;
+    }
+
+    req.s.cancel = req.s.notify;
+
+    /* Write the new CSR's */
+    ctx_req->u64 = req.u64;
+    /*Ensure the update to the CSR is complete */
+    XMEMFENCE();
+    XCACHEFLUSH(ctx_req);
+
+    return 0;
+}
+
 int wh_TransportMem_RecvResponse(void* c, uint16_t* out_len, void* data)
 {
     whTransportMemContext* context = c;
@@ -169,6 +280,11 @@ int wh_TransportMem_RecvResponse(void* c, uint16_t* out_len, void* data)
         return WH_ERROR_NOTREADY;
     }
 
+    /* A zero length completion carries no response */
+    if (resp.s.len == 0) {
+        return WH_ERROR_NOTREADY;
+    }
+
     if ((data != NULL) && (resp.s.len != 0)) {
         wh_Utils_memcpy_invalidate(data, context->resp_data, resp.s.len);
     }
@@ -200,7 +316,7 @@ int wh_TransportMem_SendResponse(void* c, uint16_t len, const void* data)
     ctx_resp = context->resp;
 
     /* Check against available data space (total size minus CSR size) */
-    if (len > (context->resp_size - sizeof(whTransportMemCsr))) {
+    if (len > context->resp_data_size) {
         return WH_ERROR_BADARGS;
     }
 
@@ -226,6 +342,42 @@ int wh_TransportMem_SendResponse(void* c, uint16_t len, const void* data)
     return 0;
 }
 
+int wh_TransportMem_CompleteRequest(void* c)
+{
+    /* Release the request buffer with an empty completion */
+    return wh_TransportMem_SendResponse(c, 0, NULL);
+}
+
+int wh_TransportMem_CheckCanceled(void* c)
+{
+    whTransportMemContext* context = c;
+    volatile whTransportMemCsr* ctx_req;
+    volatile whTransportMemCsr* ctx_resp;
+    whTransportMemCsr req;
+    whTransportMemCsr resp;
+
+    if (    (context == NULL) ||
+            (context->initialized == 0)) {
+        return WH_ERROR_BADARGS;
+    }
+
+    ctx_req  = context->req;
+    ctx_resp = context->resp;
+
+    /* Read both CSR's. ctx_resp does not need to be invalidated */
+    XMEMFENCE();
+    XCACHEINVLD(ctx_req);
+    req.u64 = ctx_req->u64;
+    resp.u64 = ctx_resp->u64;
+
+    /* Only a request that has not been responded to can be canceled */
+    if (    (req.s.notify != resp.s.notify) &&
+            (req.s.cancel == req.s.notify)) {
+        return WH_ERROR_CANCEL;
+    }
+    return 0;
+}
+
 int wh_TransportMem_RecvRequest(void* c, uint16_t* out_len, void* data)
 {
     whTransportMemContext* context = c;
@@ -262,4 +414,447 @@ int wh_TransportMem_RecvRequest(void* c, uint16_t* out_len, void* data)
 
     return 0;
 }
-#endif /* WOLFHSM_CFG_ENABLE_SERVER */
\ No newline at end of file
+
+int wh_TransportMem_PendingRequest(void* c)
+{
+    whTransportMemContext* context = c;
+    volatile whTransportMemCsr* ctx_req;
+    volatile whTransportMemCsr* ctx_resp;
+    whTransportMemCsr req;
+    whTransportMemCsr resp;
+
+    if (    (context == NULL) ||
+            (context->initialized == 0)) {
+        return WH_ERROR_BADARGS;
+    }
+
+    ctx_req  = context->req;
+    ctx_resp = context->resp;
+
+    XMEMFENCE();
+    XCACHEINVLD(ctx_req);
+    req.u64 = ctx_req->u64;
+    resp.u64 = ctx_resp->u64;
+
+    return (req.s.notify == resp.s.notify) ? WH_ERROR_NOTREADY : 0;
+}
+#endif /* WOLFHSM_CFG_ENABLE_SERVER */
+
+/** Multi-slot ring functions */
+
+#if defined(WOLFHSM_CFG_ENABLE_CLIENT) || defined(WOLFHSM_CFG_ENABLE_SERVER)
+/* Return the CSR at the start of slot idx within a ring buffer */
+static whTransportMemCsr* _RingSlot(uint8_t* base, uint16_t slot_size,
+                                    uint16_t idx)
+{
+    return (whTransportMemCsr*)(base + ((size_t)slot_size * idx));
+}
+
+/* Advance a slot index, wrapping at slot_count */
+static uint16_t _RingNext(whTransportMemRingContext* context, uint16_t idx)
+{
+    idx++;
+    if (idx >= context->slot_count) {
+        idx = 0;
+    }
+    return idx;
+}
+#endif /* WOLFHSM_CFG_ENABLE_CLIENT || WOLFHSM_CFG_ENABLE_SERVER */
+
+int wh_TransportMemRing_Init(void* c, const void* cf,
+        whCommSetConnectedCb connectcb, void* connectcb_arg)
+{
+    whTransportMemRingContext*      context = c;
+    const whTransportMemRingConfig* config  = cf;
+    uint16_t                        req_slot_size;
+    uint16_t                        resp_slot_size;
+
+    (void)connectcb; (void)connectcb_arg; /* Not used */
+
+    if (    (context == NULL) ||
+            (config == NULL) ||
+            (config->req == NULL) ||
+            (config->resp == NULL) ||
+            (config->slot_count == 0)) {
+        return WH_ERROR_BADARGS;
+    }
+
+    /* Keep each slot CSR aligned to its natural size */
+    req_slot_size  = (config->req_size / config->slot_count) &
+                     ~(uint16_t)(sizeof(whTransportMemCsr) - 1);
+    resp_slot_size = (config->resp_size / config->slot_count) &
+                     ~(uint16_t)(sizeof(whTransportMemCsr) - 1);
+
+    /* Each slot must hold a CSR and at least some data */
+    if (    (req_slot_size <= sizeof(whTransportMemCsr)) ||
+            (resp_slot_size <= sizeof(whTransportMemCsr))) {
+        return WH_ERROR_BADARGS;
+    }
+
+    wh_Utils_memset_flush(context, 0, sizeof(*context));
+    context->req            = (uint8_t*)config->req;
+    context->req_slot_size  = req_slot_size;
+    context->resp           = (uint8_t*)config->resp;
+    context->resp_slot_size = resp_slot_size;
+    context->slot_count     = config->slot_count;
+
+    context->initialized = 1;
+    XMEMFENCE();
+
+    return WH_ERROR_OK;
+}
+
+#if defined(WOLFHSM_CFG_ENABLE_CLIENT)
+/* Release the oldest outstanding slots that were completed without a response,
+ * as for NORESP requests.  Returns the number of slots that remain pending. */
+static uint16_t _RingReap(whTransportMemRingContext* context)
+{
+    volatile whTransportMemCsr* ctx_req;
+    volatile whTransportMemCsr* ctx_resp;
+    whTransportMemCsr req;
+    whTransportMemCsr resp;
+
+    while (context->pending > 0) {
+        ctx_req  = _RingSlot(context->req, context->req_slot_size,
+                             context->recv_idx);
+        ctx_resp = _RingSlot(context->resp, context->resp_slot_size,
+                             context->recv_idx);
+
+        XMEMFENCE();
+        XCACHEINVLD(ctx_resp);
+        req.u64 = ctx_req->u64;
+        resp.u64 = ctx_resp->u64;
+
+        if ((resp.s.notify != req.s.notify) || (resp.s.len != 0)) {
+            break;
+        }
+        context->recv_idx = _RingNext(context, context->recv_idx);
+        context->pending--;
+    }
+    return context->pending;
+}
+#endif /* WOLFHSM_CFG_ENABLE_CLIENT */
+
+int wh_TransportMemRing_InitClear(void* c, const void* cf,
+        whCommSetConnectedCb connectcb, void* connectcb_arg)
+{
+    whTransportMemRingContext* context = c;
+
+    int rc = wh_TransportMemRing_Init(c, cf, connectcb, connectcb_arg);
+    if (rc == WH_ERROR_OK) {
+        /* Zero every slot in both buffers */
+        wh_Utils_memset_flush((void*)context->req, 0,
+                (size_t)context->req_slot_size * context->slot_count);
+        wh_Utils_memset_flush((void*)context->resp, 0,
+                (size_t)context->resp_slot_size * context->slot_count);
+    }
+    return rc;
+}
+
+int wh_TransportMemRing_Cleanup(void* c)
+{
+    whTransportMemRingContext* context = c;
+    if (context == NULL) {
+        return WH_ERROR_BADARGS;
+    }
+
+    context->initialized = 0;
+
+    return 0;
+}
+
+#if defined(WOLFHSM_CFG_ENABLE_CLIENT)
+int wh_TransportMemRing_SendRequest(void* c, uint16_t len, const void* data)
+{
+    whTransportMemRingContext* context = c;
+    volatile whTransportMemCsr* ctx_req;
+    volatile whTransportMemCsr* ctx_resp;
+    whTransportMemCsr resp;
+    whTransportMemCsr req;
+
+    if (    (context == NULL) ||
+            (context->initialized == 0) ||
+            (data == NULL && len != 0)) {
+        return WH_ERROR_BADARGS;
+    }
+
+    /* Don't send more data than we have space for in a request slot */
+    if (len > (context->req_slot_size - sizeof(whTransportMemCsr))) {
+        return WH_ERROR_BADARGS;
+    }
+
+    /* Every slot is in flight */
+    if (_RingReap(context) >= context->slot_count) {
+        return WH_ERROR_NOTREADY;
+    }
+
+    ctx_req  = _RingSlot(context->req, context->req_slot_size,
+                         context->send_idx);
+    ctx_resp = _RingSlot(context->resp, context->resp_slot_size,
+                         context->send_idx);
+
+    /* Read current CSR's. ctx_req does not need to be invalidated */
+    XMEMFENCE();
+    XCACHEINVLD(ctx_resp);
+    resp.u64 = ctx_resp->u64;
+    req.u64 = ctx_req->u64;
+
+    /* Has server completed with the previous request in this slot */
+    if (req.s.notify != resp.s.notify) {
+        return WH_ERROR_NOTREADY;
+    }
+
+    if ((data != NULL) && (len != 0)) {
+        if (data == (void*)(ctx_req + 1)) {
+            /* Built in place with GetSendBuffer */
+            wh_Utils_CacheFlush((void*)(ctx_req + 1), len);
+        }
+        else {
+            wh_Utils_memcpy_flush((void*)(ctx_req + 1), data, len);
+        }
+    }
+
+    req.s.len = len;
+    req.s.notify++;
+
+    /* Write the new CSR */
+    ctx_req->u64 = req.u64;
+    /*Ensure the update to the CSR is complete */
+    XMEMFENCE();
+    XCACHEFLUSH(ctx_req);
+
+    context->send_idx = _RingNext(context, context->send_idx);
+    context->pending++;
+
+    return 0;
+}
+
+int wh_TransportMemRing_GetSendBuffer(void* c, uint16_t* out_size,
+        void** out_buffer)
+{
+    whTransportMemRingContext* context = c;
+    volatile whTransportMemCsr* ctx_req;
+    volatile whTransportMemCsr* ctx_resp;
+    whTransportMemCsr resp;
+    whTransportMemCsr req;
+
+    if (    (context == NULL) ||
+            (context->initialized == 0) ||
+            (out_size == NULL) ||
+            (out_buffer == NULL)) {
+        return WH_ERROR_BADARGS;
+    }
+
+    /* Every slot is in flight */
+    if (_RingReap(context) >= context->slot_count) {
+        return WH_ERROR_NOTREADY;
+    }
+
+    ctx_req  = _RingSlot(context->req, context->req_slot_size,
+                         context->send_idx);
+    ctx_resp = _RingSlot(context->resp, context->resp_slot_size,
+                         context->send_idx);
+
+    /* Read current CSR's. ctx_req does not need to be invalidated */
+    XMEMFENCE();
+    XCACHEINVLD(ctx_resp);
+    resp.u64 = ctx_resp->u64;
+    req.u64 = ctx_req->u64;
+
+    /* The server may still be reading the previous request in this slot */
+    if (req.s.notify != resp.s.notify) {
+        return WH_ERROR_NOTREADY;
+    }
+
+    *out_buffer = (void*)(ctx_req + 1);
+    *out_size   = context->req_slot_size - sizeof(whTransportMemCsr);
+    return 0;
+}
+
+int wh_TransportMemRing_RecvResponse(void* c, uint16_t* out_len, void* data)
+{
+    whTransportMemRingContext* context = c;
+    volatile whTransportMemCsr* ctx_req;
+    volatile whTransportMemCsr* ctx_resp;
+    whTransportMemCsr req;
+    whTransportMemCsr resp;
+
+    if (    (context == NULL) ||
+            (context->initialized == 0)) {
+        return WH_ERROR_BADARGS;
+    }
+
+    /* Nothing outstanding to receive */
+    if (_RingReap(context) == 0) {
+        return WH_ERROR_NOTREADY;
+    }
+
+    ctx_req  = _RingSlot(context->req, context->req_slot_size,
+                         context->recv_idx);
+    ctx_resp = _RingSlot(context->resp, context->resp_slot_size,
+                         context->recv_idx);
+
+    /* Read both CSR's. ctx_req does not need to be invalidated */
+    XMEMFENCE();
+    XCACHEINVLD(ctx_resp);
+    req.u64 = ctx_req->u64;
+    resp.u64 = ctx_resp->u64;
+
+    /* Check to see if the oldest request has been answered */
+    if (resp.s.notify != req.s.notify) {
+        return WH_ERROR_NOTREADY;
+    }
+
+    if ((data != NULL) && (resp.s.len != 0)) {
+        wh_Utils_memcpy_invalidate(data, (void*)(ctx_resp + 1), resp.s.len);
+    }
+
+    if (out_len != NULL) {
+        *out_len = resp.s.len;
+    }
+
+    context->recv_idx = _RingNext(context, context->recv_idx);
+    context->pending--;
+
+    return 0;
+}
+#endif /* WOLFHSM_CFG_ENABLE_CLIENT */
+
+#if defined(WOLFHSM_CFG_ENABLE_SERVER)
+int wh_TransportMemRing_SendResponse(void* c, uint16_t len, const void* data)
+{
+    whTransportMemRingContext* context = c;
+    volatile whTransportMemCsr* ctx_req;
+    volatile whTransportMemCsr* ctx_resp;
+    whTransportMemCsr req;
+    whTransportMemCsr resp;
+
+    if (    (context == NULL) ||
+            (context->initialized == 0) ||
+            (data == NULL && len != 0)) {
+        return WH_ERROR_BADARGS;
+    }
+
+    /* Check against available data space (slot size minus CSR size) */
+    if (len > (context->resp_slot_size - sizeof(whTransportMemCsr))) {
+        return WH_ERROR_BADARGS;
+    }
+
+    /* No received request to respond to */
+    if (context->pending == 0) {
+        return WH_ERROR_BADARGS;
+    }
+
+    ctx_req  = _RingSlot(context->req, context->req_slot_size,
+                         context->send_idx);
+    ctx_resp = _RingSlot(context->resp, context->resp_slot_size,
+                         context->send_idx);
+
+    /* Read both CSR's. ctx_resp does not need to be invalidated */
+    XMEMFENCE();
+    XCACHEINVLD(ctx_req);
+    req.u64 = ctx_req->u64;
+    resp.u64 = ctx_resp->u64;
+
+    if ((data != NULL) && (len != 0)) {
+        wh_Utils_memcpy_flush((void*)(ctx_resp + 1), data, len);
+    }
+
+    resp.s.len = len;
+    resp.s.notify = req.s.notify;
+
+    /* Write the new CSR */
+    ctx_resp->u64 = resp.u64;
+    /*Ensure the update to the CSR is complete */
+    XMEMFENCE();
+    XCACHEFLUSH(ctx_resp);
+
+    context->send_idx = _RingNext(context, context->send_idx);
+    context->pending--;
+
+    return 0;
+}
+
+int wh_TransportMemRing_CompleteRequest(void* c)
+{
+    /* Release the slot with an empty completion */
+    return wh_TransportMemRing_SendResponse(c, 0, NULL);
+}
+
+int wh_TransportMemRing_RecvRequest(void* c, uint16_t* out_len, void* data)
+{
+    whTransportMemRingContext* context = c;
+    volatile whTransportMemCsr* ctx_req;
+    volatile whTransportMemCsr* ctx_resp;
+    whTransportMemCsr req;
+    whTransportMemCsr resp;
+
+    if (    (context == NULL) ||
+            (context->initialized == 0)) {
+        return WH_ERROR_BADARGS;
+    }
+
+    /* Every slot has been received but not yet answered */
+    if (context->pending >= context->slot_count) {
+        return WH_ERROR_NOTREADY;
+    }
+
+    ctx_req  = _RingSlot(context->req, context->req_slot_size,
+                         context->recv_idx);
+    ctx_resp = _RingSlot(context->resp, context->resp_slot_size,
+                         context->recv_idx);
+
+    /* Read current request CSR's. ctx_resp does not need to be invalidated */
+    XMEMFENCE();
+    XCACHEINVLD(ctx_req);
+    req.u64 = ctx_req->u64;
+    resp.u64 = ctx_resp->u64;
+
+    /* Check to see if a new request has arrived in this slot */
+    if (req.s.notify == resp.s.notify) {
+        return WH_ERROR_NOTREADY;
+    }
+
+    if ((data != NULL) && (req.s.len != 0)) {
+        wh_Utils_memcpy_invalidate(data, (void*)(ctx_req + 1), req.s.len);
+    }
+    if (out_len != NULL) {
+        *out_len = req.s.len;
+    }
+
+    context->recv_idx = _RingNext(context, context->recv_idx);
+    context->pending++;
+
+    return 0;
+}
+
+int wh_TransportMemRing_PendingRequest(void* c)
+{
+    whTransportMemRingContext* context = c;
+    volatile whTransportMemCsr* ctx_req;
+    volatile whTransportMemCsr* ctx_resp;
+    whTransportMemCsr req;
+    whTransportMemCsr resp;
+
+    if (    (context == NULL) ||
+            (context->initialized == 0)) {
+        return WH_ERROR_BADARGS;
+    }
+
+    if (context->pending >= context->slot_count) {
+        return WH_ERROR_NOTREADY;
+    }
+
+    ctx_req  = _RingSlot(context->req, context->req_slot_size,
+                         context->recv_idx);
+    ctx_resp = _RingSlot(context->resp, context->resp_slot_size,
+                         context->recv_idx);
+
+    XMEMFENCE();
+    XCACHEINVLD(ctx_req);
+    req.u64 = ctx_req->u64;
+    resp.u64 = ctx_resp->u64;
+
+    return (req.s.notify == resp.s.notify) ? WH_ERROR_NOTREADY : 0;
+}
+#endif /* WOLFHSM_CFG_ENABLE_SERVER */
@@ -0,0 +1,242 @@
+/*
+ * Copyright (C) 2025 wolfSSL Inc.
+ *
+ * This file is part of wolfHSM.
+ *
+ * wolfHSM is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * wolfHSM is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with wolfHSM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/*
+ * src/wh_transport_session.c
+ *
+ * Implementation of a client transport that multiplexes many sessions over one
+ * underlying client transport connection
+ */
+
+/* Pick up compile-time configuration */
+#include "wolfhsm/wh_settings.h"
+
+#if defined(WOLFHSM_CFG_COMM_SESSIONS) && defined(WOLFHSM_CFG_ENABLE_CLIENT)
+
+#include <stddef.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "wolfhsm/wh_error.h"
+#include "wolfhsm/wh_comm.h"
+
+#include "wolfhsm/wh_transport_session.h"
+
+#ifdef WOLFHSM_CFG_COMM_FRAGMENT
+/* Nonzero if the received packet is an ack or a fragment that is not the last
+ * of its logical packet, so the owner has more fragments to exchange */
+static int _MoreFragments(uint16_t len, const void* data)
+{
+    const whCommFragHeader* frag = data;
+    uint16_t magic = 0;
+
+    if (len < sizeof(*frag)) {
+        return 0;
+    }
+    magic = frag->magic;
+    if (wh_Translate16(magic, frag->flags) == WH_COMM_FRAG_FLAG_ACK) {
+        return 1;
+    }
+    return ((uint32_t)wh_Translate16(magic, frag->offset) + len -
+                sizeof(*frag)) < wh_Translate16(magic, frag->total);
+}
+#endif
+
+/* Nonzero if the session may use the connection now */
+static int _Available(whTransportSessionContext* context)
+{
+    return (context->conn->owner == NULL) ||
+           (context->conn->owner == (void*)context);
+}
+
+int wh_TransportSession_Init(void* c, const void* cf,
+        whCommSetConnectedCb connectcb, void* connectcb_arg)
+{
+    whTransportSessionContext* context = c;
+    const whTransportSessionConfig* config = cf;
+    whTransportSessionConnection* conn = NULL;
+    int rc = 0;
+
+    if (    (context == NULL) ||
+            (config == NULL) ||
+            (config->conn == NULL) ||
+            (config->transport_cb == NULL)) {
+        return WH_ERROR_BADARGS;
+    }
+    conn = config->conn;
+
+    if (conn->users == 0) {
+        /* First session establishes the connection */
+        memset(conn, 0, sizeof(*conn));
+        if (config->transport_cb->Init != NULL) {
+            rc = config->transport_cb->Init(config->transport_context,
+                    config->transport_config, connectcb, connectcb_arg);
+        }
+        if (rc != 0) {
+            return rc;
+        }
+        conn->transport_cb      = config->transport_cb;
+        conn->transport_context = config->transport_context;
+#ifdef WOLFHSM_CFG_COMM_FRAGMENT
+        conn->fragment_size     = config->fragment_size;
+#endif
+    }
+    else if (conn->transport_context != config->transport_context) {
+        return WH_ERROR_BADARGS;
+    }
+#ifdef WOLFHSM_CFG_COMM_FRAGMENT
+    else if (conn->fragment_size != config->fragment_size) {
+        return WH_ERROR_BADARGS;
+    }
+#endif
+
+    memset(context, 0, sizeof(*context));
+    context->conn        = conn;
+    context->initialized = 1;
+    conn->users++;
+
+    return 0;
+}
+
+int wh_TransportSession_Send(void* c, uint16_t len, const void* data)
+{
+    whTransportSessionContext* context = c;
+    int rc = 0;
+
+    if (    (context == NULL) ||
+            (context->initialized == 0)) {
+        return WH_ERROR_BADARGS;
+    }
+
+    /* Another session is waiting for a response */
+    if (!_Available(context)) {
+        return WH_ERROR_NOTREADY;
+    }
+
+    rc = context->conn->transport_cb->Send(context->conn->transport_context,
+            len, data);
+    if (rc == 0) {
+        context->conn->owner = context;
+        context->conn->pending++;
+    }
+    return rc;
+}
+
+int wh_TransportSession_Recv(void* c, uint16_t* out_len, void* data)
+{
+    whTransportSessionContext* context = c;
+    int rc = 0;
+
+    if (    (context == NULL) ||
+            (context->initialized == 0)) {
+        return WH_ERROR_BADARGS;
+    }
+
+    /* Any response on the connection belongs to the owner */
+    if (context->conn->owner != (void*)context) {
+        return WH_ERROR_NOTREADY;
+    }
+
+    rc = context->conn->transport_cb->Recv(context->conn->transport_context,
+            out_len, data);
+    if (rc == 0) {
+        context->conn->pending--;
+        if (    (context->conn->pending == 0)
+#ifdef WOLFHSM_CFG_COMM_FRAGMENT
+                && ((context->conn->fragment_size == 0) ||
+                    !_MoreFragments(*out_len, data))
+#endif
+            ) {
+            /* Let the next session send */
+            context->conn->owner = NULL;
+        }
+    }
+    return rc;
+}
+
+int wh_TransportSession_GetSendBuffer(void* c, uint16_t* out_size,
+        void** out_buffer)
+{
+    whTransportSessionContext* context = c;
+
+    if (    (context == NULL) ||
+            (context->initialized == 0)) {
+        return WH_ERROR_BADARGS;
+    }
+
+    if (context->conn->transport_cb->GetSendBuffer == NULL) {
+        return WH_ERROR_NOTIMPL;
+    }
+    if (!_Available(context)) {
+        return WH_ERROR_NOTREADY;
+    }
+    return context->conn->transport_cb->GetSendBuffer(
+            context->conn->transport_context, out_size, out_buffer);
+}
+
+int wh_TransportSession_Wait(void* c, uint64_t timeout_us)
+{
+    whTransportSessionContext* context = c;
+
+    if (    (context == NULL) ||
+            (context->initialized == 0)) {
+        return WH_ERROR_BADARGS;
+    }
+
+    if (context->conn->transport_cb->Wait == NULL) {
+        return WH_ERROR_NOTIMPL;
+    }
+    /* Spurious returns are allowed, so waking for the response of another
+     * session is harmless */
+    return context->conn->transport_cb->Wait(context->conn->transport_context,
+            timeout_us);
+}
+
+int wh_TransportSession_Cleanup(void* c)
+{
+    whTransportSessionContext* context = c;
+    whTransportSessionConnection* conn = NULL;
+    int rc = 0;
+
+    if (context == NULL) {
+        return WH_ERROR_BADARGS;
+    }
+    if (context->initialized == 0) {
+        return 0;
+    }
+    conn = context->conn;
+
+    if (conn->owner == (void*)context) {
+        if (conn->pending != 0) {
+            /* A response left on the connection would be received by the
+             * next session, so it must be received first */
+            return WH_ERROR_NOTREADY;
+        }
+        conn->owner = NULL;
+    }
+    conn->users--;
+    if (    (conn->users == 0) &&
+            (conn->transport_cb->Cleanup != NULL)) {
+        rc = conn->transport_cb->Cleanup(conn->transport_context);
+    }
+    context->initialized = 0;
+
+    return rc;
+}
+
+#endif /* WOLFHSM_CFG_COMM_SESSIONS && WOLFHSM_CFG_ENABLE_CLIENT */
@@ -35,6 +35,7 @@
 #include "wh_test_flash_ramsim.h"
 #include "wh_test_nvm_flash.h"
 #include "wh_test_crypto.h"
+#include "wh_test_keystore.h"
 #include "wh_test_she.h"
 #include "wh_test_clientserver.h"
 #include "wh_test_keywrap.h"
@@ -99,6 +100,7 @@ int whTest_Unit(void)
 #ifndef WOLFHSM_CFG_NO_CRYPTO
     /* Crypto Tests */
     WH_TEST_ASSERT(0 == whTest_Crypto());
+    WH_TEST_ASSERT(0 == whTest_Keystore());
 
 #ifdef WOLF_CRYPTO_CB
     WH_TEST_ASSERT(0 == whTest_CryptoAffinity());
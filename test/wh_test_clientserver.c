@@ -28,6 +28,8 @@
 
 #include "wolfhsm/wh_comm.h"
 #include "wolfhsm/wh_transport_mem.h"
+#include "wolfhsm/wh_transport_direct.h"
+#include "wolfhsm/wh_transport_session.h"
 
 #ifdef WOLFHSM_CFG_ENABLE_SERVER
 #include "wolfhsm/wh_nvm.h"
@@ -39,6 +41,11 @@
 
 #include "wolfhsm/wh_message.h"
 #include "wolfhsm/wh_message_comm.h"
+#include "wolfhsm/wh_message_nvm.h"
+#ifdef WOLFHSM_CFG_BATCH
+#include "wolfhsm/wh_message_batch.h"
+#include "wolfhsm/wh_message_counter.h"
+#endif /* WOLFHSM_CFG_BATCH */
 
 #ifdef WOLFHSM_CFG_ENABLE_CLIENT
 #include "wolfhsm/wh_client.h"
@@ -55,8 +62,13 @@
 #if defined(WOLFHSM_CFG_TEST_POSIX)
 #include <pthread.h> /* For pthread_create/cancel/join/_t */
 #include <unistd.h>  /* For sleep */
+#include <sched.h>   /* For sched_yield */
 
 #include "port/posix/posix_transport_shm.h"
+#include "port/posix/posix_server_pool.h"
+#if defined(__linux__)
+#include "port/posix/posix_transport_uds.h"
+#endif
 #endif
 
 
@@ -492,6 +504,675 @@ static int _testClientCounter(whClientContext* client)
 }
 #endif /* WOLFHSM_CFG_ENABLE_CLIENT */
 
+#if defined(WOLFHSM_CFG_ENABLE_CLIENT) && defined(WOLFHSM_CFG_ENABLE_SERVER)
+static int _testNoResp(whServerContext* server, whClientContext* client)
+{
+    const whNvmId counterId = 8;
+    uint32_t      counter   = 0;
+    uint16_t      size      = 0;
+    int           ret       = 0;
+    int           i         = 0;
+
+    WH_TEST_PRINT("Testing requests without response...\n");
+
+    WH_TEST_RETURN_ON_FAIL(
+        wh_Client_CounterInitRequest(client, counterId, counter));
+    WH_TEST_RETURN_ON_FAIL(wh_Server_HandleRequestMessage(server));
+    WH_TEST_RETURN_ON_FAIL(wh_Client_CounterInitResponse(client, &counter));
+    WH_TEST_ASSERT_RETURN(counter == 0);
+
+    for (i = 0; i < 3; i++) {
+        WH_TEST_RETURN_ON_FAIL(
+            wh_Client_CounterIncrementNoResp(client, counterId));
+        WH_TEST_RETURN_ON_FAIL(wh_Server_HandleRequestMessage(server));
+
+        /* The server completed the request without a response */
+        ret = wh_Client_RecvResponse(client, NULL, NULL, &size, NULL);
+        WH_TEST_ASSERT_RETURN(ret == WH_ERROR_NOTREADY);
+    }
+
+    WH_TEST_RETURN_ON_FAIL(wh_Client_CounterReadRequest(client, counterId));
+    WH_TEST_RETURN_ON_FAIL(wh_Server_HandleRequestMessage(server));
+    WH_TEST_RETURN_ON_FAIL(wh_Client_CounterReadResponse(client, &counter));
+    WH_TEST_ASSERT_RETURN(counter == 3);
+
+    WH_TEST_RETURN_ON_FAIL(wh_Client_CounterDestroyRequest(client, counterId));
+    WH_TEST_RETURN_ON_FAIL(wh_Server_HandleRequestMessage(server));
+    WH_TEST_RETURN_ON_FAIL(wh_Client_CounterDestroyResponse(client));
+
+    /* Errors are not reported, and the next request is unaffected */
+    WH_TEST_RETURN_ON_FAIL(
+        wh_Client_CounterIncrementNoResp(client, counterId));
+    WH_TEST_RETURN_ON_FAIL(wh_Server_HandleRequestMessage(server));
+    WH_TEST_RETURN_ON_FAIL(
+        wh_Client_NvmDestroyObjectsNoResp(client, 1, &counterId));
+    WH_TEST_RETURN_ON_FAIL(wh_Server_HandleRequestMessage(server));
+
+    WH_TEST_RETURN_ON_FAIL(wh_Client_CounterReadRequest(client, counterId));
+    WH_TEST_RETURN_ON_FAIL(wh_Server_HandleRequestMessage(server));
+    ret = wh_Client_CounterReadResponse(client, &counter);
+    WH_TEST_ASSERT_RETURN(ret == WH_ERROR_NOTFOUND);
+
+    return WH_ERROR_OK;
+}
+#endif /* WOLFHSM_CFG_ENABLE_CLIENT && WOLFHSM_CFG_ENABLE_SERVER */
+
+#if defined(WOLFHSM_CFG_CANCEL_API) && defined(WOLFHSM_CFG_ENABLE_CLIENT) && \
+    defined(WOLFHSM_CFG_ENABLE_SERVER)
+/* Client cancel callback. In a "real" system, this would signal the server
+ * out of band, for example through a doorbell interrupt */
+static int _cancelTestClientCb(void* arg, uint16_t seq)
+{
+    (void)arg;
+    return wh_Server_SetCanceledSequence(clientServerSequentialTestServerCtx,
+                                         seq);
+}
+
+#ifdef WOLFHSM_CFG_BATCH
+/* Sequence number the cancel custom callback cancels mid-batch */
+static uint16_t _cancelTestSeq = 0;
+
+/* Custom callback that simulates a cancel arriving while a batch runs */
+static int _cancelTestServerCb(whServerContext*                 server,
+                               const whMessageCustomCb_Request* req,
+                               whMessageCustomCb_Response*      resp)
+{
+    (void)req;
+    (void)resp;
+    return wh_Server_SetCanceledSequence(server, _cancelTestSeq);
+}
+
+/* Client transport context the transport cancel custom callback cancels on */
+static void* _cancelTestTransport = NULL;
+
+/* Custom callback that simulates a transport cancel arriving while a batch
+ * runs. The memory transport CSR is written as the client would */
+static int _cancelTestTransportCb(whServerContext*                 server,
+                                  const whMessageCustomCb_Request* req,
+                                  whMessageCustomCb_Response*      resp)
+{
+    (void)server;
+    (void)req;
+    (void)resp;
+    return wh_TransportMem_CancelRequest(_cancelTestTransport);
+}
+#endif /* WOLFHSM_CFG_BATCH */
+
+#if defined(WOLFHSM_CFG_DMA) && defined(WOLFHSM_CFG_CLIENT_WAIT) && \
+    !defined(WOLFHSM_CFG_NO_CRYPTO) && !defined(NO_SHA256)
+/* Server crypto device used to observe the chunks of a DMA hash */
+#define CANCEL_TEST_DEVID 0x434E434C /* "CNCL" */
+
+static int _cancelHashUpdates   = 0;
+static int _cancelHashReadPres  = 0;
+static int _cancelHashReadPosts = 0;
+static int _cancelHashArmed     = 0;
+
+/* Runs the server while the client waits in a blocking crypto call */
+static void _cancelHashYieldCb(void* arg)
+{
+    (void)wh_Server_HandleRequestMessage((whServerContext*)arg);
+}
+
+/* Cancels the outstanding request on the first hashed chunk. Software still
+ * does the hashing */
+static int _cancelHashCryptoCb(int devId, wc_CryptoInfo* info, void* ctx)
+{
+    whClientContext* client = (whClientContext*)ctx;
+    (void)devId;
+
+    if ((info->algo_type == WC_ALGO_TYPE_HASH) &&
+        (info->hash.type == WC_HASH_TYPE_SHA256) && (info->hash.in != NULL)) {
+        _cancelHashUpdates++;
+        if (_cancelHashArmed != 0) {
+            _cancelHashArmed = 0;
+            (void)wh_Server_SetCanceledSequence(
+                clientServerSequentialTestServerCtx, client->last_req_id);
+        }
+    }
+    return CRYPTOCB_UNAVAILABLE;
+}
+
+/* Counts reads of client memory, using the client address in place */
+static int _cancelHashDmaCb(struct whServerContext_t* server,
+                            uintptr_t clientAddr, void** serverPtr, size_t len,
+                            whServerDmaOper oper, whServerDmaFlags flags)
+{
+    (void)server;
+    (void)clientAddr;
+    (void)serverPtr;
+    (void)len;
+    (void)flags;
+
+    if (oper == WH_DMA_OPER_CLIENT_READ_PRE) {
+        _cancelHashReadPres++;
+    }
+    else if (oper == WH_DMA_OPER_CLIENT_READ_POST) {
+        _cancelHashReadPosts++;
+    }
+    return WH_ERROR_OK;
+}
+
+static int _testCancelDmaHash(whServerContext* server, whClientContext* client)
+{
+    static uint8_t  in[2 * WOLFHSM_CFG_SERVER_CANCEL_CHUNK];
+    wc_Sha256       sha[1];
+    wc_Sha256       shaBefore[1];
+    uint8_t         digest[WC_SHA256_DIGEST_SIZE];
+    uint8_t         expected[WC_SHA256_DIGEST_SIZE];
+    whClientYieldCb yieldCb   = client->wait.yield_cb;
+    void*           yieldArg  = client->wait.yield_arg;
+    int             serverDev = server->devId;
+    uint32_t        affinity  = 0;
+    int             rc        = 0;
+
+    WH_TEST_PRINT("Testing cancel of a DMA hash...\n");
+
+    memset(in, 0x5A, sizeof(in));
+    WH_TEST_RETURN_ON_FAIL(wc_InitSha256_ex(sha, NULL, INVALID_DEVID));
+    WH_TEST_RETURN_ON_FAIL(wc_Sha256Update(sha, in, sizeof(in)));
+    WH_TEST_RETURN_ON_FAIL(wc_Sha256Final(sha, expected));
+    wc_Sha256Free(sha);
+
+    WH_TEST_RETURN_ON_FAIL(wh_Client_GetCryptoAffinity(client, &affinity));
+    WH_TEST_RETURN_ON_FAIL(
+        wh_Client_SetCryptoAffinity(client, WH_CRYPTO_AFFINITY_HW));
+    WH_TEST_RETURN_ON_FAIL(wc_CryptoCb_RegisterDevice(
+        CANCEL_TEST_DEVID, _cancelHashCryptoCb, client));
+    WH_TEST_RETURN_ON_FAIL(wh_Server_DmaRegisterCb(server, _cancelHashDmaCb));
+    server->devId          = CANCEL_TEST_DEVID;
+    client->wait.yield_cb  = _cancelHashYieldCb;
+    client->wait.yield_arg = server;
+
+    /* Canceled after the first chunk, so the rest of the input is skipped,
+     * the input is still released and the client state is left untouched */
+    WH_TEST_RETURN_ON_FAIL(wc_InitSha256_ex(sha, NULL, INVALID_DEVID));
+    memcpy(shaBefore, sha, sizeof(sha));
+    _cancelHashUpdates   = 0;
+    _cancelHashReadPres  = 0;
+    _cancelHashReadPosts = 0;
+    _cancelHashArmed     = 1;
+    rc = wh_Client_Sha256Dma(client, sha, in, sizeof(in), NULL);
+    WH_TEST_ASSERT_RETURN(rc == WH_ERROR_CANCEL);
+    WH_TEST_ASSERT_RETURN(_cancelHashUpdates == 1);
+    WH_TEST_ASSERT_RETURN(_cancelHashReadPres > 0);
+    WH_TEST_ASSERT_RETURN(_cancelHashReadPosts == _cancelHashReadPres);
+    WH_TEST_ASSERT_RETURN(0 == memcmp(shaBefore, sha, sizeof(sha)));
+
+    /* The same state can be hashed again in full after the cancel */
+    _cancelHashUpdates = 0;
+    WH_TEST_RETURN_ON_FAIL(wh_Client_Sha256Dma(client, sha, in, sizeof(in),
+                                               NULL));
+    WH_TEST_ASSERT_RETURN(_cancelHashUpdates == 2);
+    WH_TEST_RETURN_ON_FAIL(wh_Client_Sha256Dma(client, sha, NULL, 0, digest));
+    WH_TEST_ASSERT_RETURN(0 == memcmp(digest, expected, sizeof(digest)));
+
+    client->wait.yield_cb  = yieldCb;
+    client->wait.yield_arg = yieldArg;
+    server->devId          = serverDev;
+    WH_TEST_RETURN_ON_FAIL(wh_Server_DmaRegisterCb(server, NULL));
+    wc_CryptoCb_UnRegisterDevice(CANCEL_TEST_DEVID);
+    WH_TEST_RETURN_ON_FAIL(wh_Client_SetCryptoAffinity(client, affinity));
+
+    return WH_ERROR_OK;
+}
+#endif /* WOLFHSM_CFG_DMA && WOLFHSM_CFG_CLIENT_WAIT && \
+          !WOLFHSM_CFG_NO_CRYPTO && !NO_SHA256 */
+
+static int _testCancel(whServerContext* server, whClientContext* client)
+{
+    const char                send[]   = "cancel echo";
+    char                      recv[sizeof(send)];
+    whMessageCustomCb_Request cbReq    = {0};
+    const uint16_t            cbId     = 0;
+    uint16_t                  recv_len = 0;
+    uint16_t                  count    = 0;
+    int                       ret      = 0;
+
+    WH_TEST_PRINT("Testing request cancellation...\n");
+
+    /* Canceled before the server starts it, so it is never executed */
+    WH_TEST_RETURN_ON_FAIL(
+        wh_Client_EchoRequest(client, sizeof(send), send));
+    WH_TEST_RETURN_ON_FAIL(wh_Client_CancelRequest(client));
+    ret = wh_Server_HandleRequestMessage(server);
+    WH_TEST_ASSERT_RETURN(ret == WH_ERROR_OK);
+    WH_TEST_RETURN_ON_FAIL(wh_Client_CancelResponse(client));
+
+    /* The channel is in step for the next request */
+    WH_TEST_RETURN_ON_FAIL(
+        wh_Client_EchoRequest(client, sizeof(send), send));
+    WH_TEST_RETURN_ON_FAIL(wh_Server_HandleRequestMessage(server));
+    WH_TEST_RETURN_ON_FAIL(wh_Client_EchoResponse(client, &recv_len, recv));
+    WH_TEST_ASSERT_RETURN(recv_len == sizeof(send));
+
+    /* Canceled after it completed, so the normal response is discarded */
+    WH_TEST_RETURN_ON_FAIL(
+        wh_Client_EchoRequest(client, sizeof(send), send));
+    WH_TEST_RETURN_ON_FAIL(wh_Server_HandleRequestMessage(server));
+    WH_TEST_RETURN_ON_FAIL(wh_Client_CancelRequest(client));
+    ret = wh_Client_CancelResponse(client);
+    WH_TEST_ASSERT_RETURN(ret == WH_ERROR_CANCEL_LATE);
+
+    /* The late cancel is stale and does not affect the next request */
+    WH_TEST_RETURN_ON_FAIL(
+        wh_Client_EchoRequest(client, sizeof(send), send));
+    WH_TEST_RETURN_ON_FAIL(wh_Server_HandleRequestMessage(server));
+    WH_TEST_RETURN_ON_FAIL(wh_Client_EchoResponse(client, &recv_len, recv));
+    WH_TEST_ASSERT_RETURN(recv_len == sizeof(send));
+
+#ifdef WOLFHSM_CFG_BATCH
+    /* Canceled between the sub-requests of a batch. The first sub-request
+     * cancels the batch, so the echo is never executed */
+    WH_TEST_RETURN_ON_FAIL(
+        wh_Server_RegisterCustomCb(server, cbId, _cancelTestServerCb));
+    cbReq.id   = cbId;
+    cbReq.type = WH_MESSAGE_CUSTOM_CB_TYPE_USER_DEFINED_START;
+    WH_TEST_RETURN_ON_FAIL(wh_Client_BatchStart(client));
+    WH_TEST_RETURN_ON_FAIL(wh_Client_BatchAdd(
+        client, WH_MESSAGE_GROUP_CUSTOM, cbId, sizeof(cbReq), &cbReq,
+        sizeof(whMessageCustomCb_Response)));
+    WH_TEST_RETURN_ON_FAIL(wh_Client_BatchAdd(
+        client, WH_MESSAGE_GROUP_COMM, WH_MESSAGE_COMM_ACTION_ECHO,
+        sizeof(send), send, sizeof(send)));
+    WH_TEST_RETURN_ON_FAIL(wh_Client_BatchRequest(client));
+    _cancelTestSeq = client->last_req_id;
+    WH_TEST_RETURN_ON_FAIL(wh_Server_HandleRequestMessage(server));
+    ret = wh_Client_BatchResponse(client, &count);
+    WH_TEST_ASSERT_RETURN(ret == WH_ERROR_CANCEL);
+    WH_TEST_RETURN_ON_FAIL(
+        wh_Server_RegisterCustomCb(server, cbId, _customServerCb));
+#else
+    (void)cbReq;
+    (void)cbId;
+    (void)count;
+#endif /* WOLFHSM_CFG_BATCH */
+
+#if defined(WOLFHSM_CFG_DMA) && defined(WOLFHSM_CFG_CLIENT_WAIT) && \
+    !defined(WOLFHSM_CFG_NO_CRYPTO) && !defined(NO_SHA256)
+    /* Canceled between the chunks of a DMA hash */
+    WH_TEST_RETURN_ON_FAIL(_testCancelDmaHash(server, client));
+#endif
+
+    /* Without a cancel callback, the cancel goes through the memory
+     * transport, which needs an outstanding request */
+    client->cancelCb = NULL;
+    WH_TEST_ASSERT_RETURN(WH_ERROR_NOTREADY ==
+                          wh_Client_CancelRequest(client));
+
+    /* Canceled through the transport before the server starts it */
+    WH_TEST_RETURN_ON_FAIL(
+        wh_Client_EchoRequest(client, sizeof(send), send));
+    WH_TEST_RETURN_ON_FAIL(wh_Client_CancelRequest(client));
+    ret = wh_Server_HandleRequestMessage(server);
+    WH_TEST_ASSERT_RETURN(ret == WH_ERROR_OK);
+    WH_TEST_RETURN_ON_FAIL(wh_Client_CancelResponse(client));
+
+    /* A late transport cancel is refused, since no request is outstanding,
+     * and the next request is not affected */
+    WH_TEST_RETURN_ON_FAIL(
+        wh_Client_EchoRequest(client, sizeof(send), send));
+    WH_TEST_RETURN_ON_FAIL(wh_Server_HandleRequestMessage(server));
+    WH_TEST_ASSERT_RETURN(WH_ERROR_NOTREADY ==
+                          wh_Client_CancelRequest(client));
+    WH_TEST_RETURN_ON_FAIL(wh_Client_EchoResponse(client, &recv_len, recv));
+    WH_TEST_ASSERT_RETURN(recv_len == sizeof(send));
+    WH_TEST_RETURN_ON_FAIL(
+        wh_Client_EchoRequest(client, sizeof(send), send));
+    WH_TEST_RETURN_ON_FAIL(wh_Server_HandleRequestMessage(server));
+    WH_TEST_RETURN_ON_FAIL(wh_Client_EchoResponse(client, &recv_len, recv));
+    WH_TEST_ASSERT_RETURN(recv_len == sizeof(send));
+
+#ifdef WOLFHSM_CFG_BATCH
+    /* Canceled through the transport while a batch runs */
+    _cancelTestTransport = client->comm->transport_context;
+    WH_TEST_RETURN_ON_FAIL(
+        wh_Server_RegisterCustomCb(server, cbId, _cancelTestTransportCb));
+    WH_TEST_RETURN_ON_FAIL(wh_Client_BatchStart(client));
+    WH_TEST_RETURN_ON_FAIL(wh_Client_BatchAdd(
+        client, WH_MESSAGE_GROUP_CUSTOM, cbId, sizeof(cbReq), &cbReq,
+        sizeof(whMessageCustomCb_Response)));
+    WH_TEST_RETURN_ON_FAIL(wh_Client_BatchAdd(
+        client, WH_MESSAGE_GROUP_COMM, WH_MESSAGE_COMM_ACTION_ECHO,
+        sizeof(send), send, sizeof(send)));
+    WH_TEST_RETURN_ON_FAIL(wh_Client_BatchRequest(client));
+    WH_TEST_RETURN_ON_FAIL(wh_Server_HandleRequestMessage(server));
+    ret = wh_Client_BatchResponse(client, &count);
+    WH_TEST_ASSERT_RETURN(ret == WH_ERROR_CANCEL);
+    WH_TEST_RETURN_ON_FAIL(
+        wh_Server_RegisterCustomCb(server, cbId, _customServerCb));
+#endif /* WOLFHSM_CFG_BATCH */
+    client->cancelCb = _cancelTestClientCb;
+
+    return WH_ERROR_OK;
+}
+#endif /* WOLFHSM_CFG_CANCEL_API && WOLFHSM_CFG_ENABLE_CLIENT && \
+          WOLFHSM_CFG_ENABLE_SERVER */
+
+#if defined(WOLFHSM_CFG_CLIENT_WAIT) && defined(WOLFHSM_CFG_ENABLE_CLIENT) && \
+    defined(WOLFHSM_CFG_ENABLE_SERVER)
+static int _waitTestYields = 0;
+
+static void _waitTestYieldCb(void* arg)
+{
+    _waitTestYields++;
+    /* Given a server, run it so a blocking client call can complete */
+    if (arg != NULL) {
+        (void)wh_Server_HandleRequestMessage((whServerContext*)arg);
+    }
+}
+
+static const whClientWaitConfig _waitTestConfig = {
+    .yield_cb = _waitTestYieldCb,
+};
+
+static int _testWaitPolicy(whServerContext* server, whClientContext* client)
+{
+    const whClientWaitPolicy spinYield  = {2, 3, 0};
+    const whClientWaitPolicy yieldBlock = {1, 1, 1000};
+    const whClientWaitPolicy noWait     = {0, 0, 0};
+    char                     send_buffer[REQ_SIZE] = "wait policy";
+    char                     recv_buffer[RESP_SIZE];
+    uint16_t                 size = 0;
+    int                      ret  = 0;
+    int                      i    = 0;
+
+    WH_TEST_PRINT("Testing client wait policy...\n");
+
+    WH_TEST_ASSERT_RETURN(WH_ERROR_BADARGS ==
+                          wh_Client_SetWaitPolicy(client,
+                                                  WH_CLIENT_WAIT_CLASS_COUNT,
+                                                  &spinYield));
+    WH_TEST_ASSERT_RETURN(WH_ERROR_BADARGS ==
+                          wh_Client_SetWaitPolicy(client,
+                                                  WH_CLIENT_WAIT_CLASS_SHORT,
+                                                  NULL));
+
+    /* Spin for 2 polls, then yield on every later poll since block_us is 0 */
+    WH_TEST_RETURN_ON_FAIL(wh_Client_SetWaitPolicy(
+        client, WH_CLIENT_WAIT_CLASS_SHORT, &spinYield));
+    _waitTestYields = 0;
+    WH_TEST_RETURN_ON_FAIL(
+        wh_Client_EchoRequest(client, sizeof(send_buffer), send_buffer));
+    for (i = 0; i < 10; i++) {
+        ret = wh_Client_EchoResponse(client, &size, recv_buffer);
+        WH_TEST_ASSERT_RETURN(ret == WH_ERROR_NOTREADY);
+        /* The non-blocking response function itself never waits */
+        WH_TEST_ASSERT_RETURN(_waitTestYields == ((i < 2) ? 0 : i - 2));
+        WH_TEST_RETURN_ON_FAIL(wh_Client_WaitStep(client));
+    }
+    WH_TEST_ASSERT_RETURN(_waitTestYields == 8);
+    WH_TEST_RETURN_ON_FAIL(wh_Server_HandleRequestMessage(server));
+    WH_TEST_RETURN_ON_FAIL(wh_Client_EchoResponse(client, &size, recv_buffer));
+    WH_TEST_ASSERT_RETURN(size == sizeof(send_buffer));
+    WH_TEST_ASSERT_RETURN(0 == memcmp(send_buffer, recv_buffer, size));
+
+    /* The memory transport cannot block, so blocking polls yield instead */
+    WH_TEST_RETURN_ON_FAIL(wh_Client_SetWaitPolicy(
+        client, WH_CLIENT_WAIT_CLASS_SHORT, &yieldBlock));
+    _waitTestYields = 0;
+    WH_TEST_RETURN_ON_FAIL(
+        wh_Client_EchoRequest(client, sizeof(send_buffer), send_buffer));
+    for (i = 0; i < 5; i++) {
+        ret = wh_Client_EchoResponse(client, &size, recv_buffer);
+        WH_TEST_ASSERT_RETURN(ret == WH_ERROR_NOTREADY);
+        WH_TEST_RETURN_ON_FAIL(wh_Client_WaitStep(client));
+    }
+    WH_TEST_ASSERT_RETURN(_waitTestYields == 4);
+    WH_TEST_RETURN_ON_FAIL(wh_Server_HandleRequestMessage(server));
+    WH_TEST_RETURN_ON_FAIL(wh_Client_EchoResponse(client, &size, recv_buffer));
+    WH_TEST_ASSERT_RETURN(size == sizeof(send_buffer));
+
+    /* The wait state restarts with each request */
+    _waitTestYields = 0;
+    WH_TEST_RETURN_ON_FAIL(
+        wh_Client_EchoRequest(client, sizeof(send_buffer), send_buffer));
+    ret = wh_Client_EchoResponse(client, &size, recv_buffer);
+    WH_TEST_ASSERT_RETURN(ret == WH_ERROR_NOTREADY);
+    WH_TEST_RETURN_ON_FAIL(wh_Client_WaitStep(client));
+    WH_TEST_ASSERT_RETURN(_waitTestYields == 0);
+    WH_TEST_RETURN_ON_FAIL(wh_Server_HandleRequestMessage(server));
+    WH_TEST_RETURN_ON_FAIL(wh_Client_EchoResponse(client, &size, recv_buffer));
+
+#if !defined(WOLFHSM_CFG_NO_CRYPTO) && !defined(NO_SHA256)
+    {
+        /* A blocking crypto call waits with the short policy between polls,
+         * so it completes once the yield runs the server */
+        const uint8_t msg[] = "wait policy";
+        uint8_t       digest[WC_SHA256_DIGEST_SIZE];
+        uint8_t       expected[WC_SHA256_DIGEST_SIZE];
+        wc_Sha256     sha[1];
+        const whClientWaitPolicy longPolicy =
+            client->wait.policy[WH_CLIENT_WAIT_CLASS_LONG];
+
+        WH_TEST_RETURN_ON_FAIL(wc_InitSha256_ex(sha, NULL, INVALID_DEVID));
+        WH_TEST_RETURN_ON_FAIL(wc_Sha256Update(sha, msg, sizeof(msg)));
+        WH_TEST_RETURN_ON_FAIL(wc_Sha256Final(sha, expected));
+        wc_Sha256Free(sha);
+
+        WH_TEST_RETURN_ON_FAIL(wh_Client_SetWaitPolicy(
+            client, WH_CLIENT_WAIT_CLASS_SHORT, &spinYield));
+        WH_TEST_RETURN_ON_FAIL(wh_Client_SetWaitPolicy(
+            client, WH_CLIENT_WAIT_CLASS_LONG, &noWait));
+        client->wait.yield_arg = server;
+        _waitTestYields        = 0;
+        WH_TEST_RETURN_ON_FAIL(wc_InitSha256_ex(sha, NULL, INVALID_DEVID));
+        WH_TEST_RETURN_ON_FAIL(
+            wh_Client_Sha256(client, sha, msg, sizeof(msg), digest));
+        client->wait.yield_arg = NULL;
+        WH_TEST_ASSERT_RETURN(0 == memcmp(digest, expected, sizeof(digest)));
+        /* Two spinning polls, then one yield that ran the server */
+        WH_TEST_ASSERT_RETURN(_waitTestYields == 1);
+        WH_TEST_ASSERT_RETURN(client->wait.polls == 3);
+        WH_TEST_RETURN_ON_FAIL(wh_Client_SetWaitPolicy(
+            client, WH_CLIENT_WAIT_CLASS_LONG, &longPolicy));
+    }
+#endif /* !WOLFHSM_CFG_NO_CRYPTO && !NO_SHA256 */
+
+    WH_TEST_RETURN_ON_FAIL(
+        wh_Client_SetWaitPolicy(client, WH_CLIENT_WAIT_CLASS_SHORT, &noWait));
+
+    return WH_ERROR_OK;
+}
+#endif /* WOLFHSM_CFG_CLIENT_WAIT && WOLFHSM_CFG_ENABLE_CLIENT && \
+          WOLFHSM_CFG_ENABLE_SERVER */
+
+#if defined(WOLFHSM_CFG_BATCH) && defined(WOLFHSM_CFG_ENABLE_CLIENT) && \
+    defined(WOLFHSM_CFG_ENABLE_SERVER)
+static int _testBatch(whServerContext* server, whClientContext* client)
+{
+    const char                         echo[]    = "batched echo";
+    const whNvmId                      counterId = 7;
+    whMessageCounter_InitRequest       initReq   = {0};
+    whMessageCounter_IncrementRequest  incReq    = {0};
+    whMessageCounter_ReadRequest       readReq   = {0};
+    whMessageCounter_DestroyRequest    delReq    = {0};
+    whMessageCounter_InitResponse      initResp  = {0};
+    whMessageCounter_ReadResponse      readResp  = {0};
+    whMessageNvm_GetAvailableResponse  availResp = {0};
+    uint64_t   raw[(sizeof(whMessageBatch_Request) * 2 +
+                    sizeof(whMessageBatch_RequestItem)) / sizeof(uint64_t)];
+    whMessageBatch_Request*     rawReq  = NULL;
+    whMessageBatch_RequestItem* rawItem = NULL;
+    static uint8_t big[WOLFHSM_CFG_COMM_DATA_LEN / 2];
+    const void*    data  = NULL;
+    uint16_t       count = 0;
+    uint16_t       size  = 0;
+    uint32_t       counter = 0;
+    int32_t        rc    = 0;
+    int            ret   = 0;
+    size_t         i     = 0;
+
+    WH_TEST_PRINT("Testing batched requests...\n");
+
+    initReq.counterId = counterId;
+    initReq.counter   = 5;
+    incReq.counterId  = counterId;
+    readReq.counterId = counterId;
+    delReq.counterId  = counterId;
+
+    WH_TEST_RETURN_ON_FAIL(wh_Client_BatchStart(client));
+    WH_TEST_RETURN_ON_FAIL(
+        wh_Client_BatchAdd(client, WH_MESSAGE_GROUP_COMM,
+                           WH_MESSAGE_COMM_ACTION_ECHO, sizeof(echo), echo,
+                           sizeof(echo)));
+    WH_TEST_RETURN_ON_FAIL(wh_Client_BatchAdd(
+        client, WH_MESSAGE_GROUP_COUNTER, WH_COUNTER_INIT, sizeof(initReq),
+        &initReq, sizeof(whMessageCounter_InitResponse)));
+    WH_TEST_RETURN_ON_FAIL(wh_Client_BatchAdd(
+        client, WH_MESSAGE_GROUP_COUNTER, WH_COUNTER_INCREMENT, sizeof(incReq),
+        &incReq, sizeof(whMessageCounter_IncrementResponse)));
+    WH_TEST_RETURN_ON_FAIL(wh_Client_BatchAdd(
+        client, WH_MESSAGE_GROUP_COUNTER, WH_COUNTER_READ, sizeof(readReq),
+        &readReq, sizeof(whMessageCounter_ReadResponse)));
+    WH_TEST_RETURN_ON_FAIL(wh_Client_BatchAdd(
+        client, WH_MESSAGE_GROUP_NVM, WH_MESSAGE_NVM_ACTION_GETAVAILABLE, 0,
+        NULL, sizeof(whMessageNvm_GetAvailableResponse)));
+    /* Response larger than its reservation */
+    WH_TEST_RETURN_ON_FAIL(wh_Client_BatchAdd(client, WH_MESSAGE_GROUP_COMM,
+                                              WH_MESSAGE_COMM_ACTION_ECHO,
+                                              sizeof(echo), echo, 4));
+    /* Unknown group */
+    WH_TEST_RETURN_ON_FAIL(wh_Client_BatchAdd(
+        client, WH_MESSAGE_GROUP_RESERVED, 1, 0, NULL, 0));
+    WH_TEST_RETURN_ON_FAIL(wh_Client_BatchAdd(
+        client, WH_MESSAGE_GROUP_COUNTER, WH_COUNTER_DESTROY, sizeof(delReq),
+        &delReq, sizeof(whMessageCounter_DestroyResponse)));
+    /* Batches may not be nested */
+    WH_TEST_ASSERT_RETURN(WH_ERROR_BADARGS ==
+                          wh_Client_BatchAdd(client, WH_MESSAGE_GROUP_BATCH,
+                                             WH_MESSAGE_BATCH_ACTION_EXEC, 0,
+                                             NULL, 0));
+
+    WH_TEST_RETURN_ON_FAIL(wh_Client_BatchRequest(client));
+    WH_TEST_RETURN_ON_FAIL(wh_Server_HandleRequestMessage(server));
+    WH_TEST_RETURN_ON_FAIL(wh_Client_BatchResponse(client, &count));
+    WH_TEST_ASSERT_RETURN(count == 8);
+
+    WH_TEST_RETURN_ON_FAIL(wh_Client_BatchGetResult(client, 0, &rc, &size,
+                                                    &data));
+    WH_TEST_ASSERT_RETURN(rc == WH_ERROR_OK);
+    WH_TEST_ASSERT_RETURN(size == sizeof(echo));
+    WH_TEST_ASSERT_RETURN(0 == memcmp(data, echo, sizeof(echo)));
+
+    WH_TEST_RETURN_ON_FAIL(wh_Client_BatchGetResult(client, 1, &rc, &size,
+                                                    &data));
+    WH_TEST_ASSERT_RETURN(rc == WH_ERROR_OK);
+    WH_TEST_ASSERT_RETURN(size == sizeof(initResp));
+    memcpy(&initResp, data, sizeof(initResp));
+    WH_TEST_ASSERT_RETURN(initResp.rc == WH_ERROR_OK);
+    WH_TEST_ASSERT_RETURN(initResp.counter == 5);
+
+    for (i = 2; i <= 3; i++) {
+        WH_TEST_RETURN_ON_FAIL(wh_Client_BatchGetResult(
+            client, (uint16_t)i, &rc, &size, &data));
+        WH_TEST_ASSERT_RETURN(rc == WH_ERROR_OK);
+        WH_TEST_ASSERT_RETURN(size == sizeof(readResp));
+        memcpy(&readResp, data, sizeof(readResp));
+        WH_TEST_ASSERT_RETURN(readResp.rc == WH_ERROR_OK);
+        WH_TEST_ASSERT_RETURN(readResp.counter == 6);
+    }
+
+    WH_TEST_RETURN_ON_FAIL(wh_Client_BatchGetResult(client, 4, &rc, &size,
+                                                    &data));
+    WH_TEST_ASSERT_RETURN(rc == WH_ERROR_OK);
+    WH_TEST_ASSERT_RETURN(size == sizeof(availResp));
+    memcpy(&availResp, data, sizeof(availResp));
+    WH_TEST_ASSERT_RETURN(availResp.rc == WH_ERROR_OK);
+
+    WH_TEST_RETURN_ON_FAIL(wh_Client_BatchGetResult(client, 5, &rc, &size,
+                                                    NULL));
+    WH_TEST_ASSERT_RETURN(rc == WH_ERROR_BUFFER_SIZE);
+    WH_TEST_ASSERT_RETURN(size == 0);
+
+    WH_TEST_RETURN_ON_FAIL(wh_Client_BatchGetResult(client, 6, &rc, &size,
+                                                    NULL));
+    WH_TEST_ASSERT_RETURN(rc == WH_ERROR_NOTIMPL);
+    WH_TEST_ASSERT_RETURN(size == 0);
+
+    WH_TEST_RETURN_ON_FAIL(wh_Client_BatchGetResult(client, 7, &rc, NULL,
+                                                    NULL));
+    WH_TEST_ASSERT_RETURN(rc == WH_ERROR_OK);
+
+    WH_TEST_ASSERT_RETURN(WH_ERROR_BADARGS ==
+                          wh_Client_BatchGetResult(client, 8, &rc, NULL, NULL));
+
+    /* The counter was destroyed by the last item */
+    WH_TEST_RETURN_ON_FAIL(wh_Client_CounterReadRequest(client, counterId));
+    WH_TEST_RETURN_ON_FAIL(wh_Server_HandleRequestMessage(server));
+    ret = wh_Client_CounterReadResponse(client, &counter);
+    WH_TEST_ASSERT_RETURN(ret == WH_ERROR_NOTFOUND);
+
+    /* Fill half the comm buffer with one item. A second cannot fit */
+    for (i = 0; i < sizeof(big); i++) {
+        big[i] = (uint8_t)i;
+    }
+    WH_TEST_RETURN_ON_FAIL(wh_Client_BatchStart(client));
+    WH_TEST_ASSERT_RETURN(WH_ERROR_BUFFER_SIZE ==
+                          wh_Client_BatchAdd(client, WH_MESSAGE_GROUP_COMM,
+                                             WH_MESSAGE_COMM_ACTION_ECHO, 0,
+                                             NULL, WOLFHSM_CFG_COMM_DATA_LEN));
+    WH_TEST_RETURN_ON_FAIL(wh_Client_BatchAdd(
+        client, WH_MESSAGE_GROUP_COMM, WH_MESSAGE_COMM_ACTION_ECHO,
+        sizeof(big), big, sizeof(big)));
+    WH_TEST_ASSERT_RETURN(WH_ERROR_BUFFER_SIZE ==
+                          wh_Client_BatchAdd(client, WH_MESSAGE_GROUP_COMM,
+                                             WH_MESSAGE_COMM_ACTION_ECHO,
+                                             sizeof(big), big, sizeof(big)));
+
+    /* Larger payloads survive the move to the end of the server buffer */
+    WH_TEST_RETURN_ON_FAIL(wh_Client_BatchStart(client));
+    for (i = 0; i < 2; i++) {
+        WH_TEST_RETURN_ON_FAIL(wh_Client_BatchAdd(
+            client, WH_MESSAGE_GROUP_COMM, WH_MESSAGE_COMM_ACTION_ECHO,
+            BUFFER_SIZE / 4, big + i, BUFFER_SIZE / 4));
+    }
+    WH_TEST_RETURN_ON_FAIL(wh_Client_BatchRequest(client));
+    WH_TEST_RETURN_ON_FAIL(wh_Server_HandleRequestMessage(server));
+    WH_TEST_RETURN_ON_FAIL(wh_Client_BatchResponse(client, &count));
+    WH_TEST_ASSERT_RETURN(count == 2);
+    for (i = 0; i < 2; i++) {
+        WH_TEST_RETURN_ON_FAIL(wh_Client_BatchGetResult(
+            client, (uint16_t)i, &rc, &size, &data));
+        WH_TEST_ASSERT_RETURN(rc == WH_ERROR_OK);
+        WH_TEST_ASSERT_RETURN(size == BUFFER_SIZE / 4);
+        WH_TEST_ASSERT_RETURN(0 == memcmp(data, big + i, BUFFER_SIZE / 4));
+    }
+
+    /* The server rejects a nested batch built by hand */
+    memset(raw, 0, sizeof(raw));
+    rawReq         = (whMessageBatch_Request*)raw;
+    rawItem        = (whMessageBatch_RequestItem*)(rawReq + 1);
+    rawReq->count  = 1;
+    rawItem->kind  = WH_MESSAGE_KIND(WH_MESSAGE_GROUP_BATCH,
+                                     WH_MESSAGE_BATCH_ACTION_EXEC);
+    rawItem->size  = sizeof(whMessageBatch_Request);
+    rawItem->resp_max = sizeof(whMessageBatch_Response);
+    WH_TEST_RETURN_ON_FAIL(wh_Client_SendRequest(
+        client, WH_MESSAGE_GROUP_BATCH, WH_MESSAGE_BATCH_ACTION_EXEC,
+        sizeof(raw), raw));
+    WH_TEST_RETURN_ON_FAIL(wh_Server_HandleRequestMessage(server));
+    WH_TEST_RETURN_ON_FAIL(wh_Client_BatchResponse(client, &count));
+    WH_TEST_ASSERT_RETURN(count == 1);
+    WH_TEST_RETURN_ON_FAIL(wh_Client_BatchGetResult(client, 0, &rc, &size,
+                                                    NULL));
+    WH_TEST_ASSERT_RETURN(rc == WH_ERROR_BADARGS);
+    WH_TEST_ASSERT_RETURN(size == 0);
+
+    /* A truncated batch is rejected as a whole */
+    rawReq->count = 2;
+    WH_TEST_RETURN_ON_FAIL(wh_Client_SendRequest(
+        client, WH_MESSAGE_GROUP_BATCH, WH_MESSAGE_BATCH_ACTION_EXEC,
+        sizeof(raw), raw));
+    WH_TEST_RETURN_ON_FAIL(wh_Server_HandleRequestMessage(server));
+    ret = wh_Client_BatchResponse(client, &count);
+    WH_TEST_ASSERT_RETURN(ret == WH_ERROR_ABORTED);
+
+    return WH_ERROR_OK;
+}
+#endif /* WOLFHSM_CFG_BATCH && WOLFHSM_CFG_ENABLE_CLIENT && \
+          WOLFHSM_CFG_ENABLE_SERVER */
+
 #if defined(WOLFHSM_CFG_ENABLE_CLIENT) && defined(WOLFHSM_CFG_ENABLE_SERVER)
 static int _clientServerSequentialTestConnectCb(void*           context,
                                                 whCommConnected connected)
@@ -620,6 +1301,12 @@ int whTest_ClientServerSequential(whTestNvmBackendType nvmType)
 
     whClientConfig c_conf[1] = {{
         .comm = cc_conf,
+#ifdef WOLFHSM_CFG_CLIENT_WAIT
+        .waitConfig = &_waitTestConfig,
+#endif /* WOLFHSM_CFG_CLIENT_WAIT */
+#ifdef WOLFHSM_CFG_CANCEL_API
+        .cancelCb = _cancelTestClientCb,
+#endif /* WOLFHSM_CFG_CANCEL_API */
     }};
 
     /* Server configuration/contexts */
@@ -1129,6 +1816,24 @@ int whTest_ClientServerSequential(whTestNvmBackendType nvmType)
     /* Test custom registered callbacks */
     WH_TEST_RETURN_ON_FAIL(_testCallbacks(server, client));
 
+    /* Test requests without response */
+    WH_TEST_RETURN_ON_FAIL(_testNoResp(server, client));
+
+#ifdef WOLFHSM_CFG_CLIENT_WAIT
+    /* Test the client wait policy */
+    WH_TEST_RETURN_ON_FAIL(_testWaitPolicy(server, client));
+#endif /* WOLFHSM_CFG_CLIENT_WAIT */
+
+#ifdef WOLFHSM_CFG_BATCH
+    /* Test batched requests */
+    WH_TEST_RETURN_ON_FAIL(_testBatch(server, client));
+#endif /* WOLFHSM_CFG_BATCH */
+
+#ifdef WOLFHSM_CFG_CANCEL_API
+    /* Test request cancellation */
+    WH_TEST_RETURN_ON_FAIL(_testCancel(server, client));
+#endif /* WOLFHSM_CFG_CANCEL_API */
+
 #ifdef WOLFHSM_CFG_DMA
     /* Test DMA callbacks and address allowlisting */
     WH_TEST_RETURN_ON_FAIL(_testDma(server, client));
@@ -1159,70 +1864,1504 @@ int whTest_ClientServerSequential(whTestNvmBackendType nvmType)
 
     return ret;
 }
-#endif /* WOLFHSM_CFG_ENABLE_CLIENT && WOLFHSM_CFG_ENABLE_SERVER */
 
-#ifdef WOLFHSM_CFG_ENABLE_CLIENT
-int whTest_ClientServerClientConfig(whClientConfig* clientCfg)
+#ifdef WOLFHSM_CFG_CLIENT_PIPELINE
+typedef struct {
+    uint16_t seq;
+    uint16_t size;
+    int      done;
+    int      rc;
+    char     data[REQ_SIZE];
+} _pipelineTestResult;
+
+static int _pipelineTestCb(whClientContext* c, void* cb_arg, int rc,
+                           uint16_t magic, uint16_t group, uint16_t action,
+                           uint16_t seq, uint16_t size, const void* data)
 {
-    int ret = 0;
-    whClientContext client[1] = {0};
+    _pipelineTestResult* result = (_pipelineTestResult*)cb_arg;
+    (void)c;
+
+    WH_TEST_ASSERT_RETURN(result != NULL);
+    WH_TEST_ASSERT_RETURN(seq == result->seq);
+    result->rc   = rc;
+    result->done = 1;
+    if (rc != 0) {
+        WH_TEST_ASSERT_RETURN((size == 0) && (data == NULL));
+        return 0;
+    }
+    WH_TEST_ASSERT_RETURN(magic == WH_COMM_MAGIC_NATIVE);
+    WH_TEST_ASSERT_RETURN(group == WH_MESSAGE_GROUP_COMM);
+    WH_TEST_ASSERT_RETURN(action == WH_MESSAGE_COMM_ACTION_ECHO);
+    WH_TEST_ASSERT_RETURN(size <= sizeof(result->data));
 
-    WH_TEST_RETURN_ON_FAIL(wh_Client_Init(client, clientCfg));
+    memcpy(result->data, data, size);
+    result->size = size;
+    return 0;
+}
 
-    int counter = 1;
-    char recv_buffer[WOLFHSM_CFG_COMM_DATA_LEN] = {0};
-    char send_buffer[WOLFHSM_CFG_COMM_DATA_LEN] = {0};
-    uint16_t send_len = 0;
-    uint16_t recv_len = 0;
+static int whTest_ClientServerPipeline(void)
+{
+    /* Ring transport memory configuration */
+    uint8_t                  req[BUFFER_SIZE];
+    uint8_t                  resp[BUFFER_SIZE];
+    whTransportMemRingConfig tmcf[1] = {{
+        .req        = req,
+        .req_size   = sizeof(req),
+        .resp       = resp,
+        .resp_size  = sizeof(resp),
+        .slot_count = WOLFHSM_CFG_CLIENT_PIPELINE_DEPTH,
+    }};
 
-    int32_t server_rc = 0;
-    uint32_t client_id = 0;
-    uint32_t server_id = 0;
-    uint32_t avail_size = 0;
-    uint32_t reclaim_size = 0;
-    whNvmId avail_objects = 0;
-    whNvmId reclaim_objects = 0;
+    /* Client configuration/contexts */
+    whTransportClientCb             tccb[1]    = {WH_TRANSPORT_MEM_RING_CLIENT_CB};
+    whTransportMemRingClientContext tmcc[1]    = {0};
+    whCommClientConfig              cc_conf[1] = {{
+                     .transport_cb      = tccb,
+                     .transport_context = (void*)tmcc,
+                     .transport_config  = (void*)tmcf,
+                     .client_id         = WH_TEST_DEFAULT_CLIENT_ID,
+                     .connect_cb        = _clientServerSequentialTestConnectCb,
+    }};
+    whClientContext client[1] = {0};
+    whClientConfig  c_conf[1] = {{
+         .comm = cc_conf,
+    }};
 
-    /* Init client/server comms */
-    WH_TEST_RETURN_ON_FAIL(wh_Client_CommInit(client, &client_id, &server_id));
-    WH_TEST_ASSERT_RETURN(client_id == client->comm->client_id);
+    /* Server configuration/contexts */
+    whTransportServerCb             tscb[1]    = {WH_TRANSPORT_MEM_RING_SERVER_CB};
+    whTransportMemRingServerContext tmsc[1]    = {0};
+    whCommServerConfig              cs_conf[1] = {{
+                     .transport_cb      = tscb,
+                     .transport_context = (void*)tmsc,
+                     .transport_config  = (void*)tmcf,
+                     .server_id         = 124,
+    }};
+#ifndef WOLFHSM_CFG_NO_CRYPTO
+    whServerCryptoContext crypto[1] = {0};
+#endif
+    whServerConfig s_conf[1] = {{
+        .comm_config = cs_conf,
+#ifndef WOLFHSM_CFG_NO_CRYPTO
+        .crypto = crypto,
+#endif
+    }};
+    whServerContext server[1] = {0};
 
+    _pipelineTestResult results[WOLFHSM_CFG_CLIENT_PIPELINE_DEPTH];
+    char                send_buffer[REQ_SIZE] = {0};
+    char                recv_buffer[REQ_SIZE] = {0};
+    uint16_t            send_len              = 0;
+    uint16_t            recv_len              = 0;
+    uint16_t            outstanding           = 0;
+#ifndef WOLFHSM_CFG_COMM_NATIVE_ONLY
+    uint16_t            srv_magic             = 0;
+    uint16_t            srv_kind              = 0;
+    uint16_t            srv_seq               = 0;
+    uint16_t            srv_size              = 0;
+#endif
+    int                 i                     = 0;
 
-    for (counter = 0; counter < REPEAT_COUNT; counter++) {
+    memset(results, 0, sizeof(results));
+    clientServerSequentialTestServerCtx = server;
 
-        /* Prepare echo test */
-        send_len =
-            snprintf(send_buffer, sizeof(send_buffer), "Request:%u", counter);
-        (void)snprintf(recv_buffer, sizeof(recv_buffer), "NOTHING RECEIVED");
-        recv_len = 0;
+    WH_TEST_RETURN_ON_FAIL(wh_Server_Init(server, s_conf));
+    WH_TEST_RETURN_ON_FAIL(wh_Client_Init(client, c_conf));
 
-        WH_TEST_RETURN_ON_FAIL(ret = wh_Client_Echo(client, send_len, send_buffer, &recv_len, recv_buffer));
+    /* Nothing outstanding yet */
+    WH_TEST_RETURN_ON_FAIL(wh_Client_PipelineGetOutstanding(client,
+                                                            &outstanding));
+    WH_TEST_ASSERT_RETURN(outstanding == 0);
+    WH_TEST_ASSERT_RETURN(WH_ERROR_BADARGS == wh_Client_PipelinePoll(client));
+
+    /* Fill the pipeline with echo requests before the server runs */
+    for (i = 0; i < WOLFHSM_CFG_CLIENT_PIPELINE_DEPTH; i++) {
+        send_len = snprintf(send_buffer, sizeof(send_buffer),
+                            "Pipelined echo %d", i);
+        WH_TEST_RETURN_ON_FAIL(wh_Client_PipelineSendRequest(
+            client, WH_MESSAGE_GROUP_COMM, WH_MESSAGE_COMM_ACTION_ECHO,
+            send_len, send_buffer, _pipelineTestCb, &results[i],
+            &results[i].seq));
+    }
+    WH_TEST_RETURN_ON_FAIL(wh_Client_PipelineGetOutstanding(client,
+                                                            &outstanding));
+    WH_TEST_ASSERT_RETURN(outstanding == WOLFHSM_CFG_CLIENT_PIPELINE_DEPTH);
 
-        WH_TEST_PRINT("Client Echo:%d, len:%d, %.*s, expected:%.*s\n", ret,
-                      recv_len, recv_len, recv_buffer, send_len, send_buffer);
+    /* Table is full, and non-pipelined requests are refused */
+    WH_TEST_ASSERT_RETURN(WH_ERROR_NOTREADY ==
+                          wh_Client_PipelineSendRequest(
+                              client, WH_MESSAGE_GROUP_COMM,
+                              WH_MESSAGE_COMM_ACTION_ECHO, 0, NULL, NULL, NULL,
+                              NULL));
+    WH_TEST_ASSERT_RETURN(WH_ERROR_BADARGS ==
+                          wh_Client_EchoRequest(client, 0, NULL));
 
-        WH_TEST_ASSERT_RETURN( recv_len == send_len);
-        WH_TEST_ASSERT_RETURN( strncmp(recv_buffer, send_buffer, recv_len) == 0);
-    }
+    /* No responses yet */
+    WH_TEST_ASSERT_RETURN(WH_ERROR_NOTREADY == wh_Client_PipelinePoll(client));
 
-    /* Perform NVM tests */
+    /* Server handles every queued request */
+    for (i = 0; i < WOLFHSM_CFG_CLIENT_PIPELINE_DEPTH; i++) {
+        WH_TEST_RETURN_ON_FAIL(wh_Server_HandleRequestMessage(server));
+    }
+    WH_TEST_ASSERT_RETURN(WH_ERROR_NOTREADY ==
+                          wh_Server_HandleRequestMessage(server));
 
-    WH_TEST_RETURN_ON_FAIL(ret = wh_Client_NvmInit(client, &server_rc, &client_id, &server_id));
-    WH_TEST_ASSERT_RETURN(server_rc == WH_ERROR_OK);
+    /* Complete one, then drain the remainder */
+    WH_TEST_RETURN_ON_FAIL(wh_Client_PipelinePoll(client));
+    WH_TEST_ASSERT_RETURN(results[0].done == 1);
+    WH_TEST_RETURN_ON_FAIL(wh_Client_PipelineDrain(client));
+    WH_TEST_RETURN_ON_FAIL(wh_Client_PipelineGetOutstanding(client,
+                                                            &outstanding));
+    WH_TEST_ASSERT_RETURN(outstanding == 0);
+
+    for (i = 0; i < WOLFHSM_CFG_CLIENT_PIPELINE_DEPTH; i++) {
+        send_len = snprintf(send_buffer, sizeof(send_buffer),
+                            "Pipelined echo %d", i);
+        WH_TEST_ASSERT_RETURN(results[i].done == 1);
+        WH_TEST_ASSERT_RETURN(results[i].rc == 0);
+        WH_TEST_ASSERT_RETURN(results[i].size == send_len);
+        WH_TEST_ASSERT_RETURN(0 ==
+                              memcmp(results[i].data, send_buffer, send_len));
+    }
 
-    WH_TEST_RETURN_ON_FAIL(ret = wh_Client_NvmGetAvailable(
-        client, &server_rc, &avail_size, &avail_objects, &reclaim_size,
-        &reclaim_objects));
+    /* Requests without response are reaped from the ring as they complete,
+     * so more than the slot count may be sent */
+    for (i = 0; i < 2 * WOLFHSM_CFG_CLIENT_PIPELINE_DEPTH; i++) {
+        WH_TEST_RETURN_ON_FAIL(wh_Client_SendRequestNoResp(
+            client, WH_MESSAGE_GROUP_COMM, WH_MESSAGE_COMM_ACTION_ECHO, 0,
+            NULL));
+        WH_TEST_RETURN_ON_FAIL(wh_Server_HandleRequestMessage(server));
+    }
 
-    WH_TEST_PRINT("Client NvmGetAvailable:%d, server_rc:%d avail_size:%d "
-                  "avail_objects:%d, reclaim_size:%d reclaim_objects:%d\n",
-                  ret, (int)server_rc, (int)avail_size, (int)avail_objects,
-                  (int)reclaim_size, (int)reclaim_objects);
-    WH_TEST_ASSERT_RETURN(server_rc == WH_ERROR_OK);
-    WH_TEST_ASSERT_RETURN(avail_objects == WOLFHSM_CFG_NVM_OBJECT_COUNT);
+    /* A pipelined request may follow one without response, but not the
+     * other way around until the pipeline is empty */
+    memset(results, 0, sizeof(results));
+    send_len = snprintf(send_buffer, sizeof(send_buffer), "Pipelined echo 0");
+    WH_TEST_RETURN_ON_FAIL(wh_Client_SendRequestNoResp(
+        client, WH_MESSAGE_GROUP_COMM, WH_MESSAGE_COMM_ACTION_ECHO, 0, NULL));
+    WH_TEST_RETURN_ON_FAIL(wh_Client_PipelineSendRequest(
+        client, WH_MESSAGE_GROUP_COMM, WH_MESSAGE_COMM_ACTION_ECHO, send_len,
+        send_buffer, _pipelineTestCb, &results[0], &results[0].seq));
+    WH_TEST_ASSERT_RETURN(WH_ERROR_NOTREADY ==
+                          wh_Client_SendRequestNoResp(
+                              client, WH_MESSAGE_GROUP_COMM,
+                              WH_MESSAGE_COMM_ACTION_ECHO, 0, NULL));
+    WH_TEST_ASSERT_RETURN(WH_ERROR_NOTREADY ==
+                          wh_Client_CounterIncrementNoResp(client, 1));
+    WH_TEST_RETURN_ON_FAIL(wh_Server_HandleRequestMessage(server));
+    WH_TEST_RETURN_ON_FAIL(wh_Server_HandleRequestMessage(server));
+    WH_TEST_ASSERT_RETURN(WH_ERROR_NOTREADY ==
+                          wh_Server_HandleRequestMessage(server));
+    WH_TEST_RETURN_ON_FAIL(wh_Client_PipelineDrain(client));
+    WH_TEST_ASSERT_RETURN(results[0].done == 1);
+    WH_TEST_ASSERT_RETURN(results[0].size == send_len);
+    WH_TEST_RETURN_ON_FAIL(wh_Client_SendRequestNoResp(
+        client, WH_MESSAGE_GROUP_COMM, WH_MESSAGE_COMM_ACTION_ECHO, 0, NULL));
+    WH_TEST_RETURN_ON_FAIL(wh_Server_HandleRequestMessage(server));
 
-    /* Reset NVM state after flag tests */
-    WH_TEST_RETURN_ON_FAIL(ret = wh_Client_NvmCleanup(client, &server_rc));
+    /* A response that does not answer its request is reported to the
+     * request's callback with its sequence number */
+    memset(results, 0, sizeof(results));
+    WH_TEST_RETURN_ON_FAIL(wh_Client_PipelineSendRequest(
+        client, WH_MESSAGE_GROUP_COMM, WH_MESSAGE_COMM_ACTION_ECHO, send_len,
+        send_buffer, _pipelineTestCb, &results[0], &results[0].seq));
+    for (i = 0; i < WOLFHSM_CFG_CLIENT_PIPELINE_DEPTH; i++) {
+        if (client->pipeline.entry[i].in_use != 0) {
+            client->pipeline.entry[i].kind = WH_MESSAGE_KIND(
+                WH_MESSAGE_GROUP_COMM, WH_MESSAGE_COMM_ACTION_INFO);
+        }
+    }
+    WH_TEST_RETURN_ON_FAIL(wh_Server_HandleRequestMessage(server));
+    WH_TEST_RETURN_ON_FAIL(wh_Client_PipelinePoll(client));
+    WH_TEST_ASSERT_RETURN(results[0].done == 1);
+    WH_TEST_ASSERT_RETURN(results[0].rc == WH_ERROR_ABORTED);
+    WH_TEST_RETURN_ON_FAIL(wh_Client_PipelineGetOutstanding(client,
+                                                            &outstanding));
+    WH_TEST_ASSERT_RETURN(outstanding == 0);
+
+    /* Without a callback, the error is returned */
+    WH_TEST_RETURN_ON_FAIL(wh_Client_PipelineSendRequest(
+        client, WH_MESSAGE_GROUP_COMM, WH_MESSAGE_COMM_ACTION_ECHO, send_len,
+        send_buffer, NULL, NULL, NULL));
+    for (i = 0; i < WOLFHSM_CFG_CLIENT_PIPELINE_DEPTH; i++) {
+        if (client->pipeline.entry[i].in_use != 0) {
+            client->pipeline.entry[i].kind = WH_MESSAGE_KIND(
+                WH_MESSAGE_GROUP_COMM, WH_MESSAGE_COMM_ACTION_INFO);
+        }
+    }
+    WH_TEST_RETURN_ON_FAIL(wh_Server_HandleRequestMessage(server));
+    WH_TEST_ASSERT_RETURN(WH_ERROR_ABORTED == wh_Client_PipelinePoll(client));
+
+#ifndef WOLFHSM_CFG_COMM_NATIVE_ONLY
+    /* A response in swapped byte order is rejected, as for a regular
+     * request.  Native-only builds drop it in the comm layer instead */
+    memset(results, 0, sizeof(results));
+    WH_TEST_RETURN_ON_FAIL(wh_Client_PipelineSendRequest(
+        client, WH_MESSAGE_GROUP_COMM, WH_MESSAGE_COMM_ACTION_ECHO, send_len,
+        send_buffer, _pipelineTestCb, &results[0], &results[0].seq));
+    WH_TEST_RETURN_ON_FAIL(wh_CommServer_RecvRequest(
+        server->comm, &srv_magic, &srv_kind, &srv_seq, &srv_size,
+        recv_buffer));
+    WH_TEST_RETURN_ON_FAIL(wh_CommServer_SendResponse(
+        server->comm, WH_COMM_MAGIC_SWAP, srv_kind, srv_seq, srv_size,
+        recv_buffer));
+    WH_TEST_RETURN_ON_FAIL(wh_Client_PipelinePoll(client));
+    WH_TEST_ASSERT_RETURN(results[0].done == 1);
+    WH_TEST_ASSERT_RETURN(results[0].rc == WH_ERROR_ABORTED);
+#endif /* !WOLFHSM_CFG_COMM_NATIVE_ONLY */
+
+#ifdef WOLFHSM_CFG_CLIENT_WAIT
+    /* Draining waits between polls, here yielding to run the server */
+    memset(results, 0, sizeof(results));
+    client->wait.yield_cb  = _waitTestYieldCb;
+    client->wait.yield_arg = server;
+    _waitTestYields        = 0;
+    for (i = 0; i < 2; i++) {
+        WH_TEST_RETURN_ON_FAIL(wh_Client_PipelineSendRequest(
+            client, WH_MESSAGE_GROUP_COMM, WH_MESSAGE_COMM_ACTION_ECHO,
+            send_len, send_buffer, _pipelineTestCb, &results[i],
+            &results[i].seq));
+    }
+    WH_TEST_RETURN_ON_FAIL(wh_Client_PipelineDrain(client));
+    WH_TEST_ASSERT_RETURN((results[0].done == 1) && (results[1].done == 1));
+    WH_TEST_ASSERT_RETURN(_waitTestYields == 2);
+    client->wait.yield_cb  = NULL;
+    client->wait.yield_arg = NULL;
+#endif /* WOLFHSM_CFG_CLIENT_WAIT */
+
+    /* Regular requests work again once the pipeline is empty */
+    send_len = snprintf(send_buffer, sizeof(send_buffer), "After pipeline");
+    WH_TEST_RETURN_ON_FAIL(wh_Client_EchoRequest(client, send_len, send_buffer));
+    WH_TEST_RETURN_ON_FAIL(wh_Server_HandleRequestMessage(server));
+    WH_TEST_RETURN_ON_FAIL(wh_Client_EchoResponse(client, &recv_len,
+                                                  recv_buffer));
+    WH_TEST_ASSERT_RETURN(recv_len == send_len);
+    WH_TEST_ASSERT_RETURN(0 == memcmp(recv_buffer, send_buffer, send_len));
+
+    WH_TEST_RETURN_ON_FAIL(wh_Server_Cleanup(server));
+    WH_TEST_RETURN_ON_FAIL(wh_Client_Cleanup(client));
+
+    return 0;
+}
+#endif /* WOLFHSM_CFG_CLIENT_PIPELINE */
+
+static int whTest_ClientServerDirect(void)
+{
+    /* Direct transport context shared by the client and server */
+    whServerContext          server[1] = {0};
+    whTransportDirectConfig  tdcf[1]   = {{
+          .server = server,
+    }};
+    whTransportDirectContext tdctx[1]  = {0};
+    whServerContext          server_other[1]  = {0};
+    whTransportDirectConfig  tdcf_other[1]    = {{
+         .server = server_other,
+    }};
+
+    /* Client configuration/contexts */
+    whTransportClientCb tccb[1]    = {WH_TRANSPORT_DIRECT_CLIENT_CB};
+    whCommClientConfig  cc_conf[1] = {{
+         .transport_cb      = tccb,
+         .transport_context = (void*)tdctx,
+         .transport_config  = (void*)tdcf,
+         .client_id         = WH_TEST_DEFAULT_CLIENT_ID,
+    }};
+    whClientContext client[1] = {0};
+    whClientConfig  c_conf[1] = {{
+         .comm = cc_conf,
+    }};
+
+    /* Server configuration/contexts */
+    whTransportServerCb tscb[1]    = {WH_TRANSPORT_DIRECT_SERVER_CB};
+    whCommServerConfig  cs_conf[1] = {{
+         .transport_cb      = tscb,
+         .transport_context = (void*)tdctx,
+         .transport_config  = (void*)tdcf,
+         .server_id         = 124,
+    }};
+#ifndef WOLFHSM_CFG_NO_CRYPTO
+    whServerCryptoContext crypto[1] = {0};
+#endif
+    whServerConfig s_conf[1] = {{
+        .comm_config = cs_conf,
+#ifndef WOLFHSM_CFG_NO_CRYPTO
+        .crypto = crypto,
+#endif
+    }};
+
+    char     send_buffer[REQ_SIZE] = {0};
+    char     recv_buffer[REQ_SIZE] = {0};
+    uint16_t send_len              = 0;
+    uint16_t recv_len              = 0;
+    int      i                     = 0;
+
+    WH_TEST_RETURN_ON_FAIL(wh_Server_Init(server, s_conf));
+    WH_TEST_ASSERT_RETURN(server->connected == WH_COMM_DISCONNECTED);
+    WH_TEST_RETURN_ON_FAIL(wh_Client_Init(client, c_conf));
+
+    /* Client Init connects the server */
+    WH_TEST_ASSERT_RETURN(server->connected == WH_COMM_CONNECTED);
+
+    /* The server works on requests in place in the shared buffer */
+    WH_TEST_ASSERT_RETURN(wh_CommServer_GetDataPtr(server->comm) ==
+                          (uint8_t*)tdctx->buffer + sizeof(whCommHeader));
+
+    /* Blocking calls complete without any server loop */
+    for (i = 0; i < REPEAT_COUNT; i++) {
+        send_len = snprintf(send_buffer, sizeof(send_buffer),
+                            "Direct echo %d", i);
+        WH_TEST_RETURN_ON_FAIL(wh_Client_Echo(client, send_len, send_buffer,
+                                              &recv_len, recv_buffer));
+        WH_TEST_ASSERT_RETURN(recv_len == send_len);
+        WH_TEST_ASSERT_RETURN(0 == memcmp(recv_buffer, send_buffer, send_len));
+    }
+
+    /* Only one request may be outstanding */
+    send_len = snprintf(send_buffer, sizeof(send_buffer), "Split echo");
+    WH_TEST_RETURN_ON_FAIL(wh_Client_EchoRequest(client, send_len, send_buffer));
+    WH_TEST_ASSERT_RETURN(WH_ERROR_NOTREADY ==
+                          wh_TransportDirect_SendRequest(tdctx, 0, NULL));
+    WH_TEST_RETURN_ON_FAIL(wh_Client_EchoResponse(client, &recv_len,
+                                                  recv_buffer));
+    WH_TEST_ASSERT_RETURN(recv_len == send_len);
+    WH_TEST_ASSERT_RETURN(0 == memcmp(recv_buffer, send_buffer, send_len));
+    WH_TEST_ASSERT_RETURN(WH_ERROR_NOTREADY ==
+                          wh_Client_EchoResponse(client, &recv_len,
+                                                 recv_buffer));
+
+    /* A request that is not handled while the server is disconnected is
+     * dispatched again when the client polls for the response */
+    WH_TEST_RETURN_ON_FAIL(
+        wh_Server_SetConnected(server, WH_COMM_DISCONNECTED));
+    WH_TEST_RETURN_ON_FAIL(wh_Client_EchoRequest(client, send_len, send_buffer));
+    WH_TEST_ASSERT_RETURN(WH_ERROR_NOTREADY ==
+                          wh_Client_EchoResponse(client, &recv_len,
+                                                 recv_buffer));
+    WH_TEST_RETURN_ON_FAIL(wh_Server_SetConnected(server, WH_COMM_CONNECTED));
+    WH_TEST_RETURN_ON_FAIL(wh_Client_EchoResponse(client, &recv_len,
+                                                  recv_buffer));
+    WH_TEST_ASSERT_RETURN(recv_len == send_len);
+
+    /* Requests without response leave the buffer free for the next one */
+    WH_TEST_RETURN_ON_FAIL(wh_Client_SendRequestNoResp(
+        client, WH_MESSAGE_GROUP_COMM, WH_MESSAGE_COMM_ACTION_ECHO, 0, NULL));
+    WH_TEST_RETURN_ON_FAIL(wh_Client_Echo(client, send_len, send_buffer,
+                                          &recv_len, recv_buffer));
+    WH_TEST_ASSERT_RETURN(recv_len == send_len);
+
+    /* A second server may not share the context */
+    WH_TEST_ASSERT_RETURN(WH_ERROR_BADARGS ==
+                          wh_TransportDirect_InitListen(
+                              tdctx, tdcf_other, NULL, NULL));
+
+    /* Client Cleanup disconnects the server */
+    WH_TEST_RETURN_ON_FAIL(wh_Client_Cleanup(client));
+    WH_TEST_ASSERT_RETURN(server->connected == WH_COMM_DISCONNECTED);
+    WH_TEST_RETURN_ON_FAIL(wh_Server_Cleanup(server));
+
+    return 0;
+}
+
+#ifdef WOLFHSM_CFG_BATCH
+/* The direct transport carries a full comm buffer, so a batch can fill the
+ * server buffer and a response past its reservation reaches the sub-requests
+ * that are still unread */
+static int whTest_ClientServerBatchOverrun(void)
+{
+    whServerContext          server[1] = {0};
+    whTransportDirectConfig  tdcf[1]   = {{
+          .server = server,
+    }};
+    whTransportDirectContext tdctx[1]  = {0};
+
+    /* Client configuration/contexts */
+    whTransportClientCb tccb[1]    = {WH_TRANSPORT_DIRECT_CLIENT_CB};
+    whCommClientConfig  cc_conf[1] = {{
+         .transport_cb      = tccb,
+         .transport_context = (void*)tdctx,
+         .transport_config  = (void*)tdcf,
+         .client_id         = WH_TEST_DEFAULT_CLIENT_ID,
+    }};
+    whClientContext client[1] = {0};
+    whClientConfig  c_conf[1] = {{
+         .comm = cc_conf,
+    }};
+
+    /* Server configuration/contexts */
+    whTransportServerCb tscb[1]    = {WH_TRANSPORT_DIRECT_SERVER_CB};
+    whCommServerConfig  cs_conf[1] = {{
+         .transport_cb      = tscb,
+         .transport_context = (void*)tdctx,
+         .transport_config  = (void*)tdcf,
+         .server_id         = 124,
+    }};
+#ifndef WOLFHSM_CFG_NO_CRYPTO
+    whServerCryptoContext crypto[1] = {0};
+#endif
+    whServerConfig s_conf[1] = {{
+        .comm_config = cs_conf,
+#ifndef WOLFHSM_CFG_NO_CRYPTO
+        .crypto = crypto,
+#endif
+    }};
+
+    /* Largest echo that fits behind an item with no reservation */
+    static uint8_t fill[WOLFHSM_CFG_COMM_DATA_LEN -
+                        sizeof(whMessageBatch_Response) -
+                        sizeof(whMessageBatch_ResponseItem) -
+                        sizeof(whMessageBatch_RequestItem)];
+    whMessageCommInfoResponse info  = {0};
+    const void*               data  = NULL;
+    uint16_t                  count = 0;
+    uint16_t                  size  = 0;
+    int32_t                   rc    = 0;
+    int                       ret   = 0;
+
+    WH_TEST_RETURN_ON_FAIL(wh_Server_Init(server, s_conf));
+    WH_TEST_RETURN_ON_FAIL(wh_Client_Init(client, c_conf));
+
+    /* The same batch runs when the info response has room */
+    WH_TEST_RETURN_ON_FAIL(wh_Client_BatchStart(client));
+    WH_TEST_RETURN_ON_FAIL(wh_Client_BatchAdd(
+        client, WH_MESSAGE_GROUP_COMM, WH_MESSAGE_COMM_ACTION_INFO, 0, NULL,
+        sizeof(info)));
+    WH_TEST_RETURN_ON_FAIL(wh_Client_BatchAdd(
+        client, WH_MESSAGE_GROUP_COMM, WH_MESSAGE_COMM_ACTION_ECHO,
+        sizeof(fill) - WH_MESSAGE_BATCH_ALIGN(sizeof(info)), fill,
+        sizeof(fill) - WH_MESSAGE_BATCH_ALIGN(sizeof(info))));
+    WH_TEST_RETURN_ON_FAIL(wh_Client_BatchRequest(client));
+    WH_TEST_RETURN_ON_FAIL(wh_Client_BatchResponse(client, &count));
+    WH_TEST_ASSERT_RETURN(count == 2);
+    WH_TEST_RETURN_ON_FAIL(wh_Client_BatchGetResult(client, 0, &rc, &size,
+                                                    &data));
+    WH_TEST_ASSERT_RETURN(rc == WH_ERROR_OK);
+    WH_TEST_ASSERT_RETURN(size == sizeof(info));
+    memcpy(&info, data, sizeof(info));
+    WH_TEST_ASSERT_RETURN(info.cfg_comm_data_len == WOLFHSM_CFG_COMM_DATA_LEN);
+    WH_TEST_RETURN_ON_FAIL(wh_Client_BatchGetResult(client, 1, &rc, &size,
+                                                    NULL));
+    WH_TEST_ASSERT_RETURN(rc == WH_ERROR_OK);
+    WH_TEST_ASSERT_RETURN(size ==
+                          sizeof(fill) - WH_MESSAGE_BATCH_ALIGN(sizeof(info)));
+
+    /* Without a reservation the info response overwrites the echo, so the
+     * batch stops instead of executing it */
+    WH_TEST_RETURN_ON_FAIL(wh_Client_BatchStart(client));
+    WH_TEST_RETURN_ON_FAIL(wh_Client_BatchAdd(
+        client, WH_MESSAGE_GROUP_COMM, WH_MESSAGE_COMM_ACTION_INFO, 0, NULL,
+        0));
+    WH_TEST_RETURN_ON_FAIL(wh_Client_BatchAdd(
+        client, WH_MESSAGE_GROUP_COMM, WH_MESSAGE_COMM_ACTION_ECHO,
+        sizeof(fill), fill, sizeof(fill)));
+    WH_TEST_RETURN_ON_FAIL(wh_Client_BatchRequest(client));
+    ret = wh_Client_BatchResponse(client, &count);
+    WH_TEST_ASSERT_RETURN(ret == WH_ERROR_BUFFER_SIZE);
+
+    WH_TEST_RETURN_ON_FAIL(wh_Client_Cleanup(client));
+    WH_TEST_RETURN_ON_FAIL(wh_Server_Cleanup(server));
+
+    return 0;
+}
+#endif /* WOLFHSM_CFG_BATCH */
+
+#ifdef WOLFHSM_CFG_SERVER_LANES
+/* Memory transport receive that fails while _lanesTestFailRecv is set */
+static int _lanesTestFailRecv = 0;
+static int _lanesTestRecvRequest(void* c, uint16_t* out_len, void* data)
+{
+    if (_lanesTestFailRecv != 0) {
+        return WH_ERROR_ABORTED;
+    }
+    return wh_TransportMem_RecvRequest(c, out_len, data);
+}
+
+static int whTest_ClientServerLanes(void)
+{
+    /* Transport memory configuration, one channel per lane */
+    uint8_t              ctl_req[BUFFER_SIZE];
+    uint8_t              ctl_resp[BUFFER_SIZE];
+    uint8_t              bulk_req[BUFFER_SIZE];
+    uint8_t              bulk_resp[BUFFER_SIZE];
+    whTransportMemConfig tmcf[2] = {{
+        .req       = (whTransportMemCsr*)ctl_req,
+        .req_size  = sizeof(ctl_req),
+        .resp      = (whTransportMemCsr*)ctl_resp,
+        .resp_size = sizeof(ctl_resp),
+    }, {
+        .req       = (whTransportMemCsr*)bulk_req,
+        .req_size  = sizeof(bulk_req),
+        .resp      = (whTransportMemCsr*)bulk_resp,
+        .resp_size = sizeof(bulk_resp),
+    }};
+
+    /* Client configuration/contexts. Only the control client connects */
+    whTransportClientCb         tccb[1]    = {WH_TRANSPORT_MEM_CLIENT_CB};
+    whTransportMemClientContext tmcc[2]    = {0};
+    whCommClientConfig          cc_conf[2] = {{
+                 .transport_cb      = tccb,
+                 .transport_context = (void*)&tmcc[0],
+                 .transport_config  = (void*)&tmcf[0],
+                 .client_id         = WH_TEST_DEFAULT_CLIENT_ID,
+                 .connect_cb        = _clientServerSequentialTestConnectCb,
+    }, {
+                 .transport_cb      = tccb,
+                 .transport_context = (void*)&tmcc[1],
+                 .transport_config  = (void*)&tmcf[1],
+                 .client_id         = WH_TEST_DEFAULT_CLIENT_ID,
+    }};
+    whClientContext ctl_client[1]  = {0};
+    whClientContext bulk_client[1] = {0};
+    whClientConfig  c_conf[2]      = {{
+         .comm = &cc_conf[0],
+    }, {
+         .comm = &cc_conf[1],
+    }};
+
+    /* Server configuration/contexts. The primary channel can fail receives */
+    whTransportServerCb         tscb[1]    = {WH_TRANSPORT_MEM_SERVER_CB};
+    whTransportServerCb         tfscb[1]   = {WH_TRANSPORT_MEM_SERVER_CB};
+    whTransportMemServerContext tmsc[2]    = {0};
+    whCommServerConfig          cs_conf[2] = {{
+                 .transport_cb      = tfscb,
+                 .transport_context = (void*)&tmsc[0],
+                 .transport_config  = (void*)&tmcf[0],
+                 .server_id         = 124,
+    }, {
+                 .transport_cb      = tscb,
+                 .transport_context = (void*)&tmsc[1],
+                 .transport_config  = (void*)&tmcf[1],
+                 .server_id         = 124,
+    }};
+#ifndef WOLFHSM_CFG_NO_CRYPTO
+    whServerCryptoContext crypto[1] = {0};
+#endif
+    whServerConfig s_conf[1] = {{
+        .comm_config = &cs_conf[0],
+        .lane_config = {&cs_conf[1]},
+#ifndef WOLFHSM_CFG_NO_CRYPTO
+        .crypto = crypto,
+#endif
+    }};
+    whServerContext server[1] = {0};
+
+    char     ctl_send[REQ_SIZE]    = {0};
+    char     bulk_send[REQ_SIZE]   = {0};
+    char     recv_buffer[REQ_SIZE] = {0};
+    uint16_t ctl_len               = 0;
+    uint16_t bulk_len              = 0;
+    uint16_t recv_len              = 0;
+    int      rc                    = 0;
+
+    tfscb->Recv                         = _lanesTestRecvRequest;
+    clientServerSequentialTestServerCtx = server;
+
+    WH_TEST_RETURN_ON_FAIL(wh_Server_Init(server, s_conf));
+    WH_TEST_RETURN_ON_FAIL(wh_Client_Init(ctl_client, &c_conf[0]));
+    WH_TEST_RETURN_ON_FAIL(wh_Client_Init(bulk_client, &c_conf[1]));
+
+    /* Nothing pending on any lane */
+    WH_TEST_ASSERT_RETURN(WH_ERROR_NOTREADY ==
+                          wh_Server_HandleRequestMessage(server));
+
+    /* A bulk request is queued before a control request */
+    bulk_len = snprintf(bulk_send, sizeof(bulk_send), "Bulk echo");
+    ctl_len  = snprintf(ctl_send, sizeof(ctl_send), "Control echo");
+    WH_TEST_RETURN_ON_FAIL(
+        wh_Client_EchoRequest(bulk_client, bulk_len, bulk_send));
+    WH_TEST_RETURN_ON_FAIL(
+        wh_Client_EchoRequest(ctl_client, ctl_len, ctl_send));
+
+    /* The control request is handled first */
+    WH_TEST_RETURN_ON_FAIL(wh_Server_HandleRequestMessage(server));
+    WH_TEST_ASSERT_RETURN(WH_ERROR_NOTREADY ==
+                          wh_Client_EchoResponse(bulk_client, &recv_len,
+                                                 recv_buffer));
+    WH_TEST_RETURN_ON_FAIL(
+        wh_Client_EchoResponse(ctl_client, &recv_len, recv_buffer));
+    WH_TEST_ASSERT_RETURN(recv_len == ctl_len);
+    WH_TEST_ASSERT_RETURN(0 == memcmp(recv_buffer, ctl_send, ctl_len));
+
+    /* Then the bulk request */
+    WH_TEST_RETURN_ON_FAIL(wh_Server_HandleRequestMessage(server));
+    WH_TEST_RETURN_ON_FAIL(
+        wh_Client_EchoResponse(bulk_client, &recv_len, recv_buffer));
+    WH_TEST_ASSERT_RETURN(recv_len == bulk_len);
+    WH_TEST_ASSERT_RETURN(0 == memcmp(recv_buffer, bulk_send, bulk_len));
+    WH_TEST_ASSERT_RETURN(WH_ERROR_NOTREADY ==
+                          wh_Server_HandleRequestMessage(server));
+
+    /* The mem transport cannot block, so neither can its lanes */
+    WH_TEST_ASSERT_RETURN(WH_ERROR_NOTIMPL ==
+                          wh_Server_WaitRequest(server, ONE_MS));
+
+    /* A failing primary channel does not block the bulk lane, and its error
+     * is kept until read */
+    WH_TEST_RETURN_ON_FAIL(
+        wh_Client_EchoRequest(bulk_client, bulk_len, bulk_send));
+    _lanesTestFailRecv = 1;
+    WH_TEST_RETURN_ON_FAIL(wh_Server_HandleRequestMessage(server));
+    WH_TEST_RETURN_ON_FAIL(
+        wh_Client_EchoResponse(bulk_client, &recv_len, recv_buffer));
+    WH_TEST_ASSERT_RETURN(recv_len == bulk_len);
+    WH_TEST_RETURN_ON_FAIL(wh_Server_GetLaneError(server, 0, &rc));
+    WH_TEST_ASSERT_RETURN(rc == WH_ERROR_ABORTED);
+    WH_TEST_RETURN_ON_FAIL(wh_Server_GetLaneError(server, 0, &rc));
+    WH_TEST_ASSERT_RETURN(rc == 0);
+
+    /* With no request on any lane, the error is returned instead */
+    WH_TEST_ASSERT_RETURN(WH_ERROR_ABORTED ==
+                          wh_Server_HandleRequestMessage(server));
+    WH_TEST_RETURN_ON_FAIL(wh_Server_GetLaneError(server, 0, &rc));
+    WH_TEST_ASSERT_RETURN(rc == 0);
+    _lanesTestFailRecv = 0;
+    WH_TEST_ASSERT_RETURN(WH_ERROR_BADARGS ==
+                          wh_Server_GetLaneError(server,
+                                                 WOLFHSM_CFG_SERVER_LANE_COUNT,
+                                                 &rc));
+
+    /* Lanes share the connection state of the primary channel */
+    WH_TEST_RETURN_ON_FAIL(wh_Client_Cleanup(ctl_client));
+    WH_TEST_RETURN_ON_FAIL(
+        wh_Client_EchoRequest(bulk_client, bulk_len, bulk_send));
+    WH_TEST_ASSERT_RETURN(WH_ERROR_NOTREADY ==
+                          wh_Server_HandleRequestMessage(server));
+
+    WH_TEST_RETURN_ON_FAIL(wh_Client_Cleanup(bulk_client));
+    WH_TEST_RETURN_ON_FAIL(wh_Server_Cleanup(server));
+
+    return 0;
+}
+
+#if defined(WOLFHSM_CFG_TEST_POSIX) && defined(__linux__)
+/* Waiting on a server with lanes wakes for a request on any lane, either
+ * through a single poll() over both sockets or by waiting on each in turn */
+static int whTest_ClientServerLanesWait(int use_set)
+{
+    int  ret          = 0;
+    int  i            = 0;
+    char path[2][64]  = {{0}};
+
+    posixTransportUdsConfig ptucfg[2] = {{
+        .socket_path = path[0],
+    }, {
+        .socket_path = path[1],
+    }};
+
+    /* Client configuration/contexts, one per lane */
+    whTransportClientCb            tccb[1]    = {POSIX_TRANSPORT_UDS_CLIENT_CB};
+    posixTransportUdsClientContext tcc[2]     = {0};
+    whCommClientConfig             cc_conf[2] = {{
+                    .transport_cb      = tccb,
+                    .transport_context = (void*)&tcc[0],
+                    .transport_config  = (void*)&ptucfg[0],
+                    .client_id         = WH_TEST_DEFAULT_CLIENT_ID,
+    }, {
+                    .transport_cb      = tccb,
+                    .transport_context = (void*)&tcc[1],
+                    .transport_config  = (void*)&ptucfg[1],
+                    .client_id         = WH_TEST_DEFAULT_CLIENT_ID,
+    }};
+    whClientContext client[2] = {0};
+    whClientConfig  c_conf[2] = {{
+         .comm = &cc_conf[0],
+    }, {
+         .comm = &cc_conf[1],
+    }};
+
+    /* Server configuration/contexts */
+    whTransportServerCb            tscb[1]    = {POSIX_TRANSPORT_UDS_SERVER_CB};
+    posixTransportUdsServerContext tssc[2]    = {0};
+    whCommServerConfig             cs_conf[2] = {{
+                    .transport_cb      = tscb,
+                    .transport_context = (void*)&tssc[0],
+                    .transport_config  = (void*)&ptucfg[0],
+                    .server_id         = 124,
+    }, {
+                    .transport_cb      = tscb,
+                    .transport_context = (void*)&tssc[1],
+                    .transport_config  = (void*)&ptucfg[1],
+                    .server_id         = 124,
+    }};
+#ifndef WOLFHSM_CFG_NO_CRYPTO
+    whServerCryptoContext crypto[1] = {0};
+#endif
+    whServerConfig s_conf[1] = {{
+        .comm_config = &cs_conf[0],
+        .lane_config = {&cs_conf[1]},
+#ifndef WOLFHSM_CFG_NO_CRYPTO
+        .crypto = crypto,
+#endif
+    }};
+    whServerContext server[1] = {0};
+
+    posixTransportUdsServerContext* wait_ctx[2] = {&tssc[0], &tssc[1]};
+    posixTransportUdsServerWaitSet  wait_set[1] = {{
+         .contexts = wait_ctx,
+         .count    = 2,
+    }};
+
+    char     send_buffer[REQ_SIZE] = {0};
+    char     recv_buffer[REQ_SIZE] = {0};
+    uint16_t send_len              = 0;
+    uint16_t recv_len              = 0;
+
+    for (i = 0; i < 2; i++) {
+        snprintf(path[i], sizeof(path[i]), "/tmp/wh_test_lanes_wait%d.%u", i,
+                 (unsigned)getpid());
+    }
+    if (use_set != 0) {
+        s_conf->lane_wait_cb      = posixTransportUds_ServerWaitSet;
+        s_conf->lane_wait_context = (void*)wait_set;
+    }
+    WH_TEST_RETURN_ON_FAIL(wh_Server_Init(server, s_conf));
+    WH_TEST_RETURN_ON_FAIL(wh_Client_Init(&client[0], &c_conf[0]));
+    WH_TEST_RETURN_ON_FAIL(wh_Client_Init(&client[1], &c_conf[1]));
+
+    /* Accept both connections, then nothing is pending on any lane */
+    WH_TEST_ASSERT_RETURN(WH_ERROR_NOTREADY ==
+                          wh_Server_HandleRequestMessage(server));
+    WH_TEST_ASSERT_RETURN((tssc[0].connect_fd_p1 != 0) &&
+                          (tssc[1].connect_fd_p1 != 0));
+    WH_TEST_ASSERT_RETURN(WH_ERROR_TIMEOUT ==
+                          wh_Server_WaitRequest(server, 10 * ONE_MS));
+
+    /* A request on either lane ends the wait */
+    send_len = snprintf(send_buffer, sizeof(send_buffer), "Lane echo");
+    for (i = 1; i >= 0; i--) {
+        WH_TEST_RETURN_ON_FAIL(
+            wh_Client_EchoRequest(&client[i], send_len, send_buffer));
+        do {
+            WH_TEST_RETURN_ON_FAIL(wh_Server_WaitRequest(server, 0));
+            ret = wh_Server_HandleRequestMessage(server);
+        } while (ret == WH_ERROR_NOTREADY);
+        WH_TEST_ASSERT_RETURN(ret == 0);
+        do {
+            ret = wh_Client_EchoResponse(&client[i], &recv_len, recv_buffer);
+        } while (ret == WH_ERROR_NOTREADY);
+        WH_TEST_ASSERT_RETURN(ret == 0);
+        WH_TEST_ASSERT_RETURN(recv_len == send_len);
+        WH_TEST_ASSERT_RETURN(0 == memcmp(recv_buffer, send_buffer, send_len));
+    }
+
+    WH_TEST_RETURN_ON_FAIL(wh_Client_Cleanup(&client[1]));
+    WH_TEST_RETURN_ON_FAIL(wh_Client_Cleanup(&client[0]));
+    WH_TEST_RETURN_ON_FAIL(wh_Server_Cleanup(server));
+
+    return 0;
+}
+
+/* A lane whose transport cannot block does not fail the wait, which checks it
+ * without blocking, or if its transport cannot tell either, returns after one
+ * slice so the lane is polled */
+static int whTest_ClientServerLanesWaitSkip(int checkable)
+{
+    int  ret      = 0;
+    char path[64] = {0};
+
+    posixTransportUdsConfig ptucfg[1] = {{
+        .socket_path = path,
+    }};
+    uint8_t              req[BUFFER_SIZE];
+    uint8_t              resp[BUFFER_SIZE];
+    whTransportMemConfig tmcf[1] = {{
+        .req       = (whTransportMemCsr*)req,
+        .req_size  = sizeof(req),
+        .resp      = (whTransportMemCsr*)resp,
+        .resp_size = sizeof(resp),
+    }};
+
+    /* Client configuration/contexts. The primary channel uses a socket, the
+     * lane shared memory */
+    whTransportClientCb            tccb[1]    = {POSIX_TRANSPORT_UDS_CLIENT_CB};
+    posixTransportUdsClientContext tcc[1]     = {0};
+    whTransportClientCb            tmccb[1]   = {WH_TRANSPORT_MEM_CLIENT_CB};
+    whTransportMemClientContext    tmcc[1]    = {0};
+    whCommClientConfig             cc_conf[2] = {{
+                    .transport_cb      = tccb,
+                    .transport_context = (void*)tcc,
+                    .transport_config  = (void*)ptucfg,
+                    .client_id         = WH_TEST_DEFAULT_CLIENT_ID,
+    }, {
+                    .transport_cb      = tmccb,
+                    .transport_context = (void*)tmcc,
+                    .transport_config  = (void*)tmcf,
+                    .client_id         = WH_TEST_DEFAULT_CLIENT_ID,
+    }};
+    whClientContext client[2] = {0};
+    whClientConfig  c_conf[2] = {{
+         .comm = &cc_conf[0],
+    }, {
+         .comm = &cc_conf[1],
+    }};
+
+    /* Server configuration/contexts */
+    whTransportServerCb            tscb[1]    = {POSIX_TRANSPORT_UDS_SERVER_CB};
+    posixTransportUdsServerContext tssc[1]    = {0};
+    whTransportServerCb            tmscb[1]   = {WH_TRANSPORT_MEM_SERVER_CB};
+    whTransportMemServerContext    tmsc[1]    = {0};
+    whCommServerConfig             cs_conf[2] = {{
+                    .transport_cb      = tscb,
+                    .transport_context = (void*)tssc,
+                    .transport_config  = (void*)ptucfg,
+                    .server_id         = 124,
+    }, {
+                    .transport_cb      = tmscb,
+                    .transport_context = (void*)tmsc,
+                    .transport_config  = (void*)tmcf,
+                    .server_id         = 124,
+    }};
+#ifndef WOLFHSM_CFG_NO_CRYPTO
+    whServerCryptoContext crypto[1] = {0};
+#endif
+    whServerConfig s_conf[1] = {{
+        .comm_config = &cs_conf[0],
+        .lane_config = {&cs_conf[1]},
+#ifndef WOLFHSM_CFG_NO_CRYPTO
+        .crypto = crypto,
+#endif
+    }};
+    whServerContext server[1] = {0};
+
+    char     send_buffer[REQ_SIZE] = {0};
+    char     recv_buffer[REQ_SIZE] = {0};
+    uint16_t send_len              = 0;
+    uint16_t recv_len              = 0;
+
+    snprintf(path, sizeof(path), "/tmp/wh_test_lanes_skip.%u",
+             (unsigned)getpid());
+    if (checkable == 0) {
+        tmscb->Pending = NULL;
+    }
+    WH_TEST_RETURN_ON_FAIL(wh_Server_Init(server, s_conf));
+    WH_TEST_RETURN_ON_FAIL(wh_Client_Init(&client[0], &c_conf[0]));
+    WH_TEST_RETURN_ON_FAIL(wh_Client_Init(&client[1], &c_conf[1]));
+    WH_TEST_ASSERT_RETURN(WH_ERROR_NOTREADY ==
+                          wh_Server_HandleRequestMessage(server));
+
+    /* Nothing is pending. Unless the lane can be checked, the wait ends
+     * after one slice regardless */
+    if (checkable != 0) {
+        WH_TEST_ASSERT_RETURN(WH_ERROR_TIMEOUT ==
+                              wh_Server_WaitRequest(server, 10 * ONE_MS));
+    }
+    else {
+        WH_TEST_RETURN_ON_FAIL(wh_Server_WaitRequest(server, 10 * ONE_MS));
+    }
+    WH_TEST_ASSERT_RETURN(WH_ERROR_TIMEOUT ==
+                          wh_Server_WaitRequest(server, ONE_MS / 2));
+
+    /* A request on the lane that cannot block is found by the wait */
+    send_len = snprintf(send_buffer, sizeof(send_buffer), "Skipped lane");
+    WH_TEST_RETURN_ON_FAIL(
+        wh_Client_EchoRequest(&client[1], send_len, send_buffer));
+    WH_TEST_RETURN_ON_FAIL(wh_Server_WaitRequest(server, 0));
+    WH_TEST_RETURN_ON_FAIL(wh_Server_HandleRequestMessage(server));
+    do {
+        ret = wh_Client_EchoResponse(&client[1], &recv_len, recv_buffer);
+    } while (ret == WH_ERROR_NOTREADY);
+    WH_TEST_ASSERT_RETURN(ret == 0);
+    WH_TEST_ASSERT_RETURN(recv_len == send_len);
+    WH_TEST_ASSERT_RETURN(0 == memcmp(recv_buffer, send_buffer, send_len));
+
+    WH_TEST_RETURN_ON_FAIL(wh_Client_Cleanup(&client[1]));
+    WH_TEST_RETURN_ON_FAIL(wh_Client_Cleanup(&client[0]));
+    WH_TEST_RETURN_ON_FAIL(wh_Server_Cleanup(server));
+
+    return 0;
+}
+#endif /* WOLFHSM_CFG_TEST_POSIX && __linux__ */
+#endif /* WOLFHSM_CFG_SERVER_LANES */
+
+#ifdef WOLFHSM_CFG_COMM_SESSIONS
+#define SESSION_TEST_COUNT 3
+
+/* Send a counter request on a session, let the server handle it, and return
+ * the result of the response */
+static int _sessionTestCounter(whServerContext* server, whClientContext* client,
+                               whNvmId id, int init, uint32_t* inout_counter)
+{
+    if (init != 0) {
+        WH_TEST_RETURN_ON_FAIL(
+            wh_Client_CounterInitRequest(client, id, *inout_counter));
+        WH_TEST_RETURN_ON_FAIL(wh_Server_HandleRequestMessage(server));
+        return wh_Client_CounterInitResponse(client, inout_counter);
+    }
+    WH_TEST_RETURN_ON_FAIL(wh_Client_CounterReadRequest(client, id));
+    WH_TEST_RETURN_ON_FAIL(wh_Server_HandleRequestMessage(server));
+    return wh_Client_CounterReadResponse(client, inout_counter);
+}
+
+#if !defined(WOLFHSM_CFG_NO_CRYPTO) && \
+    (WOLFHSM_CFG_SERVER_KEYCACHE_PIN_MAX > 0)
+/* Cache a key on a session and pin or unpin it, letting the server handle
+ * each request. Returns the result of the pin response */
+static int _sessionTestPin(whServerContext* server, whClientContext* client,
+                           uint16_t keyId, int pin)
+{
+    uint8_t  key[16] = {0};
+    uint16_t outId   = 0;
+
+    if (pin != 0) {
+        key[0] = (uint8_t)keyId;
+        WH_TEST_RETURN_ON_FAIL(wh_Client_KeyCacheRequest_ex(
+            client, 0, NULL, 0, key, sizeof(key), keyId));
+        WH_TEST_RETURN_ON_FAIL(wh_Server_HandleRequestMessage(server));
+        WH_TEST_RETURN_ON_FAIL(wh_Client_KeyCacheResponse(client, &outId));
+        WH_TEST_ASSERT_RETURN(outId == keyId);
+    }
+    WH_TEST_RETURN_ON_FAIL(wh_Client_KeyPinRequest(client, keyId, pin));
+    WH_TEST_RETURN_ON_FAIL(wh_Server_HandleRequestMessage(server));
+    return wh_Client_KeyPinResponse(client);
+}
+
+/* Evict count keys of a session starting at firstId. Returns the result of
+ * the first evict response that fails */
+static int _sessionTestEvict(whServerContext* server, whClientContext* client,
+                             uint16_t firstId, int count)
+{
+    int ret = 0;
+    int i;
+
+    for (i = 0; (i < count) && (ret == 0); i++) {
+        WH_TEST_RETURN_ON_FAIL(
+            wh_Client_KeyEvictRequest(client, (uint16_t)(firstId + i)));
+        WH_TEST_RETURN_ON_FAIL(wh_Server_HandleRequestMessage(server));
+        ret = wh_Client_KeyEvictResponse(client);
+    }
+    return ret;
+}
+
+/* Pin as many keys as a session may, starting at firstId, and check that one
+ * more key cannot be pinned */
+static int _sessionTestPinMax(whServerContext* server,
+                              whClientContext* client, uint16_t firstId)
+{
+    uint16_t extraId = (uint16_t)(firstId + WOLFHSM_CFG_SERVER_KEYCACHE_PIN_MAX);
+    int      i;
+
+    for (i = 0; i < WOLFHSM_CFG_SERVER_KEYCACHE_PIN_MAX; i++) {
+        WH_TEST_RETURN_ON_FAIL(
+            _sessionTestPin(server, client, (uint16_t)(firstId + i), 1));
+    }
+    WH_TEST_ASSERT_RETURN(WH_ERROR_NOSPACE ==
+                          _sessionTestPin(server, client, extraId, 1));
+    return _sessionTestEvict(server, client, extraId, 1);
+}
+
+/* Reopen a closed session */
+static int _sessionTestReopen(whServerContext* server,
+                              whClientContext* client)
+{
+    uint32_t client_id = 0;
+    uint32_t server_id = 0;
+
+    WH_TEST_RETURN_ON_FAIL(wh_Client_CommInitRequest(client));
+    WH_TEST_RETURN_ON_FAIL(wh_Server_HandleRequestMessage(server));
+    return wh_Client_CommInitResponse(client, &client_id, &server_id);
+}
+#endif /* !WOLFHSM_CFG_NO_CRYPTO && WOLFHSM_CFG_SERVER_KEYCACHE_PIN_MAX > 0 */
+
+static int whTest_ClientServerSessions(void)
+{
+    /* One transport connection carries every session */
+    uint8_t              req[BUFFER_SIZE];
+    uint8_t              resp[BUFFER_SIZE];
+    whTransportMemConfig tmcf[1] = {{
+        .req       = (whTransportMemCsr*)req,
+        .req_size  = sizeof(req),
+        .resp      = (whTransportMemCsr*)resp,
+        .resp_size = sizeof(resp),
+    }};
+
+    /* Client configuration/contexts, one per session */
+    whTransportClientCb          tmccb[1] = {WH_TRANSPORT_MEM_CLIENT_CB};
+    whTransportMemClientContext  tmcc[1]  = {0};
+    whTransportSessionConnection conn[1]  = {0};
+    whTransportSessionConfig     tscf[1]  = {{
+             .conn              = conn,
+             .transport_cb      = tmccb,
+             .transport_context = (void*)tmcc,
+             .transport_config  = (void*)tmcf,
+    }};
+    whTransportClientCb       tsccb[1] = {WH_TRANSPORT_SESSION_CLIENT_CB};
+    whTransportSessionContext tsctx[SESSION_TEST_COUNT];
+    whCommClientConfig        cc_conf[SESSION_TEST_COUNT];
+    whClientConfig            c_conf[SESSION_TEST_COUNT];
+    whClientContext           client[SESSION_TEST_COUNT];
+
+    /* Server configuration/contexts */
+    whTransportServerCb         tscb[1]    = {WH_TRANSPORT_MEM_SERVER_CB};
+    whTransportMemServerContext tmsc[1]    = {0};
+    whCommServerConfig          cs_conf[1] = {{
+                 .transport_cb      = tscb,
+                 .transport_context = (void*)tmsc,
+                 .transport_config  = (void*)tmcf,
+                 .server_id         = 124,
+    }};
+
+    /* RamSim Flash state and configuration */
+    uint8_t          memory[FLASH_RAM_SIZE] = {0};
+    whFlashRamsimCtx fc[1]                  = {0};
+    whFlashRamsimCfg fc_conf[1]             = {{
+                    .size       = FLASH_RAM_SIZE,
+                    .sectorSize = FLASH_SECTOR_SIZE,
+                    .pageSize   = FLASH_PAGE_SIZE,
+                    .erasedByte = ~(uint8_t)0,
+                    .memory     = memory,
+    }};
+    const whFlashCb  fcb[1]                 = {WH_FLASH_RAMSIM_CB};
+
+    whTestNvmBackendUnion nvm_setup;
+    whNvmConfig           n_conf[1] = {0};
+    whNvmContext          nvm[1]    = {{0}};
+
+#ifndef WOLFHSM_CFG_NO_CRYPTO
+    whServerCryptoContext crypto[1] = {0};
+#endif
+    whServerConfig s_conf[1] = {{
+        .comm_config = cs_conf,
+        .nvm         = nvm,
+#ifndef WOLFHSM_CFG_NO_CRYPTO
+        .crypto = crypto,
+#endif
+    }};
+    whServerContext server[1] = {0};
+
+    const whNvmId counterId             = 7;
+    char          send_buffer[REQ_SIZE] = {0};
+    char          recv_buffer[REQ_SIZE] = {0};
+    uint16_t      send_len              = 0;
+    uint16_t      recv_len              = 0;
+    uint32_t      client_id             = 0;
+    uint32_t      server_id             = 0;
+    uint32_t      counter               = 0;
+    int           i                     = 0;
+
+    memset(tsctx, 0, sizeof(tsctx));
+    memset(cc_conf, 0, sizeof(cc_conf));
+    memset(c_conf, 0, sizeof(c_conf));
+    memset(client, 0, sizeof(client));
+
+    WH_TEST_RETURN_ON_FAIL(whTest_NvmCfgBackend(WH_NVM_TEST_BACKEND_FLASH,
+                                                &nvm_setup, n_conf, fc_conf,
+                                                fc, fcb));
+    WH_TEST_RETURN_ON_FAIL(wh_Nvm_Init(nvm, n_conf));
+    WH_TEST_RETURN_ON_FAIL(wh_Server_Init(server, s_conf));
+    WH_TEST_RETURN_ON_FAIL(wh_Server_SetConnected(server, WH_COMM_CONNECTED));
+
+    for (i = 0; i < SESSION_TEST_COUNT; i++) {
+        cc_conf[i].transport_cb      = tsccb;
+        cc_conf[i].transport_context = (void*)&tsctx[i];
+        cc_conf[i].transport_config  = (void*)tscf;
+        cc_conf[i].client_id  = (uint8_t)(WH_TEST_DEFAULT_CLIENT_ID + 1 + i);
+        cc_conf[i].session_id = (uint16_t)(0x100 + i);
+        c_conf[i].comm        = &cc_conf[i];
+        WH_TEST_RETURN_ON_FAIL(wh_Client_Init(&client[i], &c_conf[i]));
+    }
+    WH_TEST_ASSERT_RETURN(conn->users == SESSION_TEST_COUNT);
+
+    /* Requests of a session that is not open are not dispatched */
+    send_len = snprintf(send_buffer, sizeof(send_buffer), "No session");
+    WH_TEST_RETURN_ON_FAIL(
+        wh_Client_EchoRequest(&client[0], send_len, send_buffer));
+    WH_TEST_RETURN_ON_FAIL(wh_Server_HandleRequestMessage(server));
+    WH_TEST_ASSERT_RETURN(WH_ERROR_NOSESSION ==
+                          wh_Client_EchoResponse(&client[0], &recv_len,
+                                                 recv_buffer));
+
+    /* Open every session. The server keeps its own client_id */
+    for (i = 0; i < SESSION_TEST_COUNT; i++) {
+        WH_TEST_RETURN_ON_FAIL(wh_Client_CommInitRequest(&client[i]));
+        WH_TEST_RETURN_ON_FAIL(wh_Server_HandleRequestMessage(server));
+        WH_TEST_RETURN_ON_FAIL(
+            wh_Client_CommInitResponse(&client[i], &client_id, &server_id));
+        WH_TEST_ASSERT_RETURN(client_id == cc_conf[i].client_id);
+        WH_TEST_ASSERT_RETURN(server_id == cs_conf->server_id);
+    }
+    WH_TEST_ASSERT_RETURN(server->comm->client_id == 0);
+
+    /* The connection is held until the response is received */
+    send_len = snprintf(send_buffer, sizeof(send_buffer), "Session 0 echo");
+    WH_TEST_RETURN_ON_FAIL(
+        wh_Client_EchoRequest(&client[0], send_len, send_buffer));
+    WH_TEST_ASSERT_RETURN(WH_ERROR_NOTREADY ==
+                          wh_Client_EchoRequest(&client[1], send_len,
+                                                send_buffer));
+    WH_TEST_RETURN_ON_FAIL(wh_Server_HandleRequestMessage(server));
+    WH_TEST_ASSERT_RETURN(WH_ERROR_NOTREADY ==
+                          wh_Client_EchoResponse(&client[1], &recv_len,
+                                                 recv_buffer));
+    WH_TEST_RETURN_ON_FAIL(
+        wh_Client_EchoResponse(&client[0], &recv_len, recv_buffer));
+    WH_TEST_ASSERT_RETURN(recv_len == send_len);
+    WH_TEST_ASSERT_RETURN(0 == memcmp(recv_buffer, send_buffer, send_len));
+
+    /* A session is not released while its response is on the connection */
+    WH_TEST_RETURN_ON_FAIL(
+        wh_Client_EchoRequest(&client[0], send_len, send_buffer));
+    WH_TEST_ASSERT_RETURN(WH_ERROR_NOTREADY == wh_Client_Cleanup(&client[0]));
+    WH_TEST_ASSERT_RETURN(conn->users == SESSION_TEST_COUNT);
+    WH_TEST_RETURN_ON_FAIL(wh_Server_HandleRequestMessage(server));
+    WH_TEST_RETURN_ON_FAIL(
+        wh_Client_EchoResponse(&client[0], &recv_len, recv_buffer));
+    WH_TEST_ASSERT_RETURN(recv_len == send_len);
+    WH_TEST_RETURN_ON_FAIL(wh_Client_Cleanup(&client[0]));
+    WH_TEST_ASSERT_RETURN(conn->users == SESSION_TEST_COUNT - 1);
+    WH_TEST_ASSERT_RETURN(conn->owner == NULL);
+    WH_TEST_RETURN_ON_FAIL(wh_Client_Init(&client[0], &c_conf[0]));
+
+    /* Each session has its own counter namespace */
+    for (i = 0; i < SESSION_TEST_COUNT; i++) {
+        counter = (uint32_t)(100 * (i + 1));
+        WH_TEST_RETURN_ON_FAIL(
+            _sessionTestCounter(server, &client[i], counterId, 1, &counter));
+    }
+    for (i = 0; i < SESSION_TEST_COUNT; i++) {
+        counter = 0;
+        WH_TEST_RETURN_ON_FAIL(
+            _sessionTestCounter(server, &client[i], counterId, 0, &counter));
+        WH_TEST_ASSERT_RETURN(counter == (uint32_t)(100 * (i + 1)));
+    }
+
+    /* Closing a session leaves the connection and other sessions open */
+    WH_TEST_RETURN_ON_FAIL(wh_Client_CommCloseRequest(&client[0]));
+    WH_TEST_RETURN_ON_FAIL(wh_Server_HandleRequestMessage(server));
+    WH_TEST_RETURN_ON_FAIL(wh_Client_CommCloseResponse(&client[0]));
+    WH_TEST_ASSERT_RETURN(server->connected == WH_COMM_CONNECTED);
+    WH_TEST_ASSERT_RETURN(WH_ERROR_NOSESSION ==
+                          _sessionTestCounter(server, &client[0], counterId, 0,
+                                              &counter));
+    WH_TEST_RETURN_ON_FAIL(
+        _sessionTestCounter(server, &client[1], counterId, 0, &counter));
+    WH_TEST_ASSERT_RETURN(counter == 200);
+
+    /* NORESP requests cannot be sent on a session */
+    WH_TEST_ASSERT_RETURN(WH_ERROR_BADARGS ==
+                          wh_Client_CounterIncrementNoResp(&client[1],
+                                                           counterId));
+
+#if !defined(WOLFHSM_CFG_NO_CRYPTO) && \
+    (WOLFHSM_CFG_SERVER_KEYCACHE_PIN_MAX > 0)
+    /* Closing a session evicts the keys of its client, releasing their pins */
+    WH_TEST_RETURN_ON_FAIL(_sessionTestPinMax(server, &client[1], 1));
+    WH_TEST_RETURN_ON_FAIL(wh_Client_CommCloseRequest(&client[1]));
+    WH_TEST_RETURN_ON_FAIL(wh_Server_HandleRequestMessage(server));
+    WH_TEST_RETURN_ON_FAIL(wh_Client_CommCloseResponse(&client[1]));
+    WH_TEST_RETURN_ON_FAIL(_sessionTestReopen(server, &client[1]));
+    WH_TEST_ASSERT_RETURN(WH_ERROR_NOTFOUND ==
+                          _sessionTestEvict(server, &client[1], 1, 1));
+    WH_TEST_RETURN_ON_FAIL(_sessionTestPinMax(server, &client[1], 0x11));
+
+    /* The sessions of a connection share its pins */
+    WH_TEST_ASSERT_RETURN(WH_ERROR_NOSPACE ==
+                          _sessionTestPin(server, &client[2], 1, 1));
+    WH_TEST_RETURN_ON_FAIL(_sessionTestEvict(server, &client[2], 1, 1));
+    WH_TEST_RETURN_ON_FAIL(_sessionTestEvict(
+        server, &client[1], 0x11, WOLFHSM_CFG_SERVER_KEYCACHE_PIN_MAX));
+
+    /* So are those of a session still open when the server disconnects */
+    WH_TEST_RETURN_ON_FAIL(_sessionTestPinMax(server, &client[2], 1));
+#endif /* !WOLFHSM_CFG_NO_CRYPTO && WOLFHSM_CFG_SERVER_KEYCACHE_PIN_MAX > 0 */
+
+    /* Disconnecting the server closes every session */
+    WH_TEST_RETURN_ON_FAIL(
+        wh_Server_SetConnected(server, WH_COMM_DISCONNECTED));
+    WH_TEST_RETURN_ON_FAIL(wh_Server_SetConnected(server, WH_COMM_CONNECTED));
+    WH_TEST_ASSERT_RETURN(WH_ERROR_NOSESSION ==
+                          _sessionTestCounter(server, &client[2], counterId, 0,
+                                              &counter));
+#if !defined(WOLFHSM_CFG_NO_CRYPTO) && \
+    (WOLFHSM_CFG_SERVER_KEYCACHE_PIN_MAX > 0)
+    WH_TEST_RETURN_ON_FAIL(_sessionTestReopen(server, &client[2]));
+    WH_TEST_ASSERT_RETURN(WH_ERROR_NOTFOUND ==
+                          _sessionTestEvict(server, &client[2], 1, 1));
+    WH_TEST_RETURN_ON_FAIL(_sessionTestPinMax(server, &client[2], 0x11));
+    WH_TEST_RETURN_ON_FAIL(_sessionTestEvict(
+        server, &client[2], 0x11, WOLFHSM_CFG_SERVER_KEYCACHE_PIN_MAX));
+#endif /* !WOLFHSM_CFG_NO_CRYPTO && WOLFHSM_CFG_SERVER_KEYCACHE_PIN_MAX > 0 */
+
+    for (i = 0; i < SESSION_TEST_COUNT; i++) {
+        WH_TEST_RETURN_ON_FAIL(wh_Client_Cleanup(&client[i]));
+    }
+    WH_TEST_ASSERT_RETURN(conn->users == 0);
+    WH_TEST_RETURN_ON_FAIL(wh_Server_Cleanup(server));
+    WH_TEST_RETURN_ON_FAIL(wh_Nvm_Cleanup(nvm));
+
+    return 0;
+}
+#endif /* WOLFHSM_CFG_COMM_SESSIONS */
+
+#ifdef WOLFHSM_CFG_COMM_FRAGMENT
+/* Transport buffers that only hold one small fragment */
+#define FRAG_TEST_BUFFER_SIZE 256
+#define FRAG_TEST_SIZE (FRAG_TEST_BUFFER_SIZE - sizeof(whTransportMemCsr))
+/* Largest NVM object that fits in one reassembled request */
+#define FRAG_TEST_OBJ_SIZE \
+    (WOLFHSM_CFG_COMM_FRAGMENT_DATA_LEN - sizeof(whMessageNvm_AddObjectRequest))
+
+/* Run the server until the client has received the whole response to its last
+ * request.  Each server call sends or acks one fragment */
+#define FRAG_TEST_PUMP(_server, _rc, _response)                         \
+    do {                                                                \
+        _rc = wh_Server_HandleRequestMessage(_server);                  \
+        WH_TEST_ASSERT_RETURN((_rc == 0) || (_rc == WH_ERROR_NOTREADY)); \
+        _rc = (_response);                                              \
+    } while (_rc == WH_ERROR_NOTREADY)
+
+/* NVM objects and certificates larger than WOLFHSM_CFG_COMM_DATA_LEN move in
+ * one request over transport buffers much smaller than either */
+static int whTest_ClientServerFragment(void)
+{
+    int rc = 0;
+
+    /* Transport memory configuration */
+    uint8_t              req[FRAG_TEST_BUFFER_SIZE];
+    uint8_t              resp[FRAG_TEST_BUFFER_SIZE];
+    whTransportMemConfig tmcf[1] = {{
+        .req       = (whTransportMemCsr*)req,
+        .req_size  = sizeof(req),
+        .resp      = (whTransportMemCsr*)resp,
+        .resp_size = sizeof(resp),
+    }};
+
+    /* Client configuration/contexts */
+    whTransportClientCb         tccb[1]    = {WH_TRANSPORT_MEM_CLIENT_CB};
+    whTransportMemClientContext tmcc[1]    = {0};
+    whCommClientConfig          cc_conf[1] = {{
+                 .transport_cb      = tccb,
+                 .transport_context = (void*)tmcc,
+                 .transport_config  = (void*)tmcf,
+                 .client_id         = WH_TEST_DEFAULT_CLIENT_ID,
+                 .fragment_size     = FRAG_TEST_SIZE,
+    }};
+    whClientConfig              c_conf[1]  = {{
+                     .comm = cc_conf,
+    }};
+    whClientContext             client[1]  = {0};
+
+    /* Server configuration/contexts, with a buffer to reassemble requests
+     * larger than the comm buffer */
+    static uint64_t frag_buffer[(sizeof(whCommFragHeader) +
+                                 sizeof(whCommHeader) +
+                                 WOLFHSM_CFG_COMM_FRAGMENT_DATA_LEN +
+                                 sizeof(uint64_t) - 1) /
+                                sizeof(uint64_t)];
+    whTransportServerCb         tscb[1]    = {WH_TRANSPORT_MEM_SERVER_CB};
+    whTransportMemServerContext tmsc[1]    = {0};
+    whCommServerConfig          cs_conf[1] = {{
+                 .transport_cb      = tscb,
+                 .transport_context = (void*)tmsc,
+                 .transport_config  = (void*)tmcf,
+                 .server_id         = 124,
+                 .fragment_size     = FRAG_TEST_SIZE,
+                 .frag_buffer       = frag_buffer,
+                 .frag_buffer_size  = sizeof(frag_buffer),
+    }};
+
+    /* RamSim Flash state and configuration */
+    uint8_t          memory[FLASH_RAM_SIZE] = {0};
+    whFlashRamsimCtx fc[1]                  = {0};
+    whFlashRamsimCfg fc_conf[1]             = {{
+                    .size       = FLASH_RAM_SIZE,
+                    .sectorSize = FLASH_SECTOR_SIZE,
+                    .pageSize   = FLASH_PAGE_SIZE,
+                    .erasedByte = ~(uint8_t)0,
+                    .memory     = memory,
+    }};
+    const whFlashCb  fcb[1]                 = {WH_FLASH_RAMSIM_CB};
+
+    whTestNvmBackendUnion nvm_setup;
+    whNvmConfig           n_conf[1] = {0};
+    whNvmContext          nvm[1]    = {{0}};
+
+#ifndef WOLFHSM_CFG_NO_CRYPTO
+    whServerCryptoContext crypto[1] = {0};
+#endif
+    whServerConfig s_conf[1] = {{
+        .comm_config = cs_conf,
+        .nvm         = nvm,
+#ifndef WOLFHSM_CFG_NO_CRYPTO
+        .crypto = crypto,
+#endif
+    }};
+    whServerContext server[1] = {0};
+
+    const whNvmId objId                       = 0x31;
+    uint8_t       obj[FRAG_TEST_OBJ_SIZE]     = {0};
+    uint8_t       readback[FRAG_TEST_OBJ_SIZE] = {0};
+    whNvmSize     readLen                     = 0;
+    int32_t       server_rc                   = 0;
+    uint32_t      client_id                   = 0;
+    uint32_t      server_id                   = 0;
+    uint32_t      i                           = 0;
+
+    for (i = 0; i < sizeof(obj); i++) {
+        obj[i] = (uint8_t)(i + (i >> 8));
+    }
+
+    WH_TEST_RETURN_ON_FAIL(whTest_NvmCfgBackend(WH_NVM_TEST_BACKEND_FLASH,
+                                                &nvm_setup, n_conf, fc_conf,
+                                                fc, fcb));
+    WH_TEST_RETURN_ON_FAIL(wh_Nvm_Init(nvm, n_conf));
+    WH_TEST_RETURN_ON_FAIL(wh_Server_Init(server, s_conf));
+    WH_TEST_RETURN_ON_FAIL(wh_Server_SetConnected(server, WH_COMM_CONNECTED));
+    WH_TEST_RETURN_ON_FAIL(wh_Client_Init(client, c_conf));
+
+    WH_TEST_RETURN_ON_FAIL(wh_Client_CommInitRequest(client));
+    FRAG_TEST_PUMP(server, rc,
+                   wh_Client_CommInitResponse(client, &client_id, &server_id));
+    WH_TEST_RETURN_ON_FAIL(rc);
+
+    /* The whole object goes in one request and comes back in one response */
+    WH_TEST_ASSERT_RETURN(WH_ERROR_BADARGS ==
+                          wh_Client_NvmAddObjectRequest(
+                              client, objId, WH_NVM_ACCESS_ANY,
+                              WH_NVM_FLAGS_NONE, 0, NULL,
+                              sizeof(obj) + 1, obj));
+    WH_TEST_RETURN_ON_FAIL(wh_Client_NvmAddObjectRequest(
+        client, objId, WH_NVM_ACCESS_ANY, WH_NVM_FLAGS_NONE, 0, NULL,
+        sizeof(obj), obj));
+    FRAG_TEST_PUMP(server, rc,
+                   wh_Client_NvmAddObjectResponse(client, &server_rc));
+    WH_TEST_RETURN_ON_FAIL(rc);
+    WH_TEST_RETURN_ON_FAIL(server_rc);
+
+    WH_TEST_RETURN_ON_FAIL(
+        wh_Client_NvmReadRequest(client, objId, 0, sizeof(readback)));
+    FRAG_TEST_PUMP(server, rc,
+                   wh_Client_NvmReadResponse(client, &server_rc, &readLen,
+                                             readback));
+    WH_TEST_RETURN_ON_FAIL(rc);
+    WH_TEST_RETURN_ON_FAIL(server_rc);
+    WH_TEST_ASSERT_RETURN(readLen == sizeof(obj));
+    WH_TEST_ASSERT_RETURN(0 == memcmp(readback, obj, sizeof(obj)));
+
+    /* A read past what one response can carry is still rejected */
+    WH_TEST_RETURN_ON_FAIL(wh_Client_NvmReadRequest(
+        client, objId, 0,
+        WOLFHSM_CFG_COMM_FRAGMENT_DATA_LEN - sizeof(whMessageNvm_ReadResponse) +
+            1));
+    FRAG_TEST_PUMP(server, rc,
+                   wh_Client_NvmReadResponse(client, &server_rc, &readLen,
+                                             readback));
+    WH_TEST_RETURN_ON_FAIL(rc);
+    WH_TEST_ASSERT_RETURN(server_rc == WH_ERROR_ABORTED);
+
+    WH_TEST_RETURN_ON_FAIL(wh_Client_NvmDestroyObjectsRequest(client, 1, &objId));
+    FRAG_TEST_PUMP(server, rc,
+                   wh_Client_NvmDestroyObjectsResponse(client, &server_rc));
+    WH_TEST_RETURN_ON_FAIL(rc);
+    WH_TEST_RETURN_ON_FAIL(server_rc);
+
+#if defined(WOLFHSM_CFG_CERTIFICATE_MANAGER) && !defined(WOLFHSM_CFG_NO_CRYPTO)
+    {
+        /* Certificates are stored and read back whole the same way */
+        const uint32_t certLen = FRAG_TEST_OBJ_SIZE - 64;
+        uint32_t       outLen  = sizeof(readback);
+
+        WH_TEST_RETURN_ON_FAIL(wh_Client_CertInitRequest(client));
+        FRAG_TEST_PUMP(server, rc,
+                       wh_Client_CertInitResponse(client, &server_rc));
+        WH_TEST_RETURN_ON_FAIL(rc);
+        WH_TEST_RETURN_ON_FAIL(server_rc);
+
+        WH_TEST_RETURN_ON_FAIL(wh_Client_CertAddTrustedRequest(
+            client, objId, WH_NVM_ACCESS_ANY, WH_NVM_FLAGS_NONE, NULL, 0, obj,
+            certLen));
+        FRAG_TEST_PUMP(server, rc,
+                       wh_Client_CertAddTrustedResponse(client, &server_rc));
+        WH_TEST_RETURN_ON_FAIL(rc);
+        WH_TEST_RETURN_ON_FAIL(server_rc);
+
+        memset(readback, 0, sizeof(readback));
+        WH_TEST_RETURN_ON_FAIL(
+            wh_Client_CertReadTrustedRequest(client, objId, outLen));
+        FRAG_TEST_PUMP(server, rc,
+                       wh_Client_CertReadTrustedResponse(client, readback,
+                                                         &outLen, &server_rc));
+        WH_TEST_RETURN_ON_FAIL(rc);
+        WH_TEST_RETURN_ON_FAIL(server_rc);
+        WH_TEST_ASSERT_RETURN(outLen == certLen);
+        WH_TEST_ASSERT_RETURN(0 == memcmp(readback, obj, certLen));
+
+        WH_TEST_RETURN_ON_FAIL(wh_Client_CertEraseTrustedRequest(client, objId));
+        FRAG_TEST_PUMP(server, rc,
+                       wh_Client_CertEraseTrustedResponse(client, &server_rc));
+        WH_TEST_RETURN_ON_FAIL(rc);
+        WH_TEST_RETURN_ON_FAIL(server_rc);
+    }
+#endif /* WOLFHSM_CFG_CERTIFICATE_MANAGER && !WOLFHSM_CFG_NO_CRYPTO */
+
+    WH_TEST_RETURN_ON_FAIL(wh_Client_Cleanup(client));
+    WH_TEST_RETURN_ON_FAIL(wh_Server_Cleanup(server));
+    WH_TEST_RETURN_ON_FAIL(wh_Nvm_Cleanup(nvm));
+
+    return 0;
+}
+#endif /* WOLFHSM_CFG_COMM_FRAGMENT */
+#endif /* WOLFHSM_CFG_ENABLE_CLIENT && WOLFHSM_CFG_ENABLE_SERVER */
+
+#ifdef WOLFHSM_CFG_ENABLE_CLIENT
+int whTest_ClientServerClientConfig(whClientConfig* clientCfg)
+{
+    int ret = 0;
+    whClientContext client[1] = {0};
+
+    WH_TEST_RETURN_ON_FAIL(wh_Client_Init(client, clientCfg));
+
+    int counter = 1;
+    char recv_buffer[WOLFHSM_CFG_COMM_DATA_LEN] = {0};
+    char send_buffer[WOLFHSM_CFG_COMM_DATA_LEN] = {0};
+    uint16_t send_len = 0;
+    uint16_t recv_len = 0;
+
+    int32_t server_rc = 0;
+    uint32_t client_id = 0;
+    uint32_t server_id = 0;
+    uint32_t avail_size = 0;
+    uint32_t reclaim_size = 0;
+    whNvmId avail_objects = 0;
+    whNvmId reclaim_objects = 0;
+
+    /* Init client/server comms */
+    WH_TEST_RETURN_ON_FAIL(wh_Client_CommInit(client, &client_id, &server_id));
+    WH_TEST_ASSERT_RETURN(client_id == client->comm->client_id);
+
+
+    for (counter = 0; counter < REPEAT_COUNT; counter++) {
+
+        /* Prepare echo test */
+        send_len =
+            snprintf(send_buffer, sizeof(send_buffer), "Request:%u", counter);
+        (void)snprintf(recv_buffer, sizeof(recv_buffer), "NOTHING RECEIVED");
+        recv_len = 0;
+
+        WH_TEST_RETURN_ON_FAIL(ret = wh_Client_Echo(client, send_len, send_buffer, &recv_len, recv_buffer));
+
+        WH_TEST_PRINT("Client Echo:%d, len:%d, %.*s, expected:%.*s\n", ret,
+                      recv_len, recv_len, recv_buffer, send_len, send_buffer);
+
+        WH_TEST_ASSERT_RETURN( recv_len == send_len);
+        WH_TEST_ASSERT_RETURN( strncmp(recv_buffer, send_buffer, recv_len) == 0);
+    }
+
+    /* Perform NVM tests */
+
+    WH_TEST_RETURN_ON_FAIL(ret = wh_Client_NvmInit(client, &server_rc, &client_id, &server_id));
+    WH_TEST_ASSERT_RETURN(server_rc == WH_ERROR_OK);
+
+    WH_TEST_RETURN_ON_FAIL(ret = wh_Client_NvmGetAvailable(
+        client, &server_rc, &avail_size, &avail_objects, &reclaim_size,
+        &reclaim_objects));
+
+    WH_TEST_PRINT("Client NvmGetAvailable:%d, server_rc:%d avail_size:%d "
+                  "avail_objects:%d, reclaim_size:%d reclaim_objects:%d\n",
+                  ret, (int)server_rc, (int)avail_size, (int)avail_objects,
+                  (int)reclaim_size, (int)reclaim_objects);
+    WH_TEST_ASSERT_RETURN(server_rc == WH_ERROR_OK);
+    WH_TEST_ASSERT_RETURN(avail_objects == WOLFHSM_CFG_NVM_OBJECT_COUNT);
+
+    /* Reset NVM state after flag tests */
+    WH_TEST_RETURN_ON_FAIL(ret = wh_Client_NvmCleanup(client, &server_rc));
     WH_TEST_ASSERT_RETURN(server_rc == WH_ERROR_OK);
     WH_TEST_RETURN_ON_FAIL(
         ret = wh_Client_NvmInit(client, &server_rc, &client_id, &server_id));
@@ -1687,8 +3826,18 @@ static int wh_ClientServer_PosixMemMapThreadTest(whTestNvmBackendType nvmType)
                     .transport_config  = (void*)tmcf,
                     .client_id         = WH_TEST_DEFAULT_CLIENT_ID,
     }};
+#ifdef WOLFHSM_CFG_CLIENT_WAIT
+    /* Block on the response doorbell after a short spin */
+    const whClientWaitConfig       wait_conf[1] = {{
+        .policy = {{16, 16, ONE_MS}, {16, 16, ONE_MS}},
+        .yield_cb = posixYield,
+    }};
+#endif /* WOLFHSM_CFG_CLIENT_WAIT */
     whClientConfig                 c_conf[1]  = {{
                          .comm = cc_conf,
+#ifdef WOLFHSM_CFG_CLIENT_WAIT
+                         .waitConfig = wait_conf,
+#endif /* WOLFHSM_CFG_CLIENT_WAIT */
     }};
     /* Server configuration/contexts */
     whTransportServerCb            tscb[1]    = {POSIX_TRANSPORT_SHM_SERVER_CB};
@@ -1749,6 +3898,248 @@ static int wh_ClientServer_PosixMemMapThreadTest(whTestNvmBackendType nvmType)
 
     return WH_ERROR_OK;
 }
+
+#define POOL_TEST_SERVERS 4
+#define POOL_TEST_WORKERS 2
+
+#ifdef WOLFHSM_CFG_THREADSAFE
+/* Have every client echo through the pool REPEAT_COUNT times, with all of
+ * them outstanding at once.  Servers are notified of each request if notify
+ * is set */
+static int _whClientServer_PoolEcho(posixServerPool* pool,
+                                    whClientContext* client, int notify)
+{
+    char     send_buffer[REQ_SIZE] = {0};
+    char     recv_buffer[REQ_SIZE] = {0};
+    uint16_t send_len              = 0;
+    uint16_t recv_len              = 0;
+    uint64_t handled               = 0;
+    int      ret                   = 0;
+    int      round                 = 0;
+    int      i                     = 0;
+
+    for (round = 0; round < REPEAT_COUNT; round++) {
+        for (i = 0; i < POOL_TEST_SERVERS; i++) {
+            send_len = snprintf(send_buffer, sizeof(send_buffer),
+                                "Pool %d echo %d", i, round);
+            WH_TEST_RETURN_ON_FAIL(
+                wh_Client_EchoRequest(&client[i], send_len, send_buffer));
+            if (notify != 0) {
+                WH_TEST_RETURN_ON_FAIL(posixServerPool_Notify(pool, i));
+            }
+        }
+        for (i = 0; i < POOL_TEST_SERVERS; i++) {
+            send_len = snprintf(send_buffer, sizeof(send_buffer),
+                                "Pool %d echo %d", i, round);
+            do {
+                ret = wh_Client_EchoResponse(&client[i], &recv_len,
+                                             recv_buffer);
+            } while (ret == WH_ERROR_NOTREADY);
+            WH_TEST_ASSERT_RETURN(ret == WH_ERROR_OK);
+            WH_TEST_ASSERT_RETURN(recv_len == send_len);
+            WH_TEST_ASSERT_RETURN(
+                0 == memcmp(recv_buffer, send_buffer, send_len));
+        }
+    }
+
+    /* Workers count a request after its response is sent */
+    do {
+        (void)sched_yield();
+        WH_TEST_RETURN_ON_FAIL(posixServerPool_GetHandled(pool, &handled));
+    } while (handled < (uint64_t)(REPEAT_COUNT * POOL_TEST_SERVERS));
+    WH_TEST_ASSERT_RETURN(handled == (uint64_t)(REPEAT_COUNT *
+                                                POOL_TEST_SERVERS));
+    return WH_ERROR_OK;
+}
+
+/* The mem transport has no readiness file descriptor */
+static int _whClientServer_PoolNoFd(whServerContext* server, int* out_fd)
+{
+    (void)server;
+    (void)out_fd;
+    return WH_ERROR_NOTIMPL;
+}
+
+/* Serve several clients from a worker pool with fewer threads than servers.
+ * The mem transport has no readiness file descriptor, so with idle_us of 0
+ * servers are only handled after a Notify, which must also wake the worker
+ * blocked in poll() */
+static int wh_ClientServer_PoolTest(uint32_t idle_us)
+{
+    static uint8_t       req[POOL_TEST_SERVERS][BUFFER_SIZE];
+    static uint8_t       resp[POOL_TEST_SERVERS][BUFFER_SIZE];
+    whTransportMemConfig tmcf[POOL_TEST_SERVERS];
+
+    whTransportClientCb         tccb[1] = {WH_TRANSPORT_MEM_CLIENT_CB};
+    whTransportMemClientContext tmcc[POOL_TEST_SERVERS];
+    whCommClientConfig          cc_conf[POOL_TEST_SERVERS];
+    whClientConfig              c_conf[POOL_TEST_SERVERS];
+    whClientContext             client[POOL_TEST_SERVERS];
+
+    whTransportServerCb         tscb[1] = {WH_TRANSPORT_MEM_SERVER_CB};
+    whTransportMemServerContext tmsc[POOL_TEST_SERVERS];
+    whCommServerConfig          cs_conf[POOL_TEST_SERVERS];
+    whServerConfig              s_conf[POOL_TEST_SERVERS];
+    whServerContext             server[POOL_TEST_SERVERS];
+    whServerContext*            servers[POOL_TEST_SERVERS];
+
+    posixServerPoolConfig pcfg[1] = {{
+        .servers      = servers,
+        .server_count = POOL_TEST_SERVERS,
+        .worker_count = POOL_TEST_WORKERS,
+    }};
+    posixServerPool pool[1] = {0};
+    int             i       = 0;
+
+    memset(tmcf, 0, sizeof(tmcf));
+    memset(tmcc, 0, sizeof(tmcc));
+    memset(cc_conf, 0, sizeof(cc_conf));
+    memset(c_conf, 0, sizeof(c_conf));
+    memset(client, 0, sizeof(client));
+    memset(tmsc, 0, sizeof(tmsc));
+    memset(cs_conf, 0, sizeof(cs_conf));
+    memset(s_conf, 0, sizeof(s_conf));
+    memset(server, 0, sizeof(server));
+    pcfg->idle_us = idle_us;
+    pcfg->get_fd  = _whClientServer_PoolNoFd;
+
+    for (i = 0; i < POOL_TEST_SERVERS; i++) {
+        tmcf[i].req       = (whTransportMemCsr*)req[i];
+        tmcf[i].req_size  = sizeof(req[i]);
+        tmcf[i].resp      = (whTransportMemCsr*)resp[i];
+        tmcf[i].resp_size = sizeof(resp[i]);
+
+        cs_conf[i].transport_cb      = tscb;
+        cs_conf[i].transport_context = (void*)&tmsc[i];
+        cs_conf[i].transport_config  = (void*)&tmcf[i];
+        cs_conf[i].server_id         = 124;
+        s_conf[i].comm_config        = &cs_conf[i];
+        servers[i]                   = &server[i];
+        WH_TEST_RETURN_ON_FAIL(wh_Server_Init(&server[i], &s_conf[i]));
+        WH_TEST_RETURN_ON_FAIL(
+            wh_Server_SetConnected(&server[i], WH_COMM_CONNECTED));
+
+        cc_conf[i].transport_cb      = tccb;
+        cc_conf[i].transport_context = (void*)&tmcc[i];
+        cc_conf[i].transport_config  = (void*)&tmcf[i];
+        cc_conf[i].client_id         = (uint8_t)(WH_TEST_DEFAULT_CLIENT_ID + i);
+        c_conf[i].comm               = &cc_conf[i];
+        WH_TEST_RETURN_ON_FAIL(wh_Client_Init(&client[i], &c_conf[i]));
+    }
+
+    WH_TEST_RETURN_ON_FAIL(posixServerPool_Init(pool, pcfg));
+    WH_TEST_ASSERT_RETURN(WH_ERROR_BADARGS ==
+                          posixServerPool_Notify(pool, POOL_TEST_SERVERS));
+    WH_TEST_RETURN_ON_FAIL(
+        _whClientServer_PoolEcho(pool, client, (idle_us == 0)));
+
+    WH_TEST_RETURN_ON_FAIL(posixServerPool_Cleanup(pool));
+    for (i = 0; i < POOL_TEST_SERVERS; i++) {
+        WH_TEST_RETURN_ON_FAIL(wh_Client_Cleanup(&client[i]));
+        WH_TEST_RETURN_ON_FAIL(wh_Server_Cleanup(&server[i]));
+    }
+
+    return WH_ERROR_OK;
+}
+
+#if defined(__linux__)
+static int _whClientServer_PoolGetFd(whServerContext* server, int* out_fd)
+{
+    return posixTransportUds_GetServerWaitFd(
+        (posixTransportUdsServerContext*)server->comm->transport_context,
+        out_fd);
+}
+
+/* Serve several UDS clients from a worker pool with an idle_us of 0 and no
+ * Notify, so workers only learn of requests by polling the sockets */
+static int wh_ClientServer_PoolWaitTest(void)
+{
+    char                    path[POOL_TEST_SERVERS][64];
+    posixTransportUdsConfig ptucfg[POOL_TEST_SERVERS];
+
+    whTransportClientCb tccb[1] = {POSIX_TRANSPORT_UDS_CLIENT_CB};
+    posixTransportUdsClientContext tcc[POOL_TEST_SERVERS];
+    whCommClientConfig             cc_conf[POOL_TEST_SERVERS];
+    whClientConfig                 c_conf[POOL_TEST_SERVERS];
+    whClientContext                client[POOL_TEST_SERVERS];
+
+    whTransportServerCb tscb[1] = {POSIX_TRANSPORT_UDS_SERVER_CB};
+    posixTransportUdsServerContext tssc[POOL_TEST_SERVERS];
+    whCommServerConfig             cs_conf[POOL_TEST_SERVERS];
+    whServerConfig                 s_conf[POOL_TEST_SERVERS];
+    whServerContext                server[POOL_TEST_SERVERS];
+    whServerContext*               servers[POOL_TEST_SERVERS];
+
+    posixServerPoolConfig pcfg[1] = {{
+        .servers      = servers,
+        .server_count = POOL_TEST_SERVERS,
+        .worker_count = POOL_TEST_WORKERS,
+        .idle_us      = 0,
+        .get_fd       = _whClientServer_PoolGetFd,
+    }};
+    posixServerPool pool[1] = {0};
+    int             i       = 0;
+
+    memset(ptucfg, 0, sizeof(ptucfg));
+    memset(tcc, 0, sizeof(tcc));
+    memset(cc_conf, 0, sizeof(cc_conf));
+    memset(c_conf, 0, sizeof(c_conf));
+    memset(client, 0, sizeof(client));
+    memset(tssc, 0, sizeof(tssc));
+    memset(cs_conf, 0, sizeof(cs_conf));
+    memset(s_conf, 0, sizeof(s_conf));
+    memset(server, 0, sizeof(server));
+
+    for (i = 0; i < POOL_TEST_SERVERS; i++) {
+        snprintf(path[i], sizeof(path[i]), "/tmp/wh_test_pool_wait%d.%u", i,
+                 (unsigned)getpid());
+        ptucfg[i].socket_path = path[i];
+
+        cs_conf[i].transport_cb      = tscb;
+        cs_conf[i].transport_context = (void*)&tssc[i];
+        cs_conf[i].transport_config  = (void*)&ptucfg[i];
+        cs_conf[i].server_id         = 124;
+        s_conf[i].comm_config        = &cs_conf[i];
+        servers[i]                   = &server[i];
+        WH_TEST_RETURN_ON_FAIL(wh_Server_Init(&server[i], &s_conf[i]));
+
+        cc_conf[i].transport_cb      = tccb;
+        cc_conf[i].transport_context = (void*)&tcc[i];
+        cc_conf[i].transport_config  = (void*)&ptucfg[i];
+        cc_conf[i].client_id         = (uint8_t)(WH_TEST_DEFAULT_CLIENT_ID + i);
+        c_conf[i].comm               = &cc_conf[i];
+        WH_TEST_RETURN_ON_FAIL(wh_Client_Init(&client[i], &c_conf[i]));
+    }
+
+    WH_TEST_RETURN_ON_FAIL(posixServerPool_Init(pool, pcfg));
+    WH_TEST_RETURN_ON_FAIL(_whClientServer_PoolEcho(pool, client, 0));
+
+    WH_TEST_RETURN_ON_FAIL(posixServerPool_Cleanup(pool));
+    for (i = 0; i < POOL_TEST_SERVERS; i++) {
+        WH_TEST_RETURN_ON_FAIL(wh_Client_Cleanup(&client[i]));
+        WH_TEST_RETURN_ON_FAIL(wh_Server_Cleanup(&server[i]));
+    }
+
+    return WH_ERROR_OK;
+}
+#endif /* __linux__ */
+#else
+/* The pool refuses to run servers concurrently without locking */
+static int wh_ClientServer_PoolUnsafeTest(void)
+{
+    whServerContext       server[1];
+    whServerContext*      servers[1] = {server};
+    posixServerPoolConfig pcfg[1]    = {{
+           .servers      = servers,
+           .server_count = 1,
+           .worker_count = 1,
+    }};
+    posixServerPool pool[1] = {0};
+
+    WH_TEST_ASSERT_RETURN(WH_ERROR_NOTIMPL == posixServerPool_Init(pool, pcfg));
+    return WH_ERROR_OK;
+}
+#endif /* WOLFHSM_CFG_THREADSAFE */
 #endif /* WOLFHSM_CFG_TEST_POSIX && WOLFHSM_CFG_ENABLE_CLIENT && \
           WOLFHSM_CFG_ENABLE_SERVER */
 
@@ -1764,6 +4155,43 @@ int whTest_ClientServer(void)
                    whTest_ClientServerSequential(WH_NVM_TEST_BACKEND_FLASH_LOG));
 #endif /* defined(WOLFHSM_CFG_SERVER_NVM_FLASH_LOG) */
 
+#if defined(WOLFHSM_CFG_CLIENT_PIPELINE)
+    WH_TEST_PRINT("Testing client/server pipelined requests: mem ring...\n");
+    WH_TEST_ASSERT(0 == whTest_ClientServerPipeline());
+#endif /* WOLFHSM_CFG_CLIENT_PIPELINE */
+
+    WH_TEST_PRINT("Testing client/server: direct dispatch...\n");
+    WH_TEST_ASSERT(0 == whTest_ClientServerDirect());
+
+#if defined(WOLFHSM_CFG_BATCH)
+    WH_TEST_PRINT("Testing client/server: batch response overrun...\n");
+    WH_TEST_ASSERT(0 == whTest_ClientServerBatchOverrun());
+#endif /* WOLFHSM_CFG_BATCH */
+
+#if defined(WOLFHSM_CFG_SERVER_LANES)
+    WH_TEST_PRINT("Testing client/server: priority lanes...\n");
+    WH_TEST_ASSERT(0 == whTest_ClientServerLanes());
+#if defined(WOLFHSM_CFG_TEST_POSIX) && defined(__linux__)
+    WH_TEST_PRINT("Testing client/server: waiting on priority lanes...\n");
+    WH_TEST_ASSERT(0 == whTest_ClientServerLanesWait(0));
+    WH_TEST_PRINT("Testing client/server: waiting on a lane wait set...\n");
+    WH_TEST_ASSERT(0 == whTest_ClientServerLanesWait(1));
+    WH_TEST_PRINT("Testing client/server: skipping lanes that cannot wait...\n");
+    WH_TEST_ASSERT(0 == whTest_ClientServerLanesWaitSkip(0));
+    WH_TEST_ASSERT(0 == whTest_ClientServerLanesWaitSkip(1));
+#endif
+#endif /* WOLFHSM_CFG_SERVER_LANES */
+
+#if defined(WOLFHSM_CFG_COMM_SESSIONS)
+    WH_TEST_PRINT("Testing client/server: sessions...\n");
+    WH_TEST_ASSERT(0 == whTest_ClientServerSessions());
+#endif /* WOLFHSM_CFG_COMM_SESSIONS */
+
+#if defined(WOLFHSM_CFG_COMM_FRAGMENT)
+    WH_TEST_PRINT("Testing client/server: NVM and certificates in fragments...\n");
+    WH_TEST_ASSERT(0 == whTest_ClientServerFragment());
+#endif /* WOLFHSM_CFG_COMM_FRAGMENT */
+
 #if defined(WOLFHSM_CFG_TEST_POSIX)
     WH_TEST_PRINT("Testing client/server: (pthread) mem...\n");
     WH_TEST_ASSERT(0 == wh_ClientServer_MemThreadTest(WH_NVM_TEST_BACKEND_FLASH));
@@ -1772,6 +4200,22 @@ int whTest_ClientServer(void)
     WH_TEST_ASSERT(
         0 == wh_ClientServer_PosixMemMapThreadTest(WH_NVM_TEST_BACKEND_FLASH));
 
+#ifdef WOLFHSM_CFG_THREADSAFE
+    WH_TEST_PRINT("Testing client/server: (pthread) worker pool, polled...\n");
+    WH_TEST_ASSERT(0 == wh_ClientServer_PoolTest(ONE_MS));
+
+    WH_TEST_PRINT("Testing client/server: (pthread) worker pool, notified...\n");
+    WH_TEST_ASSERT(0 == wh_ClientServer_PoolTest(0));
+
+#if defined(__linux__)
+    WH_TEST_PRINT("Testing client/server: (pthread) worker pool, waiting...\n");
+    WH_TEST_ASSERT(0 == wh_ClientServer_PoolWaitTest());
+#endif
+#else
+    WH_TEST_PRINT("Testing client/server: worker pool needs THREADSAFE...\n");
+    WH_TEST_ASSERT(0 == wh_ClientServer_PoolUnsafeTest());
+#endif /* WOLFHSM_CFG_THREADSAFE */
+
 #if defined(WOLFHSM_CFG_SERVER_NVM_FLASH_LOG)
     WH_TEST_PRINT("Testing client/server: (pthread) mem + flash log...\n");
     WH_TEST_ASSERT(0 ==
@@ -32,6 +32,8 @@
 #include "wolfhsm/wh_error.h"
 #include "wolfhsm/wh_comm.h"
 #include "wolfhsm/wh_transport_mem.h"
+#include "wolfhsm/wh_transport_session.h"
+#include "wolfhsm/wh_message_counter.h"
 
 #ifdef WOLFHSM_CFG_ENABLE_SERVER
 #include "wolfhsm/wh_server.h"
@@ -44,9 +46,16 @@
 #if defined(WOLFHSM_CFG_TEST_POSIX)
 #include <pthread.h> /* For pthread_create/cancel/join/_t */
 #include <unistd.h>
+#include <fcntl.h>    /* For O_* constants */
+#include <sys/mman.h> /* For shm_open */
+#include <sys/resource.h> /* For getrlimit/setrlimit */
 #include <time.h> /* For nanosleep */
 #include "port/posix/posix_transport_tcp.h"
 #include "port/posix/posix_transport_shm.h"
+#if defined(__linux__)
+#include "port/posix/posix_transport_uds.h"
+#include "port/posix/posix_transport_tcp_uring.h"
+#endif
 
 const struct timespec ONE_MS = {.tv_sec = 0, .tv_nsec = 1000000};
 #endif
@@ -57,7 +66,58 @@ const struct timespec ONE_MS = {.tv_sec = 0, .tv_nsec = 1000000};
 #define REQ_SIZE 32
 #define RESP_SIZE 64
 #define REPEAT_COUNT 10
+#define RING_SLOT_COUNT 4
+
+
+int whTest_CommTranslate(void)
+{
+    whMessageCounter_InitRequest src[1];
+    whMessageCounter_InitRequest dest[1];
+
+    memset(src, 0, sizeof(src));
+    src->counter   = 0x11223344u;
+    src->counterId = 0x5566u;
+
+    /* Native messages are copied */
+    memset(dest, 0xFF, sizeof(dest));
+    WH_TEST_RETURN_ON_FAIL(wh_MessageCounter_TranslateInitRequest(
+        WH_COMM_MAGIC_NATIVE, src, dest));
+    WH_TEST_ASSERT_RETURN(dest->counter == src->counter);
+    WH_TEST_ASSERT_RETURN(dest->counterId == src->counterId);
+
+    /* Native translation in place leaves the message unchanged */
+    WH_TEST_RETURN_ON_FAIL(wh_MessageCounter_TranslateInitRequest(
+        WH_COMM_MAGIC_NATIVE, dest, dest));
+    WH_TEST_ASSERT_RETURN(dest->counter == src->counter);
+    WH_TEST_ASSERT_RETURN(dest->counterId == src->counterId);
+
+    /* The translate helpers are plain copies for a native magic */
+    WH_TEST_ASSERT_RETURN(wh_Translate16(WH_COMM_MAGIC_NATIVE, 0x1234u) ==
+                          0x1234u);
+    WH_TEST_ASSERT_RETURN(wh_Translate32(WH_COMM_MAGIC_NATIVE, 0x12345678u) ==
+                          0x12345678u);
+
+#ifndef WOLFHSM_CFG_COMM_NATIVE_ONLY
+    /* Other endianness is translated per member */
+    memset(dest, 0, sizeof(dest));
+    WH_TEST_RETURN_ON_FAIL(wh_MessageCounter_TranslateInitRequest(
+        WH_COMM_MAGIC_SWAP, src, dest));
+    WH_TEST_ASSERT_RETURN(dest->counter == 0x44332211u);
+    WH_TEST_ASSERT_RETURN(dest->counterId == 0x6655u);
+
+    WH_TEST_RETURN_ON_FAIL(wh_MessageCounter_TranslateInitRequest(
+        WH_COMM_MAGIC_SWAP, dest, dest));
+    WH_TEST_ASSERT_RETURN(dest->counter == src->counter);
+    WH_TEST_ASSERT_RETURN(dest->counterId == src->counterId);
+
+    WH_TEST_ASSERT_RETURN(wh_Translate16(WH_COMM_MAGIC_SWAP, 0x1234u) ==
+                          0x3412u);
+    WH_TEST_ASSERT_RETURN(wh_Translate32(WH_COMM_MAGIC_SWAP, 0x12345678u) ==
+                          0x78563412u);
+#endif /* !WOLFHSM_CFG_COMM_NATIVE_ONLY */
 
+    return 0;
+}
 
 #if defined(WOLFHSM_CFG_ENABLE_CLIENT) && defined(WOLFHSM_CFG_ENABLE_SERVER)
 int whTest_CommMem(void)
@@ -124,6 +184,10 @@ int whTest_CommMem(void)
     uint16_t rx_resp_type       = 0;
     uint16_t rx_resp_seq        = 0;
 
+    /* The mem transport has no blocking wait */
+    WH_TEST_ASSERT_RETURN(WH_ERROR_NOTIMPL ==
+                          wh_CommServer_WaitRequest(server, 0));
+
     /* Check that neither side is ready to recv */
     WH_TEST_ASSERT_RETURN(WH_ERROR_NOTREADY ==
                           wh_CommServer_RecvRequest(server, &rx_req_flags,
@@ -182,6 +246,789 @@ int whTest_CommMem(void)
             rx_resp);
     }
 
+    /* Build a request in place in the transport buffer */
+    {
+        uint8_t*    tx_data      = NULL;
+        uint16_t    tx_data_size = 0;
+        const char  frag0[]      = "gathered ";
+        const char  frag1[]      = "request";
+        whCommIoVec iov[3]       = {{0}};
+
+        WH_TEST_RETURN_ON_FAIL(
+            wh_CommClient_GetSendDataPtr(client, &tx_data_size, &tx_data));
+        WH_TEST_ASSERT_RETURN(tx_data == req + sizeof(whTransportMemCsr) +
+                                             sizeof(whCommHeader));
+        WH_TEST_ASSERT_RETURN(tx_data_size == sizeof(req) -
+                                                  sizeof(whTransportMemCsr) -
+                                                  sizeof(whCommHeader));
+        memcpy(tx_data, "in place", sizeof("in place"));
+        WH_TEST_RETURN_ON_FAIL(wh_CommClient_SendRequest(
+            client, tx_req_flags, tx_req_type, &tx_req_seq,
+            sizeof("in place"), tx_data));
+
+        /* The transport buffer is busy, so the internal buffer is used */
+        WH_TEST_RETURN_ON_FAIL(
+            wh_CommClient_GetSendDataPtr(client, &tx_data_size, &tx_data));
+        WH_TEST_ASSERT_RETURN(tx_data == wh_CommClient_GetDataPtr(client));
+
+        WH_TEST_RETURN_ON_FAIL(
+            wh_CommServer_RecvRequest(server, &rx_req_flags, &rx_req_type,
+                                      &rx_req_seq, &rx_req_len, rx_req));
+        WH_TEST_ASSERT_RETURN(rx_req_seq == tx_req_seq);
+        WH_TEST_ASSERT_RETURN(rx_req_len == sizeof("in place"));
+        WH_TEST_ASSERT_RETURN(0 == memcmp(rx_req, "in place", rx_req_len));
+        WH_TEST_RETURN_ON_FAIL(wh_CommServer_SendResponse(
+            server, rx_req_flags, rx_req_type, rx_req_seq, 0, NULL));
+        WH_TEST_RETURN_ON_FAIL(
+            wh_CommClient_RecvResponse(client, &rx_resp_flags, &rx_resp_type,
+                                       &rx_resp_seq, &rx_resp_len, rx_resp));
+
+        /* Gather a request from several fragments, including an empty one */
+        iov[0].data = frag0;
+        iov[0].size = sizeof(frag0) - 1;
+        iov[2].data = frag1;
+        iov[2].size = sizeof(frag1);
+        WH_TEST_RETURN_ON_FAIL(wh_CommClient_SendRequestV(
+            client, tx_req_flags, tx_req_type, &tx_req_seq, 3, iov));
+        WH_TEST_RETURN_ON_FAIL(
+            wh_CommServer_RecvRequest(server, &rx_req_flags, &rx_req_type,
+                                      &rx_req_seq, &rx_req_len, rx_req));
+        WH_TEST_ASSERT_RETURN(rx_req_seq == tx_req_seq);
+        WH_TEST_ASSERT_RETURN(rx_req_len ==
+                              sizeof(frag0) - 1 + sizeof(frag1));
+        WH_TEST_ASSERT_RETURN(0 == memcmp(rx_req, "gathered request",
+                                          rx_req_len));
+        WH_TEST_RETURN_ON_FAIL(wh_CommServer_SendResponse(
+            server, rx_req_flags, rx_req_type, rx_req_seq, 0, NULL));
+        WH_TEST_RETURN_ON_FAIL(
+            wh_CommClient_RecvResponse(client, &rx_resp_flags, &rx_resp_type,
+                                       &rx_resp_seq, &rx_resp_len, rx_resp));
+    }
+
+    WH_TEST_RETURN_ON_FAIL(wh_CommServer_Cleanup(server));
+    WH_TEST_RETURN_ON_FAIL(wh_CommClient_Cleanup(client));
+
+    return ret;
+}
+
+int whTest_CommMemCsrPadded(void)
+{
+    const uint16_t csr_size = WH_TRANSPORT_MEM_CSR_SIZE_CACHELINE;
+
+    /* Transport memory, aligned to the CSR size below */
+    uint8_t  req_mem[BUFFER_SIZE + WH_TRANSPORT_MEM_CSR_SIZE_CACHELINE];
+    uint8_t  resp_mem[BUFFER_SIZE + WH_TRANSPORT_MEM_CSR_SIZE_CACHELINE];
+    uint8_t* req  = req_mem + (csr_size - ((uintptr_t)req_mem % csr_size));
+    uint8_t* resp = resp_mem + (csr_size - ((uintptr_t)resp_mem % csr_size));
+    whTransportMemConfig tmcf[1] = {{0}};
+
+    whTransportMemClientContext tmcc[1] = {0};
+    whTransportMemServerContext tmsc[1] = {0};
+
+    uint8_t  tx[REQ_SIZE] = "padded request";
+    uint8_t  rx[RESP_SIZE] = {0};
+    uint16_t rx_len        = 0;
+    uint8_t* buffer        = NULL;
+    uint16_t buffer_size   = 0;
+
+    tmcf->req       = req;
+    tmcf->req_size  = BUFFER_SIZE - 1;
+    tmcf->resp      = resp;
+    tmcf->resp_size = BUFFER_SIZE;
+    tmcf->csr_size  = csr_size;
+
+    /* Buffers must be aligned to a power of 2 CSR size */
+    tmcf->req = req + sizeof(whTransportMemCsr);
+    WH_TEST_ASSERT_RETURN(WH_ERROR_BADARGS ==
+                          wh_TransportMem_InitClear(tmcc, tmcf, NULL, NULL));
+    tmcf->req      = req;
+    tmcf->csr_size = csr_size + sizeof(whTransportMemCsr);
+    WH_TEST_ASSERT_RETURN(WH_ERROR_BADARGS ==
+                          wh_TransportMem_InitClear(tmcc, tmcf, NULL, NULL));
+    tmcf->csr_size = csr_size;
+
+    WH_TEST_RETURN_ON_FAIL(wh_TransportMem_InitClear(tmcc, tmcf, NULL, NULL));
+    WH_TEST_RETURN_ON_FAIL(wh_TransportMem_Init(tmsc, tmcf, NULL, NULL));
+
+    /* Data starts on the line after the CSR and ends on a line boundary */
+    WH_TEST_RETURN_ON_FAIL(
+        wh_TransportMem_GetSendBuffer(tmcc, &buffer_size, (void**)&buffer));
+    WH_TEST_ASSERT_RETURN(buffer == req + csr_size);
+    WH_TEST_ASSERT_RETURN(buffer_size == BUFFER_SIZE - 2 * csr_size);
+    WH_TEST_ASSERT_RETURN(WH_ERROR_BADARGS ==
+                          wh_TransportMem_SendRequest(tmcc, buffer_size + 1,
+                                                      buffer));
+
+    WH_TEST_RETURN_ON_FAIL(wh_TransportMem_SendRequest(tmcc, sizeof(tx), tx));
+    WH_TEST_RETURN_ON_FAIL(wh_TransportMem_RecvRequest(tmsc, &rx_len, rx));
+    WH_TEST_ASSERT_RETURN(rx_len == sizeof(tx));
+    WH_TEST_ASSERT_RETURN(0 == memcmp(rx, tx, sizeof(tx)));
+    WH_TEST_ASSERT_RETURN(0 == memcmp(req + csr_size, tx, sizeof(tx)));
+
+    WH_TEST_RETURN_ON_FAIL(wh_TransportMem_SendResponse(tmsc, rx_len, rx));
+    WH_TEST_ASSERT_RETURN(0 == memcmp(resp + csr_size, tx, sizeof(tx)));
+    memset(rx, 0, sizeof(rx));
+    WH_TEST_RETURN_ON_FAIL(wh_TransportMem_RecvResponse(tmcc, &rx_len, rx));
+    WH_TEST_ASSERT_RETURN(rx_len == sizeof(tx));
+    WH_TEST_ASSERT_RETURN(0 == memcmp(rx, tx, sizeof(tx)));
+
+    WH_TEST_RETURN_ON_FAIL(wh_TransportMem_Cleanup(tmsc));
+    WH_TEST_RETURN_ON_FAIL(wh_TransportMem_Cleanup(tmcc));
+
+    return 0;
+}
+
+#ifdef WOLFHSM_CFG_COMM_FRAGMENT
+/* Transport buffers much smaller than the messages sent over them */
+#define FRAG_BUFFER_SIZE 128
+#define FRAG_SIZE (FRAG_BUFFER_SIZE - sizeof(whTransportMemCsr))
+#define FRAG_REQ_SIZE 1000
+#define FRAG_RESP_SIZE 3000
+/* Larger than an unfragmented packet, when the configuration allows it */
+#define FRAG_LARGE_SIZE WOLFHSM_CFG_COMM_FRAGMENT_DATA_LEN
+
+/* Fill a buffer with a pattern that differs per offset and per message */
+static void _fragTestFill(uint8_t* data, uint16_t size, uint8_t seed)
+{
+    uint16_t i;
+    for (i = 0; i < size; i++) {
+        data[i] = (uint8_t)(i + (i >> 8) + seed);
+    }
+}
+
+static int _fragTestCheck(const uint8_t* data, uint16_t size, uint8_t seed)
+{
+    uint16_t i;
+    for (i = 0; i < size; i++) {
+        if (data[i] != (uint8_t)(i + (i >> 8) + seed)) {
+            return WH_ERROR_ABORTED;
+        }
+    }
+    return 0;
+}
+
+#ifdef WOLFHSM_CFG_COMM_SESSIONS
+/* Sessions sharing a fragmenting connection */
+static int _whTestCommFragmentSessions(void)
+{
+    int ret = 0;
+    int i   = 0;
+
+    /* Transport memory configuration */
+    uint8_t              req[FRAG_BUFFER_SIZE]  = {0};
+    uint8_t              resp[FRAG_BUFFER_SIZE] = {0};
+    whTransportMemConfig tmcf[1] = {{
+        .req       = (whTransportMemCsr*)req,
+        .req_size  = sizeof(req),
+        .resp      = (whTransportMemCsr*)resp,
+        .resp_size = sizeof(resp),
+    }};
+
+    /* Client configuration/contexts, one per session */
+    whTransportClientCb          tmccb[1] = {WH_TRANSPORT_MEM_CLIENT_CB};
+    whTransportMemClientContext  tmcc[1]  = {0};
+    whTransportSessionConnection conn[1]  = {0};
+    whTransportSessionConfig     tscf[1]  = {{
+             .conn              = conn,
+             .transport_cb      = tmccb,
+             .transport_context = (void*)tmcc,
+             .transport_config  = (void*)tmcf,
+             .fragment_size     = FRAG_SIZE,
+    }};
+    whTransportClientCb       tsccb[1]  = {WH_TRANSPORT_SESSION_CLIENT_CB};
+    whTransportSessionContext tsctx[2]  = {{0}};
+    whCommClientConfig        c_conf[2] = {{
+                 .transport_cb      = tsccb,
+                 .transport_context = (void*)&tsctx[0],
+                 .transport_config  = (void*)tscf,
+                 .client_id         = WH_TEST_DEFAULT_CLIENT_ID,
+                 .session_id        = 1,
+                 .fragment_size     = FRAG_SIZE,
+    }, {
+                 .transport_cb      = tsccb,
+                 .transport_context = (void*)&tsctx[1],
+                 .transport_config  = (void*)tscf,
+                 .client_id         = WH_TEST_DEFAULT_CLIENT_ID + 1,
+                 .session_id        = 2,
+                 .fragment_size     = FRAG_SIZE,
+    }};
+    whCommClient client[2] = {{0}};
+
+    /* Server configuration/contexts */
+    whTransportServerCb         tscb[1]   = {WH_TRANSPORT_MEM_SERVER_CB};
+    whTransportMemServerContext tmsc[1]   = {0};
+    whCommServerConfig          s_conf[1] = {{
+                 .transport_cb      = tscb,
+                 .transport_context = (void*)tmsc,
+                 .transport_config  = (void*)tmcf,
+                 .server_id         = 124,
+                 .fragment_size     = FRAG_SIZE,
+    }};
+    whCommServer server[1] = {0};
+
+    uint8_t  tx_req[FRAG_REQ_SIZE]   = {0};
+    uint8_t  rx_req[FRAG_REQ_SIZE]   = {0};
+    uint8_t  tx_resp[FRAG_RESP_SIZE] = {0};
+    uint8_t  rx_resp[FRAG_RESP_SIZE] = {0};
+    uint16_t magic                   = 0;
+    uint16_t kind                    = 0;
+    uint16_t tx_seq                  = 0;
+    uint16_t rx_seq                  = 0;
+    uint16_t rx_len                  = 0;
+
+    _fragTestFill(tx_req, sizeof(tx_req), 5);
+    _fragTestFill(tx_resp, sizeof(tx_resp), 6);
+
+    WH_TEST_RETURN_ON_FAIL(wh_CommServer_Init(server, s_conf, NULL, NULL));
+    WH_TEST_RETURN_ON_FAIL(wh_CommClient_Init(&client[0], &c_conf[0]));
+    WH_TEST_RETURN_ON_FAIL(wh_CommClient_Init(&client[1], &c_conf[1]));
+
+    /* Every session of a connection must fragment the same way */
+    tscf->fragment_size = 0;
+    WH_TEST_ASSERT_RETURN(WH_ERROR_BADARGS ==
+                          wh_TransportSession_Init(&tsctx[1], tscf, NULL,
+                                                   NULL));
+    tscf->fragment_size = FRAG_SIZE;
+
+    /* A session keeps the connection between the fragments of its request and
+     * of its response, not only while a fragment is in flight */
+    WH_TEST_RETURN_ON_FAIL(wh_CommClient_SendRequest(
+        &client[0], WH_COMM_MAGIC_NATIVE, 1, &tx_seq, sizeof(tx_req), tx_req));
+    while ((ret = wh_CommServer_RecvRequest(server, &magic, &kind, &rx_seq,
+                                            &rx_len, rx_req)) ==
+           WH_ERROR_NOTREADY) {
+        WH_TEST_ASSERT_RETURN(WH_ERROR_NOTREADY ==
+                              wh_CommClient_RecvResponse(&client[0], NULL,
+                                                         NULL, NULL, NULL,
+                                                         NULL));
+        WH_TEST_ASSERT_RETURN(conn->owner == (void*)&tsctx[0]);
+        WH_TEST_ASSERT_RETURN(WH_ERROR_NOTREADY ==
+                              wh_CommClient_SendRequest(
+                                  &client[1], WH_COMM_MAGIC_NATIVE, 2, NULL,
+                                  4, tx_req));
+    }
+    WH_TEST_ASSERT_RETURN(ret == 0);
+    WH_TEST_ASSERT_RETURN(rx_len == sizeof(tx_req));
+    WH_TEST_ASSERT_RETURN(0 == memcmp(rx_req, tx_req, sizeof(tx_req)));
+
+    WH_TEST_RETURN_ON_FAIL(wh_CommServer_SendResponse(
+        server, magic, kind, rx_seq, sizeof(tx_resp), tx_resp));
+    while ((ret = wh_CommClient_RecvResponse(&client[0], &magic, &kind,
+                                             &rx_seq, &rx_len, rx_resp)) ==
+           WH_ERROR_NOTREADY) {
+        WH_TEST_ASSERT_RETURN(WH_ERROR_NOTREADY ==
+                              wh_CommClient_SendRequest(
+                                  &client[1], WH_COMM_MAGIC_NATIVE, 2, NULL,
+                                  4, tx_req));
+        WH_TEST_ASSERT_RETURN(WH_ERROR_NOTREADY ==
+                              wh_CommServer_RecvRequest(server, NULL, NULL,
+                                                        NULL, NULL, NULL));
+    }
+    WH_TEST_ASSERT_RETURN(ret == 0);
+    WH_TEST_ASSERT_RETURN(rx_seq == tx_seq);
+    WH_TEST_ASSERT_RETURN(rx_len == sizeof(tx_resp));
+    WH_TEST_ASSERT_RETURN(0 == memcmp(rx_resp, tx_resp, sizeof(tx_resp)));
+    WH_TEST_ASSERT_RETURN(conn->owner == NULL);
+
+    /* The other session may use the connection once the response is in */
+    for (i = 0; i < 2; i++) {
+        WH_TEST_RETURN_ON_FAIL(wh_CommClient_SendRequest(
+            &client[1 - i], WH_COMM_MAGIC_NATIVE, 3, &tx_seq, 4, tx_req));
+        WH_TEST_RETURN_ON_FAIL(wh_CommServer_RecvRequest(
+            server, &magic, &kind, &rx_seq, &rx_len, rx_req));
+        WH_TEST_ASSERT_RETURN(rx_len == 4);
+        WH_TEST_RETURN_ON_FAIL(
+            wh_CommServer_SendResponse(server, magic, kind, rx_seq, 0, NULL));
+        WH_TEST_RETURN_ON_FAIL(wh_CommClient_RecvResponse(
+            &client[1 - i], NULL, NULL, &rx_seq, &rx_len, NULL));
+        WH_TEST_ASSERT_RETURN(rx_seq == tx_seq);
+        WH_TEST_ASSERT_RETURN(conn->owner == NULL);
+    }
+
+    WH_TEST_RETURN_ON_FAIL(wh_CommClient_Cleanup(&client[1]));
+    WH_TEST_RETURN_ON_FAIL(wh_CommClient_Cleanup(&client[0]));
+    WH_TEST_RETURN_ON_FAIL(wh_CommServer_Cleanup(server));
+
+    return 0;
+}
+#endif /* WOLFHSM_CFG_COMM_SESSIONS */
+
+int whTest_CommMemFragment(void)
+{
+    int ret = 0;
+    int i   = 0;
+
+    /* Transport memory configuration */
+    uint8_t              req[FRAG_BUFFER_SIZE]  = {0};
+    uint8_t              resp[FRAG_BUFFER_SIZE] = {0};
+    whTransportMemConfig tmcf[1] = {{
+        .req       = (whTransportMemCsr*)req,
+        .req_size  = sizeof(req),
+        .resp      = (whTransportMemCsr*)resp,
+        .resp_size = sizeof(resp),
+    }};
+
+    /* Client configuration/contexts */
+    whTransportClientCb         tccb[1]   = {WH_TRANSPORT_MEM_CLIENT_CB};
+    whTransportMemClientContext tmcc[1]   = {0};
+    whCommClientConfig          c_conf[1] = {{
+                 .transport_cb      = tccb,
+                 .transport_context = (void*)tmcc,
+                 .transport_config  = (void*)tmcf,
+                 .client_id         = WH_TEST_DEFAULT_CLIENT_ID,
+                 .fragment_size     = FRAG_SIZE,
+    }};
+    whCommClient                client[1] = {0};
+
+    /* Server configuration/contexts */
+    whTransportServerCb         tscb[1]   = {WH_TRANSPORT_MEM_SERVER_CB};
+    whTransportMemServerContext tmsc[1]   = {0};
+    whCommServerConfig          s_conf[1] = {{
+                 .transport_cb      = tscb,
+                 .transport_context = (void*)tmsc,
+                 .transport_config  = (void*)tmcf,
+                 .server_id         = 124,
+                 .fragment_size     = FRAG_SIZE,
+    }};
+    whCommServer                server[1] = {0};
+
+    uint8_t  tx_req[FRAG_REQ_SIZE]   = {0};
+    uint8_t  rx_req[FRAG_REQ_SIZE]   = {0};
+    uint8_t  tx_resp[FRAG_RESP_SIZE] = {0};
+    uint8_t  rx_resp[FRAG_RESP_SIZE] = {0};
+    uint16_t magic                   = 0;
+    uint16_t kind                    = 0;
+    uint16_t tx_seq                  = 0;
+    uint16_t rx_seq                  = 0;
+    uint16_t rx_len                  = 0;
+    int      acks                    = 0;
+
+    for (i = 0; i < FRAG_REQ_SIZE; i++) {
+        tx_req[i] = (uint8_t)i;
+    }
+    for (i = 0; i < FRAG_RESP_SIZE; i++) {
+        tx_resp[i] = (uint8_t)(i * 7);
+    }
+
+    /* Fragments must hold more than a header and keep headers aligned */
+    c_conf->fragment_size = sizeof(whCommFragHeader);
+    WH_TEST_ASSERT_RETURN(WH_ERROR_BADARGS == wh_CommClient_Init(client, c_conf));
+    c_conf->fragment_size = FRAG_SIZE + 1;
+    WH_TEST_ASSERT_RETURN(WH_ERROR_BADARGS == wh_CommClient_Init(client, c_conf));
+    c_conf->fragment_size = FRAG_SIZE;
+
+    WH_TEST_RETURN_ON_FAIL(wh_CommClient_Init(client, c_conf));
+    WH_TEST_RETURN_ON_FAIL(wh_CommServer_Init(server, s_conf, NULL, NULL));
+
+    /* Requests are built in the internal buffer, which holds an MTU. Only
+     * streamed requests may be larger, and only up to the reassembly size of
+     * the server */
+    {
+        uint8_t* tx_data      = NULL;
+        uint16_t tx_data_size = 0;
+        WH_TEST_RETURN_ON_FAIL(
+            wh_CommClient_GetSendDataPtr(client, &tx_data_size, &tx_data));
+        WH_TEST_ASSERT_RETURN(tx_data == wh_CommClient_GetDataPtr(client));
+        WH_TEST_ASSERT_RETURN(tx_data_size == WOLFHSM_CFG_COMM_DATA_LEN);
+        WH_TEST_ASSERT_RETURN(wh_CommClient_GetMaxDataLen(client) ==
+                              WOLFHSM_CFG_COMM_FRAGMENT_DATA_LEN);
+        WH_TEST_ASSERT_RETURN(wh_CommServer_GetMaxDataLen(server) ==
+                              WOLFHSM_CFG_COMM_DATA_LEN);
+    }
+
+    /* A request larger than the transport buffer, acked fragment by fragment */
+    WH_TEST_RETURN_ON_FAIL(wh_CommClient_SendRequest(
+        client, WH_COMM_MAGIC_NATIVE, 1, &tx_seq, sizeof(tx_req), tx_req));
+    while ((ret = wh_CommServer_RecvRequest(server, &magic, &kind, &rx_seq,
+                                            &rx_len, rx_req)) ==
+           WH_ERROR_NOTREADY) {
+        /* Each ack lets the client send the next fragment */
+        WH_TEST_ASSERT_RETURN(WH_ERROR_NOTREADY ==
+                              wh_CommClient_RecvResponse(client, NULL, NULL,
+                                                         NULL, NULL, NULL));
+        acks++;
+    }
+    WH_TEST_ASSERT_RETURN(ret == 0);
+    WH_TEST_ASSERT_RETURN(acks == (sizeof(whCommHeader) + FRAG_REQ_SIZE - 1) /
+                                      (FRAG_SIZE - sizeof(whCommFragHeader)));
+    WH_TEST_ASSERT_RETURN(kind == 1);
+    WH_TEST_ASSERT_RETURN(rx_seq == tx_seq);
+    WH_TEST_ASSERT_RETURN(rx_len == sizeof(tx_req));
+    WH_TEST_ASSERT_RETURN(0 == memcmp(rx_req, tx_req, sizeof(tx_req)));
+
+    /* A response larger than the transport buffer */
+    WH_TEST_RETURN_ON_FAIL(wh_CommServer_SendResponse(
+        server, magic, kind, rx_seq, sizeof(tx_resp), tx_resp));
+    acks = 0;
+    while ((ret = wh_CommClient_RecvResponse(client, &magic, &kind, &rx_seq,
+                                             &rx_len, rx_resp)) ==
+           WH_ERROR_NOTREADY) {
+        WH_TEST_ASSERT_RETURN(WH_ERROR_NOTREADY ==
+                              wh_CommServer_RecvRequest(server, NULL, NULL,
+                                                        NULL, NULL, NULL));
+        acks++;
+    }
+    WH_TEST_ASSERT_RETURN(ret == 0);
+    WH_TEST_ASSERT_RETURN(acks == (sizeof(whCommHeader) + FRAG_RESP_SIZE - 1) /
+                                      (FRAG_SIZE - sizeof(whCommFragHeader)));
+    WH_TEST_ASSERT_RETURN(rx_seq == tx_seq);
+    WH_TEST_ASSERT_RETURN(rx_len == sizeof(tx_resp));
+    WH_TEST_ASSERT_RETURN(0 == memcmp(rx_resp, tx_resp, sizeof(tx_resp)));
+
+    /* Both sides are idle once the last fragment has been delivered */
+    WH_TEST_ASSERT_RETURN(WH_ERROR_NOTREADY ==
+                          wh_CommServer_RecvRequest(server, NULL, NULL, NULL,
+                                                    NULL, NULL));
+
+    /* Small messages still take a single fragment each way */
+    WH_TEST_RETURN_ON_FAIL(wh_CommClient_SendRequest(
+        client, WH_COMM_MAGIC_NATIVE, 2, &tx_seq, 4, tx_req));
+    WH_TEST_RETURN_ON_FAIL(wh_CommServer_RecvRequest(server, &magic, &kind,
+                                                     &rx_seq, &rx_len, rx_req));
+    WH_TEST_ASSERT_RETURN(rx_len == 4);
+    WH_TEST_RETURN_ON_FAIL(
+        wh_CommServer_SendResponse(server, magic, kind, rx_seq, 0, NULL));
+    WH_TEST_RETURN_ON_FAIL(wh_CommClient_RecvResponse(client, NULL, NULL,
+                                                      &rx_seq, &rx_len, NULL));
+    WH_TEST_ASSERT_RETURN(rx_seq == tx_seq);
+    WH_TEST_ASSERT_RETURN(rx_len == 0);
+
+    /* Nothing would drive the later fragments of a NORESP request */
+    WH_TEST_ASSERT_RETURN(WH_ERROR_BADARGS ==
+                          wh_CommClient_SendRequestNoResp(
+                              client, WH_COMM_MAGIC_NATIVE, 3, &tx_seq,
+                              sizeof(tx_req), tx_req));
+
+    /* Only requests that fit in one fragment may be pipelined behind another,
+     * and only once the channel is not busy with a multi-fragment exchange */
+    WH_TEST_RETURN_ON_FAIL(wh_CommClient_CheckPipeline(client, 4));
+    WH_TEST_ASSERT_RETURN(WH_ERROR_NOTREADY ==
+                          wh_CommClient_CheckPipeline(client, FRAG_SIZE));
+    WH_TEST_RETURN_ON_FAIL(wh_CommClient_SendRequest(
+        client, WH_COMM_MAGIC_NATIVE, 4, &tx_seq, sizeof(tx_req), tx_req));
+    WH_TEST_ASSERT_RETURN(WH_ERROR_NOTREADY ==
+                          wh_CommClient_CheckPipeline(client, 4));
+    while ((ret = wh_CommServer_RecvRequest(server, &magic, &kind, &rx_seq,
+                                            &rx_len, rx_req)) ==
+           WH_ERROR_NOTREADY) {
+        WH_TEST_ASSERT_RETURN(WH_ERROR_NOTREADY ==
+                              wh_CommClient_RecvResponse(client, NULL, NULL,
+                                                         NULL, NULL, NULL));
+    }
+    WH_TEST_ASSERT_RETURN(ret == 0);
+    WH_TEST_RETURN_ON_FAIL(
+        wh_CommServer_SendResponse(server, magic, kind, rx_seq, 0, NULL));
+    WH_TEST_RETURN_ON_FAIL(wh_CommClient_RecvResponse(client, NULL, NULL,
+                                                      &rx_seq, &rx_len, NULL));
+    WH_TEST_RETURN_ON_FAIL(wh_CommClient_CheckPipeline(client, 4));
+
+    /* Requests beyond the internal buffer must be streamed */
+    WH_TEST_ASSERT_RETURN(
+        WH_ERROR_BADARGS ==
+        wh_CommClient_SendRequest(client, WH_COMM_MAGIC_NATIVE, 5, &tx_seq,
+                                  WOLFHSM_CFG_COMM_DATA_LEN + 1,
+                                  wh_CommClient_GetDataPtr(client)));
+
+#if WOLFHSM_CFG_COMM_FRAGMENT_DATA_LEN > WOLFHSM_CFG_COMM_DATA_LEN
+    {
+        static uint8_t tx_large[FRAG_LARGE_SIZE];
+        static uint8_t rx_large[FRAG_LARGE_SIZE];
+        /* Reassembly buffer for the server, with room for both headers */
+        static uint64_t frag_buffer[(sizeof(whCommFragHeader) +
+                                     sizeof(whCommHeader) + FRAG_LARGE_SIZE +
+                                     sizeof(uint64_t) - 1) /
+                                    sizeof(uint64_t)];
+        whCommIoVec iov[3]   = {{0}};
+        uint8_t     head[16] = {0};
+        uint16_t    split    = WOLFHSM_CFG_COMM_DATA_LEN / 2;
+
+        _fragTestFill(tx_large, FRAG_LARGE_SIZE, 3);
+        iov[0].data = tx_large;
+        iov[0].size = 16;
+        iov[1].data = tx_large + 16;
+        iov[1].size = split;
+        iov[2].data = tx_large + 16 + split;
+        iov[2].size = FRAG_LARGE_SIZE - 16 - split;
+
+        /* Streamed requests are limited to the reassembly size */
+        iov[2].size++;
+        WH_TEST_ASSERT_RETURN(WH_ERROR_BADARGS ==
+                              wh_CommClient_SendRequestV(
+                                  client, WH_COMM_MAGIC_NATIVE, 5, &tx_seq,
+                                  3, iov));
+        iov[2].size--;
+
+        /* A server without a reassembly buffer drains the request and
+         * refuses it */
+        WH_TEST_RETURN_ON_FAIL(wh_CommClient_SendRequestV(
+            client, WH_COMM_MAGIC_NATIVE, 5, &tx_seq, 3, iov));
+        while ((ret = wh_CommServer_RecvRequest(
+                    server, &magic, &kind, &rx_seq, &rx_len,
+                    wh_CommServer_GetDataPtr(server))) == WH_ERROR_NOTREADY) {
+            WH_TEST_ASSERT_RETURN(WH_ERROR_NOTREADY ==
+                                  wh_CommClient_RecvResponse(
+                                      client, NULL, NULL, NULL, NULL, NULL));
+        }
+        WH_TEST_ASSERT_RETURN(ret == WH_ERROR_ABORTED);
+
+        /* Restart both sides, with a reassembly buffer for the server */
+        WH_TEST_RETURN_ON_FAIL(wh_CommServer_Cleanup(server));
+        WH_TEST_RETURN_ON_FAIL(wh_CommClient_Cleanup(client));
+        s_conf->frag_buffer      = frag_buffer;
+        s_conf->frag_buffer_size = sizeof(whCommFragHeader) + WH_COMM_MTU - 1;
+        WH_TEST_ASSERT_RETURN(WH_ERROR_BADARGS ==
+                              wh_CommServer_Init(server, s_conf, NULL, NULL));
+        s_conf->frag_buffer_size = sizeof(frag_buffer);
+        WH_TEST_RETURN_ON_FAIL(wh_CommClient_Init(client, c_conf));
+        WH_TEST_RETURN_ON_FAIL(wh_CommServer_Init(server, s_conf, NULL, NULL));
+        WH_TEST_ASSERT_RETURN(wh_CommServer_GetMaxDataLen(server) ==
+                              WOLFHSM_CFG_COMM_FRAGMENT_DATA_LEN);
+
+        /* The part beyond the internal buffer is sent from the caller's
+         * buffers, and the server receives it in place */
+        WH_TEST_RETURN_ON_FAIL(wh_CommClient_SendRequestV(
+            client, WH_COMM_MAGIC_NATIVE, 5, &tx_seq, 3, iov));
+        while ((ret = wh_CommServer_RecvRequest(
+                    server, &magic, &kind, &rx_seq, &rx_len,
+                    wh_CommServer_GetDataPtr(server))) == WH_ERROR_NOTREADY) {
+            WH_TEST_ASSERT_RETURN(WH_ERROR_NOTREADY ==
+                                  wh_CommClient_RecvResponse(
+                                      client, NULL, NULL, NULL, NULL, NULL));
+        }
+        WH_TEST_ASSERT_RETURN(ret == 0);
+        WH_TEST_ASSERT_RETURN(kind == 5);
+        WH_TEST_ASSERT_RETURN(rx_seq == tx_seq);
+        WH_TEST_ASSERT_RETURN(rx_len == FRAG_LARGE_SIZE);
+        WH_TEST_RETURN_ON_FAIL(
+            _fragTestCheck(wh_CommServer_GetDataPtr(server), rx_len, 3));
+
+        /* A large response is scattered into the caller's buffers */
+        _fragTestFill(wh_CommServer_GetDataPtr(server), FRAG_LARGE_SIZE, 4);
+        WH_TEST_RETURN_ON_FAIL(wh_CommServer_SendResponse(
+            server, magic, kind, rx_seq, FRAG_LARGE_SIZE,
+            wh_CommServer_GetDataPtr(server)));
+        while ((ret = wh_CommClient_RecvResponseExt(
+                    client, &magic, &kind, &rx_seq, &rx_len, sizeof(head),
+                    head, sizeof(rx_large), rx_large)) == WH_ERROR_NOTREADY) {
+            WH_TEST_ASSERT_RETURN(WH_ERROR_NOTREADY ==
+                                  wh_CommServer_RecvRequest(
+                                      server, NULL, NULL, NULL, NULL, NULL));
+        }
+        WH_TEST_ASSERT_RETURN(ret == 0);
+        WH_TEST_ASSERT_RETURN(rx_seq == tx_seq);
+        WH_TEST_ASSERT_RETURN(rx_len == FRAG_LARGE_SIZE);
+        WH_TEST_RETURN_ON_FAIL(_fragTestCheck(head, sizeof(head), 4));
+        for (i = 0; i < FRAG_LARGE_SIZE - (int)sizeof(head); i++) {
+            WH_TEST_ASSERT_RETURN(
+                rx_large[i] ==
+                (uint8_t)((i + 16) + ((i + 16) >> 8) + 4));
+        }
+
+        /* A response larger than the caller's buffers is refused once it has
+         * been received */
+        WH_TEST_RETURN_ON_FAIL(wh_CommClient_SendRequest(
+            client, WH_COMM_MAGIC_NATIVE, 6, &tx_seq, 4, tx_req));
+        WH_TEST_RETURN_ON_FAIL(wh_CommServer_RecvRequest(
+            server, &magic, &kind, &rx_seq, &rx_len, NULL));
+        WH_TEST_RETURN_ON_FAIL(wh_CommServer_SendResponse(
+            server, magic, kind, rx_seq, FRAG_LARGE_SIZE,
+            wh_CommServer_GetDataPtr(server)));
+        while ((ret = wh_CommClient_RecvResponseExt(
+                    client, &magic, &kind, &rx_seq, &rx_len, sizeof(head),
+                    head, sizeof(rx_large) - sizeof(head) - 1, rx_large)) ==
+               WH_ERROR_NOTREADY) {
+            WH_TEST_ASSERT_RETURN(WH_ERROR_NOTREADY ==
+                                  wh_CommServer_RecvRequest(
+                                      server, NULL, NULL, NULL, NULL, NULL));
+        }
+        WH_TEST_ASSERT_RETURN(ret == WH_ERROR_ABORTED);
+
+        /* The channel is still usable */
+        WH_TEST_RETURN_ON_FAIL(wh_CommClient_SendRequest(
+            client, WH_COMM_MAGIC_NATIVE, 7, &tx_seq, 4, tx_req));
+        WH_TEST_RETURN_ON_FAIL(wh_CommServer_RecvRequest(
+            server, &magic, &kind, &rx_seq, &rx_len, rx_req));
+        WH_TEST_ASSERT_RETURN(kind == 7);
+        WH_TEST_RETURN_ON_FAIL(
+            wh_CommServer_SendResponse(server, magic, kind, rx_seq, 0, NULL));
+        WH_TEST_RETURN_ON_FAIL(wh_CommClient_RecvResponse(
+            client, NULL, NULL, &rx_seq, &rx_len, NULL));
+        WH_TEST_ASSERT_RETURN(rx_seq == tx_seq);
+    }
+#endif
+
+    WH_TEST_RETURN_ON_FAIL(wh_CommServer_Cleanup(server));
+    WH_TEST_RETURN_ON_FAIL(wh_CommClient_Cleanup(client));
+
+#ifdef WOLFHSM_CFG_COMM_SESSIONS
+    WH_TEST_RETURN_ON_FAIL(_whTestCommFragmentSessions());
+#endif
+    return 0;
+}
+#endif /* WOLFHSM_CFG_COMM_FRAGMENT */
+
+int whTest_CommMemRing(void)
+{
+    int ret = 0;
+    int i   = 0;
+
+    /* Transport memory configuration */
+    uint8_t                  req[BUFFER_SIZE]  = {0};
+    uint8_t                  resp[BUFFER_SIZE] = {0};
+    whTransportMemRingConfig tmcf[1]           = {{
+                  .req        = req,
+                  .req_size   = sizeof(req),
+                  .resp       = resp,
+                  .resp_size  = sizeof(resp),
+                  .slot_count = RING_SLOT_COUNT,
+    }};
+
+    /* Client configuration/contexts */
+    whTransportClientCb             tccb[1]   = {WH_TRANSPORT_MEM_RING_CLIENT_CB};
+    whTransportMemRingClientContext tmcc[1]   = {0};
+    whCommClientConfig              c_conf[1] = {{
+                     .transport_cb      = tccb,
+                     .transport_context = (void*)tmcc,
+                     .transport_config  = (void*)tmcf,
+                     .client_id         = WH_TEST_DEFAULT_CLIENT_ID,
+    }};
+    whCommClient                    client[1] = {0};
+
+    /* Server configuration/contexts */
+    whTransportServerCb             tscb[1]   = {WH_TRANSPORT_MEM_RING_SERVER_CB};
+    whTransportMemRingServerContext tmsc[1]   = {0};
+    whCommServerConfig              s_conf[1] = {{
+                     .transport_cb      = tscb,
+                     .transport_context = (void*)tmsc,
+                     .transport_config  = (void*)tmcf,
+                     .server_id         = 124,
+    }};
+    whCommServer                    server[1] = {0};
+
+    uint8_t  tx_req[REQ_SIZE] = {0};
+    uint16_t tx_req_len       = 0;
+    uint16_t tx_req_seq[RING_SLOT_COUNT] = {0};
+
+    uint8_t  rx_req[REQ_SIZE] = {0};
+    uint16_t rx_req_len       = 0;
+    uint16_t rx_req_flags     = 0;
+    uint16_t rx_req_type      = 0;
+    uint16_t rx_req_seq       = 0;
+
+    uint8_t  tx_resp[RESP_SIZE] = {0};
+    uint16_t tx_resp_len        = 0;
+
+    uint8_t  rx_resp[RESP_SIZE] = {0};
+    uint16_t rx_resp_len        = 0;
+    uint16_t rx_resp_flags      = 0;
+    uint16_t rx_resp_type       = 0;
+    uint16_t rx_resp_seq        = 0;
+
+    /* Slot count must be non-zero and each slot must fit a CSR */
+    tmcf->slot_count = 0;
+    WH_TEST_ASSERT_RETURN(WH_ERROR_BADARGS ==
+                          wh_TransportMemRing_Init(tmsc, tmcf, NULL, NULL));
+    tmcf->slot_count = sizeof(req);
+    WH_TEST_ASSERT_RETURN(WH_ERROR_BADARGS ==
+                          wh_TransportMemRing_Init(tmsc, tmcf, NULL, NULL));
+    tmcf->slot_count = RING_SLOT_COUNT;
+
+    WH_TEST_RETURN_ON_FAIL(wh_CommClient_Init(client, c_conf));
+    WH_TEST_RETURN_ON_FAIL(wh_CommServer_Init(server, s_conf, NULL, NULL));
+
+    /* Nothing outstanding on either side */
+    WH_TEST_ASSERT_RETURN(WH_ERROR_NOTREADY ==
+                          wh_CommServer_RecvRequest(server, &rx_req_flags,
+                                                    &rx_req_type, &rx_req_seq,
+                                                    &rx_req_len, rx_req));
+    WH_TEST_ASSERT_RETURN(WH_ERROR_NOTREADY ==
+                          wh_CommClient_RecvResponse(
+                              client, &rx_resp_flags, &rx_resp_type,
+                              &rx_resp_seq, &rx_resp_len, rx_resp));
+
+    /* Fill every slot before the server handles anything */
+    for (i = 0; i < RING_SLOT_COUNT; i++) {
+        (void)snprintf((char*)tx_req, sizeof(tx_req), "Request:%u", i);
+        tx_req_len = strlen((char*)tx_req);
+        WH_TEST_RETURN_ON_FAIL(wh_CommClient_SendRequest(
+            client, WH_COMM_MAGIC_NATIVE, i, &tx_req_seq[i], tx_req_len,
+            tx_req));
+    }
+
+    /* All slots are in flight */
+    WH_TEST_ASSERT_RETURN(WH_ERROR_NOTREADY ==
+                          wh_CommClient_SendRequest(client,
+                                                    WH_COMM_MAGIC_NATIVE, 0,
+                                                    NULL, tx_req_len, tx_req));
+
+    /* Responding with no request received is an error */
+    WH_TEST_ASSERT_RETURN(WH_ERROR_BADARGS ==
+                          wh_CommServer_SendResponse(server,
+                                                     WH_COMM_MAGIC_NATIVE, 0, 0,
+                                                     0, NULL));
+
+    /* Server drains all the requests in order before responding */
+    for (i = 0; i < RING_SLOT_COUNT; i++) {
+        WH_TEST_RETURN_ON_FAIL(
+            wh_CommServer_RecvRequest(server, &rx_req_flags, &rx_req_type,
+                                      &rx_req_seq, &rx_req_len, rx_req));
+        WH_TEST_ASSERT_RETURN(rx_req_type == i);
+        WH_TEST_ASSERT_RETURN(rx_req_seq == tx_req_seq[i]);
+    }
+    WH_TEST_ASSERT_RETURN(WH_ERROR_NOTREADY ==
+                          wh_CommServer_RecvRequest(server, &rx_req_flags,
+                                                    &rx_req_type, &rx_req_seq,
+                                                    &rx_req_len, rx_req));
+
+    /* Answer the first request only and check the client gets just that */
+    (void)snprintf((char*)tx_resp, sizeof(tx_resp), "Response:%u", 0);
+    tx_resp_len = strlen((char*)tx_resp);
+    WH_TEST_RETURN_ON_FAIL(wh_CommServer_SendResponse(
+        server, WH_COMM_MAGIC_NATIVE, 0, tx_req_seq[0], tx_resp_len, tx_resp));
+    WH_TEST_RETURN_ON_FAIL(
+        wh_CommClient_RecvResponse(client, &rx_resp_flags, &rx_resp_type,
+                                   &rx_resp_seq, &rx_resp_len, rx_resp));
+    WH_TEST_ASSERT_RETURN(rx_resp_seq == tx_req_seq[0]);
+    WH_TEST_ASSERT_RETURN(rx_resp_len == tx_resp_len);
+    WH_TEST_ASSERT_RETURN(0 == memcmp(rx_resp, tx_resp, tx_resp_len));
+    WH_TEST_ASSERT_RETURN(WH_ERROR_NOTREADY ==
+                          wh_CommClient_RecvResponse(
+                              client, &rx_resp_flags, &rx_resp_type,
+                              &rx_resp_seq, &rx_resp_len, rx_resp));
+
+    /* Freed slot can be reused while the others are still pending */
+    WH_TEST_RETURN_ON_FAIL(wh_CommClient_SendRequest(
+        client, WH_COMM_MAGIC_NATIVE, RING_SLOT_COUNT, &tx_req_seq[0],
+        tx_req_len, tx_req));
+
+    /* Answer the rest, including the wrapped request */
+    for (i = 1; i <= RING_SLOT_COUNT; i++) {
+        uint16_t seq = tx_req_seq[i % RING_SLOT_COUNT];
+        if (i == RING_SLOT_COUNT) {
+            WH_TEST_RETURN_ON_FAIL(
+                wh_CommServer_RecvRequest(server, &rx_req_flags, &rx_req_type,
+                                          &rx_req_seq, &rx_req_len, rx_req));
+            WH_TEST_ASSERT_RETURN(rx_req_seq == seq);
+        }
+        (void)snprintf((char*)tx_resp, sizeof(tx_resp), "Response:%u", i);
+        tx_resp_len = strlen((char*)tx_resp);
+        WH_TEST_RETURN_ON_FAIL(
+            wh_CommServer_SendResponse(server, WH_COMM_MAGIC_NATIVE, i, seq,
+                                       tx_resp_len, tx_resp));
+    }
+    for (i = 1; i <= RING_SLOT_COUNT; i++) {
+        uint16_t seq = tx_req_seq[i % RING_SLOT_COUNT];
+        (void)snprintf((char*)tx_resp, sizeof(tx_resp), "Response:%u", i);
+        tx_resp_len = strlen((char*)tx_resp);
+        WH_TEST_RETURN_ON_FAIL(
+            wh_CommClient_RecvResponse(client, &rx_resp_flags, &rx_resp_type,
+                                       &rx_resp_seq, &rx_resp_len, rx_resp));
+        WH_TEST_ASSERT_RETURN(rx_resp_type == i);
+        WH_TEST_ASSERT_RETURN(rx_resp_seq == seq);
+        WH_TEST_ASSERT_RETURN(rx_resp_len == tx_resp_len);
+        WH_TEST_ASSERT_RETURN(0 == memcmp(rx_resp, tx_resp, tx_resp_len));
+    }
+
     WH_TEST_RETURN_ON_FAIL(wh_CommServer_Cleanup(server));
     WH_TEST_RETURN_ON_FAIL(wh_CommClient_Cleanup(client));
 
@@ -191,6 +1038,871 @@ int whTest_CommMem(void)
 
 #if defined(WOLFHSM_CFG_TEST_POSIX) && defined(WOLFHSM_CFG_ENABLE_CLIENT) && \
     defined(WOLFHSM_CFG_ENABLE_SERVER)
+int whTest_CommShmWait(void)
+{
+    int ret = 0;
+
+    /* Transport memory configuration */
+    posixTransportShmConfig tmcf[1] = {{
+        .name      = "/wh_test_comm_shm_wait",
+        .req_size  = BUFFER_SIZE,
+        .resp_size = BUFFER_SIZE,
+    }};
+
+    /* Client configuration/contexts */
+    whTransportClientCb            tccb[1]   = {POSIX_TRANSPORT_SHM_CLIENT_CB};
+    posixTransportShmClientContext tmcc[1]   = {0};
+    whCommClientConfig             c_conf[1] = {{
+                    .transport_cb      = tccb,
+                    .transport_context = (void*)tmcc,
+                    .transport_config  = (void*)tmcf,
+                    .client_id         = WH_TEST_DEFAULT_CLIENT_ID,
+    }};
+    whCommClient                   client[1] = {0};
+
+    /* Server configuration/contexts */
+    whTransportServerCb            tscb[1]   = {POSIX_TRANSPORT_SHM_SERVER_CB};
+    posixTransportShmServerContext tmsc[1]   = {0};
+    whCommServerConfig             s_conf[1] = {{
+                    .transport_cb      = tscb,
+                    .transport_context = (void*)tmsc,
+                    .transport_config  = (void*)tmcf,
+                    .server_id         = 124,
+    }};
+    whCommServer                   server[1] = {0};
+
+    char     uniq_name[32]    = {0};
+    uint8_t  tx_req[REQ_SIZE] = {0};
+    uint16_t tx_req_len       = 0;
+    uint16_t tx_req_seq       = 0;
+    uint8_t  rx_req[REQ_SIZE] = {0};
+    uint16_t rx_req_len       = 0;
+
+    /* Make unique name for this test */
+    snprintf(uniq_name, sizeof(uniq_name), "/wh_test_comm_wait.%u",
+             (unsigned)getpid());
+    tmcf->name = uniq_name;
+
+    WH_TEST_RETURN_ON_FAIL(wh_CommServer_Init(server, s_conf, NULL, NULL));
+
+    /* Nothing has happened yet, so the wait times out */
+    WH_TEST_ASSERT_RETURN(WH_ERROR_TIMEOUT ==
+                          wh_CommServer_WaitRequest(server, 1000));
+
+    /* Client connecting rings the doorbell */
+    WH_TEST_RETURN_ON_FAIL(wh_CommClient_Init(client, c_conf));
+    WH_TEST_RETURN_ON_FAIL(wh_CommServer_WaitRequest(server, 1000));
+    WH_TEST_ASSERT_RETURN(WH_ERROR_NOTREADY ==
+                          wh_CommServer_RecvRequest(server, NULL, NULL, NULL,
+                                                    &rx_req_len, rx_req));
+    WH_TEST_ASSERT_RETURN(WH_ERROR_TIMEOUT ==
+                          wh_CommServer_WaitRequest(server, 1000));
+
+    /* A request wakes the server exactly once */
+    (void)snprintf((char*)tx_req, sizeof(tx_req), "Wait request");
+    tx_req_len = strlen((char*)tx_req);
+    WH_TEST_RETURN_ON_FAIL(wh_CommClient_SendRequest(
+        client, WH_COMM_MAGIC_NATIVE, 0, &tx_req_seq, tx_req_len, tx_req));
+    WH_TEST_RETURN_ON_FAIL(wh_CommServer_WaitRequest(server, 0));
+    WH_TEST_RETURN_ON_FAIL(wh_CommServer_RecvRequest(server, NULL, NULL, NULL,
+                                                     &rx_req_len, rx_req));
+    WH_TEST_ASSERT_RETURN(rx_req_len == tx_req_len);
+    WH_TEST_ASSERT_RETURN(0 == memcmp(rx_req, tx_req, tx_req_len));
+    WH_TEST_ASSERT_RETURN(WH_ERROR_TIMEOUT ==
+                          wh_CommServer_WaitRequest(server, 1000));
+
+    WH_TEST_RETURN_ON_FAIL(wh_CommClient_Cleanup(client));
+    WH_TEST_RETURN_ON_FAIL(wh_CommServer_Cleanup(server));
+
+    return ret;
+}
+
+#define NORESP_TEST_PORT 23459
+
+int whTest_CommTcpNoResp(void)
+{
+    int ret = 0;
+    int i   = 0;
+
+    posixTransportTcpConfig tcf[1] = {{
+        .server_ip_string = "127.0.0.1",
+        .server_port      = NORESP_TEST_PORT,
+    }};
+
+    /* Client configuration/contexts */
+    whTransportClientCb            tccb[1]   = {PTT_CLIENT_CB};
+    posixTransportTcpClientContext tcc[1]    = {0};
+    whCommClientConfig             c_conf[1] = {{
+                    .transport_cb      = tccb,
+                    .transport_context = (void*)tcc,
+                    .transport_config  = (void*)tcf,
+                    .client_id         = WH_TEST_DEFAULT_CLIENT_ID,
+    }};
+    whCommClient                   client[1] = {0};
+
+    /* Server configuration/contexts */
+    whTransportServerCb            tscb[1]   = {PTT_SERVER_CB};
+    posixTransportTcpServerContext tsc[1]    = {0};
+    whCommServerConfig             s_conf[1] = {{
+                    .transport_cb      = tscb,
+                    .transport_context = (void*)tsc,
+                    .transport_config  = (void*)tcf,
+                    .server_id         = 0xF,
+    }};
+    whCommServer                   server[1] = {0};
+
+    uint8_t  tx_req[REQ_SIZE]   = {0};
+    uint16_t tx_req_len         = 0;
+    uint16_t tx_req_seq         = 0;
+    uint8_t  rx_req[REQ_SIZE]   = {0};
+    uint16_t rx_req_len         = 0;
+    uint16_t rx_req_flags       = 0;
+    uint16_t rx_req_type        = 0;
+    uint16_t rx_req_seq         = 0;
+    uint16_t rx_req_aux         = 0;
+    uint8_t  rx_resp[RESP_SIZE] = {0};
+    uint16_t rx_resp_len        = 0;
+
+    WH_TEST_RETURN_ON_FAIL(wh_CommServer_Init(server, s_conf, NULL, NULL));
+    WH_TEST_RETURN_ON_FAIL(wh_CommClient_Init(client, c_conf));
+
+    /* Several requests without response in a row, then a normal one. Neither
+     * side may wait for the responses that never come */
+    for (i = 0; i < 4; i++) {
+        (void)snprintf((char*)tx_req, sizeof(tx_req), "NoResp:%d", i);
+        tx_req_len = strlen((char*)tx_req);
+        do {
+            if (i < 3) {
+                ret = wh_CommClient_SendRequestNoResp(
+                    client, WH_COMM_MAGIC_NATIVE, i, &tx_req_seq, tx_req_len,
+                    tx_req);
+            }
+            else {
+                ret = wh_CommClient_SendRequest(client, WH_COMM_MAGIC_NATIVE,
+                                                i, &tx_req_seq, tx_req_len,
+                                                tx_req);
+            }
+            if (ret == WH_ERROR_NOTREADY) {
+                /* Accept the connection */
+                (void)wh_CommServer_RecvRequest(server, NULL, NULL, NULL,
+                                                &rx_req_len, rx_req);
+            }
+        } while ((ret == WH_ERROR_NOTREADY) &&
+                 (nanosleep(&ONE_MS, NULL) == 0));
+        WH_TEST_ASSERT_RETURN(ret == 0);
+
+        do {
+            ret = wh_CommServer_RecvRequest(server, &rx_req_flags,
+                                            &rx_req_type, &rx_req_seq,
+                                            &rx_req_len, rx_req);
+        } while ((ret == WH_ERROR_NOTREADY) &&
+                 (nanosleep(&ONE_MS, NULL) == 0));
+        WH_TEST_ASSERT_RETURN(ret == 0);
+        WH_TEST_ASSERT_RETURN(rx_req_type == i);
+        WH_TEST_ASSERT_RETURN(rx_req_seq == tx_req_seq);
+        WH_TEST_ASSERT_RETURN(rx_req_len == tx_req_len);
+        WH_TEST_ASSERT_RETURN(0 == memcmp(rx_req, tx_req, tx_req_len));
+
+        if (i < 3) {
+            WH_TEST_RETURN_ON_FAIL(
+                wh_CommServer_GetRequestAux(server, &rx_req_aux));
+            WH_TEST_ASSERT_RETURN(rx_req_aux == WH_COMM_AUX_REQ_NORESP);
+            WH_TEST_RETURN_ON_FAIL(wh_CommServer_CompleteRequest(server));
+            /* Nothing is waiting for the client */
+            WH_TEST_ASSERT_RETURN(WH_ERROR_NOTREADY ==
+                                  wh_CommClient_RecvResponse(
+                                      client, NULL, NULL, NULL, &rx_resp_len,
+                                      rx_resp));
+        }
+    }
+
+    WH_TEST_RETURN_ON_FAIL(wh_CommServer_SendResponse(
+        server, rx_req_flags, rx_req_type, rx_req_seq, rx_req_len, rx_req));
+    do {
+        ret = wh_CommClient_RecvResponse(client, NULL, NULL, NULL,
+                                         &rx_resp_len, rx_resp);
+    } while ((ret == WH_ERROR_NOTREADY) && (nanosleep(&ONE_MS, NULL) == 0));
+    WH_TEST_ASSERT_RETURN(ret == 0);
+    WH_TEST_ASSERT_RETURN(rx_resp_len == tx_req_len);
+    WH_TEST_ASSERT_RETURN(0 == memcmp(rx_resp, tx_req, tx_req_len));
+
+    WH_TEST_RETURN_ON_FAIL(wh_CommClient_Cleanup(client));
+    WH_TEST_RETURN_ON_FAIL(wh_CommServer_Cleanup(server));
+
+    return 0;
+}
+
+#if defined(__linux__)
+#define MUX_CLIENT_COUNT 3
+#define MUX_TEST_PORT 23457
+
+int whTest_CommTcpMux(void)
+{
+    int ret = 0;
+    int i   = 0;
+    int j   = 0;
+
+    posixTransportTcpConfig tcf[1] = {{
+        .server_ip_string = "127.0.0.1",
+        .server_port      = MUX_TEST_PORT,
+    }};
+
+    /* Client configuration/contexts. One more client than server slots */
+    whTransportClientCb            tccb[1] = {PTT_CLIENT_CB};
+    posixTransportTcpClientContext tcc[MUX_CLIENT_COUNT + 1];
+    whCommClientConfig             c_conf[MUX_CLIENT_COUNT + 1];
+    whCommClient                   client[MUX_CLIENT_COUNT + 1];
+
+    /* Server configuration/contexts, one per slot */
+    posixTransportTcpMuxContext       mux[1] = {0};
+    whTransportServerCb               tscb[1] = {PTT_MUX_SERVER_CB};
+    posixTransportTcpMuxServerContext tsc[MUX_CLIENT_COUNT];
+    posixTransportTcpMuxServerConfig  ts_conf[MUX_CLIENT_COUNT];
+    whCommServerConfig                s_conf[MUX_CLIENT_COUNT];
+    whCommServer                      server[MUX_CLIENT_COUNT];
+
+    uint8_t  tx_req[REQ_SIZE]   = {0};
+    uint16_t tx_req_len         = 0;
+    uint16_t tx_req_seq         = 0;
+    uint8_t  rx_req[REQ_SIZE]   = {0};
+    uint16_t rx_req_len         = 0;
+    uint16_t rx_req_flags       = 0;
+    uint16_t rx_req_type        = 0;
+    uint16_t rx_req_seq         = 0;
+    uint8_t  rx_resp[RESP_SIZE] = {0};
+    uint16_t rx_resp_len        = 0;
+    uint16_t rx_resp_type       = 0;
+
+    uint16_t ready[MUX_CLIENT_COUNT];
+    uint16_t ready_count                = 0;
+    int      sent[MUX_CLIENT_COUNT + 1] = {0};
+    int      served                     = 0;
+    int      served_by[MUX_CLIENT_COUNT] = {0};
+    int           spare_fd = -1;
+    struct rlimit fd_limit;
+    struct rlimit low_limit;
+
+    memset(tcc, 0, sizeof(tcc));
+    memset(c_conf, 0, sizeof(c_conf));
+    memset(client, 0, sizeof(client));
+    memset(tsc, 0, sizeof(tsc));
+    memset(ts_conf, 0, sizeof(ts_conf));
+    memset(s_conf, 0, sizeof(s_conf));
+    memset(server, 0, sizeof(server));
+
+    WH_TEST_RETURN_ON_FAIL(posixTransportTcpMux_Init(mux, tcf));
+    for (i = 0; i < MUX_CLIENT_COUNT; i++) {
+        ts_conf[i].mux               = mux;
+        ts_conf[i].index             = i;
+        s_conf[i].transport_cb       = tscb;
+        s_conf[i].transport_context  = (void*)&tsc[i];
+        s_conf[i].transport_config   = (void*)&ts_conf[i];
+        s_conf[i].server_id          = 0xF;
+        WH_TEST_RETURN_ON_FAIL(
+            wh_CommServer_Init(&server[i], &s_conf[i], NULL, NULL));
+        /* No client bound to the slot yet */
+        WH_TEST_ASSERT_RETURN(WH_ERROR_NOTREADY ==
+                              wh_CommServer_RecvRequest(&server[i], NULL, NULL,
+                                                        NULL, &rx_req_len,
+                                                        rx_req));
+    }
+    /* A slot can only be owned by one context */
+    WH_TEST_ASSERT_RETURN(WH_ERROR_BADARGS ==
+                          posixTransportTcpMux_InitServer(&tsc[1], &ts_conf[0],
+                                                          NULL, NULL));
+
+    for (i = 0; i <= MUX_CLIENT_COUNT; i++) {
+        c_conf[i].transport_cb      = tccb;
+        c_conf[i].transport_context = (void*)&tcc[i];
+        c_conf[i].transport_config  = (void*)tcf;
+        c_conf[i].client_id         = WH_TEST_DEFAULT_CLIENT_ID + i;
+        WH_TEST_RETURN_ON_FAIL(wh_CommClient_Init(&client[i], &c_conf[i]));
+    }
+
+    /* Each client sends one request once connected. The type encodes the
+     * client so the server side can check which connection it came from */
+    for (j = 0; (j < 1000) && (served < MUX_CLIENT_COUNT); j++) {
+        for (i = 0; i < MUX_CLIENT_COUNT; i++) {
+            if (sent[i] == 0) {
+                (void)snprintf((char*)tx_req, sizeof(tx_req), "Mux:%d", i);
+                tx_req_len = strlen((char*)tx_req);
+                ret = wh_CommClient_SendRequest(&client[i],
+                                                WH_COMM_MAGIC_NATIVE, i,
+                                                &tx_req_seq, tx_req_len,
+                                                tx_req);
+                WH_TEST_ASSERT_RETURN((ret == 0) ||
+                                      (ret == WH_ERROR_NOTREADY));
+                sent[i] = (ret == 0);
+            }
+        }
+
+        ready_count = MUX_CLIENT_COUNT;
+        WH_TEST_RETURN_ON_FAIL(
+            posixTransportTcpMux_Poll(mux, 10, ready, &ready_count));
+        for (i = 0; i < ready_count; i++) {
+            ret = wh_CommServer_RecvRequest(&server[ready[i]], &rx_req_flags,
+                                            &rx_req_type, &rx_req_seq,
+                                            &rx_req_len, rx_req);
+            if (ret == WH_ERROR_NOTREADY) {
+                continue;
+            }
+            WH_TEST_ASSERT_RETURN(ret == 0);
+            WH_TEST_ASSERT_RETURN(rx_req_type < MUX_CLIENT_COUNT);
+            served_by[rx_req_type]++;
+            served++;
+            WH_TEST_RETURN_ON_FAIL(wh_CommServer_SendResponse(
+                &server[ready[i]], rx_req_flags, rx_req_type, rx_req_seq,
+                rx_req_len, rx_req));
+        }
+    }
+    WH_TEST_ASSERT_RETURN(served == MUX_CLIENT_COUNT);
+
+    /* Every client was served exactly once and gets its own response back */
+    for (i = 0; i < MUX_CLIENT_COUNT; i++) {
+        WH_TEST_ASSERT_RETURN(served_by[i] == 1);
+        (void)snprintf((char*)tx_req, sizeof(tx_req), "Mux:%d", i);
+        tx_req_len = strlen((char*)tx_req);
+        do {
+            ret = wh_CommClient_RecvResponse(&client[i], NULL, &rx_resp_type,
+                                             NULL, &rx_resp_len, rx_resp);
+        } while ((ret == WH_ERROR_NOTREADY) &&
+                 (nanosleep(&ONE_MS, NULL) == 0));
+        WH_TEST_ASSERT_RETURN(ret == 0);
+        WH_TEST_ASSERT_RETURN(rx_resp_type == i);
+        WH_TEST_ASSERT_RETURN(rx_resp_len == tx_req_len);
+        WH_TEST_ASSERT_RETURN(0 == memcmp(rx_resp, tx_req, tx_req_len));
+    }
+
+    /* A request without response must not block the slot, so the request
+     * that follows it is still served */
+    (void)snprintf((char*)tx_req, sizeof(tx_req), "NoResp");
+    tx_req_len = strlen((char*)tx_req);
+    WH_TEST_RETURN_ON_FAIL(wh_CommClient_SendRequestNoResp(
+        &client[1], WH_COMM_MAGIC_NATIVE, MUX_CLIENT_COUNT, &tx_req_seq,
+        tx_req_len, tx_req));
+    WH_TEST_RETURN_ON_FAIL(wh_CommClient_SendRequest(
+        &client[1], WH_COMM_MAGIC_NATIVE, 1, &tx_req_seq, tx_req_len, tx_req));
+    served = 0;
+    for (j = 0; (j < 1000) && (served < 2); j++) {
+        ready_count = MUX_CLIENT_COUNT;
+        WH_TEST_RETURN_ON_FAIL(
+            posixTransportTcpMux_Poll(mux, 10, ready, &ready_count));
+        for (i = 0; i < ready_count; i++) {
+            WH_TEST_ASSERT_RETURN(ready[i] == 1);
+            ret = wh_CommServer_RecvRequest(&server[1], &rx_req_flags,
+                                            &rx_req_type, &rx_req_seq,
+                                            &rx_req_len, rx_req);
+            if (ret == WH_ERROR_NOTREADY) {
+                continue;
+            }
+            WH_TEST_ASSERT_RETURN(ret == 0);
+            if (served == 0) {
+                WH_TEST_ASSERT_RETURN(rx_req_type == MUX_CLIENT_COUNT);
+                WH_TEST_RETURN_ON_FAIL(
+                    wh_CommServer_CompleteRequest(&server[1]));
+            }
+            else {
+                WH_TEST_ASSERT_RETURN(rx_req_type == 1);
+                WH_TEST_RETURN_ON_FAIL(wh_CommServer_SendResponse(
+                    &server[1], rx_req_flags, rx_req_type, rx_req_seq,
+                    rx_req_len, rx_req));
+            }
+            served++;
+        }
+    }
+    WH_TEST_ASSERT_RETURN(served == 2);
+    do {
+        ret = wh_CommClient_RecvResponse(&client[1], NULL, &rx_resp_type,
+                                         NULL, &rx_resp_len, rx_resp);
+    } while ((ret == WH_ERROR_NOTREADY) && (nanosleep(&ONE_MS, NULL) == 0));
+    WH_TEST_ASSERT_RETURN(ret == 0);
+    WH_TEST_ASSERT_RETURN(rx_resp_type == 1);
+    WH_TEST_ASSERT_RETURN(rx_resp_len == tx_req_len);
+
+    /* The extra client was refused as all slots are in use */
+    (void)snprintf((char*)tx_req, sizeof(tx_req), "Refused");
+    tx_req_len = strlen((char*)tx_req);
+    for (j = 0; j < 100; j++) {
+        ret = wh_CommClient_SendRequest(&client[MUX_CLIENT_COUNT],
+                                        WH_COMM_MAGIC_NATIVE, 0, &tx_req_seq,
+                                        tx_req_len, tx_req);
+        ready_count = MUX_CLIENT_COUNT;
+        WH_TEST_RETURN_ON_FAIL(
+            posixTransportTcpMux_Poll(mux, 1, ready, &ready_count));
+        WH_TEST_ASSERT_RETURN(ready_count == 0);
+        if ((ret != 0) && (ret != WH_ERROR_NOTREADY)) {
+            break;
+        }
+    }
+    (void)wh_CommClient_Cleanup(&client[MUX_CLIENT_COUNT]);
+
+    /* A disconnect frees the slot for the next client */
+    WH_TEST_RETURN_ON_FAIL(wh_CommClient_Cleanup(&client[0]));
+    for (j = 0; (j < 100) && (tsc[0].accept_fd_p1 != 0); j++) {
+        ready_count = MUX_CLIENT_COUNT;
+        WH_TEST_RETURN_ON_FAIL(
+            posixTransportTcpMux_Poll(mux, 10, ready, &ready_count));
+    }
+    WH_TEST_ASSERT_RETURN(tsc[0].accept_fd_p1 == 0);
+
+    /* Running out of descriptors only delays accepting. The new client is
+     * left queued while the open connections are still served */
+    WH_TEST_RETURN_ON_FAIL(wh_CommClient_Init(&client[0], &c_conf[0]));
+    (void)snprintf((char*)tx_req, sizeof(tx_req), "Queued");
+    tx_req_len = strlen((char*)tx_req);
+    do {
+        ret = wh_CommClient_SendRequest(&client[0], WH_COMM_MAGIC_NATIVE, 0,
+                                        &tx_req_seq, tx_req_len, tx_req);
+    } while ((ret == WH_ERROR_NOTREADY) && (nanosleep(&ONE_MS, NULL) == 0));
+    WH_TEST_ASSERT_RETURN(ret == 0);
+    spare_fd = dup(0);
+    WH_TEST_ASSERT_RETURN(spare_fd >= 0);
+    WH_TEST_ASSERT_RETURN(0 == getrlimit(RLIMIT_NOFILE, &fd_limit));
+    low_limit.rlim_cur = spare_fd + 1;
+    low_limit.rlim_max = fd_limit.rlim_max;
+    WH_TEST_ASSERT_RETURN(0 == setrlimit(RLIMIT_NOFILE, &low_limit));
+    ready_count = MUX_CLIENT_COUNT;
+    ret = posixTransportTcpMux_Poll(mux, 10, ready, &ready_count);
+    WH_TEST_ASSERT_RETURN(0 == setrlimit(RLIMIT_NOFILE, &fd_limit));
+    WH_TEST_ASSERT_RETURN(ret == 0);
+    WH_TEST_ASSERT_RETURN(mux->accept_paused != 0);
+    WH_TEST_ASSERT_RETURN(tsc[0].accept_fd_p1 == 0);
+    WH_TEST_RETURN_ON_FAIL(wh_CommClient_SendRequestNoResp(
+        &client[2], WH_COMM_MAGIC_NATIVE, 2, &tx_req_seq, tx_req_len, tx_req));
+    served = 0;
+    for (j = 0; (j < 100) && (served == 0); j++) {
+        ready_count = MUX_CLIENT_COUNT;
+        WH_TEST_RETURN_ON_FAIL(
+            posixTransportTcpMux_Poll(mux, 10, ready, &ready_count));
+        for (i = 0; i < ready_count; i++) {
+            WH_TEST_ASSERT_RETURN(ready[i] == 2);
+            ret = wh_CommServer_RecvRequest(&server[2], &rx_req_flags,
+                                            &rx_req_type, &rx_req_seq,
+                                            &rx_req_len, rx_req);
+            if (ret == 0) {
+                WH_TEST_RETURN_ON_FAIL(
+                    wh_CommServer_CompleteRequest(&server[2]));
+                served++;
+            }
+        }
+    }
+    WH_TEST_ASSERT_RETURN(served == 1);
+    close(spare_fd);
+
+    /* Accepting resumes after the retry time */
+    for (j = 0; (j < 100) && (tsc[0].accept_fd_p1 == 0); j++) {
+        ready_count = MUX_CLIENT_COUNT;
+        WH_TEST_RETURN_ON_FAIL(
+            posixTransportTcpMux_Poll(mux, 10, ready, &ready_count));
+    }
+    WH_TEST_ASSERT_RETURN(tsc[0].accept_fd_p1 != 0);
+    WH_TEST_ASSERT_RETURN(mux->accept_paused == 0);
+    WH_TEST_RETURN_ON_FAIL(wh_CommClient_Cleanup(&client[0]));
+
+    for (i = 1; i < MUX_CLIENT_COUNT; i++) {
+        WH_TEST_RETURN_ON_FAIL(wh_CommClient_Cleanup(&client[i]));
+    }
+    for (i = 0; i < MUX_CLIENT_COUNT; i++) {
+        WH_TEST_RETURN_ON_FAIL(wh_CommServer_Cleanup(&server[i]));
+    }
+    WH_TEST_RETURN_ON_FAIL(posixTransportTcpMux_Cleanup(mux));
+
+    return 0;
+}
+
+#if defined(PTT_URING_SUPPORTED)
+#define URING_CLIENT_COUNT 3
+#define URING_TEST_PORT 23458
+
+/* Poll the ring, serving every reported slot by echoing the request. Requests
+ * with a type of URING_NORESP_TYPE are completed without a response */
+#define URING_NORESP_TYPE 0xFF
+static int _whTestCommUringServe(posixTransportTcpUringContext* ring,
+                                 whCommServer* server, int timeout_ms,
+                                 int* served_by)
+{
+    int      ret                = 0;
+    int      i                  = 0;
+    uint16_t ready[URING_CLIENT_COUNT];
+    uint16_t ready_count        = URING_CLIENT_COUNT;
+    uint8_t  rx_req[REQ_SIZE]   = {0};
+    uint16_t rx_req_len         = 0;
+    uint16_t rx_req_flags       = 0;
+    uint16_t rx_req_type        = 0;
+    uint16_t rx_req_seq         = 0;
+
+    WH_TEST_RETURN_ON_FAIL(
+        posixTransportTcpUring_Poll(ring, timeout_ms, ready, &ready_count));
+    for (i = 0; i < ready_count; i++) {
+        ret = wh_CommServer_RecvRequest(&server[ready[i]], &rx_req_flags,
+                                        &rx_req_type, &rx_req_seq, &rx_req_len,
+                                        rx_req);
+        WH_TEST_ASSERT_RETURN(ret == 0);
+        if (rx_req_type == URING_NORESP_TYPE) {
+            WH_TEST_RETURN_ON_FAIL(
+                wh_CommServer_CompleteRequest(&server[ready[i]]));
+            continue;
+        }
+        WH_TEST_ASSERT_RETURN(rx_req_type < URING_CLIENT_COUNT);
+        served_by[rx_req_type]++;
+        WH_TEST_RETURN_ON_FAIL(wh_CommServer_SendResponse(
+            &server[ready[i]], rx_req_flags, rx_req_type, rx_req_seq,
+            rx_req_len, rx_req));
+    }
+    return 0;
+}
+
+int whTest_CommTcpUring(void)
+{
+    int ret = 0;
+    int i   = 0;
+    int j   = 0;
+
+    posixTransportTcpConfig tcf[1] = {{
+        .server_ip_string = "127.0.0.1",
+        .server_port      = URING_TEST_PORT,
+    }};
+
+    /* Client configuration/contexts. One more client than server slots */
+    whTransportClientCb            tccb[1] = {PTT_CLIENT_CB};
+    posixTransportTcpClientContext tcc[URING_CLIENT_COUNT + 1];
+    whCommClientConfig             c_conf[URING_CLIENT_COUNT + 1];
+    whCommClient                   client[URING_CLIENT_COUNT + 1];
+
+    /* Server configuration/contexts, one per slot */
+    static posixTransportTcpUringServerContext tsc[URING_CLIENT_COUNT];
+    posixTransportTcpUringContext      ring[1] = {0};
+    whTransportServerCb                tscb[1] = {PTT_URING_SERVER_CB};
+    posixTransportTcpUringServerConfig ts_conf[URING_CLIENT_COUNT];
+    whCommServerConfig                 s_conf[URING_CLIENT_COUNT];
+    whCommServer                       server[URING_CLIENT_COUNT];
+
+    uint8_t  tx_req[REQ_SIZE]   = {0};
+    uint16_t tx_req_len         = 0;
+    uint16_t tx_req_seq         = 0;
+    uint8_t  rx_resp[RESP_SIZE] = {0};
+    uint16_t rx_resp_len        = 0;
+    uint16_t rx_resp_type       = 0;
+
+    int sent[URING_CLIENT_COUNT + 1]   = {0};
+    int served_by[URING_CLIENT_COUNT]  = {0};
+    int received[URING_CLIENT_COUNT]   = {0};
+    int done                           = 0;
+
+    memset(tcc, 0, sizeof(tcc));
+    memset(c_conf, 0, sizeof(c_conf));
+    memset(client, 0, sizeof(client));
+    memset(tsc, 0, sizeof(tsc));
+    memset(ts_conf, 0, sizeof(ts_conf));
+    memset(s_conf, 0, sizeof(s_conf));
+    memset(server, 0, sizeof(server));
+
+    ret = posixTransportTcpUring_Init(ring, tcf);
+    if (ret == WH_ERROR_NOTIMPL) {
+        WH_TEST_PRINT("  io_uring unavailable, skipping\n");
+        return 0;
+    }
+    WH_TEST_ASSERT_RETURN(ret == 0);
+
+    for (i = 0; i < URING_CLIENT_COUNT; i++) {
+        ts_conf[i].ring              = ring;
+        ts_conf[i].index             = i;
+        s_conf[i].transport_cb       = tscb;
+        s_conf[i].transport_context  = (void*)&tsc[i];
+        s_conf[i].transport_config   = (void*)&ts_conf[i];
+        s_conf[i].server_id          = 0xF;
+        WH_TEST_RETURN_ON_FAIL(
+            wh_CommServer_Init(&server[i], &s_conf[i], NULL, NULL));
+    }
+    /* A slot can only be owned by one context */
+    WH_TEST_ASSERT_RETURN(WH_ERROR_BADARGS ==
+                          posixTransportTcpUring_InitServer(
+                              &tsc[1], &ts_conf[0], NULL, NULL));
+
+    for (i = 0; i <= URING_CLIENT_COUNT; i++) {
+        c_conf[i].transport_cb      = tccb;
+        c_conf[i].transport_context = (void*)&tcc[i];
+        c_conf[i].transport_config  = (void*)tcf;
+        c_conf[i].client_id         = WH_TEST_DEFAULT_CLIENT_ID + i;
+        WH_TEST_RETURN_ON_FAIL(wh_CommClient_Init(&client[i], &c_conf[i]));
+    }
+
+    /* Each client sends a request without response, then one with. The
+     * response type encodes the client, so each must get its own back */
+    for (j = 0; (j < 1000) && (done < URING_CLIENT_COUNT); j++) {
+        for (i = 0; i < URING_CLIENT_COUNT; i++) {
+            if (sent[i] < 2) {
+                (void)snprintf((char*)tx_req, sizeof(tx_req), "Uring:%d", i);
+                tx_req_len = strlen((char*)tx_req);
+                if (sent[i] == 0) {
+                    ret = wh_CommClient_SendRequestNoResp(
+                        &client[i], WH_COMM_MAGIC_NATIVE, URING_NORESP_TYPE,
+                        &tx_req_seq, tx_req_len, tx_req);
+                }
+                else {
+                    ret = wh_CommClient_SendRequest(
+                        &client[i], WH_COMM_MAGIC_NATIVE, i, &tx_req_seq,
+                        tx_req_len, tx_req);
+                }
+                WH_TEST_ASSERT_RETURN((ret == 0) ||
+                                      (ret == WH_ERROR_NOTREADY));
+                sent[i] += (ret == 0);
+            }
+        }
+
+        WH_TEST_RETURN_ON_FAIL(_whTestCommUringServe(ring, server, 10,
+                                                     served_by));
+
+        for (i = 0; i < URING_CLIENT_COUNT; i++) {
+            if ((sent[i] == 2) && (received[i] == 0)) {
+                ret = wh_CommClient_RecvResponse(&client[i], NULL,
+                                                 &rx_resp_type, NULL,
+                                                 &rx_resp_len, rx_resp);
+                if (ret == WH_ERROR_NOTREADY) {
+                    continue;
+                }
+                WH_TEST_ASSERT_RETURN(ret == 0);
+                (void)snprintf((char*)tx_req, sizeof(tx_req), "Uring:%d", i);
+                tx_req_len = strlen((char*)tx_req);
+                WH_TEST_ASSERT_RETURN(rx_resp_type == i);
+                WH_TEST_ASSERT_RETURN(rx_resp_len == tx_req_len);
+                WH_TEST_ASSERT_RETURN(0 ==
+                                      memcmp(rx_resp, tx_req, tx_req_len));
+                received[i] = 1;
+                done++;
+            }
+        }
+    }
+    WH_TEST_ASSERT_RETURN(done == URING_CLIENT_COUNT);
+
+    /* Every client was served exactly once */
+    for (i = 0; i < URING_CLIENT_COUNT; i++) {
+        WH_TEST_ASSERT_RETURN(served_by[i] == 1);
+    }
+
+    /* The extra client was refused as all slots are in use */
+    (void)snprintf((char*)tx_req, sizeof(tx_req), "Refused");
+    tx_req_len = strlen((char*)tx_req);
+    for (j = 0; j < 100; j++) {
+        ret = wh_CommClient_SendRequest(&client[URING_CLIENT_COUNT],
+                                        WH_COMM_MAGIC_NATIVE, 0, &tx_req_seq,
+                                        tx_req_len, tx_req);
+        memset(served_by, 0, sizeof(served_by));
+        WH_TEST_RETURN_ON_FAIL(_whTestCommUringServe(ring, server, 1,
+                                                     served_by));
+        WH_TEST_ASSERT_RETURN(served_by[0] == 0);
+        if ((ret != 0) && (ret != WH_ERROR_NOTREADY)) {
+            break;
+        }
+    }
+    (void)wh_CommClient_Cleanup(&client[URING_CLIENT_COUNT]);
+
+    /* A disconnect frees the slot for the next client */
+    WH_TEST_RETURN_ON_FAIL(wh_CommClient_Cleanup(&client[0]));
+    for (j = 0; (j < 100) && (tsc[0].accept_fd_p1 != 0); j++) {
+        WH_TEST_RETURN_ON_FAIL(_whTestCommUringServe(ring, server, 10,
+                                                     served_by));
+    }
+    WH_TEST_ASSERT_RETURN(tsc[0].accept_fd_p1 == 0);
+
+    for (i = 1; i < URING_CLIENT_COUNT; i++) {
+        WH_TEST_RETURN_ON_FAIL(wh_CommClient_Cleanup(&client[i]));
+    }
+    for (i = 0; i < URING_CLIENT_COUNT; i++) {
+        WH_TEST_RETURN_ON_FAIL(wh_CommServer_Cleanup(&server[i]));
+    }
+    WH_TEST_RETURN_ON_FAIL(posixTransportTcpUring_Cleanup(ring));
+
+    return 0;
+}
+#endif /* PTT_URING_SUPPORTED */
+
+/* Connect a client, send one request carrying the memfd, and check the server
+ * sees what the client wrote in its area */
+static int _whTestCommUdsExchange(whCommClient* client, whCommServer* server,
+                                  uint8_t pattern)
+{
+    int      ret             = 0;
+    uint8_t  result          = (uint8_t)(pattern ^ 0xFF);
+    uint8_t* c_dma           = NULL;
+    uint8_t* s_dma           = NULL;
+    size_t   c_dma_size      = 0;
+    size_t   s_dma_size      = 0;
+    uint8_t  req[REQ_SIZE]   = {0};
+    uint8_t  resp[RESP_SIZE] = {0};
+    uint16_t magic           = 0;
+    uint16_t kind            = 0;
+    uint16_t seq             = 0;
+    uint16_t size            = 0;
+
+    WH_TEST_RETURN_ON_FAIL(posixTransportUds_GetDma(
+        client->transport_context, (void**)&c_dma, &c_dma_size));
+    memset(c_dma, pattern, c_dma_size);
+
+    do {
+        ret = wh_CommClient_SendRequest(client, WH_COMM_MAGIC_NATIVE, 1, &seq,
+                                        sizeof("bulk"), "bulk");
+    } while ((ret == WH_ERROR_NOTREADY) && (nanosleep(&ONE_MS, NULL) == 0));
+    WH_TEST_ASSERT_RETURN(ret == 0);
+
+    do {
+        ret = wh_CommServer_RecvRequest(server, &magic, &kind, &seq, &size,
+                                        req);
+    } while ((ret == WH_ERROR_NOTREADY) &&
+             (wh_CommServer_WaitRequest(server, 100000) != WH_ERROR_ABORTED));
+    WH_TEST_ASSERT_RETURN(ret == 0);
+    WH_TEST_ASSERT_RETURN(size == sizeof("bulk"));
+
+    /* The server maps the same pages the client wrote */
+    WH_TEST_RETURN_ON_FAIL(posixTransportUds_GetDma(
+        server->transport_context, (void**)&s_dma, &s_dma_size));
+    WH_TEST_ASSERT_RETURN(s_dma_size == c_dma_size);
+    WH_TEST_ASSERT_RETURN(s_dma != c_dma);
+    WH_TEST_ASSERT_RETURN(s_dma[0] == pattern);
+    WH_TEST_ASSERT_RETURN(s_dma[s_dma_size - 1] == pattern);
+
+    /* And results written by the server are visible to the client */
+    s_dma[0] = result;
+    WH_TEST_RETURN_ON_FAIL(
+        wh_CommServer_SendResponse(server, magic, kind, seq, 0, NULL));
+    do {
+        ret = wh_CommClient_RecvResponse(client, NULL, NULL, &seq, &size,
+                                         resp);
+    } while ((ret == WH_ERROR_NOTREADY) && (nanosleep(&ONE_MS, NULL) == 0));
+    WH_TEST_ASSERT_RETURN(ret == 0);
+    WH_TEST_ASSERT_RETURN(c_dma[0] == result);
+
+    return 0;
+}
+
+/* Count the disconnects reported by the transport */
+static int _whTestCommUdsConnectCb(void* context, whCommConnected connected)
+{
+    if (connected == WH_COMM_DISCONNECTED) {
+        (*(int*)context)++;
+    }
+    return 0;
+}
+
+int whTest_CommUds(void)
+{
+    int                     ret       = 0;
+    int                     i         = 0;
+    int                     drops     = 0;
+    int                     shm_fd    = -1;
+    char                    shm[64]   = {0};
+    char                    path[64]  = {0};
+    posixTransportUdsConfig ptucfg[1] = {{
+        .socket_path = path,
+        .dma_size    = BUFFER_SIZE * 4,
+    }};
+
+    whTransportClientCb            tccb[1]   = {POSIX_TRANSPORT_UDS_CLIENT_CB};
+    posixTransportUdsClientContext tcc[1]    = {0};
+    whCommClientConfig             c_conf[1] = {{
+                    .transport_cb      = tccb,
+                    .transport_context = (void*)tcc,
+                    .transport_config  = (void*)ptucfg,
+                    .client_id         = WH_TEST_DEFAULT_CLIENT_ID,
+    }};
+    whCommClient                   client[1] = {0};
+
+    whTransportServerCb            tscb[1]   = {POSIX_TRANSPORT_UDS_SERVER_CB};
+    posixTransportUdsServerContext tsc[1]    = {0};
+    whCommServerConfig             s_conf[1] = {{
+                    .transport_cb      = tscb,
+                    .transport_context = (void*)tsc,
+                    .transport_config  = (void*)ptucfg,
+                    .server_id         = 0xF,
+    }};
+    whCommServer                   server[1] = {0};
+
+    snprintf(path, sizeof(path), "/tmp/wh_test_comm_uds.%u",
+             (unsigned)getpid());
+
+    /* A client may start before the server is listening */
+    WH_TEST_RETURN_ON_FAIL(wh_CommClient_Init(client, c_conf));
+    WH_TEST_RETURN_ON_FAIL(wh_CommServer_Init(server, s_conf,
+                                              _whTestCommUdsConnectCb, &drops));
+    WH_TEST_ASSERT_RETURN(WH_ERROR_TIMEOUT ==
+                          wh_CommServer_WaitRequest(server, 1000));
+    WH_TEST_ASSERT_RETURN(WH_ERROR_NOTREADY ==
+                          posixTransportUds_GetDma(tsc, NULL, NULL));
+
+    WH_TEST_RETURN_ON_FAIL(_whTestCommUdsExchange(client, server, 0x5A));
+    WH_TEST_RETURN_ON_FAIL(wh_CommClient_Cleanup(client));
+
+    /* The server drops the area with the connection and reports it */
+    WH_TEST_ASSERT_RETURN(WH_ERROR_NOTREADY ==
+                          wh_CommServer_RecvRequest(server, NULL, NULL, NULL,
+                                                    NULL, NULL));
+    WH_TEST_ASSERT_RETURN(WH_ERROR_NOTREADY ==
+                          posixTransportUds_GetDma(tsc, NULL, NULL));
+    WH_TEST_ASSERT_RETURN(drops == 1);
+
+    /* The next client gets its own area */
+    WH_TEST_RETURN_ON_FAIL(wh_CommClient_Init(client, c_conf));
+    WH_TEST_RETURN_ON_FAIL(_whTestCommUdsExchange(client, server, 0xC3));
+
+    /* The client area is sealed against resizing */
+    WH_TEST_ASSERT_RETURN(0 != ftruncate(tcc->memfd_p1 - 1, 0));
+    WH_TEST_RETURN_ON_FAIL(wh_CommClient_Cleanup(client));
+    WH_TEST_ASSERT_RETURN(WH_ERROR_NOTREADY ==
+                          wh_CommServer_RecvRequest(server, NULL, NULL, NULL,
+                                                    NULL, NULL));
+    WH_TEST_ASSERT_RETURN(drops == 2);
+
+    /* The server refuses an area that could be resized under its mapping */
+    snprintf(shm, sizeof(shm), "/wh_test_comm_uds.%u", (unsigned)getpid());
+    shm_fd = shm_open(shm, O_RDWR | O_CREAT | O_EXCL, 0600);
+    WH_TEST_ASSERT_RETURN(shm_fd >= 0);
+    (void)shm_unlink(shm);
+    ret = ftruncate(shm_fd, (off_t)ptucfg->dma_size);
+    WH_TEST_RETURN_ON_FAIL(wh_CommClient_Init(client, c_conf));
+    if (ret == 0) {
+        /* Send the unsealed descriptor in place of the client memfd */
+        ret = dup2(shm_fd, tcc->memfd_p1 - 1);
+    }
+    close(shm_fd);
+    WH_TEST_ASSERT_RETURN(ret >= 0);
+    do {
+        ret = wh_CommClient_SendRequest(client, WH_COMM_MAGIC_NATIVE, 1,
+                                        NULL, sizeof("bulk"), "bulk");
+    } while ((ret == WH_ERROR_NOTREADY) && (nanosleep(&ONE_MS, NULL) == 0));
+    WH_TEST_ASSERT_RETURN(ret == 0);
+    for (i = 0; (i < 100) && (drops == 2); i++) {
+        (void)wh_CommServer_WaitRequest(server, 100000);
+        WH_TEST_ASSERT_RETURN(WH_ERROR_NOTREADY ==
+                              wh_CommServer_RecvRequest(server, NULL, NULL,
+                                                        NULL, NULL, NULL));
+    }
+    /* Only that client is dropped */
+    WH_TEST_ASSERT_RETURN(drops == 3);
+    WH_TEST_ASSERT_RETURN(tsc->connect_fd_p1 == 0);
+    WH_TEST_ASSERT_RETURN(WH_ERROR_NOTREADY ==
+                          posixTransportUds_GetDma(tsc, NULL, NULL));
+    WH_TEST_RETURN_ON_FAIL(wh_CommClient_Cleanup(client));
+
+    /* The server keeps serving the next client */
+    WH_TEST_RETURN_ON_FAIL(wh_CommClient_Init(client, c_conf));
+    WH_TEST_RETURN_ON_FAIL(_whTestCommUdsExchange(client, server, 0x3C));
+    WH_TEST_RETURN_ON_FAIL(wh_CommClient_Cleanup(client));
+
+    WH_TEST_RETURN_ON_FAIL(wh_CommServer_Cleanup(server));
+    return 0;
+}
+#endif /* __linux__ */
+
+/* Block on the transport if supported, otherwise sleep for a poll interval */
+static int _whCommServerWait(whCommServer* server)
+{
+    int ret = wh_CommServer_WaitRequest(server, 100000);
+    if (ret == WH_ERROR_NOTIMPL) {
+        return nanosleep(&ONE_MS, NULL);
+    }
+    return ((ret == 0) || (ret == WH_ERROR_TIMEOUT)) ? 0 : ret;
+}
+
 static void* _whCommClientTask(void* cf)
 {
     whCommClientConfig* config = (whCommClientConfig*)cf;
@@ -298,7 +2010,7 @@ static void* _whCommServerTask(void* cf)
                    ret, rx_req_flags, rx_req_type, rx_req_seq, rx_req_len,
                    rx_req);
             }
-        } while ((ret == WH_ERROR_NOTREADY) && (nanosleep(&ONE_MS, NULL) == 0));
+        } while ((ret == WH_ERROR_NOTREADY) && (_whCommServerWait(server) == 0));
 
         if (ret != 0) {
             WH_TEST_DEBUG_PRINT("Server had failure. Exiting\n");
@@ -400,6 +2112,42 @@ void wh_CommClientServer_MemThreadTest(void)
     _whCommClientServerThreadTest(c_conf, s_conf);
 }
 
+void wh_CommClientServer_MemRingThreadTest(void)
+{
+    /* Transport memory configuration */
+    uint8_t                  req[BUFFER_SIZE]  = {0};
+    uint8_t                  resp[BUFFER_SIZE] = {0};
+    whTransportMemRingConfig tmcf[1]           = {{
+                  .req        = req,
+                  .req_size   = sizeof(req),
+                  .resp       = resp,
+                  .resp_size  = sizeof(resp),
+                  .slot_count = RING_SLOT_COUNT,
+    }};
+
+    /* Client configuration/contexts */
+    whTransportClientCb tmccb[1] = {WH_TRANSPORT_MEM_RING_CLIENT_CB};
+    whTransportMemRingClientContext csc[1]    = {0};
+    whCommClientConfig              c_conf[1] = {{
+                     .transport_cb      = tmccb,
+                     .transport_context = (void*)csc,
+                     .transport_config  = (void*)tmcf,
+                     .client_id         = WH_TEST_DEFAULT_CLIENT_ID,
+    }};
+
+    /* Server configuration/contexts */
+    whTransportServerCb tmscb[1] = {WH_TRANSPORT_MEM_RING_SERVER_CB};
+    whTransportMemRingServerContext css[1]    = {0};
+    whCommServerConfig              s_conf[1] = {{
+                     .transport_cb      = tmscb,
+                     .transport_context = (void*)css,
+                     .transport_config  = (void*)tmcf,
+                     .server_id         = 0xF,
+    }};
+
+    _whCommClientServerThreadTest(c_conf, s_conf);
+}
+
 void wh_CommClientServer_ShMemThreadTest(void)
 {
     /* Transport memory configuration */
@@ -470,22 +2218,97 @@ void wh_CommClientServer_TcpThreadTest(void)
 
     _whCommClientServerThreadTest(c_conf, s_conf);
 }
+
+#if defined(__linux__)
+void wh_CommClientServer_UdsThreadTest(void)
+{
+    char                    path[64]  = {0};
+    posixTransportUdsConfig ptucfg[1] = {{
+        .socket_path = path,
+        .dma_size    = BUFFER_SIZE,
+    }};
+
+    /* Client configuration/contexts */
+    whTransportClientCb            ptuccb[1] = {POSIX_TRANSPORT_UDS_CLIENT_CB};
+    posixTransportUdsClientContext tcc[1]    = {0};
+    whCommClientConfig             c_conf[1] = {{
+                    .transport_cb      = ptuccb,
+                    .transport_context = (void*)tcc,
+                    .transport_config  = (void*)ptucfg,
+                    .client_id         = WH_TEST_DEFAULT_CLIENT_ID,
+    }};
+
+    /* Server configuration/contexts */
+    whTransportServerCb            ptuscb[1] = {POSIX_TRANSPORT_UDS_SERVER_CB};
+    posixTransportUdsServerContext tss[1]    = {0};
+    whCommServerConfig             s_conf[1] = {{
+                    .transport_cb      = ptuscb,
+                    .transport_context = (void*)tss,
+                    .transport_config  = (void*)ptucfg,
+                    .server_id         = 0xF,
+    }};
+
+    snprintf(path, sizeof(path), "/tmp/wh_test_comm_uds_thread.%u",
+             (unsigned)getpid());
+
+    _whCommClientServerThreadTest(c_conf, s_conf);
+}
+#endif /* __linux__ */
 #endif /* WOLFHSM_CFG_TEST_POSIX && WOLFHSM_CFG_ENABLE_CLIENT && \
           WOLFHSM_CFG_ENABLE_SERVER */
 
 #if defined(WOLFHSM_CFG_ENABLE_CLIENT) && defined(WOLFHSM_CFG_ENABLE_SERVER)
 int whTest_Comm(void)
 {
+    WH_TEST_PRINT("Testing comms: message translation...\n");
+    WH_TEST_ASSERT(0 == whTest_CommTranslate());
+
     WH_TEST_PRINT("Testing comms: mem...\n");
     WH_TEST_ASSERT(0 == whTest_CommMem());
 
+    WH_TEST_PRINT("Testing comms: mem ring...\n");
+    WH_TEST_ASSERT(0 == whTest_CommMemRing());
+
+    WH_TEST_PRINT("Testing comms: mem cache line layout...\n");
+    WH_TEST_ASSERT(0 == whTest_CommMemCsrPadded());
+
+#ifdef WOLFHSM_CFG_COMM_FRAGMENT
+    WH_TEST_PRINT("Testing comms: mem fragmentation...\n");
+    WH_TEST_ASSERT(0 == whTest_CommMemFragment());
+#endif
+
 #if defined(WOLFHSM_CFG_TEST_POSIX)
     WH_TEST_PRINT("Testing comms: (pthread) mem...\n");
     wh_CommClientServer_MemThreadTest();
 
+    WH_TEST_PRINT("Testing comms: (pthread) mem ring...\n");
+    wh_CommClientServer_MemRingThreadTest();
+
     WH_TEST_PRINT("Testing comms: (pthread) tcp...\n");
     wh_CommClientServer_TcpThreadTest();
 
+    WH_TEST_PRINT("Testing comms: tcp requests without response...\n");
+    WH_TEST_ASSERT(0 == whTest_CommTcpNoResp());
+
+#if defined(__linux__)
+    WH_TEST_PRINT("Testing comms: tcp multi-connection...\n");
+    WH_TEST_ASSERT(0 == whTest_CommTcpMux());
+
+#if defined(PTT_URING_SUPPORTED)
+    WH_TEST_PRINT("Testing comms: tcp multi-connection io_uring...\n");
+    WH_TEST_ASSERT(0 == whTest_CommTcpUring());
+#endif
+
+    WH_TEST_PRINT("Testing comms: unix socket with memfd...\n");
+    WH_TEST_ASSERT(0 == whTest_CommUds());
+
+    WH_TEST_PRINT("Testing comms: (pthread) unix socket...\n");
+    wh_CommClientServer_UdsThreadTest();
+#endif
+
+    WH_TEST_PRINT("Testing comms: posix mem wait...\n");
+    WH_TEST_ASSERT(0 == whTest_CommShmWait());
+
     WH_TEST_PRINT("Testing comms: (pthread) posix mem...\n");
     wh_CommClientServer_ShMemThreadTest();
 #endif /* defined(WOLFHSM_CFG_TEST_POSIX) */
@@ -30,6 +30,73 @@
  */
 int whTest_CommMem(void);
 
+/*
+ * Runs the comms tests using the multi-slot ring memory transport backend,
+ * keeping several requests in flight at once.
+ * Returns 0 on success and a non-zero error code on failure
+ */
+int whTest_CommMemRing(void);
+
+/*
+ * Runs the message translation tests, checking the native fast path and, unless
+ * WOLFHSM_CFG_COMM_NATIVE_ONLY is defined, byteswapping of the other endianness
+ * Returns 0 on success and a non-zero error code on failure
+ */
+int whTest_CommTranslate(void);
+
+/*
+ * Runs the memory transport tests with each CSR padded to its own cache line
+ * Returns 0 on success and a non-zero error code on failure
+ */
+int whTest_CommMemCsrPadded(void);
+
+/*
+ * Runs the fragmentation tests, sending messages several times larger than the
+ * memory transport buffers.  Only available if WOLFHSM_CFG_COMM_FRAGMENT is
+ * defined.
+ * Returns 0 on success and a non-zero error code on failure
+ */
+int whTest_CommMemFragment(void);
+
+/*
+ * Runs the blocking server wait tests using the POSIX shared memory transport.
+ * Only available if WOLFHSM_CFG_TEST_POSIX is defined.
+ * Returns 0 on success and a non-zero error code on failure
+ */
+int whTest_CommShmWait(void);
+
+/*
+ * Runs the TCP transport tests for requests completed without a response.
+ * Only available if WOLFHSM_CFG_TEST_POSIX is defined.
+ * Returns 0 on success and a non-zero error code on failure
+ */
+int whTest_CommTcpNoResp(void);
+
+/*
+ * Runs the epoll multi-connection TCP server transport tests with several
+ * clients served from one listen socket, including requests completed without
+ * a response.
+ * Only available on Linux if WOLFHSM_CFG_TEST_POSIX is defined.
+ * Returns 0 on success and a non-zero error code on failure
+ */
+int whTest_CommTcpMux(void);
+
+/*
+ * Runs the io_uring multi-connection TCP server transport tests, including
+ * requests completed without a response.
+ * Only available on Linux with io_uring if WOLFHSM_CFG_TEST_POSIX is defined.
+ * Returns 0 on success and a non-zero error code on failure
+ */
+int whTest_CommTcpUring(void);
+
+/*
+ * Runs the Unix domain socket transport tests, checking that the client memfd
+ * area is shared with the server and is private to each connection.
+ * Only available on Linux if WOLFHSM_CFG_TEST_POSIX is defined.
+ * Returns 0 on success and a non-zero error code on failure
+ */
+int whTest_CommUds(void);
+
 /* Runs all the comms tests using a memory transport as the backend, and
  * optionally using the POSIX TCP backend if WOLFHSM_CFG_TEST_POSIX is defined.
  *
@@ -931,6 +931,128 @@ static int whTest_CryptoEccCrossVerify(whClientContext* ctx, WC_RNG* rng)
 
     return ret;
 }
+
+#define WH_TEST_ECC_RECACHE_SIGNS 3
+
+/* Sign with a key of this keyId WH_TEST_ECC_RECACHE_SIGNS times, checking each
+ * signature verifies against swKey and not against otherKey */
+static int whTest_CryptoEccRecacheSign(WC_RNG* rng, whKeyId keyId,
+                                       ecc_key* swKey, ecc_key* otherKey)
+{
+    ecc_key hsmKey[1] = {0};
+    uint8_t hash[WC_SHA256_DIGEST_SIZE];
+    uint8_t sig[ECC_MAX_SIG_SIZE];
+    word32  sigLen;
+    int     res;
+    int     ret;
+    int     i;
+
+    ret = wc_ecc_init_ex(hsmKey, NULL, WH_DEV_ID);
+    if (ret != 0) {
+        WH_ERROR_PRINT("Failed to init HSM key: %d\n", ret);
+        return ret;
+    }
+    ret = wc_ecc_set_curve(hsmKey, 32, ECC_SECP256R1);
+    if (ret == 0) {
+        ret = wh_Client_EccSetKeyId(hsmKey, keyId);
+    }
+
+    for (i = 0; (ret == 0) && (i < WH_TEST_ECC_RECACHE_SIGNS); i++) {
+        ret = wc_RNG_GenerateBlock(rng, hash, sizeof(hash));
+        if (ret == 0) {
+            sigLen = sizeof(sig);
+            ret = wc_ecc_sign_hash(hash, sizeof(hash), sig, &sigLen, rng,
+                                   hsmKey);
+            if (ret != 0) {
+                WH_ERROR_PRINT("HSM sign failed: %d\n", ret);
+            }
+        }
+        if (ret == 0) {
+            res = 0;
+            ret = wc_ecc_verify_hash(sig, sigLen, hash, sizeof(hash), &res,
+                                     swKey);
+            if ((ret == 0) && (res != 1)) {
+                WH_ERROR_PRINT("Signature %d does not match the cached key\n",
+                               i);
+                ret = WH_ERROR_ABORTED;
+            }
+        }
+        if ((ret == 0) && (otherKey != NULL)) {
+            res = 0;
+            ret = wc_ecc_verify_hash(sig, sigLen, hash, sizeof(hash), &res,
+                                     otherKey);
+            if ((ret == 0) && (res != 0)) {
+                WH_ERROR_PRINT("Signature %d was made with the replaced "
+                               "key\n", i);
+                ret = WH_ERROR_ABORTED;
+            }
+        }
+    }
+
+    wc_ecc_free(hsmKey);
+    return ret;
+}
+
+/* Repeated signs with one keyId reuse the server's decoded key object, so
+ * check that caching a new key under the same keyId is picked up */
+static int whTest_CryptoEccRecache(whClientContext* client, WC_RNG* rng)
+{
+    ecc_key    key1[1]  = {0};
+    ecc_key    key2[1]  = {0};
+    int        key1Init = 0;
+    int        key2Init = 0;
+    whKeyId    keyId    = WH_KEYID_ERASED;
+    whNvmFlags flags = WH_NVM_FLAGS_USAGE_SIGN | WH_NVM_FLAGS_USAGE_VERIFY;
+    int        ret;
+
+    WH_TEST_PRINT("  Testing ECC sign after re-caching a keyId...\n");
+
+    /* Cache a key and keep a software copy to verify against */
+    ret = wh_Client_EccMakeCacheKey(client, 32, ECC_SECP256R1, &keyId, flags,
+                                    0, NULL);
+    if (ret == 0) {
+        ret = wc_ecc_init_ex(key1, NULL, INVALID_DEVID);
+        key1Init = (ret == 0);
+    }
+    if (ret == 0) {
+        ret = wh_Client_EccExportKey(client, keyId, key1, 0, NULL);
+    }
+    if (ret == 0) {
+        ret = whTest_CryptoEccRecacheSign(rng, keyId, key1, NULL);
+    }
+
+    /* Replace the cached key under the same keyId */
+    if (ret == 0) {
+        ret = wh_Client_EccMakeCacheKey(client, 32, ECC_SECP256R1, &keyId,
+                                        flags, 0, NULL);
+    }
+    if (ret == 0) {
+        ret = wc_ecc_init_ex(key2, NULL, INVALID_DEVID);
+        key2Init = (ret == 0);
+    }
+    if (ret == 0) {
+        ret = wh_Client_EccExportKey(client, keyId, key2, 0, NULL);
+    }
+
+    /* Signatures must now come from the new key only */
+    if (ret == 0) {
+        ret = whTest_CryptoEccRecacheSign(rng, keyId, key2, key1);
+    }
+
+    if (ret == 0) {
+        WH_TEST_PRINT("    PASS: Sign used the re-cached ECC key\n");
+    }
+    if (key1Init) {
+        wc_ecc_free(key1);
+    }
+    if (key2Init) {
+        wc_ecc_free(key2);
+    }
+    if (!WH_KEYID_ISERASED(keyId)) {
+        (void)wh_Client_KeyEvict(client, keyId);
+    }
+    return ret;
+}
 #endif /* HAVE_ECC_SIGN && HAVE_ECC_VERIFY && !WOLF_CRYPTO_CB_ONLY_ECC */
 #endif /* HAVE_ECC */
 
@@ -2966,6 +3088,148 @@ static int whTest_KeyCache(whClientContext* ctx, int devId, WC_RNG* rng)
     }
 #endif /* WOLFHSM_CFG_DMA */
 
+#if WOLFHSM_CFG_SERVER_KEYCACHE_PIN_MAX > 0
+    /* Test key pinning and the per-client pin limit */
+    if (ret == 0) {
+        whKeyId pinIds[WOLFHSM_CFG_SERVER_KEYCACHE_PIN_MAX + 1];
+        int     pinCount = 0;
+
+        /* Pinning a committed key that is not cached loads it from NVM */
+        keyId = WH_KEYID_ERASED;
+        ret = wh_Client_KeyCache(ctx, 0, labelIn, sizeof(labelIn), key,
+                sizeof(key), &keyId);
+        if (ret == 0) {
+            ret = wh_Client_KeyCommit(ctx, keyId);
+        }
+        if (ret == 0) {
+            pinIds[pinCount++] = keyId;
+            ret = wh_Client_KeyEvict(ctx, keyId);
+        }
+        if (ret == 0) {
+            ret = wh_Client_KeyPin(ctx, keyId);
+            if (ret != 0) {
+                WH_ERROR_PRINT("Failed to pin committed key %d\n", ret);
+            }
+        }
+        if (ret == 0) {
+            /* Pinning again is not counted twice */
+            ret = wh_Client_KeyPin(ctx, keyId);
+            if (ret != 0) {
+                WH_ERROR_PRINT("Failed to pin key twice %d\n", ret);
+            }
+        }
+        if (ret == 0) {
+            outLen = sizeof(keyOut);
+            ret = wh_Client_KeyExport(ctx, keyId, labelOut, sizeof(labelOut),
+                    keyOut, &outLen);
+            if ((ret == 0) && ((outLen != sizeof(key)) ||
+                               (memcmp(key, keyOut, outLen) != 0))) {
+                WH_ERROR_PRINT("Failed to match pinned key\n");
+                ret = -1;
+            }
+        }
+
+        /* Pin cached keys until the limit is reached */
+        while ((ret == 0) &&
+               (pinCount <= WOLFHSM_CFG_SERVER_KEYCACHE_PIN_MAX)) {
+            keyId = WH_KEYID_ERASED;
+            ret = wh_Client_KeyCache(ctx, 0, labelIn, sizeof(labelIn), key,
+                    sizeof(key), &keyId);
+            if (ret != 0) {
+                WH_ERROR_PRINT("Failed to wh_Client_KeyCache %d\n", ret);
+                break;
+            }
+            pinIds[pinCount++] = keyId;
+            ret = wh_Client_KeyPin(ctx, keyId);
+            if (pinCount <= WOLFHSM_CFG_SERVER_KEYCACHE_PIN_MAX) {
+                if (ret != 0) {
+                    WH_ERROR_PRINT("Failed to pin key %d\n", ret);
+                }
+            }
+            else if (ret != WH_ERROR_NOSPACE) {
+                WH_ERROR_PRINT("Pinned more than the limit %d\n", ret);
+                ret = -1;
+            }
+            else {
+                ret = 0;
+            }
+        }
+
+        /* Unpinning one key makes room for another pin */
+        if (ret == 0) {
+            ret = wh_Client_KeyUnpin(ctx, pinIds[1]);
+            if (ret == 0) {
+                ret = wh_Client_KeyPin(ctx, pinIds[pinCount - 1]);
+            }
+            if (ret != 0) {
+                WH_ERROR_PRINT("Failed to pin after unpin %d\n", ret);
+            }
+        }
+
+        /* Committing more keys than the cache holds forces evictions, but
+         * never of the pinned committed key */
+        if (ret == 0) {
+            whKeyId fillIds[WOLFHSM_CFG_SERVER_KEYCACHE_COUNT];
+            int     fillCount = 0;
+
+            while ((ret == 0) &&
+                   (fillCount < WOLFHSM_CFG_SERVER_KEYCACHE_COUNT)) {
+                keyId = WH_KEYID_ERASED;
+                ret = wh_Client_KeyCache(ctx, 0, labelIn, sizeof(labelIn),
+                        key, sizeof(key), &keyId);
+                if (ret == 0) {
+                    fillIds[fillCount++] = keyId;
+                    ret = wh_Client_KeyCommit(ctx, keyId);
+                }
+                if (ret != 0) {
+                    WH_ERROR_PRINT("Failed to fill the cache %d\n", ret);
+                }
+            }
+            if (ret == 0) {
+                /* Unpin only finds cached keys */
+                ret = wh_Client_KeyUnpin(ctx, pinIds[0]);
+                if (ret != 0) {
+                    WH_ERROR_PRINT("Pinned key was evicted %d\n", ret);
+                }
+                else {
+                    ret = wh_Client_KeyPin(ctx, pinIds[0]);
+                }
+            }
+            while (fillCount > 0) {
+                (void)wh_Client_KeyErase(ctx, fillIds[--fillCount]);
+            }
+        }
+
+        /* Evicting a pinned key drops its pin */
+        if (ret == 0) {
+            ret = wh_Client_KeyEvict(ctx, pinIds[pinCount - 1]);
+            if (ret == 0) {
+                ret = wh_Client_KeyUnpin(ctx, pinIds[pinCount - 1]);
+                if (ret != WH_ERROR_NOTFOUND) {
+                    WH_ERROR_PRINT("Failed to not find evicted pinned key "
+                            "%d\n", ret);
+                    ret = -1;
+                }
+                else {
+                    ret = 0;
+                }
+            }
+            pinCount--;
+        }
+
+        /* Clean up */
+        while (pinCount > 1) {
+            (void)wh_Client_KeyEvict(ctx, pinIds[--pinCount]);
+        }
+        if (pinCount > 0) {
+            (void)wh_Client_KeyErase(ctx, pinIds[0]);
+        }
+        if (ret == 0) {
+            WH_TEST_PRINT("KEY PIN SUCCESS\n");
+        }
+    }
+#endif /* WOLFHSM_CFG_SERVER_KEYCACHE_PIN_MAX > 0 */
+
     return ret;
 }
 
@@ -5840,6 +6104,9 @@ int whTest_CryptoClientConfig(whClientConfig* config)
     if (ret == 0) {
         ret = whTest_CryptoEccCrossVerify(client, rng);
     }
+    if (ret == 0) {
+        ret = whTest_CryptoEccRecache(client, rng);
+    }
 #endif
 #endif /* HAVE_ECC */
 
@@ -0,0 +1,892 @@
+/*
+ * Copyright (C) 2025 wolfSSL Inc.
+ *
+ * This file is part of wolfHSM.
+ *
+ * wolfHSM is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * wolfHSM is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with wolfHSM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/*
+ * test/wh_test_keystore.c
+ *
+ * Server key cache tests. These drive the keystore of a server context
+ * directly, without a client, so they can check which keys the cache holds
+ * and where it placed them.
+ */
+
+#include "wolfhsm/wh_settings.h"
+
+#if defined(WOLFHSM_CFG_ENABLE_SERVER) && !defined(WOLFHSM_CFG_NO_CRYPTO)
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "wolfssl/wolfcrypt/settings.h"
+#include "wolfssl/wolfcrypt/types.h"
+#include "wolfssl/wolfcrypt/wc_port.h"
+#include "wolfssl/wolfcrypt/random.h"
+#include "wolfssl/wolfcrypt/rsa.h"
+#include "wolfssl/wolfcrypt/ecc.h"
+
+#include "wolfhsm/wh_error.h"
+#include "wolfhsm/wh_comm.h"
+#include "wolfhsm/wh_keyid.h"
+#include "wolfhsm/wh_keycache.h"
+#include "wolfhsm/wh_transport_mem.h"
+#include "wolfhsm/wh_server.h"
+#include "wolfhsm/wh_server_keystore.h"
+#include "wolfhsm/wh_server_crypto.h"
+#include "wolfhsm/wh_nvm.h"
+#include "wolfhsm/wh_nvm_flash.h"
+#include "wolfhsm/wh_flash_ramsim.h"
+
+#include "wh_test_common.h"
+#include "wh_test_keystore.h"
+
+#define FLASH_RAM_SIZE (1024 * 1024)   /* 1MB */
+#define FLASH_SECTOR_SIZE (128 * 1024) /* 128KB */
+#define FLASH_PAGE_SIZE (8)            /* 8B */
+#define BUFFER_SIZE 4096
+
+/* Keys of the tests belong to this user */
+#define TEST_USER 1
+#define TEST_KEYID(_id) WH_MAKE_KEYID(WH_KEYTYPE_CRYPTO, TEST_USER, (_id))
+
+/* Slots that keys of TEST_KEY_LEN bytes compete for */
+#ifdef WOLFHSM_CFG_SERVER_KEYCACHE_POOL
+#define TEST_SLOTS WOLFHSM_CFG_SERVER_KEYCACHE_POOL_KEYS
+#else
+#define TEST_SLOTS WOLFHSM_CFG_SERVER_KEYCACHE_COUNT
+#endif
+#define TEST_KEY_LEN 32
+
+/* Key IDs of the uncommitted keys filling up the cache */
+#define TEST_FILL_ID 100
+
+/* Flash contents kept over an NVM restart */
+static uint8_t backupMemory[FLASH_RAM_SIZE];
+
+/* Key material cached by the tests, the contents don't matter */
+static uint8_t testKey[WOLFHSM_CFG_SERVER_KEYCACHE_BIG_BUFSIZE];
+
+/* Cache len bytes of key material under keyId, committing it to NVM if asked */
+static int _cacheKey(whServerContext* server, whKeyId keyId, uint16_t len,
+                     int commit)
+{
+    whNvmMetadata meta[1] = {{0}};
+
+    meta->id     = keyId;
+    meta->len    = len;
+    meta->access = WH_NVM_ACCESS_ANY;
+    WH_TEST_RETURN_ON_FAIL(wh_Server_KeystoreCacheKey(server, meta, testKey));
+    if (commit != 0) {
+        WH_TEST_RETURN_ON_FAIL(wh_Server_KeystoreCommitKey(server, keyId));
+    }
+    return 0;
+}
+
+/* Whether keyId is in the local cache, without counting it as a use */
+static int _isCached(whServerContext* server, whKeyId keyId)
+{
+    int i;
+
+    for (i = 0; i < WH_KEYCACHE_SLOT_COUNT; i++) {
+        if (server->localCache.indexId[i] == keyId) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* Remove the keys with IDs first to first + count - 1 from cache and NVM */
+static void _dropKeys(whServerContext* server, int first, int count)
+{
+    int i;
+
+    for (i = first; i < first + count; i++) {
+        (void)wh_Server_KeystoreEraseKey(server, TEST_KEYID(i));
+    }
+}
+
+/* Fill count slots with uncommitted keys, which are never evicted */
+static int _fillCache(whServerContext* server, int count)
+{
+    int i;
+
+    for (i = 0; i < count; i++) {
+        WH_TEST_RETURN_ON_FAIL(
+            _cacheKey(server, TEST_KEYID(TEST_FILL_ID + i), TEST_KEY_LEN, 0));
+    }
+    return 0;
+}
+
+/* Use a cached key times times */
+static int _touchKey(whServerContext* server, whKeyId keyId, int times)
+{
+    int i;
+
+    for (i = 0; i < times; i++) {
+        WH_TEST_RETURN_ON_FAIL(
+            wh_Server_KeystoreFreshenKey(server, keyId, NULL, NULL));
+    }
+    return 0;
+}
+
+/* A full cache evicts the committed key the policy picks, and the statistics
+ * count the uses, misses and evictions */
+static int _testEvictionPolicy(whServerContext* server)
+{
+    whKeyCacheStats stats;
+    uint8_t         out[TEST_KEY_LEN];
+    uint32_t        outSz = sizeof(out);
+    whKeyId         victim;
+    int             i;
+
+    /* Keys 1 to 3 are the only committed ones */
+    for (i = 1; i <= 3; i++) {
+        WH_TEST_RETURN_ON_FAIL(
+            _cacheKey(server, TEST_KEYID(i), TEST_KEY_LEN, 1));
+    }
+    WH_TEST_RETURN_ON_FAIL(_fillCache(server, TEST_SLOTS - 3));
+    WH_TEST_RETURN_ON_FAIL(wh_Server_KeystoreResetCacheStats(server, 0));
+
+    /* Key 1 is used most often but longest ago */
+    WH_TEST_RETURN_ON_FAIL(_touchKey(server, TEST_KEYID(1), 3));
+    WH_TEST_RETURN_ON_FAIL(_touchKey(server, TEST_KEYID(2), 1));
+    WH_TEST_RETURN_ON_FAIL(_touchKey(server, TEST_KEYID(3), 1));
+#if defined(WOLFHSM_CFG_SERVER_KEYCACHE_LFU)
+    victim = TEST_KEYID(2);
+#else
+    /* Least recently used, or the first committed key without a policy */
+    victim = TEST_KEYID(1);
+#endif
+
+    WH_TEST_RETURN_ON_FAIL(_cacheKey(server, TEST_KEYID(4), TEST_KEY_LEN, 0));
+    for (i = 1; i <= 4; i++) {
+        WH_TEST_ASSERT_RETURN(_isCached(server, TEST_KEYID(i)) ==
+                              (TEST_KEYID(i) != victim));
+    }
+
+    WH_TEST_ASSERT_RETURN(WH_ERROR_NOTFOUND ==
+                          wh_Server_KeystoreReadKey(server, TEST_KEYID(50),
+                                                    NULL, out, &outSz));
+    WH_TEST_RETURN_ON_FAIL(wh_Server_KeystoreGetCacheStats(server, 0, &stats));
+    WH_TEST_ASSERT_RETURN(stats.hits == 5);
+    WH_TEST_ASSERT_RETURN(stats.misses == 1);
+    WH_TEST_ASSERT_RETURN(stats.evictions == 1);
+
+#ifdef WOLFHSM_CFG_GLOBAL_KEYS
+    /* Local keys don't count towards the global cache */
+    WH_TEST_RETURN_ON_FAIL(wh_Server_KeystoreGetCacheStats(server, 1, &stats));
+    WH_TEST_ASSERT_RETURN(stats.hits == 0);
+    WH_TEST_ASSERT_RETURN(stats.misses == 0);
+    WH_TEST_ASSERT_RETURN(stats.evictions == 0);
+#endif
+
+    WH_TEST_RETURN_ON_FAIL(wh_Server_KeystoreResetCacheStats(server, 0));
+    WH_TEST_RETURN_ON_FAIL(wh_Server_KeystoreGetCacheStats(server, 0, &stats));
+    WH_TEST_ASSERT_RETURN(stats.hits == 0);
+    WH_TEST_ASSERT_RETURN(stats.misses == 0);
+    WH_TEST_ASSERT_RETURN(stats.evictions == 0);
+
+    _dropKeys(server, 1, 4);
+    _dropKeys(server, TEST_FILL_ID, TEST_SLOTS - 3);
+    return 0;
+}
+
+/* Home bucket of keyId, the same hash as the keystore index uses */
+static int _indexHome(whKeyId keyId)
+{
+    uint32_t h = (uint32_t)keyId * 0x9E3779B1u;
+    return (int)((h >> 16) % WOLFHSM_CFG_SERVER_KEYCACHE_INDEX_SIZE);
+}
+
+/* Whether keyId is found through the index, without reading it from NVM */
+static int _indexFinds(whServerContext* server, whKeyId keyId)
+{
+    whNvmMetadata* meta = NULL;
+
+    if (wh_Server_KeystoreFreshenKey(server, keyId, NULL, &meta) != 0) {
+        return 0;
+    }
+    return (meta->id == keyId);
+}
+
+/* Keys whose index probes collide and wrap past the last bucket are all found
+ * while others are evicted and cached again around them */
+static int _testIndexCollisions(whServerContext* server)
+{
+    const int first = WOLFHSM_CFG_SERVER_KEYCACHE_INDEX_SIZE -
+                      WOLFHSM_CFG_SERVER_KEYCACHE_INDEX_SIZE / 4;
+    whKeyId   ids[TEST_SLOTS];
+    whKeyId   id;
+    int       count = 0;
+    int       user;
+    int       round;
+    int       evicted;
+    int       i;
+
+    /* Take keys homed in the last quarter of the index. There are more of
+     * them than buckets in it, so their probe runs wrap to the start */
+    for (user = 1; (user <= WH_KEYUSER_MASK >> WH_KEYUSER_SHIFT) &&
+                   (count < TEST_SLOTS);
+         user++) {
+        for (i = 1; (i <= WH_KEYID_IDMAX) && (count < TEST_SLOTS); i++) {
+            id = WH_MAKE_KEYID(WH_KEYTYPE_CRYPTO, user, i);
+            if (_indexHome(id) >= first) {
+                ids[count++] = id;
+            }
+        }
+    }
+    WH_TEST_ASSERT_RETURN(count == TEST_SLOTS);
+    WH_TEST_ASSERT_RETURN(TEST_SLOTS > WOLFHSM_CFG_SERVER_KEYCACHE_INDEX_SIZE -
+                                           first);
+
+    for (i = 0; i < count; i++) {
+        WH_TEST_RETURN_ON_FAIL(_cacheKey(server, ids[i], TEST_KEY_LEN, 0));
+    }
+    WH_TEST_ASSERT_RETURN(server->localCache.index[0].slot != 0);
+    WH_TEST_ASSERT_RETURN(_indexHome(server->localCache.index[0].id) >= first);
+
+    /* Evict and cache again alternating halves of the keys, so entries are
+     * shifted back across the wrap as well as within it */
+    for (round = 0; round < 4; round++) {
+        for (i = round % 2; i < count; i += 2) {
+            WH_TEST_RETURN_ON_FAIL(wh_Server_KeystoreEvictKey(server, ids[i]));
+        }
+        for (i = 0; i < count; i++) {
+            /* Keys evicted this round have the same parity as the round */
+            evicted = ((i & 1) == (round & 1));
+            WH_TEST_ASSERT_RETURN(_indexFinds(server, ids[i]) == !evicted);
+        }
+        for (i = round % 2; i < count; i += 2) {
+            WH_TEST_RETURN_ON_FAIL(_cacheKey(server, ids[i], TEST_KEY_LEN, 0));
+        }
+        for (i = 0; i < count; i++) {
+            WH_TEST_ASSERT_RETURN(_indexFinds(server, ids[i]));
+        }
+    }
+
+    for (i = 0; i < count; i++) {
+        WH_TEST_RETURN_ON_FAIL(wh_Server_KeystoreEvictKey(server, ids[i]));
+    }
+    return 0;
+}
+
+/* Get a unique key ID for user and check no cached or NVM key uses it */
+static int _uniqueId(whServerContext* server, int user, whKeyId* out_id)
+{
+    *out_id = WH_MAKE_KEYID(WH_KEYTYPE_CRYPTO, user, WH_KEYID_ERASED);
+    WH_TEST_RETURN_ON_FAIL(wh_Server_KeystoreGetUniqueId(server, out_id));
+    WH_TEST_ASSERT_RETURN(!WH_KEYID_ISERASED(*out_id));
+    WH_TEST_ASSERT_RETURN(WH_KEYID_USER(*out_id) == user);
+    WH_TEST_ASSERT_RETURN(!_isCached(server, *out_id));
+    WH_TEST_ASSERT_RETURN(WH_ERROR_NOTFOUND ==
+                          wh_Nvm_GetMetadata(server->nvm, *out_id, NULL));
+    return 0;
+}
+
+/* Auto assigned key IDs stay unique as keys are cached, committed, erased and
+ * destroyed, and after the NVM key ID map is rebuilt at init */
+static int _testUniqueIds(whServerContext* server, const whNvmConfig* nvmCfg,
+                          whFlashRamsimCfg* flashCfg)
+{
+    whKeyId       ids[8];
+    whKeyId       fresh[8];
+    whKeyId       id;
+    whNvmMetadata meta;
+    int           count = sizeof(ids) / sizeof(ids[0]);
+    int           i;
+
+    WH_TEST_ASSERT_RETURN(server->nvm->keyIdMapValid != 0);
+
+    /* Cached and committed keys both hold their IDs, in cache or in NVM */
+    for (i = 0; i < count; i++) {
+        WH_TEST_RETURN_ON_FAIL(_uniqueId(server, TEST_USER, &ids[i]));
+        WH_TEST_RETURN_ON_FAIL(_cacheKey(server, ids[i], TEST_KEY_LEN, 0));
+    }
+    for (i = 0; i < count; i++) {
+        WH_TEST_RETURN_ON_FAIL(wh_Server_KeystoreCommitKey(server, ids[i]));
+        WH_TEST_RETURN_ON_FAIL(wh_Server_KeystoreEvictKey(server, ids[i]));
+    }
+    WH_TEST_RETURN_ON_FAIL(_uniqueId(server, TEST_USER, &id));
+
+    /* Erased and destroyed IDs may be handed out again, the others not */
+    WH_TEST_RETURN_ON_FAIL(wh_Server_KeystoreEraseKey(server, ids[0]));
+    WH_TEST_RETURN_ON_FAIL(wh_Nvm_DestroyObjects(server->nvm, 1, &ids[1]));
+    for (i = 0; i < 2; i++) {
+        WH_TEST_RETURN_ON_FAIL(_uniqueId(server, TEST_USER, &ids[i]));
+        WH_TEST_RETURN_ON_FAIL(_cacheKey(server, ids[i], TEST_KEY_LEN, 1));
+    }
+
+    /* The map rebuilt from the NVM objects still covers every committed key,
+     * with none of them left in the cache */
+    for (i = 0; i < 2; i++) {
+        WH_TEST_RETURN_ON_FAIL(wh_Server_KeystoreEvictKey(server, ids[i]));
+    }
+    memcpy(backupMemory, flashCfg->memory, FLASH_RAM_SIZE);
+    WH_TEST_RETURN_ON_FAIL(wh_Nvm_Cleanup(server->nvm));
+    flashCfg->initData = backupMemory;
+    WH_TEST_RETURN_ON_FAIL(wh_Nvm_Init(server->nvm, nvmCfg));
+    flashCfg->initData = NULL;
+    WH_TEST_ASSERT_RETURN(server->nvm->keyIdMapValid != 0);
+    WH_TEST_ASSERT_RETURN(WH_ERROR_OK ==
+                          wh_Nvm_GetMetadata(server->nvm, ids[0], NULL));
+    for (i = 0; i < count; i++) {
+        WH_TEST_RETURN_ON_FAIL(_uniqueId(server, TEST_USER, &fresh[i]));
+        WH_TEST_RETURN_ON_FAIL(_cacheKey(server, fresh[i], TEST_KEY_LEN, 0));
+    }
+    for (i = 0; i < count; i++) {
+        WH_TEST_RETURN_ON_FAIL(wh_Server_KeystoreEvictKey(server, fresh[i]));
+    }
+
+    /* A user with every ID in use gets none, other users are unaffected */
+    memset(server->nvm->keyIdMap[TEST_USER + 1], 0xFF,
+           sizeof(server->nvm->keyIdMap[TEST_USER + 1]));
+    id = WH_MAKE_KEYID(WH_KEYTYPE_CRYPTO, TEST_USER + 1, WH_KEYID_ERASED);
+    WH_TEST_ASSERT_RETURN(WH_ERROR_NOSPACE ==
+                          wh_Server_KeystoreGetUniqueId(server, &id));
+    WH_TEST_RETURN_ON_FAIL(_uniqueId(server, TEST_USER, &id));
+    memset(server->nvm->keyIdMap[TEST_USER + 1], 0,
+           sizeof(server->nvm->keyIdMap[TEST_USER + 1]));
+
+    /* A failed add stores nothing, so its ID is handed out again */
+    WH_TEST_RETURN_ON_FAIL(_uniqueId(server, TEST_USER, &id));
+    memset(&meta, 0, sizeof(meta));
+    meta.id  = id;
+    meta.len = TEST_KEY_LEN;
+    WH_TEST_ASSERT_RETURN(WH_ERROR_BADARGS ==
+                          wh_Nvm_AddObject(server->nvm, &meta, meta.len, NULL));
+    WH_TEST_RETURN_ON_FAIL(_uniqueId(server, TEST_USER, &fresh[0]));
+    WH_TEST_ASSERT_RETURN(fresh[0] == id);
+
+    for (i = 0; i < count; i++) {
+        WH_TEST_RETURN_ON_FAIL(wh_Server_KeystoreEraseKey(server, ids[i]));
+    }
+    return 0;
+}
+
+#if defined(WOLFHSM_CFG_SERVER_KEYCACHE_LRU)
+/* Use ticks restart when they wrap, keeping the order of recent uses */
+static int _testLruTickWrap(whServerContext* server)
+{
+    WH_TEST_RETURN_ON_FAIL(_cacheKey(server, TEST_KEYID(1), TEST_KEY_LEN, 1));
+    WH_TEST_RETURN_ON_FAIL(_cacheKey(server, TEST_KEYID(2), TEST_KEY_LEN, 1));
+    WH_TEST_RETURN_ON_FAIL(_fillCache(server, TEST_SLOTS - 2));
+
+    /* Key 2 is used last, on the tick that wraps. Had the tick just wrapped
+     * to 0, key 2 would look like the oldest use */
+    server->localCache.tick = UINT32_MAX - 1;
+    WH_TEST_RETURN_ON_FAIL(_touchKey(server, TEST_KEYID(1), 1));
+    WH_TEST_RETURN_ON_FAIL(_touchKey(server, TEST_KEYID(2), 1));
+
+    WH_TEST_RETURN_ON_FAIL(_cacheKey(server, TEST_KEYID(3), TEST_KEY_LEN, 0));
+    WH_TEST_ASSERT_RETURN(!_isCached(server, TEST_KEYID(1)));
+    WH_TEST_ASSERT_RETURN(_isCached(server, TEST_KEYID(2)));
+    WH_TEST_ASSERT_RETURN(server->localCache.tick < UINT32_MAX - 1);
+
+    _dropKeys(server, 1, 3);
+    _dropKeys(server, TEST_FILL_ID, TEST_SLOTS - 2);
+    return 0;
+}
+#endif /* WOLFHSM_CFG_SERVER_KEYCACHE_LRU */
+
+#if defined(WOLFHSM_CFG_SERVER_KEYCACHE_LFU)
+/* Use counts are halved on each eviction, so a key that was used often long
+ * ago is eventually evicted in favor of keys in use now */
+static int _testLfuAging(whServerContext* server)
+{
+    int i;
+
+    /* Key 1 is used 9 times, then keys 11 to 14 in turn 3 times each, with one
+     * slot for them */
+    WH_TEST_RETURN_ON_FAIL(_cacheKey(server, TEST_KEYID(1), TEST_KEY_LEN, 1));
+    WH_TEST_RETURN_ON_FAIL(_touchKey(server, TEST_KEYID(1), 8));
+    WH_TEST_RETURN_ON_FAIL(_fillCache(server, TEST_SLOTS - 2));
+
+    /* Key 1 counts 9, 4 and 2 against 3 when keys 12, 13 and 14 are cached,
+     * so it is only evicted for key 14. Without aging it would stay ahead */
+    for (i = 11; i <= 14; i++) {
+        WH_TEST_ASSERT_RETURN(_isCached(server, TEST_KEYID(1)));
+        WH_TEST_RETURN_ON_FAIL(
+            _cacheKey(server, TEST_KEYID(i), TEST_KEY_LEN, 1));
+        WH_TEST_RETURN_ON_FAIL(_touchKey(server, TEST_KEYID(i), 2));
+    }
+    WH_TEST_ASSERT_RETURN(!_isCached(server, TEST_KEYID(1)));
+    WH_TEST_ASSERT_RETURN(_isCached(server, TEST_KEYID(13)));
+    WH_TEST_ASSERT_RETURN(_isCached(server, TEST_KEYID(14)));
+
+    _dropKeys(server, 1, 1);
+    _dropKeys(server, 11, 4);
+    _dropKeys(server, TEST_FILL_ID, TEST_SLOTS - 2);
+    return 0;
+}
+#endif /* WOLFHSM_CFG_SERVER_KEYCACHE_LFU */
+
+#ifdef WOLFHSM_CFG_SERVER_KEYCACHE_POOL
+#define POOL_GRANULES(_len)                                  \
+    (((_len) + WOLFHSM_CFG_SERVER_KEYCACHE_POOL_GRANULE - 1) / \
+     WOLFHSM_CFG_SERVER_KEYCACHE_POOL_GRANULE)
+
+/* Small keys are placed from the start of the pool, large ones from the end */
+static int _testPoolPlacement(whServerContext* server)
+{
+    whKeyCacheContext* ctx = &server->localCache;
+    const uint16_t     smallLen = WOLFHSM_CFG_SERVER_KEYCACHE_BUFSIZE;
+    const uint16_t     largeLen = WOLFHSM_CFG_SERVER_KEYCACHE_BUFSIZE + 1;
+    uint8_t*           buf;
+
+    WH_TEST_RETURN_ON_FAIL(_cacheKey(server, TEST_KEYID(1), smallLen, 0));
+    WH_TEST_RETURN_ON_FAIL(_cacheKey(server, TEST_KEYID(2), largeLen, 0));
+
+    WH_TEST_RETURN_ON_FAIL(
+        wh_Server_KeystoreFreshenKey(server, TEST_KEYID(1), &buf, NULL));
+    WH_TEST_ASSERT_RETURN(buf == ctx->pool);
+
+    WH_TEST_RETURN_ON_FAIL(
+        wh_Server_KeystoreFreshenKey(server, TEST_KEYID(2), &buf, NULL));
+    WH_TEST_ASSERT_RETURN(buf + POOL_GRANULES(largeLen) *
+                                    WOLFHSM_CFG_SERVER_KEYCACHE_POOL_GRANULE ==
+                          ctx->pool + sizeof(ctx->pool));
+
+    _dropKeys(server, 1, 2);
+    return 0;
+}
+
+/* Reservations are trimmed to the length of the key written into them, and
+ * released if no key was written, before the next key is placed */
+static int _testPoolTrim(whServerContext* server)
+{
+    const uint16_t bigLen = WOLFHSM_CFG_SERVER_KEYCACHE_BIG_BUFSIZE;
+    uint8_t*       buf1;
+    uint8_t*       buf2;
+    whNvmMetadata* meta;
+
+    /* Reserve the largest size but only write one granule, as a caller
+     * serializing a key of unknown size would */
+    WH_TEST_RETURN_ON_FAIL(wh_Server_KeystoreGetCacheSlot(
+        server, TEST_KEYID(1), bigLen, &buf1, &meta));
+    meta->id     = TEST_KEYID(1);
+    meta->len    = WOLFHSM_CFG_SERVER_KEYCACHE_POOL_GRANULE;
+    meta->access = WH_NVM_ACCESS_ANY;
+
+    /* The unused tail is free again, so the next large key sits right after
+     * the written granule */
+    WH_TEST_RETURN_ON_FAIL(wh_Server_KeystoreGetCacheSlot(
+        server, TEST_KEYID(2), bigLen - WOLFHSM_CFG_SERVER_KEYCACHE_POOL_GRANULE,
+        &buf2, &meta));
+    meta->id     = TEST_KEYID(2);
+    meta->len    = bigLen - WOLFHSM_CFG_SERVER_KEYCACHE_POOL_GRANULE;
+    meta->access = WH_NVM_ACCESS_ANY;
+    WH_TEST_ASSERT_RETURN(buf2 ==
+                          buf1 + WOLFHSM_CFG_SERVER_KEYCACHE_POOL_GRANULE);
+    _dropKeys(server, 1, 2);
+
+    /* A reservation that is never written is released and its space reused */
+    WH_TEST_RETURN_ON_FAIL(wh_Server_KeystoreGetCacheSlot(
+        server, TEST_KEYID(3), bigLen, &buf1, NULL));
+    WH_TEST_RETURN_ON_FAIL(wh_Server_KeystoreGetCacheSlot(
+        server, TEST_KEYID(4), bigLen, &buf2, &meta));
+    meta->id     = TEST_KEYID(4);
+    meta->len    = bigLen;
+    meta->access = WH_NVM_ACCESS_ANY;
+    WH_TEST_ASSERT_RETURN(buf2 == buf1);
+    WH_TEST_ASSERT_RETURN(_isCached(server, TEST_KEYID(4)));
+
+    _dropKeys(server, 3, 2);
+    return 0;
+}
+
+/* A key larger than every free run is refused while nothing can be evicted,
+ * even with enough free space in total, and evicts a committed key whose
+ * space joins two runs once there is one */
+static int _testPoolFragmentation(whServerContext* server)
+{
+    const uint16_t  bigLen   = WOLFHSM_CFG_SERVER_KEYCACHE_BIG_BUFSIZE;
+    const uint16_t  chunkLen = WOLFHSM_CFG_SERVER_KEYCACHE_BIG_BUFSIZE / 2;
+    const int       chunks =
+        WH_KEYCACHE_POOL_GRANULES / POOL_GRANULES(chunkLen);
+    whKeyCacheStats stats;
+    uint8_t*        buf;
+    uint8_t*        end;
+    whNvmMetadata*  meta;
+    int             i;
+
+    /* Chunks 1 and 3 leave holes around chunk 2 */
+    WH_TEST_ASSERT_RETURN(chunks >= 4);
+    WH_TEST_ASSERT_RETURN(chunks < WOLFHSM_CFG_SERVER_KEYCACHE_POOL_KEYS);
+    WH_TEST_RETURN_ON_FAIL(wh_Server_KeystoreResetCacheStats(server, 0));
+
+    /* Fill the pool with uncommitted half size keys, placed from the end, then
+     * free every other one. No free run is as large as a big key, since
+     * the space below the last chunk is smaller than a chunk */
+    for (i = 0; i < chunks; i++) {
+        WH_TEST_RETURN_ON_FAIL(
+            _cacheKey(server, TEST_KEYID(1 + i), chunkLen, 0));
+    }
+    for (i = 1; i < chunks; i += 2) {
+        WH_TEST_RETURN_ON_FAIL(
+            wh_Server_KeystoreEvictKey(server, TEST_KEYID(1 + i)));
+    }
+    WH_TEST_ASSERT_RETURN(WH_ERROR_NOSPACE ==
+                          wh_Server_KeystoreGetCacheSlot(
+                              server, TEST_KEYID(100), bigLen, &buf, &meta));
+
+    /* Chunk 2 is the only committed key, evicting it joins the holes of
+     * chunks 1 and 3, and the big key takes the top of that run */
+    WH_TEST_RETURN_ON_FAIL(wh_Server_KeystoreCommitKey(server, TEST_KEYID(3)));
+    WH_TEST_RETURN_ON_FAIL(wh_Server_KeystoreGetCacheSlot(
+        server, TEST_KEYID(100), bigLen, &buf, &meta));
+    meta->id     = TEST_KEYID(100);
+    meta->len    = bigLen;
+    meta->access = WH_NVM_ACCESS_ANY;
+
+    WH_TEST_RETURN_ON_FAIL(wh_Server_KeystoreGetCacheStats(server, 0, &stats));
+    WH_TEST_ASSERT_RETURN(stats.evictions == 1);
+    WH_TEST_ASSERT_RETURN(!_isCached(server, TEST_KEYID(3)));
+    for (i = 0; i < chunks; i += 2) {
+        if (i != 2) {
+            WH_TEST_ASSERT_RETURN(_isCached(server, TEST_KEYID(1 + i)));
+        }
+    }
+    WH_TEST_RETURN_ON_FAIL(
+        wh_Server_KeystoreFreshenKey(server, TEST_KEYID(1), &end, NULL));
+    WH_TEST_ASSERT_RETURN(buf + POOL_GRANULES(bigLen) *
+                                    WOLFHSM_CFG_SERVER_KEYCACHE_POOL_GRANULE ==
+                          end);
+
+    _dropKeys(server, 1, chunks);
+    _dropKeys(server, 100, 1);
+    return 0;
+}
+
+/* When evicting every committed key would still leave no run large enough,
+ * the request fails without evicting any of them */
+static int _testPoolNoSpaceKeepsKeys(whServerContext* server)
+{
+    const uint16_t  bigLen   = WOLFHSM_CFG_SERVER_KEYCACHE_BIG_BUFSIZE;
+    const uint16_t  chunkLen = WOLFHSM_CFG_SERVER_KEYCACHE_BIG_BUFSIZE / 2;
+    const int       chunks =
+        WH_KEYCACHE_POOL_GRANULES / POOL_GRANULES(chunkLen);
+    whKeyCacheStats stats;
+    uint8_t*        buf;
+    whNvmMetadata*  meta;
+    int             i;
+
+    WH_TEST_ASSERT_RETURN(chunks >= 4);
+    WH_TEST_ASSERT_RETURN(chunks < WOLFHSM_CFG_SERVER_KEYCACHE_POOL_KEYS);
+    WH_TEST_RETURN_ON_FAIL(wh_Server_KeystoreResetCacheStats(server, 0));
+
+    /* Fill the pool with half size keys and commit every other one, so each
+     * committed key sits between keys that cannot be evicted */
+    for (i = 0; i < chunks; i++) {
+        WH_TEST_RETURN_ON_FAIL(
+            _cacheKey(server, TEST_KEYID(1 + i), chunkLen, i & 1));
+    }
+    WH_TEST_ASSERT_RETURN(WH_ERROR_NOSPACE ==
+                          wh_Server_KeystoreGetCacheSlot(
+                              server, TEST_KEYID(100), bigLen, &buf, &meta));
+
+    WH_TEST_RETURN_ON_FAIL(wh_Server_KeystoreGetCacheStats(server, 0, &stats));
+    WH_TEST_ASSERT_RETURN(stats.evictions == 0);
+    for (i = 0; i < chunks; i++) {
+        WH_TEST_ASSERT_RETURN(_isCached(server, TEST_KEYID(1 + i)));
+    }
+
+    /* A key that fits in one committed key's space evicts only that one */
+    WH_TEST_RETURN_ON_FAIL(wh_Server_KeystoreGetCacheSlot(
+        server, TEST_KEYID(100), chunkLen, &buf, &meta));
+    meta->id     = TEST_KEYID(100);
+    meta->len    = chunkLen;
+    meta->access = WH_NVM_ACCESS_ANY;
+    WH_TEST_RETURN_ON_FAIL(wh_Server_KeystoreGetCacheStats(server, 0, &stats));
+    WH_TEST_ASSERT_RETURN(stats.evictions == 1);
+
+    _dropKeys(server, 1, chunks);
+    _dropKeys(server, 100, 1);
+    return 0;
+}
+#endif /* WOLFHSM_CFG_SERVER_KEYCACHE_POOL */
+
+#if !defined(NO_RSA) && defined(WOLFSSL_KEY_GEN)
+/* Caching an RSA key reserves the DER size wolfCrypt reports for it rather
+ * than the largest slot. With the pool it fits in free space smaller than a
+ * big key, while no key can be evicted to make more room */
+static int _testCacheRsaKeySize(whServerContext* server)
+{
+    RsaKey         key[1];
+    RsaKey         exported[1];
+    whNvmMetadata* meta = NULL;
+    uint8_t*       buf  = NULL;
+    int            need = 0;
+    int            fill = 0;
+    int            ret;
+#ifdef WOLFHSM_CFG_SERVER_KEYCACHE_POOL
+    const uint16_t chunkLen = WOLFHSM_CFG_SERVER_KEYCACHE_BIG_BUFSIZE / 2;
+    int            freeRun  = WH_KEYCACHE_POOL_GRANULES;
+#endif
+
+    WH_TEST_RETURN_ON_FAIL(wc_InitRsaKey_ex(key, NULL, INVALID_DEVID));
+    ret = wc_MakeRsaKey(key, 2048, WC_RSA_EXPONENT, server->crypto->rng);
+    if (ret == 0) {
+        need = wc_RsaKeyToDer(key, NULL, 0);
+        if (need <= 0) {
+            ret = WH_ERROR_ABORTED;
+        }
+    }
+
+#ifdef WOLFHSM_CFG_SERVER_KEYCACHE_POOL
+    /* Fill the end of the pool with uncommitted keys, leaving a free run that
+     * holds the RSA key but not a big key */
+    while ((ret == 0) &&
+           (freeRun - POOL_GRANULES(chunkLen) >= POOL_GRANULES(need))) {
+        ret = _cacheKey(server, TEST_KEYID(1 + fill), chunkLen, 0);
+        fill++;
+        freeRun -= POOL_GRANULES(chunkLen);
+    }
+    if ((ret == 0) &&
+        (freeRun >= POOL_GRANULES(WOLFHSM_CFG_SERVER_KEYCACHE_BIG_BUFSIZE))) {
+        ret = WH_ERROR_ABORTED;
+    }
+#endif
+
+    if (ret == 0) {
+        ret = wh_Server_CacheImportRsaKey(server, key, TEST_KEYID(100),
+                                          WH_NVM_FLAGS_NONE, 0, NULL);
+    }
+    if (ret == 0) {
+        ret = wh_Server_KeystoreFreshenKey(server, TEST_KEYID(100), &buf,
+                                           &meta);
+    }
+    if ((ret == 0) && (meta->len != (uint16_t)need)) {
+        ret = WH_ERROR_ABORTED;
+    }
+
+    /* The cached key reads back */
+    if (ret == 0) {
+        ret = wc_InitRsaKey_ex(exported, NULL, INVALID_DEVID);
+        if (ret == 0) {
+            ret = wh_Server_CacheExportRsaKey(server, TEST_KEYID(100),
+                                              exported);
+            if ((ret == 0) && (wc_RsaKeyToDer(exported, NULL, 0) != need)) {
+                ret = WH_ERROR_ABORTED;
+            }
+            (void)wc_FreeRsaKey(exported);
+        }
+    }
+
+    (void)wc_FreeRsaKey(key);
+    _dropKeys(server, 1, fill);
+    _dropKeys(server, 100, 1);
+    if (ret != 0) {
+        WH_ERROR_PRINT("RSA key cache size test failed: %d\n", ret);
+    }
+    return ret;
+}
+#endif /* !NO_RSA && WOLFSSL_KEY_GEN */
+
+#if defined(WOLFHSM_CFG_SERVER_KEYCACHE_PARSED) && defined(HAVE_ECC)
+/* The decoded object of a cached key is reused until the key is cached again
+ * or evicted */
+static int _testParsedKey(whServerContext* server)
+{
+    ecc_key  key[1];
+    void*    first  = NULL;
+    void*    second = NULL;
+    uint32_t gen    = 0;
+    int      ret;
+    int      i;
+
+    WH_TEST_RETURN_ON_FAIL(wc_ecc_init_ex(key, NULL, INVALID_DEVID));
+    ret = wc_ecc_make_key(server->crypto->rng, 32, key);
+    if (ret == 0) {
+        ret = wh_Server_EccKeyCacheImport(server, key, TEST_KEYID(1),
+                                          WH_NVM_FLAGS_NONE, 0, NULL);
+    }
+
+    /* Decoded once, then the same object is returned */
+    if (ret == 0) {
+        ret = wh_Server_ParsedKeyGet(server, TEST_KEYID(1),
+                                     WH_SERVER_PARSEDKEY_ECC, INVALID_DEVID,
+                                     &first);
+    }
+    if (ret == 0) {
+        ret = wh_Server_ParsedKeyGet(server, TEST_KEYID(1),
+                                     WH_SERVER_PARSEDKEY_ECC, INVALID_DEVID,
+                                     &second);
+    }
+    if ((ret == 0) && ((first == NULL) || (first != second) ||
+                       (server->parsedKey[0].id != TEST_KEYID(1)))) {
+        ret = WH_ERROR_ABORTED;
+    }
+    if ((ret == 0) && (WH_ERROR_BADARGS !=
+                       wh_Server_ParsedKeyGet(server, TEST_KEYID(1),
+                                              WH_SERVER_PARSEDKEY_ECC,
+                                              INVALID_DEVID, NULL))) {
+        ret = WH_ERROR_ABORTED;
+    }
+    gen = server->parsedKey[0].gen;
+
+    /* Caching the key again decodes the new bytes */
+    if (ret == 0) {
+        ret = wh_Server_EccKeyCacheImport(server, key, TEST_KEYID(1),
+                                          WH_NVM_FLAGS_NONE, 0, NULL);
+    }
+    if (ret == 0) {
+        ret = wh_Server_ParsedKeyGet(server, TEST_KEYID(1),
+                                     WH_SERVER_PARSEDKEY_ECC, INVALID_DEVID,
+                                     &second);
+    }
+    if ((ret == 0) && ((server->parsedKey[0].id != TEST_KEYID(1)) ||
+                       (server->parsedKey[0].gen == gen))) {
+        ret = WH_ERROR_ABORTED;
+    }
+
+    /* Evicting the key drops its decoded object */
+    if (ret == 0) {
+        ret = wh_Server_KeystoreEvictKey(server, TEST_KEYID(1));
+    }
+    for (i = 0; (ret == 0) && (i < WOLFHSM_CFG_SERVER_KEYCACHE_PARSED_COUNT);
+         i++) {
+        if (server->parsedKey[i].id == TEST_KEYID(1)) {
+            ret = WH_ERROR_ABORTED;
+        }
+    }
+
+    (void)wc_ecc_free(key);
+    _dropKeys(server, 1, 1);
+    if (ret != 0) {
+        WH_ERROR_PRINT("Parsed key test failed: %d\n", ret);
+    }
+    return ret;
+}
+#endif /* WOLFHSM_CFG_SERVER_KEYCACHE_PARSED && HAVE_ECC */
+
+int whTest_Keystore(void)
+{
+    int ret = 0;
+
+    /* Transport memory configuration, unused by the server tests */
+    static uint8_t       req[BUFFER_SIZE];
+    static uint8_t       resp[BUFFER_SIZE];
+    whTransportMemConfig tmcf[1] = {{
+        .req       = (whTransportMemCsr*)req,
+        .req_size  = sizeof(req),
+        .resp      = (whTransportMemCsr*)resp,
+        .resp_size = sizeof(resp),
+    }};
+
+    /* RamSim Flash backed NVM */
+    static uint8_t   memory[FLASH_RAM_SIZE] = {0};
+    whFlashRamsimCtx fc[1]                  = {0};
+    whFlashRamsimCfg fc_conf[1]             = {{
+                    .size       = FLASH_RAM_SIZE,
+                    .sectorSize = FLASH_SECTOR_SIZE,
+                    .pageSize   = FLASH_PAGE_SIZE,
+                    .erasedByte = ~(uint8_t)0,
+                    .memory     = memory,
+    }};
+    const whFlashCb  fcb[1]                 = {WH_FLASH_RAMSIM_CB};
+
+    whNvmFlashConfig  nf_conf[1] = {{
+         .cb      = fcb,
+         .context = fc,
+         .config  = fc_conf,
+    }};
+    whNvmFlashContext nfc[1]     = {0};
+    whNvmCb           nfcb[1]    = {WH_NVM_FLASH_CB};
+
+    whNvmConfig         n_conf[1] = {{
+                .cb      = nfcb,
+                .context = nfc,
+                .config  = nf_conf,
+    }};
+    static whNvmContext nvm[1];
+
+    whServerCryptoContext crypto[1] = {0};
+
+    whTransportServerCb         tscb[1]    = {WH_TRANSPORT_MEM_SERVER_CB};
+    whTransportMemServerContext tmsc[1]    = {0};
+    whCommServerConfig          cs_conf[1] = {{
+                 .transport_cb      = tscb,
+                 .transport_context = (void*)tmsc,
+                 .transport_config  = (void*)tmcf,
+                 .server_id         = 103,
+    }};
+    whServerConfig              s_conf[1]  = {{
+                      .comm_config = cs_conf,
+                      .nvm         = nvm,
+                      .crypto      = crypto,
+    }};
+    static whServerContext      server[1];
+
+    memset(nvm, 0, sizeof(nvm));
+    memset(server, 0, sizeof(server));
+
+    WH_TEST_RETURN_ON_FAIL(wolfCrypt_Init());
+    WH_TEST_RETURN_ON_FAIL(wh_Nvm_Init(nvm, n_conf));
+    WH_TEST_RETURN_ON_FAIL(wc_InitRng_ex(crypto->rng, NULL, INVALID_DEVID));
+    WH_TEST_RETURN_ON_FAIL(wh_Server_Init(server, s_conf));
+
+    WH_TEST_PRINT("Testing server keystore...\n");
+    ret = _testEvictionPolicy(server);
+    if (ret == 0) {
+        ret = _testUniqueIds(server, n_conf, fc_conf);
+    }
+    if (ret == 0) {
+        ret = _testIndexCollisions(server);
+    }
+#if defined(WOLFHSM_CFG_SERVER_KEYCACHE_LRU)
+    if (ret == 0) {
+        ret = _testLruTickWrap(server);
+    }
+#elif defined(WOLFHSM_CFG_SERVER_KEYCACHE_LFU)
+    if (ret == 0) {
+        ret = _testLfuAging(server);
+    }
+#endif
+#ifdef WOLFHSM_CFG_SERVER_KEYCACHE_POOL
+    if (ret == 0) {
+        ret = _testPoolPlacement(server);
+    }
+    if (ret == 0) {
+        ret = _testPoolTrim(server);
+    }
+    if (ret == 0) {
+        ret = _testPoolFragmentation(server);
+    }
+    if (ret == 0) {
+        ret = _testPoolNoSpaceKeepsKeys(server);
+    }
+#endif
+#if !defined(NO_RSA) && defined(WOLFSSL_KEY_GEN)
+    if (ret == 0) {
+        ret = _testCacheRsaKeySize(server);
+    }
+#endif
+#if defined(WOLFHSM_CFG_SERVER_KEYCACHE_PARSED) && defined(HAVE_ECC)
+    if (ret == 0) {
+        ret = _testParsedKey(server);
+    }
+#endif
+
+    wh_Server_Cleanup(server);
+    wc_FreeRng(crypto->rng);
+    wh_Nvm_Cleanup(nvm);
+    wolfCrypt_Cleanup();
+
+    return ret;
+}
+
+#endif /* WOLFHSM_CFG_ENABLE_SERVER && !WOLFHSM_CFG_NO_CRYPTO */
@@ -0,0 +1,32 @@
+/*
+ * Copyright (C) 2025 wolfSSL Inc.
+ *
+ * This file is part of wolfHSM.
+ *
+ * wolfHSM is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * wolfHSM is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with wolfHSM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/*
+ * test/wh_test_keystore.h
+ *
+ */
+
+#ifndef WH_TEST_KEYSTORE_H
+#define WH_TEST_KEYSTORE_H
+
+#include "wh_test_common.h"
+
+/* Server key cache tests, run directly against a server context */
+int whTest_Keystore(void);
+
+#endif /* WH_TEST_KEYSTORE_H */
@@ -428,6 +428,71 @@ static int _testGlobalKeyExportProtection(whClientContext* client1,
     return 0;
 }
 
+#if WOLFHSM_CFG_SERVER_KEYCACHE_PIN_MAX > 0
+/*
+ * Global key pins are released on disconnect
+ * - Client 1 caches, commits and pins a global key
+ * - Client 2 fails to pin the key while client 1 holds the pin
+ * - Client 1 disconnects, which releases its pins in the global cache
+ * - Client 2 can now pin the key
+ */
+static int _testGlobalKeyPinDisconnect(whClientContext* client1,
+                                       whServerContext* server1,
+                                       whClientContext* client2,
+                                       whServerContext* server2)
+{
+    int     ret;
+    whKeyId keyId = WH_CLIENT_KEYID_MAKE_GLOBAL(DUMMY_KEYID_1);
+
+    WH_TEST_PRINT("Test: Global key pins released on disconnect\n");
+
+    /* Client 1 caches, commits and pins a global key */
+    WH_TEST_RETURN_ON_FAIL(wh_Client_KeyCacheRequest_ex(
+        client1, 0, (uint8_t*)"GlobalPin", sizeof("GlobalPin"),
+        (uint8_t*)TEST_KEY_DATA_1, sizeof(TEST_KEY_DATA_1), keyId));
+    WH_TEST_RETURN_ON_FAIL(wh_Server_HandleRequestMessage(server1));
+    WH_TEST_RETURN_ON_FAIL(wh_Client_KeyCacheResponse(client1, &keyId));
+
+    keyId = WH_CLIENT_KEYID_MAKE_GLOBAL(DUMMY_KEYID_1);
+    WH_TEST_RETURN_ON_FAIL(wh_Client_KeyCommitRequest(client1, keyId));
+    WH_TEST_RETURN_ON_FAIL(wh_Server_HandleRequestMessage(server1));
+    WH_TEST_RETURN_ON_FAIL(wh_Client_KeyCommitResponse(client1));
+
+    WH_TEST_RETURN_ON_FAIL(wh_Client_KeyPinRequest(client1, keyId, 1));
+    WH_TEST_RETURN_ON_FAIL(wh_Server_HandleRequestMessage(server1));
+    WH_TEST_RETURN_ON_FAIL(wh_Client_KeyPinResponse(client1));
+
+    /* Client 2 cannot take over client 1's pin */
+    WH_TEST_RETURN_ON_FAIL(wh_Client_KeyPinRequest(client2, keyId, 1));
+    WH_TEST_RETURN_ON_FAIL(wh_Server_HandleRequestMessage(server2));
+    ret = wh_Client_KeyPinResponse(client2);
+    WH_TEST_ASSERT_RETURN(ret == WH_ERROR_ACCESS);
+
+    /* Client 1 disconnects and reconnects, dropping its pins */
+    WH_TEST_RETURN_ON_FAIL(
+        wh_Server_SetConnected(server1, WH_COMM_DISCONNECTED));
+    WH_TEST_RETURN_ON_FAIL(wh_Server_SetConnected(server1, WH_COMM_CONNECTED));
+
+    /* Client 2 can now pin and unpin the key */
+    WH_TEST_RETURN_ON_FAIL(wh_Client_KeyPinRequest(client2, keyId, 1));
+    WH_TEST_RETURN_ON_FAIL(wh_Server_HandleRequestMessage(server2));
+    WH_TEST_RETURN_ON_FAIL(wh_Client_KeyPinResponse(client2));
+
+    WH_TEST_RETURN_ON_FAIL(wh_Client_KeyPinRequest(client2, keyId, 0));
+    WH_TEST_RETURN_ON_FAIL(wh_Server_HandleRequestMessage(server2));
+    WH_TEST_RETURN_ON_FAIL(wh_Client_KeyPinResponse(client2));
+
+    /* Clean up */
+    WH_TEST_RETURN_ON_FAIL(wh_Client_KeyEraseRequest(client1, keyId));
+    WH_TEST_RETURN_ON_FAIL(wh_Server_HandleRequestMessage(server1));
+    WH_TEST_RETURN_ON_FAIL(wh_Client_KeyEraseResponse(client1));
+
+    WH_TEST_PRINT("  PASS: Global key pins released on disconnect\n");
+
+    return 0;
+}
+#endif /* WOLFHSM_CFG_SERVER_KEYCACHE_PIN_MAX > 0 */
+
 #ifdef WOLFHSM_CFG_DMA
 /*
  * Test 6: DMA operations with global keys
@@ -1368,6 +1433,11 @@ static int _runGlobalKeysTests(whClientContext* client1,
     WH_TEST_RETURN_ON_FAIL(
         _testGlobalKeyExportProtection(client1, server1, client2, server2));
 
+#if WOLFHSM_CFG_SERVER_KEYCACHE_PIN_MAX > 0
+    WH_TEST_RETURN_ON_FAIL(
+        _testGlobalKeyPinDisconnect(client1, server1, client2, server2));
+#endif
+
 #ifdef WOLFHSM_CFG_DMA
     WH_TEST_RETURN_ON_FAIL(
         _testGlobalKeyDma(client1, server1, client2, server2));
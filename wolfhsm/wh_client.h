@@ -52,6 +52,9 @@
 #ifdef WOLFHSM_CFG_DMA
 #include "wolfhsm/wh_dma.h"
 #endif /* WOLFHSM_CFG_DMA */
+#ifdef WOLFHSM_CFG_BATCH
+#include "wolfhsm/wh_message_batch.h"
+#endif /* WOLFHSM_CFG_BATCH */
 #include "wolfhsm/wh_keyid.h"
 
 
@@ -104,6 +107,106 @@ typedef struct {
 } whClientDmaContext;
 #endif /* WOLFHSM_CFG_DMA */
 
+#ifdef WOLFHSM_CFG_CLIENT_PIPELINE
+/** Pipelined request completion callback
+ *
+ * Invoked from wh_Client_PipelinePoll() when the response matching a
+ * pipelined request arrives. rc is 0 for a valid response, or
+ * WH_ERROR_ABORTED if the response is not in native byte order or answers a
+ * different action, in which case size is 0 and data is NULL. As with
+ * wh_Client_RecvResponse(), valid responses use the native magic, which the
+ * callback passes on to the message translation functions. The data pointer
+ * references the comm buffer and is only valid for the duration of the
+ * callback. A non-zero return value is propagated back to the caller of
+ * wh_Client_PipelinePoll().
+ */
+typedef int (*whClientPipelineCb)(struct whClientContext_t* c, void* cb_arg,
+                                  int rc, uint16_t magic, uint16_t group,
+                                  uint16_t action, uint16_t seq, uint16_t size,
+                                  const void* data);
+
+/* Outstanding pipelined request */
+typedef struct {
+    whClientPipelineCb cb;
+    void*              cb_arg;
+    uint16_t           seq;
+    uint16_t           kind;
+    uint8_t            in_use;
+    uint8_t            WH_PAD[3];
+} whClientPipelineEntry;
+
+/* Completion table for pipelined requests */
+typedef struct {
+    whClientPipelineEntry entry[WOLFHSM_CFG_CLIENT_PIPELINE_DEPTH];
+    uint16_t              count;
+    uint8_t               WH_PAD[6];
+} whClientPipeline;
+#endif /* WOLFHSM_CFG_CLIENT_PIPELINE */
+
+#ifdef WOLFHSM_CFG_CLIENT_WAIT
+/** Client wait policy
+ *
+ * Blocking client functions poll for the response until it arrives, calling
+ * wh_Client_WaitStep() after each poll that finds no response.  The first
+ * spin_count steps spin, returning at once.  The next yield_count steps call
+ * the yield callback before returning.  Later steps block in the transport
+ * Wait callback for up to block_us, or yield if the transport cannot block or
+ * block_us is 0.  The
+ * policy is selected by the class of the outstanding request, so short
+ * operations keep their latency and long operations stop using a full core.
+ */
+typedef enum {
+    WH_CLIENT_WAIT_CLASS_SHORT = 0, /* Hash, cipher, MAC, RNG, NVM, keystore */
+    WH_CLIENT_WAIT_CLASS_LONG,      /* Public key and certificate operations */
+    WH_CLIENT_WAIT_CLASS_COUNT
+} whClientWaitClass;
+
+typedef struct {
+    uint32_t spin_count;  /* Polls that return without waiting */
+    uint32_t yield_count; /* Following polls that yield before returning */
+    uint32_t block_us;    /* Max time later polls block. 0 to keep yielding */
+} whClientWaitPolicy;
+
+/* Yield the CPU to other threads, such as sched_yield() */
+typedef void (*whClientYieldCb)(void* arg);
+
+typedef struct {
+    whClientWaitPolicy policy[WH_CLIENT_WAIT_CLASS_COUNT];
+    whClientYieldCb    yield_cb;  /* Optional. Without it, yielding spins */
+    void*              yield_arg;
+} whClientWaitConfig;
+
+/* Wait policies and progress of the outstanding request */
+typedef struct {
+    whClientWaitPolicy policy[WH_CLIENT_WAIT_CLASS_COUNT];
+    whClientYieldCb    yield_cb;
+    void*              yield_arg;
+    uint32_t           polls;      /* Polls without a response */
+    uint8_t            wait_class; /* Class of the outstanding request */
+    uint8_t            WH_PAD[3];
+} whClientWait;
+#endif /* WOLFHSM_CFG_CLIENT_WAIT */
+
+#ifdef WOLFHSM_CFG_CANCEL_API
+/* Deliver a cancel of the request with sequence number seq to the server out
+ * of band, for example by writing seq to a shared register and raising an
+ * interrupt. The server application passes it to
+ * wh_Server_SetCanceledSequence(). Not needed with transports that have their
+ * own out of band cancel, such as the memory and POSIX shared memory
+ * transports */
+typedef int (*whClientCancelCb)(void* arg, uint16_t seq);
+#endif /* WOLFHSM_CFG_CANCEL_API */
+
+#ifdef WOLFHSM_CFG_BATCH
+/* State of the batch being built or the last batch response received */
+typedef struct {
+    whMessageBatch_Layout layout;
+    uint16_t              resp_size;  /* Size of the received response */
+    uint16_t              resp_count; /* Items in the received response */
+    uint8_t               WH_PAD[4];
+} whClientBatch;
+#endif /* WOLFHSM_CFG_BATCH */
+
 /* Client context */
 struct whClientContext_t {
     uint16_t     last_req_id;
@@ -112,6 +215,19 @@ struct whClientContext_t {
 #ifdef WOLFHSM_CFG_DMA
     whClientDmaContext dma;
 #endif /* WOLFHSM_CFG_DMA */
+#ifdef WOLFHSM_CFG_CLIENT_PIPELINE
+    whClientPipeline pipeline;
+#endif /* WOLFHSM_CFG_CLIENT_PIPELINE */
+#ifdef WOLFHSM_CFG_BATCH
+    whClientBatch batch;
+#endif /* WOLFHSM_CFG_BATCH */
+#ifdef WOLFHSM_CFG_CLIENT_WAIT
+    whClientWait wait;
+#endif /* WOLFHSM_CFG_CLIENT_WAIT */
+#ifdef WOLFHSM_CFG_CANCEL_API
+    whClientCancelCb cancelCb;
+    void*            cancelArg;
+#endif /* WOLFHSM_CFG_CANCEL_API */
     whCommClient comm[1];
 };
 
@@ -120,6 +236,13 @@ struct whClientConfig_t {
 #ifdef WOLFHSM_CFG_DMA
     whClientDmaConfig* dmaConfig;
 #endif /* WOLFHSM_CFG_DMA */
+#ifdef WOLFHSM_CFG_CLIENT_WAIT
+    const whClientWaitConfig* waitConfig; /* Optional. NULL for defaults */
+#endif /* WOLFHSM_CFG_CLIENT_WAIT */
+#ifdef WOLFHSM_CFG_CANCEL_API
+    whClientCancelCb cancelCb;  /* Optional. NULL if requests can't be canceled */
+    void*            cancelArg; /* Passed to cancelCb */
+#endif /* WOLFHSM_CFG_CANCEL_API */
 };
 typedef struct whClientConfig_t whClientConfig;
 
@@ -144,7 +267,9 @@ int wh_Client_Init(whClientContext* c, const whClientConfig* config);
  * needed
  *
  * @param c A pointer to the whClientContext structure to be cleaned up.
- * @return Returns 0 on success, or a negative value on failure.
+ * @return Returns 0 on success, WH_ERROR_NOTREADY if the client is still
+ * usable because its transport must deliver a response first, such as a
+ * session sharing a connection, or a negative value on failure.
  */
 int wh_Client_Cleanup(whClientContext* c);
 
@@ -164,6 +289,47 @@ int wh_Client_Cleanup(whClientContext* c);
  */
 int wh_Client_SendRequest(whClientContext* c, uint16_t group, uint16_t action,
                           uint16_t data_size, const void* data);
+
+/**
+ * @brief Sends a request gathered from several buffers.
+ *
+ * As wh_Client_SendRequest(), but the request data is the concatenation of
+ * iov_count buffers. On a fragmenting channel the request may carry up to
+ * wh_CommClient_GetMaxDataLen() bytes, and the buffers that do not fit in the
+ * comm buffer are sent from where they are, so they must stay valid until the
+ * response has been received.
+ *
+ * @param c The client context.
+ * @param group The group identifier.
+ * @param action The action identifier.
+ * @param iov_count The number of entries in iov.
+ * @param iov The buffers to send in order.
+ * @return Returns 0 on success, or a negative value on failure.
+ */
+int wh_Client_SendRequestV(whClientContext* c, uint16_t group,
+                           uint16_t action, uint16_t iov_count,
+                           const whCommIoVec* iov);
+
+/**
+ * @brief Sends a request to the server without a response.
+ *
+ * The request is marked with WH_COMM_AUX_REQ_NORESP, so the server processes
+ * it but does not send a response and the result is not reported.  Do not
+ * call wh_Client_RecvResponse() for this request.  This function does not
+ * block.
+ *
+ * @param c The client context.
+ * @param group The group identifier.
+ * @param action The action identifier.
+ * @param data_size The size of the data to be sent.
+ * @param data A pointer to the data to be sent. NULL is allowed in the case of
+ * zero-sized data.
+ * @return Returns 0 on success, WH_ERROR_NOTREADY if the transport is busy or
+ * pipelined requests are outstanding, or a negative value on failure.
+ */
+int wh_Client_SendRequestNoResp(whClientContext* c, uint16_t group,
+                                uint16_t action, uint16_t data_size,
+                                const void* data);
 /**
  * Receives a response from the server and extracts the group, action, size, and
  * data.
@@ -173,11 +339,295 @@ int wh_Client_SendRequest(whClientContext* c, uint16_t group, uint16_t action,
  * @param out_action Pointer to store the received action value.
  * @param out_size Pointer to store the received size value.
  * @param data Pointer to store the received data.
- * @return 0 if successful, a negative value if an error occurred.
+ * @return 0 if successful, WH_ERROR_CANCEL if the server canceled the request,
+ * or a negative value if an error occurred.
  */
 int wh_Client_RecvResponse(whClientContext* c, uint16_t* out_group,
                            uint16_t* out_action, uint16_t* out_size,
                            void* data);
+
+/**
+ * @brief Receives a response into two buffers.
+ *
+ * As wh_Client_RecvResponse(), but the response data fills data_size bytes of
+ * data and then up to ext_size bytes of ext. On a fragmenting channel the
+ * response may carry up to wh_CommClient_GetMaxDataLen() bytes, which are
+ * copied into the buffers as they arrive.
+ *
+ * @param c The client context.
+ * @param out_group Pointer to store the received group value.
+ * @param out_action Pointer to store the received action value.
+ * @param out_size Pointer to store the total size of the received data.
+ * @param data_size The size of data.
+ * @param data Buffer for the start of the response data.
+ * @param ext_size The size of ext.
+ * @param ext Buffer for the rest of the response data.
+ * @return 0 if successful, WH_ERROR_ABORTED if the response does not fit,
+ * WH_ERROR_CANCEL if the server canceled the request, or a negative value if
+ * an error occurred.
+ */
+int wh_Client_RecvResponseExt(whClientContext* c, uint16_t* out_group,
+                              uint16_t* out_action, uint16_t* out_size,
+                              uint16_t data_size, void* data,
+                              uint16_t ext_size, void* ext);
+
+/**
+ * @brief Waits once after a poll for a response returned WH_ERROR_NOTREADY.
+ *
+ * Blocking client functions call this between polls of a response function.
+ * With WOLFHSM_CFG_CLIENT_WAIT, it applies the wait policy of the outstanding
+ * request, so it may spin, yield or block in the transport. Otherwise it
+ * returns at once. The non-blocking response functions never wait.
+ *
+ * @param c The client context.
+ * @return Returns 0 to poll again, or WH_ERROR_BADARGS if c is NULL.
+ */
+int wh_Client_WaitStep(whClientContext* c);
+
+#ifdef WOLFHSM_CFG_CANCEL_API
+/** Request cancellation
+ *
+ * The outstanding request can be canceled when it is no longer needed, such as
+ * after wh_Client_RecvResponse() returned WH_ERROR_TIMEOUT. The cancel is
+ * delivered through the cancelCb of the client configuration or, without one,
+ * through the transport. The memory and POSIX shared memory transports mark
+ * the request canceled in the request control register, which the server
+ * reads at each cancel check. The server
+ * answers a canceled request with a cancel response instead of its normal
+ * response, so receiving either one leaves the channel in step for the next
+ * request. Pipelined requests cannot be canceled.
+ *
+ * The cancel is not sent as a message on the request channel. The server does
+ * not read that channel while it handles a request, and transports with a
+ * single request buffer cannot take a second message until the response is
+ * read, so an in-band cancel would only arrive once the request had finished.
+ * The server checks for a cancel before it dispatches a request, between the
+ * sub-requests of a batch and between chunks of DMA hash input. Any other
+ * operation runs to completion once started. In particular, key generation
+ * and signing cannot be canceled once the server has started them. A cancel
+ * sent while one runs is late: wh_Client_CancelResponse() returns
+ * WH_ERROR_CANCEL_LATE and discards the result, and any key the server
+ * generated and cached remains in its cache.
+ */
+
+/**
+ * @brief Sends a cancel for the outstanding request.
+ *
+ * Restarts the response timeout, if enabled, so the cancel response can be
+ * awaited. This function does not block.
+ *
+ * @param c The client context.
+ * @return Returns 0 on success, WH_ERROR_BADARGS if pipelined requests are
+ * outstanding, WH_ERROR_NOTIMPL if there is no cancelCb and the transport has
+ * no out of band cancel, or the error returned by cancelCb or the transport.
+ */
+int wh_Client_CancelRequest(whClientContext* c);
+
+/**
+ * @brief Receives the response to a canceled request.
+ *
+ * Consumes either the cancel response or, if the request completed first, its
+ * normal response. This function does not block.
+ *
+ * @param c The client context.
+ * @return Returns 0 if the server canceled the request, WH_ERROR_CANCEL_LATE if
+ * the request completed before the cancel and its response was discarded,
+ * WH_ERROR_NOTREADY if no response has arrived, or a negative value on failure.
+ */
+int wh_Client_CancelResponse(whClientContext* c);
+
+/**
+ * @brief Cancels the outstanding request and waits for its response.
+ *
+ * @param c The client context.
+ * @return See wh_Client_CancelRequest() and wh_Client_CancelResponse().
+ */
+int wh_Client_Cancel(whClientContext* c);
+#endif /* WOLFHSM_CFG_CANCEL_API */
+
+#ifdef WOLFHSM_CFG_CLIENT_WAIT
+/**
+ * @brief Sets the wait policy of a class of operations.
+ *
+ * Replaces the policy set from whClientConfig.waitConfig, or the
+ * WOLFHSM_CFG_CLIENT_WAIT_* defaults, for requests sent afterwards.
+ *
+ * @param c The client context.
+ * @param wait_class The class of operations, such as
+ * WH_CLIENT_WAIT_CLASS_LONG.
+ * @param policy The new wait policy.
+ * @return Returns 0 on success, or WH_ERROR_BADARGS if the arguments are
+ * invalid.
+ */
+int wh_Client_SetWaitPolicy(whClientContext* c, whClientWaitClass wait_class,
+                            const whClientWaitPolicy* policy);
+#endif /* WOLFHSM_CFG_CLIENT_WAIT */
+
+#ifdef WOLFHSM_CFG_CLIENT_PIPELINE
+/** Pipelined request functions
+ *
+ * Pipelined requests allow a client to have up to
+ * WOLFHSM_CFG_CLIENT_PIPELINE_DEPTH requests outstanding at once.  Each
+ * request is recorded in a completion table keyed by its sequence number, and
+ * responses are matched back to their request as they arrive, regardless of
+ * order.  The transport must be able to buffer more than one request, such as
+ * the multi-slot ring mode of the memory transport.  While any pipelined
+ * request is outstanding, the regular (non-pipelined) request functions return
+ * WH_ERROR_BADARGS.  On a fragmenting channel, pipelined requests and their
+ * responses must each fit in one fragment, as fragments are acked one at a
+ * time.  A request that needs more is only sent once the pipeline is empty.
+ */
+
+/**
+ * @brief Sends a pipelined request to the server.
+ *
+ * The request is sent and its completion callback is recorded. This function
+ * does not block.
+ *
+ * @param[in] c Pointer to the client context.
+ * @param[in] group The group identifier.
+ * @param[in] action The action identifier.
+ * @param[in] data_size The size of the data to be sent.
+ * @param[in] data A pointer to the data to be sent.
+ * @param[in] cb Completion callback invoked when the response arrives. May be
+ * NULL to discard the response.
+ * @param[in] cb_arg Opaque argument passed to the callback.
+ * @param[out] out_seq Optional pointer to store the request sequence number.
+ * @return int Returns 0 on success, WH_ERROR_NOTREADY if the completion table
+ * or the transport is full, or while other requests are outstanding on a
+ * fragmenting channel if this request needs more than one fragment or a
+ * fragmented exchange is in progress, or a negative error code on failure.
+ */
+int wh_Client_PipelineSendRequest(whClientContext* c, uint16_t group,
+                                  uint16_t action, uint16_t data_size,
+                                  const void* data, whClientPipelineCb cb,
+                                  void* cb_arg, uint16_t* out_seq);
+
+/**
+ * @brief Processes a single pipelined response, if one is available.
+ *
+ * Receives one response, matches it against the completion table by sequence
+ * number, releases the table entry and invokes the completion callback. This
+ * function does not block.
+ *
+ * @param[in] c Pointer to the client context.
+ * @return int Returns 0 if a response was processed, WH_ERROR_NOTREADY if no
+ * response is available, WH_ERROR_ABORTED if the response does not match an
+ * outstanding request, the callback return value if non-zero, or a negative
+ * error code on failure. An invalid response to an outstanding request is
+ * reported to its callback, or returned as WH_ERROR_ABORTED if it has none.
+ */
+int wh_Client_PipelinePoll(whClientContext* c);
+
+/**
+ * @brief Processes pipelined responses until none are outstanding.
+ *
+ * This function blocks until every outstanding pipelined request has been
+ * completed or an error occurs. It calls wh_Client_WaitStep() between polls
+ * that find no response. The wait policy is that of the longest class among
+ * the requests sent since the pipeline was last empty.
+ *
+ * @param[in] c Pointer to the client context.
+ * @return int Returns 0 on success, or a negative error code on failure.
+ */
+int wh_Client_PipelineDrain(whClientContext* c);
+
+/**
+ * @brief Gets the number of outstanding pipelined requests.
+ *
+ * @param[in] c Pointer to the client context.
+ * @param[out] out_count Pointer to store the number of outstanding requests.
+ * @return int Returns 0 on success, or WH_ERROR_BADARGS on invalid arguments.
+ */
+int wh_Client_PipelineGetOutstanding(whClientContext* c, uint16_t* out_count);
+#endif /* WOLFHSM_CFG_CLIENT_PIPELINE */
+
+#ifdef WOLFHSM_CFG_BATCH
+/** Batched request functions
+ *
+ * A batch carries several sub-requests to the server in a single packet and
+ * returns all of their responses in a single packet, saving a transport round
+ * trip per sub-request.  Sub-requests are built directly in the comm buffer,
+ * so no other request may be sent between wh_Client_BatchStart() and
+ * wh_Client_BatchRequest().  Each sub-request payload must already be in the
+ * format expected by the server handler, and each reserves resp_max bytes for
+ * its response.  Sub-requests are executed in order and a failing sub-request
+ * does not stop the rest of the batch.
+ */
+
+/**
+ * @brief Starts building a new, empty batch.
+ *
+ * @param[in] c Pointer to the client context.
+ * @return int Returns 0 on success, or WH_ERROR_BADARGS on invalid arguments.
+ */
+int wh_Client_BatchStart(whClientContext* c);
+
+/**
+ * @brief Appends a sub-request to the batch being built.
+ *
+ * @param[in] c Pointer to the client context.
+ * @param[in] group The group identifier of the sub-request.
+ * @param[in] action The action identifier of the sub-request.
+ * @param[in] data_size The size of the sub-request payload.
+ * @param[in] data A pointer to the sub-request payload. May be NULL if
+ * data_size is 0.
+ * @param[in] resp_max Maximum size of the sub-request response payload.
+ * @return int Returns 0 on success, WH_ERROR_BUFFER_SIZE if the sub-request
+ * does not fit in the batch, or WH_ERROR_BADARGS on invalid arguments.
+ */
+int wh_Client_BatchAdd(whClientContext* c, uint16_t group, uint16_t action,
+                       uint16_t data_size, const void* data,
+                       uint16_t resp_max);
+
+/**
+ * @brief Sends the batch that has been built to the server.
+ *
+ * @param[in] c Pointer to the client context.
+ * @return int Returns 0 on success, or a negative error code on failure.
+ */
+int wh_Client_BatchRequest(whClientContext* c);
+
+/**
+ * @brief Receives the response to a batch.
+ *
+ * The response is received into the comm buffer, where the individual
+ * results can be read with wh_Client_BatchGetResult() until the next request.
+ *
+ * @param[in] c Pointer to the client context.
+ * @param[out] out_count Optional pointer to store the number of results.
+ * @return int Returns 0 on success, WH_ERROR_NOTREADY if no response is
+ * available, the server return code if the batch was rejected, or a negative
+ * error code on failure.
+ */
+int wh_Client_BatchResponse(whClientContext* c, uint16_t* out_count);
+
+/**
+ * @brief Sends the batch that has been built and waits for its response.
+ *
+ * @param[in] c Pointer to the client context.
+ * @param[out] out_count Optional pointer to store the number of results.
+ * @return int Returns 0 on success, or a negative error code on failure.
+ */
+int wh_Client_Batch(whClientContext* c, uint16_t* out_count);
+
+/**
+ * @brief Gets the result of one sub-request from the last batch response.
+ *
+ * @param[in] c Pointer to the client context.
+ * @param[in] index Index of the sub-request, in the order it was added.
+ * @param[out] out_rc Optional pointer to store the handler return code.
+ * @param[out] out_size Optional pointer to store the response payload size.
+ * @param[out] out_data Optional pointer to store the address of the response
+ * payload within the comm buffer.
+ * @return int Returns 0 on success, WH_ERROR_BADARGS if index is out of
+ * range, or WH_ERROR_ABORTED if the response is malformed.
+ */
+int wh_Client_BatchGetResult(whClientContext* c, uint16_t index,
+                             int32_t* out_rc, uint16_t* out_size,
+                             const void** out_data);
+#endif /* WOLFHSM_CFG_BATCH */
+
 /** Comm component functions */
 
 /**
@@ -571,6 +1021,19 @@ int wh_Client_KeyEvictResponse(whClientContext* c);
  */
 int wh_Client_KeyEvict(whClientContext* c, uint16_t keyId);
 
+/**
+ * @brief Sends a key eviction request to the server without a response.
+ *
+ * The server evicts the key but does not report the result. This function
+ * does not block.
+ *
+ * @param[in] c Pointer to the client context.
+ * @param[in] keyId Key ID to be evicted.
+ * @return int Returns 0 on success, WH_ERROR_NOTREADY if the transport is
+ * busy, or a negative error code on failure.
+ */
+int wh_Client_KeyEvictNoResp(whClientContext* c, uint16_t keyId);
+
 /**
  * @brief Sends a key export request to the server.
  *
@@ -746,6 +1209,61 @@ int wh_Client_KeyRevokeResponse(whClientContext* c);
  */
 int wh_Client_KeyRevoke(whClientContext* c, whKeyId keyId);
 
+/**
+ * @brief Sends a key pin or unpin request to the server.
+ *
+ * This function prepares and sends a request to pin or unpin the specified
+ * key in the server key cache. This function does not block; it returns
+ * immediately after sending the request.
+ *
+ * @param[in] c Pointer to the client context.
+ * @param[in] keyId Key ID to be pinned or unpinned.
+ * @param[in] pin Nonzero to pin the key, 0 to unpin it.
+ * @return int Returns 0 on success, or a negative error code on failure.
+ */
+int wh_Client_KeyPinRequest(whClientContext* c, whKeyId keyId, int pin);
+
+/**
+ * @brief Receives a key pin or unpin response from the server.
+ *
+ * This function attempts to process a key pin response message from the
+ * server. It validates the response. This function does not block; it returns
+ * WH_ERROR_NOTREADY if a response has not been received.
+ *
+ * @param[in] c Pointer to the client context.
+ * @return int Returns 0 on success, WH_ERROR_NOTREADY if no response is
+ * available, or a negative error code on failure.
+ */
+int wh_Client_KeyPinResponse(whClientContext* c);
+
+/**
+ * @brief Pins a key in the server key cache.
+ *
+ * A pinned key is loaded into the cache if needed and is never evicted to
+ * make room for other keys, so using it never reads NVM. It stays pinned
+ * until it is unpinned, evicted or erased. This function blocks until the
+ * entire operation is complete or an error occurs.
+ *
+ * @param[in] c Pointer to the client context.
+ * @param[in] keyId Key ID to be pinned.
+ * @return int Returns 0 on success, WH_ERROR_NOSPACE if the connection of the
+ * client, with its sessions, already pinned WOLFHSM_CFG_SERVER_KEYCACHE_PIN_MAX
+ * keys, or a negative error code on failure.
+ */
+int wh_Client_KeyPin(whClientContext* c, whKeyId keyId);
+
+/**
+ * @brief Unpins a key in the server key cache, so it may be evicted again.
+ *
+ * This function blocks until the entire operation is complete or an error
+ * occurs.
+ *
+ * @param[in] c Pointer to the client context.
+ * @param[in] keyId Key ID to be unpinned.
+ * @return int Returns 0 on success, or a negative error code on failure.
+ */
+int wh_Client_KeyUnpin(whClientContext* c, whKeyId keyId);
+
 #ifdef WOLFHSM_CFG_DMA
 
 /**
@@ -1149,6 +1667,19 @@ int wh_Client_CounterIncrementResponse(whClientContext* c, uint32_t* counter);
 int wh_Client_CounterIncrement(whClientContext* c, whNvmId counterId,
     uint32_t* counter);
 
+/**
+ * @brief Increments a counter without waiting for a response.
+ *
+ * The server increments the counter but does not report the new value. This
+ * function does not block.
+ *
+ * @param[in] c Pointer to the whClientContext structure.
+ * @param[in] counterId Counter ID to be incremented.
+ * @return int Returns 0 on success, WH_ERROR_NOTREADY if the transport is
+ * busy, or a negative error code on failure.
+ */
+int wh_Client_CounterIncrementNoResp(whClientContext* c, whNvmId counterId);
+
 int wh_Client_CounterReadRequest(whClientContext* c, whNvmId counterId);
 int wh_Client_CounterReadResponse(whClientContext* c, uint32_t* counter);
 /**
@@ -1587,6 +2118,21 @@ int wh_Client_NvmDestroyObjectsResponse(whClientContext* c, int32_t* out_rc);
 int wh_Client_NvmDestroyObjects(whClientContext* c, whNvmId list_count,
                                 const whNvmId* id_list, int32_t* out_rc);
 
+/**
+ * @brief Sends a request to destroy NVM objects without a response.
+ *
+ * The server destroys the objects but does not report the result. This
+ * function does not block.
+ *
+ * @param[in] c Pointer to the client context.
+ * @param[in] list_count The number of NVM objects to destroy.
+ * @param[in] id_list Pointer to an array of IDs of the NVM objects to destroy.
+ * @return int Returns 0 on success, WH_ERROR_NOTREADY if the transport is
+ * busy, or a negative error code on failure.
+ */
+int wh_Client_NvmDestroyObjectsNoResp(whClientContext* c, whNvmId list_count,
+                                      const whNvmId* id_list);
+
 /**
  * @brief Sends a request to the server to read data from a non-volatile memory
  * (NVM) object.
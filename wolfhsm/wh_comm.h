@@ -23,12 +23,33 @@
  * Fundamentally, communications are reliable, bidirectional, and packet-based
  * with a fixed MTU.  Packets are delivered in-order without any intrinsic
  * queuing nor OOB support.  Transports deliver complete packets up to the MTU
- * size and provide the number of bytes received.
+ * size and provide the number of bytes received.  With WOLFHSM_CFG_COMM_FRAGMENT,
+ * packets may instead be split into acked fragments so transports with buffers
+ * smaller than the MTU can carry them.
+ *
+ * Packets larger than the comm context buffers are streamed when fragmenting:
+ *  - A fragmented packet may carry up to WOLFHSM_CFG_COMM_FRAGMENT_DATA_LEN of
+ *    data, which may exceed WOLFHSM_CFG_COMM_DATA_LEN.  NVM, certificate and
+ *    ML-DSA messages use the larger size, so whole objects, certificates and
+ *    messages move in one request.
+ *  - Comm context buffers stay at WH_COMM_MTU, and transport buffers only need
+ *    to hold one fragment.  The client sends the part of a request that does
+ *    not fit in its buffer straight from the caller's buffers with
+ *    wh_CommClient_SendRequestV(), and scatters a large response into the
+ *    caller's buffers with wh_CommClient_RecvResponseExt().  The server
+ *    reassembles large requests into the optional buffer of its config, and
+ *    refuses them with WH_ERROR_ABORTED without one.
+ *  - Fragments are acked one at a time.  Pipelined requests and responses
+ *    must each fit in a single fragment, and a packet that needs more than
+ *    one fragment needs the channel to itself.  Multi-fragment NORESP
+ *    requests are not supported.
  *
  * Note: Multibyte data will be passed in native order, which means clients and
  * servers must be the SAME endianness or will be required to translate data
  * elements in messages.  Translate helper functions are provided here and used
- * to interpret header fields.
+ * to interpret header fields.  The translate helpers check the endianness
+ * inline, and WOLFHSM_CFG_COMM_NATIVE_ONLY makes them plain copies for
+ * deployments without mixed endianness.
  *
  * All functions return an integer value with 0 meaning success and !=0 an error
  * enumerated either within wolfhsm/wh_error.h.  Unless otherwise noted, all
@@ -46,6 +67,7 @@
 #include <stdint.h>  /* For sized ints */
 
 #include "wolfhsm/wh_timeout.h"
+#include "wolfhsm/wh_utils.h"
 
 /** Packet content types */
 /* Request/response packets are composed of a single fixed-length header
@@ -67,8 +89,8 @@
 #define WH_COMM_MAGIC_SWAP      (WH_COMM_ENDIAN | (WH_COMM_VERSION << 8))
 
 #define WH_COMM_FLAGS_SWAPTEST(_magic) \
-    (_magic                 & WH_COMM_MAGIC_ENDIAN_MASK) ==  \
-    (WH_COMM_MAGIC_NATIVE   & WH_COMM_MAGIC_ENDIAN_MASK)
+    (((_magic)              & WH_COMM_MAGIC_ENDIAN_MASK) ==  \
+     (WH_COMM_MAGIC_NATIVE  & WH_COMM_MAGIC_ENDIAN_MASK))
 
 /* 8 byte Header for a packet, request or response. On-the-wire format */
 typedef struct {
@@ -86,19 +108,63 @@ enum WH_COMM_AUX_ENUM {
     WH_COMM_AUX_REQ_NORESP      = 0xFFFF, /* Async request without response*/
 
     WH_COMM_AUX_RESP_OK         = 0x0000, /* Response is valid */
-    WH_COMM_AUX_RESP_ERROR      = 0x0001, /* Request failed with error */
+    WH_COMM_AUX_RESP_ERROR      = 0x0001, /* Request failed with error, such
+                                           * as for a session not open */
     WH_COMM_AUX_RESP_FATAL      = 0xFFFE, /* Server condition is fatal */
     WH_COMM_AUX_RESP_UNSUPP     = 0xFFFF, /* Request is not supported */
 };
 
+#ifdef WOLFHSM_CFG_COMM_FRAGMENT
+/* 8 byte Header for each transport packet when fragmenting, the transport MTU
+ * adapter described above. On-the-wire format.
+ * A logical packet (whCommHeader and data) that is larger than the configured
+ * fragment_size is split into fragments that each start with this header. The
+ * receiver acks each fragment but the last before the next one is sent, so a
+ * transport buffer only ever holds one fragment.
+ */
+typedef struct {
+    uint16_t magic;     /* Endian marker with version */
+    uint16_t flags;     /* WH_COMM_FRAG_FLAG_* */
+    uint16_t offset;    /* Offset of the fragment within the logical packet. For
+                         * an ack, the number of bytes received so far. */
+    uint16_t total;     /* Size of the logical packet */
+} whCommFragHeader;
+
+enum WH_COMM_FRAG_FLAG_ENUM {
+    WH_COMM_FRAG_FLAG_DATA      = 0x0000, /* Fragment of a logical packet */
+    WH_COMM_FRAG_FLAG_ACK       = 0x0001, /* Ready for the next fragment */
+};
+
+/* Space ahead of the packet buffer for the header of the first fragment */
+#define WH_COMM_FRAG_RESERVE_U64_COUNT 1
+#else
+#define WH_COMM_FRAG_RESERVE_U64_COUNT 0
+#endif /* WOLFHSM_CFG_COMM_FRAGMENT */
+
 
 /** Translation utilities */
 
-/* Byteswap val if magic doesn't have the same endianness as native */
-uint8_t wh_Translate8(uint16_t magic, uint8_t val);
-uint16_t wh_Translate16(uint16_t magic, uint16_t val);
-uint32_t wh_Translate32(uint16_t magic, uint32_t val);
-uint64_t wh_Translate64(uint16_t magic, uint64_t val);
+#ifdef WOLFHSM_CFG_COMM_NATIVE_ONLY
+/* Peers always share the native endianness, so translation is a copy */
+#define WH_COMM_MAGIC_IS_NATIVE(_magic) ((void)(_magic), 1)
+#else
+/* Nonzero if magic has the same endianness as native */
+#define WH_COMM_MAGIC_IS_NATIVE(_magic) WH_COMM_FLAGS_SWAPTEST(_magic)
+#endif /* WOLFHSM_CFG_COMM_NATIVE_ONLY */
+
+/* Byteswap val if magic doesn't have the same endianness as native.  The
+ * endianness check is expanded inline, so translating a message from a native
+ * peer costs a compare per member and no call. */
+#define wh_Translate8(_m, _v) ((void)(_m), (uint8_t)(_v))
+#define wh_Translate16(_m, _v)                                                 \
+    ((uint16_t)(WH_COMM_MAGIC_IS_NATIVE(_m) ? (uint16_t)(_v)                  \
+                                            : wh_Utils_Swap16((uint16_t)(_v))))
+#define wh_Translate32(_m, _v)                                                 \
+    ((uint32_t)(WH_COMM_MAGIC_IS_NATIVE(_m) ? (uint32_t)(_v)                  \
+                                            : wh_Utils_Swap32((uint32_t)(_v))))
+#define wh_Translate64(_m, _v)                                                 \
+    ((uint64_t)(WH_COMM_MAGIC_IS_NATIVE(_m) ? (uint64_t)(_v)                  \
+                                            : wh_Utils_Swap64((uint64_t)(_v))))
 
 /* Helper macros for struct members */
 #define WH_T16(_m, _d, _s, _f) _d->_f = wh_Translate16(_m, _s->_f)
@@ -153,6 +219,43 @@ typedef struct {
      *          WH_ERROR_BADARGS if NULL context
      */
     int (*Cleanup)(void* context);
+
+    /* Optional. Get the transport buffer the next request will be sent from,
+     * so the request can be built in place.  Passing this buffer to Send
+     * avoids copying the request.  The buffer is only valid until Send.
+     * Returns: 0 on success,
+     *          WH_ERROR_BADARGS if NULL context or outputs
+     *          WH_ERROR_NOTREADY if send buffer is not free. Retry.
+     */
+    int (*GetSendBuffer)(void* context, uint16_t* out_size, void** out_buffer);
+
+    /* Optional. Block until a response may be available or timeout_us
+     * microseconds have elapsed. A timeout_us of 0 waits indefinitely. Spurious
+     * returns are allowed, so callers must still handle NOTREADY from Recv.
+     * Returns: 0 if a response may be available. Call Recv.
+     *          WH_ERROR_TIMEOUT if the timeout expired with no new response
+     *          WH_ERROR_BADARGS if NULL context
+     *          WH_ERROR_ABORTED if fatal error occurred. Cleanup.
+     */
+    int (*Wait)(void* context, uint64_t timeout_us);
+
+    /* Optional. The request just sent was WH_COMM_AUX_REQ_NORESP, so no
+     * response will arrive for it.  Transports that refuse to send until the
+     * last response is received implement this.
+     * Returns: 0 on success,
+     *          WH_ERROR_BADARGS if NULL context
+     */
+    int (*Complete)(void* context);
+
+    /* Optional. Ask the server to cancel the outstanding request, out of band
+     * of the request and response buffers so the server can see it while it
+     * is handling the request.  A cancel for a request that has completed is
+     * ignored.
+     * Returns: 0 on success,
+     *          WH_ERROR_BADARGS if NULL context
+     *          WH_ERROR_NOTREADY if no request is outstanding
+     */
+    int (*Cancel)(void* context);
 } whTransportClientCb;
 
 typedef struct {
@@ -161,30 +264,75 @@ typedef struct {
     const void* transport_config;
     whCommSetConnectedCb connect_cb;
     uint8_t client_id;
-    uint8_t WH_PAD[7];
+    uint8_t WH_PAD[3];
+#ifdef WOLFHSM_CFG_COMM_SESSIONS
+    uint16_t session_id;    /* Session on a shared connection, 1-0xFFFE, or 0
+                             * for the connection's own client. Sessions do
+                             * not support NORESP requests. */
+#else
+    uint8_t WH_PAD2[2];
+#endif
+#ifdef WOLFHSM_CFG_COMM_FRAGMENT
+    uint16_t fragment_size; /* Max transport packet size, or 0 to not fragment.
+                             * Must be a multiple of 8 and at least 16. */
+#else
+    uint8_t WH_PAD3[2];
+#endif
 #ifdef WOLFHSM_CFG_ENABLE_TIMEOUT
     whTimeoutConfig* respTimeoutConfig;
 #endif
 } whCommClientConfig;
 
+/* Data fragment for wh_CommClient_SendRequestV() */
+typedef struct {
+    const void* data;
+    uint16_t    size;
+    uint8_t     WH_PAD[6];
+} whCommIoVec;
+
+#ifdef WOLFHSM_CFG_COMM_FRAGMENT
+/* Number of whCommIoVec of a request that may be streamed from the caller's
+ * buffers instead of being copied into the comm buffer */
+#define WH_COMM_FRAG_IOV_MAX 4
+#endif
+
 /* Context structure for a client.  Note the client context will track the
  * request sequence number and provide a buffer for at least 1 packet.
  */
 typedef struct {
     uint64_t WH_ALIGN; /* Ensure following is 64-bit aligned */
-    uint64_t packet[WH_COMM_MTU_U64_COUNT];
+    uint64_t packet[WH_COMM_FRAG_RESERVE_U64_COUNT + WH_COMM_MTU_U64_COUNT];
     void* transport_context;
     const whTransportClientCb* transport_cb;
     whCommSetConnectedCb connect_cb;
     whCommHeader* hdr;
     uint8_t* data;
+    uint8_t* send_buffer; /* Transport buffer from GetSendBuffer, if any */
     int initialized;
     uint16_t reqid;
     uint16_t seq;
     uint16_t size;
     uint8_t client_id;
     uint8_t server_id;
+#ifdef WOLFHSM_CFG_COMM_FRAGMENT
+    uint16_t frag_size; /* Max transport packet size, 0 if not fragmenting */
+    uint16_t tx_total;  /* Size of the logical request being sent */
+    uint16_t tx_offset; /* Bytes of the request sent */
+    uint16_t tx_acked;  /* Bytes of the request acked by the server */
+    uint16_t rx_total;  /* Size of the logical response being received */
+    uint16_t rx_offset; /* Bytes of the response received */
+    uint16_t tx_magic;  /* Magic of the request being sent */
+    uint16_t tx_head;   /* Bytes of the request held in the comm buffer */
+    uint16_t tx_iov_count; /* Entries of tx_iov streamed after tx_head */
+    uint8_t WH_PAD3[2];
+    whCommIoVec tx_iov[WH_COMM_FRAG_IOV_MAX];
+#else
     uint8_t WH_PAD[4];
+#endif
+#ifdef WOLFHSM_CFG_COMM_SESSIONS
+    uint16_t session_id; /* Sent as the aux of each request, or 0 */
+    uint8_t WH_PAD2[6];
+#endif
 #ifdef WOLFHSM_CFG_ENABLE_TIMEOUT
     whTimeout respTimeout;
 #endif
@@ -203,20 +351,98 @@ int wh_CommClient_Init(whCommClient* context, const whCommClientConfig* config);
 int wh_CommClient_SendRequest(whCommClient* context, uint16_t magic,
     uint16_t kind, uint16_t *out_seq, uint16_t data_size, const void* data);
 
+/* As wh_CommClient_SendRequest(), but mark the request with
+ * WH_COMM_AUX_REQ_NORESP so the server does not respond.  The caller must not
+ * wait for a response to this request.  When fragmenting, the request must fit
+ * in a single fragment.
+ */
+int wh_CommClient_SendRequestNoResp(whCommClient* context, uint16_t magic,
+    uint16_t kind, uint16_t *out_seq, uint16_t data_size, const void* data);
+
+/* As wh_CommClient_SendRequest(), but gather the request data from iov_count
+ * fragments.  The fragments are copied directly into the transport send buffer
+ * when the transport supports it, without staging in the internal buffer.
+ * When fragmenting, the request may carry up to wh_CommClient_GetMaxDataLen()
+ * bytes.  The leading fragments are copied while they fit in
+ * WOLFHSM_CFG_COMM_DATA_LEN, and up to WH_COMM_FRAG_IOV_MAX remaining ones are
+ * sent straight from the caller's buffers, which must then stay valid until
+ * the response has been received.
+ */
+int wh_CommClient_SendRequestV(whCommClient* context, uint16_t magic,
+    uint16_t kind, uint16_t *out_seq, uint16_t iov_count,
+    const whCommIoVec* iov);
+
 /* If a response packet has been buffered, get the header and copy the data out
- * of the buffer.
+ * of the buffer.  When fragmenting, this also sends the remaining request
+ * fragments as the server acks them and acks each response fragment, returning
+ * WH_ERROR_NOTREADY until the whole response has arrived.  A response with
+ * more than WOLFHSM_CFG_COMM_DATA_LEN of data is received and dropped, and
+ * fails with WH_ERROR_ABORTED.  With WOLFHSM_CFG_COMM_SESSIONS, returns
+ * WH_ERROR_NOSESSION if the server did not have the session open.
  */
 int wh_CommClient_RecvResponse(whCommClient* context,
         uint16_t* out_magic, uint16_t* out_kind, uint16_t* out_seq,
         uint16_t* out_size, void* data);
 
+/* As wh_CommClient_RecvResponse(), but the response data fills data_size bytes
+ * of data and then up to ext_size bytes of ext.  When fragmenting, a response
+ * of up to wh_CommClient_GetMaxDataLen() bytes is scattered into the caller's
+ * buffers fragment by fragment, so neither may be the internal buffer then.
+ * A response larger than both buffers is received and dropped, and fails with
+ * WH_ERROR_ABORTED.
+ */
+int wh_CommClient_RecvResponseExt(whCommClient* context,
+        uint16_t* out_magic, uint16_t* out_kind, uint16_t* out_seq,
+        uint16_t* out_size, uint16_t data_size, void* data,
+        uint16_t ext_size, void* ext);
+
+/* Block until a response may be available or the timeout (in microseconds)
+ * expires, if supported by the transport. A timeout_us of 0 waits
+ * indefinitely. Returns WH_ERROR_NOTIMPL if the transport cannot block, in
+ * which case the caller should fall back to polling.
+ */
+int wh_CommClient_WaitResponse(whCommClient* context, uint64_t timeout_us);
+
+/* Ask the server to cancel the outstanding request through the transport, if
+ * supported.  Returns WH_ERROR_NOTIMPL if the transport has no out of band
+ * cancel.
+ */
+int wh_CommClient_Cancel(whCommClient* context);
+
 /* Get a pointer to the data portion of the internal buffer that is
- * HW_COMM_DATA_LEN bytes.
+ * WOLFHSM_CFG_COMM_DATA_LEN bytes.
  */
 uint8_t* wh_CommClient_GetDataPtr(whCommClient* context);
 
+/* Get the maximum data size of a request or response.  This is
+ * WOLFHSM_CFG_COMM_FRAGMENT_DATA_LEN when fragmenting, otherwise
+ * WOLFHSM_CFG_COMM_DATA_LEN, or 0 if context is NULL.  Data beyond
+ * WOLFHSM_CFG_COMM_DATA_LEN is only carried by wh_CommClient_SendRequestV()
+ * and wh_CommClient_RecvResponseExt().
+ */
+uint16_t wh_CommClient_GetMaxDataLen(const whCommClient* context);
+
+/* Get a pointer to where the data of the next request can be built in place,
+ * and the maximum data size in out_size.  If the transport supports it, this
+ * is within the transport send buffer and wh_CommClient_SendRequest() with
+ * this pointer sends without copying the data.  Otherwise this is the data
+ * portion of the internal buffer.  The pointer is only valid until the next
+ * request is sent.
+ */
+int wh_CommClient_GetSendDataPtr(whCommClient* context, uint16_t* out_size,
+    uint8_t** out_data);
+
+/* Check whether a request with data_size bytes of data may be sent while other
+ * requests are outstanding.  Returns WH_ERROR_NOTREADY while fragmenting if a
+ * multi-fragment request or response is in progress, or if the request itself
+ * needs more than one fragment, and 0 otherwise.
+ */
+int wh_CommClient_CheckPipeline(const whCommClient* context,
+        uint16_t data_size);
+
 /* Inform the server that no further communications are necessary and any
- * unfinished requests can be ignored.
+ * unfinished requests can be ignored.  Returns WH_ERROR_NOTREADY, leaving the
+ * context open, if the transport must deliver a response first.
  */
 int wh_CommClient_Cleanup(whCommClient* context);
 
@@ -254,6 +480,54 @@ typedef struct {
      *          WH_ERROR_BADARGS if NULL context
      */
     int (*Cleanup)(void* context);
+
+    /* Optional. Block until a request may be available or timeout_us
+     * microseconds have elapsed. A timeout_us of 0 waits indefinitely. Spurious
+     * returns are allowed, so callers must still handle NOTREADY from Recv.
+     * Returns: 0 if a request may be available. Call Recv.
+     *          WH_ERROR_TIMEOUT if the timeout expired with no new request
+     *          WH_ERROR_BADARGS if NULL context
+     *          WH_ERROR_ABORTED if fatal error occurred. Cleanup.
+     */
+    int (*Wait)(void* context, uint64_t timeout_us);
+
+    /* Optional. Complete the last received request without sending a
+     * response, as for WH_COMM_AUX_REQ_NORESP requests.  Transports that must
+     * release the request buffer before the client can send again implement
+     * this.  Any completion visible to the client must be zero length.
+     * Returns: 0 on success,
+     *          WH_ERROR_BADARGS if NULL context
+     *          WH_ERROR_ABORTED if fatal error occurred. Cleanup.
+     */
+    int (*Complete)(void* context);
+
+    /* Optional. Get the transport buffer that requests are received into and
+     * responses are sent from.  The buffer must be 8 byte aligned, hold at
+     * least WH_COMM_MTU bytes and stay valid until Cleanup.  The server then
+     * works on requests and responses in place instead of copying them through
+     * its own buffer.  Not used when fragmenting.
+     * Returns: 0 on success,
+     *          WH_ERROR_BADARGS if NULL context or outputs
+     */
+    int (*GetBuffer)(void* context, uint16_t* out_size, void** out_buffer);
+
+    /* Optional. Check whether the client canceled the request last received,
+     * which has not been responded to yet.  Must not block.
+     * Returns: 0 if the request has not been canceled,
+     *          WH_ERROR_CANCEL if the client canceled the request
+     *          WH_ERROR_BADARGS if NULL context
+     */
+    int (*Canceled)(void* context);
+
+    /* Optional. Check whether a request may be available without blocking,
+     * so a server can check several channels before it waits on one.
+     * Spurious results are allowed, as for Wait.
+     * Returns: 0 if a request may be available. Call Recv.
+     *          WH_ERROR_NOTREADY if no request has arrived
+     *          WH_ERROR_BADARGS if NULL context
+     *          WH_ERROR_ABORTED if fatal error occurred. Cleanup.
+     */
+    int (*Pending)(void* context);
 } whTransportServerCb;
 
 typedef struct {
@@ -261,7 +535,21 @@ typedef struct {
     const whTransportServerCb* transport_cb;
     const void* transport_config;
     uint8_t server_id;
+#ifdef WOLFHSM_CFG_COMM_FRAGMENT
+    uint8_t WH_PAD[5];
+    uint16_t fragment_size; /* Max transport packet size, or 0 to not fragment.
+                             * Must be a multiple of 8 and at least 16. */
+    void* frag_buffer;      /* Opt: 8 byte aligned buffer to reassemble
+                             * requests into when fragmenting, or NULL to use
+                             * the internal buffer. Requests and responses may
+                             * then carry up to frag_buffer_size - 16 bytes of
+                             * data, limited to
+                             * WOLFHSM_CFG_COMM_FRAGMENT_DATA_LEN. */
+    uint16_t frag_buffer_size; /* At least WH_COMM_MTU + 8 bytes */
+    uint8_t WH_PAD2[6];
+#else
     uint8_t WH_PAD[7];
+#endif
 } whCommServerConfig;
 
 /* Context structure for a server.  Note the client context will track the
@@ -269,15 +557,29 @@ typedef struct {
  */
 typedef struct {
     uint64_t WH_ALIGN; /* Ensure following is 64-bit aligned */
-    uint64_t packet[WH_COMM_MTU_U64_COUNT];
+    uint64_t packet[WH_COMM_FRAG_RESERVE_U64_COUNT + WH_COMM_MTU_U64_COUNT];
     void* transport_context;
     const whTransportServerCb* transport_cb;
     whCommHeader* hdr;
     uint8_t* data;
     int initialized;
     uint16_t reqid;
+    uint16_t aux; /* Aux field of the last received request */
     uint8_t client_id;
     uint8_t server_id;
+#ifdef WOLFHSM_CFG_COMM_FRAGMENT
+    uint16_t frag_size; /* Max transport packet size, 0 if not fragmenting */
+    uint16_t tx_total;  /* Size of the logical response being sent */
+    uint16_t tx_offset; /* Bytes of the response sent */
+    uint16_t tx_acked;  /* Bytes of the response acked by the client */
+    uint16_t rx_total;  /* Size of the logical request being received */
+    uint16_t rx_offset; /* Bytes of the request received */
+    uint16_t buffer_size; /* Size of buffer */
+    uint8_t* buffer;    /* Fragments are sent and received in this buffer,
+                         * packet or the frag_buffer of the config */
+#else
+    uint8_t WH_PAD[6];
+#endif
 } whCommServer;
 
 /* Reset the state of the server context and begin the connection to a client
@@ -288,12 +590,46 @@ int wh_CommServer_Init(whCommServer* context, const whCommServerConfig* config,
                 whCommSetConnectedCb connectcb, void* connectcb_arg);
 
 /* If a request packet has been buffered, get the header and copy the data out
- * of the buffer.
+ * of the buffer.  When fragmenting, this also sends the remaining fragments of
+ * the last response as the client acks them and acks each request fragment,
+ * returning WH_ERROR_NOTREADY until the whole request has arrived.  A request
+ * with more than WOLFHSM_CFG_COMM_DATA_LEN of data is only received in place,
+ * in the frag_buffer of the config, and is received and dropped with
+ * WH_ERROR_ABORTED if it does not fit.
  */
 int wh_CommServer_RecvRequest(whCommServer* context,
         uint16_t* out_magic, uint16_t* out_kind, uint16_t* out_seq,
         uint16_t* out_size, void* data);
 
+/* Get the aux field of the last request received, such as
+ * WH_COMM_AUX_REQ_NORESP.
+ */
+int wh_CommServer_GetRequestAux(whCommServer* context, uint16_t* out_aux);
+
+/* Complete the last request received without sending a response.  Used for
+ * WH_COMM_AUX_REQ_NORESP requests in place of wh_CommServer_SendResponse().
+ */
+int wh_CommServer_CompleteRequest(whCommServer* context);
+
+/* Block until a request may be available or the timeout (in microseconds)
+ * expires, if supported by the transport. A timeout_us of 0 waits
+ * indefinitely. Returns WH_ERROR_NOTIMPL if the transport cannot block, in
+ * which case the caller should fall back to polling.
+ */
+int wh_CommServer_WaitRequest(whCommServer* context, uint64_t timeout_us);
+
+/* Check whether a request may be available without blocking.  Returns
+ * WH_ERROR_OK if one may be, WH_ERROR_NOTREADY if not, or WH_ERROR_NOTIMPL if
+ * the transport cannot tell.
+ */
+int wh_CommServer_PollRequest(whCommServer* context);
+
+/* Check whether the client canceled the request being handled through the
+ * transport.  Returns WH_ERROR_CANCEL if so, 0 if not or if the transport has
+ * no out of band cancel.
+ */
+int wh_CommServer_CheckCanceled(whCommServer* context);
+
 /* Upon completion of the request, send the response packet using the same seq
  * as the incoming request.  Note that overriding the seq number should only be
  * used for asynchronous notifications, such as keep-alive or close.
@@ -302,11 +638,24 @@ int wh_CommServer_SendResponse(whCommServer* context,
         uint16_t magic, uint16_t kind, uint16_t seq,
         uint16_t data_size, const void* data);
 
+/* Send an empty response marked WH_COMM_AUX_RESP_ERROR for a request that
+ * could not be handled at all, such as one for a session that is not open.
+ */
+int wh_CommServer_SendErrorResponse(whCommServer* context,
+        uint16_t magic, uint16_t kind, uint16_t seq);
+
 /* Get a pointer to the data portion of the internal buffer that is
- * WOLFHSM_CFG_COMM_DATA_LEN bytes long.
+ * wh_CommServer_GetMaxDataLen() bytes long.
  */
 uint8_t* wh_CommServer_GetDataPtr(whCommServer* context);
 
+/* Get the maximum data size of a request or response.  When fragmenting with a
+ * frag_buffer, this is the data it holds up to
+ * WOLFHSM_CFG_COMM_FRAGMENT_DATA_LEN, otherwise WOLFHSM_CFG_COMM_DATA_LEN, or
+ * 0 if context is NULL.
+ */
+uint16_t wh_CommServer_GetMaxDataLen(const whCommServer* context);
+
 
 int wh_CommServer_Cleanup(whCommServer* context);
 
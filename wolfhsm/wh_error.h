@@ -46,6 +46,9 @@ enum WH_ERROR_ENUM {
     WH_ERROR_USAGE =
         -2009, /* Operation not permitted based on object/key usage flags */
     WH_ERROR_TIMEOUT = -2010, /* Timeout occurred. */
+    WH_ERROR_CANCEL  = -2011, /* Request was canceled by the client */
+    WH_ERROR_CANCEL_LATE = -2012, /* Request completed before the cancel */
+    WH_ERROR_NOSESSION   = -2013, /* Session is not open on the server */
 
     /* NVM and keystore specific status returns */
     WH_ERROR_LOCKED      = -2100, /* Unlock and retry if necessary */
@@ -33,29 +33,99 @@
 
 #ifndef WOLFHSM_CFG_NO_CRYPTO
 
+#ifdef WOLFHSM_CFG_SERVER_KEYCACHE_POOL
+/** Server cache slot structure, with its key buffer in the cache pool */
+typedef struct whCacheSlot {
+#ifdef WOLFHSM_CFG_SERVER_KEYCACHE_PARSED
+    uint32_t      gen; /* Stamped each time the slot is filled */
+#endif
+#if defined(WOLFHSM_CFG_SERVER_KEYCACHE_LRU) || \
+    defined(WOLFHSM_CFG_SERVER_KEYCACHE_LFU)
+    uint32_t      use; /* Last use tick (LRU) or use count (LFU) */
+#endif
+    uint8_t       committed;
+    uint16_t      pinned;   /* Pinning client ID plus 1, or 0 if unpinned */
+    uint16_t      offset;   /* First pool granule of the key buffer */
+    uint16_t      granules; /* Pool granules reserved, 0 if none */
+    whNvmMetadata meta[1];
+} whCacheSlot;
+#else
 /** Server cache slot structures */
 typedef struct whCacheSlot {
+#ifdef WOLFHSM_CFG_SERVER_KEYCACHE_PARSED
+    uint32_t      gen; /* Stamped each time the slot is filled */
+#endif
+#if defined(WOLFHSM_CFG_SERVER_KEYCACHE_LRU) || \
+    defined(WOLFHSM_CFG_SERVER_KEYCACHE_LFU)
+    uint32_t      use; /* Last use tick (LRU) or use count (LFU) */
+#endif
     uint8_t       committed;
+    uint16_t      pinned; /* Pinning client ID plus 1, or 0 if unpinned */
     whNvmMetadata meta[1];
     uint8_t       buffer[WOLFHSM_CFG_SERVER_KEYCACHE_BUFSIZE];
 } whCacheSlot;
 
 typedef struct whBigCacheSlot {
+#ifdef WOLFHSM_CFG_SERVER_KEYCACHE_PARSED
+    uint32_t      gen; /* Stamped each time the slot is filled */
+#endif
+#if defined(WOLFHSM_CFG_SERVER_KEYCACHE_LRU) || \
+    defined(WOLFHSM_CFG_SERVER_KEYCACHE_LFU)
+    uint32_t      use; /* Last use tick (LRU) or use count (LFU) */
+#endif
     uint8_t       committed;
+    uint16_t      pinned; /* Pinning client ID plus 1, or 0 if unpinned */
     whNvmMetadata meta[1];
     uint8_t       buffer[WOLFHSM_CFG_SERVER_KEYCACHE_BIG_BUFSIZE];
 } whBigCacheSlot;
+#endif /* WOLFHSM_CFG_SERVER_KEYCACHE_POOL */
+
+/** Key ID index bucket, mapping a key ID to the slot reserved for it */
+typedef struct whKeyCacheIndex {
+    whKeyId  id;
+    uint16_t slot; /* Regular slot index plus 1, or big slot index plus
+                    * the number of regular slots plus 1. 0 if empty */
+} whKeyCacheIndex;
+
+/** Key cache statistics, for sizing WOLFHSM_CFG_SERVER_KEYCACHE_COUNT */
+typedef struct whKeyCacheStats {
+    uint32_t hits;      /* Key uses served from the cache */
+    uint32_t misses;    /* Key uses that were not cached */
+    uint32_t evictions; /* Committed keys evicted to make room */
+} whKeyCacheStats;
 
 /**
  * @brief Unified key cache context
  *
- * Holds both regular and big cache arrays. Used for client-local caches
+ * Holds both regular and big cache arrays, or with
+ * WOLFHSM_CFG_SERVER_KEYCACHE_POOL one slot array whose key buffers share a
+ * memory pool. Used for client-local caches
  * (embedded in whServerContext) and global caches (embedded in whNvmContext
  * when WOLFHSM_CFG_GLOBAL_KEYS is enabled).
  */
 typedef struct whKeyCacheContext_t {
-    whCacheSlot    cache[WOLFHSM_CFG_SERVER_KEYCACHE_COUNT];
-    whBigCacheSlot bigCache[WOLFHSM_CFG_SERVER_KEYCACHE_BIG_COUNT];
+#ifdef WOLFHSM_CFG_SERVER_KEYCACHE_POOL
+    whCacheSlot     cache[WOLFHSM_CFG_SERVER_KEYCACHE_POOL_KEYS];
+    uint8_t         pool[WH_KEYCACHE_POOL_GRANULES *
+                         WOLFHSM_CFG_SERVER_KEYCACHE_POOL_GRANULE];
+    /* Bitmap of the pool granules in use */
+    uint8_t         poolMap[(WH_KEYCACHE_POOL_GRANULES + 7) / 8];
+#else
+    whCacheSlot     cache[WOLFHSM_CFG_SERVER_KEYCACHE_COUNT];
+    whBigCacheSlot  bigCache[WOLFHSM_CFG_SERVER_KEYCACHE_BIG_COUNT];
+#endif
+    /* Open addressing index from key ID to slot, so lookups don't scan the
+     * slots */
+    whKeyCacheIndex index[WOLFHSM_CFG_SERVER_KEYCACHE_INDEX_SIZE];
+    /* Key ID each slot is indexed under, or WH_KEYID_ERASED */
+    whKeyId         indexId[WH_KEYCACHE_SLOT_COUNT];
+    whKeyCacheStats stats;
+#ifdef WOLFHSM_CFG_SERVER_KEYCACHE_PARSED
+    uint32_t        gen; /* Last generation stamped on a slot */
+#endif
+#ifdef WOLFHSM_CFG_SERVER_KEYCACHE_LRU
+    uint32_t        tick; /* Last use tick stamped on a slot */
+#endif
 } whKeyCacheContext;
 
 #endif /* !WOLFHSM_CFG_NO_CRYPTO */
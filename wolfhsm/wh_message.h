@@ -47,6 +47,8 @@ enum WH_MESSAGE_ENUM {
     WH_MESSAGE_GROUP_CUSTOM     = 0x0A00, /* User-specified features */
     WH_MESSAGE_GROUP_CRYPTO_DMA = 0x0B00, /* DMA crypto operations */
     WH_MESSAGE_GROUP_CERT       = 0x0C00, /* Certificate operations */
+    WH_MESSAGE_GROUP_BATCH      = 0x0D00, /* Batched sub-requests */
+    WH_MESSAGE_GROUP_CANCEL     = 0x0E00, /* Response to a canceled request */
 
     WH_MESSAGE_ACTION_MASK = 0x00FF, /* 255 subtypes per group*/
     WH_MESSAGE_ACTION_NONE = 0x0000, /* No action. Invalid. */
@@ -67,6 +69,7 @@ enum WH_KEY_ENUM {
     WH_KEY_KEYUNWRAPCACHE,
     WH_KEY_DATAWRAP,
     WH_KEY_DATAUNWRAP,
+    WH_KEY_PIN,
 };
 
 /* SHE actions */
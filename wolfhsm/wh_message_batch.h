@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2024 wolfSSL Inc.
+ *
+ * This file is part of wolfHSM.
+ *
+ * wolfHSM is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * wolfHSM is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with wolfHSM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/*
+ * wolfhsm/wh_message_batch.h
+ *
+ * Message structures and translation functions for batched requests.
+ *
+ * A batch request carries several sub-requests in a single packet.  The server
+ * dispatches each sub-request through the normal group handlers in order and
+ * returns a single packed response holding the return code and response
+ * payload of every sub-request.
+ *
+ * Request layout (WH_MESSAGE_GROUP_BATCH, WH_MESSAGE_BATCH_ACTION_EXEC):
+ *   whMessageBatch_Request
+ *   count * { whMessageBatch_RequestItem, payload padded to 8 bytes }
+ *
+ * Response layout:
+ *   whMessageBatch_Response
+ *   count * { whMessageBatch_ResponseItem, payload padded to 8 bytes }
+ *
+ * Each request item reserves resp_max bytes of response payload.  The server
+ * places the unprocessed sub-requests at the end of the comm buffer and packs
+ * responses from the start.  Each sub-request is moved into its response slot
+ * and executed in place, so the slot holds the larger of its request and
+ * resp_max.  A batch is only valid if, at every item, the responses packed so
+ * far, the current slot and the sub-requests still to be read fit within
+ * WOLFHSM_CFG_COMM_DATA_LEN.  wh_MessageBatch_LayoutAdd() tracks this as items
+ * are added and invalid batches are rejected before any sub-request is
+ * executed.  A sub-request whose response exceeds its reservation is reported
+ * with WH_ERROR_BUFFER_SIZE and no payload.  If that response overwrote unread
+ * sub-requests, the batch stops there with WH_ERROR_BUFFER_SIZE.  Batches may
+ * not be nested.
+ */
+
+#ifndef WOLFHSM_WH_MESSAGE_BATCH_H_
+#define WOLFHSM_WH_MESSAGE_BATCH_H_
+
+/* Pick up compile-time configuration */
+#include "wolfhsm/wh_settings.h"
+
+#include <stdint.h>
+
+#include "wolfhsm/wh_common.h"
+
+/* Batch actions */
+enum WH_MESSAGE_BATCH_ACTION_ENUM {
+    WH_MESSAGE_BATCH_ACTION_NONE = 0x00,
+    WH_MESSAGE_BATCH_ACTION_EXEC = 0x01,
+};
+
+/* Round a payload size up to the item alignment */
+#define WH_MESSAGE_BATCH_ALIGN(_sz) (((_sz) + 7u) & ~7u)
+
+/* Batch Request header */
+typedef struct {
+    uint16_t count; /* Number of items that follow */
+    uint8_t  WH_PAD[6];
+} whMessageBatch_Request;
+
+/* Batch Request item header, followed by size bytes of payload */
+typedef struct {
+    uint16_t kind;     /* Group and action of the sub-request */
+    uint16_t size;     /* Size of the sub-request payload */
+    uint16_t resp_max; /* Response payload bytes reserved for this item */
+    uint8_t  WH_PAD[2];
+} whMessageBatch_RequestItem;
+
+/* Batch Response header */
+typedef struct {
+    int32_t  rc;    /* Overall result. Items are only valid if 0 */
+    uint16_t count; /* Number of items that follow */
+    uint8_t  WH_PAD[2];
+} whMessageBatch_Response;
+
+/* Batch Response item header, followed by size bytes of payload */
+typedef struct {
+    int32_t  rc;   /* Return code of the sub-request handler */
+    uint16_t kind; /* Group and action of the sub-request */
+    uint16_t size; /* Size of the sub-response payload */
+} whMessageBatch_ResponseItem;
+
+/* Batch translation functions */
+int wh_MessageBatch_TranslateRequest(uint16_t magic,
+                                     const whMessageBatch_Request* src,
+                                     whMessageBatch_Request*       dest);
+
+int wh_MessageBatch_TranslateRequestItem(uint16_t magic,
+                                         const whMessageBatch_RequestItem* src,
+                                         whMessageBatch_RequestItem* dest);
+
+int wh_MessageBatch_TranslateResponse(uint16_t magic,
+                                      const whMessageBatch_Response* src,
+                                      whMessageBatch_Response*       dest);
+
+int wh_MessageBatch_TranslateResponseItem(
+    uint16_t magic, const whMessageBatch_ResponseItem* src,
+    whMessageBatch_ResponseItem* dest);
+
+/* Incrementally track the space required by a batch as items are added.
+ * Initialize with wh_MessageBatch_LayoutInit(), then call
+ * wh_MessageBatch_LayoutAdd() for each item.  Returns WH_ERROR_BUFFER_SIZE,
+ * leaving the layout unchanged, if the item would make the batch invalid. */
+typedef struct {
+    uint32_t req_total;  /* Bytes of all request items */
+    uint32_t resp_total; /* Bytes reserved for all response items */
+    uint32_t required;   /* Worst case bytes in use while processing */
+    uint16_t count;
+    uint8_t  WH_PAD[2];
+} whMessageBatch_Layout;
+
+int wh_MessageBatch_LayoutInit(whMessageBatch_Layout* layout);
+
+int wh_MessageBatch_LayoutAdd(whMessageBatch_Layout* layout, uint16_t size,
+                              uint16_t resp_max);
+
+#endif /* !WOLFHSM_WH_MESSAGE_BATCH_H_ */
@@ -174,6 +174,28 @@ int wh_MessageKeystore_TranslateRevokeResponse(
     uint16_t magic, const whMessageKeystore_RevokeResponse* src,
     whMessageKeystore_RevokeResponse* dest);
 
+/* Key Pin Request */
+typedef struct {
+    uint16_t id;
+    uint16_t pin; /* Nonzero to pin, 0 to unpin */
+    uint8_t  WH_PAD[4];
+} whMessageKeystore_PinRequest;
+
+/* Key Pin Response */
+typedef struct {
+    uint32_t rc;
+    uint8_t  WH_PAD[4];
+} whMessageKeystore_PinResponse;
+
+/* Key Pin translation functions */
+int wh_MessageKeystore_TranslatePinRequest(
+    uint16_t magic, const whMessageKeystore_PinRequest* src,
+    whMessageKeystore_PinRequest* dest);
+
+int wh_MessageKeystore_TranslatePinResponse(
+    uint16_t magic, const whMessageKeystore_PinResponse* src,
+    whMessageKeystore_PinResponse* dest);
+
 /*
  * DMA-based keystore operations
  */
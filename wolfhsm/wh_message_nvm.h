@@ -50,6 +50,8 @@ enum WH_MESSAGE_NVM_ACTION_ENUM {
 enum WH_MESSAGE_NVM_MAX_ENUM {
     /* must be odd for struct whMessageNvm_DestroyObjectsRequest  alignment */
     WH_MESSAGE_NVM_MAX_DESTROY_OBJECTS_COUNT = 19,
+    /* Without fragmenting.  Fragmenting channels allow the same message headers
+     * with up to WOLFHSM_CFG_COMM_FRAGMENT_DATA_LEN in total */
     WH_MESSAGE_NVM_MAX_ADDOBJECT_LEN = WOLFHSM_CFG_COMM_DATA_LEN - sizeof(whNvmMetadata),
     WH_MESSAGE_NVM_MAX_READ_LEN = WOLFHSM_CFG_COMM_DATA_LEN - sizeof(int32_t),
 };
@@ -112,7 +114,8 @@ typedef struct {
     uint16_t flags;
     uint16_t len;
     uint8_t label[WH_NVM_LABEL_LEN];
-    /* Data up to WH_MESSAGE_NVM_MAX_ADDOBJECT_LEN follows */
+    /* Data up to WH_MESSAGE_NVM_MAX_ADDOBJECT_LEN, or more when fragmenting,
+     * follows */
 } whMessageNvm_AddObjectRequest;
 
 int wh_MessageNvm_TranslateAddObjectRequest(uint16_t magic,
@@ -194,7 +197,8 @@ int wh_MessageNvm_TranslateReadRequest(uint16_t magic,
 /** NVM Read Response */
 typedef struct {
     int32_t rc;
-    /* Data up to WH_MESSAGE_NVM_MAX_READ_LEN follows */
+    /* Data up to WH_MESSAGE_NVM_MAX_READ_LEN, or more when fragmenting,
+     * follows */
 } whMessageNvm_ReadResponse;
 
 int wh_MessageNvm_TranslateReadResponse(uint16_t magic,
@@ -61,6 +61,13 @@
 #include "wolfhsm/wh_keycache.h"     /* For whKeyCacheContext */
 #include "wolfhsm/wh_lock.h"
 
+#ifndef WOLFHSM_CFG_NO_CRYPTO
+/** Words in the key ID bitmap of one key user */
+#define WH_NVM_KEYID_MAP_WORDS ((WH_KEYID_IDMAX + 32) / 32)
+/** Number of key users, each with its own key ID bitmap */
+#define WH_NVM_KEYID_MAP_USERS ((WH_KEYUSER_MASK >> WH_KEYUSER_SHIFT) + 1)
+#endif
+
 /**
  * @brief NVM backend callback table.
  *
@@ -137,6 +144,13 @@ typedef struct whNvmContext_t {
 #if !defined(WOLFHSM_CFG_NO_CRYPTO) && defined(WOLFHSM_CFG_GLOBAL_KEYS)
     whKeyCacheContext globalCache; /**< Global key cache (shared keys) */
 #endif
+#ifndef WOLFHSM_CFG_NO_CRYPTO
+    /** IDs of WH_KEYTYPE_CRYPTO objects in NVM, one bitmap per key user, so
+     * key ID allocation does not search the directory.  Built at init and
+     * updated on add and destroy.  May hold IDs that are no longer in use */
+    uint32_t keyIdMap[WH_NVM_KEYID_MAP_USERS][WH_NVM_KEYID_MAP_WORDS];
+    int      keyIdMapValid; /**< Nonzero if the backend could be listed */
+#endif
 #ifdef WOLFHSM_CFG_THREADSAFE
     whLock lock; /**< Lock for serializing NVM and global cache operations */
 #endif
@@ -55,6 +55,10 @@ typedef struct whServerContext_t whServerContext;
 #include "wolfssl/wolfcrypt/curve25519.h"
 #include "wolfssl/wolfcrypt/cryptocb.h"
 #include "wolfssl/wolfcrypt/sha256.h"
+#ifdef WOLFHSM_CFG_SERVER_KEYCACHE_PARSED
+#include "wolfssl/wolfcrypt/ed25519.h"
+#include "wolfssl/wolfcrypt/dilithium.h"
+#endif /* WOLFHSM_CFG_SERVER_KEYCACHE_PARSED */
 #endif /* !WOLFHSM_CFG_NO_CRYPTO */
 
 #ifdef WOLFHSM_CFG_SHE_EXTENSION
@@ -74,6 +78,40 @@ typedef struct whServerCryptoContext {
 #endif
 } whServerCryptoContext;
 
+#ifdef WOLFHSM_CFG_SERVER_KEYCACHE_PARSED
+/* Types of decoded key objects */
+#define WH_SERVER_PARSEDKEY_NONE    0
+#define WH_SERVER_PARSEDKEY_RSA     1
+#define WH_SERVER_PARSEDKEY_ECC     2
+#define WH_SERVER_PARSEDKEY_ED25519 3
+#define WH_SERVER_PARSEDKEY_MLDSA   4
+
+/* Decoded wolfCrypt object of a cached key, valid while the cache slot holding
+ * the key keeps the same generation */
+typedef struct whServerParsedKey {
+    uint32_t gen;   /* Cache slot generation when the key was decoded */
+    int      devId; /* Device the key object was initialized with */
+    whKeyId  id;    /* WH_KEYID_ERASED if unused */
+    uint16_t type;  /* WH_SERVER_PARSEDKEY_* */
+    union {
+#ifndef NO_RSA
+        RsaKey rsa;
+#endif
+#ifdef HAVE_ECC
+        ecc_key ecc;
+#endif
+#ifdef HAVE_ED25519
+        ed25519_key ed25519;
+#endif
+#ifdef HAVE_DILITHIUM
+        MlDsaKey mldsa;
+#endif
+        /* Placeholder to prevent empty union in C90 */
+        uint8_t none;
+    } key;
+} whServerParsedKey;
+#endif /* WOLFHSM_CFG_SERVER_KEYCACHE_PARSED */
+
 
 #endif /* !WOLFHSM_CFG_NO_CRYPTO */
 
@@ -135,9 +173,26 @@ typedef struct {
 
 /** Server config and context */
 
+#ifdef WOLFHSM_CFG_SERVER_LANES
+/* Block until a request may be pending on any channel of a server, or until
+ * timeout_us elapses (0 waits indefinitely).  Returns WH_ERROR_OK or
+ * WH_ERROR_TIMEOUT, or a negative error code on failure */
+typedef int (*whServerWaitCb)(void* context, uint64_t timeout_us);
+#endif /* WOLFHSM_CFG_SERVER_LANES */
+
 typedef struct whServerConfig_t {
     whCommServerConfig* comm_config;
     whNvmContext*       nvm;
+#ifdef WOLFHSM_CFG_SERVER_LANES
+    /* Lower priority channels of the same client. Entry i is lane i + 1, after
+     * the primary comm_config lane 0. NULL if unused */
+    whCommServerConfig* lane_config[WOLFHSM_CFG_SERVER_LANE_COUNT - 1];
+    /* Optional single wait on every channel, such as a doorbell the lane
+     * transports share or a poll set over them. NULL to wait on each channel
+     * in turn */
+    whServerWaitCb lane_wait_cb;
+    void*          lane_wait_context;
+#endif /* WOLFHSM_CFG_SERVER_LANES */
 
 #ifndef WOLFHSM_CFG_NO_CRYPTO
     whServerCryptoContext* crypto;
@@ -157,14 +212,34 @@ typedef struct whServerConfig_t {
 } whServerConfig;
 
 
+#ifdef WOLFHSM_CFG_COMM_SESSIONS
+/* Logical client multiplexed on the connection of a server context */
+typedef struct {
+    uint16_t id;        /* Session id from the request aux, 0 if free */
+    uint8_t  client_id; /* Client of the session, from its CommInit */
+    uint8_t  WH_PAD[1];
+} whServerSession;
+#endif /* WOLFHSM_CFG_COMM_SESSIONS */
+
 /* Context structure to maintain the state of an HSM server */
 struct whServerContext_t {
     whNvmContext* nvm;
     whCommServer  comm[1];
+#ifdef WOLFHSM_CFG_SERVER_LANES
+    whCommServer  lane[WOLFHSM_CFG_SERVER_LANE_COUNT - 1]; /* Lanes 1 and up */
+    whServerWaitCb laneWaitCb;
+    void*          laneWaitContext;
+    /* Errors not returned by wh_Server_HandleRequestMessage, per lane */
+    int            laneError[WOLFHSM_CFG_SERVER_LANE_COUNT];
+#endif /* WOLFHSM_CFG_SERVER_LANES */
 #ifndef WOLFHSM_CFG_NO_CRYPTO
     whServerCryptoContext* crypto;
     int                    devId;
     whKeyCacheContext      localCache; /* Unified cache structure */
+#ifdef WOLFHSM_CFG_SERVER_KEYCACHE_PARSED
+    whServerParsedKey parsedKey[WOLFHSM_CFG_SERVER_KEYCACHE_PARSED_COUNT];
+    uint16_t          parsedKeyNext; /* Next entry to replace when full */
+#endif /* WOLFHSM_CFG_SERVER_KEYCACHE_PARSED */
 #ifdef WOLFHSM_CFG_SHE_EXTENSION
     whServerSheContext* she;
 #endif
@@ -177,6 +252,23 @@ struct whServerContext_t {
 #ifdef WOLFHSM_CFG_LOGGING
     whLogContext log;
 #endif /* WOLFHSM_CFG_LOGGING */
+#ifdef WOLFHSM_CFG_CANCEL_API
+    /* Sequence number to cancel in the low 16 bits and a count of cancels
+     * in the high 16 bits. Only written by wh_Server_SetCanceledSequence(),
+     * which may run in another thread or an interrupt handler */
+    volatile uint32_t cancelSeq;
+    uint32_t          cancelSeen; /* Last cancelSeq value checked */
+    int               canceled;   /* Current request stopped by a cancel */
+    int               cancelable; /* Current request is on the primary channel */
+#endif /* WOLFHSM_CFG_CANCEL_API */
+#ifdef WOLFHSM_CFG_COMM_SESSIONS
+    /* Sessions opened by a CommInit carrying a session id */
+    whServerSession session[WOLFHSM_CFG_SERVER_SESSION_COUNT];
+    /* While a session request is dispatched, comm->client_id is that of the
+     * session and the connection's own is kept here */
+    int     sessionDispatch;
+    uint8_t connClientId;
+#endif /* WOLFHSM_CFG_COMM_SESSIONS */
 };
 
 
@@ -239,6 +331,28 @@ int wh_Server_SetConnectedCb(void* s, whCommConnected connected);
 int wh_Server_GetConnected(whServerContext* server,
                            whCommConnected* out_connected);
 
+/* Most distinct client IDs on one connection: its own and one per session */
+#ifdef WOLFHSM_CFG_COMM_SESSIONS
+#define WH_SERVER_CONNECTION_CLIENTS (WOLFHSM_CFG_SERVER_SESSION_COUNT + 1)
+#else
+#define WH_SERVER_CONNECTION_CLIENTS 1
+#endif /* WOLFHSM_CFG_COMM_SESSIONS */
+
+/**
+ * @brief Gets the client IDs in use on the connection of the server.
+ *
+ * These are the client_id of the connection itself and, if
+ * WOLFHSM_CFG_COMM_SESSIONS is defined, those of its open sessions, each
+ * listed once.
+ *
+ * @param[in] server Pointer to the server context.
+ * @param[out] out_ids Array of WH_SERVER_CONNECTION_CLIENTS entries to store
+ * the client IDs in.
+ * @return int Returns the number of client IDs stored, or WH_ERROR_BADARGS if
+ * the arguments are invalid.
+ */
+int wh_Server_GetConnectionClients(whServerContext* server, uint8_t* out_ids);
+
 /**
  * @brief Handles incoming request messages and dispatches them to the
  * appropriate handlers.
@@ -248,6 +362,24 @@ int wh_Server_GetConnected(whServerContext* server,
  * and dispatches the request to the appropriate handler. The function also
  * sends a response back to the client.
  *
+ * If WOLFHSM_CFG_SERVER_LANES is defined, each call handles at most one
+ * request, taken from the highest priority lane with one pending: the primary
+ * channel first, then each configured lane_config in order. A request in
+ * progress is not preempted, but a pending control request is always handled
+ * before any pending bulk request. A channel that fails to receive does not
+ * stop the lower priority lanes from being polled: if another lane then
+ * handles a request, its result is returned and the error is kept for
+ * wh_Server_GetLaneError(). If no lane handles a request, the error of the
+ * highest priority failing channel is returned and those of the others kept.
+ *
+ * If WOLFHSM_CFG_COMM_SESSIONS is defined, a request whose aux carries a
+ * session id is handled as the client that opened that session with a
+ * CommInit, so keys, counters and NVM access use the client_id of the session.
+ * A CommClose of a session only closes that session, and evicts the cached
+ * keys and releases the key pins of its client unless the connection or another
+ * open session uses the same client_id.  Requests of a session that is not
+ * open receive an error response without being dispatched.
+ *
  * @param[in] server Pointer to the server context.
  * @return int Returns 0 on success, WH_ERROR_BADARGS if the arguments are
  * invalid, WH_ERROR_NOTREADY if the server is not connected or no data is
@@ -255,6 +387,86 @@ int wh_Server_GetConnected(whServerContext* server,
  */
 int wh_Server_HandleRequestMessage(whServerContext* server);
 
+/**
+ * @brief Blocks until a request may be available or a timeout expires.
+ *
+ * This function allows a server loop to sleep while idle instead of polling
+ * wh_Server_HandleRequestMessage(). It is only supported by transports that
+ * provide a Wait callback. Spurious returns are possible, so the caller must
+ * still handle WH_ERROR_NOTREADY from wh_Server_HandleRequestMessage().
+ *
+ * If WOLFHSM_CFG_SERVER_LANES is defined and lanes are configured, it calls
+ * the lane_wait_cb of the server config, which waits on every channel at once.
+ * Without one, it blocks on the first channel whose transport can wait, for up
+ * to WOLFHSM_CFG_SERVER_LANE_WAIT_US at a time, and before each wait checks
+ * every other channel without blocking, returning at once if one may have a
+ * request.  Channels whose transport cannot be checked are left to the caller,
+ * and the wait then returns after one slice so the caller polls them.
+ *
+ * @param[in] server Pointer to the server context.
+ * @param[in] timeout_us Maximum time to wait in microseconds, or 0 to wait
+ * indefinitely.
+ * @return int Returns 0 if a request may be available, WH_ERROR_TIMEOUT if the
+ * timeout expired, WH_ERROR_NOTIMPL if the transport of no channel can block,
+ * WH_ERROR_BADARGS if the arguments are invalid, or a negative error code on
+ * failure.
+ */
+int wh_Server_WaitRequest(whServerContext* server, uint64_t timeout_us);
+
+#ifdef WOLFHSM_CFG_SERVER_LANES
+/**
+ * @brief Returns and clears the last receive or send error of a lane that
+ * wh_Server_HandleRequestMessage() did not return.
+ *
+ * @param[in] server Pointer to the server context.
+ * @param[in] lane Lane number, 0 for the primary channel.
+ * @param[out] out_rc Kept error of the lane, or 0 if none.
+ * @return int Returns 0 on success, or WH_ERROR_BADARGS if the arguments are
+ * invalid.
+ */
+int wh_Server_GetLaneError(whServerContext* server, int lane, int* out_rc);
+#endif /* WOLFHSM_CFG_SERVER_LANES */
+
+#ifdef WOLFHSM_CFG_CANCEL_API
+/**
+ * @brief Requests cancellation of the request with the given sequence number.
+ *
+ * Call this when a cancel is delivered by the client cancel callback, for
+ * example from the interrupt handler of a doorbell. Transports with their own
+ * out of band cancel, such as the memory transport, do not need it. It only
+ * records the cancel, so it may be called while the server is handling the
+ * request, but not concurrently with itself. Only requests on the primary comm
+ * channel can be canceled, and a cancel for any request other than the next or
+ * current one is dropped.
+ *
+ * If the request has not started, it is not executed. If it is running, it
+ * stops at its next cancel check. Either way the server answers with an empty
+ * WH_MESSAGE_GROUP_CANCEL response. A cancel that arrives after the request
+ * completed is ignored and the normal response is sent.
+ *
+ * @param[in] server Pointer to the server context.
+ * @param[in] seq Sequence number of the request to cancel.
+ * @return int Returns 0 on success, or WH_ERROR_BADARGS if server is NULL.
+ */
+int wh_Server_SetCanceledSequence(whServerContext* server, uint16_t seq);
+
+/**
+ * @brief Checks whether the request being handled has been canceled.
+ *
+ * Checks both wh_Server_SetCanceledSequence() and the out of band cancel of
+ * the primary comm transport, if any. Handlers of long operations call this
+ * between chunks of work. On
+ * WH_ERROR_CANCEL, the handler must stop without further side effects and
+ * return, and the server replaces its response with the cancel response.
+ *
+ * @param[in] server Pointer to the server context.
+ * @param[in] seq Sequence number of the request being handled.
+ * @return int Returns 0 to continue, WH_ERROR_CANCEL if the request must stop,
+ * or WH_ERROR_BADARGS if server is NULL.
+ */
+int wh_Server_CheckCanceled(whServerContext* server, uint16_t seq);
+#endif /* WOLFHSM_CFG_CANCEL_API */
+
 /**
  * @brief Cleans up the server context and associated resources.
  *
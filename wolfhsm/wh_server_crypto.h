@@ -103,6 +103,21 @@ int wh_Server_MlDsaKeyCacheExport(whServerContext* ctx, whKeyId keyId,
                                   MlDsaKey* key);
 #endif /* HAVE_DILITHIUM */
 
+#ifdef WOLFHSM_CFG_SERVER_KEYCACHE_PARSED
+/* Get the decoded key object of a cached key, decoding the cached key bytes
+ * only if they changed since the last call.  type is a WH_SERVER_PARSEDKEY_*
+ * value and *out_key is set to the matching wolfCrypt key object.  The object
+ * stays owned by the server and must not be freed by the caller */
+int wh_Server_ParsedKeyGet(whServerContext* ctx, whKeyId keyId, uint16_t type,
+                           int devId, void** out_key);
+
+/* Free the decoded key object of keyId, if any */
+void wh_Server_ParsedKeyDrop(whServerContext* ctx, whKeyId keyId);
+
+/* Free all decoded key objects */
+void wh_Server_ParsedKeyFlush(whServerContext* ctx);
+#endif /* WOLFHSM_CFG_SERVER_KEYCACHE_PARSED */
+
 #ifdef HAVE_HKDF
 /* Store HKDF output into a server key cache with optional metadata */
 int wh_Server_HkdfKeyCacheImport(whServerContext* ctx, const uint8_t* keyData,
@@ -105,6 +105,49 @@ int wh_Server_KeystoreCacheKeyChecked(whServerContext* server,
 int wh_Server_KeystoreFreshenKey(whServerContext* server, whKeyId keyId,
                                  uint8_t** outBuf, whNvmMetadata** outMeta);
 
+#ifdef WOLFHSM_CFG_SERVER_KEYCACHE_PARSED
+/**
+ * @brief Get the generation of the cache slot holding a key
+ *
+ * The generation changes whenever a slot is filled, so a matching generation
+ * means the cached key bytes have not changed since it was read.
+ *
+ * @param[in]  server   Server context
+ * @param[in]  keyId    Key ID of a cached key
+ * @param[out] out_gen  Generation of the slot holding the key
+ * @return 0 on success, WH_ERROR_NOTFOUND if the key is not cached
+ */
+int wh_Server_KeystoreGetCacheGen(whServerContext* server, whKeyId keyId,
+                                  uint32_t* out_gen);
+#endif /* WOLFHSM_CFG_SERVER_KEYCACHE_PARSED */
+
+#ifndef WOLFHSM_CFG_NO_CRYPTO
+/**
+ * @brief Get the hit, miss and eviction counts of a key cache
+ *
+ * Key uses through wh_Server_KeystoreFreshenKey() and
+ * wh_Server_KeystoreReadKey() count as a hit or a miss.  Evictions count the
+ * committed keys dropped to make room for another key.
+ *
+ * @param[in]  server     Server context
+ * @param[in]  global     Nonzero for the global key cache, which requires
+ *                        WOLFHSM_CFG_GLOBAL_KEYS, or 0 for the local one
+ * @param[out] out_stats  Current statistics
+ * @return 0 on success, WH_ERROR_BADARGS on invalid arguments
+ */
+int wh_Server_KeystoreGetCacheStats(whServerContext* server, int global,
+                                    whKeyCacheStats* out_stats);
+
+/**
+ * @brief Reset the statistics of a key cache to zero
+ *
+ * @param[in] server  Server context
+ * @param[in] global  Nonzero for the global key cache, or 0 for the local one
+ * @return 0 on success, WH_ERROR_BADARGS on invalid arguments
+ */
+int wh_Server_KeystoreResetCacheStats(whServerContext* server, int global);
+#endif /* !WOLFHSM_CFG_NO_CRYPTO */
+
 /**
  * @brief Read a key from cache or NVM
  *
@@ -191,6 +234,60 @@ int wh_Server_KeystoreEraseKeyChecked(whServerContext* server, whNvmId keyId);
  */
 int wh_Server_KeystoreRevokeKey(whServerContext* server, whKeyId keyId);
 
+/**
+ * @brief Pin a key in the cache so it is never evicted to make room
+ *
+ * Loads the key from NVM if it is not cached.  The key stays pinned until it
+ * is unpinned or explicitly evicted, erased or replaced.  The clients of a
+ * connection, its own and those of its sessions, may pin up to
+ * WOLFHSM_CFG_SERVER_KEYCACHE_PIN_MAX keys together.
+ *
+ * @param[in] server  Server context
+ * @param[in] keyId   Key ID to pin
+ * @return 0 on success, WH_ERROR_NOSPACE if the connection already pinned the
+ *         maximum number of keys, WH_ERROR_ACCESS if another client pinned
+ *         the key, or a negative error code on failure
+ */
+int wh_Server_KeystorePinKey(whServerContext* server, whKeyId keyId);
+
+/**
+ * @brief Unpin a cached key, so it may be evicted again
+ *
+ * @param[in] server  Server context
+ * @param[in] keyId   Key ID to unpin
+ * @return 0 on success, WH_ERROR_NOTFOUND if the key is not cached,
+ *         WH_ERROR_ACCESS if another client pinned the key, or a negative
+ *         error code on failure
+ */
+int wh_Server_KeystoreUnpinKey(whServerContext* server, whKeyId keyId);
+
+/**
+ * @brief Unpin every key a client pinned
+ *
+ * Releases the pins of clientId in the local cache of server and in the global
+ * cache, so pins in the shared global cache do not outlive the client.  Called
+ * for the client and each session of a connection when it disconnects, when a
+ * session closes and on server cleanup.  The caller must hold the NVM lock.
+ *
+ * @param[in] server    Server context
+ * @param[in] clientId  Client whose pins are released
+ * @return 0 on success, or WH_ERROR_BADARGS if server is NULL
+ */
+int wh_Server_KeystoreUnpinClient(whServerContext* server, uint8_t clientId);
+
+/**
+ * @brief Evict every key of a client from the local cache
+ *
+ * Drops the keys of clientId, pinned or not and committed or not, from the
+ * local cache of server without writing them to NVM.  Called when a session
+ * closes, so its keys do not stay in the cache the sessions share.
+ *
+ * @param[in] server    Server context
+ * @param[in] clientId  Client whose keys are evicted
+ * @return 0 on success, or WH_ERROR_BADARGS if server is NULL
+ */
+int wh_Server_KeystoreEvictClient(whServerContext* server, uint8_t clientId);
+
 /**
  * @brief Handle key management requests from clients
  *
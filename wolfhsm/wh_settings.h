@@ -60,6 +60,72 @@
  *  WOLFHSM_CFG_ENABLE_TIMEOUT - If defined, include client-side support for
  *  blocking request timeouts
  *
+ *  WOLFHSM_CFG_CLIENT_PIPELINE - If defined, include client-side support for
+ *  multiple outstanding (pipelined) requests matched by sequence number
+ *      Default: Not defined
+ *
+ *  WOLFHSM_CFG_CLIENT_PIPELINE_DEPTH - Maximum number of outstanding pipelined
+ *  requests per client
+ *      Default: 8
+ *
+ *  WOLFHSM_CFG_CLIENT_WAIT - If defined, blocking client functions follow a
+ *  spin, then yield, then block wait policy per operation class instead of
+ *  only spinning while waiting for a response.  See whClientWaitConfig
+ *      Default: Not defined
+ *
+ *  WOLFHSM_CFG_CLIENT_WAIT_SHORT_SPIN, _SHORT_YIELD, _SHORT_BLOCK_US,
+ *  WOLFHSM_CFG_CLIENT_WAIT_LONG_SPIN, _LONG_YIELD, _LONG_BLOCK_US - Default
+ *  wait policy of short operations (hashes, ciphers, NVM, ...) and long
+ *  operations (public key operations and key generation): polls to spin,
+ *  polls to yield, and the maximum time to block in each later poll
+ *      Default: 10000, 100, 100 and 100, 10, 1000
+ *
+ *  WOLFHSM_CFG_BATCH - If defined, include client and server support for the
+ *  batch message group, which carries several sub-requests in one packet.
+ *  Adds a WOLFHSM_CFG_COMM_DATA_LEN response buffer to the server context
+ *      Default: Not defined
+ *
+ *  WOLFHSM_CFG_CANCEL_API - If defined, a client can cancel its outstanding
+ *  request through an out of band cancel callback.  The server checks for a
+ *  cancel before dispatching each request, between the sub-requests of a batch
+ *  and between chunks of DMA hash input, and answers a canceled request with an
+ *  empty WH_MESSAGE_GROUP_CANCEL response.  Other operations run to completion
+ *  once started
+ *      Default: Not defined
+ *
+ *  WOLFHSM_CFG_SERVER_CANCEL_CHUNK - Bytes of DMA input hashed between checks
+ *  for a cancel
+ *      Default: 16384
+ *
+ *  WOLFHSM_CFG_COMM_FRAGMENT - If defined, comm contexts configured with a
+ *  fragment_size split packets into fragments of that size with per-fragment
+ *  flow control and reassemble them on receipt, so transport buffers may be
+ *  much smaller than the messages they carry.  Pipelined requests and
+ *  responses must each fit in one fragment while fragmenting
+ *      Default: Not defined
+ *
+ *  WOLFHSM_CFG_COMM_FRAGMENT_DATA_LEN - Maximum length of the data portion of a
+ *  message on a fragmenting channel.  The client streams the data beyond
+ *  WOLFHSM_CFG_COMM_DATA_LEN from and into the caller's buffers, and the server
+ *  reassembles it into the frag_buffer of its comm config.  NVM, certificate
+ *  and ML-DSA messages may use all of it.  Must be at least
+ *  WOLFHSM_CFG_COMM_DATA_LEN and at most 65512
+ *      Default: WOLFHSM_CFG_COMM_DATA_LEN
+ *
+ *  WOLFHSM_CFG_COMM_SESSIONS - If defined, many logical clients (sessions) may
+ *  share one transport connection and server context.  Each session has its
+ *  own client_id and sequence numbers and is identified by the header aux
+ *      Default: Not defined
+ *
+ *  WOLFHSM_CFG_SERVER_SESSION_COUNT - Number of sessions a server context can
+ *  have open at once, in addition to the connection's own client
+ *      Default: 8
+ *
+ *  WOLFHSM_CFG_COMM_NATIVE_ONLY - If defined, the client and server must have
+ *  the same endianness.  Message translation compiles to plain copies and
+ *  packets from a peer of the other endianness are rejected
+ *      Default: Not defined
+ *
  *  WOLFHSM_CFG_NVM_OBJECT_COUNT - Number of objects in ram and disk directories
  *      Default: 32
  *
@@ -69,9 +135,80 @@
  *  WOLFHSM_CFG_SERVER_KEYCACHE_BUFSIZE - Size of each key in RAM
  *      Default: 1200
  *
+ *  WOLFHSM_CFG_SERVER_KEYCACHE_POOL - If defined, each key cache stores keys
+ *  of any size up to the larger of WOLFHSM_CFG_SERVER_KEYCACHE_BUFSIZE and
+ *  _BIG_BUFSIZE in one memory pool instead of in fixed regular and big slots,
+ *  so a key only takes the space it needs.  WOLFHSM_CFG_SERVER_KEYCACHE_COUNT
+ *  and _BIG_COUNT then only set the defaults below
+ *      Default: Not defined
+ *
+ *  WOLFHSM_CFG_SERVER_KEYCACHE_POOL_SIZE - Size in bytes of the memory pool of
+ *  each key cache
+ *      Default: The size of the fixed slots, COUNT * BUFSIZE +
+ *               BIG_COUNT * BIG_BUFSIZE
+ *
+ *  WOLFHSM_CFG_SERVER_KEYCACHE_POOL_KEYS - Number of keys each key cache can
+ *  hold with the pool
+ *      Default: 4 * (WOLFHSM_CFG_SERVER_KEYCACHE_COUNT +
+ *                    WOLFHSM_CFG_SERVER_KEYCACHE_BIG_COUNT)
+ *
+ *  WOLFHSM_CFG_SERVER_KEYCACHE_POOL_GRANULE - Allocation unit of the pool in
+ *  bytes.  Key sizes are rounded up to a multiple of it
+ *      Default: 32
+ *
+ *  WOLFHSM_CFG_SERVER_KEYCACHE_INDEX_SIZE - Number of buckets in the key ID
+ *  index of each key cache.  Must be larger than the total number of RAM keys
+ *      Default: 2 * (WOLFHSM_CFG_SERVER_KEYCACHE_COUNT +
+ *                    WOLFHSM_CFG_SERVER_KEYCACHE_BIG_COUNT), or
+ *               2 * WOLFHSM_CFG_SERVER_KEYCACHE_POOL_KEYS with the pool
+ *
+ *  WOLFHSM_CFG_SERVER_KEYCACHE_LRU - If defined, a full key cache evicts the
+ *  least recently used committed key
+ *      Default: Not defined
+ *
+ *  WOLFHSM_CFG_SERVER_KEYCACHE_LFU - If defined, a full key cache evicts the
+ *  least frequently used committed key.  Use counts are halved on each
+ *  eviction so keys that are no longer used age out
+ *      Default: Not defined.  Without LRU or LFU, the first committed key found
+ *      is evicted
+ *
+ *  WOLFHSM_CFG_SERVER_KEYCACHE_PIN_MAX - Number of keys each connection may
+ *  pin in the key caches, shared by its sessions.  Pinned keys are never
+ *  evicted to make room, so uses of them never read NVM.  0 disables pinning
+ *      Default: WOLFHSM_CFG_SERVER_KEYCACHE_COUNT / 2
+ *
+ *  WOLFHSM_CFG_SERVER_KEYCACHE_PARSED - If defined, each server context can
+ *  keep the decoded wolfCrypt object of recently used RSA, ECC, Ed25519 and
+ *  ML-DSA cached keys resident through wh_Server_ParsedKeyGet(), so server
+ *  code such as custom callbacks can skip decoding the key on repeated use.
+ *  The built-in crypto handlers still decode the key on every request
+ *      Default: Not defined
+ *
+ *  WOLFHSM_CFG_SERVER_KEYCACHE_PARSED_COUNT - Number of decoded key objects
+ *  kept resident per server context.  Each entry holds a union of the enabled
+ *  RsaKey, ecc_key, ed25519_key and MlDsaKey types, so every server context
+ *  grows by this count times the largest of them, which for RSA and ML-DSA is
+ *  several kilobytes.  Keep server contexts off small stacks when raising it
+ *      Default: 1
+ *
  *  WOLFHSM_CFG_SERVER_CUSTOMCB_COUNT - Number of additional callbacks
  *      Default: 8
  *
+ *  WOLFHSM_CFG_SERVER_LANES - If defined, a server context may serve several
+ *  comm channels (lanes) in priority order, so requests on a control lane are
+ *  never queued behind bulk requests on a lower priority lane
+ *      Default: Not defined
+ *
+ *  WOLFHSM_CFG_SERVER_LANE_COUNT - Number of lanes per server context,
+ *  including the primary channel
+ *      Default: 2
+ *
+ *  WOLFHSM_CFG_SERVER_LANE_WAIT_US - Microseconds wh_Server_WaitRequest blocks
+ *  on one lane before checking the others again, bounding the added latency
+ *  of a request on another lane.  Unused by servers configured with a
+ *  lane_wait_cb
+ *      Default: 1000
+ *
  *  WOLFHSM_CFG_DMAADDR_COUNT - Number of DMA address regions
  *      Default: 10
  *
@@ -194,7 +331,72 @@
 #define WOLFHSM_CFG_COMM_DATA_LEN 1280
 #endif
 
+#ifdef WOLFHSM_CFG_COMM_FRAGMENT
+/* Maximum length of the data portion of a reassembled message */
+#ifndef WOLFHSM_CFG_COMM_FRAGMENT_DATA_LEN
+#define WOLFHSM_CFG_COMM_FRAGMENT_DATA_LEN WOLFHSM_CFG_COMM_DATA_LEN
+#endif
+
+#if WOLFHSM_CFG_COMM_FRAGMENT_DATA_LEN < WOLFHSM_CFG_COMM_DATA_LEN
+#error "WOLFHSM_CFG_COMM_FRAGMENT_DATA_LEN must be at least WOLFHSM_CFG_COMM_DATA_LEN"
+#endif
+/* Fragment offsets and sizes must fit in 16 bits */
+#if WOLFHSM_CFG_COMM_FRAGMENT_DATA_LEN > 65512
+#error "WOLFHSM_CFG_COMM_FRAGMENT_DATA_LEN must be at most 65512"
+#endif
+#endif /* WOLFHSM_CFG_COMM_FRAGMENT */
+
+/* Maximum number of outstanding pipelined client requests */
+#ifndef WOLFHSM_CFG_CLIENT_PIPELINE_DEPTH
+#define WOLFHSM_CFG_CLIENT_PIPELINE_DEPTH 8
+#endif
+
+/* Default client wait policy of short operations */
+#ifndef WOLFHSM_CFG_CLIENT_WAIT_SHORT_SPIN
+#define WOLFHSM_CFG_CLIENT_WAIT_SHORT_SPIN 10000
+#endif
+#ifndef WOLFHSM_CFG_CLIENT_WAIT_SHORT_YIELD
+#define WOLFHSM_CFG_CLIENT_WAIT_SHORT_YIELD 100
+#endif
+#ifndef WOLFHSM_CFG_CLIENT_WAIT_SHORT_BLOCK_US
+#define WOLFHSM_CFG_CLIENT_WAIT_SHORT_BLOCK_US 100
+#endif
+
+/* Default client wait policy of long operations */
+#ifndef WOLFHSM_CFG_CLIENT_WAIT_LONG_SPIN
+#define WOLFHSM_CFG_CLIENT_WAIT_LONG_SPIN 100
+#endif
+#ifndef WOLFHSM_CFG_CLIENT_WAIT_LONG_YIELD
+#define WOLFHSM_CFG_CLIENT_WAIT_LONG_YIELD 10
+#endif
+#ifndef WOLFHSM_CFG_CLIENT_WAIT_LONG_BLOCK_US
+#define WOLFHSM_CFG_CLIENT_WAIT_LONG_BLOCK_US 1000
+#endif
+
 /** Default server resource configurations */
+/* Number of prioritized comm channels per server, including the primary */
+#ifndef WOLFHSM_CFG_SERVER_LANE_COUNT
+#define WOLFHSM_CFG_SERVER_LANE_COUNT 2
+#endif
+#if defined(WOLFHSM_CFG_SERVER_LANES) && (WOLFHSM_CFG_SERVER_LANE_COUNT < 2)
+#error "WOLFHSM_CFG_SERVER_LANE_COUNT must be at least 2"
+#endif
+
+/* Time wh_Server_WaitRequest blocks on one lane between checks of the rest */
+#ifndef WOLFHSM_CFG_SERVER_LANE_WAIT_US
+#define WOLFHSM_CFG_SERVER_LANE_WAIT_US 1000
+#endif
+
+/* Sessions open at once per server context */
+#ifndef WOLFHSM_CFG_SERVER_SESSION_COUNT
+#define WOLFHSM_CFG_SERVER_SESSION_COUNT 8
+#endif
+
+/* Bytes of input processed between checks for a canceled request */
+#ifndef WOLFHSM_CFG_SERVER_CANCEL_CHUNK
+#define WOLFHSM_CFG_SERVER_CANCEL_CHUNK 16384
+#endif
+
 /* Reported version string */
 #ifndef WOLFHSM_CFG_INFOVERSION
 #define WOLFHSM_CFG_INFOVERSION "01.01.01"
@@ -230,6 +432,74 @@
 #define WOLFHSM_CFG_SERVER_KEYCACHE_BIG_BUFSIZE 1200
 #endif
 
+/* Key memory pool of each key cache */
+#ifdef WOLFHSM_CFG_SERVER_KEYCACHE_POOL
+#ifndef WOLFHSM_CFG_SERVER_KEYCACHE_POOL_SIZE
+#define WOLFHSM_CFG_SERVER_KEYCACHE_POOL_SIZE                                 \
+    (WOLFHSM_CFG_SERVER_KEYCACHE_COUNT * WOLFHSM_CFG_SERVER_KEYCACHE_BUFSIZE + \
+     WOLFHSM_CFG_SERVER_KEYCACHE_BIG_COUNT *                                  \
+         WOLFHSM_CFG_SERVER_KEYCACHE_BIG_BUFSIZE)
+#endif
+
+#ifndef WOLFHSM_CFG_SERVER_KEYCACHE_POOL_KEYS
+#define WOLFHSM_CFG_SERVER_KEYCACHE_POOL_KEYS   \
+    (4 * (WOLFHSM_CFG_SERVER_KEYCACHE_COUNT + \
+          WOLFHSM_CFG_SERVER_KEYCACHE_BIG_COUNT))
+#endif
+
+#ifndef WOLFHSM_CFG_SERVER_KEYCACHE_POOL_GRANULE
+#define WOLFHSM_CFG_SERVER_KEYCACHE_POOL_GRANULE 32
+#endif
+
+/* Number of granules in each pool */
+#define WH_KEYCACHE_POOL_GRANULES            \
+    (WOLFHSM_CFG_SERVER_KEYCACHE_POOL_SIZE / \
+     WOLFHSM_CFG_SERVER_KEYCACHE_POOL_GRANULE)
+
+#if (WH_KEYCACHE_POOL_GRANULES * WOLFHSM_CFG_SERVER_KEYCACHE_POOL_GRANULE < \
+     WOLFHSM_CFG_SERVER_KEYCACHE_BUFSIZE) ||                                 \
+    (WH_KEYCACHE_POOL_GRANULES * WOLFHSM_CFG_SERVER_KEYCACHE_POOL_GRANULE < \
+     WOLFHSM_CFG_SERVER_KEYCACHE_BIG_BUFSIZE)
+#error "WOLFHSM_CFG_SERVER_KEYCACHE_POOL_SIZE must hold the largest key"
+#endif
+#if WH_KEYCACHE_POOL_GRANULES > 0xFFFF
+#error "Too many granules in WOLFHSM_CFG_SERVER_KEYCACHE_POOL_SIZE"
+#endif
+
+/* Number of keys in each key cache */
+#define WH_KEYCACHE_SLOT_COUNT WOLFHSM_CFG_SERVER_KEYCACHE_POOL_KEYS
+#else
+#define WH_KEYCACHE_SLOT_COUNT \
+    (WOLFHSM_CFG_SERVER_KEYCACHE_COUNT + WOLFHSM_CFG_SERVER_KEYCACHE_BIG_COUNT)
+#endif /* WOLFHSM_CFG_SERVER_KEYCACHE_POOL */
+
+/* Number of buckets in the key ID index of each key cache */
+#ifndef WOLFHSM_CFG_SERVER_KEYCACHE_INDEX_SIZE
+#define WOLFHSM_CFG_SERVER_KEYCACHE_INDEX_SIZE (2 * WH_KEYCACHE_SLOT_COUNT)
+#endif
+#if WOLFHSM_CFG_SERVER_KEYCACHE_INDEX_SIZE <= WH_KEYCACHE_SLOT_COUNT
+#error "WOLFHSM_CFG_SERVER_KEYCACHE_INDEX_SIZE must exceed the number of RAM keys"
+#endif
+#if WH_KEYCACHE_SLOT_COUNT >= 0xFFFF
+#error "Too many RAM keys for the key ID index"
+#endif
+
+#if defined(WOLFHSM_CFG_SERVER_KEYCACHE_LRU) && \
+    defined(WOLFHSM_CFG_SERVER_KEYCACHE_LFU)
+#error "Define at most one of WOLFHSM_CFG_SERVER_KEYCACHE_LRU and _LFU"
+#endif
+
+/* Number of keys each connection may pin */
+#ifndef WOLFHSM_CFG_SERVER_KEYCACHE_PIN_MAX
+#define WOLFHSM_CFG_SERVER_KEYCACHE_PIN_MAX \
+    (WOLFHSM_CFG_SERVER_KEYCACHE_COUNT / 2)
+#endif
+
+/* Number of decoded key objects per server context */
+#ifndef WOLFHSM_CFG_SERVER_KEYCACHE_PARSED_COUNT
+#define WOLFHSM_CFG_SERVER_KEYCACHE_PARSED_COUNT 1
+#endif
+
 /* Custom request shared defs */
 #ifndef WOLFHSM_CFG_SERVER_CUSTOMCB_COUNT
 #define WOLFHSM_CFG_SERVER_CUSTOMCB_COUNT 8
@@ -266,7 +536,11 @@
 /* Maximum size of a certificate */
 #ifndef WOLFHSM_CFG_MAX_CERT_SIZE
 #ifndef WOLFHSM_CFG_DMA
+#ifdef WOLFHSM_CFG_COMM_FRAGMENT
+#define WOLFHSM_CFG_MAX_CERT_SIZE WOLFHSM_CFG_COMM_FRAGMENT_DATA_LEN
+#else
 #define WOLFHSM_CFG_MAX_CERT_SIZE WOLFHSM_CFG_COMM_DATA_LEN
+#endif
 #else
 #define WOLFHSM_CFG_MAX_CERT_SIZE 4096
 #endif
@@ -430,6 +704,11 @@
 #error "WOLFHSM_CFG_KEYWRAP is incompatible with WOLFHSM_CFG_NO_CRYPTO"
 #endif
 
+#if defined(WOLFHSM_CFG_NO_CRYPTO) && \
+    defined(WOLFHSM_CFG_SERVER_KEYCACHE_PARSED)
+#error "WOLFHSM_CFG_SERVER_KEYCACHE_PARSED is incompatible with WOLFHSM_CFG_NO_CRYPTO"
+#endif
+
 /** Cache flushing and memory fencing synchronization primitives */
 /* Create a full sequential memory fence to ensure compiler memory ordering */
 #ifndef XMEMFENCE
@@ -0,0 +1,152 @@
+/*
+ * Copyright (C) 2025 wolfSSL Inc.
+ *
+ * This file is part of wolfHSM.
+ *
+ * wolfHSM is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * wolfHSM is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with wolfHSM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/*
+ * wolfhsm/wh_transport_direct.h
+ *
+ * wolfHSM Transport binding that dispatches requests directly to a server in
+ * the same process
+ */
+
+/* Direct dispatch comms
+ * When the client and server are built into the same image and run from the
+ * same thread, the client transport can hand each request straight to the
+ * server instead of signalling another thread or core.  The client and server
+ * share one transport context holding a single packet buffer.
+ *
+ * The client sends a request by:
+ *  1. Check the previous response has been received
+ *  2. Write request data into the buffer, unless it was built in place
+ *  3. Call wh_Server_HandleRequestMessage() on the configured server, which
+ *     handles the request in place in the buffer and builds the response there
+ *
+ * The client receives a response by:
+ *  1. Check the server has sent a response
+ *  2. Read response data from the buffer
+ *
+ * A request built in place with the client GetSendBuffer callback is not
+ * copied before the server handles it, and the server comm context works in
+ * the buffer through the server GetBuffer callback.  The response is copied
+ * once, into the client comm buffer, since the next request reuses the shared
+ * buffer.
+ *
+ * There is no polling, cache maintenance or server loop iteration, so this is
+ * the lowest overhead transport and a baseline for the cost of the others.
+ * The server must only be driven through this transport: do not also run a
+ * server loop on it from another thread.  If the server is not ready when the
+ * request is sent, the request is dispatched again when the client polls for
+ * the response.  Client Init marks the server as connected and client Cleanup
+ * marks it as disconnected.
+ *
+ * Example usage:
+ *
+ * whServerContext server[1];
+ *
+ * whTransportDirectConfig tdcfg[1] = {{
+ *      .server = server,
+ * }};
+ * whTransportDirectContext tdctx[1] = {0};
+ *
+ * whTransportClientCb tdccb[1] = {WH_TRANSPORT_DIRECT_CLIENT_CB};
+ * whCommClientConfig ccc[1] = {{
+ *      .transport_cb = tdccb,
+ *      .transport_context = tdctx,
+ *      .transport_config = tdcfg,
+ *      .client_id = 1
+ * }};
+ *
+ * whTransportServerCb tdscb[1] = {WH_TRANSPORT_DIRECT_SERVER_CB};
+ * whCommServerConfig csc[1] = {{
+ *      .transport_cb = tdscb,
+ *      .transport_context = tdctx,
+ *      .transport_config = tdcfg,
+ *      .server_id = 2,
+ * }};
+ *
+ * Initialize the server with csc before initializing the client with ccc.
+ */
+
+#ifndef WOLFHSM_WH_TRANSPORT_DIRECT_H_
+#define WOLFHSM_WH_TRANSPORT_DIRECT_H_
+
+/* Pick up compile-time configuration */
+#include "wolfhsm/wh_settings.h"
+
+#if defined(WOLFHSM_CFG_ENABLE_CLIENT) && defined(WOLFHSM_CFG_ENABLE_SERVER)
+
+#include <stdint.h>
+
+#include "wolfhsm/wh_comm.h"
+#include "wolfhsm/wh_server.h"
+
+/** Common configuration structure */
+typedef struct {
+    whServerContext* server; /* Server that handles each request */
+} whTransportDirectConfig;
+
+/** Common context, shared by the client and server */
+typedef struct {
+    uint64_t buffer[WH_COMM_MTU_U64_COUNT]; /* Request, then response */
+    whServerContext* server;
+    int initialized;
+    uint16_t len;       /* Length of the request or response in buffer */
+    uint8_t req_ready;  /* Request written, not yet received by the server */
+    uint8_t resp_ready; /* Response written, not yet received by the client */
+} whTransportDirectContext;
+
+/* Naming conveniences. Reuses the same types. */
+typedef whTransportDirectContext whTransportDirectClientContext;
+typedef whTransportDirectContext whTransportDirectServerContext;
+
+/** Callback function declarations */
+int wh_TransportDirect_InitConnect(void* c, const void* cf,
+        whCommSetConnectedCb connectcb, void* connectcb_arg);
+int wh_TransportDirect_InitListen(void* c, const void* cf,
+        whCommSetConnectedCb connectcb, void* connectcb_arg);
+int wh_TransportDirect_CleanupConnect(void* c);
+int wh_TransportDirect_CleanupListen(void* c);
+int wh_TransportDirect_SendRequest(void* c, uint16_t len, const void* data);
+int wh_TransportDirect_RecvRequest(void* c, uint16_t* out_len, void* data);
+int wh_TransportDirect_SendResponse(void* c, uint16_t len, const void* data);
+int wh_TransportDirect_RecvResponse(void* c, uint16_t* out_len, void* data);
+int wh_TransportDirect_GetSendBuffer(void* c, uint16_t* out_size,
+        void** out_buffer);
+int wh_TransportDirect_GetBuffer(void* c, uint16_t* out_size,
+        void** out_buffer);
+
+#define WH_TRANSPORT_DIRECT_CLIENT_CB                   \
+{                                                       \
+    .Init =          wh_TransportDirect_InitConnect,    \
+    .Send =          wh_TransportDirect_SendRequest,    \
+    .Recv =          wh_TransportDirect_RecvResponse,   \
+    .Cleanup =       wh_TransportDirect_CleanupConnect, \
+    .GetSendBuffer = wh_TransportDirect_GetSendBuffer,  \
+}
+
+#define WH_TRANSPORT_DIRECT_SERVER_CB                   \
+{                                                       \
+    .Init =          wh_TransportDirect_InitListen,     \
+    .Recv =          wh_TransportDirect_RecvRequest,    \
+    .Send =          wh_TransportDirect_SendResponse,   \
+    .Cleanup =       wh_TransportDirect_CleanupListen,  \
+    .GetBuffer =     wh_TransportDirect_GetBuffer,      \
+}
+
+#endif /* WOLFHSM_CFG_ENABLE_CLIENT && WOLFHSM_CFG_ENABLE_SERVER */
+
+#endif /* !WOLFHSM_WH_TRANSPORT_DIRECT_H_ */
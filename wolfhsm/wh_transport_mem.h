@@ -37,6 +37,9 @@
  *  3. Increments requestid: req_id = req->notify++
  *  4. Optionally sends notify interrupt to server.
  *
+ * Alternatively, the client may build the request directly in req->data[],
+ * obtained with wh_TransportMem_GetSendBuffer(), and skip the copy in step 2.
+ *
  * The client receives a response to req_id by:
  *  1. Check if the request is complete: resp->notify == req_id
  *  2. Read response data: data[] = resp->data[]
@@ -52,6 +55,29 @@
  *  3. Optionally send notify interrupt to client
  *
  *
+ * The client cancels the outstanding request by:
+ *  1. Setting the cancel field of the request CSR to the request's notify
+ *
+ * The server checks whether the request it is handling was canceled with:
+ *  1. req->cancel == req->notify, while req->notify != resp->notify
+ *
+ * Only the client writes the request CSR, so the cancel can be written while
+ * the server is handling the request.  Each new request leaves the cancel field
+ * on the previous notify value, so a late cancel never applies to it.
+ *
+ *
+ * Cache line layout
+ *
+ * By default, the data of each buffer immediately follows its CSR, so the CSR
+ * shares a cache line with the start of the data.  When the client and server
+ * run on different cores, each poll of a CSR then contends with writes to the
+ * data next to it.  Setting csr_size to WH_TRANSPORT_MEM_CSR_SIZE_CACHELINE
+ * (XCACHELINE) pads each CSR to a full cache line and starts the data on the
+ * next line.  The data size is rounded down to whole lines, so the data never
+ * shares a line with memory following the buffer.  Both buffers must be aligned
+ * to csr_size, and the client and server must use the same csr_size.
+ *
+ *
  * Example usage:
  *
  * uint8_t req_buffer[4096];
@@ -60,7 +86,7 @@
  * whTransportMemConfig tmcfg[1] = {{
  *      .req = req_buffer,
  *      .req_size = sizeof(req_buffer),
- *      .resp = resp_buffer
+ *      .resp = resp_buffer,
  *      .resp_size = sizeof(resp_buffer),
  * }};
  *
@@ -86,6 +112,41 @@
  * whCommServer cs[1] = {0};
  * wh_CommServer_Init(cs, csc);
  *
+ *
+ * Multi-slot ring mode
+ *
+ * The ring variant splits each of the request and response buffers into
+ * slot_count equally sized slots.  Every slot begins with its own CSR followed
+ * by the slot data, so up to slot_count requests may be in flight at once.
+ * Slots are used strictly in order, and the server responds in the same order
+ * it received requests, which preserves the in-order delivery expected by
+ * wh_CommClient and wh_CommServer.
+ *
+ * The client sends a request by:
+ *  1. Check the number of outstanding requests is less than slot_count
+ *  2. Write request data into slot send_idx and increment its notify
+ *  3. Advance send_idx to the next slot
+ *
+ * The client receives a response by:
+ *  1. Check a request is outstanding and resp[recv_idx].notify matches
+ *  2. Read response data and advance recv_idx to the next slot
+ *
+ * The server follows the same steps with the request and response roles
+ * swapped, using recv_idx for requests and send_idx for responses.
+ *
+ * Example usage:
+ *
+ * whTransportMemRingConfig tmrcfg[1] = {{
+ *      .req = req_buffer,
+ *      .req_size = sizeof(req_buffer),
+ *      .resp = resp_buffer,
+ *      .resp_size = sizeof(resp_buffer),
+ *      .slot_count = 4,
+ * }};
+ *
+ * whTransportClientCb tmrccb[1] = {WH_TRANSPORT_MEM_RING_CLIENT_CB};
+ * whTransportMemRingClientContext tmrcc[1] = {0};
+ *
  */
 
 #ifndef WOLFHSM_WH_TRANSPORT_MEM_H_
@@ -98,13 +159,20 @@
 
 #include "wolfhsm/wh_comm.h"
 
+/* Size of a CSR padded to its own cache line.  Use as csr_size */
+#define WH_TRANSPORT_MEM_CSR_SIZE_CACHELINE XCACHELINE
+
 /** Common configuration structure */
 typedef struct {
     void* req;
     void* resp;
     uint16_t req_size;
     uint16_t resp_size;
-    uint8_t WH_PAD[4];
+    uint16_t csr_size;  /* Opt: Space for each CSR ahead of its data. 0 packs
+                         * the data right after the CSR.  Otherwise a power
+                         * of 2, such as WH_TRANSPORT_MEM_CSR_SIZE_CACHELINE,
+                         * that req and resp are aligned to. */
+    uint8_t WH_PAD[2];
 } whTransportMemConfig;
 
 
@@ -116,7 +184,7 @@ typedef union whTransportMemCsr_t {
     struct {
         uint16_t notify;   /* Incremented to notify */
         uint16_t len;      /* Length of data */
-        uint16_t ack;      /* Opt: Acknowledge the reverse notify */
+        uint16_t cancel;   /* Opt: Request notify value to cancel */
         uint16_t wait;     /* Opt: Incremented while waiting*/
     } s;
 } whTransportMemCsr;
@@ -129,6 +197,9 @@ typedef struct {
     int initialized;
     uint16_t req_size;
     uint16_t resp_size;
+    uint16_t req_data_size;  /* Space for request data after the CSR */
+    uint16_t resp_data_size; /* Space for response data after the CSR */
+    uint8_t WH_PAD[4];
 } whTransportMemContext;
 
 /* Naming conveniences. Reuses the same types. */
@@ -145,21 +216,94 @@ int wh_TransportMem_SendRequest(void* c, uint16_t len, const void* data);
 int wh_TransportMem_RecvRequest(void* c, uint16_t* out_len, void* data);
 int wh_TransportMem_SendResponse(void* c, uint16_t len, const void* data);
 int wh_TransportMem_RecvResponse(void* c, uint16_t* out_len, void* data);
+int wh_TransportMem_CompleteRequest(void* c);
+int wh_TransportMem_GetSendBuffer(void* c, uint16_t* out_size,
+        void** out_buffer);
+int wh_TransportMem_CancelRequest(void* c);
+int wh_TransportMem_CheckCanceled(void* c);
+int wh_TransportMem_PendingRequest(void* c);
+
+#define WH_TRANSPORT_MEM_CLIENT_CB                  \
+{                                                   \
+    .Init =          wh_TransportMem_InitClear,     \
+    .Send =          wh_TransportMem_SendRequest,   \
+    .Recv =          wh_TransportMem_RecvResponse,  \
+    .Cleanup =       wh_TransportMem_Cleanup,       \
+    .GetSendBuffer = wh_TransportMem_GetSendBuffer, \
+    .Cancel =        wh_TransportMem_CancelRequest, \
+}
+
+#define WH_TRANSPORT_MEM_SERVER_CB                    \
+{                                                     \
+    .Init =          wh_TransportMem_Init,            \
+    .Recv =          wh_TransportMem_RecvRequest,     \
+    .Send =          wh_TransportMem_SendResponse,    \
+    .Cleanup =       wh_TransportMem_Cleanup,         \
+    .Complete =      wh_TransportMem_CompleteRequest, \
+    .Canceled =      wh_TransportMem_CheckCanceled,   \
+    .Pending =       wh_TransportMem_PendingRequest,  \
+}
+
+/** Multi-slot ring configuration structure */
+typedef struct {
+    void*    req;
+    void*    resp;
+    uint16_t req_size;   /* Total size of the request buffer */
+    uint16_t resp_size;  /* Total size of the response buffer */
+    uint16_t slot_count; /* Number of request/response slots */
+    uint8_t  WH_PAD[2];
+} whTransportMemRingConfig;
+
+/** Multi-slot ring context */
+typedef struct {
+    uint8_t* req;
+    uint8_t* resp;
+    int      initialized;
+    uint16_t req_slot_size;  /* Stride of each request slot, including CSR */
+    uint16_t resp_slot_size; /* Stride of each response slot, including CSR */
+    uint16_t slot_count;
+    uint16_t send_idx; /* Next slot to send into */
+    uint16_t recv_idx; /* Next slot to receive from */
+    uint16_t pending;  /* Client: sent, not received. Server: received, not
+                        * responded */
+} whTransportMemRingContext;
+
+/* Naming conveniences. Reuses the same types. */
+typedef whTransportMemRingContext whTransportMemRingClientContext;
+typedef whTransportMemRingContext whTransportMemRingServerContext;
+
+/** Multi-slot ring callback function declarations */
+int wh_TransportMemRing_Init(void* c, const void* cf,
+        whCommSetConnectedCb connectcb, void* connectcb_arg);
+int wh_TransportMemRing_InitClear(void* c, const void* cf,
+        whCommSetConnectedCb connectcb, void* connectcb_arg);
+int wh_TransportMemRing_Cleanup(void* c);
+int wh_TransportMemRing_SendRequest(void* c, uint16_t len, const void* data);
+int wh_TransportMemRing_RecvRequest(void* c, uint16_t* out_len, void* data);
+int wh_TransportMemRing_SendResponse(void* c, uint16_t len, const void* data);
+int wh_TransportMemRing_RecvResponse(void* c, uint16_t* out_len, void* data);
+int wh_TransportMemRing_CompleteRequest(void* c);
+int wh_TransportMemRing_GetSendBuffer(void* c, uint16_t* out_size,
+        void** out_buffer);
+int wh_TransportMemRing_PendingRequest(void* c);
 
-#define WH_TRANSPORT_MEM_CLIENT_CB              \
-{                                               \
-    .Init =     wh_TransportMem_InitClear,      \
-    .Send =     wh_TransportMem_SendRequest,    \
-    .Recv =     wh_TransportMem_RecvResponse,   \
-    .Cleanup =  wh_TransportMem_Cleanup,        \
+#define WH_TRANSPORT_MEM_RING_CLIENT_CB                 \
+{                                                       \
+    .Init =          wh_TransportMemRing_InitClear,     \
+    .Send =          wh_TransportMemRing_SendRequest,   \
+    .Recv =          wh_TransportMemRing_RecvResponse,  \
+    .Cleanup =       wh_TransportMemRing_Cleanup,       \
+    .GetSendBuffer = wh_TransportMemRing_GetSendBuffer, \
 }
 
-#define WH_TRANSPORT_MEM_SERVER_CB              \
-{                                               \
-    .Init =     wh_TransportMem_Init,           \
-    .Recv =     wh_TransportMem_RecvRequest,    \
-    .Send =     wh_TransportMem_SendResponse,   \
-    .Cleanup =  wh_TransportMem_Cleanup,        \
+#define WH_TRANSPORT_MEM_RING_SERVER_CB                   \
+{                                                         \
+    .Init =          wh_TransportMemRing_Init,            \
+    .Recv =          wh_TransportMemRing_RecvRequest,     \
+    .Send =          wh_TransportMemRing_SendResponse,    \
+    .Cleanup =       wh_TransportMemRing_Cleanup,         \
+    .Complete =      wh_TransportMemRing_CompleteRequest, \
+    .Pending =       wh_TransportMemRing_PendingRequest,  \
 }
 
 #endif /* !WOLFHSM_WH_TRANSPORT_MEM_H_ */
@@ -0,0 +1,143 @@
+/*
+ * Copyright (C) 2025 wolfSSL Inc.
+ *
+ * This file is part of wolfHSM.
+ *
+ * wolfHSM is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * wolfHSM is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with wolfHSM.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/*
+ * wolfhsm/wh_transport_session.h
+ *
+ * wolfHSM client transport that multiplexes many sessions over one connection
+ */
+
+/* Session multiplexing
+ * Each logical client normally needs its own transport connection and its own
+ * server context.  With WOLFHSM_CFG_COMM_SESSIONS, a client comm configured
+ * with a non-zero session_id marks each request with that id in the header aux
+ * field, and the server handles it as the client that opened the session.
+ * This transport lets the whCommClient of each session share one underlying
+ * client transport connection, so a single connection and server context can
+ * serve many clients, each with its own client_id, key namespace and sequence
+ * numbers.
+ *
+ * The connection is held by one session at a time: a session that sends a
+ * request keeps the connection until it has received every response it is
+ * waiting for, and Send from any other session returns WH_ERROR_NOTREADY until
+ * then.  The underlying transport is initialized by the first session and
+ * cleaned up with the last one.  Cleanup of a session that is still waiting
+ * for a response returns WH_ERROR_NOTREADY and leaves the session open, so
+ * receive the response first.  All sessions of a connection must be used
+ * from the same thread.  NORESP requests are not supported on sessions.  With
+ * WOLFHSM_CFG_COMM_FRAGMENT, set fragment_size in the config to the
+ * fragment_size of the comm clients, and a session keeps the connection until
+ * the last fragment of its response has arrived.
+ *
+ * Each session must send a CommInit (wh_Client_CommInit) to open the session
+ * on the server before any other request, and may close it again with
+ * wh_Client_CommClose without affecting the other sessions.
+ *
+ * Example usage:
+ *
+ * whTransportClientCb tmccb[1] = {WH_TRANSPORT_MEM_CLIENT_CB};
+ * whTransportMemClientContext tmcc[1] = {0};
+ *
+ * whTransportSessionConnection conn[1] = {0};
+ * whTransportSessionConfig tscf[1] = {{
+ *      .conn = conn,
+ *      .transport_cb = tmccb,
+ *      .transport_context = tmcc,
+ *      .transport_config = tmcf,
+ * }};
+ * whTransportSessionContext tsctx[N] = {0};
+ *
+ * whTransportClientCb tsccb[1] = {WH_TRANSPORT_SESSION_CLIENT_CB};
+ * whCommClientConfig ccc[N] = {{
+ *      .transport_cb = tsccb,
+ *      .transport_context = &tsctx[0],
+ *      .transport_config = tscf,
+ *      .client_id = 1,
+ *      .session_id = 1,
+ * }, ..};
+ */
+
+#ifndef WOLFHSM_WH_TRANSPORT_SESSION_H_
+#define WOLFHSM_WH_TRANSPORT_SESSION_H_
+
+/* Pick up compile-time configuration */
+#include "wolfhsm/wh_settings.h"
+
+#if defined(WOLFHSM_CFG_COMM_SESSIONS) && defined(WOLFHSM_CFG_ENABLE_CLIENT)
+
+#include <stdint.h>
+
+#include "wolfhsm/wh_comm.h"
+
+/** Connection state shared by all sessions */
+typedef struct {
+    const whTransportClientCb* transport_cb;
+    void* transport_context;
+    void* owner;        /* Session holding the connection, or NULL */
+    uint16_t users;     /* Sessions initialized on the connection */
+    uint16_t pending;   /* Responses the owner is waiting for */
+#ifdef WOLFHSM_CFG_COMM_FRAGMENT
+    uint16_t fragment_size; /* Nonzero if packets carry fragment headers */
+    uint8_t WH_PAD[2];
+#else
+    uint8_t WH_PAD[4];
+#endif
+} whTransportSessionConnection;
+
+/** Session configuration structure */
+typedef struct {
+    whTransportSessionConnection* conn;  /* Shared by all sessions */
+    const whTransportClientCb* transport_cb; /* Underlying transport */
+    void* transport_context;
+    const void* transport_config;
+#ifdef WOLFHSM_CFG_COMM_FRAGMENT
+    uint16_t fragment_size; /* fragment_size of the comm clients, or 0 */
+    uint8_t WH_PAD[6];
+#endif
+} whTransportSessionConfig;
+
+/** Session context structure */
+typedef struct {
+    whTransportSessionConnection* conn;
+    int initialized;
+    uint8_t WH_PAD[4];
+} whTransportSessionContext;
+
+/** Callback function declarations */
+int wh_TransportSession_Init(void* c, const void* cf,
+        whCommSetConnectedCb connectcb, void* connectcb_arg);
+int wh_TransportSession_Send(void* c, uint16_t len, const void* data);
+int wh_TransportSession_Recv(void* c, uint16_t* out_len, void* data);
+int wh_TransportSession_Cleanup(void* c);
+int wh_TransportSession_GetSendBuffer(void* c, uint16_t* out_size,
+        void** out_buffer);
+int wh_TransportSession_Wait(void* c, uint64_t timeout_us);
+
+#define WH_TRANSPORT_SESSION_CLIENT_CB                  \
+{                                                       \
+    .Init =          wh_TransportSession_Init,          \
+    .Send =          wh_TransportSession_Send,          \
+    .Recv =          wh_TransportSession_Recv,          \
+    .Cleanup =       wh_TransportSession_Cleanup,       \
+    .GetSendBuffer = wh_TransportSession_GetSendBuffer, \
+    .Wait =          wh_TransportSession_Wait,          \
+}
+
+#endif /* WOLFHSM_CFG_COMM_SESSIONS && WOLFHSM_CFG_ENABLE_CLIENT */
+
+#endif /* !WOLFHSM_WH_TRANSPORT_SESSION_H_ */